@@ -209,6 +209,14 @@ std::vector<std::string> printIntermediateCode(const std::vector<std::pair<ICUni
  */
 uint32_t generateRTypeMachineCode(const ICUnit &block);
 
+/**
+ * @brief Generates machine code for an R2-type instruction, funct5 in place of rs2.
+ *
+ * @param block The ICUnit representing the instruction.
+ * @return The machine code bitset<32>.
+ */
+uint32_t generateR2TypeMachineCode(const ICUnit &block);
+
 /**
  * @brief Generates machine code for an I1-type instruction.
  * 
@@ -276,6 +284,27 @@ uint32_t generateFDR4TypeMachineCode(const ICUnit &block);
 uint32_t generateFDITypeMachineCode(const ICUnit &block);
 uint32_t generateFDSTypeMachineCode(const ICUnit &block);
 
+/**
+ * @brief Generates machine code for a vector instruction, vset{i}vl{i} included.
+ *
+ * The vtype of vsetvli and vsetivli and the simm5 of the .vi forms come from the immediate, a missing rs2 is the
+ * funct5 of the encoding (lumop, sumop, the vs2 of vmv.v.*).
+ *
+ * @param block The ICUnit representing the instruction.
+ * @return The machine code bitset<32>.
+ */
+uint32_t generateVTypeMachineCode(const ICUnit &block);
+
+/**
+ * @brief Generates machine code for lr, sc and the amos, funct7 holds the aq and rl bits of the mnemonic.
+ *
+ * lr has no rs2, the field is 0.
+ *
+ * @param block The ICUnit representing the instruction.
+ * @return The machine code bitset<32>.
+ */
+uint32_t generateATypeMachineCode(const ICUnit &block);
+
 /**
  * @brief Generates machine code from a vector of intermediate code blocks.
  * 
@@ -284,4 +313,27 @@ uint32_t generateFDSTypeMachineCode(const ICUnit &block);
  */
 std::vector<uint32_t> generateMachineCode(const std::vector<std::pair<ICUnit, bool>> &IntermediateCode);
 
+/**
+ * @brief Returns the 16-bit RV64C form of an instruction.
+ *
+ * @param instruction The 32-bit machine code.
+ * @return The compressed instruction, 0 if the instruction has no 16-bit form.
+ */
+uint16_t compressInstruction(uint32_t instruction);
+
+/**
+ * @brief Replaces the instructions that have a 16-bit RV64C form by it.
+ *
+ * Branches and jumps to a label are compressed while the offset to the label fits, their offsets and the offsets of
+ * the auipc pairs that address data are recomputed for the new addresses (in IntermediateCode too). Numeric offsets
+ * are kept as written.
+ * A compressed instruction is stored in the low 16 bits of its entry.
+ *
+ * @param IntermediateCode A vector of pairs containing ICUnit and a boolean flag, the relocated offsets are updated.
+ * @param machine_code The machine code generated from IntermediateCode, rewritten in place.
+ * @return The address of every instruction.
+ */
+std::vector<uint64_t> compressMachineCode(std::vector<std::pair<ICUnit, bool>> &IntermediateCode,
+                                          std::vector<uint32_t> &machine_code);
+
 #endif // CODE_GENERATOR_H
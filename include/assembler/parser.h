@@ -123,6 +123,7 @@ class Parser {
   bool parse_O_GPR_C_GPR_C_GPR();
   bool parse_O_GPR_C_GPR_C_I();
   bool parse_O_GPR_C_I();
+  bool parse_O_GPR_C_GPR();
   bool parse_O_GPR_C_GPR_C_IL();
   bool parse_O_GPR_C_GPR_C_DL();
   bool parse_O_GPR_C_IL();
@@ -148,6 +149,24 @@ class Parser {
   bool parse_O_GPR_C_FPR_C_FPR();
   bool parse_O_FPR_C_I_LP_GPR_RP();
 
+  bool parse_O_GPR_C_GPR_C_VTYPE();
+  bool parse_O_GPR_C_I_C_VTYPE();
+  bool parse_O_VR_C_LP_GPR_RP();
+  bool parse_O_VR_C_LP_GPR_RP_C_GPR();
+  bool parse_O_VR_C_VR_C_VR();
+  bool parse_O_VR_C_VR_C_GPR();
+  bool parse_O_VR_C_VR_C_FPR();
+  bool parse_O_VR_C_VR_C_I();
+  bool parse_O_VR_C_GPR_C_VR();
+  bool parse_O_VR_C_FPR_C_VR();
+  bool parse_O_VR_C_VR();
+  bool parse_O_VR_C_GPR();
+  bool parse_O_VR_C_FPR();
+  bool parse_O_VR_C_I();
+
+  bool parse_O_GPR_C_LP_GPR_RP();
+  bool parse_O_GPR_C_GPR_C_LP_GPR_RP();
+
   /**
    * @brief Parses a data directive.
    */
@@ -33,6 +33,7 @@ enum class TokenType {
   RPAREN,          ///< Right parenthesis ')'
   STRING,          ///< String literal
   RM,            ///< Rounding mode
+  VTYPE,         ///< Field of a vtype (SEW, LMUL, tail or mask policy)
 };
 
 /**
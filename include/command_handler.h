@@ -21,6 +21,7 @@ enum class CommandType {
   STEP,
   UNDO,
   REDO,
+  SEEK,
   RESET,
   MODIFY_REGISTER,
   GET_REGISTER,
@@ -29,6 +30,10 @@ enum class CommandType {
   PRINT_MEMORY,
   GET_MEMORY_POINT,
   DUMP_CACHE,
+  DUMP_BRANCH_PROFILE,
+  SAVE_STATE,
+  LOAD_STATE,
+  FORK_RUN,
   ADD_BREAKPOINT,
   REMOVE_BREAKPOINT,
   VM_STDIN,
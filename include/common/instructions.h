@@ -134,6 +134,40 @@ enum Instruction {
   kremw, 
   kremuw,
 
+  ksh1add, 
+  ksh2add, 
+  ksh3add,
+  kadd_uw, 
+  ksh1add_uw, 
+  ksh2add_uw, 
+  ksh3add_uw, 
+  kslli_uw,
+
+  kandn, 
+  korn, 
+  kxnor,
+  kclz, 
+  kctz, 
+  kcpop, 
+  kclzw, 
+  kctzw, 
+  kcpopw,
+  kmax, 
+  kmaxu, 
+  kmin, 
+  kminu,
+  ksext_b, 
+  ksext_h, 
+  kzext_h,
+  krol, 
+  kror, 
+  krori, 
+  krolw, 
+  krorw, 
+  kroriw,
+  korc_b, 
+  krev8,
+
   kflw, 
   kfsw, 
   kfmadd_s, 
@@ -197,6 +231,73 @@ enum Instruction {
   kfcvt_d_lu, 
   kfmv_d_x,
 
+  kvsetvli,
+  kvsetivli,
+  kvsetvl,
+  kvle8_v,
+  kvle16_v,
+  kvle32_v,
+  kvle64_v,
+  kvse8_v,
+  kvse16_v,
+  kvse32_v,
+  kvse64_v,
+  kvlse8_v,
+  kvlse16_v,
+  kvlse32_v,
+  kvlse64_v,
+  kvsse8_v,
+  kvsse16_v,
+  kvsse32_v,
+  kvsse64_v,
+  kvadd_vv,
+  kvadd_vx,
+  kvadd_vi,
+  kvsub_vv,
+  kvsub_vx,
+  kvmul_vv,
+  kvmul_vx,
+  kvmacc_vv,
+  kvmacc_vx,
+  kvredsum_vs,
+  kvmv_v_v,
+  kvmv_v_x,
+  kvmv_v_i,
+  kvfadd_vv,
+  kvfadd_vf,
+  kvfsub_vv,
+  kvfsub_vf,
+  kvfmul_vv,
+  kvfmul_vf,
+  kvfmacc_vv,
+  kvfmacc_vf,
+  kvfredusum_vs,
+  kvfredosum_vs,
+  kvfmv_v_f,
+
+  klr_w,
+  ksc_w,
+  kamoswap_w,
+  kamoadd_w,
+  kamoxor_w,
+  kamoand_w,
+  kamoor_w,
+  kamomin_w,
+  kamomax_w,
+  kamominu_w,
+  kamomaxu_w,
+  klr_d,
+  ksc_d,
+  kamoswap_d,
+  kamoadd_d,
+  kamoxor_d,
+  kamoand_d,
+  kamoor_d,
+  kamomin_d,
+  kamomax_d,
+  kamominu_d,
+  kamomaxu_d,
+
   INVALID,
 
   COUNT // sentinel for length
@@ -264,16 +365,50 @@ inline constexpr std::array<InstructionEncoding, static_cast<size_t>(Instruction
   InstructionEncoding(Instruction::kremw,       0b0111011, -1, 0b110, -1, -1, 0b0000001), // kremw
   InstructionEncoding(Instruction::kremuw,      0b0111011, -1, 0b111, -1, -1, 0b0000001), // kremuw
 
+  InstructionEncoding(Instruction::ksh1add,     0b0110011, -1, 0b010, -1, -1, 0b0010000), // ksh1add
+  InstructionEncoding(Instruction::ksh2add,     0b0110011, -1, 0b100, -1, -1, 0b0010000), // ksh2add
+  InstructionEncoding(Instruction::ksh3add,     0b0110011, -1, 0b110, -1, -1, 0b0010000), // ksh3add
+  InstructionEncoding(Instruction::kadd_uw,     0b0111011, -1, 0b000, -1, -1, 0b0000100), // kadd_uw
+  InstructionEncoding(Instruction::ksh1add_uw,  0b0111011, -1, 0b010, -1, -1, 0b0010000), // ksh1add_uw
+  InstructionEncoding(Instruction::ksh2add_uw,  0b0111011, -1, 0b100, -1, -1, 0b0010000), // ksh2add_uw
+  InstructionEncoding(Instruction::ksh3add_uw,  0b0111011, -1, 0b110, -1, -1, 0b0010000), // ksh3add_uw
+  InstructionEncoding(Instruction::kslli_uw,    0b0011011, -1, 0b001, -1, 0b000010, -1), // kslli_uw
+
+  InstructionEncoding(Instruction::kandn,       0b0110011, -1, 0b111, -1, -1, 0b0100000), // kandn
+  InstructionEncoding(Instruction::korn,        0b0110011, -1, 0b110, -1, -1, 0b0100000), // korn
+  InstructionEncoding(Instruction::kxnor,       0b0110011, -1, 0b100, -1, -1, 0b0100000), // kxnor
+  InstructionEncoding(Instruction::kclz,        0b0010011, -1, 0b001, 0b00000, -1, 0b0110000), // kclz
+  InstructionEncoding(Instruction::kctz,        0b0010011, -1, 0b001, 0b00001, -1, 0b0110000), // kctz
+  InstructionEncoding(Instruction::kcpop,       0b0010011, -1, 0b001, 0b00010, -1, 0b0110000), // kcpop
+  InstructionEncoding(Instruction::kclzw,       0b0011011, -1, 0b001, 0b00000, -1, 0b0110000), // kclzw
+  InstructionEncoding(Instruction::kctzw,       0b0011011, -1, 0b001, 0b00001, -1, 0b0110000), // kctzw
+  InstructionEncoding(Instruction::kcpopw,      0b0011011, -1, 0b001, 0b00010, -1, 0b0110000), // kcpopw
+  InstructionEncoding(Instruction::kmax,        0b0110011, -1, 0b110, -1, -1, 0b0000101), // kmax
+  InstructionEncoding(Instruction::kmaxu,       0b0110011, -1, 0b111, -1, -1, 0b0000101), // kmaxu
+  InstructionEncoding(Instruction::kmin,        0b0110011, -1, 0b100, -1, -1, 0b0000101), // kmin
+  InstructionEncoding(Instruction::kminu,       0b0110011, -1, 0b101, -1, -1, 0b0000101), // kminu
+  InstructionEncoding(Instruction::ksext_b,     0b0010011, -1, 0b001, 0b00100, -1, 0b0110000), // ksext_b
+  InstructionEncoding(Instruction::ksext_h,     0b0010011, -1, 0b001, 0b00101, -1, 0b0110000), // ksext_h
+  InstructionEncoding(Instruction::kzext_h,     0b0111011, -1, 0b100, 0b00000, -1, 0b0000100), // kzext_h
+  InstructionEncoding(Instruction::krol,        0b0110011, -1, 0b001, -1, -1, 0b0110000), // krol
+  InstructionEncoding(Instruction::kror,        0b0110011, -1, 0b101, -1, -1, 0b0110000), // kror
+  InstructionEncoding(Instruction::krori,       0b0010011, -1, 0b101, -1, 0b011000, -1), // krori
+  InstructionEncoding(Instruction::krolw,       0b0111011, -1, 0b001, -1, -1, 0b0110000), // krolw
+  InstructionEncoding(Instruction::krorw,       0b0111011, -1, 0b101, -1, -1, 0b0110000), // krorw
+  InstructionEncoding(Instruction::kroriw,      0b0011011, -1, 0b101, -1, -1, 0b0110000), // kroriw
+  InstructionEncoding(Instruction::korc_b,      0b0010011, -1, 0b101, 0b00111, -1, 0b0010100), // korc_b
+  InstructionEncoding(Instruction::krev8,       0b0010011, -1, 0b101, 0b11000, -1, 0b0110101), // krev8
+
   InstructionEncoding(Instruction::kecall,      0b1110011, -1, 0b000, -1, -1, 0b0000000), // kecall
 
   
   InstructionEncoding(Instruction::kaddi,       0b0010011, -1, 0b000, -1, -1, -1), // addi
-  InstructionEncoding(Instruction::kslli,       0b0010011, -1, 0b001, -1, -1, 0b0000000), // kslli
+  InstructionEncoding(Instruction::kslli,       0b0010011, -1, 0b001, -1, 0b000000, -1), // kslli
   InstructionEncoding(Instruction::kslti,       0b0010011, -1, 0b010, -1, -1, -1), // kslti
   InstructionEncoding(Instruction::ksltiu,      0b0010011, -1, 0b011, -1, -1, -1), // ksltiu
   InstructionEncoding(Instruction::kxori,       0b0010011, -1, 0b100, -1, -1, -1), // kxori
-  InstructionEncoding(Instruction::ksrli,       0b0010011, -1, 0b101, -1, -1, 0b0000000), // ksrli
-  InstructionEncoding(Instruction::ksrai,       0b0010011, -1, 0b101, -1, -1, 0b0100000), // ksrai
+  InstructionEncoding(Instruction::ksrli,       0b0010011, -1, 0b101, -1, 0b000000, -1), // ksrli
+  InstructionEncoding(Instruction::ksrai,       0b0010011, -1, 0b101, -1, 0b010000, -1), // ksrai
   InstructionEncoding(Instruction::kori,        0b0010011, -1, 0b110, -1, -1, -1), // kori
   InstructionEncoding(Instruction::kandi,       0b0010011, -1, 0b111, -1, -1, -1), // kandi
 
@@ -344,7 +479,7 @@ inline constexpr std::array<InstructionEncoding, static_cast<size_t>(Instruction
   InstructionEncoding(Instruction::kflw,        0b0000111, -1, 0b010, -1, -1, -1), // kflw
   InstructionEncoding(Instruction::kfsw,        0b0100111, -1, 0b010, -1, -1, -1), // kfsw
   InstructionEncoding(Instruction::kfld,        0b0000111, -1, 0b011, -1, -1, -1), // kfld
-  InstructionEncoding(Instruction::kfsw,        0b0100111, -1, 0b011, -1, -1, -1), // kfsd
+  InstructionEncoding(Instruction::kfsd,        0b0100111, -1, 0b011, -1, -1, -1), // kfsd
 
 
   InstructionEncoding(Instruction::kfadd_s,     0b1010011, -1, -1, -1, -1, 0b0000000), // kfadd_s
@@ -401,6 +536,78 @@ inline constexpr std::array<InstructionEncoding, static_cast<size_t>(Instruction
   InstructionEncoding(Instruction::kfnmsub_d, 0b1001011, 0b01, -1, -1, -1, -1), // kfnmsub_d
   InstructionEncoding(Instruction::kfnmadd_d, 0b1001111, 0b01, -1, -1, -1, -1), // kfnmadd_d
 
+  // V, unmasked only: vm (bit 25) is 1 in funct7, funct6 is funct7[6:1]. The loads and stores use LOAD-FP / STORE-FP
+  // with the element width in funct3 and nf, mew, mop, vm in funct7, lumop / sumop 00000 for unit stride.
+  InstructionEncoding(Instruction::kvsetvli,    0b1010111, -1, 0b111, -1, -1, -1), // kvsetvli, bit 31 = 0
+  InstructionEncoding(Instruction::kvsetivli,   0b1010111, -1, 0b111, -1, -1, -1), // kvsetivli, bits 31:30 = 11
+  InstructionEncoding(Instruction::kvsetvl,     0b1010111, -1, 0b111, -1, -1, 0b1000000), // kvsetvl
+
+  InstructionEncoding(Instruction::kvle8_v,     0b0000111, -1, 0b000, 0b00000, -1, 0b0000001), // kvle8_v
+  InstructionEncoding(Instruction::kvle16_v,    0b0000111, -1, 0b101, 0b00000, -1, 0b0000001), // kvle16_v
+  InstructionEncoding(Instruction::kvle32_v,    0b0000111, -1, 0b110, 0b00000, -1, 0b0000001), // kvle32_v
+  InstructionEncoding(Instruction::kvle64_v,    0b0000111, -1, 0b111, 0b00000, -1, 0b0000001), // kvle64_v
+  InstructionEncoding(Instruction::kvse8_v,     0b0100111, -1, 0b000, 0b00000, -1, 0b0000001), // kvse8_v
+  InstructionEncoding(Instruction::kvse16_v,    0b0100111, -1, 0b101, 0b00000, -1, 0b0000001), // kvse16_v
+  InstructionEncoding(Instruction::kvse32_v,    0b0100111, -1, 0b110, 0b00000, -1, 0b0000001), // kvse32_v
+  InstructionEncoding(Instruction::kvse64_v,    0b0100111, -1, 0b111, 0b00000, -1, 0b0000001), // kvse64_v
+  InstructionEncoding(Instruction::kvlse8_v,    0b0000111, -1, 0b000, -1, -1, 0b0000101), // kvlse8_v
+  InstructionEncoding(Instruction::kvlse16_v,   0b0000111, -1, 0b101, -1, -1, 0b0000101), // kvlse16_v
+  InstructionEncoding(Instruction::kvlse32_v,   0b0000111, -1, 0b110, -1, -1, 0b0000101), // kvlse32_v
+  InstructionEncoding(Instruction::kvlse64_v,   0b0000111, -1, 0b111, -1, -1, 0b0000101), // kvlse64_v
+  InstructionEncoding(Instruction::kvsse8_v,    0b0100111, -1, 0b000, -1, -1, 0b0000101), // kvsse8_v
+  InstructionEncoding(Instruction::kvsse16_v,   0b0100111, -1, 0b101, -1, -1, 0b0000101), // kvsse16_v
+  InstructionEncoding(Instruction::kvsse32_v,   0b0100111, -1, 0b110, -1, -1, 0b0000101), // kvsse32_v
+  InstructionEncoding(Instruction::kvsse64_v,   0b0100111, -1, 0b111, -1, -1, 0b0000101), // kvsse64_v
+
+  InstructionEncoding(Instruction::kvadd_vv,    0b1010111, -1, 0b000, -1, -1, 0b0000001), // kvadd_vv
+  InstructionEncoding(Instruction::kvadd_vx,    0b1010111, -1, 0b100, -1, -1, 0b0000001), // kvadd_vx
+  InstructionEncoding(Instruction::kvadd_vi,    0b1010111, -1, 0b011, -1, -1, 0b0000001), // kvadd_vi
+  InstructionEncoding(Instruction::kvsub_vv,    0b1010111, -1, 0b000, -1, -1, 0b0000101), // kvsub_vv
+  InstructionEncoding(Instruction::kvsub_vx,    0b1010111, -1, 0b100, -1, -1, 0b0000101), // kvsub_vx
+  InstructionEncoding(Instruction::kvmul_vv,    0b1010111, -1, 0b010, -1, -1, 0b1001011), // kvmul_vv
+  InstructionEncoding(Instruction::kvmul_vx,    0b1010111, -1, 0b110, -1, -1, 0b1001011), // kvmul_vx
+  InstructionEncoding(Instruction::kvmacc_vv,   0b1010111, -1, 0b010, -1, -1, 0b1011011), // kvmacc_vv
+  InstructionEncoding(Instruction::kvmacc_vx,   0b1010111, -1, 0b110, -1, -1, 0b1011011), // kvmacc_vx
+  InstructionEncoding(Instruction::kvredsum_vs, 0b1010111, -1, 0b010, -1, -1, 0b0000001), // kvredsum_vs
+  InstructionEncoding(Instruction::kvmv_v_v,    0b1010111, -1, 0b000, 0b00000, -1, 0b0101111), // kvmv_v_v
+  InstructionEncoding(Instruction::kvmv_v_x,    0b1010111, -1, 0b100, 0b00000, -1, 0b0101111), // kvmv_v_x
+  InstructionEncoding(Instruction::kvmv_v_i,    0b1010111, -1, 0b011, 0b00000, -1, 0b0101111), // kvmv_v_i
+
+  InstructionEncoding(Instruction::kvfadd_vv,   0b1010111, -1, 0b001, -1, -1, 0b0000001), // kvfadd_vv
+  InstructionEncoding(Instruction::kvfadd_vf,   0b1010111, -1, 0b101, -1, -1, 0b0000001), // kvfadd_vf
+  InstructionEncoding(Instruction::kvfsub_vv,   0b1010111, -1, 0b001, -1, -1, 0b0000101), // kvfsub_vv
+  InstructionEncoding(Instruction::kvfsub_vf,   0b1010111, -1, 0b101, -1, -1, 0b0000101), // kvfsub_vf
+  InstructionEncoding(Instruction::kvfmul_vv,   0b1010111, -1, 0b001, -1, -1, 0b1001001), // kvfmul_vv
+  InstructionEncoding(Instruction::kvfmul_vf,   0b1010111, -1, 0b101, -1, -1, 0b1001001), // kvfmul_vf
+  InstructionEncoding(Instruction::kvfmacc_vv,  0b1010111, -1, 0b001, -1, -1, 0b1011001), // kvfmacc_vv
+  InstructionEncoding(Instruction::kvfmacc_vf,  0b1010111, -1, 0b101, -1, -1, 0b1011001), // kvfmacc_vf
+  InstructionEncoding(Instruction::kvfredusum_vs, 0b1010111, -1, 0b001, -1, -1, 0b0000011), // kvfredusum_vs
+  InstructionEncoding(Instruction::kvfredosum_vs, 0b1010111, -1, 0b001, -1, -1, 0b0000111), // kvfredosum_vs
+  InstructionEncoding(Instruction::kvfmv_v_f,   0b1010111, -1, 0b101, 0b00000, -1, 0b0101111), // kvfmv_v_f
+
+  // aq and rl (funct7[1:0]) are not part of the encoding, lr has rs2 = 0
+  InstructionEncoding(Instruction::klr_w,       0b0101111, -1, 0b010, 0b00000, -1, 0b0001000), // klr_w
+  InstructionEncoding(Instruction::ksc_w,       0b0101111, -1, 0b010, -1, -1, 0b0001100), // ksc_w
+  InstructionEncoding(Instruction::kamoswap_w,  0b0101111, -1, 0b010, -1, -1, 0b0000100), // kamoswap_w
+  InstructionEncoding(Instruction::kamoadd_w,   0b0101111, -1, 0b010, -1, -1, 0b0000000), // kamoadd_w
+  InstructionEncoding(Instruction::kamoxor_w,   0b0101111, -1, 0b010, -1, -1, 0b0010000), // kamoxor_w
+  InstructionEncoding(Instruction::kamoand_w,   0b0101111, -1, 0b010, -1, -1, 0b0110000), // kamoand_w
+  InstructionEncoding(Instruction::kamoor_w,    0b0101111, -1, 0b010, -1, -1, 0b0100000), // kamoor_w
+  InstructionEncoding(Instruction::kamomin_w,   0b0101111, -1, 0b010, -1, -1, 0b1000000), // kamomin_w
+  InstructionEncoding(Instruction::kamomax_w,   0b0101111, -1, 0b010, -1, -1, 0b1010000), // kamomax_w
+  InstructionEncoding(Instruction::kamominu_w,  0b0101111, -1, 0b010, -1, -1, 0b1100000), // kamominu_w
+  InstructionEncoding(Instruction::kamomaxu_w,  0b0101111, -1, 0b010, -1, -1, 0b1110000), // kamomaxu_w
+  InstructionEncoding(Instruction::klr_d,       0b0101111, -1, 0b011, 0b00000, -1, 0b0001000), // klr_d
+  InstructionEncoding(Instruction::ksc_d,       0b0101111, -1, 0b011, -1, -1, 0b0001100), // ksc_d
+  InstructionEncoding(Instruction::kamoswap_d,  0b0101111, -1, 0b011, -1, -1, 0b0000100), // kamoswap_d
+  InstructionEncoding(Instruction::kamoadd_d,   0b0101111, -1, 0b011, -1, -1, 0b0000000), // kamoadd_d
+  InstructionEncoding(Instruction::kamoxor_d,   0b0101111, -1, 0b011, -1, -1, 0b0010000), // kamoxor_d
+  InstructionEncoding(Instruction::kamoand_d,   0b0101111, -1, 0b011, -1, -1, 0b0110000), // kamoand_d
+  InstructionEncoding(Instruction::kamoor_d,    0b0101111, -1, 0b011, -1, -1, 0b0100000), // kamoor_d
+  InstructionEncoding(Instruction::kamomin_d,   0b0101111, -1, 0b011, -1, -1, 0b1000000), // kamomin_d
+  InstructionEncoding(Instruction::kamomax_d,   0b0101111, -1, 0b011, -1, -1, 0b1010000), // kamomax_d
+  InstructionEncoding(Instruction::kamominu_d,  0b0101111, -1, 0b011, -1, -1, 0b1100000), // kamominu_d
+  InstructionEncoding(Instruction::kamomaxu_d,  0b0101111, -1, 0b011, -1, -1, 0b1110000), // kamomaxu_d
 
 }};
 
@@ -466,6 +673,16 @@ struct I2TypeInstructionEncoding {
       : opcode(opcode), funct3(funct3), funct6(funct6) {}
 };
 
+struct R2TypeInstructionEncoding { // clz, rev8, have funct5 instead of rs2
+  std::bitset<7> opcode;
+  std::bitset<3> funct3;
+  std::bitset<5> funct5;
+  std::bitset<7> funct7;
+
+  R2TypeInstructionEncoding(unsigned int opcode, unsigned int funct3, unsigned int funct5, unsigned int funct7)
+      : opcode(opcode), funct3(funct3), funct5(funct5), funct7(funct7) {}
+};
+
 struct I3TypeInstructionEncoding {
   std::bitset<7> opcode;
   std::bitset<3> funct3;
@@ -584,6 +801,29 @@ struct FDSTypeInstructionEncoding {
       : opcode(opcode), funct3(funct3) {}
 };
 
+// Aextension instructions===========================================================================
+
+struct ATypeInstructionEncoding {
+  std::bitset<7> opcode;
+  std::bitset<3> funct3;
+  std::bitset<7> funct7;  // funct5, aq and rl
+
+  ATypeInstructionEncoding(unsigned int opcode, unsigned int funct3, unsigned int funct7)
+      : opcode(opcode), funct3(funct3), funct7(funct7) {}
+};
+
+// Vextension instructions===========================================================================
+
+struct VTypeInstructionEncoding {
+  std::bitset<7> opcode;
+  std::bitset<3> funct3;
+  std::bitset<7> funct7;  // funct6 and vm for OP-V, nf, mew, mop and vm for the loads and stores
+  std::bitset<5> funct5;  // lumop / sumop of the unit-stride loads and stores, vs2 = 0 of vmv.v.*, in place of rs2
+
+  VTypeInstructionEncoding(unsigned int opcode, unsigned int funct3, unsigned int funct7, unsigned int funct5 = 0)
+      : opcode(opcode), funct3(funct3), funct7(funct7), funct5(funct5) {}
+};
+
 /**
  * @brief Enum that represents different syntax types for instructions.
  */
@@ -591,6 +831,7 @@ enum class SyntaxType {
   O_GPR_C_GPR_C_GPR,       ///< Opcode general-register , general-register , register
   O_GPR_C_GPR_C_I,        ///< Opcode general-register , general-register , immediate
   O_GPR_C_I,            ///< Opcode general-register , immediate
+  O_GPR_C_GPR,          ///< Opcode general-register , general-register
   O_GPR_C_GPR_C_IL,       ///< Opcode general-register , general-register , immediate , instruction_label
   O_GPR_C_GPR_C_DL,       ///< Opcode register , register , immediate , data_label
   O_GPR_C_IL,           ///< Opcode register , instruction_label
@@ -615,9 +856,28 @@ enum class SyntaxType {
   O_GPR_C_FPR_C_RM,       ///< Opcode general-register , floating-point-register , rounding_mode
   O_GPR_C_FPR_C_FPR,       ///< Opcode general-register , floating-point-register , floating-point-register
   O_FPR_C_I_LP_GPR_RP,    ///< Opcode floating-point-register , immediate , lparen ( general-register ) rparen
+
+  O_GPR_C_GPR_C_VTYPE,    ///< Opcode general-register , general-register , vtype
+  O_GPR_C_I_C_VTYPE,      ///< Opcode general-register , immediate , vtype
+  O_VR_C_LP_GPR_RP,       ///< Opcode vector-register , lparen ( general-register ) rparen
+  O_VR_C_LP_GPR_RP_C_GPR, ///< Opcode vector-register , lparen ( general-register ) rparen , general-register
+  O_VR_C_VR_C_VR,         ///< Opcode vector-register , vector-register , vector-register
+  O_VR_C_VR_C_GPR,        ///< Opcode vector-register , vector-register , general-register
+  O_VR_C_VR_C_FPR,        ///< Opcode vector-register , vector-register , floating-point-register
+  O_VR_C_VR_C_I,          ///< Opcode vector-register , vector-register , immediate
+  O_VR_C_GPR_C_VR,        ///< Opcode vector-register , general-register , vector-register
+  O_VR_C_FPR_C_VR,        ///< Opcode vector-register , floating-point-register , vector-register
+  O_VR_C_VR,              ///< Opcode vector-register , vector-register
+  O_VR_C_GPR,             ///< Opcode vector-register , general-register
+  O_VR_C_FPR,             ///< Opcode vector-register , floating-point-register
+  O_VR_C_I,               ///< Opcode vector-register , immediate
+
+  O_GPR_C_LP_GPR_RP,          ///< Opcode general-register , lparen ( general-register ) rparen
+  O_GPR_C_GPR_C_LP_GPR_RP,    ///< Opcode general-register , general-register , lparen ( general-register ) rparen
 };
 
 extern std::unordered_map<std::string, RTypeInstructionEncoding> R_type_instruction_encoding_map;
+extern std::unordered_map<std::string, R2TypeInstructionEncoding> R2_type_instruction_encoding_map;
 extern std::unordered_map<std::string, I1TypeInstructionEncoding> I1_type_instruction_encoding_map;
 extern std::unordered_map<std::string, I2TypeInstructionEncoding> I2_type_instruction_encoding_map;
 extern std::unordered_map<std::string, I3TypeInstructionEncoding> I3_type_instruction_encoding_map;
@@ -636,6 +896,10 @@ extern std::unordered_map<std::string, FDR4TypeInstructionEncoding> F_D_R4_type_
 extern std::unordered_map<std::string, FDITypeInstructionEncoding> F_D_I_type_instruction_encoding_map;
 extern std::unordered_map<std::string, FDSTypeInstructionEncoding> F_D_S_type_instruction_encoding_map;
 
+extern std::unordered_map<std::string, ATypeInstructionEncoding> A_type_instruction_encoding_map;
+
+extern std::unordered_map<std::string, VTypeInstructionEncoding> V_type_instruction_encoding_map;
+
 /**
  * @brief A map that associates instruction names with their expected syntax.
  * 
@@ -646,9 +910,11 @@ extern std::unordered_map<std::string, std::vector<SyntaxType>> instruction_synt
 bool isValidInstruction(const std::string &instruction);
 
 bool isValidRTypeInstruction(const std::string &name);
+bool isValidR2TypeInstruction(const std::string &instruction);
 bool isValidITypeInstruction(const std::string &instruction);
 bool isValidI1TypeInstruction(const std::string &instruction);
 bool isValidI2TypeInstruction(const std::string &instruction);
+bool isValidI2WordTypeInstruction(const std::string &instruction);
 bool isValidI3TypeInstruction(const std::string &instruction);
 bool isValidSTypeInstruction(const std::string &instruction);
 bool isValidBTypeInstruction(const std::string &instruction);
@@ -662,6 +928,10 @@ bool isValidBaseExtensionInstruction(const std::string &instruction);
 bool isValidMExtensionInstruction(const std::string &instruction);
 bool isValidFExtensionInstruction(const std::string &instruction);
 bool isValidDExtensionInstruction(const std::string &instruction);
+bool isValidZbaExtensionInstruction(const std::string &instruction);
+bool isValidZbbExtensionInstruction(const std::string &instruction);
+bool isValidVExtensionInstruction(const std::string &instruction);
+bool isValidAExtensionInstruction(const std::string &instruction);
 
 bool isValidCSRRTypeInstruction(const std::string &instruction);
 bool isValidCSRITypeInstruction(const std::string &instruction);
@@ -675,9 +945,6 @@ bool isValidFDR4TypeInstruction(const std::string &instruction);
 bool isValidFDITypeInstruction(const std::string &instruction);
 bool isValidFDSTypeInstruction(const std::string &instruction);
 
-bool isFInstruction(const uint32_t &instruction);
-bool isDInstruction(const uint32_t &instruction);
-
 std::string getExpectedSyntaxes(const std::string &opcode);
 
 } // namespace instruction_set
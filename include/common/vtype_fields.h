@@ -0,0 +1,45 @@
+/**
+ * @file vtype_fields.h
+ * @brief The vtype fields written in vsetvli / vsetivli: SEW, LMUL and the tail and mask policies
+ */
+#ifndef VTYPE_FIELDS_H
+#define VTYPE_FIELDS_H
+
+#include <string>
+#include <unordered_map>
+
+enum class VTypeField {
+  SEW,
+  LMUL,
+  TAIL,
+  MASK
+};
+
+struct VTypeFieldEncoding {
+  VTypeField field;
+  unsigned int bits;    // already shifted to their place in vtype
+};
+
+inline const std::unordered_map<std::string, VTypeFieldEncoding> stringToVTypeField = {
+    {"e8", {VTypeField::SEW, 0b000 << 3}},
+    {"e16", {VTypeField::SEW, 0b001 << 3}},
+    {"e32", {VTypeField::SEW, 0b010 << 3}},
+    {"e64", {VTypeField::SEW, 0b011 << 3}},
+    {"m1", {VTypeField::LMUL, 0b000}},
+    {"m2", {VTypeField::LMUL, 0b001}},
+    {"m4", {VTypeField::LMUL, 0b010}},
+    {"m8", {VTypeField::LMUL, 0b011}},
+    {"mf8", {VTypeField::LMUL, 0b101}},
+    {"mf4", {VTypeField::LMUL, 0b110}},
+    {"mf2", {VTypeField::LMUL, 0b111}},
+    {"tu", {VTypeField::TAIL, 0 << 6}},
+    {"ta", {VTypeField::TAIL, 1 << 6}},
+    {"mu", {VTypeField::MASK, 0 << 7}},
+    {"ma", {VTypeField::MASK, 1 << 7}},
+};
+
+inline bool isValidVTypeField(const std::string &field) {
+  return stringToVTypeField.find(field)!=stringToVTypeField.end();
+}
+
+#endif // VTYPE_FIELDS_H
@@ -23,7 +23,8 @@ namespace vm_config {
 // Top level choice of VM
 enum class VmTypes {
   SINGLE_STAGE,
-  MULTI_STAGE
+  MULTI_STAGE,
+  OUT_OF_ORDER
 };
 
 // Defines the Data Hazard Resolution Mode
@@ -48,6 +49,12 @@ enum class BranchStage {
     BRANCH_IN_ID                // Branch result decided in ID stage (using early comparator)
 };
 
+// Defines how the F/D instructions are computed
+enum class FpEngine {
+    HOST,                       // RNE add/sub/mul/div/sqrt in the common range on the host FPU, the rest in softfloat
+    SOFT                        // everything in softfloat
+};
+
 
 struct VmConfig {
   VmTypes vm_type = VmTypes::SINGLE_STAGE;
@@ -65,14 +72,56 @@ struct VmConfig {
 
   uint64_t instruction_execution_limit = 100;
 
+  // Front-end of the branch-in-ID pipeline
+  uint64_t ftq_depth = 0;               // fetch target queue entries, 0 -> front-end coupled to decode
+  uint64_t fetch_latency = 1;           // cycles per instruction memory access
+  uint64_t fetch_buffer_size = 8;       // instructions buffered between fetch and decode (decoupled front-end only)
+
+  // Superscalar (branch-in-EX) pipeline: instructions per cycle and functional unit ports per class
+  uint64_t issue_width = 1;
+  uint64_t alu_ports = 2;
+  uint64_t mem_ports = 1;
+  uint64_t branch_ports = 1;
+  uint64_t fp_ports = 1;
+
+  bool multi_cycle_units = false;       // branch-in-EX pipeline: M and F/D operations take the latency of their execution unit
+
+  std::string pipeline_trace_path;      // kanata stage timeline written by the 5-stage pipelines, empty -> off
+  bool lockstep_check = false;          // replay every instruction retired by the 5-stage pipelines on the single stage vm
+  uint64_t undo_depth = 1000;           // steps that can be undone, 0 -> no undo history
+  uint64_t checkpoint_interval = 100000;  // single stage vm: instructions between the checkpoints seek restores, 0 -> off
+  FpEngine fp_engine = FpEngine::HOST;
+  uint64_t vlen = 128;                  // bits of a vector register, a power of two from 64 to 4096
+  uint64_t vector_lanes = 2;            // 64-bit lanes of the vector unit, a vector operation occupies it vl * sew / (64 * lanes) cycles
+  uint64_t harts = 1;                   // harts sharing the memory, each vm run by its own host thread
+  uint64_t hart_quantum = 1000;         // cycles a hart runs before it waits for the others
+
+  // Out-of-order core: window sizes (issue_width and the functional unit ports above are shared)
+  uint64_t rob_size = 64;
+  uint64_t issue_queue_size = 32;       // entries of the unified queue, or of every queue when split
+  uint64_t lsq_size = 16;
+  uint64_t physical_registers = 96;     // integer physical registers, more than the 32 architectural ones
+  bool split_issue_queues = false;      // one issue queue per functional unit class instead of a unified one
+
   bool m_extension_enabled = true;
   bool f_extension_enabled = true;
   bool d_extension_enabled = true;
+  bool c_extension_enabled = false;     // the assembler emits the 16-bit RV64C form of the instructions that have one
+  bool zba_extension_enabled = true;
+  bool zbb_extension_enabled = true;
+  bool v_extension_enabled = true;
+  bool a_extension_enabled = true;
 
   void setVmType(const VmTypes &type) {
     if (type != vm_type) {
         vm_type = type;
-        std::cout << "Processor type set to: " << (type == VmTypes::SINGLE_STAGE ? "single_stage" : "multi_stage") << std::endl;
+        std::cout << "Processor type set to: ";
+        switch(type) {
+          case VmTypes::SINGLE_STAGE: std::cout << "single_stage"; break;
+          case VmTypes::MULTI_STAGE: std::cout << "multi_stage"; break;
+          case VmTypes::OUT_OF_ORDER: std::cout << "out_of_order"; break;
+        }
+        std::cout << std::endl;
         
         // resetting to default settings
         if (type == VmTypes::SINGLE_STAGE) {
@@ -180,6 +229,215 @@ struct VmConfig {
     return instruction_execution_limit;
   }
 
+  void setFtqDepth(uint64_t depth) {
+    ftq_depth = depth;
+    std::cout << "Fetch target queue depth set to: " << ftq_depth << (ftq_depth ? "" : " (coupled front-end)") << std::endl;
+  }
+
+  uint64_t getFtqDepth() const {
+    return ftq_depth;
+  }
+
+  void setFetchLatency(uint64_t latency) {
+    if (latency == 0) {
+      throw std::invalid_argument("fetch_latency must be at least 1 cycle.");
+    }
+    fetch_latency = latency;
+    std::cout << "Fetch latency set to: " << fetch_latency << " cycles" << std::endl;
+  }
+
+  uint64_t getFetchLatency() const {
+    return fetch_latency;
+  }
+
+  void setFetchBufferSize(uint64_t size) {
+    fetch_buffer_size = size;
+    std::cout << "Fetch buffer size set to: " << fetch_buffer_size << std::endl;
+  }
+
+  uint64_t getFetchBufferSize() const {
+    return fetch_buffer_size;
+  }
+
+  void setIssueWidth(uint64_t width) {
+    if (width == 0) {
+      throw std::invalid_argument("issue_width must be at least 1.");
+    }
+    issue_width = width;
+    std::cout << "Issue width set to: " << issue_width << std::endl;
+  }
+
+  uint64_t getIssueWidth() const {
+    return issue_width;
+  }
+
+  void setFunctionalUnitPorts(const std::string &unit, uint64_t ports) {
+    if (ports == 0) {
+      throw std::invalid_argument(unit + " must be at least 1.");
+    }
+    if (unit == "alu_ports") alu_ports = ports;
+    else if (unit == "mem_ports") mem_ports = ports;
+    else if (unit == "branch_ports") branch_ports = ports;
+    else if (unit == "fp_ports") fp_ports = ports;
+    else throw std::invalid_argument("Unknown functional unit: " + unit);
+    std::cout << "Functional unit " << unit << " set to: " << ports << std::endl;
+  }
+
+  uint64_t getAluPorts() const {
+    return alu_ports;
+  }
+  uint64_t getMemPorts() const {
+    return mem_ports;
+  }
+  uint64_t getBranchPorts() const {
+    return branch_ports;
+  }
+  uint64_t getFpPorts() const {
+    return fp_ports;
+  }
+
+  void setMultiCycleUnits(bool enabled) {
+    multi_cycle_units = enabled;
+    std::cout << "Multi-cycle functional units " << (enabled ? "enabled" : "disabled") << std::endl;
+  }
+
+  bool getMultiCycleUnits() const {
+    return multi_cycle_units;
+  }
+
+  void setPipelineTracePath(const std::string &path) {
+    pipeline_trace_path = (path == "off") ? "" : path;
+    std::cout << "Pipeline trace " << (pipeline_trace_path.empty() ? "disabled" : "written to: " + pipeline_trace_path) << std::endl;
+  }
+
+  const std::string &getPipelineTracePath() const {
+    return pipeline_trace_path;
+  }
+
+  void setLockstepCheck(bool enabled) {
+    lockstep_check = enabled;
+    std::cout << "Lockstep check " << (enabled ? "enabled" : "disabled") << std::endl;
+  }
+
+  bool getLockstepCheck() const {
+    return lockstep_check;
+  }
+
+  void setUndoDepth(uint64_t depth) {
+    undo_depth = depth;
+    std::cout << "Undo depth set to: " << undo_depth << " cycles" << std::endl;
+  }
+
+  uint64_t getUndoDepth() const {
+    return undo_depth;
+  }
+
+  void setCheckpointInterval(uint64_t interval) {
+    checkpoint_interval = interval;
+    std::cout << "Checkpoint interval set to: " << checkpoint_interval << " instructions" << std::endl;
+  }
+
+  uint64_t getCheckpointInterval() const {
+    return checkpoint_interval;
+  }
+
+  void setOooWindowSize(const std::string &structure, uint64_t size) {
+    if (structure == "physical_registers") {
+      if (size <= 32) {
+        throw std::invalid_argument("physical_registers must be more than the 32 architectural registers.");
+      }
+      physical_registers = size;
+    } else {
+      if (size == 0) {
+        throw std::invalid_argument(structure + " must be at least 1.");
+      }
+      if (structure == "rob_size") rob_size = size;
+      else if (structure == "issue_queue_size") issue_queue_size = size;
+      else if (structure == "lsq_size") lsq_size = size;
+      else throw std::invalid_argument("Unknown out-of-order structure: " + structure);
+    }
+    std::cout << "Out-of-order " << structure << " set to: " << size << std::endl;
+  }
+
+  uint64_t getRobSize() const {
+    return rob_size;
+  }
+  uint64_t getIssueQueueSize() const {
+    return issue_queue_size;
+  }
+  uint64_t getLsqSize() const {
+    return lsq_size;
+  }
+  uint64_t getPhysicalRegisters() const {
+    return physical_registers;
+  }
+
+  void setSplitIssueQueues(bool split) {
+    split_issue_queues = split;
+    std::cout << "Issue queues set to: " << (split ? "split" : "unified") << std::endl;
+  }
+
+  bool getSplitIssueQueues() const {
+    return split_issue_queues;
+  }
+
+  void setFpEngine(FpEngine engine) {
+    fp_engine = engine;
+    std::cout << "FP engine set to: " << (engine == FpEngine::SOFT ? "soft" : "host") << std::endl;
+  }
+
+  FpEngine getFpEngine() const {
+    return fp_engine;
+  }
+
+  void setVlen(uint64_t bits) {
+    if (bits < 64 || bits > 4096 || (bits & (bits - 1)) != 0) {
+      throw std::invalid_argument("vlen must be a power of two from 64 to 4096 bits.");
+    }
+    vlen = bits;
+    std::cout << "Vector register length set to: " << vlen << " bits" << std::endl;
+  }
+
+  uint64_t getVlen() const {
+    return vlen;
+  }
+
+  void setVectorLanes(uint64_t lanes) {
+    if (lanes == 0) {
+      throw std::invalid_argument("vector_lanes must be at least 1.");
+    }
+    vector_lanes = lanes;
+    std::cout << "Vector lanes set to: " << vector_lanes << std::endl;
+  }
+
+  uint64_t getVectorLanes() const {
+    return vector_lanes;
+  }
+
+  void setHarts(uint64_t count) {
+    if (count == 0) {
+      throw std::invalid_argument("harts must be at least 1.");
+    }
+    harts = count;
+    std::cout << "Harts set to: " << harts << std::endl;
+  }
+
+  uint64_t getHarts() const {
+    return harts;
+  }
+
+  void setHartQuantum(uint64_t cycles) {
+    if (cycles == 0) {
+      throw std::invalid_argument("hart_quantum must be at least 1.");
+    }
+    hart_quantum = cycles;
+    std::cout << "Hart quantum set to: " << hart_quantum << " cycles" << std::endl;
+  }
+
+  uint64_t getHartQuantum() const {
+    return hart_quantum;
+  }
+
   void setMExtensionEnabled(bool enabled) {
     m_extension_enabled = enabled;
   }
@@ -204,6 +462,46 @@ struct VmConfig {
     return d_extension_enabled;
   }
 
+  void setCExtensionEnabled(bool enabled) {
+    c_extension_enabled = enabled;
+  }
+
+  bool getCExtensionEnabled() const {
+    return c_extension_enabled;
+  }
+
+  void setZbaExtensionEnabled(bool enabled) {
+    zba_extension_enabled = enabled;
+  }
+
+  bool getZbaExtensionEnabled() const {
+    return zba_extension_enabled;
+  }
+
+  void setZbbExtensionEnabled(bool enabled) {
+    zbb_extension_enabled = enabled;
+  }
+
+  bool getZbbExtensionEnabled() const {
+    return zbb_extension_enabled;
+  }
+
+  void setVExtensionEnabled(bool enabled) {
+    v_extension_enabled = enabled;
+  }
+
+  bool getVExtensionEnabled() const {
+    return v_extension_enabled;
+  }
+
+  void setAExtensionEnabled(bool enabled) {
+    a_extension_enabled = enabled;
+  }
+
+  bool getAExtensionEnabled() const {
+    return a_extension_enabled;
+  }
+
   void modifyConfig(const std::string &section, const std::string &key, const std::string &value) {
     if (section == "Execution") {
       if (key == "processor_type") {
@@ -211,6 +509,8 @@ struct VmConfig {
           setVmType(VmTypes::SINGLE_STAGE);
         } else if (value == "multi_stage") {
           setVmType(VmTypes::MULTI_STAGE);
+        } else if (value == "out_of_order") {
+          setVmType(VmTypes::OUT_OF_ORDER);
         } else {
           throw std::invalid_argument("Unknown VM type: " + value);
         }
@@ -218,6 +518,55 @@ struct VmConfig {
         setRunStepDelay(std::stoull(value));
       } else if (key == "instruction_execution_limit") {
         setInstructionExecutionLimit(std::stoull(value));
+      } else if (key == "ftq_depth") {
+        setFtqDepth(std::stoull(value));
+      } else if (key == "fetch_latency") {
+        setFetchLatency(std::stoull(value));
+      } else if (key == "fetch_buffer_size") {
+        setFetchBufferSize(std::stoull(value));
+      } else if (key == "issue_width") {
+        setIssueWidth(std::stoull(value));
+      } else if (key == "alu_ports" || key == "mem_ports" || key == "branch_ports" || key == "fp_ports") {
+        setFunctionalUnitPorts(key, std::stoull(value));
+      } else if (key == "rob_size" || key == "issue_queue_size" || key == "lsq_size" || key == "physical_registers") {
+        setOooWindowSize(key, std::stoull(value));
+      } else if (key == "multi_cycle_units") {
+        if (value != "true" && value != "false") {
+          throw std::invalid_argument("multi_cycle_units must be true or false.");
+        }
+        setMultiCycleUnits(value == "true");
+      } else if (key == "pipeline_trace") {
+        setPipelineTracePath(value);
+      } else if (key == "lockstep_check") {
+        if (value != "true" && value != "false") {
+          throw std::invalid_argument("lockstep_check must be true or false.");
+        }
+        setLockstepCheck(value == "true");
+      } else if (key == "undo_depth") {
+        setUndoDepth(std::stoull(value));
+      } else if (key == "checkpoint_interval") {
+        setCheckpointInterval(std::stoull(value));
+      } else if (key == "fp_engine") {
+        if (value == "host") {
+          setFpEngine(FpEngine::HOST);
+        } else if (value == "soft") {
+          setFpEngine(FpEngine::SOFT);
+        } else {
+          throw std::invalid_argument("Unknown fp engine: " + value);
+        }
+      } else if (key == "vlen") {
+        setVlen(std::stoull(value));
+      } else if (key == "vector_lanes") {
+        setVectorLanes(std::stoull(value));
+      } else if (key == "harts") {
+        setHarts(std::stoull(value));
+      } else if (key == "hart_quantum") {
+        setHartQuantum(std::stoull(value));
+      } else if (key == "split_issue_queues") {
+        if (value != "true" && value != "false") {
+          throw std::invalid_argument("split_issue_queues must be true or false.");
+        }
+        setSplitIssueQueues(value == "true");
       }
 
       // Config Options for RV5S:
@@ -247,7 +596,7 @@ struct VmConfig {
         if (vm_type == VmTypes::SINGLE_STAGE) {
             throw std::invalid_argument("Cannot set branch_predictor when processor_type is single_stage.");
         }
-        if (data_hazard_mode == DataHazardMode::IDEAL) {
+        if (vm_type == VmTypes::MULTI_STAGE && data_hazard_mode == DataHazardMode::IDEAL) {
             throw std::invalid_argument("Cannot set branch_predictor when data_hazard_mode is 'ideal'.");
         }
         // if (data_hazard_mode == DataHazardMode::STALL_ONLY) {
@@ -304,6 +653,16 @@ struct VmConfig {
         setFExtensionEnabled(value == "true");
       } else if (key == "d_extension_enabled") {
         setDExtensionEnabled(value == "true");
+      } else if (key == "c_extension_enabled") {
+        setCExtensionEnabled(value == "true");
+      } else if (key == "zba_extension_enabled") {
+        setZbaExtensionEnabled(value == "true");
+      } else if (key == "zbb_extension_enabled") {
+        setZbbExtensionEnabled(value == "true");
+      } else if (key == "v_extension_enabled") {
+        setVExtensionEnabled(value == "true");
+      } else if (key == "a_extension_enabled") {
+        setAExtensionEnabled(value == "true");
       }
       else {
         throw std::invalid_argument("Unknown key in Assembler section: " + key);
@@ -6,7 +6,6 @@
 #ifndef ALU_H
 #define ALU_H
 
-#include <cfenv>
 #include <cmath>
 #include <cstdint>
 #include <ostream>
@@ -57,6 +56,38 @@ enum class AluOp {
     kSlt, ///< Set less than operation.
     kSltu, ///< Unsigned set less than operation.
 
+    // Zba / Zbb operations
+    kSh1add, ///< Shift left by one and add operation.
+    kSh2add, ///< Shift left by two and add operation.
+    kSh3add, ///< Shift left by three and add operation.
+    kAdduw, ///< Add unsigned word operation.
+    kSh1adduw, ///< Shift unsigned word left by one and add operation.
+    kSh2adduw, ///< Shift unsigned word left by two and add operation.
+    kSh3adduw, ///< Shift unsigned word left by three and add operation.
+    kSlliuw, ///< Shift left logical unsigned word operation.
+    kAndn, ///< Bitwise and with inverted operand operation.
+    kOrn, ///< Bitwise or with inverted operand operation.
+    kXnor, ///< Bitwise exclusive nor operation.
+    kClz, ///< Count leading zero bits operation.
+    kClzw, ///< Count leading zero bits word operation.
+    kCtz, ///< Count trailing zero bits operation.
+    kCtzw, ///< Count trailing zero bits word operation.
+    kCpop, ///< Count set bits operation.
+    kCpopw, ///< Count set bits word operation.
+    kMax, ///< Maximum operation.
+    kMaxu, ///< Unsigned maximum operation.
+    kMin, ///< Minimum operation.
+    kMinu, ///< Unsigned minimum operation.
+    kSextb, ///< Sign extend byte operation.
+    kSexth, ///< Sign extend halfword operation.
+    kZexth, ///< Zero extend halfword operation.
+    kRol, ///< Rotate left operation.
+    kRolw, ///< Rotate left word operation.
+    kRor, ///< Rotate right operation.
+    kRorw, ///< Rotate right word operation.
+    kOrcb, ///< Bitwise or-combine of each byte operation.
+    kRev8, ///< Byte reverse operation.
+
     // Floating point operations
     kFmadd_s, ///< Floating point multiply-add single operation.
     kFmsub_s, ///< Floating point multiply-subtract single operation.
@@ -159,6 +190,36 @@ inline std::ostream& operator<<(std::ostream& os, const AluOp& op) {
         case AluOp::kSllw: os << "kSllw"; break;
         case AluOp::kSrlw: os << "kSrlw"; break;
         case AluOp::kSraw: os << "kSraw"; break;
+        case AluOp::kSh1add: os << "kSh1add"; break;
+        case AluOp::kSh2add: os << "kSh2add"; break;
+        case AluOp::kSh3add: os << "kSh3add"; break;
+        case AluOp::kAdduw: os << "kAdduw"; break;
+        case AluOp::kSh1adduw: os << "kSh1adduw"; break;
+        case AluOp::kSh2adduw: os << "kSh2adduw"; break;
+        case AluOp::kSh3adduw: os << "kSh3adduw"; break;
+        case AluOp::kSlliuw: os << "kSlliuw"; break;
+        case AluOp::kAndn: os << "kAndn"; break;
+        case AluOp::kOrn: os << "kOrn"; break;
+        case AluOp::kXnor: os << "kXnor"; break;
+        case AluOp::kClz: os << "kClz"; break;
+        case AluOp::kClzw: os << "kClzw"; break;
+        case AluOp::kCtz: os << "kCtz"; break;
+        case AluOp::kCtzw: os << "kCtzw"; break;
+        case AluOp::kCpop: os << "kCpop"; break;
+        case AluOp::kCpopw: os << "kCpopw"; break;
+        case AluOp::kMax: os << "kMax"; break;
+        case AluOp::kMaxu: os << "kMaxu"; break;
+        case AluOp::kMin: os << "kMin"; break;
+        case AluOp::kMinu: os << "kMinu"; break;
+        case AluOp::kSextb: os << "kSextb"; break;
+        case AluOp::kSexth: os << "kSexth"; break;
+        case AluOp::kZexth: os << "kZexth"; break;
+        case AluOp::kRol: os << "kRol"; break;
+        case AluOp::kRolw: os << "kRolw"; break;
+        case AluOp::kRor: os << "kRor"; break;
+        case AluOp::kRorw: os << "kRorw"; break;
+        case AluOp::kOrcb: os << "kOrcb"; break;
+        case AluOp::kRev8: os << "kRev8"; break;
         case AluOp::kFmadd_s: os << "kFmadd_s"; break;
         case AluOp::kFmsub_s: os << "kFmsub_s"; break;
         case AluOp::kFnmadd_s: os << "kFnmadd_s"; break;
@@ -224,14 +285,37 @@ public:
      */
     [[nodiscard]] static std::pair<uint64_t, bool> execute(AluOp op, uint64_t a, uint64_t b) ;
 
-    // TODO: check all the floating point operations
+    /**
+     * @brief Executes the given F / D extension operation.
+     * @param op The alu operation.
+     * @param ina First operand, rs1 of the integer register file for the int to float conversions and moves.
+     * @param inb Second operand.
+     * @param inc Third operand (fused multiply-add).
+     * @param rm Rounding mode (frm encoding, already resolved when dynamic).
+     * @return A pair (result, fflags raised). Single precision operands must be NaN-boxed, single precision results are.
+     */
+    [[nodiscard]] std::pair<uint64_t, uint8_t> fpexecute(AluOp op, uint64_t ina, uint64_t inb, uint64_t inc, uint8_t rm) const;
+
+    [[nodiscard]] std::pair<uint64_t, uint8_t> dfpexecute(AluOp op, uint64_t ina, uint64_t inb, uint64_t inc, uint8_t rm) const {
+        return fpexecute(op, ina, inb, inc, rm);
+    }
 
-    [[nodiscard]] static std::pair<uint64_t, uint8_t> fpexecute(AluOp op, uint64_t ina, uint64_t inb, uint64_t inc, uint8_t rm) ;
+    /**
+     * @brief Selects the fp engine: false (default) runs RNE add / sub / mul / div / sqrt away from the subnormal and
+     * overflow ranges on the host FPU and everything else in softfloat, true runs everything in softfloat.
+     */
+    void setSoftFloat(bool soft) {
+        soft_float_ = soft;
+    }
 
-    [[nodiscard]] static std::pair<uint64_t, bool> dfpexecute(AluOp op, uint64_t ina, uint64_t inb, uint64_t inc, uint8_t rm) ;
+    [[nodiscard]] bool isSoftFloat() const {
+        return soft_float_;
+    }
 
     void setFlags(bool carry, bool zero, bool negative, bool overflow);
 
+private:
+    bool soft_float_ = false;
 };
 }
 
@@ -0,0 +1,48 @@
+/**
+ * @file atomic_unit.h
+ * @brief RV64A, lr / sc and the amos shared by the single cycle vm and the pipelines
+ */
+
+#ifndef ATOMIC_UNIT_H
+#define ATOMIC_UNIT_H
+
+#include "vm/memory_controller.h"
+
+#include <cstdint>
+
+// Every access is sequentially consistent, so aq and rl need nothing more. With a single hart the operations are plain
+// read-modify-writes of the memory; once the memory is shared between harts they run as host atomics on it under the
+// reservation stripe lock of their granule, and a store of any hart to the granule drops the reservations on it.
+namespace atomic_unit {
+
+// the reservation lr.w / lr.d leaves on its hart, bytes is 0 while there is none
+struct Reservation {
+    uint64_t address = 0;
+    uint64_t value = 0;
+    unsigned int bytes = 0;
+    uint64_t stores = 0;        // ReservationStripe::stores at the lr, on a shared memory
+
+    bool operator==(const Reservation &) const = default;
+};
+
+// funct7[6:2], which of lr / sc / amo* the instruction is
+uint8_t operation(uint32_t instruction);
+
+// 4 for the .w forms, 8 for .d
+unsigned int accessBytes(uint32_t instruction);
+
+/**
+ * @brief Executes lr, sc or an amo.
+ * @param operation As returned by operation().
+ * @param bytes As returned by accessBytes().
+ * @param address rs1, naturally aligned.
+ * @param rs2_value The value sc stores or the amo combines with memory.
+ * @param reservation The reservation of the hart, set by lr and dropped by every sc.
+ * @return The value of rd: the old memory value, sign extended for the .w forms, or 0 / 1 for a successful / failed sc.
+ */
+uint64_t execute(uint8_t operation, unsigned int bytes, uint64_t address, uint64_t rs2_value, MemoryController &memory,
+                 Reservation &reservation);
+
+} // namespace atomic_unit
+
+#endif // ATOMIC_UNIT_H
@@ -0,0 +1,48 @@
+/**
+ * @file branch_profile.h
+ * @brief Per-branch execution and misprediction statistics with source line attribution
+ */
+
+#ifndef BRANCH_PROFILE_H
+#define BRANCH_PROFILE_H
+
+#include "vm_asm_mw.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct BranchStats {
+    uint64_t executions = 0;
+    uint64_t taken = 0;
+    uint64_t mispredictions = 0;
+    uint64_t cycles_lost = 0;           // flush penalty summed over all mispredictions
+};
+
+class BranchProfile {
+public:
+    void Record(uint64_t pc, bool taken, bool mispredicted, unsigned int penalty_cycles);
+    void Clear();
+    bool Empty() const;
+
+    // Puts back the statistics of one branch as they were before a Record, profiled == false removes the branch
+    void Restore(uint64_t pc, bool profiled, const BranchStats &stats);
+
+    const std::unordered_map<uint64_t, BranchStats> &GetStats() const;
+
+    // Branches ordered by cycles lost, then mispredictions, then executions (all descending)
+    std::vector<std::pair<uint64_t, BranchStats>> Sorted() const;
+
+    void DumpJson(const std::filesystem::path &filename, const AssembledProgram &program) const;
+    void DumpCsv(const std::filesystem::path &filename, const AssembledProgram &program) const;
+
+    // Appends the statistics of every profiled branch to its line in the disassembly file, re-annotating replaces old notes
+    void AnnotateDisassembly(const std::filesystem::path &filename, const AssembledProgram &program) const;
+
+private:
+    std::unordered_map<uint64_t, BranchStats> stats_;
+};
+
+#endif // BRANCH_PROFILE_H
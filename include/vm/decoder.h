@@ -0,0 +1,106 @@
+/**
+ * @file decoder.h
+ * @brief Instruction decoder shared by all vms, a dense lookup table generated at compile time from the encoding array
+ */
+
+#ifndef DECODER_H
+#define DECODER_H
+
+#include "common/instructions.h"
+#include "vm/alu.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Every 32-bit instruction is decoded with two loads: the opcode selects a row, funct3 and funct7 select the
+// instruction in it. The few encodings told apart by the rs2 field (fsqrt, fcvt, fmv, fclass, clz, rev8, ...) go through
+// one more 32 entry table. The tables are filled from instruction_set::compiletime_instruction_encoding_array by decoder.cpp.
+namespace decoder {
+
+enum class ImmFormat : uint8_t {
+    kNone,      // R, R4 and SYSTEM, ImmGenerator returns 0
+    kI,
+    kS,
+    kB,
+    kU,         // the 20 upper bits, not shifted
+    kJ,
+};
+
+enum class OperandA : uint8_t {
+    kRs1,
+    kPc,        // auipc, jal
+    kZero,      // lui, csr*i
+};
+
+// what the control units need from an instruction, INVALID has every signal off
+struct DecodedOp {
+    instruction_set::Instruction instr = instruction_set::Instruction::INVALID;
+    alu::AluOp alu_op = alu::AluOp::kNone;
+    ImmFormat imm_format = ImmFormat::kNone;
+    OperandA operand_a = OperandA::kRs1;
+
+    bool alu_src = false;       // operand b is the immediate
+    bool reg_write = false;
+    bool mem_read = false;
+    bool mem_write = false;
+    bool mem_to_reg = false;    // rd gets the loaded value
+    bool branch = false;        // branches, jal and jalr
+
+    bool fp_unit = false;       // computed on the fp datapath of the alu (OP-FP, fused multiply add)
+    bool is_float = false;      // F extension, flw / fsw included
+    bool is_double = false;     // D extension, fld / fsd and fcvt.s.d included
+    bool rs1_fp = false;
+    bool rs2_fp = false;        // also the store data of fsw, fsd
+    bool uses_rs3 = false;
+    bool rd_fp = false;
+
+    bool is_csr = false;
+    bool is_syscall = false;
+
+    bool is_atomic = false;     // A extension, lr / sc / amo* go through the atomic unit in the memory stage
+    bool is_vector = false;     // V extension, executed by the vector unit; rs1 (and rs2 for the strided accesses) are scalars
+};
+
+namespace detail {
+
+constexpr std::size_t kNumInstructions = static_cast<std::size_t>(instruction_set::Instruction::COUNT);
+constexpr std::size_t kRows = 24;               // distinct major opcodes + row 0 for the illegal ones
+constexpr std::size_t kFunct5Groups = 40;
+constexpr std::size_t kFirstGroup = kNumInstructions;  // table entries from here on select a funct5 group
+
+static_assert(kFirstGroup + kFunct5Groups <= 65536, "instruction ids and funct5 groups must fit in 16 bits");
+
+struct DecodeTables {
+    std::array<uint8_t, 128> row_of_opcode{};
+    std::array<std::array<uint16_t, 8 * 128>, kRows> rows{};             // [row][funct3 << 7 | funct7]
+    std::array<std::array<uint16_t, 32>, kFunct5Groups> funct5_groups{};  // [group][rs2]
+    std::array<DecodedOp, kNumInstructions> ops{};
+};
+
+extern const DecodeTables kTables;
+
+} // namespace detail
+
+// constexpr only inside decoder.cpp, where the tables are defined
+constexpr const DecodedOp &decode(uint32_t instruction) {
+    const detail::DecodeTables &tables = detail::kTables;
+    uint8_t row = tables.row_of_opcode[instruction & 0b1111111];
+    uint16_t id = tables.rows[row][((instruction >> 12) & 0b111) << 7 | instruction >> 25];
+    if (id >= detail::kFirstGroup) {
+        id = tables.funct5_groups[id - detail::kFirstGroup][(instruction >> 20) & 0b11111];
+    }
+    return tables.ops[id];
+}
+
+// RV64C: a parcel whose two low bits are not 11 is a 16-bit instruction
+constexpr bool isCompressed(uint32_t parcel) {
+    return (parcel & 0b11) != 0b11;
+}
+
+// the 32-bit instruction a compressed one expands to, 0 (illegal) for the reserved encodings
+uint32_t expandCompressed(uint16_t parcel);
+
+} // namespace decoder
+
+#endif // DECODER_H
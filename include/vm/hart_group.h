@@ -0,0 +1,49 @@
+/**
+ * @file hart_group.h
+ * @brief N harts on one guest memory, each vm run by its own host thread, synchronised every time quantum
+ */
+
+#ifndef HART_GROUP_H
+#define HART_GROUP_H
+
+#include "vm/vm_base.h"
+#include "vm/vm_fork.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// The harts start at the pc of the boot vm, on copies of its registers and on one copy of its memory they all share.
+// mhartid is the index of the hart. Every hart runs quantum cycles (instructions on the single stage vm), then waits
+// until all the harts still running are done with theirs: no hart gets more than one quantum ahead of another, and
+// within a quantum their memory accesses interleave as the host threads happen to run them. The harts keep no undo
+// history or checkpoints and are not lockstep checked.
+class HartGroup {
+public:
+    // builds the harts with factory, the boot vm itself does not run
+    HartGroup(const VmBase &boot, std::size_t harts, const VmFactory &factory, uint64_t quantum);
+
+    HartGroup(const HartGroup &) = delete;
+    HartGroup &operator=(const HartGroup &) = delete;
+
+    // Runs every hart to the end of the program, to its exit syscall or to instruction_execution_limit retired
+    // instructions (0 -> no limit). The first exception a hart threw is rethrown once all of them stopped.
+    void Run();
+
+    [[nodiscard]] std::size_t Size() const;
+    [[nodiscard]] VmBase &Hart(std::size_t index);
+    [[nodiscard]] uint64_t Quanta() const;      // quanta run so far
+
+    // "quanta" and "harts", the counters of every hart, as json members at indent
+    void DumpHartCounters(std::ostream &file, const std::string &indent) const;
+
+private:
+    std::vector<std::unique_ptr<VmBase>> harts_;
+    uint64_t quantum_;
+    uint64_t quanta_ = 0;
+};
+
+#endif // HART_GROUP_H
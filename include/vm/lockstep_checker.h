@@ -0,0 +1,57 @@
+/**
+ * @file lockstep_checker.h
+ * @brief Co-simulation against the single stage VM: every instruction retired by a pipelined VM is replayed on a golden RVSSVM and compared
+ */
+
+#ifndef LOCKSTEP_CHECKER_H
+#define LOCKSTEP_CHECKER_H
+
+#include "vm/rvss/rvss_vm.h"
+#include "vm/vector_unit.h"
+
+#include <cstdint>
+#include <string>
+
+// What the pipeline did for one retired instruction, taken in WB after its register write
+struct RetiredInstruction {
+    uint64_t pc = 0;
+    bool writes_rd = false;         // false if the result is still in a multi-cycle unit, it is then checked through its consumers
+    bool rd_fp = false;
+    uint8_t rd_index = 0;
+    bool is_syscall = false;
+};
+
+class LockstepChecker {
+public:
+    // the golden vm starts from the current memory, registers and pc of dut, attach before the first step
+    explicit LockstepChecker(VmBase &dut);
+
+    // replays one instruction on the golden vm, returns false at the first divergence (and from then on)
+    bool check(const RetiredInstruction &retired);
+
+    // the pipeline drained, returns false if the golden vm still had instructions to run
+    bool checkEnd();
+
+    bool diverged() const {
+        return diverged_;
+    }
+
+    const std::string &report() const {
+        return report_;
+    }
+
+private:
+    VmBase &dut_;
+    RVSSVM golden_;
+    uint64_t checked_ = 0;          // instructions compared so far
+    bool diverged_ = false;
+    std::string report_;
+
+    void stepGolden();
+    void replaySyscall();           // copies the effect of an ecall from dut, the syscall itself runs only once
+    // the memory elements and vector register words a vector instruction wrote, compared after the golden vm ran it
+    bool checkVectorWrites(const vector_unit::Footprint &writes, uint64_t pc, uint32_t instruction);
+    void diverge(const std::string &what, uint64_t pc, uint32_t instruction);
+};
+
+#endif // LOCKSTEP_CHECKER_H
@@ -9,6 +9,10 @@
 
 #include "config.h"
 
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
@@ -19,17 +23,26 @@
  * @brief Represents a memory block containing 1 KB of memory.
  */
 struct MemoryBlock {
-  std::vector<uint8_t> data; ///< A vector representing the memory block data.
+  std::shared_ptr<std::vector<uint8_t>> data; ///< The memory block data, shared with the snapshots taken since its last write.
   unsigned int block_size = vm_config::config.getMemoryBlockSize(); ///< The size of the memory block in bytes.
 
   /**
    * @brief Constructs a MemoryBlock with a size of 1 KB initialized to 0.
    */
   MemoryBlock() {
-    data.resize(block_size, 0);
+    data = std::make_shared<std::vector<uint8_t>>(block_size, 0);
   }
 };
 
+/**
+ * @brief Lock and store count of the lr / sc reservation granules (aligned 8 bytes) hashing to it, while the memory is
+ *        shared between harts.
+ */
+struct ReservationStripe {
+  std::mutex mutex;
+  uint64_t stores = 0; ///< Stores to any of its granules, counted under the mutex.
+};
+
 /**
  * @brief Represents a memory management system with dynamic memory block allocation.
  */
@@ -39,6 +52,17 @@ class Memory {
   unsigned int block_size_; ///< The size of each memory block in bytes.
   uint64_t memory_size_ = vm_config::config.getMemorySize(); ///< The total memory size in bytes.
 
+  // While the harts of a HartGroup share the memory, blocks_ is guarded by table_mutex_ and the blocks are written in
+  // place, never copied on write or freed. generation_ tells the harts whether the blocks they looked up last are
+  // still the ones of this memory.
+  bool shared_ = false;
+  std::shared_ptr<std::shared_mutex> table_mutex_;
+  uint64_t generation_ = 0;
+
+  // every store to the shared memory counts in the stripe of its granule, an sc succeeds only if none did since the lr
+  static constexpr size_t kReservationStripes = 256;
+  std::shared_ptr<std::array<ReservationStripe, kReservationStripes>> reservation_stripes_;
+
   /**
    * @brief Gets the block index for a given memory address.
    * @param address The memory address.
@@ -66,6 +90,14 @@ class Memory {
    */
   void EnsureBlockExists(uint64_t block_index);
 
+  /**
+   * @brief Looks up a block of a shared memory, through a small per-thread cache of the blocks looked up last.
+   * @param block_index The index of the block.
+   * @param create Whether to create the block when it does not exist yet.
+   * @return The data of the block, nullptr if it does not exist and create is false.
+   */
+  uint8_t *SharedBlock(uint64_t block_index, bool create);
+
   /**
    * @brief Generic function to read data of type T from the memory.
    * @tparam T The type of data to read.
@@ -85,6 +117,11 @@ class Memory {
   void WriteGeneric(uint64_t address, T value);
 
  public:
+  /**
+   * @brief Copy-on-write image of the memory: the blocks are shared until either side writes to them.
+   */
+  using Snapshot = std::unordered_map<uint64_t, MemoryBlock>;
+
   /**
    * @brief Constructs a Memory object.
    */
@@ -96,8 +133,31 @@ class Memory {
    */
   ~Memory() = default;
 
-  void Reset() {
-    blocks_.clear();
+  void Reset();
+
+  /**
+   * @brief Takes a snapshot of the memory, only the block table is copied.
+   * @return The snapshot.
+   */
+  Snapshot TakeSnapshot() const {
+    return blocks_;
+  }
+
+  /**
+   * @brief Brings the memory back to a snapshot, the blocks stay shared with it.
+   * @param snapshot The snapshot to restore.
+   */
+  void RestoreSnapshot(const Snapshot &snapshot);
+
+  /**
+   * @brief Lets several host threads access the memory at once. Aligned loads and stores are then single-copy atomic
+   *        (acquire / release on the host), the others are done byte by byte. No snapshot may be taken while shared.
+   * @param shared True while the harts run on the memory.
+   */
+  void SetShared(bool shared);
+
+  bool IsShared() const {
+    return shared_;
   }
 
   /**
@@ -178,6 +238,22 @@ class Memory {
 
   void WriteDouble(uint64_t address, double value);
 
+  /**
+   * @brief Host memory backing a naturally aligned access, for the atomics. The block is created and made private to
+   *        this memory (copy on write) first.
+   * @param address The memory address of the access.
+   * @param size The size of the access in bytes.
+   * @return The host address of its first byte, nullptr if it is misaligned or out of range.
+   */
+  uint8_t *HostBytes(uint64_t address, unsigned int size);
+
+  /**
+   * @brief The reservation stripe of the granule of address. The stores to a shared memory lock it and count in it.
+   * @param address The memory address.
+   * @return The stripe, nullptr while the memory is not shared.
+   */
+  ReservationStripe *Reservations(uint64_t address);
+
   void PrintMemory(uint64_t address, unsigned int rows);
 
   void DumpMemory(std::vector<std::string> args);
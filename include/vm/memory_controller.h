@@ -11,6 +11,7 @@
 #include "main_memory.h"
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -20,77 +21,123 @@
  */
 class MemoryController {
 private:
-    Memory memory_; ///< The main memory object.
+    std::shared_ptr<Memory> memory_ = std::make_shared<Memory>(); ///< The main memory object, the harts of a HartGroup share one.
 public:
     MemoryController() = default;
 
+    // a copy gets its own block table, the blocks stay shared with the original until either side writes them. The
+    // copy is not shared between harts, even when the original is.
+    MemoryController(const MemoryController &other) : memory_(std::make_shared<Memory>(*other.memory_)) {
+        memory_->SetShared(false);
+    }
+
+    MemoryController &operator=(const MemoryController &other) {
+        if (this != &other) {
+            memory_ = std::make_shared<Memory>(*other.memory_);
+            memory_->SetShared(false);
+        }
+        return *this;
+    }
+
+    // runs on the memory of other from now on, see HartGroup
+    void ShareMemoryOf(const MemoryController &other) {
+        memory_ = other.memory_;
+    }
+
     void Reset() {
-        memory_.Reset();
+        memory_->Reset();
+    }
+
+    [[nodiscard]] Memory::Snapshot TakeSnapshot() const {
+        return memory_->TakeSnapshot();
+    }
+
+    void RestoreSnapshot(const Memory::Snapshot &snapshot) {
+        memory_->RestoreSnapshot(snapshot);
     }
 
     void PrintCacheStatus() const {
     }
 
+    // several harts access the memory at once, the atomics then run as host atomics, see Memory::SetShared
+    void SetShared(bool shared) {
+        memory_->SetShared(shared);
+    }
+
+    [[nodiscard]] bool IsShared() const {
+        return memory_->IsShared();
+    }
+
+    // host memory of an aligned access, nullptr otherwise, see Memory::HostBytes
+    [[nodiscard]] uint8_t *HostBytes(uint64_t address, unsigned int size) {
+        return memory_->HostBytes(address, size);
+    }
+
+    // lock and store count of the reservation granule of address, nullptr while not shared, see Memory::Reservations
+    [[nodiscard]] ReservationStripe *Reservations(uint64_t address) {
+        return memory_->Reservations(address);
+    }
+
     void WriteByte(uint64_t address, uint8_t value) {
-      memory_.WriteByte(address, value);
+      memory_->WriteByte(address, value);
     }
 
     void WriteHalfWord(uint64_t address, uint16_t value) {
-      memory_.WriteHalfWord(address, value);
+      memory_->WriteHalfWord(address, value);
     }
 
     void WriteWord(uint64_t address, uint32_t value) {
-      memory_.WriteWord(address, value);
+      memory_->WriteWord(address, value);
     }
 
     void WriteDoubleWord(uint64_t address, uint64_t value) {
-      memory_.WriteDoubleWord(address, value);
+      memory_->WriteDoubleWord(address, value);
     }
 
     [[nodiscard]] uint8_t ReadByte(uint64_t address) {
-        return memory_.ReadByte(address);
+        return memory_->ReadByte(address);
     }
 
     [[nodiscard]] uint16_t ReadHalfWord(uint64_t address) {
-        return memory_.ReadHalfWord(address);
+        return memory_->ReadHalfWord(address);
     }
 
     [[nodiscard]] uint32_t ReadWord(uint64_t address) {
-        return memory_.ReadWord(address);
+        return memory_->ReadWord(address);
     }
 
     [[nodiscard]] uint64_t ReadDoubleWord(uint64_t address) {
-        return memory_.ReadDoubleWord(address);
+        return memory_->ReadDoubleWord(address);
     }
 
     // Functions to read memory directly with cache bypass
 
     [[nodiscard]] uint8_t ReadByte_d(uint64_t address) {
-        return memory_.ReadByte(address);
+        return memory_->ReadByte(address);
     }
 
     [[nodiscard]] uint16_t ReadHalfWord_d(uint64_t address) {
-        return memory_.ReadHalfWord(address);
+        return memory_->ReadHalfWord(address);
     }
 
     [[nodiscard]] uint32_t ReadWord_d(uint64_t address) {
-        return memory_.ReadWord(address);
+        return memory_->ReadWord(address);
     }
 
     [[nodiscard]] uint64_t ReadDoubleWord_d(uint64_t address) {
-        return memory_.ReadDoubleWord(address);
+        return memory_->ReadDoubleWord(address);
     }
 
     void PrintMemory(const uint64_t address, unsigned int rows) {
-      memory_.PrintMemory(address, rows);
+      memory_->PrintMemory(address, rows);
     }
 
     void DumpMemory(std::vector<std::string> args) {
-      memory_.DumpMemory(args);
+      memory_->DumpMemory(args);
     }
 
     void GetMemoryPoint(std::string address) {
-      return memory_.GetMemoryPoint(address);
+      return memory_->GetMemoryPoint(address);
     }
 
 };
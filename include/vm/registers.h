@@ -21,15 +21,50 @@ class RegisterFile {
  private:
   static constexpr size_t NUM_GPR = 32; ///< Number of General-Purpose Registers (GPR).
   static constexpr size_t NUM_FPR = 32; ///< Number of Floating-Point Registers (FPR).
+  static constexpr size_t GPR_SINK = NUM_GPR; ///< Extra GPR slot that takes the writes to x0, so x0 always reads 0.
 
-  std::array<uint64_t, NUM_GPR> gpr_ = {}; ///< Array for storing GPR values.
+  alignas(64) std::array<uint64_t, NUM_GPR + 1> gpr_ = {}; ///< Array for storing GPR values, and the x0 sink.
   std::array<uint64_t, NUM_FPR> fpr_ = {}; ///< Array for storing FPR values.
 
-  static constexpr size_t NUM_CSR = 4096; ///< Number of Control and Status Registers (CSR).
+  static constexpr size_t NUM_VR = 32; ///< Number of vector registers.
 
-  std::array<uint64_t, NUM_CSR> csr_ = {}; ///< Array for storing CSR values.
+  // The vector registers are VLEN / 64 words each and stored one after the other, so a register group (LMUL > 1) is a
+  // contiguous run of words. VLEN is read from the config on Reset.
+  std::vector<uint64_t> vregs_;
+  uint64_t vl_ = 0;
+  uint64_t vtype_ = VTYPE_VILL;
+
+  static constexpr size_t NUM_CSR = 4096; ///< Size of the CSR address space.
+
+  // Only the CSRs in implemented_csrs have state: fflags and frm are fields of fcsr, and the counters are read from the
+  // vm owning the register file plus the offset a write to mcycle / minstret leaves.
+  uint64_t fcsr_ = 0;
+  uint64_t cycle_offset_ = 0;
+  uint64_t instret_offset_ = 0;
+  uint64_t hart_id_ = 0;    ///< mhartid, set by the HartGroup the vm runs in and kept across Reset.
+
+  /**
+   * @brief Counters of the vm that owns the register file. Copies leave them unbound and assignment keeps those of
+   * the destination, so a checkpoint or a forked vm never reads the counters of another vm.
+   */
+  struct CounterSources {
+    const unsigned int *cycles = nullptr;
+    const unsigned int *instructions_retired = nullptr;
+
+    CounterSources() = default;
+    CounterSources(const CounterSources &) {}
+    CounterSources &operator=(const CounterSources &) { return *this; }
+  };
+  CounterSources counters_;
+
+  [[nodiscard]] uint64_t Cycles() const { return counters_.cycles ? *counters_.cycles : 0; }
+  [[nodiscard]] uint64_t InstructionsRetired() const {
+    return counters_.instructions_retired ? *counters_.instructions_retired : 0;
+  }
 
  public:
+  static constexpr uint64_t VTYPE_VILL = uint64_t{1} << 63; ///< vtype.vill, set while no legal vtype is configured.
+
   /**
    * @brief Enum representing the type of a register.
    */
@@ -45,38 +80,122 @@ class RegisterFile {
 
   void Reset();
 
+  /**
+   * @brief Binds the cycle, time, instret and mcycle / minstret CSRs to the counters of a vm, they are computed on
+   * read and never stored.
+   */
+  void BindCounters(const unsigned int *cycles, const unsigned int *instructions_retired);
+
+  void SetHartId(uint64_t hart_id) {
+    hart_id_ = hart_id;
+  }
+
+  // The accessors below are the hot path of every vm and do not check the index, it is masked to the field width of
+  // the instruction encoding (5 bits for GPR / FPR, 12 bits for CSR). The *Checked variants throw std::out_of_range
+  // and are meant for indices coming from the user. A CSR that is not implemented reads 0 and ignores writes, a write
+  // only changes the bits in the write_mask of its implemented_csrs entry, so a read-only CSR ignores it as well. The
+  // vms report such accesses of the csr instructions, see CheckCsrAccess.
+
   /**
    * @brief Reads the value of a General-Purpose Register (GPR).
    * @param reg The index of the GPR to read.
    * @return The value of the GPR at the specified index.
    */
-  [[nodiscard]] uint64_t ReadGpr(size_t reg) const;
+  [[nodiscard]] uint64_t ReadGpr(size_t reg) const {
+    return gpr_[reg & (NUM_GPR - 1)];
+  }
 
   /**
-   * @brief Writes a value to a General-Purpose Register (GPR).
+   * @brief Writes a value to a General-Purpose Register (GPR), a write to x0 goes to the sink slot.
    * @param reg The index of the GPR to write.
    * @param value The value to write.
    */
-  void WriteGpr(size_t reg, uint64_t value);
+  void WriteGpr(size_t reg, uint64_t value) {
+    size_t index = reg & (NUM_GPR - 1);
+    gpr_[index == 0 ? GPR_SINK : index] = value;
+  }
 
   /**
    * @brief Reads the value of a Floating-Point Register (FPR).
    * @param reg The index of the FPR to read.
    * @return The value of the FPR at the specified index.
    */
-  [[nodiscard]] uint64_t ReadFpr(size_t reg) const;
+  [[nodiscard]] uint64_t ReadFpr(size_t reg) const {
+    return fpr_[reg & (NUM_FPR - 1)];
+  }
 
   /**
    * @brief Writes a value to a Floating-Point Register (FPR).
    * @param reg The index of the FPR to write.
    * @param value The value to write.
    */
-  void WriteFpr(size_t reg, uint64_t value);
+  void WriteFpr(size_t reg, uint64_t value) {
+    fpr_[reg & (NUM_FPR - 1)] = value;
+  }
+
+  /**
+   * @brief Returns the words of a vector register, the registers of a group follow it.
+   * @param reg The index of the first vector register.
+   */
+  [[nodiscard]] uint64_t *VectorRegister(size_t reg) {
+    return vregs_.data() + (reg & (NUM_VR - 1)) * VectorRegisterWords();
+  }
+
+  [[nodiscard]] const uint64_t *VectorRegister(size_t reg) const {
+    return vregs_.data() + (reg & (NUM_VR - 1)) * VectorRegisterWords();
+  }
+
+  /**
+   * @brief Words of 64 bits in one vector register, VLEN / 64.
+   */
+  [[nodiscard]] size_t VectorRegisterWords() const {
+    return vregs_.size() / NUM_VR;
+  }
+
+  /**
+   * @brief Reads a word of the vector register file, the index runs over all the registers (v1 starts at
+   * VectorRegisterWords()).
+   */
+  [[nodiscard]] uint64_t ReadVectorWord(size_t index) const {
+    return vregs_[index];
+  }
+
+  void WriteVectorWord(size_t index, uint64_t value) {
+    vregs_[index] = value;
+  }
+
+  [[nodiscard]] uint64_t VectorLength() const {
+    return vl_;
+  }
+
+  [[nodiscard]] uint64_t VectorType() const {
+    return vtype_;
+  }
+
+  /**
+   * @brief Sets vl and vtype, only vset{i}vl{i} and the undo of one change them.
+   */
+  void SetVectorConfig(uint64_t vl, uint64_t vtype) {
+    vl_ = vl;
+    vtype_ = vtype;
+  }
 
   [[nodiscard]] uint64_t ReadCsr(size_t reg) const;
 
   void WriteCsr(size_t reg, uint64_t value);
 
+  [[nodiscard]] uint64_t ReadGprChecked(size_t reg) const;
+
+  void WriteGprChecked(size_t reg, uint64_t value);
+
+  [[nodiscard]] uint64_t ReadFprChecked(size_t reg) const;
+
+  void WriteFprChecked(size_t reg, uint64_t value);
+
+  [[nodiscard]] uint64_t ReadCsrChecked(size_t reg) const;
+
+  void WriteCsrChecked(size_t reg, uint64_t value);
+
   /**
    * @brief Retrieves the values of all General-Purpose Registers (GPR).
    * @return A vector containing the values of all GPRs.
@@ -89,6 +208,17 @@ class RegisterFile {
    */
   [[nodiscard]] std::vector<uint64_t> GetFprValues() const;
 
+  /**
+   * @brief Retrieves the words of all vector registers, VectorRegisterWords() per register.
+   * @return A vector containing the words of v0 to v31.
+   */
+  [[nodiscard]] std::vector<uint64_t> GetVectorValues() const;
+
+  /**
+   * @brief Replaces the vector register file, vl and vtype, the words must hold 32 registers of the current VLEN.
+   */
+  void SetVectorState(const std::vector<uint64_t> &words, uint64_t vl, uint64_t vtype);
+
 
   void ModifyRegister(const std::string &reg_name, uint64_t value);
 
@@ -98,6 +228,46 @@ extern const std::unordered_set<std::string> valid_general_purpose_registers;
 
 extern const std::unordered_set<std::string> valid_floating_point_registers;
 
+extern const std::unordered_set<std::string> valid_vector_registers;
+
+/**
+ * @brief A CSR implemented by the register file.
+ */
+struct CsrInfo {
+  const char *name;
+  uint16_t address;
+  uint64_t write_mask; ///< Bits a write can change, 0 for the read-only counters.
+};
+
+/**
+ * @brief The implemented CSRs, ordered by address.
+ */
+extern const std::array<CsrInfo, 12> implemented_csrs;
+
+/**
+ * @brief The implemented_csrs entry of a CSR, null when it is not implemented.
+ */
+const CsrInfo *FindCsr(size_t address);
+
+bool IsImplementedCsr(size_t address);
+
+/**
+ * @brief What a csr instruction runs into: kReadOnly when it writes a CSR whose write mask is 0, kUnimplemented for
+ * any access to a CSR that is not implemented.
+ */
+enum class CsrAccess {
+  kOk,
+  kReadOnly,
+  kUnimplemented,
+};
+
+CsrAccess CheckCsrAccess(size_t address, bool write);
+
+/**
+ * @brief Whether a CSR is one of the counters computed from the vm, cycle, time, instret, mcycle and minstret.
+ */
+bool IsCounterCsr(size_t address);
+
 extern const std::unordered_set<std::string> valid_csr_registers;
 
 extern const std::unordered_map<std::string, int> csr_to_address;
@@ -111,6 +281,8 @@ bool IsValidGeneralPurposeRegister(const std::string &reg);
 
 bool IsValidFloatingPointRegister(const std::string &reg);
 
+bool IsValidVectorRegister(const std::string &reg);
+
 bool IsValidCsr(const std::string &reg);
 
 #endif // REGISTERS_H
\ No newline at end of file
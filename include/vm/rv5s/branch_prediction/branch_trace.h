@@ -0,0 +1,97 @@
+/**
+ * @file branch_trace.h
+ * @brief Recording of control transfer outcomes and offline replay of the trace through the branch predictors
+ */
+
+#ifndef BRANCH_TRACE_H
+#define BRANCH_TRACE_H
+
+#include "config.h"
+#include "vm/rv5s/branch_prediction/i_branch_predictor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Kind of control transfer, jal / jalr link when rd is x1 or x5 and return when they jump through one of them
+enum class BranchType : uint8_t {
+    kConditional,       // beq .. bgeu
+    kJump,              // jal without link
+    kCall,              // jal with link
+    kIndirectJump,      // jalr without link, not a return
+    kIndirectCall,      // jalr with link
+    kReturn,            // jalr without link through x1 / x5
+};
+
+// the type of a jal / jalr instruction from its rd and rs1
+BranchType jumpType(uint32_t instruction);
+
+// One dynamic instance of a branch or jump, a jump is always taken
+struct BranchTraceRecord {
+    uint64_t pc = 0;
+    uint64_t target = 0;
+    bool taken = false;
+    BranchType type = BranchType::kConditional;
+};
+
+class BranchTrace {
+private:
+    std::vector<BranchTraceRecord> records_;
+    uint64_t instruction_count_ = 0;          // total instructions retired while recording, used for MPKI
+
+public:
+    void record(uint64_t pc, uint64_t target, bool taken, BranchType type = BranchType::kConditional) {
+        records_.push_back({pc, target, taken, type});
+    }
+
+    void clear() {
+        records_.clear();
+        instruction_count_ = 0;
+    }
+
+    const std::vector<BranchTraceRecord>& getRecords() const {
+        return records_;
+    }
+
+    void setInstructionCount(uint64_t count) {
+        instruction_count_ = count;
+    }
+    uint64_t getInstructionCount() const {
+        return instruction_count_;
+    }
+
+    // binary trace file, throws std::runtime_error on failure. Version 1 files, which hold only the conditional
+    // branches and no type, still load.
+    void save(const std::filesystem::path &filename) const;
+    static BranchTrace load(const std::filesystem::path &filename);
+};
+
+// A predictor configuration to be evaluated against a trace
+struct ReplayConfig {
+    vm_config::BranchPredictorType type = vm_config::BranchPredictorType::STATIC_NOT_TAKEN;
+    std::size_t table_size = 0;               // bht entries for the dynamic predictors, 0 -> unbounded
+};
+
+// only the conditional branches go through the direction predictors, the jumps are counted
+struct ReplayResult {
+    ReplayConfig config;
+    uint64_t branches = 0;                    // conditional ones
+    uint64_t mispredictions = 0;
+    double accuracy = 0.0;                    // in percent
+    double mpki = 0.0;                        // mispredictions per kilo instruction
+};
+
+// Creates a predictor of the given type, throws std::invalid_argument for unsupported types
+std::unique_ptr<IBranchPredictor> makeBranchPredictor(vm_config::BranchPredictorType type, std::size_t table_size = 0);
+
+std::string branchPredictorName(vm_config::BranchPredictorType type);
+
+ReplayResult replayTrace(const BranchTrace &trace, const ReplayConfig &config);
+
+// Replays the trace through every config on a pool of worker threads, results are in the order of configs
+std::vector<ReplayResult> replayTraceParallel(const BranchTrace &trace, const std::vector<ReplayConfig> &configs, unsigned int num_threads = 0);
+
+#endif // BRANCH_TRACE_H
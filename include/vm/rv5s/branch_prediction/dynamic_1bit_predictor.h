@@ -7,6 +7,7 @@
 #define DYNAMIC_1BIT_PREDICTOR_H
 
 #include "vm/rv5s/branch_prediction/i_branch_predictor.h"
+#include <cstddef>
 #include <map>
 
 class Dynamic1BitPredictor : public IBranchPredictor {
@@ -17,10 +18,22 @@ private:
     // stores 1 bit for every PC entry -> true for branch taken and false for branch not taken
     std::map<uint64_t, bool> bht_; 
 
+    // no of bht entries, 0 -> unbounded (one entry per branch pc)
+    std::size_t table_size_ = 0;
+
+    uint64_t index(uint64_t pc) const {
+        return table_size_ ? (pc >> 2) % table_size_ : pc;
+    }
+
 public:
     Dynamic1BitPredictor() = default;
+    explicit Dynamic1BitPredictor(std::size_t table_size) : table_size_(table_size) {}
 
     bool getPrediction(uint64_t pc) override;
+    PredictorEntry saveEntry(uint64_t pc) const override;
+    void restoreEntry(uint64_t pc, const PredictorEntry &entry) override;
+    void saveTable(StateWriter &writer) const override;
+    void loadTable(StateReader &reader) override;
     void updateState(uint64_t pc, bool predicted_outcome, bool actual_outcome) override;
     
     unsigned int getMispredictions() const override {
@@ -10,6 +10,15 @@
     #include <cstdint>
     #include <iostream>
 
+    class StateWriter;
+    class StateReader;
+
+    // State of the one entry an updateState(pc, ...) call changes, plus the misprediction count
+    struct PredictorEntry {
+        uint8_t state = 0;                  // absent entries read as 0 (not taken)
+        unsigned int mispredictions = 0;
+    };
+
     class IBranchPredictor {
         public: 
             virtual ~IBranchPredictor() = default;
@@ -20,6 +29,18 @@
             // Updates the state of the predictor, after the actual branch outcome is determined. Also increments the no of mispredictions
             virtual void updateState(uint64_t pc, bool predicted, bool actual_outcome) = 0;
 
+            // Save / restore of the entry of pc, used by the pipelines to undo a cycle
+            virtual PredictorEntry saveEntry(uint64_t pc) const = 0;
+            virtual void restoreEntry(uint64_t pc, const PredictorEntry &entry) = 0;
+
+            // Whole table and misprediction count, for save_state / load_state
+            virtual void saveTable(StateWriter &writer) const = 0;
+            virtual void loadTable(StateReader &reader) = 0;
+
+            // The predictor section of a state file, the table saved by another predictor type is skipped
+            void saveState(StateWriter &writer) const;
+            void loadState(StateReader &reader);
+
             // Getter for no of mispredictions of the branch
             virtual unsigned int getMispredictions() const = 0;
 
@@ -8,6 +8,7 @@
 
     #include "config.h"
     #include "vm/rv5s/branch_prediction/i_branch_predictor.h"
+    #include "vm/state_file.h"
     #include <cstdint>
     #include <iostream>
 
@@ -17,13 +18,25 @@
             vm_config::BranchPredictorType type_ = vm_config::BranchPredictorType::STATIC_TAKEN;
     public: 
         bool getPrediction(uint64_t /*pc*/) override {
-            return false;  
+            return true;  
         }
     
         void updateState(uint64_t /*pc*/, bool predicted_outcome, bool actual_outcome) override {
             if(predicted_outcome != actual_outcome) 
                 no_mispredictions_++;
         }
+        PredictorEntry saveEntry(uint64_t /*pc*/) const override {
+            return {0, no_mispredictions_};
+        }
+        void restoreEntry(uint64_t /*pc*/, const PredictorEntry &entry) override {
+            no_mispredictions_ = entry.mispredictions;
+        }
+        void saveTable(StateWriter &writer) const override {
+            writer.write(no_mispredictions_);
+        }
+        void loadTable(StateReader &reader) override {
+            reader.read(no_mispredictions_);
+        }
         unsigned int getMispredictions() const override {
             return no_mispredictions_;
         }
@@ -39,13 +52,25 @@
             vm_config::BranchPredictorType type_ = vm_config::BranchPredictorType::STATIC_NOT_TAKEN;
     public: 
         bool getPrediction(uint64_t /*pc*/) override {
-            return true;
+            return false;
         }
     
         void updateState(uint64_t /*pc*/, bool predicted_outcome, bool actual_outcome) override {
             if(predicted_outcome != actual_outcome)
                 no_mispredictions_++;
         }
+        PredictorEntry saveEntry(uint64_t /*pc*/) const override {
+            return {0, no_mispredictions_};
+        }
+        void restoreEntry(uint64_t /*pc*/, const PredictorEntry &entry) override {
+            no_mispredictions_ = entry.mispredictions;
+        }
+        void saveTable(StateWriter &writer) const override {
+            writer.write(no_mispredictions_);
+        }
+        void loadTable(StateReader &reader) override {
+            reader.read(no_mispredictions_);
+        }
         unsigned int getMispredictions() const override {
             return no_mispredictions_;
         }
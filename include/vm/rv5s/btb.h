@@ -5,6 +5,9 @@
 
 #ifndef BTB_H
 #define BTB_H
+    #include "vm/state_file.h"
+
+    #include <cstdint>
     #include <unordered_map>
 
     struct BTBEntry {
@@ -30,9 +33,41 @@
             table[pc] = {true, target};
         }
         
+        // Puts back an entry as lookup returned it before an update
+        void restore(uint64_t pc, bool hit, uint64_t target) {
+            if (hit) {
+                table[pc] = {true, target};
+            } else {
+                table.erase(pc);
+            }
+        }
+
         void reset() {
             table.clear();
         }
+
+        void saveState(StateWriter &writer) const {
+            writer.beginSection(state_file::kTagBtb);
+            writer.write(static_cast<uint64_t>(table.size()));
+            for (const auto &[pc, entry] : table) {
+                writer.write(pc);
+                writer.write(entry);
+            }
+            writer.endSection();
+        }
+
+        void loadState(StateReader &reader) {
+            uint64_t count = 0;
+            reader.read(count);
+            table.clear();
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t pc = 0;
+                BTBEntry entry;
+                if (reader.read(pc) && reader.read(entry)) {
+                    table[pc] = entry;
+                }
+            }
+        }
     };
 
 #endif
\ No newline at end of file
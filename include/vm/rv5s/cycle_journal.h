@@ -0,0 +1,231 @@
+/**
+ * @file cycle_journal.h
+ * @brief Bounded ring of per-cycle deltas that lets the 5-stage pipelines step backwards one cycle at a time
+ */
+
+#ifndef CYCLE_JOURNAL_H
+#define CYCLE_JOURNAL_H
+
+#include "vm/vm_base.h"
+#include "vm/rv5s/pipeline_registers.h"
+#include "vm/rv5s/btb.h"
+#include "vm/rv5s/branch_prediction/i_branch_predictor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+// State every 5-stage vm snapshots at the start of a cycle, each vm extends it with its own front-end / unit state
+struct PipelineSnapshot {
+    IF_ID_Reg if_id, next_if_id;
+    ID_EX_Reg id_ex, next_id_ex;
+    EX_MEM_Reg ex_mem, next_ex_mem;
+    MEM_WB_Reg mem_wb, next_mem_wb;
+
+    uint64_t program_counter = 0;
+    unsigned int cycle_s = 0;
+    unsigned int instructions_retired = 0;
+    unsigned int stall_cycles = 0;
+    unsigned int branch_mispredictions = 0;
+    float cpi = 0;
+    float ipc = 0;
+    StallAccounting stall_accounting;
+    atomic_unit::Reservation reservation;
+
+    void saveCounters(const VmBase &vm) {
+        program_counter = vm.program_counter_;
+        cycle_s = vm.cycle_s_;
+        instructions_retired = vm.instructions_retired_;
+        stall_cycles = vm.stall_cycles_;
+        branch_mispredictions = vm.branch_mispredictions_;
+        cpi = vm.cpi_;
+        ipc = vm.ipc_;
+        stall_accounting = vm.stall_accounting_;
+        reservation = vm.reservation_;
+    }
+
+    void restoreCounters(VmBase &vm) const {
+        vm.program_counter_ = program_counter;
+        vm.cycle_s_ = cycle_s;
+        vm.instructions_retired_ = instructions_retired;
+        vm.stall_cycles_ = stall_cycles;
+        vm.branch_mispredictions_ = branch_mispredictions;
+        vm.cpi_ = cpi;
+        vm.ipc_ = ipc;
+        vm.stall_accounting_ = stall_accounting;
+        vm.reservation_ = reservation;
+    }
+};
+
+// A cycle is recorded as the small state the vm snapshots at its start (pipeline registers, counters) plus the old value
+// of every register, memory byte and predictor entry the cycle overwrites. Slots are reused, so a full ring records
+// without allocating.
+template <typename Snapshot>
+class CycleJournal {
+public:
+    // 0 disables the journal, any change drops the recorded cycles
+    void setDepth(std::size_t depth) {
+        ring_.clear();
+        ring_.resize(depth);
+        newest_ = 0;
+        size_ = 0;
+    }
+
+    bool enabled() const {
+        return !ring_.empty();
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    void clear() {
+        size_ = 0;
+    }
+
+    // opens the record of a new cycle (the oldest one is dropped when the ring is full), the caller fills the snapshot
+    Snapshot &beginCycle() {
+        newest_ = (size_ == 0) ? 0 : (newest_ + 1) % ring_.size();
+        if (size_ < ring_.size()) {
+            size_++;
+        }
+        Entry &entry = ring_[newest_];
+        entry.registers.clear();
+        entry.memory.clear();
+        entry.has_branch = false;
+        return entry.snapshot;
+    }
+
+    // the record of the running cycle, for the deltas a vm keeps in its own snapshot; null while nothing is recorded
+    Snapshot *newestCycle() {
+        return size_ ? &ring_[newest_].snapshot : nullptr;
+    }
+
+    void saveGpr(const RegisterFile &registers, std::size_t index) {
+        if (size_) ring_[newest_].registers.push_back({RegisterKind::GPR, static_cast<uint16_t>(index), registers.ReadGpr(index)});
+    }
+
+    void saveFpr(const RegisterFile &registers, std::size_t index) {
+        if (size_) ring_[newest_].registers.push_back({RegisterKind::FPR, static_cast<uint16_t>(index), registers.ReadFpr(index)});
+    }
+
+    void saveCsr(const RegisterFile &registers, std::size_t index) {
+        if (size_) ring_[newest_].registers.push_back({RegisterKind::CSR, static_cast<uint16_t>(index), registers.ReadCsr(index)});
+    }
+
+    // words of the vector register file, indexed as by RegisterFile::ReadVectorWord
+    void saveVectorWords(const RegisterFile &registers, std::size_t first, std::size_t words) {
+        if (!size_) return;
+        for (std::size_t i = 0; i < words; ++i) {
+            ring_[newest_].registers.push_back({RegisterKind::VECTOR, static_cast<uint16_t>(first + i), registers.ReadVectorWord(first + i)});
+        }
+    }
+
+    void saveVectorConfig(const RegisterFile &registers) {
+        if (!size_) return;
+        ring_[newest_].registers.push_back({RegisterKind::VCONFIG, 0, registers.VectorLength()});
+        ring_[newest_].registers.push_back({RegisterKind::VCONFIG, 1, registers.VectorType()});
+    }
+
+    void saveMemory(MemoryController &memory, uint64_t address, std::size_t bytes) {
+        if (!size_) return;
+        for (std::size_t i = 0; i < bytes; ++i) {
+            ring_[newest_].memory.push_back({address + i, memory.ReadByte(address + i)});
+        }
+    }
+
+    // a scalar pipeline resolves at most one branch per cycle, btb is null for the pipelines without one
+    void saveBranch(uint64_t pc, const IBranchPredictor &predictor, const BranchProfile &profile, BranchTargetBuffer *btb = nullptr) {
+        if (!size_) return;
+        Entry &entry = ring_[newest_];
+        entry.has_branch = true;
+        entry.branch_pc = pc;
+        entry.predictor = predictor.saveEntry(pc);
+        auto it = profile.GetStats().find(pc);
+        entry.profiled = (it != profile.GetStats().end());
+        entry.profile = entry.profiled ? it->second : BranchStats{};
+        if (btb) {
+            std::tie(entry.btb_hit, entry.btb_target) = btb->lookup(pc);
+        }
+    }
+
+    // reverts the writes of the newest cycle and returns its snapshot, which stays valid until the next beginCycle
+    const Snapshot &undoCycle(RegisterFile &registers, MemoryController &memory) {
+        Entry &entry = ring_[newest_];
+        for (auto it = entry.memory.rbegin(); it != entry.memory.rend(); ++it) {
+            memory.WriteByte(it->address, it->old_value);
+        }
+        for (auto it = entry.registers.rbegin(); it != entry.registers.rend(); ++it) {
+            switch (it->kind) {
+                case RegisterKind::GPR: registers.WriteGpr(it->index, it->old_value); break;
+                case RegisterKind::FPR: registers.WriteFpr(it->index, it->old_value); break;
+                case RegisterKind::CSR: registers.WriteCsr(it->index, it->old_value); break;
+                case RegisterKind::VECTOR: registers.WriteVectorWord(it->index, it->old_value); break;
+                case RegisterKind::VCONFIG:
+                    if (it->index == 0) {
+                        registers.SetVectorConfig(it->old_value, registers.VectorType());
+                    } else {
+                        registers.SetVectorConfig(registers.VectorLength(), it->old_value);
+                    }
+                    break;
+            }
+        }
+
+        newest_ = (newest_ + ring_.size() - 1) % ring_.size();
+        size_--;
+        return entry.snapshot;
+    }
+
+    // same, for the pipelines that also have a predictor (and a btb) to revert
+    const Snapshot &undoCycle(RegisterFile &registers, MemoryController &memory, IBranchPredictor &predictor,
+                              BranchProfile &profile, BranchTargetBuffer *btb = nullptr) {
+        const Entry &entry = ring_[newest_];
+        if (entry.has_branch) {
+            predictor.restoreEntry(entry.branch_pc, entry.predictor);
+            profile.Restore(entry.branch_pc, entry.profiled, entry.profile);
+            if (btb) {
+                btb->restore(entry.branch_pc, entry.btb_hit, entry.btb_target);
+            }
+        }
+        return undoCycle(registers, memory);
+    }
+
+private:
+    enum class RegisterKind : uint8_t { GPR, FPR, CSR, VECTOR, VCONFIG };     // VCONFIG: vl (index 0), vtype (1)
+
+    struct RegisterWrite {
+        RegisterKind kind;
+        uint16_t index;
+        uint64_t old_value;
+    };
+
+    struct MemoryWrite {
+        uint64_t address;
+        uint8_t old_value;
+    };
+
+    struct Entry {
+        Snapshot snapshot{};
+        std::vector<RegisterWrite> registers;
+        std::vector<MemoryWrite> memory;
+
+        bool has_branch = false;
+        uint64_t branch_pc = 0;
+        PredictorEntry predictor;
+        bool profiled = false;
+        BranchStats profile;
+        bool btb_hit = false;
+        uint64_t btb_target = 0;
+    };
+
+    std::vector<Entry> ring_;
+    std::size_t newest_ = 0;
+    std::size_t size_ = 0;
+};
+
+#endif // CYCLE_JOURNAL_H
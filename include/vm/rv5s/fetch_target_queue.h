@@ -0,0 +1,108 @@
+/**
+ * @file fetch_target_queue.h
+ * @brief Definition of the Fetch Target Queue used by the decoupled front-end: the branch predictor pushes predicted fetch blocks, the fetch unit consumes them. The fetch buffer is a queue of the same kind
+ */
+
+#ifndef FETCH_TARGET_QUEUE_H
+#define FETCH_TARGET_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A run of sequential instructions ending at a fetch block boundary or at a predicted taken branch
+struct FetchTarget {
+    uint64_t start_pc = 0;
+    unsigned int count = 0;                 // no of instructions in the block
+    bool predicted_taken = false;           // last instruction of the block is a predicted taken branch
+    uint64_t predicted_target = 0;
+};
+
+// Queue over a fixed number of slots. Pops only move the head and the size and a push writes a single slot, so a cycle
+// journal restores the queue from the mark taken at the start of the cycle plus the old value of every slot the pushes
+// of the cycle overwrote: a slot popped in an older cycle may be pushed into in a newer one.
+template <typename T>
+class RingQueue {
+private:
+    std::vector<T> slots_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+
+public:
+    struct Mark {
+        std::size_t head = 0;
+        std::size_t size = 0;
+    };
+
+    RingQueue() = default;
+    explicit RingQueue(std::size_t capacity) : slots_(capacity) {}
+
+    bool push(const T &value) {
+        if (full()) {
+            return false;
+        }
+        slots_[tailSlot()] = value;
+        size_++;
+        return true;
+    }
+
+    void pop() {
+        head_ = (head_ + 1) % slots_.size();
+        size_--;
+    }
+
+    const T& front() const {
+        return slots_[head_];
+    }
+
+    // the entry index places behind the front
+    const T& at(std::size_t index) const {
+        return slots_[(head_ + index) % slots_.size()];
+    }
+
+    void clear() {
+        size_ = 0;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    bool full() const {
+        return size_ >= slots_.size();
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    std::size_t capacity() const {
+        return slots_.size();
+    }
+
+    Mark mark() const {
+        return {head_, size_};
+    }
+
+    // the slot the next push writes, only while the queue is not full
+    std::size_t tailSlot() const {
+        return (head_ + size_) % slots_.size();
+    }
+
+    const T& slot(std::size_t index) const {
+        return slots_[index];
+    }
+
+    void restoreSlot(std::size_t index, const T &value) {
+        slots_[index] = value;
+    }
+
+    void rewind(const Mark &mark) {
+        head_ = mark.head;
+        size_ = mark.size;
+    }
+};
+
+using FetchTargetQueue = RingQueue<FetchTarget>;
+
+#endif // FETCH_TARGET_QUEUE_H
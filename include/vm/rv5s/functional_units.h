@@ -0,0 +1,70 @@
+/**
+ * @file functional_units.h
+ * @brief Functional unit classes shared by the multi-issue cores (superscalar pipeline, out-of-order core)
+ */
+
+#ifndef FUNCTIONAL_UNITS_H
+#define FUNCTIONAL_UNITS_H
+
+#include "vm/alu.h"
+
+#include <cstdint>
+#include <vector>
+
+// Functional unit class an instruction needs an issue port of
+enum class FuClass {
+    ALU,
+    MEM,
+    BRANCH,
+    FP
+};
+
+// Classifies an instruction by its opcode
+inline FuClass getFuClass(uint32_t instruction) {
+    switch (instruction & 0b1111111) {
+        case 0b0000011: case 0b0100011:                     // integer loads, stores
+        case 0b0000111: case 0b0100111:                     // fp loads, stores
+            return FuClass::MEM;
+        case 0b1100011: case 0b1101111: case 0b1100111:     // branches, jal, jalr
+            return FuClass::BRANCH;
+        case 0b1010011:
+        case 0b1000011: case 0b1000111: case 0b1001011: case 0b1001111:
+            return FuClass::FP;
+        default:
+            return FuClass::ALU;
+    }
+}
+
+// Execution units behind the EX stage when multi-cycle units are enabled
+enum class FuUnit {
+    INT_ALU,
+    INT_MUL,
+    INT_DIV,
+    FP_ADD,
+    FP_MUL,
+    FP_FMA,
+    FP_DIV_SQRT,
+    FP_MISC,            // sign injection, compares, class, conversions and moves
+    VECTOR              // the vector unit, iterative: busy for vector_unit::occupancy cycles per instruction
+};
+
+struct FuTiming {
+    FuUnit unit = FuUnit::INT_ALU;
+    unsigned int latency = 1;           // cycles from entering EX to the result being available
+    bool pipelined = true;              // false -> iterative unit, busy for the whole latency
+};
+
+// Latency / throughput table indexed by the alu operation
+FuTiming getFuTiming(alu::AluOp op);
+
+// An operation still running in a multi-cycle unit, its result is written to the register file on completion
+struct InFlightFuOp {
+    FuUnit unit = FuUnit::INT_ALU;
+    bool has_dest = false;              // false for ops without rd and for writes to x0
+    bool rd_fp = false;                 // rd is an fpr
+    uint8_t rd_index = 0;
+    uint64_t result = 0;
+    unsigned int remaining_cycles = 0;
+};
+
+#endif // FUNCTIONAL_UNITS_H
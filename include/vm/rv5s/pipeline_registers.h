@@ -7,6 +7,7 @@
 #define PIPELINE_REGISTERS_H
 
 #include "vm/alu.h"
+#include "vm/stall_accounting.h"
 #include <cstdint>
 
 namespace instruction_type {
@@ -30,6 +31,16 @@ namespace instruction_type {
         MEM_WRITE_DOUBLE
     };
 
+    // bytes written by a store, 0 for MEM_WRITE_NONE
+    inline unsigned int storeSize(MemWriteOp op) {
+        return op == MEM_WRITE_NONE ? 0 : 1u << (op - MEM_WRITE_BYTE);
+    }
+
+    // bytes lr / sc / amo* access, their mem_read_op is the word or double word load
+    inline unsigned int atomicSize(MemReadOp op) {
+        return op == MEM_READ_DOUBLE ? 8 : 4;
+    }
+
     enum WriteBackSrc {
         WB_NONE,
         WB_FROM_ALU,
@@ -76,8 +87,19 @@ struct ControlSignals {
     bool mem_to_reg = false;
     instruction_type::WriteBackSrc wb_src = instruction_type::WB_NONE;
 
+    // Register file selection for the F / D extensions (all false -> integer instruction)
+    bool is_fp = false;         // executed on the fp datapath of the alu
+    bool is_double = false;     // D extension, uses Alu::dfpexecute
+    bool rs1_fp = false;        // rs1 is read from the fpr file
+    bool rs2_fp = false;        // rs2 is read from the fpr file (also the store data of fsw, fsd)
+    bool uses_rs3 = false;      // fused multiply add, rs3 is always an fpr
+    bool rd_fp = false;         // rd is written to the fpr file
+
     bool is_csr = false;
     bool is_syscall = false;
+    bool is_vector = false;     // run by the vector unit in MEM, vset{i}vl{i} in EX; rs1 / rs2 are the scalar operands
+    bool is_atomic = false;     // lr / sc / amo*, run by the atomic unit in MEM with rs2 as the store data
+    uint8_t atomic_op = 0;      // atomic_unit::operation() of the instruction
     // // Additional control to detect nops/fp instrs -> is this really required ? 
     bool is_nop = true;
 };
@@ -86,16 +108,21 @@ struct ControlSignals {
 // The pipeline registers: 
 struct IF_ID_Reg {
     bool is_valid = false;
+    StallReason bubble_reason = StallReason::FRONTEND;     // why this register holds a bubble, recorded when it reaches WB
+    uint64_t trace_id = 0;              // id of the instruction in the pipeline trace, 0 -> not traced
     uint32_t instruction = 0;           // the original instruction fetched from memory 
     uint64_t pc = 0;            // pc of the original instruction -> will be needed in pc relative addressing later.
     uint64_t pc_inc = 0;                    // the incremented program counter
 
     bool predicted_outcome = false;             // for early prediction
     uint64_t predicted_target = 0;
+    bool btb_hit = false;                       // fetch found the pc in the btb
 };
 
 struct ID_EX_Reg {
     bool is_valid = false;
+    StallReason bubble_reason = StallReason::FRONTEND;
+    uint64_t trace_id = 0;
     ControlSignals control;   // All control signals
     uint64_t pc = 0;           // the original pc
     uint64_t pc_inc = 0;          // the incremented pc
@@ -103,6 +130,7 @@ struct ID_EX_Reg {
     // Data read from register file
     uint64_t rs1_data = 0;
     uint64_t rs2_data = 0;
+    uint64_t rs3_data = 0;      // fused multiply add only
 
     // Immediate value
     int32_t immediate = 0;
@@ -110,29 +138,51 @@ struct ID_EX_Reg {
     // Register indices
     uint8_t rs1_index = 0;
     uint8_t rs2_index = 0;
+    uint8_t rs3_index = 0;
     uint8_t rd_index = 0;
 
+    uint32_t instruction = 0;   // raw instruction, the fp rounding mode and the csr fields are taken from it in EX
+
     bool predicted_outcome = false;         // the branch predicted in case of branch instruction in the earlier stage, required to determine if it was a misprediction or not
 };
 
 struct EX_MEM_Reg {
     bool is_valid = false;
+    StallReason bubble_reason = StallReason::FRONTEND;
+    uint64_t trace_id = 0;
     ControlSignals control; // Passed from ID/EX. All control signals included for simplicity (even those not reqd by this stage) 
 
+    uint64_t pc = 0;        // checked against the golden vm in lockstep mode
     uint64_t pc_inc = 0;    // for jal, jalr
     uint64_t alu_result = 0;    // If data from alu is to be written back
     uint64_t store_data = 0; // Data from rs2, for store instructions
     uint8_t rd_index = 0;    // register index for write back 
+    uint8_t fflags = 0;      // exception flags raised by an fp instruction, accrued into fcsr in WB
+    uint32_t instruction = 0;   // vector instructions only, the vector unit decodes it in MEM
 };
 
 struct MEM_WB_Reg {
     bool is_valid = false;
+    StallReason bubble_reason = StallReason::FRONTEND;
+    uint64_t trace_id = 0;
     ControlSignals control; // Passed from EX/MEM. All control signals included for simplicity (even those not reqd by this stage)
 
+    uint64_t pc = 0;
     uint64_t pc_inc = 0;      // for jal, jalr
     uint64_t memory_data = 0; // Data read from memory
     uint64_t alu_result = 0;  // IF data from alu is to be written back
     uint8_t rd_index = 0;       // register index for write back
+    uint8_t fflags = 0;         // exception flags raised by an fp instruction, accrued into fcsr in WB
 };
 
+// pc of the oldest valid instruction in the pipeline registers, fallback if they all hold bubbles
+inline uint64_t oldestPipelinePc(const IF_ID_Reg &if_id, const ID_EX_Reg &id_ex, const EX_MEM_Reg &ex_mem,
+                                 const MEM_WB_Reg &mem_wb, uint64_t fallback) {
+    if (mem_wb.is_valid) return mem_wb.pc;
+    if (ex_mem.is_valid) return ex_mem.pc;
+    if (id_ex.is_valid) return id_ex.pc;
+    if (if_id.is_valid) return if_id.pc;
+    return fallback;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+/**
+ * @file pipeline_trace.h
+ * @brief Per-instruction stage timeline of the 5-stage pipelines, streamed in the Kanata log format read by Konata
+ */
+
+#ifndef PIPELINE_TRACE_H
+#define PIPELINE_TRACE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Instructions are given a non zero trace id when they are fetched, the id travels with them through the pipeline registers.
+// Every call is a no-op while no trace file is open, so the hooks can stay in the stages.
+class PipelineTrace {
+public:
+    enum class Stage : uint8_t { FETCH, DECODE, EXECUTE, MEMORY, WRITEBACK, COUNT };
+
+    PipelineTrace() = default;
+    PipelineTrace(const PipelineTrace &) = delete;
+    PipelineTrace &operator=(const PipelineTrace &) = delete;
+    ~PipelineTrace();
+
+    // truncates the file and writes the header, returns false if it could not be opened
+    bool open(const std::filesystem::path &filename);
+    void close();       // ends the last cycle and flushes the buffer
+
+    bool isOpen() const {
+        return file_.is_open();
+    }
+
+    // called once at the start of every cycle, before any stage runs
+    void beginCycle(uint64_t cycle) {
+        if (isOpen()) advanceTo(cycle);
+    }
+
+    // returns the id of the new instruction, 0 if tracing is off
+    uint64_t fetch(uint64_t pc, uint32_t instruction) {
+        return isOpen() ? startInstruction(pc, instruction) : 0;
+    }
+
+    // a stage that holds an instruction for several cycles (a stalled decode) only starts it once
+    void enterStage(uint64_t id, Stage stage) {
+        if (id != 0 && last_id_[static_cast<std::size_t>(stage)] != id) startStage(id, stage);
+    }
+
+    // a retired instruction leaves at the end of the current cycle, so its writeback stays visible for one cycle
+    void retire(uint64_t id) {
+        if (id != 0) retiring_.push_back(id);
+    }
+
+    // a squashed instruction never did the work of the current cycle, it leaves at its start
+    void squash(uint64_t id) {
+        if (id != 0) endInstruction(id, true);
+    }
+
+private:
+    static constexpr std::size_t kBufferSize = 1 << 16;     // bytes collected before a write to the file
+    static constexpr std::size_t kNumStages = static_cast<std::size_t>(Stage::COUNT);
+
+    std::ofstream file_;
+    std::string buffer_;
+    std::vector<uint64_t> retiring_;            // retired in the current cycle, written once the cycle is over
+    std::array<uint64_t, kNumStages> last_id_{};
+    uint64_t next_id_ = 1;
+    uint64_t retired_ = 0;
+    uint64_t cycle_ = 0;
+
+    void advanceTo(uint64_t cycle);
+    uint64_t startInstruction(uint64_t pc, uint32_t instruction);
+    void startStage(uint64_t id, Stage stage);
+    void endInstruction(uint64_t id, bool squashed);
+
+    void append(std::string_view text);
+    void appendNumber(uint64_t value);
+    void appendHex(uint64_t value);
+    void writeBuffer();
+};
+
+#endif // PIPELINE_TRACE_H
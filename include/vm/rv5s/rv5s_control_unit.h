@@ -14,11 +14,25 @@ public:
     RV5SControlUnit() = default;
     ~RV5SControlUnit() = default;
 
-    // Generates control signals from an instruction
+    // Generates control signals from an instruction, decoded by the decoder shared with the single cycle vm
     ControlSignals getControlSignals(uint32_t instruction);
 
     // Returns a "disable all" control signal, that acts as a nop 
     ControlSignals CreateNOP();
+
+    // F / D and Zicsr decode, only for the pipelines that implement the fp datapath and csr access
+    void enableFpCsrDecode(bool enable);
+
+    // V decode, only for the pipelines with a vector unit
+    void enableVectorDecode(bool enable);
+
+    // A decode, only for the pipelines that run lr / sc / amo* in their memory stage
+    void enableAtomicDecode(bool enable);
+
+private:
+    bool fp_csr_enabled_ = false;
+    bool vector_enabled_ = false;
+    bool atomic_enabled_ = false;
 };
 
 #endif
@@ -11,12 +11,16 @@
     #include "vm/rv5s/rv5s_control_unit.h"
     #include "vm/rv5s/rv5s_hazard_unit.h"
     #include "vm/rv5s/rv5s_forwarding_unit.h"
+    #include "vm/rv5s/functional_units.h"
+    #include "vm/rv5s/pipeline_trace.h"
+    #include "vm/rv5s/cycle_journal.h"
     #include "vm/rv5s/branch_prediction/i_branch_predictor.h"
     #include "config.h"                  // see if reqd later 
 
     #include <cstdint>
     #include <iostream> 
     #include <string>  
+    #include <vector>
 
     class RV5SEXVM : public VmBase {
         public: 
@@ -29,6 +33,9 @@
             void Undo() override;
             void Redo() override;
             void Reset() override;
+            uint64_t ResumePc() const override;
+            void SaveMicroarchState(StateWriter &writer) override;
+            bool LoadMicroarchSection(StateReader &reader, uint32_t tag) override;
 
             void DumpState(const std::filesystem::path &filename);
             void enableForwarding(bool enable);                     // to change config during testing
@@ -47,6 +54,23 @@
             bool stall_request_ = false;            // to indicate a stall signal from the decode stage
             bool flush_pipeline_ = false;           // to flush pipeline in case of branch taken in branch instructions
             bool forwarding_enabled_ = false;
+            StallReason flush_reason_ = StallReason::BRANCH_MISPREDICT;     // cause given to the bubbles of a flush
+            PipelineTrace pipeline_trace_;
+
+            bool multi_cycle_units_ = false;                // operations take the latency of their unit in getFuTiming()
+            uint64_t vector_lanes_ = 2;                     // 64-bit lanes of the vector unit, see vector_unit::occupancy
+            std::vector<InFlightFuOp> fu_in_flight_;        // long operations that left EX but have not produced their result yet
+            uint64_t fu_structural_stalls_ = 0;             // cycles decode waited for a busy iterative unit
+            uint64_t long_latency_stalls_ = 0;              // cycles decode waited on a result / rd of a long operation
+
+            struct CycleSnapshot : PipelineSnapshot {
+                std::vector<InFlightFuOp> fu_in_flight;
+                uint64_t fu_structural_stalls = 0;
+                uint64_t long_latency_stalls = 0;
+                StallReason flush_reason = StallReason::BRANCH_MISPREDICT;
+            };
+            CycleJournal<CycleSnapshot> journal_;           // undo history, one record per cycle
+            unsigned int redo_cycles_ = 0;                  // cycles undone since the last step, redo runs them again
 
             IF_ID_Reg if_id_reg_{};             // pipeline registers to hold state at beginning of a clock cycle
             ID_EX_Reg id_ex_reg_{};
@@ -65,12 +89,23 @@
             void WriteBack_Stage();
 
             template <typename RegType> 
-            RegType CreateBubble() {                // function to create a bubble of an register type
+            RegType CreateBubble(StallReason reason = StallReason::FRONTEND) {     // function to create a bubble of an register type
                 RegType bubble;
                 bubble.is_valid = false;
+                bubble.bubble_reason = reason;
                 return bubble;
             }
 
             uint64_t getWriteBackData();            // to forward the correct data that wlil be written back to register file
+            void completeFunctionalUnits();         // advances the multi-cycle units and writes back finished results
+            void startFunctionalUnit(alu::AluOp op, uint64_t result);      // hands the instruction in EX to its multi-cycle unit
+
+            void saveCycle();                       // opens the journal record of the cycle about to run
+            void restoreCycle(const CycleSnapshot &snapshot);
+
+            uint64_t executeCsr(uint64_t rs1_value);                        // reads and updates the csr, returns the old value for rd
+            uint64_t executeFloatingPoint(uint64_t rs1_value, uint64_t rs2_value, uint64_t rs3_value);
+            uint64_t executeVector(uint64_t rs1_value, uint64_t rs2_value);  // vset{i}vl{i} returns the new vl, the others their rs1
+            uint8_t runVectorUnit(uint32_t instruction, uint64_t rs1_value, uint64_t rs2_value);   // MEM, returns the fflags
     };
     #endif
\ No newline at end of file
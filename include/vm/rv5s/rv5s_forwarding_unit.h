@@ -7,6 +7,9 @@
 
     #include "vm/vm_base.h"
     #include "vm/rv5s/pipeline_registers.h"
+
+    #include <cstddef>
+    #include <vector>
     
     // Determines where does the ALU operands come from
     enum ForwardSrc {
@@ -15,14 +18,30 @@
         FROM_MEM_WB         // In case of load use hazards
     };
 
+    // Bypass source in an N-wide pipeline: the stage and the slot within the stage
+    struct BypassSource {
+        ForwardSrc src = ForwardSrc::FROM_REG;
+        std::size_t slot = 0;
+    };
+
     class RV5SForwardingUnit {
     public:
         RV5SForwardingUnit() = default;
         ~RV5SForwardingUnit() = default;
 
         // Returns appropriate enum type to decide where the first and second operand from the ALU should come from
-        ForwardSrc getAluSrcA(uint8_t id_rs1_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg);
-        ForwardSrc getAluSrcB(uint8_t id_rs2_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg);
+        // (rs_fp -> the operand is an fpr, only a producer writing the fpr file forwards to it)
+        ForwardSrc getAluSrcA(uint8_t id_rs1_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg, bool rs1_fp = false);
+        ForwardSrc getAluSrcB(uint8_t id_rs2_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg, bool rs2_fp = false);
+
+        // third operand of the fused multiply add instructions, always an fpr
+        ForwardSrc getAluSrcC(uint8_t id_rs3_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg);
+
+        // N-wide bypass network: the nearest stage wins and within a stage the youngest (highest) slot wins
+        BypassSource getBypassSource(uint8_t rs_index, const std::vector<EX_MEM_Reg>& ex_mem_regs, const std::vector<MEM_WB_Reg>& mem_wb_regs);
+
+    private:
+        ForwardSrc getForwardSrc(uint8_t rs_index, bool rs_fp, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg);
     };
 
     #endif
\ No newline at end of file
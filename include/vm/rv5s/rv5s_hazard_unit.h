@@ -7,6 +7,9 @@
 
     #include "vm/vm_base.h"
     #include "vm/rv5s/pipeline_registers.h"
+    #include "vm/rv5s/functional_units.h"
+
+    #include <vector>
     
     class RV5SHazardUnit {
     public:
@@ -16,15 +19,28 @@
         // checks for any hazard in general 
         bool detectHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg, EX_MEM_Reg ex_mem_reg);
         
-        // checks for data hazards
-        bool detectDataHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg, EX_MEM_Reg ex_mem_reg);
+        // checks for data hazards (rs3 is only read by the fused multiply add instructions)
+        bool detectDataHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg, EX_MEM_Reg ex_mem_reg, uint8_t rs3_index = 0);
 
         // check for load use data hazard specifically 
-        bool detectLoadUseHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg);
+        bool detectLoadUseHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg, uint8_t rs3_index = 0);
+
+        // csr / system instructions: fcsr is accrued in WB, the csr is read and written in EX and an ecall runs in WB
+        bool detectSerializationHazard(ControlSignals signals, const ID_EX_Reg& id_ex_reg, const EX_MEM_Reg& ex_mem_reg);
 
         // checks for control hazards
         bool detectControlHazard(ControlSignals signals);
 
+        // N-wide variants for the superscalar pipeline: check against every valid slot of the stage
+        bool detectDataHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, const std::vector<ID_EX_Reg>& id_ex_regs, const std::vector<EX_MEM_Reg>& ex_mem_regs);
+        bool detectLoadUseHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, const std::vector<ID_EX_Reg>& id_ex_regs);
+
+        // multi-cycle units: RAW on a result that is not produced yet, or WAW that would let the older long operation overwrite rd last
+        bool detectLongLatencyHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, uint8_t rd_index, const std::vector<InFlightFuOp>& in_flight, uint8_t rs3_index = 0);
+
+        // multi-cycle units: an iterative unit accepts a new operation only once the previous one has completed
+        bool detectStructuralHazard(const FuTiming& timing, const std::vector<InFlightFuOp>& in_flight);
+
     };
 
     #endif
\ No newline at end of file
@@ -8,7 +8,10 @@
 
     #include "vm/vm_base.h"
     #include "vm/rv5s/btb.h"
+    #include "vm/rv5s/cycle_journal.h"
+    #include "vm/rv5s/fetch_target_queue.h"
     #include "vm/rv5s/pipeline_registers.h"
+    #include "vm/rv5s/pipeline_trace.h"
     #include "vm/rv5s/rv5s_control_unit.h"
     #include "vm/rv5s/rv5s_hazard_unit.h"
     #include "vm/rv5s/rv5s_forwarding_unit.h"
@@ -30,6 +33,11 @@
             void Undo() override;
             void Redo() override;
             void Reset() override;
+            uint64_t ResumePc() const override;
+            bool ExecutesFpCsr() const override { return false; }
+            bool ExecutesVector() const override { return false; }
+            void SaveMicroarchState(StateWriter &writer) override;
+            bool LoadMicroarchSection(StateReader &reader, uint32_t tag) override;
 
             void DumpState(const std::filesystem::path &filename);
             void enableForwarding(bool enable);                     // to change config during testing
@@ -39,6 +47,10 @@
                 std::cout << "rv5s_id_vm" << std::endl;
             }
 
+            uint64_t getFrontendStarvationCycles() const {
+                return frontend_starvation_cycles_;
+            }
+
         private: 
             RV5SControlUnit control_unit_;
             RV5SHazardUnit hazard_unit_;
@@ -49,30 +61,66 @@
             bool stall_request_ = false;            // to indicate a stall signal from the decode stage
             bool flush_pipeline_ = false;           // to flush pipeline in case of branch taken in branch instructions
             bool forwarding_enabled_ = false;
+            StallReason flush_reason_ = StallReason::BRANCH_MISPREDICT;     // cause given to the bubbles of a flush
+            PipelineTrace pipeline_trace_;
 
             IF_ID_Reg if_id_reg_{};             // pipeline registers to hold state at beginning of a clock cycle
             ID_EX_Reg id_ex_reg_{};
             EX_MEM_Reg ex_mem_reg_{};
             MEM_WB_Reg mem_wb_reg_{};
             
+            // Front-end: with a non zero ftq depth, the predictor runs ahead of fetch and fetch runs ahead of decode
+            static constexpr uint64_t kFetchBlockBytes = 16;        // predicted fetch blocks end at the instruction reaching this alignment
+            FetchTargetQueue ftq_;
+            RingQueue<IF_ID_Reg> fetch_buffer_;
+            uint64_t fetch_latency_ = 1;
+            uint64_t fetch_busy_cycles_ = 0;             // cycles spent on the current instruction memory access
+            uint64_t frontend_starvation_cycles_ = 0;    // cycles decode could accept an instruction but the front-end had none
+
             IF_ID_Reg next_if_id_reg_{};             // pipeline registers to hold state during a clock cycle and will be stored at the end
             ID_EX_Reg next_id_ex_reg_{};
             EX_MEM_Reg next_ex_mem_reg_{};
             MEM_WB_Reg next_mem_wb_reg_{};
+
+            // the ftq and the fetch buffer are journaled as their marks plus the old value of the slots the cycle pushed into
+            struct CycleSnapshot : PipelineSnapshot {
+                FetchTargetQueue::Mark ftq;
+                RingQueue<IF_ID_Reg>::Mark fetch_buffer;
+                std::vector<std::pair<std::size_t, FetchTarget>> ftq_overwritten;
+                std::vector<std::pair<std::size_t, IF_ID_Reg>> fetch_buffer_overwritten;
+                uint64_t fetch_busy_cycles = 0;
+                uint64_t frontend_starvation_cycles = 0;
+                StallReason flush_reason = StallReason::BRANCH_MISPREDICT;
+            };
+            CycleJournal<CycleSnapshot> journal_;           // undo history, one record per cycle
+            unsigned int redo_cycles_ = 0;                  // cycles undone since the last step, redo runs them again
             
             void Fetch_Stage();                     //  pipeline stage functions 
+            void FrontEnd_Stage();                  //  replaces Fetch_Stage when the front-end is decoupled
             void Decode_Stage();
             void Execute_Stage();
             void Memory_Stage();
             void WriteBack_Stage();
 
             template <typename RegType> 
-            RegType CreateBubble() {                // function to create a bubble of an register type
+            RegType CreateBubble(StallReason reason = StallReason::FRONTEND) {     // function to create a bubble of an register type
                 RegType bubble;
                 bubble.is_valid = false;
+                bubble.bubble_reason = reason;
                 return bubble;
             }
 
+            void pushFetchTarget(const FetchTarget &target);        // push through which the journal sees the slot written
+            void pushFetched(const IF_ID_Reg &reg);
+            void predictFetchTarget();              // decoupled front-end: push the next predicted fetch block into the ftq
+            void fetchFromTargetQueue();            // decoupled front-end: fetch the block at the head of the ftq into the fetch buffer
+            bool isFrontEndDecoupled() const {
+                return ftq_.capacity() > 0;
+            }
+
+            void saveCycle();                       // opens the journal record of the cycle about to run
+            void restoreCycle(const CycleSnapshot &snapshot);
+
             uint64_t getWriteBackData();            // to forward the correct data that wlil be written back to register file
             uint64_t getForwardedIdReg(uint8_t reg_index);  // to forward data in case of branches
     };
@@ -7,6 +7,7 @@
 
     #include "vm/vm_base.h"
     #include "vm/rv5s/pipeline_registers.h"
+    #include "vm/rv5s/cycle_journal.h"
     #include "vm/rv5s/rv5s_control_unit.h"
     #include "vm/rv5s/rv5s_hazard_unit.h"     // added
     // #include "config.h"                  // see if reqd later 
@@ -26,6 +27,11 @@
             void Undo() override;
             void Redo() override;
             void Reset() override;
+            uint64_t ResumePc() const override;
+            bool ExecutesFpCsr() const override { return false; }
+            bool ExecutesVector() const override { return false; }
+            void SaveMicroarchState(StateWriter &writer) override;
+            bool LoadMicroarchSection(StateReader &reader, uint32_t tag) override;
 
             void DumpState(const std::filesystem::path &filename);
 
@@ -48,6 +54,9 @@
             ID_EX_Reg next_id_ex_reg_{};
             EX_MEM_Reg next_ex_mem_reg_{};
             MEM_WB_Reg next_mem_wb_reg_{};
+
+            CycleJournal<PipelineSnapshot> journal_;        // undo history, one record per cycle
+            unsigned int redo_cycles_ = 0;                  // cycles undone since the last step, redo runs them again
             
             void Fetch_Stage();                     //  pipeline stage functions 
             void Decode_Stage();
@@ -55,6 +64,9 @@
             void Memory_Stage();
             void WriteBack_Stage();
 
+            void saveCycle();                       // opens the journal record of the cycle about to run
+            void restoreCycle(const PipelineSnapshot &snapshot);
+
             template <typename RegType> 
             RegType CreateBubble() {                // function to create a bubble of an register type
                 RegType bubble;
@@ -0,0 +1,102 @@
+/**
+* @file rv5s_superscalar_vm.h
+* @brief Definition of the N-wide in-order superscalar variant of the 5-stage pipelined RISC-V VM (Branch Comparison in the EX stage)
+*/
+
+#ifndef RV5S_SUPERSCALAR_VM_H
+#define RV5S_SUPERSCALAR_VM_H
+
+    #include "vm/vm_base.h"
+    #include "vm/rv5s/pipeline_registers.h"
+    #include "vm/rv5s/rv5s_control_unit.h"
+    #include "vm/rv5s/rv5s_hazard_unit.h"
+    #include "vm/rv5s/rv5s_forwarding_unit.h"
+    #include "vm/rv5s/functional_units.h"
+    #include "vm/rv5s/branch_prediction/i_branch_predictor.h"
+    #include "config.h"
+
+    #include <cstddef>
+    #include <cstdint>
+    #include <iostream>
+    #include <memory>
+    #include <vector>
+
+    class RV5SSuperscalarVM : public VmBase {
+        public:
+            explicit RV5SSuperscalarVM(bool silent = false);
+            ~RV5SSuperscalarVM();
+
+            void Run() override;
+            void DebugRun() override;
+            void Step() override;
+            void Undo() override;
+            void Redo() override;
+            void Reset() override;
+            uint64_t ResumePc() const override;
+            bool ExecutesFpCsr() const override { return false; }
+            bool ExecutesVector() const override { return false; }
+            void SaveMicroarchState(StateWriter &writer) override;
+            bool LoadMicroarchSection(StateReader &reader, uint32_t tag) override;
+
+            void DumpState(const std::filesystem::path &filename);
+            void enableForwarding(bool enable);
+            void setBranchPredictorType(vm_config::BranchPredictorType type);
+
+            std::size_t getIssueWidth() const {
+                return width_;
+            }
+
+            void PrintType() {
+                std::cout << "rv5s_superscalar_vm" << std::endl;
+            }
+
+        private:
+            RV5SControlUnit control_unit_;
+            RV5SHazardUnit hazard_unit_;
+            RV5SForwardingUnit forwarding_unit_;
+            std::unique_ptr<IBranchPredictor> branch_predictor_;
+
+            std::size_t width_ = 1;                 // instructions fetched, decoded and issued per cycle
+            std::size_t alu_ports_ = 1;             // issue ports per functional unit class
+            std::size_t mem_ports_ = 1;
+            std::size_t branch_ports_ = 1;
+            std::size_t fp_ports_ = 1;
+
+            bool flush_pipeline_ = false;           // branch misprediction detected in EX
+            bool decode_redirect_ = false;          // predicted taken branch / jal in ID -> younger fetched instructions are dropped
+            bool forwarding_enabled_ = false;
+            std::size_t issued_count_ = 0;          // no of IF/ID slots issued by decode this cycle
+            uint64_t multi_issue_cycles_ = 0;        // cycles in which more than one instruction was issued
+
+            // one register per slot, slot 0 holds the oldest instruction of the group
+            std::vector<IF_ID_Reg> if_id_regs_;
+            std::vector<ID_EX_Reg> id_ex_regs_;
+            std::vector<EX_MEM_Reg> ex_mem_regs_;
+            std::vector<MEM_WB_Reg> mem_wb_regs_;
+
+            std::vector<IF_ID_Reg> next_if_id_regs_;
+            std::vector<ID_EX_Reg> next_id_ex_regs_;
+            std::vector<EX_MEM_Reg> next_ex_mem_regs_;
+            std::vector<MEM_WB_Reg> next_mem_wb_regs_;
+
+            void Fetch_Stage();
+            void Decode_Stage();
+            void Execute_Stage();
+            void Memory_Stage();
+            void WriteBack_Stage();
+
+            bool decodeSlot(const IF_ID_Reg &if_id_reg, ID_EX_Reg &id_ex_reg);     // returns false for a decode stage redirect
+            bool executeSlot(const ID_EX_Reg &id_ex_reg, EX_MEM_Reg &ex_mem_reg);  // returns false if younger slots must be squashed
+            void memorySlot(const EX_MEM_Reg &ex_mem_reg, MEM_WB_Reg &mem_wb_reg);
+            void writeBackSlot(const MEM_WB_Reg &mem_wb_reg);
+
+            uint64_t getForwardedData(uint8_t rs_index, uint64_t reg_data);
+            static uint64_t getWriteBackData(const MEM_WB_Reg &mem_wb_reg);
+
+            template <typename RegType>
+            static std::vector<RegType> CreateBubbles(std::size_t count) {
+                return std::vector<RegType>(count);         // default constructed registers are invalid
+            }
+    };
+
+#endif
@@ -26,6 +26,8 @@
             void Undo() override;
             void Redo() override;
             void Reset() override;
+            bool ExecutesFpCsr() const override { return false; }
+            bool ExecutesVector() const override { return false; }
 
             void DumpState(const std::filesystem::path &filename);
 
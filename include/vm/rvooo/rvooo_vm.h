@@ -0,0 +1,173 @@
+/**
+ * @file rvooo_vm.h
+ * @brief Definition of the parameterised out-of-order RISC-V VM (register renaming, reorder buffer, issue queues, load/store queue)
+ */
+
+#ifndef RVOOO_VM_H
+#define RVOOO_VM_H
+
+    #include "vm/vm_base.h"
+    #include "vm/rv5s/pipeline_registers.h"
+    #include "vm/rv5s/rv5s_control_unit.h"
+    #include "vm/rv5s/functional_units.h"
+    #include "vm/rv5s/branch_prediction/i_branch_predictor.h"
+    #include "config.h"
+
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <deque>
+    #include <iostream>
+    #include <memory>
+    #include <vector>
+
+    // Instruction between fetch and rename, carrying the front-end prediction
+    struct FetchedInstruction {
+        uint64_t pc = 0;
+        uint64_t pc_inc = 0;            // pc of the next sequential instruction
+        uint32_t instruction = 0;
+        bool predicted_taken = false;
+        uint64_t predicted_next_pc = 0;
+        uint64_t fetch_cycle = 0;
+    };
+
+    struct RobEntry {
+        uint64_t seq = 0;                       // program order tag, increasing
+        uint64_t pc = 0;
+        uint64_t pc_inc = 0;
+        uint32_t instruction = 0;
+        ControlSignals control;
+        int32_t immediate = 0;
+
+        uint8_t rd_index = 0;
+        bool has_dest = false;
+        uint16_t phys_rd = 0;                   // physical register allocated for rd
+        uint16_t old_phys_rd = 0;               // previous mapping of rd, freed at commit or restored on a squash
+
+        bool done = false;
+        bool predicted_taken = false;
+        uint64_t predicted_next_pc = 0;
+        uint64_t fetch_cycle = 0;
+    };
+
+    struct IssueQueueEntry {
+        uint64_t seq = 0;
+        FuClass fu_class = FuClass::ALU;
+        uint16_t phys_rs1 = 0;                  // physical register 0 is hardwired to zero and always ready
+        uint16_t phys_rs2 = 0;
+    };
+
+    struct LsqEntry {
+        uint64_t seq = 0;
+        bool is_store = false;
+        bool address_known = false;             // set when the load / store has executed
+        uint64_t address = 0;
+        unsigned int size = 0;                  // bytes accessed
+        uint64_t store_data = 0;
+    };
+
+    // Instruction in a functional unit, its result is written back when remaining_cycles reaches 0
+    struct InFlightOp {
+        uint64_t seq = 0;
+        unsigned int remaining_cycles = 0;
+        uint64_t result = 0;
+        bool actual_taken = false;              // branches only
+        uint64_t actual_next_pc = 0;
+    };
+
+    class RVOOOVM : public VmBase {
+        public:
+            explicit RVOOOVM(bool silent = false);
+            ~RVOOOVM();
+
+            void Run() override;
+            void DebugRun() override;
+            void Step() override;
+            void Undo() override;
+            void Redo() override;
+            void Reset() override;
+            uint64_t ResumePc() const override;
+            bool ExecutesFpCsr() const override { return false; }
+            bool ExecutesVector() const override { return false; }
+            bool ExecutesAtomic() const override { return false; }
+            void SaveMicroarchState(StateWriter &writer) override;
+            bool LoadMicroarchSection(StateReader &reader, uint32_t tag) override;
+
+            void DumpState(const std::filesystem::path &filename);
+            void setBranchPredictorType(vm_config::BranchPredictorType type);
+
+            void PrintType() {
+                std::cout << "rvooo_vm" << std::endl;
+            }
+
+        private:
+            static constexpr std::size_t kNumArchRegs = 32;
+            static constexpr unsigned int kAluLatency = 1;
+            static constexpr unsigned int kLoadLatency = 2;         // address generation + data cache access
+            static constexpr unsigned int kStoreLatency = 1;        // memory is written at commit
+
+            RV5SControlUnit control_unit_;
+            std::unique_ptr<IBranchPredictor> branch_predictor_;
+
+            // parameters, read from the config in Reset()
+            std::size_t width_ = 1;                 // fetch / rename / issue / commit width
+            std::size_t rob_size_ = 64;
+            std::size_t iq_size_ = 32;
+            std::size_t lsq_size_ = 16;
+            std::size_t num_phys_regs_ = 96;
+            bool split_iq_ = false;
+            std::size_t alu_ports_ = 2;
+            std::size_t mem_ports_ = 1;
+            std::size_t branch_ports_ = 1;
+
+            // rename state, the committed architectural state lives in registers_
+            std::array<uint16_t, kNumArchRegs> rat_{};
+            std::vector<uint64_t> prf_;
+            std::vector<bool> prf_ready_;
+            std::deque<uint16_t> free_list_;
+
+            std::deque<FetchedInstruction> fetch_queue_;
+            std::deque<RobEntry> rob_;
+            std::vector<std::vector<IssueQueueEntry>> issue_queues_;    // one unified queue, or one per FuClass
+            std::deque<LsqEntry> lsq_;
+            std::vector<InFlightOp> in_flight_;
+            uint64_t next_seq_ = 0;
+
+            // occupancy and stall reason counters
+            uint64_t rob_occupancy_sum_ = 0;
+            uint64_t iq_occupancy_sum_ = 0;
+            uint64_t lsq_occupancy_sum_ = 0;
+            std::size_t rob_peak_ = 0;
+            std::size_t iq_peak_ = 0;
+            std::size_t lsq_peak_ = 0;
+            uint64_t rename_stall_rob_full_ = 0;
+            uint64_t rename_stall_iq_full_ = 0;
+            uint64_t rename_stall_lsq_full_ = 0;
+            uint64_t rename_stall_no_free_regs_ = 0;
+            uint64_t rename_stall_frontend_empty_ = 0;
+            uint64_t load_disambiguation_stalls_ = 0;      // cycles a ready load waited on an older store
+            uint64_t squashed_instructions_ = 0;
+
+            void Commit_Stage();
+            void WriteBack_Stage();
+            void Issue_Stage();
+            void Rename_Stage();
+            void Fetch_Stage();
+
+            void syncArchitecturalState();
+            void recoverFrom(uint64_t branch_seq, uint64_t correct_pc);
+            RobEntry& robEntry(uint64_t seq);
+            LsqEntry* lsqEntry(uint64_t seq);
+            std::size_t issueQueueIndex(FuClass fu_class) const;
+            std::size_t issueQueueOccupancy() const;
+
+            bool tryLoad(const RobEntry &entry, uint64_t address, uint64_t &value, bool &must_wait);
+            void writeMemory(const RobEntry &entry, const LsqEntry &store);
+            uint64_t computeAluResult(const RobEntry &entry, uint64_t rs1_value, uint64_t rs2_value);
+
+            static bool readsRs1(uint32_t instruction);
+            static bool readsRs2(uint32_t instruction);
+            static unsigned int accessSize(const ControlSignals &control);
+    };
+
+#endif
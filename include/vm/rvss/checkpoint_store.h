@@ -0,0 +1,76 @@
+/**
+ * @file checkpoint_store.h
+ * @brief Periodic snapshots of the single stage VM, a seek restores the nearest one and replays from it
+ */
+#ifndef CHECKPOINT_STORE_H
+#define CHECKPOINT_STORE_H
+
+#include "vm/atomic_unit.h"
+#include "vm/main_memory.h"
+#include "vm/registers.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Checkpoint {
+  uint64_t instructions_retired;
+  uint64_t cycles;
+  uint64_t program_counter;
+  RegisterFile registers;
+  Memory::Snapshot memory; // blocks are shared with the vm until one side writes them
+  atomic_unit::Reservation reservation;
+};
+
+// What an ecall did, replaying past it restores this instead of printing or waiting for input again
+struct SyscallRecord {
+  uint64_t instruction; // instructions retired before the ecall
+  uint64_t a0;
+  uint64_t buffer_address;
+  std::vector<uint8_t> buffer; // bytes written by a stdin read, empty for the other syscalls
+};
+
+class CheckpointStore {
+ public:
+  // 0 disables checkpoints, any change drops the ones taken
+  void SetInterval(uint64_t instructions);
+  void Clear();
+
+  bool Enabled() const {
+    return interval_ > 0;
+  }
+
+  // a checkpoint is due every interval instructions, unless one was already taken there
+  bool Due(uint64_t instruction) const {
+    return interval_ > 0 && instruction >= next_;
+  }
+
+  // past kMaxCheckpoints, an older checkpoint is dropped, see Thin()
+  void Add(Checkpoint &&checkpoint);
+
+  // latest checkpoint at or before instruction, null if there is none
+  const Checkpoint *Nearest(uint64_t instruction) const;
+
+  void RecordSyscall(SyscallRecord &&record);
+  const SyscallRecord *FindSyscall(uint64_t instruction) const;
+
+  // the state was edited at instruction, what was recorded from there on no longer matches it
+  void DropFrom(uint64_t instruction);
+
+  std::size_t Size() const {
+    return checkpoints_.size();
+  }
+
+ private:
+  // each checkpoint holds a register file and a block table whose pages stop being shared once written
+  static constexpr std::size_t kMaxCheckpoints = 64;
+
+  uint64_t interval_ = 0;
+  uint64_t next_ = 0; // instruction count of the next checkpoint
+  std::vector<Checkpoint> checkpoints_; // ordered by instructions_retired
+  std::vector<SyscallRecord> syscalls_; // ordered by instruction
+
+  void Thin();
+};
+
+#endif // CHECKPOINT_STORE_H
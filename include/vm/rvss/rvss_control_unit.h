@@ -7,6 +7,7 @@
 #define RVSS_CONTROL_UNIT_H
 
 #include "../control_unit_base.h"
+#include "vm/decoder.h"
 
 
 class RVSSControlUnit : public ControlUnit {
@@ -15,6 +16,12 @@ class RVSSControlUnit : public ControlUnit {
 
   alu::AluOp GetAluSignal(uint32_t instruction, bool ALUOp) override;
 
+  // the instruction decoded by the last SetControlSignals
+  [[nodiscard]] const decoder::DecodedOp &GetDecodedOp() const { return *decoded_; }
+
+ private:
+  const decoder::DecodedOp *decoded_ = &decoder::decode(0);
+
 };
 
-#endif // RVSS_CONTROL_UNIT_H
\ No newline at end of file
+#endif // RVSS_CONTROL_UNIT_H
@@ -10,103 +10,23 @@
 #include "vm/vm_base.h"
 
 #include "rvss_control_unit.h"
+#include "vm/rvss/undo_history.h"
+#include "vm/rvss/checkpoint_store.h"
+#include "vm/rv5s/branch_prediction/branch_trace.h"
 
-#include <stack>
 #include <vector>
 #include <iostream>
 #include <cstdint>
 
-// TODO: use a circular buffer instead of a stack for undo/redo
-
-struct RegisterChange {
-  unsigned int reg_index;
-  unsigned int reg_type; // 0 for GPR, 1 for CSR, 2 for FPR
-  uint64_t old_value;
-  uint64_t new_value;
-};
-
-struct MemoryChange {
-  uint64_t address;
-  std::vector<uint8_t> old_bytes_vec; 
-  std::vector<uint8_t> new_bytes_vec; 
-};
-
-struct StepDelta {
-  uint64_t old_pc;
-  uint64_t new_pc;
-  std::vector<RegisterChange> register_changes;
-  std::vector<MemoryChange> memory_changes;
-};
-
-
-// class RingUndoRedo {
-//   std::vector<StepDelta> buffer_;
-//   int current_;      // index of current state
-//   int size_;         // number of valid entries
-//   int head_;
-//   const int capacity_;
-
-//  public:
-//   explicit RingUndoRedo(int cap)
-//     : buffer_(cap), current_(-1), size_(0), head_(-1), capacity_(cap) {}
-
-//   void push(const StepDelta& delta) {
-//     head_ = (head_ + 1) % capacity_;
-//     buffer_[head_] = delta;
-//     current_ = head_;  // move current to new step
-
-//     if (size_ < capacity_)
-//         size_++;
-//     else {
-//         ; // overwrite oldest entry
-//     }
-
-//     // Invalidate all redos beyond head_
-//     int i = (head_ + 1) % capacity_;
-//     while (i != current_) {
-//         buffer_[i] = StepDelta(); // or mark invalid
-//         i = (i + 1) % capacity_;
-//     }
-// }
-
-
-//   bool can_undo() const {
-//     return size_ > 0 && current_ != -1;
-//   }
-
-//   bool can_redo() const {
-//     return current_ != head_ && !buffer_[(current_ + 1) % capacity_].register_changes.empty();
-// }
-
-//   StepDelta undo() {
-//     if (!can_undo()) throw std::runtime_error("Nothing to undo");
-//     StepDelta delta = buffer_[current_];
-//     current_ = (current_ - 1 + capacity_) % capacity_;
-//     return delta;
-//   }
-
-//   StepDelta redo() {
-//     if (!can_redo()) throw std::runtime_error("Nothing to redo");
-
-//     current_ = (current_ + 1) % capacity_;
-//     return buffer_[current_];
-// }
-// };
-
-
-
-
 class RVSSVM : public VmBase {
  public:
   RVSSControlUnit control_unit_;
   // std::atomic<bool> stop_requested_ = false;    // why is this redeclared again here ? already declared in vm_base
 
 
-  std::stack<StepDelta> undo_stack_;
-  std::stack<StepDelta> redo_stack_;
-  // RingUndoRedo history_{1000}; // or however many steps you want to store
-
-  StepDelta current_delta_;
+  UndoHistory history_;     // steps recorded by Step() and DebugRun(), undo_depth of them are kept
+  CheckpointStore checkpoints_;     // taken every checkpoint_interval instructions, seek replays from them
+  uint64_t furthest_instruction_ = 0;     // instructions retired before going back, redo can replay up to it
 
   // intermediate variables
   int64_t execution_result_{};
@@ -117,6 +37,12 @@ class RVSSVM : public VmBase {
 
   bool branch_flag_ = false;
   int64_t next_pc_{}; // for jal, jalr,
+  uint8_t instruction_length_ = 4;  // bytes of the current instruction, 2 for a compressed one
+  std::vector<uint64_t> vector_old_words_;    // undo records of a vector instruction, kept to not allocate per step
+  std::vector<uint8_t> vector_old_bytes_;
+
+  // if set, every executed conditional branch is appended to this trace (not owned)
+  BranchTrace *branch_trace_ = nullptr;
 
   // CSR intermediate variables
   uint16_t csr_target_address_{};
@@ -132,17 +58,27 @@ class RVSSVM : public VmBase {
   void ExecuteFloat();
   void ExecuteDouble();
   void ExecuteCsr();
+  void ExecuteVector();   // the whole instruction, memory and the vector registers included; vset leaves rd to WriteBack
   void HandleSyscall();
 
   void WriteMemory();
   void WriteMemoryFloat();
   void WriteMemoryDouble();
+  void RecordStore(uint64_t address, const uint8_t *old_bytes, size_t size);   // undo record of a store, from the bytes it overwrote
+  void RecordReservation(const atomic_unit::Reservation &old_reservation);     // undo records of the fields lr / sc changed
+  void SetReservationField(unsigned int index, uint64_t value);               // address (0), value (1), bytes (2)
+  void AccrueFflags(uint8_t flags);   // sticky fp exception flags, written only when a new one is raised
 
   void WriteBack();
   void WriteBackFloat();
   void WriteBackDouble();
   void WriteBackCsr();
 
+  void ExecuteInstruction();     // one full instruction, taking a checkpoint first when one is due
+  void TakeCheckpoint();
+  void RestoreCheckpoint(const Checkpoint &checkpoint);
+  bool SeekTo(uint64_t instruction);     // quiet seek, false if going back without a checkpoint to start from
+
   explicit RVSSVM(bool silent = false);
   ~RVSSVM();
 
@@ -152,6 +88,8 @@ class RVSSVM : public VmBase {
   void Undo() override;
   void Redo() override;
   void Reset() override;
+  void Seek(uint64_t instruction) override;
+  void StateEdited() override;
 
   // were redeclared...already present in vm_base 
   // void RequestStop() {
@@ -166,6 +104,10 @@ class RVSSVM : public VmBase {
   //   stop_requested_ = false;
   // }
 
+  void SetBranchTrace(BranchTrace *trace) {
+    branch_trace_ = trace;
+  }
+
   void PrintType() {
     std::cout << "rvssvm" << std::endl;
   }
@@ -0,0 +1,98 @@
+/**
+ * @file undo_history.h
+ * @brief Bounded undo/redo history of the single stage VM, kept in preallocated rings of fixed size records
+ */
+#ifndef UNDO_HISTORY_H
+#define UNDO_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct RegisterChange {
+  uint16_t reg_index;
+  uint8_t reg_type; // 0 for GPR, 1 for CSR, 2 for FPR, 3 for a vector register word, 4 for vl (0) / vtype (1),
+                    // 5 for the lr / sc reservation: address (0), value (1), bytes (2)
+  uint64_t old_value;
+  uint64_t new_value;
+};
+
+// A store is one record, longer writes (a stdin read) are split into records of kMaxBytes
+struct MemoryChange {
+  static constexpr std::size_t kMaxBytes = 8;
+
+  uint64_t address;
+  uint8_t size;
+  uint8_t old_bytes[kMaxBytes];
+  uint8_t new_bytes[kMaxBytes];
+};
+
+// One executed instruction, its changes are the records [begin, end) of each ring. Indices count every record ever
+// written and are wrapped only on access, so they stay ordered across the ring boundary.
+struct StepDelta {
+  uint64_t old_pc;
+  uint64_t new_pc;
+  uint64_t register_begin;
+  uint64_t register_end;
+  uint64_t memory_begin;
+  uint64_t memory_end;
+};
+
+class UndoHistory {
+ public:
+  // steps that can be undone, 0 disables the history. The only call that allocates.
+  void SetCapacity(std::size_t steps);
+  void Clear();
+
+  // a step records nothing unless it is opened, so Run() can skip the history
+  void BeginStep(uint64_t pc);
+  void RecordRegister(unsigned int reg_index, unsigned int reg_type, uint64_t old_value, uint64_t new_value);
+  void RecordMemory(uint64_t address, const uint8_t *old_bytes, const uint8_t *new_bytes, std::size_t size);
+  void CommitStep(uint64_t pc);
+
+  bool CanUndo() const {
+    return undo_count_ > 0;
+  }
+
+  bool CanRedo() const {
+    return redo_count_ > 0;
+  }
+
+  // the caller writes back the old (undo) or new (redo) values of the returned step's records
+  const StepDelta &Undo();
+  const StepDelta &Redo();
+
+  const RegisterChange &RegisterAt(uint64_t index) const {
+    return register_ring_[index % register_ring_.size()];
+  }
+
+  const MemoryChange &MemoryAt(uint64_t index) const {
+    return memory_ring_[index % memory_ring_.size()];
+  }
+
+ private:
+  // most instructions write one register or store once, a step with more changes just evicts older steps sooner
+  static constexpr std::size_t kRecordsPerStep = 2;
+
+  std::vector<StepDelta> step_ring_;
+  std::vector<RegisterChange> register_ring_;
+  std::vector<MemoryChange> memory_ring_;
+
+  uint64_t oldest_ = 0;             // index of the oldest step kept
+  uint64_t undo_count_ = 0;         // steps [oldest_, oldest_ + undo_count_) can be undone
+  uint64_t redo_count_ = 0;         // the redo_count_ steps after them can be redone
+  uint64_t register_head_ = 0;      // index of the next record of each ring
+  uint64_t memory_head_ = 0;
+
+  StepDelta current_{};
+  bool open_ = false;
+  bool overflowed_ = false;         // the open step alone does not fit in a ring
+
+  StepDelta &StepAt(uint64_t index) {
+    return step_ring_[index % step_ring_.size()];
+  }
+
+  bool MakeRoom(uint64_t head, std::size_t ring_size, uint64_t StepDelta::*begin);
+};
+
+#endif // UNDO_HISTORY_H
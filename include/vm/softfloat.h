@@ -0,0 +1,72 @@
+/**
+ * @file softfloat.h
+ * @brief Integer-only IEEE-754 binary32 / binary64 arithmetic with the RISC-V rounding modes, exception flags and NaN rules
+ */
+
+#ifndef SOFTFLOAT_H
+#define SOFTFLOAT_H
+
+#include <cstdint>
+
+// Values are passed as raw bits. Every operation rounds with the given frm encoding (RNE, RTZ, RDN, RUP, RMM, the
+// reserved encodings round like RNE) and ORs the exceptions it raises into flags, in the fflags layout (FCSR_* in
+// alu.h). A NaN result is always the canonical NaN, conversions to integers saturate as the F / D extensions specify.
+namespace softfloat {
+
+constexpr uint8_t kRoundNearestEven = 0b000;
+constexpr uint8_t kRoundTowardZero = 0b001;
+constexpr uint8_t kRoundDown = 0b010;
+constexpr uint8_t kRoundUp = 0b011;
+constexpr uint8_t kRoundNearestMaxMagnitude = 0b100;
+
+constexpr uint32_t kDefaultNaN32 = 0x7fc00000;
+constexpr uint64_t kDefaultNaN64 = 0x7ff8000000000000;
+
+uint32_t f32Add(uint32_t a, uint32_t b, uint8_t rm, uint8_t &flags);
+uint32_t f32Sub(uint32_t a, uint32_t b, uint8_t rm, uint8_t &flags);
+uint32_t f32Mul(uint32_t a, uint32_t b, uint8_t rm, uint8_t &flags);
+uint32_t f32Div(uint32_t a, uint32_t b, uint8_t rm, uint8_t &flags);
+uint32_t f32Sqrt(uint32_t a, uint8_t rm, uint8_t &flags);
+// a * b + c with a single rounding, the fused variants negate the operands before the call
+uint32_t f32MulAdd(uint32_t a, uint32_t b, uint32_t c, uint8_t rm, uint8_t &flags);
+uint32_t f32Min(uint32_t a, uint32_t b, uint8_t &flags);
+uint32_t f32Max(uint32_t a, uint32_t b, uint8_t &flags);
+bool f32Eq(uint32_t a, uint32_t b, uint8_t &flags);   // quiet
+bool f32Lt(uint32_t a, uint32_t b, uint8_t &flags);   // signaling
+bool f32Le(uint32_t a, uint32_t b, uint8_t &flags);   // signaling
+uint16_t f32Classify(uint32_t a);
+
+uint64_t f64Add(uint64_t a, uint64_t b, uint8_t rm, uint8_t &flags);
+uint64_t f64Sub(uint64_t a, uint64_t b, uint8_t rm, uint8_t &flags);
+uint64_t f64Mul(uint64_t a, uint64_t b, uint8_t rm, uint8_t &flags);
+uint64_t f64Div(uint64_t a, uint64_t b, uint8_t rm, uint8_t &flags);
+uint64_t f64Sqrt(uint64_t a, uint8_t rm, uint8_t &flags);
+uint64_t f64MulAdd(uint64_t a, uint64_t b, uint64_t c, uint8_t rm, uint8_t &flags);
+uint64_t f64Min(uint64_t a, uint64_t b, uint8_t &flags);
+uint64_t f64Max(uint64_t a, uint64_t b, uint8_t &flags);
+bool f64Eq(uint64_t a, uint64_t b, uint8_t &flags);
+bool f64Lt(uint64_t a, uint64_t b, uint8_t &flags);
+bool f64Le(uint64_t a, uint64_t b, uint8_t &flags);
+uint16_t f64Classify(uint64_t a);
+
+uint64_t f32ToF64(uint32_t a, uint8_t &flags);
+uint32_t f64ToF32(uint64_t a, uint8_t rm, uint8_t &flags);
+
+uint32_t i64ToF32(int64_t a, uint8_t rm, uint8_t &flags);
+uint32_t ui64ToF32(uint64_t a, uint8_t rm, uint8_t &flags);
+uint64_t i64ToF64(int64_t a, uint8_t rm, uint8_t &flags);
+uint64_t ui64ToF64(uint64_t a, uint8_t rm, uint8_t &flags);
+
+// the 32-bit results are returned sign-extended, as fcvt.w[u] writes them to rd
+uint64_t f32ToI32(uint32_t a, uint8_t rm, uint8_t &flags);
+uint64_t f32ToUi32(uint32_t a, uint8_t rm, uint8_t &flags);
+uint64_t f32ToI64(uint32_t a, uint8_t rm, uint8_t &flags);
+uint64_t f32ToUi64(uint32_t a, uint8_t rm, uint8_t &flags);
+uint64_t f64ToI32(uint64_t a, uint8_t rm, uint8_t &flags);
+uint64_t f64ToUi32(uint64_t a, uint8_t rm, uint8_t &flags);
+uint64_t f64ToI64(uint64_t a, uint8_t rm, uint8_t &flags);
+uint64_t f64ToUi64(uint64_t a, uint8_t rm, uint8_t &flags);
+
+} // namespace softfloat
+
+#endif // SOFTFLOAT_H
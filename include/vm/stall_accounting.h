@@ -0,0 +1,47 @@
+/**
+ * @file stall_accounting.h
+ * @brief Attribution of every cycle a pipeline loses to its cause, reported as a CPI stack
+ */
+
+#ifndef STALL_ACCOUNTING_H
+#define STALL_ACCOUNTING_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Cause of a bubble, carried by the bubble down to WB where the cycle it costs is recorded
+enum class StallReason : uint8_t {
+    FRONTEND,               // pipeline fill, fetch latency, nothing left to fetch
+    LOAD_USE,               // consumer of a load one cycle behind it (forwarding enabled)
+    RAW,                    // read after write that forwarding does not cover (or forwarding disabled)
+    LONG_LATENCY,           // result of a multi-cycle functional unit not produced yet
+    STRUCTURAL,             // iterative functional unit busy
+    SERIALIZATION,          // csr / ecall ordering
+    BRANCH_MISPREDICT,      // wrong predicted direction
+    BTB_MISS,               // taken control transfer whose target fetch did not have (btb miss, or no btb at all)
+    COUNT
+};
+
+const char *StallReasonName(StallReason reason);
+
+class StallAccounting {
+public:
+    static constexpr std::size_t kNumReasons = static_cast<std::size_t>(StallReason::COUNT);
+
+    void Record(StallReason reason, uint64_t cycles = 1);
+    void Clear();
+
+    uint64_t Get(StallReason reason) const;
+    uint64_t Total() const;
+
+    // "cpi_stack" (base + one component per reason, summing to the cpi) and "lost_cycles" json objects, each line prefixed by indent
+    void DumpJson(std::ostream &os, uint64_t cycles, uint64_t instructions, const std::string &indent) const;
+
+private:
+    std::array<uint64_t, kNumReasons> cycles_{};
+};
+
+#endif // STALL_ACCOUNTING_H
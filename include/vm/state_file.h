@@ -0,0 +1,128 @@
+/**
+ * @file state_file.h
+ * @brief Versioned binary image of a vm (architectural and microarchitectural state) written by save_state and read back by load_state
+ */
+
+#ifndef STATE_FILE_H
+#define STATE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+// Layout: an 8 byte magic, the format version, the flags and the memory block size, then tagged sections
+// (4 byte tag, 8 byte payload length, payload). Values are stored in host byte order. A reader skips the sections it
+// does not know, so the architectural state saved by one vm loads into any other.
+namespace state_file {
+
+constexpr char kMagic[8] = {'R', 'V', 'S', 'T', 'A', 'T', 'E', '\0'};
+constexpr uint32_t kVersion = 1;
+
+constexpr uint32_t kFlagCompressed = 1u << 0;   // memory blocks are zero-run encoded
+
+constexpr uint32_t MakeTag(const char (&name)[5]) {
+    return static_cast<uint32_t>(name[0]) | static_cast<uint32_t>(name[1]) << 8 |
+           static_cast<uint32_t>(name[2]) << 16 | static_cast<uint32_t>(name[3]) << 24;
+}
+
+// sections written by every vm
+constexpr uint32_t kTagCounters = MakeTag("CNTR");        // pc, program size, counters, cpi, stall accounting
+constexpr uint32_t kTagRegisters = MakeTag("REGS");       // gpr and fpr files
+constexpr uint32_t kTagCsrs = MakeTag("CSRS");            // non zero csrs as (address, value)
+constexpr uint32_t kTagVectors = MakeTag("VREG");         // vlen, vl, vtype and the vector register file
+constexpr uint32_t kTagMemory = MakeTag("MEMB");          // touched memory blocks
+constexpr uint32_t kTagBranchProfile = MakeTag("BPRF");
+
+// sections of the 5-stage pipelines
+constexpr uint32_t kTagPredictor = MakeTag("BPRD");
+constexpr uint32_t kTagBtb = MakeTag("BTB ");
+constexpr uint32_t kTagStallPipeline = MakeTag("PSTL");
+constexpr uint32_t kTagExPipeline = MakeTag("PEX ");
+constexpr uint32_t kTagIdPipeline = MakeTag("PID ");
+
+} // namespace state_file
+
+class StateWriter {
+public:
+    StateWriter(const std::filesystem::path &filename, uint32_t flags, uint32_t block_size);
+
+    // false once any write failed
+    bool good() const {
+        return file_.good();
+    }
+
+    bool compressed() const {
+        return flags_ & state_file::kFlagCompressed;
+    }
+
+    // the payload length is patched in when the section ends
+    void beginSection(uint32_t tag);
+    void endSection();
+
+    void writeBytes(const void *data, std::size_t size) {
+        file_.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    }
+
+    template <typename T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values are written raw");
+        writeBytes(&value, sizeof(T));
+    }
+
+    // a block goes straight from the memory buffer to the file, or zero-run encoded in a compressed file
+    void writeBlock(uint64_t index, const std::vector<uint8_t> &data);
+
+private:
+    std::ofstream file_;
+    uint32_t flags_;
+    std::streampos section_start_{};
+    std::vector<uint8_t> scratch_;
+};
+
+class StateReader {
+public:
+    explicit StateReader(const std::filesystem::path &filename);
+
+    // false if the file could not be opened, is not a state file, or a read ran past its end
+    bool good() const {
+        return ok_;
+    }
+
+    uint32_t version() const {
+        return version_;
+    }
+
+    uint32_t blockSize() const {
+        return block_size_;
+    }
+
+    // next section header, false at the end of the file
+    bool nextSection(uint32_t &tag, uint64_t &length);
+    void skipSection();
+    // the section handler read exactly its payload
+    bool sectionDone();
+
+    bool readBytes(void *data, std::size_t size);
+
+    template <typename T>
+    bool read(T &value) {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values are read raw");
+        return readBytes(&value, sizeof(T));
+    }
+
+    // data must already hold blockSize() bytes
+    bool readBlock(uint64_t &index, std::vector<uint8_t> &data);
+
+private:
+    std::ifstream file_;
+    bool ok_ = false;
+    uint32_t version_ = 0;
+    uint32_t flags_ = 0;
+    uint32_t block_size_ = 0;
+    std::streampos section_end_{};
+};
+
+#endif // STATE_FILE_H
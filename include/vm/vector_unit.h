@@ -0,0 +1,74 @@
+/**
+ * @file vector_unit.h
+ * @brief The RVV subset shared by the single cycle vm and the pipelines, executed element by element on host SIMD
+ */
+
+#ifndef VECTOR_UNIT_H
+#define VECTOR_UNIT_H
+
+#include "vm/alu.h"
+#include "vm/memory_controller.h"
+#include "vm/registers.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Implements vset{i}vl{i}, the unit-stride and strided loads and stores and the integer / fp add, sub, mul, multiply-add
+// and sum reductions of RVV 1.0, unmasked, with SEW 8 to 64 (32 and 64 for fp) and LMUL 1 to 8. vstart is always 0
+// and the tail is left undisturbed. The vms read the scalar operands and keep the undo records, everything else is here.
+namespace vector_unit {
+
+struct VType {
+    unsigned int sew_bytes = 0;
+    unsigned int lmul = 0;
+    bool vill = true;       // reserved or unsupported vtype (fractional LMUL), no vector instruction but vset may run
+};
+
+VType decodeVType(uint64_t vtype);
+
+// elements of SEW in a register group of LMUL registers of register_words words each
+uint64_t vlmax(const VType &type, std::size_t register_words);
+
+// vset{i}vl{i}: the new vl, also written to rd, and vtype
+struct Config {
+    uint64_t vl = 0;
+    uint64_t vtype = RegisterFile::VTYPE_VILL;
+};
+
+Config configure(uint32_t instruction, uint64_t rs1_value, uint64_t rs2_value, const RegisterFile &registers);
+
+bool isConfig(uint32_t instruction);
+
+// vsetvl reads vtype and the strided accesses the stride from rs2
+bool readsScalarRs2(uint32_t instruction);
+
+// false while vtype is illegal, for register groups not aligned to their size and for fp on SEW 8 / 16
+bool isLegal(uint32_t instruction, const RegisterFile &registers);
+
+// What execute() overwrites, so the vms can keep the old values for undo before running it
+struct Footprint {
+    std::size_t first_word = 0;     // vector register words, indexed as by RegisterFile::ReadVectorWord
+    std::size_t words = 0;
+    uint64_t address = 0;           // stores: elements bytes wide at address + i * stride, i < elements
+    int64_t stride = 0;
+    unsigned int element_bytes = 0;
+    uint64_t elements = 0;
+};
+
+Footprint footprint(uint32_t instruction, const RegisterFile &registers, uint64_t rs1_value, uint64_t rs2_value);
+
+/**
+ * @brief Executes a legal vector instruction other than vset{i}vl{i}.
+ * @param rs1_value The scalar operand: the base address, the gpr of .vx or the fpr of .vf.
+ * @param rs2_value The stride of the strided accesses.
+ * @return The fflags raised.
+ */
+uint8_t execute(uint32_t instruction, RegisterFile &registers, MemoryController &memory, const alu::Alu &alu,
+                uint64_t rs1_value, uint64_t rs2_value);
+
+// Cycles the vector unit is busy with an instruction: vl elements through lanes 64-bit lanes, at least 1
+unsigned int occupancy(uint32_t instruction, const RegisterFile &registers, uint64_t lanes);
+
+} // namespace vector_unit
+
+#endif // VECTOR_UNIT_H
@@ -9,7 +9,10 @@
 
 #include "registers.h"
 #include "memory_controller.h"
+#include "atomic_unit.h"
 #include "alu.h"
+#include "branch_profile.h"
+#include "stall_accounting.h"
 
 #include "vm_asm_mw.h"
 
@@ -21,6 +24,14 @@
 #include <condition_variable>
 #include <queue>
 #include <atomic>
+#include <memory>
+#include <ostream>
+
+class LockstepChecker;
+class HartGroup;
+struct RetiredInstruction;
+class StateWriter;
+class StateReader;
 
 enum SyscallCode {
     SYSCALL_PRINT_INT = 1,
@@ -36,7 +47,7 @@ enum SyscallCode {
 class VmBase {
 public:
     explicit VmBase(bool silent = false);
-    ~VmBase() = default;
+    ~VmBase();
 
     AssembledProgram program_;
     std::atomic<bool> stop_requested_ = false;
@@ -55,6 +66,9 @@ public:
     float ipc_{};
     unsigned int stall_cycles_{};
     unsigned int branch_mispredictions_{};
+    BranchProfile branch_profile_;          // per-pc breakdown of the branches, filled by the vms that predict branches
+    StallAccounting stall_accounting_;      // lost cycles by cause, filled by the pipelined vms
+    std::unique_ptr<LockstepChecker> lockstep_checker_;     // golden vm the pipelined vms replay every retired instruction on, null -> off
 
     std::string output_status_;
 
@@ -64,6 +78,7 @@ public:
 
     MemoryController memory_controller_;
     RegisterFile registers_;
+    atomic_unit::Reservation reservation_;     // lr / sc reservation of this hart
     
     alu::Alu alu_;
 
@@ -72,8 +87,21 @@ public:
     uint64_t program_size_ = 0;
     void SetProgramSize(uint64_t size);     // to be used for testing later
 
+    // false for the pipelines that do not execute F/D, CSR instructions and ecall: loading a program that holds any of
+    // them throws instead of letting them run as bubbles
+    virtual bool ExecutesFpCsr() const { return true; }
+    // false for the pipelines that decode vector instructions as bubbles, checked the same way
+    virtual bool ExecutesVector() const { return true; }
+    // false for the pipelines that decode lr, sc and the amos as bubbles, checked the same way
+    virtual bool ExecutesAtomic() const { return true; }
+    void CheckProgramSupported();           // the text loaded in memory, for the memory images loaded without LoadProgram
+    // a csr instruction at pc writing a read-only CSR or accessing one that is not implemented, see CheckCsrAccess
+    void ReportCsrAccess(uint16_t csr, bool write, uint64_t pc) const;
+
     uint64_t GetProgramCounter() const;
     void UpdateProgramCounter(int64_t value);
+    // the instruction at pc, a compressed one expanded to its 32-bit form; length gets its size in bytes (2 or 4)
+    uint32_t FetchInstruction(uint64_t pc, uint8_t &length);
     
     int32_t ImmGenerator(uint32_t instruction);
 
@@ -87,7 +115,13 @@ public:
     // void memoryAccess();
     // void writeback();
 
-    // void HandleSyscall();
+    void HandleSyscall();                   // ecall with the syscall number in a7, shared by all the vms
+
+    // lockstep co-simulation, the golden vm starts from the current state -> enable once the program is loaded
+    void EnableLockstepCheck();
+    bool LockstepDiverged() const;
+    bool CheckRetired(const RetiredInstruction &retired);   // false at a divergence, which is reported and stops the run
+    bool CheckLockstepEnd();                                // the pipeline drained, false if the golden vm was not done
     void PrintString(uint64_t address);
 
     // only difference between run and debugrun is that debugrun has an intercycle delay
@@ -98,6 +132,31 @@ public:
     virtual void Redo() = 0;
     virtual void Reset() = 0;
 
+    // moves to the state after the given number of retired instructions, backwards or forwards
+    virtual void Seek(uint64_t instruction);
+    // registers or memory were edited from outside the program, history recorded past this point no longer matches
+    virtual void StateEdited() {}
+
+    // save_state / load_state, see state_file.h. Loading resets the vm and skips the sections it does not know, so a
+    // state saved by another vm resumes at the oldest instruction that vm had not retired.
+    bool SaveState(const std::filesystem::path &filename, bool compress);
+    bool LoadState(const std::filesystem::path &filename);
+    virtual uint64_t ResumePc() const { return program_counter_; }     // pc of the oldest instruction not retired yet
+    virtual void SaveMicroarchState(StateWriter & /*writer*/) {}
+    // false if the section is not one of this vm's
+    virtual bool LoadMicroarchSection(StateReader & /*reader*/, uint32_t /*tag*/) { return false; }
+
+    // what-if child of parent (see vm_fork.h): starts at the oldest instruction parent has not retired, on a copy of its
+    // registers and a copy-on-write view of its memory. Its syscalls have no terminal: output is dropped, a read of
+    // stdin sees the end of the input and exit only stops this vm.
+    void ForkFrom(const VmBase &parent);
+    bool forked_ = false;
+
+    // set on the harts of a HartGroup (see hart_group.h): stdout is muted while they run, their syscalls print to
+    // console_ instead, and the state dumps report the counters of every hart of the group
+    std::ostream *console_ = nullptr;
+    const HartGroup *hart_group_ = nullptr;
+
     // Added declarations for functions related to (std::atomic<bool> stop_requested_ = false)
     virtual void RequestStop();
     virtual bool IsStopRequested() const;
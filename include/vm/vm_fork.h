@@ -0,0 +1,63 @@
+/**
+ * @file vm_fork.h
+ * @brief What-if runs: child vms forked from a loaded or partly executed vm, each under its own config, run to the end of the program in parallel
+ */
+
+#ifndef VM_FORK_H
+#define VM_FORK_H
+
+#include "vm/vm_base.h"
+#include "config.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+struct ForkSpec {
+    std::string overrides;              // as given, e.g. "branch_predictor=dynamic_2bit,branch_stage=id"
+    vm_config::VmConfig config;
+};
+
+// counters of a child over the part of the program it ran after the fork
+struct ForkResult {
+    std::string overrides;
+    std::string status;                 // output status the child ended with, VM_LIMIT_REACHED when it was stopped at
+                                        // instruction_execution_limit
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t stall_cycles = 0;
+    uint64_t branch_mispredictions = 0;
+    double cpi = 0.0;
+    double ipc = 0.0;
+};
+
+// builds the vm described by vm_config::config
+using VmFactory = std::function<std::unique_ptr<VmBase>()>;
+
+// the vms report every step on stdout, the vms run on worker threads write through this instead
+class DiscardBuffer : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override {
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char * /*data*/, std::streamsize count) override {
+        return count;
+    }
+};
+
+// comma separated key=value pairs of the Execution section, applied in order on top of base, throws on an invalid one
+ForkSpec parseForkSpec(const std::string &overrides, const vm_config::VmConfig &base);
+
+// Forks one child of parent per spec and runs the children on a pool of worker threads, each to the end of the program
+// or to the instruction_execution_limit of its spec, results are in the order of specs. The children share the memory blocks of parent until they write them. parent must not run meanwhile.
+std::vector<ForkResult> forkAndRun(const VmBase &parent, const std::vector<ForkSpec> &specs, const VmFactory &factory,
+                                   unsigned int num_threads = 0);
+
+void dumpForkResults(const std::filesystem::path &filename, uint64_t fork_point, const std::vector<ForkResult> &results);
+
+#endif // VM_FORK_H
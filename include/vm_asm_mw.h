@@ -30,7 +30,13 @@ struct AssembledProgram {
 
   std::string filename;
   std::vector<std::variant<uint8_t, uint16_t, uint32_t, uint64_t, std::string, float, double>> data_buffer;
-  std::vector<uint32_t> text_buffer;
+  std::vector<uint32_t> text_buffer;           // a compressed (RV64C) instruction is held in the low 16 bits
+  std::vector<uint64_t> instruction_addresses;  // address of every instruction, empty when all of them are 4 bytes
+
+  uint64_t InstructionAddress(unsigned int instruction_number) const;
+  // number of the instruction at address, the number of instructions if none starts there
+  unsigned int InstructionNumber(uint64_t address) const;
+  uint64_t TextSize() const;
 };
 
 #endif // VM_ASM_MW_H
\ No newline at end of file
@@ -51,6 +51,7 @@ void LoadMemoryImage(VmBase* vm, const std::string& image_path) {
                 std::cerr << "Warning: Unknown memory image type: " << type << std::endl;
         }
     }
+    vm->CheckProgramSupported();
 }
 
 #endif
\ No newline at end of file
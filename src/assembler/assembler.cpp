@@ -9,6 +9,7 @@
 #include "assembler/assembler.h"
 #include "utils.h"
 #include "globals.h"
+#include "config.h"
 
 #include <string>
 #include <memory>
@@ -50,6 +51,9 @@ AssembledProgram assemble(const std::string &filename, bool silent_mode) {
 
     program.data_buffer = parser.getDataBuffer();
     program.intermediate_code = parser.getIntermediateCode();
+    if (vm_config::config.getCExtensionEnabled()) {
+      program.instruction_addresses = compressMachineCode(program.intermediate_code, machine_code_bits);
+    }
     program.text_buffer = machine_code_bits;
     program.instruction_number_line_number_mapping = parser.getInstructionNumberLineNumberMapping();
 
@@ -72,6 +76,13 @@ AssembledProgram assemble(const std::string &filename, bool silent_mode) {
     }();
 
     program.symbol_table = parser.getSymbolTable();
+    if (!program.instruction_addresses.empty()) {
+      for (auto &[name, symbol] : program.symbol_table) {   // text labels move with their instruction
+        if (!symbol.isData) {
+          symbol.address = program.InstructionAddress(static_cast<unsigned int>(symbol.address / 4));
+        }
+      }
+    }
 
     if(!silent_mode) {
       DumpDisasssembly(globals::disassembly_file_path, program);
@@ -10,6 +10,7 @@
 #include <vector>
 #include <string>
 #include <stdexcept>
+#include <utility>
 
 std::vector<std::string> printIntermediateCode(const std::vector<std::pair<ICUnit, bool>> &IntermediateCode) {
   std::vector<std::string> ICList;
@@ -19,6 +20,8 @@ std::vector<std::string> printIntermediateCode(const std::vector<std::pair<ICUni
 
     if (instruction_set::isValidRTypeInstruction(block.getOpcode())) {
       code = block.getOpcode() + " " + block.getRd() + " " + block.getRs1() + " " + block.getRs2();
+    } else if (instruction_set::isValidR2TypeInstruction(block.getOpcode())) {
+      code = block.getOpcode() + " " + block.getRd() + " " + block.getRs1();
     } else if (instruction_set::isValidITypeInstruction(block.getOpcode())) {
       code = block.getOpcode() + " " + block.getRd() + " " + block.getRs1() + " " + block.getImm();
     } else if (instruction_set::isValidSTypeInstruction(block.getOpcode())) {
@@ -30,6 +33,11 @@ std::vector<std::string> printIntermediateCode(const std::vector<std::pair<ICUni
       code = block.getOpcode() + " " + block.getRd() + " " + block.getImm();
     } else if (instruction_set::isValidJTypeInstruction(block.getOpcode())) {
       code = block.getOpcode() + " " + block.getRd() + " " + block.getImm() + " <" + block.getLabel() + ">";
+    } else if (instruction_set::isValidVExtensionInstruction(block.getOpcode())) {
+      code = block.getOpcode() + " " + block.getRd() + " " + block.getRs2() + " " + block.getRs1() + " "
+          + block.getImm();
+    } else if (instruction_set::isValidAExtensionInstruction(block.getOpcode())) {
+      code = block.getOpcode() + " " + block.getRd() + " " + block.getRs2() + " (" + block.getRs1() + ")";
     } else {
       code = block.getOpcode() + " " + block.getImm();
     }
@@ -61,6 +69,20 @@ uint32_t generateRTypeMachineCode(const ICUnit &block) {
   return machineCode;
 }
 
+uint32_t generateR2TypeMachineCode(const ICUnit &block) {
+  const auto &encoding = instruction_set::R2_type_instruction_encoding_map.at(block.getOpcode());
+  const uint32_t rd = extractRegisterIndex(block.getRd());
+  const uint32_t rs1 = extractRegisterIndex(block.getRs1());
+  uint32_t machineCode = 0;
+  machineCode |= (encoding.funct7.to_ulong() << 25);
+  machineCode |= (encoding.funct5.to_ulong() << 20);
+  machineCode |= (rs1 << 15);
+  machineCode |= (encoding.funct3.to_ulong() << 12);
+  machineCode |= (rd << 7);
+  machineCode |= encoding.opcode.to_ulong();
+  return machineCode;
+}
+
 uint32_t generateI1TypeMachineCode(const ICUnit &block) {
   const auto &encoding = instruction_set::I1_type_instruction_encoding_map.at(block.getOpcode());
   const uint32_t rd = extractRegisterIndex(block.getRd());
@@ -306,52 +328,441 @@ uint32_t generateFDSTypeMachineCode(const ICUnit &block) {
   return machineCode;
 }
 
+uint32_t generateVTypeMachineCode(const ICUnit &block) {
+  const auto &encoding = instruction_set::V_type_instruction_encoding_map.at(block.getOpcode());
+  const uint32_t rd = extractRegisterIndex(block.getRd());
+  uint32_t machineCode = 0;
+  if (block.getOpcode()=="vsetvli") {
+    const uint32_t vtypei = static_cast<uint32_t>(std::stoi(block.getImm())) & 0x7FF;
+    machineCode |= (vtypei << 20);                         // zimm[10:0] to bits 30:20, bit 31 = 0
+    machineCode |= (extractRegisterIndex(block.getRs1()) << 15);
+  } else if (block.getOpcode()=="vsetivli") {
+    const uint32_t imm = static_cast<uint32_t>(std::stoi(block.getImm()));
+    machineCode |= (encoding.funct7.to_ulong() << 25);     // bits 31:30 = 11
+    machineCode |= (((imm >> 5) & 0x3FF) << 20);           // zimm[9:0] to bits 29:20
+    machineCode |= ((imm & 0b11111) << 15);                // uimm to bits 19:15
+  } else {
+    machineCode |= (encoding.funct7.to_ulong() << 25);
+    machineCode |= ((block.getRs2().empty() ? static_cast<uint32_t>(encoding.funct5.to_ulong())
+                                            : extractRegisterIndex(block.getRs2())) << 20);
+    if (block.getRs1().empty()) {                          // .vi and vmv.v.i: simm5 to bits 19:15
+      machineCode |= ((static_cast<uint32_t>(std::stoi(block.getImm())) & 0b11111) << 15);
+    } else {
+      machineCode |= (extractRegisterIndex(block.getRs1()) << 15);
+    }
+  }
+  machineCode |= (encoding.funct3.to_ulong() << 12);
+  machineCode |= (rd << 7);
+  machineCode |= encoding.opcode.to_ulong();
+  return machineCode;
+}
+
+uint32_t generateATypeMachineCode(const ICUnit &block) {
+  const auto &encoding = instruction_set::A_type_instruction_encoding_map.at(block.getOpcode());
+  uint32_t machineCode = 0;
+  machineCode |= (encoding.funct7.to_ulong() << 25);
+  if (!block.getRs2().empty()) {
+    machineCode |= (extractRegisterIndex(block.getRs2()) << 20);
+  }
+  machineCode |= (extractRegisterIndex(block.getRs1()) << 15);
+  machineCode |= (encoding.funct3.to_ulong() << 12);
+  machineCode |= (extractRegisterIndex(block.getRd()) << 7);
+  machineCode |= encoding.opcode.to_ulong();
+  return machineCode;
+}
+
+static uint32_t generateInstructionMachineCode(const ICUnit &block) {
+  if (instruction_set::isValidRTypeInstruction(block.getOpcode())) {
+    return generateRTypeMachineCode(block);
+  } else if (instruction_set::isValidR2TypeInstruction(block.getOpcode())) {
+    return generateR2TypeMachineCode(block);
+  } else if (instruction_set::isValidI1TypeInstruction(block.getOpcode())) {
+    return generateI1TypeMachineCode(block);
+  } else if (instruction_set::isValidI2TypeInstruction(block.getOpcode())) {
+    return generateI2TypeMachineCode(block);
+  } else if (instruction_set::isValidI3TypeInstruction(block.getOpcode())) {
+    return generateI3TypeMachineCode(block);
+  } else if (instruction_set::isValidSTypeInstruction(block.getOpcode())) {
+    return generateSTypeMachineCode(block);
+  } else if (instruction_set::isValidBTypeInstruction(block.getOpcode())) {
+    return generateBTypeMachineCode(block);
+  } else if (instruction_set::isValidUTypeInstruction(block.getOpcode())) {
+    return generateUTypeMachineCode(block);
+  } else if (instruction_set::isValidJTypeInstruction(block.getOpcode())) {
+    return generateJTypeMachineCode(block);
+  } else if (instruction_set::isValidCSRRTypeInstruction(block.getOpcode())) {
+    return generateCSRRTypeMachineCode(block);
+  } else if (instruction_set::isValidCSRITypeInstruction(block.getOpcode())) {
+    return generateCSRITypeMachineCode(block);
+  } else if (instruction_set::isValidFDRTypeInstruction(block.getOpcode())) {
+    return generateFDRTypeMachineCode(block);
+  } else if (instruction_set::isValidFDR1TypeInstruction(block.getOpcode())) {
+    return generateFDR1TypeMachineCode(block);
+  } else if (instruction_set::isValidFDR2TypeInstruction(block.getOpcode())) {
+    return generateFDR2TypeMachineCode(block);
+  } else if (instruction_set::isValidFDR3TypeInstruction(block.getOpcode())) {
+    return generateFDR3TypeMachineCode(block);
+  } else if (instruction_set::isValidFDR4TypeInstruction(block.getOpcode())) {
+    return generateFDR4TypeMachineCode(block);
+  } else if (instruction_set::isValidFDITypeInstruction(block.getOpcode())) {
+    return generateFDITypeMachineCode(block);
+  } else if (instruction_set::isValidFDSTypeInstruction(block.getOpcode())) {
+    return generateFDSTypeMachineCode(block);
+  } else if (instruction_set::isValidVExtensionInstruction(block.getOpcode())) {
+    return generateVTypeMachineCode(block);
+  } else if (instruction_set::isValidAExtensionInstruction(block.getOpcode())) {
+    return generateATypeMachineCode(block);
+  }
+  throw std::runtime_error("Invalid instruction type: " + block.getOpcode());
+}
+
 std::vector<uint32_t> generateMachineCode(const std::vector<std::pair<ICUnit, bool>> &IntermediateCode) {
   std::vector<uint32_t> machine_code;
   for (const auto &pair : IntermediateCode) {
-    const ICUnit &block = pair.first;
-    uint32_t code;
-    if (instruction_set::isValidRTypeInstruction(block.getOpcode())) {
-      code = generateRTypeMachineCode(block);
-    } else if (instruction_set::isValidI1TypeInstruction(block.getOpcode())) {
-      code = generateI1TypeMachineCode(block);
-    } else if (instruction_set::isValidI2TypeInstruction(block.getOpcode())) {
-      code = generateI2TypeMachineCode(block);
-    } else if (instruction_set::isValidI3TypeInstruction(block.getOpcode())) {
-      code = generateI3TypeMachineCode(block);
-    } else if (instruction_set::isValidSTypeInstruction(block.getOpcode())) {
-      code = generateSTypeMachineCode(block);
-    } else if (instruction_set::isValidBTypeInstruction(block.getOpcode())) {
-      code = generateBTypeMachineCode(block);
-    } else if (instruction_set::isValidUTypeInstruction(block.getOpcode())) {
-      code = generateUTypeMachineCode(block);
-    } else if (instruction_set::isValidJTypeInstruction(block.getOpcode())) {
-      code = generateJTypeMachineCode(block);
-    } else if (instruction_set::isValidCSRRTypeInstruction(block.getOpcode())) {
-      code = generateCSRRTypeMachineCode(block);
-    } else if (instruction_set::isValidCSRITypeInstruction(block.getOpcode())) {
-      code = generateCSRITypeMachineCode(block);
-    } else if (instruction_set::isValidFDRTypeInstruction(block.getOpcode())) {
-      code = generateFDRTypeMachineCode(block);
-    } else if (instruction_set::isValidFDR1TypeInstruction(block.getOpcode())) {
-      code = generateFDR1TypeMachineCode(block);
-    } else if (instruction_set::isValidFDR2TypeInstruction(block.getOpcode())) {
-      code = generateFDR2TypeMachineCode(block);
-    } else if (instruction_set::isValidFDR3TypeInstruction(block.getOpcode())) {
-      code = generateFDR3TypeMachineCode(block);
-    } else if (instruction_set::isValidFDR4TypeInstruction(block.getOpcode())) {
-      code = generateFDR4TypeMachineCode(block);
-    } else if (instruction_set::isValidFDITypeInstruction(block.getOpcode())) {
-      code = generateFDITypeMachineCode(block);
-    } else if (instruction_set::isValidFDSTypeInstruction(block.getOpcode())) {
-      code = generateFDSTypeMachineCode(block);
-    } else {
-      throw std::runtime_error("Invalid instruction type: " + block.getOpcode());
-    }
-    machine_code.push_back(code);
+    machine_code.push_back(generateInstructionMachineCode(pair.first));
   }
   return machine_code;
 }
 
+static inline uint32_t bitField(uint32_t value, unsigned int hi, unsigned int lo) {
+  return (value >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+static inline int32_t signExtendField(uint32_t value, unsigned int width) {
+  return static_cast<int32_t>(value << (32 - width)) >> (32 - width);
+}
+
+static inline bool fitsSigned(int64_t value, unsigned int width) {
+  return value >= -(int64_t{1} << (width - 1)) && value < (int64_t{1} << (width - 1));
+}
+
+static inline bool isCompressedRegister(uint32_t reg) {  // x8-x15, the registers of the 3-bit register fields
+  return reg >= 8 && reg <= 15;
+}
+
+// c.lw, c.ld, c.fld and the stores, reg is rd' for the loads and rs2' for the stores
+static uint16_t compressMemoryAccess(uint32_t funct3, uint32_t offset, uint32_t rs1, uint32_t reg, bool word) {
+  uint32_t offset_bits = word ? bitField(offset, 2, 2) << 1 | bitField(offset, 6, 6)
+                              : bitField(offset, 7, 6);
+  return static_cast<uint16_t>(funct3 << 13 | bitField(offset, 5, 3) << 10 | (rs1 - 8) << 7 | offset_bits << 5
+      | (reg - 8) << 2);
+}
+
+// c.lwsp, c.ldsp, c.fldsp
+static uint16_t compressStackLoad(uint32_t funct3, uint32_t offset, uint32_t rd, bool word) {
+  uint32_t offset_bits = word ? bitField(offset, 4, 2) << 2 | bitField(offset, 7, 6)
+                              : bitField(offset, 4, 3) << 3 | bitField(offset, 8, 6);
+  return static_cast<uint16_t>(funct3 << 13 | bitField(offset, 5, 5) << 12 | rd << 7 | offset_bits << 2 | 0b10);
+}
+
+// c.swsp, c.sdsp, c.fsdsp
+static uint16_t compressStackStore(uint32_t funct3, uint32_t offset, uint32_t rs2, bool word) {
+  uint32_t offset_bits = word ? bitField(offset, 5, 2) << 2 | bitField(offset, 7, 6)
+                              : bitField(offset, 5, 3) << 3 | bitField(offset, 8, 6);
+  return static_cast<uint16_t>(funct3 << 13 | offset_bits << 7 | rs2 << 2 | 0b10);
+}
+
+uint16_t compressInstruction(uint32_t instruction) {
+  const uint32_t opcode = instruction & 0b1111111;
+  const uint32_t rd = bitField(instruction, 11, 7);
+  const uint32_t funct3 = bitField(instruction, 14, 12);
+  uint32_t rs1 = bitField(instruction, 19, 15);
+  uint32_t rs2 = bitField(instruction, 24, 20);
+  const uint32_t funct7 = bitField(instruction, 31, 25);
+  const int32_t imm_i = signExtendField(bitField(instruction, 31, 20), 12);
+  const int32_t imm_s = signExtendField(funct7 << 5 | rd, 12);
+  const uint32_t shamt = bitField(instruction, 25, 20);
+
+  auto ci = [](uint32_t ci_funct3, int32_t imm, uint32_t ci_rd, uint32_t quadrant) {
+    auto bits = static_cast<uint32_t>(imm);
+    return static_cast<uint16_t>(ci_funct3 << 13 | bitField(bits, 5, 5) << 12 | ci_rd << 7 | bitField(bits, 4, 0) << 2
+        | quadrant);
+  };
+  auto cr = [](uint32_t funct4, uint32_t cr_rd, uint32_t cr_rs2) {
+    return static_cast<uint16_t>(funct4 << 12 | cr_rd << 7 | cr_rs2 << 2 | 0b10);
+  };
+  auto ca = [](uint32_t funct6, uint32_t ca_rd, uint32_t funct2, uint32_t ca_rs2) {
+    return static_cast<uint16_t>(funct6 << 10 | (ca_rd - 8) << 7 | funct2 << 5 | (ca_rs2 - 8) << 2 | 0b01);
+  };
+  auto cb = [](uint32_t funct2, uint32_t cb_rd, int32_t imm) {   // c.srli, c.srai, c.andi
+    auto bits = static_cast<uint32_t>(imm);
+    return static_cast<uint16_t>(0b100 << 13 | bitField(bits, 5, 5) << 12 | funct2 << 10 | (cb_rd - 8) << 7
+        | bitField(bits, 4, 0) << 2 | 0b01);
+  };
+
+  switch (opcode) {
+    case 0b0010011:   // OP-IMM
+      if (funct3 == 0b000) {
+        if (rd == 0) {
+          return (rs1 == 0 && imm_i == 0) ? 0x0001 : 0;    // c.nop
+        }
+        auto imm = static_cast<uint32_t>(imm_i);
+        if (rd == 2 && rs1 == 2 && imm_i != 0 && imm_i % 16 == 0 && fitsSigned(imm_i, 10)) {   // c.addi16sp
+          return static_cast<uint16_t>(0b011 << 13 | bitField(imm, 9, 9) << 12 | 2 << 7 | bitField(imm, 4, 4) << 6
+              | bitField(imm, 6, 6) << 5 | bitField(imm, 8, 7) << 3 | bitField(imm, 5, 5) << 2 | 0b01);
+        }
+        if (rs1 == 2 && isCompressedRegister(rd) && imm_i > 0 && imm_i % 4 == 0 && imm_i < 1024) {    // c.addi4spn
+          return static_cast<uint16_t>(bitField(imm, 5, 4) << 11 | bitField(imm, 9, 6) << 7 | bitField(imm, 2, 2) << 6
+              | bitField(imm, 3, 3) << 5 | (rd - 8) << 2);
+        }
+        if (rs1 == 0 && fitsSigned(imm_i, 6)) {
+          return ci(0b010, imm_i, rd, 0b01);     // c.li
+        }
+        if (rs1 == rd && imm_i != 0 && fitsSigned(imm_i, 6)) {
+          return ci(0b000, imm_i, rd, 0b01);     // c.addi
+        }
+        if (imm_i == 0 && rs1 != 0) {
+          return cr(0b1000, rd, rs1);            // mv
+        }
+        return 0;
+      }
+      if (funct3 == 0b001 && rd != 0 && rd == rs1 && funct7 >> 1 == 0 && shamt != 0) {
+        return ci(0b000, static_cast<int32_t>(shamt), rd, 0b10);   // c.slli
+      }
+      if (funct3 == 0b101 && isCompressedRegister(rd) && rd == rs1 && shamt != 0) {
+        if (funct7 >> 1 == 0) {
+          return cb(0b00, rd, static_cast<int32_t>(shamt));        // c.srli
+        }
+        if (funct7 >> 1 == 0b010000) {
+          return cb(0b01, rd, static_cast<int32_t>(shamt));        // c.srai
+        }
+      }
+      if (funct3 == 0b111 && isCompressedRegister(rd) && rd == rs1 && fitsSigned(imm_i, 6)) {
+        return cb(0b10, rd, imm_i);                                // c.andi
+      }
+      return 0;
+
+    case 0b0011011:   // addiw
+      if (funct3 == 0b000 && rd != 0 && rd == rs1 && fitsSigned(imm_i, 6)) {
+        return ci(0b001, imm_i, rd, 0b01);
+      }
+      return 0;
+
+    case 0b0110111: {   // lui
+      int32_t imm = static_cast<int32_t>(instruction) >> 12;
+      if (rd != 0 && rd != 2 && imm != 0 && fitsSigned(imm, 6)) {
+        return ci(0b011, imm, rd, 0b01);
+      }
+      return 0;
+    }
+
+    case 0b0110011:   // OP
+      if (funct7 == 0 && funct3 == 0b000) {     // add
+        if (rd == 0) {
+          return 0;
+        }
+        if (rs1 == 0 || rs2 == 0) {
+          return (rs1 | rs2) == 0 ? 0 : cr(0b1000, rd, rs1 | rs2);    // mv
+        }
+        if (rs2 == rd) {
+          std::swap(rs1, rs2);
+        }
+        return rs1 == rd ? cr(0b1001, rd, rs2) : 0;                   // c.add
+      }
+      if (!isCompressedRegister(rd)) {
+        return 0;
+      }
+      if (funct7 == 0 && rs2 == rd && (funct3 == 0b100 || funct3 >= 0b110)) {    // xor, or, and commute
+        std::swap(rs1, rs2);
+      }
+      if (rd != rs1 || !isCompressedRegister(rs2)) {
+        return 0;
+      }
+      if (funct7 == 0b0100000 && funct3 == 0b000) {
+        return ca(0b100011, rd, 0b00, rs2);     // c.sub
+      }
+      if (funct7 == 0 && funct3 == 0b100) {
+        return ca(0b100011, rd, 0b01, rs2);     // c.xor
+      }
+      if (funct7 == 0 && funct3 == 0b110) {
+        return ca(0b100011, rd, 0b10, rs2);     // c.or
+      }
+      if (funct7 == 0 && funct3 == 0b111) {
+        return ca(0b100011, rd, 0b11, rs2);     // c.and
+      }
+      return 0;
+
+    case 0b0111011:   // OP-32
+      if (funct3 != 0b000 || !isCompressedRegister(rd)) {
+        return 0;
+      }
+      if (funct7 == 0 && rs2 == rd) {     // addw commutes
+        std::swap(rs1, rs2);
+      }
+      if (rd != rs1 || !isCompressedRegister(rs2)) {
+        return 0;
+      }
+      if (funct7 == 0b0100000) {
+        return ca(0b100111, rd, 0b00, rs2);     // c.subw
+      }
+      return funct7 == 0 ? ca(0b100111, rd, 0b01, rs2) : 0;     // c.addw
+
+    case 0b0000011:   // lw, ld
+    case 0b0000111: { // fld
+      bool word = opcode == 0b0000011 && funct3 == 0b010;
+      bool doubleword = funct3 == 0b011;
+      if (!word && !doubleword) {
+        return 0;
+      }
+      uint32_t c_funct3 = opcode == 0b0000111 ? 0b001 : funct3;
+      uint32_t alignment = word ? 4 : 8;
+      if (imm_i < 0 || imm_i % alignment != 0) {
+        return 0;
+      }
+      auto offset = static_cast<uint32_t>(imm_i);
+      if (rs1 == 2 && offset < alignment * 64 && (rd != 0 || opcode == 0b0000111)) {
+        return compressStackLoad(c_funct3, offset, rd, word);
+      }
+      if (isCompressedRegister(rs1) && isCompressedRegister(rd) && offset < alignment * 32) {
+        return compressMemoryAccess(c_funct3, offset, rs1, rd, word);
+      }
+      return 0;
+    }
+
+    case 0b0100011:   // sw, sd
+    case 0b0100111: { // fsd
+      bool word = opcode == 0b0100011 && funct3 == 0b010;
+      bool doubleword = funct3 == 0b011;
+      if (!word && !doubleword) {
+        return 0;
+      }
+      uint32_t c_funct3 = opcode == 0b0100111 ? 0b101 : 0b100 | funct3;
+      uint32_t alignment = word ? 4 : 8;
+      if (imm_s < 0 || imm_s % alignment != 0) {
+        return 0;
+      }
+      auto offset = static_cast<uint32_t>(imm_s);
+      if (rs1 == 2 && offset < alignment * 64) {
+        return compressStackStore(c_funct3, offset, rs2, word);
+      }
+      if (isCompressedRegister(rs1) && isCompressedRegister(rs2) && offset < alignment * 32) {
+        return compressMemoryAccess(c_funct3, offset, rs1, rs2, word);
+      }
+      return 0;
+    }
+
+    case 0b1100011: {   // beq, bne against x0
+      int32_t offset = signExtendField(bitField(instruction, 31, 31) << 12 | bitField(instruction, 7, 7) << 11
+          | bitField(instruction, 30, 25) << 5 | bitField(instruction, 11, 8) << 1, 13);
+      if (funct3 > 0b001 || rs2 != 0 || !isCompressedRegister(rs1) || !fitsSigned(offset, 9)) {
+        return 0;
+      }
+      auto bits = static_cast<uint32_t>(offset);
+      return static_cast<uint16_t>((0b110 | funct3) << 13 | bitField(bits, 8, 8) << 12 | bitField(bits, 4, 3) << 10
+          | (rs1 - 8) << 7 | bitField(bits, 7, 6) << 5 | bitField(bits, 2, 1) << 3 | bitField(bits, 5, 5) << 2 | 0b01);
+    }
 
+    case 0b1101111: {   // jal x0 (c.jal is RV32 only)
+      int32_t offset = signExtendField(bitField(instruction, 31, 31) << 20 | bitField(instruction, 19, 12) << 12
+          | bitField(instruction, 20, 20) << 11 | bitField(instruction, 30, 21) << 1, 21);
+      if (rd != 0 || !fitsSigned(offset, 12)) {
+        return 0;
+      }
+      auto bits = static_cast<uint32_t>(offset);
+      return static_cast<uint16_t>(0b101 << 13 | bitField(bits, 11, 11) << 12 | bitField(bits, 4, 4) << 11
+          | bitField(bits, 9, 8) << 9 | bitField(bits, 10, 10) << 8 | bitField(bits, 6, 6) << 7
+          | bitField(bits, 7, 7) << 6 | bitField(bits, 3, 1) << 3 | bitField(bits, 5, 5) << 2 | 0b01);
+    }
+
+    case 0b1100111:   // jalr
+      if (funct3 != 0b000 || imm_i != 0 || rs1 == 0 || rd > 1) {
+        return 0;
+      }
+      return cr(rd == 0 ? 0b1000 : 0b1001, rs1, 0);     // c.jr, c.jalr
+
+    case 0b1110011:
+      return instruction == 0x00100073 ? 0x9002 : 0;    // c.ebreak
+
+    default:
+      return 0;
+  }
+}
+
+std::vector<uint64_t> compressMachineCode(std::vector<std::pair<ICUnit, bool>> &IntermediateCode,
+                                          std::vector<uint32_t> &machine_code) {
+  const std::size_t count = machine_code.size();
+
+  // label branches / jumps and the auipc of the auipc pairs, with their target in the uncompressed layout
+  std::vector<bool> pc_relative(count, false);
+  std::vector<int64_t> targets(count, 0);
+  std::vector<uint8_t> sizes(count, 4);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const ICUnit &block = IntermediateCode[i].first;
+    const auto pc = static_cast<int64_t>(i * 4);
+    bool label_jump = !block.getLabel().empty() && (instruction_set::isValidBTypeInstruction(block.getOpcode())
+        || instruction_set::isValidJTypeInstruction(block.getOpcode()));
+    if (label_jump) {
+      pc_relative[i] = true;
+      targets[i] = pc + std::stoll(block.getImm());
+    } else if (block.getOpcode() == "auipc" && i + 1 < count
+        && IntermediateCode[i + 1].first.getLineNumber() == block.getLineNumber()
+        && IntermediateCode[i + 1].first.getRs1() == block.getRd()) {
+      // la and the loads from a label, both halves stay 32-bit
+      pc_relative[i] = true;
+      targets[i] = pc + (std::stoll(block.getImm()) << 12) + std::stoll(IntermediateCode[i + 1].first.getImm());
+      ++i;
+      continue;
+    }
+    if (compressInstruction(machine_code[i]) != 0) {
+      sizes[i] = 2;
+    }
+  }
 
+  std::vector<uint64_t> addresses(count + 1);
+  auto layout = [&]() {
+    uint64_t address = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      addresses[i] = address;
+      address += sizes[i];
+    }
+    addresses[count] = address;
+  };
+  // a target at an instruction (or at the end of the text) moves with it, anything else is an absolute address
+  auto newOffset = [&](std::size_t i) {
+    int64_t target = targets[i];
+    if (target >= 0 && target % 4 == 0 && static_cast<std::size_t>(target / 4) <= count) {
+      target = static_cast<int64_t>(addresses[static_cast<std::size_t>(target / 4)]);
+    }
+    return target - static_cast<int64_t>(addresses[i]);
+  };
+
+  // compressed label branches / jumps only grow, so this ends once every offset fits
+  bool grown = true;
+  while (grown) {
+    grown = false;
+    layout();
+    for (std::size_t i = 0; i < count; ++i) {
+      if (pc_relative[i] && sizes[i] == 2) {
+        bool branch = instruction_set::isValidBTypeInstruction(IntermediateCode[i].first.getOpcode());
+        if (!fitsSigned(newOffset(i), branch ? 9 : 12)) {
+          sizes[i] = 4;
+          grown = true;
+        }
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    if (pc_relative[i]) {
+      ICUnit &block = IntermediateCode[i].first;
+      int64_t offset = newOffset(i);
+      if (block.getOpcode() == "auipc") {
+        ICUnit &low = IntermediateCode[i + 1].first;
+        int64_t hi20 = (offset + 0x800) >> 12;
+        block.setImm(std::to_string(hi20));
+        low.setImm(std::to_string(offset - (hi20 << 12)));
+        machine_code[i + 1] = generateInstructionMachineCode(low);
+      } else {
+        block.setImm(std::to_string(offset));
+      }
+      machine_code[i] = generateInstructionMachineCode(block);
+    }
+    if (sizes[i] == 2) {
+      machine_code[i] = compressInstruction(machine_code[i]);
+    }
+  }
+
+  addresses.pop_back();
+  return addresses;
+}
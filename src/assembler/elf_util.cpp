@@ -25,15 +25,15 @@ void generateElfFile(const AssembledProgram &program, const std::string &output_
   // Section Header String Table (stores section names)
   std::string shstrtab = "\0.text\0.data\0.shstrtab\0";
   uint32_t shstrtab_offset = sizeof(ElfHeader) + 3*sizeof(ElfSectionHeader)
-      + program.text_buffer.size()*sizeof(uint32_t)
+      + static_cast<uint32_t>(program.TextSize())
       + program.data_buffer.size();
   uint32_t text_offset = sizeof(ElfHeader) + 3*sizeof(ElfSectionHeader);
-  uint32_t data_offset = text_offset + program.text_buffer.size()*sizeof(uint32_t);
+  uint32_t data_offset = text_offset + static_cast<uint32_t>(program.TextSize());
 
   // Section Headers
   ElfSectionHeader nullSection = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}; // Empty first entry
   ElfSectionHeader textSection = {1, 1, 6, 0x1000, text_offset,
-                                  static_cast<uint32_t>(program.text_buffer.size()*sizeof(uint32_t)), 0, 0, 4, 0};
+                                  static_cast<uint32_t>(program.TextSize()), 0, 0, 4, 0};
   ElfSectionHeader dataSection = {7, 1, 3, 0x2000, data_offset,
                                   static_cast<uint32_t>(program.data_buffer.size()), 0, 0, 4, 0};
   ElfSectionHeader shstrtabSection = {13, 3, 0, 0, shstrtab_offset,
@@ -50,7 +50,8 @@ void generateElfFile(const AssembledProgram &program, const std::string &output_
 
   // Write `.text` section (machine code)
   for (const auto &instruction : program.text_buffer) {
-    elfFile.write(reinterpret_cast<const char *>(&instruction), sizeof(instruction));
+    // a compressed instruction takes its 16 low bits
+    elfFile.write(reinterpret_cast<const char *>(&instruction), (instruction & 0b11) == 0b11 ? 4 : 2);
   }
 
   // Write `.data` section (raw binary data)
@@ -10,6 +10,7 @@
 #include "common/instructions.h"
 #include "vm/registers.h"
 #include"common/rounding_modes.h"
+#include "common/vtype_fields.h"
 
 #include <utility>
 #include <string>
@@ -17,6 +18,7 @@
 #include <regex>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 Lexer::Lexer(std::string filename) : filename_(std::move(filename)), line_number_(0), column_number_(0), pos_(0) {
   input_.open(filename_);
@@ -107,6 +109,9 @@ Token Lexer::identifier() {
   if (IsValidFloatingPointRegister(value)) {
     return {TokenType::FP_REGISTER, value, line_number_, start_column};
   }
+  if (IsValidVectorRegister(value)) {
+    return {TokenType::VEC_REGISTER, value, line_number_, start_column};
+  }
   if (IsValidCsr(value)) {
     return {TokenType::CSR_REGISTER, value, line_number_, start_column};
   }
@@ -115,6 +120,17 @@ Token Lexer::identifier() {
     return {TokenType::RM, value, line_number_, start_column};
   }
 
+  // e32, m1, ta, ... are vtype fields only on a vsetvli / vsetivli line, elsewhere they can be labels
+  if (isValidVTypeField(value)) {
+    auto opcode = std::find_if(tokens_.rbegin(), tokens_.rend(), [this](const Token &token) {
+      return token.line_number!=line_number_ || token.type==TokenType::OPCODE;
+    });
+    if (opcode!=tokens_.rend() && opcode->line_number==line_number_
+        && (opcode->value=="vsetvli" || opcode->value=="vsetivli")) {
+      return {TokenType::VTYPE, value, line_number_, start_column};
+    }
+  }
+
   if (pos_ < current_line_.size() && current_line_[pos_]==':') {
     return {TokenType::LABEL, value, line_number_, start_column};
   }
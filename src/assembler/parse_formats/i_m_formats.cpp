@@ -62,6 +62,35 @@ bool Parser::parse_O_GPR_C_GPR_C_GPR() {
   return false;
 }
 
+bool Parser::parse_O_GPR_C_GPR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::GP_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::GP_REGISTER
+      && (peekToken(4).type==TokenType::EOF_ || peekToken(4).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+
+    std::string reg;
+    reg = reg_alias_to_name.at(peekToken(1).value);
+    block.setRd(reg);
+    reg = reg_alias_to_name.at(peekToken(3).value);
+    block.setRs1(reg);
+
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
 bool Parser::parse_O_GPR_C_GPR_C_I() {
   if (peekToken(1).line_number==currentToken().line_number
       && peekToken(1).type==TokenType::GP_REGISTER
@@ -89,7 +118,9 @@ bool Parser::parse_O_GPR_C_GPR_C_I() {
       int64_t imm = std::stoll(peekToken(5).value);
 
       if (instruction_set::isValidI2TypeInstruction(block.getOpcode())) {
-        if (0 <= imm && imm <= 31) {
+        // RV64 shifts and rotates take a 6-bit amount, their word forms a 5-bit one
+        const int64_t max_shamt = instruction_set::isValidI2WordTypeInstruction(block.getOpcode()) ? 31 : 63;
+        if (0 <= imm && imm <= max_shamt) {
           block.setImm(std::to_string(imm));
         } else {
           errors_.count++;
@@ -97,7 +128,7 @@ bool Parser::parse_O_GPR_C_GPR_C_I() {
           errors_.all_errors.emplace_back(
             errors::ImmediateOutOfRangeError(
               "Immediate value out of range",
-              "Expected: 0 <= imm <= 31",
+              "Expected: 0 <= imm <= " + std::to_string(max_shamt),
               filename_,
               peekToken(5).line_number,
               peekToken(5).column_number,
@@ -262,6 +262,27 @@ bool Parser::parse_pseudo() {
     }
     return false;
   }
+
+  // rdcycle, rdtime, rdinstret
+  else if (currentToken().value=="rdcycle" || currentToken().value=="rdtime" || currentToken().value=="rdinstret") {
+    if (peekToken(1).line_number==currentToken().line_number
+        && peekToken(1).type==TokenType::GP_REGISTER
+        && (peekToken(2).type==TokenType::EOF_ || peekToken(2).line_number!=currentToken().line_number)) {
+      ICUnit block;
+      block.setOpcode("csrrs");
+      block.setLineNumber(currentToken().line_number);
+      block.setInstructionIndex(instruction_index_);
+      block.setRd(reg_alias_to_name.at(peekToken(1).value));
+      block.setRs1("x0");
+      block.setCsr(csr_to_address.at(currentToken().value.substr(2)));
+      intermediate_code_.emplace_back(block, true);
+      instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+      instruction_index_++;
+      skipCurrentLine();
+      return true;
+    }
+    return false;
+  }
   return false;
 }
 
@@ -0,0 +1,482 @@
+/**
+ * @file v_formats.cpp
+ * @brief Parsing of the vector instruction formats
+ */
+
+#include "assembler/parser.h"
+#include "common/instructions.h"
+#include "common/vtype_fields.h"
+#include "vm/registers.h"
+#include "utils.h"
+
+#include <string>
+
+// Register fields of a vector instruction in the ICUnit: rd is vd (vs3 of the stores) or the rd of vset{i}vl{i}, rs1
+// and rs2 are the fields at bits 19:15 and 24:20 whatever register file they name, imm is simm5 or the vtype.
+
+// vtype of the fields written after the operands of vset{i}vli, in the order SEW, LMUL, tail policy, mask policy; only SEW is
+// required, the others default to m1, tu, mu. Returns -1 if the fields are malformed.
+static int64_t parseVType(const std::vector<Token> &fields) {
+  if (fields.empty()) {
+    return -1;
+  }
+  int64_t vtype = 0;
+  int next = 0;
+  for (const Token &token : fields) {
+    const VTypeFieldEncoding &encoding = stringToVTypeField.at(token.value);
+    int position = static_cast<int>(encoding.field);
+    if (position < next || (next == 0 && encoding.field != VTypeField::SEW)) {
+      return -1;
+    }
+    vtype |= encoding.bits;
+    next = position + 1;
+  }
+  return vtype;
+}
+
+bool Parser::parse_O_GPR_C_GPR_C_VTYPE() {
+  // vsetvli rd, rs1, e32, m1, ta, ma
+  if (!(peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::GP_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::GP_REGISTER)) {
+    return false;
+  }
+  std::vector<Token> fields;
+  int n = 4;
+  while (peekToken(n).type==TokenType::COMMA && peekToken(n).line_number==currentToken().line_number
+      && peekToken(n + 1).type==TokenType::VTYPE && peekToken(n + 1).line_number==currentToken().line_number) {
+    fields.push_back(peekToken(n + 1));
+    n += 2;
+  }
+  int64_t vtype = parseVType(fields);
+  if (vtype < 0 || (peekToken(n).type!=TokenType::EOF_ && peekToken(n).line_number==currentToken().line_number)) {
+    return false;
+  }
+  ICUnit block;
+  block.setOpcode(currentToken().value);
+  block.setLineNumber(currentToken().line_number);
+  block.setInstructionIndex(instruction_index_);
+  block.setRd(reg_alias_to_name.at(peekToken(1).value));
+  block.setRs1(reg_alias_to_name.at(peekToken(3).value));
+  block.setImm(std::to_string(vtype));
+  skipCurrentLine();
+  intermediate_code_.emplace_back(block, true);
+  instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+  instruction_index_++;
+  return true;
+}
+
+bool Parser::parse_O_GPR_C_I_C_VTYPE() {
+  // vsetivli rd, uimm, e32, m1, ta, ma; the avl is kept in the low 5 bits of imm, under the vtype
+  if (!(peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::GP_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::NUM)) {
+    return false;
+  }
+  std::vector<Token> fields;
+  int n = 4;
+  while (peekToken(n).type==TokenType::COMMA && peekToken(n).line_number==currentToken().line_number
+      && peekToken(n + 1).type==TokenType::VTYPE && peekToken(n + 1).line_number==currentToken().line_number) {
+    fields.push_back(peekToken(n + 1));
+    n += 2;
+  }
+  int64_t vtype = parseVType(fields);
+  if (vtype < 0 || (peekToken(n).type!=TokenType::EOF_ && peekToken(n).line_number==currentToken().line_number)) {
+    return false;
+  }
+  ICUnit block;
+  block.setOpcode(currentToken().value);
+  block.setLineNumber(currentToken().line_number);
+  block.setInstructionIndex(instruction_index_);
+  block.setRd(reg_alias_to_name.at(peekToken(1).value));
+  int64_t avl = std::stoll(peekToken(3).value);
+  if (avl < 0 || avl > 31) {
+    errors_.count++;
+    recordError(ParseError(peekToken(3).line_number, "Immediate value out of range"));
+    errors_.all_errors.emplace_back(errors::ImmediateOutOfRangeError("Immediate value out of range",
+                                                                     "Expected: 0 <= imm <= 31",
+                                                                     filename_,
+                                                                     peekToken(3).line_number,
+                                                                     peekToken(3).column_number,
+                                                                     GetLineFromFile(filename_,
+                                                                                     peekToken(3).line_number)));
+    skipCurrentLine();
+    return true;
+  }
+  block.setImm(std::to_string(vtype << 5 | avl));
+  skipCurrentLine();
+  intermediate_code_.emplace_back(block, true);
+  instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+  instruction_index_++;
+  return true;
+}
+
+bool Parser::parse_O_VR_C_LP_GPR_RP() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::LPAREN
+      && peekToken(4).line_number==currentToken().line_number
+      && peekToken(4).type==TokenType::GP_REGISTER
+      && peekToken(5).line_number==currentToken().line_number
+      && peekToken(5).type==TokenType::RPAREN
+      && (peekToken(6).type==TokenType::EOF_ || peekToken(6).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs1(reg_alias_to_name.at(peekToken(4).value));
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_LP_GPR_RP_C_GPR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::LPAREN
+      && peekToken(4).line_number==currentToken().line_number
+      && peekToken(4).type==TokenType::GP_REGISTER
+      && peekToken(5).line_number==currentToken().line_number
+      && peekToken(5).type==TokenType::RPAREN
+      && peekToken(6).line_number==currentToken().line_number
+      && peekToken(6).type==TokenType::COMMA
+      && peekToken(7).line_number==currentToken().line_number
+      && peekToken(7).type==TokenType::GP_REGISTER
+      && (peekToken(8).type==TokenType::EOF_ || peekToken(8).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs1(reg_alias_to_name.at(peekToken(4).value));
+    block.setRs2(reg_alias_to_name.at(peekToken(7).value));
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_VR_C_VR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::VEC_REGISTER
+      && peekToken(4).line_number==currentToken().line_number
+      && peekToken(4).type==TokenType::COMMA
+      && peekToken(5).line_number==currentToken().line_number
+      && peekToken(5).type==TokenType::VEC_REGISTER
+      && (peekToken(6).type==TokenType::EOF_ || peekToken(6).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    if (block.getOpcode()=="vmacc.vv" || block.getOpcode()=="vfmacc.vv") {     // vd, vs1, vs2
+      block.setRs1(peekToken(3).value);
+      block.setRs2(peekToken(5).value);
+    } else {                                                                    // vd, vs2, vs1
+      block.setRs2(peekToken(3).value);
+      block.setRs1(peekToken(5).value);
+    }
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_VR_C_GPR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::VEC_REGISTER
+      && peekToken(4).line_number==currentToken().line_number
+      && peekToken(4).type==TokenType::COMMA
+      && peekToken(5).line_number==currentToken().line_number
+      && peekToken(5).type==TokenType::GP_REGISTER
+      && (peekToken(6).type==TokenType::EOF_ || peekToken(6).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs2(peekToken(3).value);
+    block.setRs1(reg_alias_to_name.at(peekToken(5).value));
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_VR_C_FPR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::VEC_REGISTER
+      && peekToken(4).line_number==currentToken().line_number
+      && peekToken(4).type==TokenType::COMMA
+      && peekToken(5).line_number==currentToken().line_number
+      && peekToken(5).type==TokenType::FP_REGISTER
+      && (peekToken(6).type==TokenType::EOF_ || peekToken(6).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs2(peekToken(3).value);
+    block.setRs1(reg_alias_to_name.at(peekToken(5).value));
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_VR_C_I() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::VEC_REGISTER
+      && peekToken(4).line_number==currentToken().line_number
+      && peekToken(4).type==TokenType::COMMA
+      && peekToken(5).line_number==currentToken().line_number
+      && peekToken(5).type==TokenType::NUM
+      && (peekToken(6).type==TokenType::EOF_ || peekToken(6).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs2(peekToken(3).value);
+    int64_t imm = std::stoll(peekToken(5).value);
+    if (imm < -16 || imm > 15) {
+      errors_.count++;
+      recordError(ParseError(peekToken(5).line_number, "Immediate value out of range"));
+      errors_.all_errors.emplace_back(errors::ImmediateOutOfRangeError("Immediate value out of range",
+                                                                       "Expected: -16 <= imm <= 15",
+                                                                       filename_,
+                                                                       peekToken(5).line_number,
+                                                                       peekToken(5).column_number,
+                                                                       GetLineFromFile(filename_,
+                                                                                       peekToken(5).line_number)));
+      skipCurrentLine();
+      return true;
+    }
+    block.setImm(std::to_string(imm));
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_GPR_C_VR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::GP_REGISTER
+      && peekToken(4).line_number==currentToken().line_number
+      && peekToken(4).type==TokenType::COMMA
+      && peekToken(5).line_number==currentToken().line_number
+      && peekToken(5).type==TokenType::VEC_REGISTER
+      && (peekToken(6).type==TokenType::EOF_ || peekToken(6).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs1(reg_alias_to_name.at(peekToken(3).value));
+    block.setRs2(peekToken(5).value);
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_FPR_C_VR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::FP_REGISTER
+      && peekToken(4).line_number==currentToken().line_number
+      && peekToken(4).type==TokenType::COMMA
+      && peekToken(5).line_number==currentToken().line_number
+      && peekToken(5).type==TokenType::VEC_REGISTER
+      && (peekToken(6).type==TokenType::EOF_ || peekToken(6).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs1(reg_alias_to_name.at(peekToken(3).value));
+    block.setRs2(peekToken(5).value);
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_VR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::VEC_REGISTER
+      && (peekToken(4).type==TokenType::EOF_ || peekToken(4).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs1(peekToken(3).value);
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_GPR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::GP_REGISTER
+      && (peekToken(4).type==TokenType::EOF_ || peekToken(4).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs1(reg_alias_to_name.at(peekToken(3).value));
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_FPR() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::FP_REGISTER
+      && (peekToken(4).type==TokenType::EOF_ || peekToken(4).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    block.setRs1(reg_alias_to_name.at(peekToken(3).value));
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
+
+bool Parser::parse_O_VR_C_I() {
+  if (peekToken(1).line_number==currentToken().line_number
+      && peekToken(1).type==TokenType::VEC_REGISTER
+      && peekToken(2).line_number==currentToken().line_number
+      && peekToken(2).type==TokenType::COMMA
+      && peekToken(3).line_number==currentToken().line_number
+      && peekToken(3).type==TokenType::NUM
+      && (peekToken(4).type==TokenType::EOF_ || peekToken(4).line_number!=currentToken().line_number)
+      ) {
+    ICUnit block;
+    block.setOpcode(currentToken().value);
+    block.setLineNumber(currentToken().line_number);
+    block.setInstructionIndex(instruction_index_);
+    block.setRd(peekToken(1).value);
+    int64_t imm = std::stoll(peekToken(3).value);
+    if (imm < -16 || imm > 15) {
+      errors_.count++;
+      recordError(ParseError(peekToken(3).line_number, "Immediate value out of range"));
+      errors_.all_errors.emplace_back(errors::ImmediateOutOfRangeError("Immediate value out of range",
+                                                                       "Expected: -16 <= imm <= 15",
+                                                                       filename_,
+                                                                       peekToken(3).line_number,
+                                                                       peekToken(3).column_number,
+                                                                       GetLineFromFile(filename_,
+                                                                                       peekToken(3).line_number)));
+      skipCurrentLine();
+      return true;
+    }
+    block.setImm(std::to_string(imm));
+    skipCurrentLine();
+    intermediate_code_.emplace_back(block, true);
+    instruction_number_line_number_mapping_[instruction_index_] = block.getLineNumber();
+    instruction_index_++;
+    return true;
+  }
+  return false;
+}
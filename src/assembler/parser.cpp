@@ -315,6 +315,54 @@ void Parser::parseTextDirective() {
         skipCurrentLine();
         continue;
       }
+      else if (instruction_set::isValidZbaExtensionInstruction(currentToken().value) && vm_config::config.getZbaExtensionEnabled() == false) {
+        errors_.count++;
+        recordError(ParseError(currentToken().line_number, "Unexpected opcode, Zba extension is disabled: " + currentToken().value));
+        errors_.all_errors.emplace_back(errors::UnexpectedTokenError("Unexpected opcode, Zba extension is disabled",
+                                                                   filename_,
+                                                                   currentToken().line_number,
+                                                                   currentToken().column_number,
+                                                                   GetLineFromFile(filename_,
+                                                                                   currentToken().line_number)));
+        skipCurrentLine();
+        continue;
+      }
+      else if (instruction_set::isValidZbbExtensionInstruction(currentToken().value) && vm_config::config.getZbbExtensionEnabled() == false) {
+        errors_.count++;
+        recordError(ParseError(currentToken().line_number, "Unexpected opcode, Zbb extension is disabled: " + currentToken().value));
+        errors_.all_errors.emplace_back(errors::UnexpectedTokenError("Unexpected opcode, Zbb extension is disabled",
+                                                                   filename_,
+                                                                   currentToken().line_number,
+                                                                   currentToken().column_number,
+                                                                   GetLineFromFile(filename_,
+                                                                                   currentToken().line_number)));
+        skipCurrentLine();
+        continue;
+      }
+      else if (instruction_set::isValidAExtensionInstruction(currentToken().value) && vm_config::config.getAExtensionEnabled() == false) {
+        errors_.count++;
+        recordError(ParseError(currentToken().line_number, "Unexpected opcode, A extension is disabled: " + currentToken().value));
+        errors_.all_errors.emplace_back(errors::UnexpectedTokenError("Unexpected opcode, A extension is disabled",
+                                                                   filename_,
+                                                                   currentToken().line_number,
+                                                                   currentToken().column_number,
+                                                                   GetLineFromFile(filename_,
+                                                                                   currentToken().line_number)));
+        skipCurrentLine();
+        continue;
+      }
+      else if (instruction_set::isValidVExtensionInstruction(currentToken().value) && vm_config::config.getVExtensionEnabled() == false) {
+        errors_.count++;
+        recordError(ParseError(currentToken().line_number, "Unexpected opcode, V extension is disabled: " + currentToken().value));
+        errors_.all_errors.emplace_back(errors::UnexpectedTokenError("Unexpected opcode, V extension is disabled",
+                                                                   filename_,
+                                                                   currentToken().line_number,
+                                                                   currentToken().column_number,
+                                                                   GetLineFromFile(filename_,
+                                                                                   currentToken().line_number)));
+        skipCurrentLine();
+        continue;
+      }
 
       std::vector<instruction_set::SyntaxType>
           syntaxes = instruction_set::instruction_syntax_map[currentToken().value];
@@ -348,6 +396,11 @@ void Parser::parseTextDirective() {
             break;
           }
 
+          case instruction_set::SyntaxType::O_GPR_C_GPR: {
+            valid_syntax = parse_O_GPR_C_GPR();
+            break;
+          }
+
           case instruction_set::SyntaxType::O_GPR_C_IL: {
             valid_syntax = parse_O_GPR_C_IL();
             break;
@@ -442,6 +495,86 @@ void Parser::parseTextDirective() {
             break;
           }
 
+          case instruction_set::SyntaxType::O_GPR_C_GPR_C_VTYPE: {
+            valid_syntax = parse_O_GPR_C_GPR_C_VTYPE();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_GPR_C_I_C_VTYPE: {
+            valid_syntax = parse_O_GPR_C_I_C_VTYPE();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_LP_GPR_RP: {
+            valid_syntax = parse_O_VR_C_LP_GPR_RP();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_LP_GPR_RP_C_GPR: {
+            valid_syntax = parse_O_VR_C_LP_GPR_RP_C_GPR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_VR_C_VR: {
+            valid_syntax = parse_O_VR_C_VR_C_VR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_VR_C_GPR: {
+            valid_syntax = parse_O_VR_C_VR_C_GPR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_VR_C_FPR: {
+            valid_syntax = parse_O_VR_C_VR_C_FPR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_VR_C_I: {
+            valid_syntax = parse_O_VR_C_VR_C_I();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_GPR_C_VR: {
+            valid_syntax = parse_O_VR_C_GPR_C_VR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_FPR_C_VR: {
+            valid_syntax = parse_O_VR_C_FPR_C_VR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_VR: {
+            valid_syntax = parse_O_VR_C_VR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_GPR: {
+            valid_syntax = parse_O_VR_C_GPR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_FPR: {
+            valid_syntax = parse_O_VR_C_FPR();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_VR_C_I: {
+            valid_syntax = parse_O_VR_C_I();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_GPR_C_LP_GPR_RP: {
+            valid_syntax = parse_O_GPR_C_LP_GPR_RP();
+            break;
+          }
+
+          case instruction_set::SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP: {
+            valid_syntax = parse_O_GPR_C_GPR_C_LP_GPR_RP();
+            break;
+          }
+
           default: {
             break;
           }
@@ -40,6 +40,7 @@ std::string tokenTypeToString(TokenType type) {
     case TokenType::RPAREN:return "RPAREN      ";
     case TokenType::STRING:return "STRING      ";
     case TokenType::RM:return "RM          ";
+    case TokenType::VTYPE:return "VTYPE       ";
     default:return "UNKNOWN     ";
   }
 }
\ No newline at end of file
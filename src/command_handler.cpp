@@ -32,6 +32,8 @@ Command ParseCommand(const std::string &input) {
     command_type = command_handler::CommandType::UNDO;
   } else if (command_str=="redo" || command_str=="r") {
     command_type = command_handler::CommandType::REDO;
+  } else if (command_str=="seek") {
+    command_type = command_handler::CommandType::SEEK;
   } else if (command_str=="reset") {
     command_type = command_handler::CommandType::RESET;
   } else if (command_str=="modify_register" || command_str=="mreg") {
@@ -52,6 +54,14 @@ Command ParseCommand(const std::string &input) {
     command_type = command_handler::CommandType::GET_MEMORY_POINT;
   } else if (command_str=="dump_cache") {
     command_type = command_handler::CommandType::DUMP_CACHE;
+  } else if (command_str=="dump_branch_profile" || command_str=="dbp") {
+    command_type = command_handler::CommandType::DUMP_BRANCH_PROFILE;
+  } else if (command_str=="save_state") {
+    command_type = command_handler::CommandType::SAVE_STATE;
+  } else if (command_str=="load_state") {
+    command_type = command_handler::CommandType::LOAD_STATE;
+  } else if (command_str=="fork_run") {
+    command_type = command_handler::CommandType::FORK_RUN;
   } else if (command_str=="add_breakpoint") {
     command_type = command_handler::CommandType::ADD_BREAKPOINT;
   } else if (command_str=="remove_breakpoint") {
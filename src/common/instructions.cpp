@@ -53,6 +53,40 @@ std::unordered_map<std::string, Instruction> instruction_string_map = {
     {"remw", Instruction::kremw},
     {"remuw", Instruction::kremuw},
 
+    {"sh1add", Instruction::ksh1add},
+    {"sh2add", Instruction::ksh2add},
+    {"sh3add", Instruction::ksh3add},
+    {"add.uw", Instruction::kadd_uw},
+    {"sh1add.uw", Instruction::ksh1add_uw},
+    {"sh2add.uw", Instruction::ksh2add_uw},
+    {"sh3add.uw", Instruction::ksh3add_uw},
+    {"slli.uw", Instruction::kslli_uw},
+
+    {"andn", Instruction::kandn},
+    {"orn", Instruction::korn},
+    {"xnor", Instruction::kxnor},
+    {"clz", Instruction::kclz},
+    {"ctz", Instruction::kctz},
+    {"cpop", Instruction::kcpop},
+    {"clzw", Instruction::kclzw},
+    {"ctzw", Instruction::kctzw},
+    {"cpopw", Instruction::kcpopw},
+    {"max", Instruction::kmax},
+    {"maxu", Instruction::kmaxu},
+    {"min", Instruction::kmin},
+    {"minu", Instruction::kminu},
+    {"sext.b", Instruction::ksext_b},
+    {"sext.h", Instruction::ksext_h},
+    {"zext.h", Instruction::kzext_h},
+    {"rol", Instruction::krol},
+    {"ror", Instruction::kror},
+    {"rori", Instruction::krori},
+    {"rolw", Instruction::krolw},
+    {"rorw", Instruction::krorw},
+    {"roriw", Instruction::kroriw},
+    {"orc.b", Instruction::korc_b},
+    {"rev8", Instruction::krev8},
+
     {"addi", Instruction::kaddi},
     {"xori", Instruction::kxori},
     {"ori", Instruction::kori},
@@ -173,7 +207,74 @@ std::unordered_map<std::string, Instruction> instruction_string_map = {
     {"flw", Instruction::kflw},
     {"fsw", Instruction::kfsw},
     {"fld", Instruction::kfld},
-    {"fsd", Instruction::kfsd}
+    {"fsd", Instruction::kfsd},
+
+    {"vsetvli", Instruction::kvsetvli},
+    {"vsetivli", Instruction::kvsetivli},
+    {"vsetvl", Instruction::kvsetvl},
+    {"vle8.v", Instruction::kvle8_v},
+    {"vle16.v", Instruction::kvle16_v},
+    {"vle32.v", Instruction::kvle32_v},
+    {"vle64.v", Instruction::kvle64_v},
+    {"vse8.v", Instruction::kvse8_v},
+    {"vse16.v", Instruction::kvse16_v},
+    {"vse32.v", Instruction::kvse32_v},
+    {"vse64.v", Instruction::kvse64_v},
+    {"vlse8.v", Instruction::kvlse8_v},
+    {"vlse16.v", Instruction::kvlse16_v},
+    {"vlse32.v", Instruction::kvlse32_v},
+    {"vlse64.v", Instruction::kvlse64_v},
+    {"vsse8.v", Instruction::kvsse8_v},
+    {"vsse16.v", Instruction::kvsse16_v},
+    {"vsse32.v", Instruction::kvsse32_v},
+    {"vsse64.v", Instruction::kvsse64_v},
+    {"vadd.vv", Instruction::kvadd_vv},
+    {"vadd.vx", Instruction::kvadd_vx},
+    {"vadd.vi", Instruction::kvadd_vi},
+    {"vsub.vv", Instruction::kvsub_vv},
+    {"vsub.vx", Instruction::kvsub_vx},
+    {"vmul.vv", Instruction::kvmul_vv},
+    {"vmul.vx", Instruction::kvmul_vx},
+    {"vmacc.vv", Instruction::kvmacc_vv},
+    {"vmacc.vx", Instruction::kvmacc_vx},
+    {"vredsum.vs", Instruction::kvredsum_vs},
+    {"vmv.v.v", Instruction::kvmv_v_v},
+    {"vmv.v.x", Instruction::kvmv_v_x},
+    {"vmv.v.i", Instruction::kvmv_v_i},
+    {"vfadd.vv", Instruction::kvfadd_vv},
+    {"vfadd.vf", Instruction::kvfadd_vf},
+    {"vfsub.vv", Instruction::kvfsub_vv},
+    {"vfsub.vf", Instruction::kvfsub_vf},
+    {"vfmul.vv", Instruction::kvfmul_vv},
+    {"vfmul.vf", Instruction::kvfmul_vf},
+    {"vfmacc.vv", Instruction::kvfmacc_vv},
+    {"vfmacc.vf", Instruction::kvfmacc_vf},
+    {"vfredusum.vs", Instruction::kvfredusum_vs},
+    {"vfredosum.vs", Instruction::kvfredosum_vs},
+    {"vfmv.v.f", Instruction::kvfmv_v_f},
+
+    {"lr.w", Instruction::klr_w},
+    {"sc.w", Instruction::ksc_w},
+    {"amoswap.w", Instruction::kamoswap_w},
+    {"amoadd.w", Instruction::kamoadd_w},
+    {"amoxor.w", Instruction::kamoxor_w},
+    {"amoand.w", Instruction::kamoand_w},
+    {"amoor.w", Instruction::kamoor_w},
+    {"amomin.w", Instruction::kamomin_w},
+    {"amomax.w", Instruction::kamomax_w},
+    {"amominu.w", Instruction::kamominu_w},
+    {"amomaxu.w", Instruction::kamomaxu_w},
+    {"lr.d", Instruction::klr_d},
+    {"sc.d", Instruction::ksc_d},
+    {"amoswap.d", Instruction::kamoswap_d},
+    {"amoadd.d", Instruction::kamoadd_d},
+    {"amoxor.d", Instruction::kamoxor_d},
+    {"amoand.d", Instruction::kamoand_d},
+    {"amoor.d", Instruction::kamoor_d},
+    {"amomin.d", Instruction::kamomin_d},
+    {"amomax.d", Instruction::kamomax_d},
+    {"amominu.d", Instruction::kamominu_d},
+    {"amomaxu.d", Instruction::kamomaxu_d},
 
 };
 
@@ -197,10 +298,17 @@ static const std::unordered_set<std::string> valid_instructions = {
     "beqz", "bnez", "blez", "bgez", "bltz", "bgtz",
     "bgt", "ble", "bgtu", "bleu",
     "j", "jr", "ret", "call", "tail", "fence", "fence_i",
+    "rdcycle", "rdtime", "rdinstret",
 
     "mul", "mulh", "mulhsu", "mulhu", "div", "divu", "rem", "remu",
     "mulw", "divw", "divuw", "remw", "remuw",
 
+    // Zba, Zbb
+    "sh1add", "sh2add", "sh3add", "add.uw", "sh1add.uw", "sh2add.uw", "sh3add.uw", "slli.uw",
+    "andn", "orn", "xnor", "clz", "ctz", "cpop", "clzw", "ctzw", "cpopw",
+    "max", "maxu", "min", "minu", "sext.b", "sext.h", "zext.h",
+    "rol", "ror", "rori", "rolw", "rorw", "roriw", "orc.b", "rev8",
+
     // RV64F
     "flw", "fsw", "fmadd.s", "fmsub.s", "fnmsub.s", "fnmadd.s",
     "fadd.s", "fsub.s", "fmul.s", "fdiv.s", "fsqrt.s",
@@ -219,7 +327,40 @@ static const std::unordered_set<std::string> valid_instructions = {
     "fcvt.s.d", "fcvt.d.s",
     "feq.d", "flt.d", "fle.d",
     "fclass.d", "fcvt.w.d", "fcvt.wu.d", "fcvt.d.w", "fcvt.d.wu",
-    "fcvt.l.d", "fcvt.lu.d", "fmv.x.d", "fcvt.d.l", "fcvt.d.lu", "fmv.d.x"
+    "fcvt.l.d", "fcvt.lu.d", "fmv.x.d", "fcvt.d.l", "fcvt.d.lu", "fmv.d.x",
+
+    // RVV subset
+    "vsetvli", "vsetivli", "vsetvl",
+    "vle8.v", "vle16.v", "vle32.v", "vle64.v", "vse8.v", "vse16.v", "vse32.v", "vse64.v",
+    "vlse8.v", "vlse16.v", "vlse32.v", "vlse64.v", "vsse8.v", "vsse16.v", "vsse32.v", "vsse64.v",
+    "vadd.vv", "vadd.vx", "vadd.vi", "vsub.vv", "vsub.vx", "vmul.vv", "vmul.vx", "vmacc.vv", "vmacc.vx",
+    "vredsum.vs", "vmv.v.v", "vmv.v.x", "vmv.v.i",
+    "vfadd.vv", "vfadd.vf", "vfsub.vv", "vfsub.vf", "vfmul.vv", "vfmul.vf", "vfmacc.vv", "vfmacc.vf",
+    "vfredusum.vs", "vfredosum.vs", "vfmv.v.f",
+
+    // RV64A, .aq / .rl / .aqrl set the ordering bits
+    "lr.w", "lr.w.aq", "lr.w.rl", "lr.w.aqrl",
+    "sc.w", "sc.w.aq", "sc.w.rl", "sc.w.aqrl",
+    "amoswap.w", "amoswap.w.aq", "amoswap.w.rl", "amoswap.w.aqrl",
+    "amoadd.w", "amoadd.w.aq", "amoadd.w.rl", "amoadd.w.aqrl",
+    "amoxor.w", "amoxor.w.aq", "amoxor.w.rl", "amoxor.w.aqrl",
+    "amoand.w", "amoand.w.aq", "amoand.w.rl", "amoand.w.aqrl",
+    "amoor.w", "amoor.w.aq", "amoor.w.rl", "amoor.w.aqrl",
+    "amomin.w", "amomin.w.aq", "amomin.w.rl", "amomin.w.aqrl",
+    "amomax.w", "amomax.w.aq", "amomax.w.rl", "amomax.w.aqrl",
+    "amominu.w", "amominu.w.aq", "amominu.w.rl", "amominu.w.aqrl",
+    "amomaxu.w", "amomaxu.w.aq", "amomaxu.w.rl", "amomaxu.w.aqrl",
+    "lr.d", "lr.d.aq", "lr.d.rl", "lr.d.aqrl",
+    "sc.d", "sc.d.aq", "sc.d.rl", "sc.d.aqrl",
+    "amoswap.d", "amoswap.d.aq", "amoswap.d.rl", "amoswap.d.aqrl",
+    "amoadd.d", "amoadd.d.aq", "amoadd.d.rl", "amoadd.d.aqrl",
+    "amoxor.d", "amoxor.d.aq", "amoxor.d.rl", "amoxor.d.aqrl",
+    "amoand.d", "amoand.d.aq", "amoand.d.rl", "amoand.d.aqrl",
+    "amoor.d", "amoor.d.aq", "amoor.d.rl", "amoor.d.aqrl",
+    "amomin.d", "amomin.d.aq", "amomin.d.rl", "amomin.d.aqrl",
+    "amomax.d", "amomax.d.aq", "amomax.d.rl", "amomax.d.aqrl",
+    "amominu.d", "amominu.d.aq", "amominu.d.rl", "amominu.d.aqrl",
+    "amomaxu.d", "amomaxu.d.aq", "amomaxu.d.rl", "amomaxu.d.aqrl",
 
 };
 
@@ -236,11 +377,22 @@ static const std::unordered_set<std::string> RTypeInstructions = {
     // M Extension RV64
     "mulw", "divw", "divuw", "remw", "remuw",
 
+    // Zba, Zbb
+    "sh1add", "sh2add", "sh3add", "add.uw", "sh1add.uw", "sh2add.uw", "sh3add.uw",
+    "andn", "orn", "xnor", "max", "maxu", "min", "minu",
+    "rol", "ror", "rolw", "rorw",
+
+};
+
+static const std::unordered_set<std::string> R2TypeInstructions = {
+    "clz", "ctz", "cpop", "clzw", "ctzw", "cpopw",
+    "sext.b", "sext.h", "zext.h", "orc.b", "rev8",
 };
 
 static const std::unordered_set<std::string> ITypeInstructions = {
     "addi", "xori", "ori", "andi", "slli", "srli", "srai", "slti", "sltiu",
     "addiw", "slliw", "srliw", "sraiw",
+    "slli.uw", "rori", "roriw",
     "lb", "lh", "lw", "ld", "lbu", "lhu", "lwu",
     "jalr"
 };
@@ -254,7 +406,14 @@ static const std::unordered_set<std::string> I1TypeInstructions = {
 
 static const std::unordered_set<std::string> I2TypeInstructions = {
     "slli", "srli", "srai",
-    "slliw", "srliw", "sraiw"
+    "slliw", "srliw", "sraiw",
+    "slli.uw", "rori", "roriw",
+};
+
+// 5-bit shift amount, the others take 6 bits on RV64
+static const std::unordered_set<std::string> I2WordTypeInstructions = {
+    "slliw", "srliw", "sraiw",
+    "roriw",
 };
 
 static const std::unordered_set<std::string> I3TypeInstructions = {
@@ -283,6 +442,7 @@ static const std::unordered_set<std::string> PseudoInstructions = {
     "beqz", "bnez", "blez", "bgez", "bltz", "bgtz",
     "bgt", "ble", "bgtu", "bleu",
     "j", "jr", "ret", "call", "tail", "fence", "fence_i",
+    "rdcycle", "rdtime", "rdinstret",
 };
 
 static const std::unordered_set<std::string> BaseExtensionInstructions = {
@@ -315,6 +475,51 @@ static const std::unordered_set<std::string> MExtensionInstructions = {
     "mulw", "divw", "divuw", "remw", "remuw",
 };
 
+static const std::unordered_set<std::string> ZbaExtensionInstructions = {
+    "sh1add", "sh2add", "sh3add", "add.uw", "sh1add.uw", "sh2add.uw", "sh3add.uw", "slli.uw",
+};
+
+static const std::unordered_set<std::string> ZbbExtensionInstructions = {
+    "andn", "orn", "xnor", "clz", "ctz", "cpop", "clzw", "ctzw", "cpopw",
+    "max", "maxu", "min", "minu", "sext.b", "sext.h", "zext.h",
+    "rol", "ror", "rori", "rolw", "rorw", "roriw", "orc.b", "rev8",
+};
+
+static const std::unordered_set<std::string> VExtensionInstructions = {
+    "vsetvli", "vsetivli", "vsetvl",
+    "vle8.v", "vle16.v", "vle32.v", "vle64.v", "vse8.v", "vse16.v", "vse32.v", "vse64.v",
+    "vlse8.v", "vlse16.v", "vlse32.v", "vlse64.v", "vsse8.v", "vsse16.v", "vsse32.v", "vsse64.v",
+    "vadd.vv", "vadd.vx", "vadd.vi", "vsub.vv", "vsub.vx", "vmul.vv", "vmul.vx", "vmacc.vv", "vmacc.vx",
+    "vredsum.vs", "vmv.v.v", "vmv.v.x", "vmv.v.i",
+    "vfadd.vv", "vfadd.vf", "vfsub.vv", "vfsub.vf", "vfmul.vv", "vfmul.vf", "vfmacc.vv", "vfmacc.vf",
+    "vfredusum.vs", "vfredosum.vs", "vfmv.v.f",
+};
+
+static const std::unordered_set<std::string> AExtensionInstructions = {
+    "lr.w", "lr.w.aq", "lr.w.rl", "lr.w.aqrl",
+    "sc.w", "sc.w.aq", "sc.w.rl", "sc.w.aqrl",
+    "amoswap.w", "amoswap.w.aq", "amoswap.w.rl", "amoswap.w.aqrl",
+    "amoadd.w", "amoadd.w.aq", "amoadd.w.rl", "amoadd.w.aqrl",
+    "amoxor.w", "amoxor.w.aq", "amoxor.w.rl", "amoxor.w.aqrl",
+    "amoand.w", "amoand.w.aq", "amoand.w.rl", "amoand.w.aqrl",
+    "amoor.w", "amoor.w.aq", "amoor.w.rl", "amoor.w.aqrl",
+    "amomin.w", "amomin.w.aq", "amomin.w.rl", "amomin.w.aqrl",
+    "amomax.w", "amomax.w.aq", "amomax.w.rl", "amomax.w.aqrl",
+    "amominu.w", "amominu.w.aq", "amominu.w.rl", "amominu.w.aqrl",
+    "amomaxu.w", "amomaxu.w.aq", "amomaxu.w.rl", "amomaxu.w.aqrl",
+    "lr.d", "lr.d.aq", "lr.d.rl", "lr.d.aqrl",
+    "sc.d", "sc.d.aq", "sc.d.rl", "sc.d.aqrl",
+    "amoswap.d", "amoswap.d.aq", "amoswap.d.rl", "amoswap.d.aqrl",
+    "amoadd.d", "amoadd.d.aq", "amoadd.d.rl", "amoadd.d.aqrl",
+    "amoxor.d", "amoxor.d.aq", "amoxor.d.rl", "amoxor.d.aqrl",
+    "amoand.d", "amoand.d.aq", "amoand.d.rl", "amoand.d.aqrl",
+    "amoor.d", "amoor.d.aq", "amoor.d.rl", "amoor.d.aqrl",
+    "amomin.d", "amomin.d.aq", "amomin.d.rl", "amomin.d.aqrl",
+    "amomax.d", "amomax.d.aq", "amomax.d.rl", "amomax.d.aqrl",
+    "amominu.d", "amominu.d.aq", "amominu.d.rl", "amominu.d.aqrl",
+    "amomaxu.d", "amomaxu.d.aq", "amomaxu.d.rl", "amomaxu.d.aqrl",
+};
+
 // Added set for f and d type instructions
 const std::unordered_set<std::string> FExtensionInstructions = {
     "flw", "fsw", "fmadd.s", "fmsub.s", "fnmsub.s", "fnmadd.s", "fadd.s",
@@ -415,6 +620,41 @@ std::unordered_map<std::string, RTypeInstructionEncoding> R_type_instruction_enc
     {"remw", {0b0111011, 0b110, 0b0000001}}, // O_GPR_C_GPR_C_GPR
     {"remuw", {0b0111011, 0b111, 0b0000001}}, // O_GPR_C_GPR_C_GPR
 
+//==Zba, Zbb=================================================================================
+    {"sh1add", {0b0110011, 0b010, 0b0010000}}, // O_GPR_C_GPR_C_GPR
+    {"sh2add", {0b0110011, 0b100, 0b0010000}}, // O_GPR_C_GPR_C_GPR
+    {"sh3add", {0b0110011, 0b110, 0b0010000}}, // O_GPR_C_GPR_C_GPR
+    {"add.uw", {0b0111011, 0b000, 0b0000100}}, // O_GPR_C_GPR_C_GPR
+    {"sh1add.uw", {0b0111011, 0b010, 0b0010000}}, // O_GPR_C_GPR_C_GPR
+    {"sh2add.uw", {0b0111011, 0b100, 0b0010000}}, // O_GPR_C_GPR_C_GPR
+    {"sh3add.uw", {0b0111011, 0b110, 0b0010000}}, // O_GPR_C_GPR_C_GPR
+
+    {"andn", {0b0110011, 0b111, 0b0100000}}, // O_GPR_C_GPR_C_GPR
+    {"orn", {0b0110011, 0b110, 0b0100000}}, // O_GPR_C_GPR_C_GPR
+    {"xnor", {0b0110011, 0b100, 0b0100000}}, // O_GPR_C_GPR_C_GPR
+    {"max", {0b0110011, 0b110, 0b0000101}}, // O_GPR_C_GPR_C_GPR
+    {"maxu", {0b0110011, 0b111, 0b0000101}}, // O_GPR_C_GPR_C_GPR
+    {"min", {0b0110011, 0b100, 0b0000101}}, // O_GPR_C_GPR_C_GPR
+    {"minu", {0b0110011, 0b101, 0b0000101}}, // O_GPR_C_GPR_C_GPR
+    {"rol", {0b0110011, 0b001, 0b0110000}}, // O_GPR_C_GPR_C_GPR
+    {"ror", {0b0110011, 0b101, 0b0110000}}, // O_GPR_C_GPR_C_GPR
+    {"rolw", {0b0111011, 0b001, 0b0110000}}, // O_GPR_C_GPR_C_GPR
+    {"rorw", {0b0111011, 0b101, 0b0110000}}, // O_GPR_C_GPR_C_GPR
+
+};
+
+std::unordered_map<std::string, R2TypeInstructionEncoding> R2_type_instruction_encoding_map = {
+    {"clz", {0b0010011, 0b001, 0b00000, 0b0110000}}, // O_GPR_C_GPR
+    {"ctz", {0b0010011, 0b001, 0b00001, 0b0110000}}, // O_GPR_C_GPR
+    {"cpop", {0b0010011, 0b001, 0b00010, 0b0110000}}, // O_GPR_C_GPR
+    {"clzw", {0b0011011, 0b001, 0b00000, 0b0110000}}, // O_GPR_C_GPR
+    {"ctzw", {0b0011011, 0b001, 0b00001, 0b0110000}}, // O_GPR_C_GPR
+    {"cpopw", {0b0011011, 0b001, 0b00010, 0b0110000}}, // O_GPR_C_GPR
+    {"sext.b", {0b0010011, 0b001, 0b00100, 0b0110000}}, // O_GPR_C_GPR
+    {"sext.h", {0b0010011, 0b001, 0b00101, 0b0110000}}, // O_GPR_C_GPR
+    {"zext.h", {0b0111011, 0b100, 0b00000, 0b0000100}}, // O_GPR_C_GPR
+    {"orc.b", {0b0010011, 0b101, 0b00111, 0b0010100}}, // O_GPR_C_GPR
+    {"rev8", {0b0010011, 0b101, 0b11000, 0b0110101}}, // O_GPR_C_GPR
 };
 
 std::unordered_map<std::string, I1TypeInstructionEncoding> I1_type_instruction_encoding_map = {
@@ -450,6 +690,10 @@ std::unordered_map<std::string, I2TypeInstructionEncoding> I2_type_instruction_e
     {"slliw", {0b0011011, 0b001, 0b000000}}, // O_GPR_C_GPR_C_I
     {"srliw", {0b0011011, 0b101, 0b000000}}, // O_GPR_C_GPR_C_I
     {"sraiw", {0b0011011, 0b101, 0b010000}}, // O_GPR_C_GPR_C_I
+
+    {"slli.uw", {0b0011011, 0b001, 0b000010}}, // O_GPR_C_GPR_C_I
+    {"rori", {0b0010011, 0b101, 0b011000}}, // O_GPR_C_GPR_C_I
+    {"roriw", {0b0011011, 0b101, 0b011000}}, // O_GPR_C_GPR_C_I
 };
 
 std::unordered_map<std::string, STypeInstructionEncoding> S_type_instruction_encoding_map = {
@@ -589,6 +833,146 @@ std::unordered_map<std::string, FDSTypeInstructionEncoding> F_D_S_type_instructi
     {"fsd", {0b0100111, 0b011}}, // O_FPR_C_I_LP_GPR_RP
 };
 
+std::unordered_map<std::string, ATypeInstructionEncoding> A_type_instruction_encoding_map = {
+    {"lr.w", {0b0101111, 0b010, 0b0001000}}, // O_GPR_C_LP_GPR_RP
+    {"lr.w.aq", {0b0101111, 0b010, 0b0001010}}, // O_GPR_C_LP_GPR_RP
+    {"lr.w.rl", {0b0101111, 0b010, 0b0001001}}, // O_GPR_C_LP_GPR_RP
+    {"lr.w.aqrl", {0b0101111, 0b010, 0b0001011}}, // O_GPR_C_LP_GPR_RP
+    {"sc.w", {0b0101111, 0b010, 0b0001100}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"sc.w.aq", {0b0101111, 0b010, 0b0001110}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"sc.w.rl", {0b0101111, 0b010, 0b0001101}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"sc.w.aqrl", {0b0101111, 0b010, 0b0001111}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoswap.w", {0b0101111, 0b010, 0b0000100}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoswap.w.aq", {0b0101111, 0b010, 0b0000110}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoswap.w.rl", {0b0101111, 0b010, 0b0000101}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoswap.w.aqrl", {0b0101111, 0b010, 0b0000111}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoadd.w", {0b0101111, 0b010, 0b0000000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoadd.w.aq", {0b0101111, 0b010, 0b0000010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoadd.w.rl", {0b0101111, 0b010, 0b0000001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoadd.w.aqrl", {0b0101111, 0b010, 0b0000011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoxor.w", {0b0101111, 0b010, 0b0010000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoxor.w.aq", {0b0101111, 0b010, 0b0010010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoxor.w.rl", {0b0101111, 0b010, 0b0010001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoxor.w.aqrl", {0b0101111, 0b010, 0b0010011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoand.w", {0b0101111, 0b010, 0b0110000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoand.w.aq", {0b0101111, 0b010, 0b0110010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoand.w.rl", {0b0101111, 0b010, 0b0110001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoand.w.aqrl", {0b0101111, 0b010, 0b0110011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoor.w", {0b0101111, 0b010, 0b0100000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoor.w.aq", {0b0101111, 0b010, 0b0100010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoor.w.rl", {0b0101111, 0b010, 0b0100001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoor.w.aqrl", {0b0101111, 0b010, 0b0100011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomin.w", {0b0101111, 0b010, 0b1000000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomin.w.aq", {0b0101111, 0b010, 0b1000010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomin.w.rl", {0b0101111, 0b010, 0b1000001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomin.w.aqrl", {0b0101111, 0b010, 0b1000011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomax.w", {0b0101111, 0b010, 0b1010000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomax.w.aq", {0b0101111, 0b010, 0b1010010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomax.w.rl", {0b0101111, 0b010, 0b1010001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomax.w.aqrl", {0b0101111, 0b010, 0b1010011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amominu.w", {0b0101111, 0b010, 0b1100000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amominu.w.aq", {0b0101111, 0b010, 0b1100010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amominu.w.rl", {0b0101111, 0b010, 0b1100001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amominu.w.aqrl", {0b0101111, 0b010, 0b1100011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomaxu.w", {0b0101111, 0b010, 0b1110000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomaxu.w.aq", {0b0101111, 0b010, 0b1110010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomaxu.w.rl", {0b0101111, 0b010, 0b1110001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomaxu.w.aqrl", {0b0101111, 0b010, 0b1110011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"lr.d", {0b0101111, 0b011, 0b0001000}}, // O_GPR_C_LP_GPR_RP
+    {"lr.d.aq", {0b0101111, 0b011, 0b0001010}}, // O_GPR_C_LP_GPR_RP
+    {"lr.d.rl", {0b0101111, 0b011, 0b0001001}}, // O_GPR_C_LP_GPR_RP
+    {"lr.d.aqrl", {0b0101111, 0b011, 0b0001011}}, // O_GPR_C_LP_GPR_RP
+    {"sc.d", {0b0101111, 0b011, 0b0001100}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"sc.d.aq", {0b0101111, 0b011, 0b0001110}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"sc.d.rl", {0b0101111, 0b011, 0b0001101}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"sc.d.aqrl", {0b0101111, 0b011, 0b0001111}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoswap.d", {0b0101111, 0b011, 0b0000100}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoswap.d.aq", {0b0101111, 0b011, 0b0000110}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoswap.d.rl", {0b0101111, 0b011, 0b0000101}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoswap.d.aqrl", {0b0101111, 0b011, 0b0000111}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoadd.d", {0b0101111, 0b011, 0b0000000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoadd.d.aq", {0b0101111, 0b011, 0b0000010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoadd.d.rl", {0b0101111, 0b011, 0b0000001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoadd.d.aqrl", {0b0101111, 0b011, 0b0000011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoxor.d", {0b0101111, 0b011, 0b0010000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoxor.d.aq", {0b0101111, 0b011, 0b0010010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoxor.d.rl", {0b0101111, 0b011, 0b0010001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoxor.d.aqrl", {0b0101111, 0b011, 0b0010011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoand.d", {0b0101111, 0b011, 0b0110000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoand.d.aq", {0b0101111, 0b011, 0b0110010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoand.d.rl", {0b0101111, 0b011, 0b0110001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoand.d.aqrl", {0b0101111, 0b011, 0b0110011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoor.d", {0b0101111, 0b011, 0b0100000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoor.d.aq", {0b0101111, 0b011, 0b0100010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoor.d.rl", {0b0101111, 0b011, 0b0100001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amoor.d.aqrl", {0b0101111, 0b011, 0b0100011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomin.d", {0b0101111, 0b011, 0b1000000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomin.d.aq", {0b0101111, 0b011, 0b1000010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomin.d.rl", {0b0101111, 0b011, 0b1000001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomin.d.aqrl", {0b0101111, 0b011, 0b1000011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomax.d", {0b0101111, 0b011, 0b1010000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomax.d.aq", {0b0101111, 0b011, 0b1010010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomax.d.rl", {0b0101111, 0b011, 0b1010001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomax.d.aqrl", {0b0101111, 0b011, 0b1010011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amominu.d", {0b0101111, 0b011, 0b1100000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amominu.d.aq", {0b0101111, 0b011, 0b1100010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amominu.d.rl", {0b0101111, 0b011, 0b1100001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amominu.d.aqrl", {0b0101111, 0b011, 0b1100011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomaxu.d", {0b0101111, 0b011, 0b1110000}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomaxu.d.aq", {0b0101111, 0b011, 0b1110010}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomaxu.d.rl", {0b0101111, 0b011, 0b1110001}}, // O_GPR_C_GPR_C_LP_GPR_RP
+    {"amomaxu.d.aqrl", {0b0101111, 0b011, 0b1110011}}, // O_GPR_C_GPR_C_LP_GPR_RP
+};
+
+std::unordered_map<std::string, VTypeInstructionEncoding> V_type_instruction_encoding_map = {
+    {"vsetvli", {0b1010111, 0b111, 0b0000000}}, // O_GPR_C_GPR_C_VTYPE, zimm[10:0] in bits 30:20
+    {"vsetivli", {0b1010111, 0b111, 0b1100000}}, // O_GPR_C_I_C_VTYPE, zimm[9:0] in bits 29:20, uimm in rs1
+    {"vsetvl", {0b1010111, 0b111, 0b1000000}}, // O_GPR_C_GPR_C_GPR
+
+    {"vle8.v", {0b0000111, 0b000, 0b0000001}}, // O_VR_C_LP_GPR_RP
+    {"vle16.v", {0b0000111, 0b101, 0b0000001}}, // O_VR_C_LP_GPR_RP
+    {"vle32.v", {0b0000111, 0b110, 0b0000001}}, // O_VR_C_LP_GPR_RP
+    {"vle64.v", {0b0000111, 0b111, 0b0000001}}, // O_VR_C_LP_GPR_RP
+    {"vse8.v", {0b0100111, 0b000, 0b0000001}}, // O_VR_C_LP_GPR_RP
+    {"vse16.v", {0b0100111, 0b101, 0b0000001}}, // O_VR_C_LP_GPR_RP
+    {"vse32.v", {0b0100111, 0b110, 0b0000001}}, // O_VR_C_LP_GPR_RP
+    {"vse64.v", {0b0100111, 0b111, 0b0000001}}, // O_VR_C_LP_GPR_RP
+    {"vlse8.v", {0b0000111, 0b000, 0b0000101}}, // O_VR_C_LP_GPR_RP_C_GPR
+    {"vlse16.v", {0b0000111, 0b101, 0b0000101}}, // O_VR_C_LP_GPR_RP_C_GPR
+    {"vlse32.v", {0b0000111, 0b110, 0b0000101}}, // O_VR_C_LP_GPR_RP_C_GPR
+    {"vlse64.v", {0b0000111, 0b111, 0b0000101}}, // O_VR_C_LP_GPR_RP_C_GPR
+    {"vsse8.v", {0b0100111, 0b000, 0b0000101}}, // O_VR_C_LP_GPR_RP_C_GPR
+    {"vsse16.v", {0b0100111, 0b101, 0b0000101}}, // O_VR_C_LP_GPR_RP_C_GPR
+    {"vsse32.v", {0b0100111, 0b110, 0b0000101}}, // O_VR_C_LP_GPR_RP_C_GPR
+    {"vsse64.v", {0b0100111, 0b111, 0b0000101}}, // O_VR_C_LP_GPR_RP_C_GPR
+
+    {"vadd.vv", {0b1010111, 0b000, 0b0000001}}, // O_VR_C_VR_C_VR
+    {"vadd.vx", {0b1010111, 0b100, 0b0000001}}, // O_VR_C_VR_C_GPR
+    {"vadd.vi", {0b1010111, 0b011, 0b0000001}}, // O_VR_C_VR_C_I
+    {"vsub.vv", {0b1010111, 0b000, 0b0000101}}, // O_VR_C_VR_C_VR
+    {"vsub.vx", {0b1010111, 0b100, 0b0000101}}, // O_VR_C_VR_C_GPR
+    {"vmul.vv", {0b1010111, 0b010, 0b1001011}}, // O_VR_C_VR_C_VR
+    {"vmul.vx", {0b1010111, 0b110, 0b1001011}}, // O_VR_C_VR_C_GPR
+    {"vmacc.vv", {0b1010111, 0b010, 0b1011011}}, // O_VR_C_VR_C_VR
+    {"vmacc.vx", {0b1010111, 0b110, 0b1011011}}, // O_VR_C_GPR_C_VR
+    {"vredsum.vs", {0b1010111, 0b010, 0b0000001}}, // O_VR_C_VR_C_VR
+    {"vmv.v.v", {0b1010111, 0b000, 0b0101111}}, // O_VR_C_VR
+    {"vmv.v.x", {0b1010111, 0b100, 0b0101111}}, // O_VR_C_GPR
+    {"vmv.v.i", {0b1010111, 0b011, 0b0101111}}, // O_VR_C_I
+
+    {"vfadd.vv", {0b1010111, 0b001, 0b0000001}}, // O_VR_C_VR_C_VR
+    {"vfadd.vf", {0b1010111, 0b101, 0b0000001}}, // O_VR_C_VR_C_FPR
+    {"vfsub.vv", {0b1010111, 0b001, 0b0000101}}, // O_VR_C_VR_C_VR
+    {"vfsub.vf", {0b1010111, 0b101, 0b0000101}}, // O_VR_C_VR_C_FPR
+    {"vfmul.vv", {0b1010111, 0b001, 0b1001001}}, // O_VR_C_VR_C_VR
+    {"vfmul.vf", {0b1010111, 0b101, 0b1001001}}, // O_VR_C_VR_C_FPR
+    {"vfmacc.vv", {0b1010111, 0b001, 0b1011001}}, // O_VR_C_VR_C_VR
+    {"vfmacc.vf", {0b1010111, 0b101, 0b1011001}}, // O_VR_C_FPR_C_VR
+    {"vfredusum.vs", {0b1010111, 0b001, 0b0000011}}, // O_VR_C_VR_C_VR
+    {"vfredosum.vs", {0b1010111, 0b001, 0b0000111}}, // O_VR_C_VR_C_VR
+    {"vfmv.v.f", {0b1010111, 0b101, 0b0101111}}, // O_VR_C_FPR
+};
+
 /*
    O_GPR_C_GPR_C_GPR,       ///< Opcode general-register , general-register , register
     O_GPR_C_GPR_C_I,        ///< Opcode general-register , general-register , immediate
@@ -715,6 +1099,9 @@ std::unordered_map<std::string, std::vector<SyntaxType>> instruction_syntax_map
     {"tail", {SyntaxType::PSEUDO}},
     {"fence", {SyntaxType::PSEUDO}},
     {"fence_i", {SyntaxType::PSEUDO}},
+    {"rdcycle", {SyntaxType::PSEUDO}},
+    {"rdtime", {SyntaxType::PSEUDO}},
+    {"rdinstret", {SyntaxType::PSEUDO}},
 
 ///////////////////////////////////////////////////////////////////////////////////
     {"mul", {SyntaxType::O_GPR_C_GPR_C_GPR}},
@@ -732,6 +1119,41 @@ std::unordered_map<std::string, std::vector<SyntaxType>> instruction_syntax_map
     {"remw", {SyntaxType::O_GPR_C_GPR_C_GPR}},
     {"remuw", {SyntaxType::O_GPR_C_GPR_C_GPR}},
 
+///////////////////////////////////////////////////////////////////////////////////
+    {"sh1add", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"sh2add", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"sh3add", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"add.uw", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"sh1add.uw", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"sh2add.uw", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"sh3add.uw", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"slli.uw", {SyntaxType::O_GPR_C_GPR_C_I}},
+
+    {"andn", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"orn", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"xnor", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"clz", {SyntaxType::O_GPR_C_GPR}},
+    {"ctz", {SyntaxType::O_GPR_C_GPR}},
+    {"cpop", {SyntaxType::O_GPR_C_GPR}},
+    {"clzw", {SyntaxType::O_GPR_C_GPR}},
+    {"ctzw", {SyntaxType::O_GPR_C_GPR}},
+    {"cpopw", {SyntaxType::O_GPR_C_GPR}},
+    {"max", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"maxu", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"min", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"minu", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"sext.b", {SyntaxType::O_GPR_C_GPR}},
+    {"sext.h", {SyntaxType::O_GPR_C_GPR}},
+    {"zext.h", {SyntaxType::O_GPR_C_GPR}},
+    {"rol", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"ror", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"rori", {SyntaxType::O_GPR_C_GPR_C_I}},
+    {"rolw", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"rorw", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+    {"roriw", {SyntaxType::O_GPR_C_GPR_C_I}},
+    {"orc.b", {SyntaxType::O_GPR_C_GPR}},
+    {"rev8", {SyntaxType::O_GPR_C_GPR}},
+
 ///////////////////////////////////////////////////////////////////////////////////
 
     {"flw", {SyntaxType::O_FPR_C_I_LP_GPR_RP}},
@@ -820,6 +1242,144 @@ std::unordered_map<std::string, std::vector<SyntaxType>> instruction_syntax_map
     {"fmv.x.d", {SyntaxType::O_GPR_C_FPR}}, // x[n][0:63] to f[m][0:63], 64-bit floating-point value from an f (floating-point) register into an x (integer) register without conversion
     {"fmv.d.x", {SyntaxType::O_FPR_C_GPR}}, // f[n][0:63] to x[m][0:63], 64-bit floating-point value from an x (integer) register into an f (floating-point) register without conversion
 
+///////////////////////////////////////////////////////////////////////////////////
+
+    {"vsetvli", {SyntaxType::O_GPR_C_GPR_C_VTYPE}},
+    {"vsetivli", {SyntaxType::O_GPR_C_I_C_VTYPE}},
+    {"vsetvl", {SyntaxType::O_GPR_C_GPR_C_GPR}},
+
+    {"vle8.v", {SyntaxType::O_VR_C_LP_GPR_RP}},
+    {"vle16.v", {SyntaxType::O_VR_C_LP_GPR_RP}},
+    {"vle32.v", {SyntaxType::O_VR_C_LP_GPR_RP}},
+    {"vle64.v", {SyntaxType::O_VR_C_LP_GPR_RP}},
+    {"vse8.v", {SyntaxType::O_VR_C_LP_GPR_RP}},
+    {"vse16.v", {SyntaxType::O_VR_C_LP_GPR_RP}},
+    {"vse32.v", {SyntaxType::O_VR_C_LP_GPR_RP}},
+    {"vse64.v", {SyntaxType::O_VR_C_LP_GPR_RP}},
+    {"vlse8.v", {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR}},
+    {"vlse16.v", {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR}},
+    {"vlse32.v", {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR}},
+    {"vlse64.v", {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR}},
+    {"vsse8.v", {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR}},
+    {"vsse16.v", {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR}},
+    {"vsse32.v", {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR}},
+    {"vsse64.v", {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR}},
+
+    {"vadd.vv", {SyntaxType::O_VR_C_VR_C_VR}}, // vd, vs2, vs1
+    {"vadd.vx", {SyntaxType::O_VR_C_VR_C_GPR}},
+    {"vadd.vi", {SyntaxType::O_VR_C_VR_C_I}},
+    {"vsub.vv", {SyntaxType::O_VR_C_VR_C_VR}},
+    {"vsub.vx", {SyntaxType::O_VR_C_VR_C_GPR}},
+    {"vmul.vv", {SyntaxType::O_VR_C_VR_C_VR}},
+    {"vmul.vx", {SyntaxType::O_VR_C_VR_C_GPR}},
+    {"vmacc.vv", {SyntaxType::O_VR_C_VR_C_VR}}, // vd, vs1, vs2
+    {"vmacc.vx", {SyntaxType::O_VR_C_GPR_C_VR}}, // vd, rs1, vs2
+    {"vredsum.vs", {SyntaxType::O_VR_C_VR_C_VR}}, // vd, vs2, vs1
+    {"vmv.v.v", {SyntaxType::O_VR_C_VR}},
+    {"vmv.v.x", {SyntaxType::O_VR_C_GPR}},
+    {"vmv.v.i", {SyntaxType::O_VR_C_I}},
+
+    {"vfadd.vv", {SyntaxType::O_VR_C_VR_C_VR}},
+    {"vfadd.vf", {SyntaxType::O_VR_C_VR_C_FPR}},
+    {"vfsub.vv", {SyntaxType::O_VR_C_VR_C_VR}},
+    {"vfsub.vf", {SyntaxType::O_VR_C_VR_C_FPR}},
+    {"vfmul.vv", {SyntaxType::O_VR_C_VR_C_VR}},
+    {"vfmul.vf", {SyntaxType::O_VR_C_VR_C_FPR}},
+    {"vfmacc.vv", {SyntaxType::O_VR_C_VR_C_VR}}, // vd, vs1, vs2
+    {"vfmacc.vf", {SyntaxType::O_VR_C_FPR_C_VR}}, // vd, rs1, vs2
+    {"vfredusum.vs", {SyntaxType::O_VR_C_VR_C_VR}},
+    {"vfredosum.vs", {SyntaxType::O_VR_C_VR_C_VR}},
+    {"vfmv.v.f", {SyntaxType::O_VR_C_FPR}},
+
+    {"lr.w", {SyntaxType::O_GPR_C_LP_GPR_RP}},
+    {"lr.w.aq", {SyntaxType::O_GPR_C_LP_GPR_RP}},
+    {"lr.w.rl", {SyntaxType::O_GPR_C_LP_GPR_RP}},
+    {"lr.w.aqrl", {SyntaxType::O_GPR_C_LP_GPR_RP}},
+    {"sc.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"sc.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"sc.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"sc.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoswap.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoswap.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoswap.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoswap.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoadd.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoadd.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoadd.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoadd.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoxor.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoxor.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoxor.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoxor.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoand.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoand.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoand.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoand.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoor.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoor.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoor.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoor.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomin.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomin.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomin.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomin.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomax.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomax.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomax.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomax.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amominu.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amominu.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amominu.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amominu.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomaxu.w", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomaxu.w.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomaxu.w.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomaxu.w.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"lr.d", {SyntaxType::O_GPR_C_LP_GPR_RP}},
+    {"lr.d.aq", {SyntaxType::O_GPR_C_LP_GPR_RP}},
+    {"lr.d.rl", {SyntaxType::O_GPR_C_LP_GPR_RP}},
+    {"lr.d.aqrl", {SyntaxType::O_GPR_C_LP_GPR_RP}},
+    {"sc.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"sc.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"sc.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"sc.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoswap.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoswap.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoswap.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoswap.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoadd.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoadd.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoadd.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoadd.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoxor.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoxor.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoxor.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoxor.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoand.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoand.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoand.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoand.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoor.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoor.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoor.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amoor.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomin.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomin.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomin.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomin.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomax.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomax.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomax.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomax.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amominu.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amominu.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amominu.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amominu.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomaxu.d", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomaxu.d.aq", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomaxu.d.rl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+    {"amomaxu.d.aqrl", {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP}},
+
 };
 
 bool isValidInstruction(const std::string &instruction) {
@@ -830,6 +1390,10 @@ bool isValidRTypeInstruction(const std::string &instruction) {
   return RTypeInstructions.find(instruction)!=RTypeInstructions.end();
 }
 
+bool isValidR2TypeInstruction(const std::string &instruction) {
+  return R2TypeInstructions.find(instruction)!=R2TypeInstructions.end();
+}
+
 bool isValidITypeInstruction(const std::string &instruction) {
   return (I1TypeInstructions.find(instruction)!=I1TypeInstructions.end()) ||
       (I2TypeInstructions.find(instruction)!=I2TypeInstructions.end()) ||
@@ -844,6 +1408,10 @@ bool isValidI2TypeInstruction(const std::string &instruction) {
   return I2TypeInstructions.find(instruction)!=I2TypeInstructions.end();
 }
 
+bool isValidI2WordTypeInstruction(const std::string &instruction) {
+  return I2WordTypeInstructions.find(instruction)!=I2WordTypeInstructions.end();
+}
+
 bool isValidI3TypeInstruction(const std::string &instruction) {
   return I3TypeInstructions.find(instruction)!=I3TypeInstructions.end();
 }
@@ -885,6 +1453,22 @@ bool isValidDExtensionInstruction(const std::string &instruction) {
   return DExtensionInstructions.find(instruction)!=DExtensionInstructions.end();
 }
 
+bool isValidZbaExtensionInstruction(const std::string &instruction) {
+  return ZbaExtensionInstructions.find(instruction)!=ZbaExtensionInstructions.end();
+}
+
+bool isValidZbbExtensionInstruction(const std::string &instruction) {
+  return ZbbExtensionInstructions.find(instruction)!=ZbbExtensionInstructions.end();
+}
+
+bool isValidVExtensionInstruction(const std::string &instruction) {
+  return VExtensionInstructions.find(instruction)!=VExtensionInstructions.end();
+}
+
+bool isValidAExtensionInstruction(const std::string &instruction) {
+  return AExtensionInstructions.find(instruction)!=AExtensionInstructions.end();
+}
+
 bool isValidCSRRTypeInstruction(const std::string &instruction) {
   return CSRRInstructions.find(instruction)!=CSRRInstructions.end();
 }
@@ -926,59 +1510,6 @@ bool isValidFDSTypeInstruction(const std::string &instruction) {
   return (FDExtensionSTypeInstructions.find(instruction)!=FDExtensionSTypeInstructions.end());
 }
 
-bool isFInstruction(const uint32_t &instruction) {
-  uint8_t opcode = (instruction & 0b1111111);
-  uint8_t funct3 = (instruction >> 12) & 0b111;
-  uint8_t funct7 = (instruction >> 25) & 0b1111111;
-
-  switch (opcode) {
-    case 0b0000111: // flw
-    case 0b0100111: {// fsw
-      if (funct3==0b010) {
-        return true; // flw
-      }
-      break;
-    }
-    case 0b1010011: {
-      if (!(funct7 & 0b1)) {
-        if (funct7==0b0100000) {
-          return false; // fcvt.s.d
-        }
-        return true;
-      }
-    }
-    default: break;
-  }
-
-  return false;
-}
-
-bool isDInstruction(const uint32_t &instruction) {
-  uint8_t opcode = (instruction & 0b1111111);
-  uint8_t funct3 = (instruction >> 12) & 0b111;
-  uint8_t funct7 = (instruction >> 25) & 0b1111111;
-  
-
-  switch (opcode) {
-    case 0b0000111: // fld
-    case 0b0100111: {// fsd
-      if (funct3==0b011) {
-        return true; // fld
-      }
-      break;
-    }
-    case 0b1010011: {
-      if (funct7 & 0b1) {
-        return true;
-      } else if (funct7==0b0100000) {
-        return true; // fcvt.s.d
-      }
-    }
-    default: break;
-  }
-  return false;
-}
-
 std::string getExpectedSyntaxes(const std::string &opcode) {
   static const std::unordered_map<std::string, std::string> opcodeSyntaxMap = {
       {"nop", "nop"},
@@ -1001,7 +1532,10 @@ std::string getExpectedSyntaxes(const std::string &opcode) {
       {"la", "la <reg>, <text label>"},
       {"call", "call <text label>"},
       {"tail", "tail <text label>"},
-      {"fence", "fence"}
+      {"fence", "fence"},
+      {"rdcycle", "rdcycle <reg>"},
+      {"rdtime", "rdtime <reg>"},
+      {"rdinstret", "rdinstret <reg>"}
   };
 
   auto opcodeIt = opcodeSyntaxMap.find(opcode);
@@ -1017,6 +1551,7 @@ std::string getExpectedSyntaxes(const std::string &opcode) {
       {SyntaxType::O_GPR_C_GPR_C_DL, "<gp-reg>, <gp-reg>, <data-label>"},
       {SyntaxType::O_GPR_C_I_LP_GPR_RP, "<gp-reg>, <gp-imm>(<gp-reg>)"},
       {SyntaxType::O_GPR_C_I, "<gp-reg>, <imm>"},
+      {SyntaxType::O_GPR_C_GPR, "<gp-reg>, <gp-reg>"},
       {SyntaxType::O_GPR_C_IL, "<gp-reg>, <text-label>"},
       {SyntaxType::O_GPR_C_DL, "<gp-reg>, <data-label>"},
       {SyntaxType::O_GPR_C_CSR_C_GPR, "<gp-reg>, <csr>, <gp-reg>"},
@@ -1033,6 +1568,22 @@ std::string getExpectedSyntaxes(const std::string &opcode) {
       {SyntaxType::O_GPR_C_FPR_C_RM, "<gp-reg>, <fp-reg>, <rm>"},
       {SyntaxType::O_GPR_C_FPR_C_FPR, "<gp-reg>, <fp-reg>, <fp-reg>"},
       {SyntaxType::O_FPR_C_I_LP_GPR_RP, "<fp-reg>, <imm>(<gp-reg>)"},
+      {SyntaxType::O_GPR_C_GPR_C_VTYPE, "<gp-reg>, <gp-reg>, <sew>, <lmul>, <ta|tu>, <ma|mu>"},
+      {SyntaxType::O_GPR_C_I_C_VTYPE, "<gp-reg>, <uimm>, <sew>, <lmul>, <ta|tu>, <ma|mu>"},
+      {SyntaxType::O_VR_C_LP_GPR_RP, "<vec-reg>, (<gp-reg>)"},
+      {SyntaxType::O_VR_C_LP_GPR_RP_C_GPR, "<vec-reg>, (<gp-reg>), <gp-reg>"},
+      {SyntaxType::O_VR_C_VR_C_VR, "<vec-reg>, <vec-reg>, <vec-reg>"},
+      {SyntaxType::O_VR_C_VR_C_GPR, "<vec-reg>, <vec-reg>, <gp-reg>"},
+      {SyntaxType::O_VR_C_VR_C_FPR, "<vec-reg>, <vec-reg>, <fp-reg>"},
+      {SyntaxType::O_VR_C_VR_C_I, "<vec-reg>, <vec-reg>, <imm>"},
+      {SyntaxType::O_VR_C_GPR_C_VR, "<vec-reg>, <gp-reg>, <vec-reg>"},
+      {SyntaxType::O_VR_C_FPR_C_VR, "<vec-reg>, <fp-reg>, <vec-reg>"},
+      {SyntaxType::O_VR_C_VR, "<vec-reg>, <vec-reg>"},
+      {SyntaxType::O_VR_C_GPR, "<vec-reg>, <gp-reg>"},
+      {SyntaxType::O_VR_C_FPR, "<vec-reg>, <fp-reg>"},
+      {SyntaxType::O_VR_C_I, "<vec-reg>, <imm>"},
+      {SyntaxType::O_GPR_C_LP_GPR_RP, "<gp-reg>, (<gp-reg>)"},
+      {SyntaxType::O_GPR_C_GPR_C_LP_GPR_RP, "<gp-reg>, <gp-reg>, (<gp-reg>)"},
   };
 
   std::string syntaxes;
@@ -6,6 +6,9 @@
 #include "vm/rv5s/rv5s_vm.h"
 #include "vm/rv5s/rv5s_ex_vm.h"
 #include "vm/rv5s/rv5s_id_vm.h"
+#include "vm/rv5s/rv5s_superscalar_vm.h"
+#include "vm/rvooo/rvooo_vm.h"
+#include "vm/vm_fork.h"
 #include "vm_runner.h"
 #include "command_handler.h"
 #include "config.h"
@@ -16,25 +19,33 @@
 #include <regex>
 
 // Helper to initialize a new VM object from the changed config modes
-std::unique_ptr<VmBase> initializeVm() {
+std::unique_ptr<VmBase> initializeVm(bool silent = false) {
     std::unique_ptr<VmBase> vm;
     vm_config::VmTypes vmType = vm_config::config.getVmType();
 
     if (vmType == vm_config::VmTypes::SINGLE_STAGE) {
         std::cout << "Initializing Single-Stage VM..." << std::endl;
-        vm = std::make_unique<RVSSVM>();
+        vm = std::make_unique<RVSSVM>(silent);
+    } else if (vmType == vm_config::VmTypes::OUT_OF_ORDER) {
+        std::cout << "Initializing Out-of-Order VM..." << std::endl;
+        vm = std::make_unique<RVOOOVM>(silent);            // reads window sizes and predictor in Reset()
     } else {
         vm_config::DataHazardMode hazardMode = vm_config::config.getDataHazardMode();
         vm_config::BranchStage branch_stage = vm_config::config.getBranchStage();
 
         if (hazardMode == vm_config::DataHazardMode::IDEAL) {
             std::cout << "Initializing 5-Stage Pipeline VM (Ideal Mode)..." << std::endl;
-            vm = std::make_unique<RV5SVM>(); 
+            vm = std::make_unique<RV5SVM>(silent); 
         } else {
-            if (branch_stage == vm_config::BranchStage::BRANCH_IN_EX) {
+            if (branch_stage == vm_config::BranchStage::BRANCH_IN_EX && vm_config::config.getIssueWidth() > 1) {
+
+                std::cout << "Initializing " << vm_config::config.getIssueWidth() << "-wide Superscalar 5-Stage Pipeline VM (Branch in EX)..." << std::endl;
+                vm = std::make_unique<RV5SSuperscalarVM>(silent);          // reads forwarding, predictor and port configuration in Reset()
+            }
+            else if (branch_stage == vm_config::BranchStage::BRANCH_IN_EX) {
                 
                 std::cout << "Initializing 5-Stage Pipeline VM (Branch in EX)..." << std::endl;
-                auto rv5s_vm = std::make_unique<RV5SEXVM>();
+                auto rv5s_vm = std::make_unique<RV5SEXVM>(silent);
 
                 rv5s_vm->setBranchPredictorType(vm_config::config.getBranchPredictorType());
                 
@@ -45,7 +56,7 @@ std::unique_ptr<VmBase> initializeVm() {
             else if (branch_stage == vm_config::BranchStage::BRANCH_IN_ID) {
                 
                 std::cout << "Initializing 5-Stage Pipeline VM (Branch in ID)..." << std::endl;
-                auto rv5s_vm = std::make_unique<RV5SIDVM>();
+                auto rv5s_vm = std::make_unique<RV5SIDVM>(silent);
 
                 rv5s_vm->setBranchPredictorType(vm_config::config.getBranchPredictorType());
                 
@@ -54,7 +65,7 @@ std::unique_ptr<VmBase> initializeVm() {
                 vm = std::move(rv5s_vm);
             } else {
                 std::cerr << "Error main.cpp: Combination of requested Pipeline Modes not supported." << std::endl;
-                vm = std::make_unique<RVSSVM>();
+                vm = std::make_unique<RVSSVM>(silent);
             }
         }
     }
@@ -242,7 +253,15 @@ int main(int argc, char *argv[]) {
         std::cerr << e.what() << '\n';
         continue;
       }
-      vm_ptr->LoadProgram(program);
+      try {
+        vm_ptr->LoadProgram(program);
+      } catch (const std::runtime_error &e) {       // the program needs instructions this pipeline does not execute
+        std::cout << "VM_PARSE_ERROR" << std::endl;
+        vm_ptr->output_status_ = "VM_PARSE_ERROR";
+        vm_ptr->DumpState(globals::vm_state_dump_file_path);
+        std::cerr << e.what() << '\n';
+        continue;
+      }
       std::cout << "Program loaded: " << command.args[0] << std::endl;
     } else if (command.type==command_handler::CommandType::RUN) {
       launch_vm_thread([&]() { vm_ptr->Run(); });
@@ -263,6 +282,18 @@ int main(int argc, char *argv[]) {
     } else if (command.type==command_handler::CommandType::REDO) {
       if (vm_running) continue;
       vm_ptr->Redo();
+    } else if (command.type==command_handler::CommandType::SEEK) {
+      if (vm_running) continue;
+      try {
+        if (command.args.size() != 1) {
+          std::cout << "VM_SEEK_ERROR" << std::endl;
+          continue;
+        }
+        vm_ptr->Seek(std::stoull(command.args[0]));
+      } catch (const std::exception& e) {
+        std::cout << "VM_SEEK_ERROR" << std::endl;
+        continue;
+      }
     } else if (command.type==command_handler::CommandType::RESET) {
       vm_ptr->Reset();
       program = AssembledProgram();
@@ -287,6 +318,7 @@ int main(int argc, char *argv[]) {
         std::string reg_name = command.args[0];
         uint64_t value = std::stoull(command.args[1], nullptr, 16);
         vm_ptr->ModifyRegister(reg_name, value);
+        vm_ptr->StateEdited();
         DumpRegisters(globals::registers_dump_file_path, vm_ptr->registers_);
         std::cout << "VM_MODIFY_REGISTER_SUCCESS" << std::endl;
       } catch (const std::out_of_range &e) {
@@ -302,7 +334,7 @@ int main(int argc, char *argv[]) {
         std::cout << "VM_REGISTER_VAL_START";
         std::cout << "0x"
                   << std::hex
-                  << vm_ptr->registers_.ReadGpr(std::stoi(reg_str.substr(1))) 
+                  << vm_ptr->registers_.ReadGprChecked(std::stoi(reg_str.substr(1))) 
                   << std::dec;
         std::cout << "VM_REGISTER_VAL_END"<< std::endl;
       } 
@@ -331,6 +363,7 @@ int main(int argc, char *argv[]) {
           std::cout << "VM_MODIFY_MEMORY_ERROR" << std::endl;
           continue;
         }
+        vm_ptr->StateEdited();
         std::cout << "VM_MODIFY_MEMORY_SUCCESS" << std::endl;
       } catch (const std::out_of_range &e) {
         std::cout << "VM_MODIFY_MEMORY_ERROR" << std::endl;
@@ -377,6 +410,67 @@ int main(int argc, char *argv[]) {
     
     else if (command.type==command_handler::CommandType::DUMP_CACHE) {
       std::cout << "Cache dumped." << std::endl;
+    } else if (command.type==command_handler::CommandType::DUMP_BRANCH_PROFILE) {
+      if (vm_running) continue;
+      if (command.args.empty() || command.args.size() > 2 || (command.args.size() == 2 && command.args[1] != "annotate")) {
+        std::cout << "VM_BRANCH_PROFILE_DUMP_ERROR" << std::endl;
+        continue;
+      }
+      try {
+        std::filesystem::path report_path = command.args[0];
+        if (report_path.extension() == ".csv") {
+          vm_ptr->branch_profile_.DumpCsv(report_path, vm_ptr->program_);
+        } else {
+          vm_ptr->branch_profile_.DumpJson(report_path, vm_ptr->program_);
+        }
+        if (command.args.size() == 2) {
+          vm_ptr->branch_profile_.AnnotateDisassembly(globals::disassembly_file_path, vm_ptr->program_);
+        }
+        std::cout << "VM_BRANCH_PROFILE_DUMPED" << std::endl;
+      } catch (const std::exception &e) {
+        std::cout << "VM_BRANCH_PROFILE_DUMP_ERROR" << std::endl;
+        std::cerr << e.what() << '\n';
+      }
+    } else if (command.type==command_handler::CommandType::SAVE_STATE) {
+      if (vm_running) continue;
+      if (command.args.empty() || command.args.size() > 2 || (command.args.size() == 2 && command.args[1] != "compress")) {
+        std::cout << "VM_SAVE_STATE_ERROR" << std::endl;
+        continue;
+      }
+      if (vm_ptr->SaveState(command.args[0], command.args.size() == 2)) {
+        std::cout << "VM_STATE_SAVED" << std::endl;
+      } else {
+        std::cout << "VM_SAVE_STATE_ERROR" << std::endl;
+      }
+    } else if (command.type==command_handler::CommandType::LOAD_STATE) {
+      if (vm_running) continue;
+      if (command.args.size() != 1) {
+        std::cout << "VM_LOAD_STATE_ERROR" << std::endl;
+        continue;
+      }
+      if (vm_ptr->LoadState(command.args[0])) {
+        std::cout << "VM_STATE_LOADED" << std::endl;
+      } else {
+        std::cout << "VM_LOAD_STATE_ERROR" << std::endl;
+      }
+    } else if (command.type==command_handler::CommandType::FORK_RUN) {
+      if (vm_running) continue;
+      if (command.args.size() < 2 || program.filename.empty()) {
+        std::cout << "VM_FORK_RUN_ERROR" << std::endl;
+        continue;
+      }
+      try {
+        std::vector<ForkSpec> specs;
+        for (size_t i = 1; i < command.args.size(); ++i) {
+          specs.push_back(parseForkSpec(command.args[i], vm_config::config));
+        }
+        std::vector<ForkResult> results = forkAndRun(*vm_ptr, specs, []() { return initializeVm(true); });
+        dumpForkResults(command.args[0], vm_ptr->instructions_retired_, results);
+        std::cout << "VM_FORK_RUN_COMPLETED" << std::endl;
+      } catch (const std::exception &e) {
+        std::cout << "VM_FORK_RUN_ERROR" << std::endl;
+        std::cerr << e.what() << '\n';
+      }
     } else {
       std::cout << "Invalid command.";
       std::cout << command_buffer << std::endl;
@@ -14,10 +14,17 @@
 #include <cstring> // For memcpy
 
 int main(int argc, char *argv[]) {
-    if (argc != 4 || std::string(argv[2]) != "-o") {
-        std::cerr << "Usage: " << argv[0] << " <input.s> -o <output.memimg>\n";
+    if (argc < 4 || (argc - 4) % 4 != 0 || std::string(argv[2]) != "-o") {
+        std::cerr << "Usage: " << argv[0] << " <input.s> -o <output.memimg> [--config <Section> <Key> <Value>]...\n";
         return 1;
     }
+    for (int i = 4; i < argc; i += 4) {     // e.g. --config Assembler c_extension_enabled true
+        if (std::string(argv[i]) != "--config") {
+            std::cerr << "Unknown argument: " << argv[i] << '\n';
+            return 1;
+        }
+        vm_config::config.modifyConfig(argv[i + 1], argv[i + 2], argv[i + 3]);
+    }
     
     std::string input_file = argv[1];
     std::string output_file = argv[3];
@@ -28,11 +35,15 @@ int main(int argc, char *argv[]) {
         out_file << std::hex << std::setfill('0');
 
         // Write .text segment (from VmBase::LoadProgram)
-        unsigned int counter = 0;
-        for (const auto &instruction : program.text_buffer) {
-            out_file << "W 0x" << counter << " 0x" << std::setw(8) << instruction << '\n';
-            counter += 4;
+        for (unsigned int i = 0; i < program.text_buffer.size(); ++i) {
+            uint32_t instruction = program.text_buffer[i];
+            if ((instruction & 0b11) != 0b11) {     // compressed
+                out_file << "H 0x" << program.InstructionAddress(i) << " 0x" << std::setw(4) << instruction << '\n';
+            } else {
+                out_file << "W 0x" << program.InstructionAddress(i) << " 0x" << std::setw(8) << instruction << '\n';
+            }
         }
+        uint64_t counter = program.TextSize();
 
         // Write .data segment (from VmBase::LoadProgram)
         unsigned int data_counter = 0;
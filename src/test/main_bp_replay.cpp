@@ -0,0 +1,172 @@
+/**
+ * @file main_bp_replay.cpp
+ * @brief Entry Point for the branch predictor trace replay tool. Records the branch and jump trace of a program on
+ *        the single stage VM (or loads a saved trace) and replays its conditional branches through every predictor
+ *        and table size.
+ */
+
+#include "vm/rvss/rvss_vm.h"
+#include "vm/rv5s/branch_prediction/branch_trace.h"
+#include "vm_loader.h"
+#include "config.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage(const char *prog) {
+    std::cerr << "Usage: " << prog << " <input.memimg> [--save-trace <file>] [--sizes n,n,...] [--threads n] [--config Sec Key Val]...\n"
+              << "       " << prog << " --trace <file> [--sizes n,n,...] [--threads n]\n";
+}
+
+std::vector<std::size_t> parseSizes(const std::string &list) {
+    std::vector<std::size_t> sizes;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            sizes.push_back(std::stoull(item));
+        }
+    }
+    return sizes;
+}
+
+BranchTrace recordTrace(const std::string &input_file) {
+    BranchTrace trace;
+    RVSSVM vm(true);
+    vm.SetBranchTrace(&trace);
+    LoadMemoryImage(&vm, input_file);
+
+    // the vm reports every retired pc on stdout, which would drown the table
+    std::streambuf *cout_buf = std::cout.rdbuf(nullptr);
+    vm.Run();
+    std::cout.rdbuf(cout_buf);
+    std::cout.clear();
+
+    trace.setInstructionCount(vm.instructions_retired_);
+    return trace;
+}
+
+void printTable(const BranchTrace &trace, const std::vector<ReplayResult> &results) {
+    uint64_t conditional = 0;
+    uint64_t calls = 0;
+    uint64_t returns = 0;
+    for (const BranchTraceRecord &record : trace.getRecords()) {
+        conditional += record.type == BranchType::kConditional;
+        calls += record.type == BranchType::kCall || record.type == BranchType::kIndirectCall;
+        returns += record.type == BranchType::kReturn;
+    }
+    std::cout << "Instructions: " << trace.getInstructionCount()
+              << "  Conditional branches: " << conditional
+              << "  Jumps: " << trace.getRecords().size() - conditional
+              << " (calls: " << calls << ", returns: " << returns << ")\n\n";
+
+    std::cout << std::left << std::setw(20) << "predictor"
+              << std::right << std::setw(10) << "entries"
+              << std::setw(14) << "mispredicts"
+              << std::setw(12) << "accuracy%"
+              << std::setw(10) << "MPKI" << "\n";
+    std::cout << std::string(66, '-') << "\n";
+
+    for (const ReplayResult &result : results) {
+        std::string entries = "-";
+        if (result.config.type == vm_config::BranchPredictorType::DYNAMIC_1BIT ||
+            result.config.type == vm_config::BranchPredictorType::DYNAMIC_2BIT) {
+            entries = result.config.table_size ? std::to_string(result.config.table_size) : "inf";
+        }
+        std::cout << std::left << std::setw(20) << branchPredictorName(result.config.type)
+                  << std::right << std::setw(10) << entries
+                  << std::setw(14) << result.mispredictions
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(12) << result.accuracy
+                  << std::setprecision(3)
+                  << std::setw(10) << result.mpki << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string input_file;
+    std::string trace_file;
+    std::string save_file;
+    std::vector<std::size_t> sizes = {16, 64, 256, 1024, 0};
+    unsigned int num_threads = 0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+
+            if (arg == "--trace" || arg == "--save-trace" || arg == "--sizes" || arg == "--threads") {
+                if (i + 1 >= argc) {
+                    std::cerr << "Error: " << arg << " requires a value\n";
+                    return 1;
+                }
+                std::string value = argv[++i];
+                if (arg == "--trace") trace_file = value;
+                else if (arg == "--save-trace") save_file = value;
+                else if (arg == "--sizes") sizes = parseSizes(value);
+                else num_threads = static_cast<unsigned int>(std::stoul(value));
+            }
+            else if (arg == "--config") {
+                if (i + 3 >= argc) {
+                    std::cerr << "Error: --config requires 3 arguments: <SECTION> <KEY> <VALUE>\n";
+                    return 1;
+                }
+                std::string section = argv[++i];
+                std::string key = argv[++i];
+                std::string value = argv[++i];
+                vm_config::config.modifyConfig(section, key, value);
+            }
+            else if (input_file.empty()) {
+                input_file = arg;
+            }
+            else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Argument Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    if (input_file.empty() == trace_file.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        BranchTrace trace = trace_file.empty() ? recordTrace(input_file) : BranchTrace::load(trace_file);
+        if (!save_file.empty()) {
+            trace.save(save_file);
+        }
+
+        std::vector<ReplayConfig> configs = {
+            {vm_config::BranchPredictorType::STATIC_NOT_TAKEN, 0},
+            {vm_config::BranchPredictorType::STATIC_TAKEN, 0},
+        };
+        for (vm_config::BranchPredictorType type : {vm_config::BranchPredictorType::DYNAMIC_1BIT,
+                                                    vm_config::BranchPredictorType::DYNAMIC_2BIT}) {
+            for (std::size_t size : sizes) {
+                configs.push_back({type, size});
+            }
+        }
+
+        printTable(trace, replayTraceParallel(trace, configs, num_threads));
+        return 0;
+
+    } catch (const std::exception &e) {
+        std::cerr << "BP Replay Error: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -7,6 +7,9 @@
 #include "vm/rv5s/rv5s_vm.h"
 #include "vm/rv5s/rv5s_ex_vm.h"
 #include "vm/rv5s/rv5s_id_vm.h"
+#include "vm/rv5s/rv5s_superscalar_vm.h"
+#include "vm/rvooo/rvooo_vm.h"
+#include "vm/hart_group.h"
 #include "vm_loader.h"
 #include "utils.h"
 #include "config.h"
@@ -20,6 +23,8 @@ std::unique_ptr<VmBase> initializeVm() {
 
     if (vmType == vm_config::VmTypes::SINGLE_STAGE) {
         vm = std::make_unique<RVSSVM>(true);
+    } else if (vmType == vm_config::VmTypes::OUT_OF_ORDER) {
+        vm = std::make_unique<RVOOOVM>(true);
     } else {
         vm_config::DataHazardMode hazardMode = vm_config::config.getDataHazardMode();
         vm_config::BranchStage branch_stage = vm_config::config.getBranchStage();
@@ -27,7 +32,10 @@ std::unique_ptr<VmBase> initializeVm() {
         if (hazardMode == vm_config::DataHazardMode::IDEAL) {
             vm = std::make_unique<RV5SVM>(true); 
         } else {
-            if (branch_stage == vm_config::BranchStage::BRANCH_IN_EX) {                
+            if (branch_stage == vm_config::BranchStage::BRANCH_IN_EX && vm_config::config.getIssueWidth() > 1) {
+                vm = std::make_unique<RV5SSuperscalarVM>(true);
+            }
+            else if (branch_stage == vm_config::BranchStage::BRANCH_IN_EX) {                
                 auto rv5s_vm = std::make_unique<RV5SEXVM>(true);
                 rv5s_vm->setBranchPredictorType(vm_config::config.getBranchPredictorType());
                 
@@ -95,11 +103,22 @@ int main(int argc, char *argv[]) {
         }
         
         LoadMemoryImage(vm.get(), input_file);
-        vm->Run();
-
         uint64_t data_addr = vm_config::config.getDataSectionStart();
+
+        // several harts run the loaded program on one memory, without the lockstep check
+        if (vm_config::config.getHarts() > 1) {
+            HartGroup group(*vm, vm_config::config.getHarts(), initializeVm, vm_config::config.getHartQuantum());
+            group.Run();
+            group.Hart(0).DumpFinalState(output_file, data_addr);
+            return 0;
+        }
+
+        if (vm_config::config.getLockstepCheck()) {
+            vm->EnableLockstepCheck();
+        }
+        vm->Run();
         vm->DumpFinalState(output_file, data_addr);
-        return 0;
+        return vm->LockstepDiverged() ? 2 : 0;
         
     } catch (const std::exception& e) {
         std::cerr << "MAIN CLI Error: " << e.what() << '\n';
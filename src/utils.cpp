@@ -173,26 +173,14 @@ void DumpRegisters(const std::filesystem::path &filename, RegisterFile &register
   file << "{\n";
 
   file << "    \"control and status registers\": {\n";
-  if (!csr_to_address.empty()) {
-    auto it = csr_to_address.begin();
-    auto end = csr_to_address.end();
-
-    while (true) {
-      const auto &key = it->first;
-      const auto &value = it->second;
-
-      file << "        \"" << key << "\": \"0x"
-           << std::hex << std::setw(16) << std::setfill('0') << register_file.ReadCsr(value)
-           << std::setw(0) << std::setfill(' ') << std::dec << "\"";
-
-      ++it;
-      if (it!=end) {
-        file << ",";
-      }
-      file << "\n";
-
-      if (it==end) break;
+  for (size_t i = 0; i < implemented_csrs.size(); ++i) {
+    file << "        \"" << implemented_csrs[i].name << "\": \"0x"
+         << std::hex << std::setw(16) << std::setfill('0') << register_file.ReadCsr(implemented_csrs[i].address)
+         << std::setw(0) << std::setfill(' ') << std::dec << "\"";
+    if (i!=implemented_csrs.size() - 1) {
+      file << ",";
     }
+    file << "\n";
   }
   file << "    },\n";
 
@@ -225,19 +213,25 @@ void DumpRegisters(const std::filesystem::path &filename, RegisterFile &register
     }
     file << "\n";
   }
+  file << "    },\n";
+
+  // a vector register is printed as one number, element 0 in the low bits
+  file << "    \"vec_registers\": {\n";
+  for (size_t i = 0; i < 32; ++i) {
+    const uint64_t *words = register_file.VectorRegister(i);
+    file << "        \"v" << i << "\"";
+    file << std::string((i >= 10 ? 0 : 1), ' ');
+    file << ": \"0x";
+    for (size_t w = register_file.VectorRegisterWords(); w-- > 0;) {
+      file << std::hex << std::setw(16) << std::setfill('0') << words[w];
+    }
+    file << std::setw(0) << std::setfill(' ') << std::dec << "\"";
+    if (i != 31) {
+      file << ",";
+    }
+    file << "\n";
+  }
   file << "    }\n";
-  // file << "    },\n";
-
-  // file << "    \"vec_registers\": {\n";
-  // for (size_t i = 0; i < gp_registers.size(); ++i) {
-  //     file << "        \"x" << i << "\": \"0x"
-  //          << std::hex << std::setw(16) << std::setfill('0') << gp_registers[i] << std::setw(0) << std::dec << "\"";
-  //     if (i != gp_registers.size() - 1) {
-  //         file << ",";
-  //     }
-  //     file << "\n";
-  // }
-  // file << "    }\n";
 
   file << "}\n";
 
@@ -268,13 +262,13 @@ void DumpRegisters(const std::filesystem::path &filename, RegisterFile &register
 //   unsigned int instruction_index = 0;
 //   // unsigned int symbol_index = 0;
 //   unsigned int line_number = 1;
-//   size_t max_address = intermediate_code.size() * 4;
+//   size_t max_address = program.TextSize();
 //   int hex_digits = 1;
 //   size_t temp = max_address;
 //   while (temp >>= 4) ++hex_digits;
 //   while (instruction_index < intermediate_code.size()) {
 //     const auto& [ICBlock, isData] = intermediate_code[instruction_index];
-//     uint64_t current_address = instruction_index * 4;
+//     uint64_t current_address = program.InstructionAddress(instruction_index);
 //     auto it = label_for_address.find(current_address);
 //     if (it != label_for_address.end()) {
 //       if (line_number > 1) {
@@ -337,14 +331,14 @@ void DumpDisasssembly(const std::filesystem::path &filename, AssembledProgram &p
   unsigned int instruction_index = 0;
   unsigned int line_number = 1;
 
-  size_t max_address = intermediate_code.size() * 4;
+  size_t max_address = program.TextSize();
   int hex_digits = 1;
   size_t temp = max_address;
   while (temp >>= 4) ++hex_digits;
 
   while (instruction_index < intermediate_code.size()) {
     const auto& [ICBlock, isData] = intermediate_code[instruction_index];
-    uint64_t current_address = instruction_index * 4;
+    uint64_t current_address = program.InstructionAddress(instruction_index);
 
     auto it = label_for_address.find(current_address);
     if (it != label_for_address.end()) {
@@ -367,9 +361,10 @@ void DumpDisasssembly(const std::filesystem::path &filename, AssembledProgram &p
 
     if (instruction_index < text_buffer.size()) {
       uint32_t raw = text_buffer[instruction_index];
-      out << std::setfill('0') << std::setw(8) << std::right << std::hex
+      bool compressed = (raw & 0b11) != 0b11;     // the 16-bit parcel of an RV64C instruction
+      out << std::setfill('0') << std::setw(compressed ? 4 : 8) << std::right << std::hex
           << raw
-          << std::dec << std::setfill(' ') << "             ";
+          << std::dec << std::setfill(' ') << (compressed ? "                 " : "             ");
     } else {
       out << " ????????             ";
     }
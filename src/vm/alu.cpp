@@ -5,7 +5,7 @@
  */
 
 #include "vm/alu.h"
-#include <cfenv>
+#include "vm/softfloat.h"
 #include <cmath>
 #include <cstdint>
 #include <cstring>
@@ -233,597 +233,336 @@ static std::string decode_fclass(uint16_t res) {
     case AluOp::kSltu: {
       return {static_cast<uint64_t>(a < b), false};
     }
-    default: return {0, false};
-  }
-}
-
-[[nodiscard]] std::pair<uint64_t, uint8_t> Alu::fpexecute(AluOp op,
-                                                          uint64_t ina,
-                                                          uint64_t inb,
-                                                          uint64_t inc,
-                                                          uint8_t rm) {
-  float a, b, c;
-  std::memcpy(&a, &ina, sizeof(float));
-  std::memcpy(&b, &inb, sizeof(float));
-  std::memcpy(&c, &inc, sizeof(float));
-  float result = 0.0;
-
-  uint8_t fcsr = 0;
-
-  int original_rm = std::fegetround();
-
-  switch (rm) {
-    case 0b000: std::fesetround(FE_TONEAREST);
-      break;  // RNE
-    case 0b001: std::fesetround(FE_TOWARDZERO);
-      break; // RTZ
-    case 0b010: std::fesetround(FE_DOWNWARD);
-      break;   // RDN
-    case 0b011: std::fesetround(FE_UPWARD);
-      break;     // RUP
-      // 0b100 RMM, unsupported
-    default: break;
-  }
-
-  std::feclearexcept(FE_ALL_EXCEPT);
-
-  switch (op) {
-    case AluOp::kAdd: {
-      auto sa = static_cast<int64_t>(ina);
-      auto sb = static_cast<int64_t>(inb);
-      int64_t res = sa + sb;
-      // bool overflow = __builtin_add_overflow(sa, sb, &res); // TODO: check this
-      return {static_cast<uint64_t>(res), 0};
-    }
-    case AluOp::kFmadd_s: {
-      result = std::fma(a, b, c);
-      break;
+    // Zba / Zbb, the counts and byte swaps are single host instructions through the builtins
+    case AluOp::kSh1add: {
+      return {(a << 1) + b, false};
     }
-    case AluOp::kFmsub_s: {
-      result = std::fma(a, b, -c);
-      break;
+    case AluOp::kSh2add: {
+      return {(a << 2) + b, false};
     }
-    case AluOp::kFnmadd_s: {
-      result = std::fma(-a, b, -c);
-      break;
+    case AluOp::kSh3add: {
+      return {(a << 3) + b, false};
     }
-    case AluOp::kFnmsub_s: {
-      result = std::fma(-a, b, c);
-      break;
+    case AluOp::kAdduw: {
+      return {static_cast<uint64_t>(static_cast<uint32_t>(a)) + b, false};
     }
-    case AluOp::FADD_S: {
-      result = a + b;
-      break;
+    case AluOp::kSh1adduw: {
+      return {(static_cast<uint64_t>(static_cast<uint32_t>(a)) << 1) + b, false};
     }
-    case AluOp::FSUB_S: {
-      result = a - b;
-      break;
+    case AluOp::kSh2adduw: {
+      return {(static_cast<uint64_t>(static_cast<uint32_t>(a)) << 2) + b, false};
     }
-    case AluOp::FMUL_S: {
-      result = a * b;
-      break;
+    case AluOp::kSh3adduw: {
+      return {(static_cast<uint64_t>(static_cast<uint32_t>(a)) << 3) + b, false};
     }
-    case AluOp::FDIV_S: {
-      if (b == 0.0f) {
-        result = std::numeric_limits<float>::quiet_NaN();
-        fcsr |= FCSR_DIV_BY_ZERO;
-      } else {
-        result = a / b;
-      }
-      break;
+    case AluOp::kSlliuw: {
+      return {static_cast<uint64_t>(static_cast<uint32_t>(a)) << (b & 63), false};
     }
-    case AluOp::FSQRT_S: {
-      if (a < 0.0f) {
-        result = std::numeric_limits<float>::quiet_NaN();
-        fcsr |= FCSR_INVALID_OP;
-      } else {
-        result = std::sqrt(a);
-      }
-      break;
+    case AluOp::kAndn: {
+      return {a & ~b, false};
     }
-    case AluOp::FCVT_W_S: {
-      if (!std::isfinite(a) || a > static_cast<float>(INT32_MAX) || a < static_cast<float>(INT32_MIN)) {
-        fcsr |= FCSR_INVALID_OP;
-        fesetround(original_rm);
-        auto res = static_cast<int64_t>(static_cast<int32_t>(a > 0 ? INT32_MAX : INT32_MIN));
-        return {static_cast<uint64_t>(res), fcsr};
-      } else {
-        auto ires = static_cast<int32_t>(std::nearbyint(a));
-        auto res = static_cast<int64_t>(ires); // sign-extend
-        fesetround(original_rm);
-        return {static_cast<uint64_t>(res), fcsr};
-      }
-      break;
+    case AluOp::kOrn: {
+      return {a | ~b, false};
     }
-    case AluOp::FCVT_WU_S: {
-      if (!std::isfinite(a) || a > static_cast<float>(UINT32_MAX) || a < 0.0f) {
-        fcsr |= FCSR_INVALID_OP;
-        fesetround(original_rm);
-        uint32_t saturate = (a < 0.0f) ? 0 : UINT32_MAX;
-        auto res = static_cast<int64_t>(static_cast<int32_t>(saturate)); // sign-extend
-        return {static_cast<uint64_t>(res), fcsr};
-      } else {
-        auto ires = static_cast<uint32_t>(std::nearbyint(a));
-        auto res = static_cast<int64_t>(static_cast<int32_t>(ires)); // sign-extend
-        fesetround(original_rm);
-        return {static_cast<uint64_t>(res), fcsr};
-      }
-      break;
+    case AluOp::kXnor: {
+      return {~(a ^ b), false};
     }
-    case AluOp::FCVT_L_S: {
-      if (!std::isfinite(a) || a > static_cast<float>(INT64_MAX) || a < static_cast<float>(INT64_MIN)) {
-        fcsr |= FCSR_INVALID_OP;
-        fesetround(original_rm);
-        int64_t saturate = (a < 0.0f) ? INT64_MIN : INT64_MAX;
-        return {static_cast<uint64_t>(saturate), fcsr};
-      } else {
-        auto ires = static_cast<int64_t>(std::nearbyint(a));
-        fesetround(original_rm);
-        return {static_cast<uint64_t>(ires), fcsr};
-      }
-      break;
+    case AluOp::kClz: {
+      return {a == 0 ? 64 : static_cast<uint64_t>(__builtin_clzll(a)), false};
     }
-    case AluOp::FCVT_LU_S: {
-      if (!std::isfinite(a) || a > static_cast<float>(UINT64_MAX) || a < 0.0f) {
-        fcsr |= FCSR_INVALID_OP;
-        fesetround(original_rm);
-        uint64_t saturate = (a < 0.0f) ? 0 : UINT64_MAX;
-        return {saturate, fcsr};
-      } else {
-        auto ires = static_cast<uint64_t>(std::nearbyint(a));
-        fesetround(original_rm);
-        return {ires, fcsr};
-      }
-      break;
+    case AluOp::kClzw: {
+      auto sa = static_cast<uint32_t>(a);
+      return {sa == 0 ? 32 : static_cast<uint64_t>(__builtin_clz(sa)), false};
     }
-    case AluOp::FCVT_S_W: {
-      auto ia = static_cast<int32_t>(ina);
-      result = static_cast<float>(ia);
-      break;
-
+    case AluOp::kCtz: {
+      return {a == 0 ? 64 : static_cast<uint64_t>(__builtin_ctzll(a)), false};
     }
-    case AluOp::FCVT_S_WU: {
-      auto ua = static_cast<uint32_t>(ina);
-      result = static_cast<float>(ua);
-      break;
+    case AluOp::kCtzw: {
+      auto sa = static_cast<uint32_t>(a);
+      return {sa == 0 ? 32 : static_cast<uint64_t>(__builtin_ctz(sa)), false};
     }
-    case AluOp::FCVT_S_L: {
-      auto la = static_cast<int64_t>(ina);
-      result = static_cast<float>(la);
-      break;
-
+    case AluOp::kCpop: {
+      return {static_cast<uint64_t>(__builtin_popcountll(a)), false};
     }
-    case AluOp::FCVT_S_LU: {
-      auto ula = static_cast<uint64_t>(ina);
-      result = static_cast<float>(ula);
-      break;
+    case AluOp::kCpopw: {
+      return {static_cast<uint64_t>(__builtin_popcount(static_cast<uint32_t>(a))), false};
     }
-    case AluOp::FSGNJ_S: {
-      auto a_bits = static_cast<uint32_t>(ina);
-      auto b_bits = static_cast<uint32_t>(inb);
-      uint32_t temp = (a_bits & 0x7FFFFFFF) | (b_bits & 0x80000000);
-      std::memcpy(&result, &temp, sizeof(float));
-      break;
+    case AluOp::kMax: {
+      auto sa = static_cast<int64_t>(a);
+      auto sb = static_cast<int64_t>(b);
+      return {static_cast<uint64_t>(sa < sb ? sb : sa), false};
     }
-    case AluOp::FSGNJN_S: {
-      auto a_bits = static_cast<uint32_t>(ina);
-      auto b_bits = static_cast<uint32_t>(inb);
-      uint32_t temp = (a_bits & 0x7FFFFFFF) | (~b_bits & 0x80000000);
-      std::memcpy(&result, &temp, sizeof(float));
-      break;
+    case AluOp::kMaxu: {
+      return {a < b ? b : a, false};
     }
-    case AluOp::FSGNJX_S: {
-      auto a_bits = static_cast<uint32_t>(ina);
-      auto b_bits = static_cast<uint32_t>(inb);
-      uint32_t temp = (a_bits & 0x7FFFFFFF) | ((a_bits ^ b_bits) & 0x80000000);
-      std::memcpy(&result, &temp, sizeof(float));
-      break;
+    case AluOp::kMin: {
+      auto sa = static_cast<int64_t>(a);
+      auto sb = static_cast<int64_t>(b);
+      return {static_cast<uint64_t>(sa < sb ? sa : sb), false};
     }
-    case AluOp::FMIN_S: {
-      if (std::isnan(a) && !std::isnan(b)) {
-        result = b;
-      } else if (!std::isnan(a) && std::isnan(b)) {
-        result = a;
-      } else if (std::signbit(a)!=std::signbit(b) && a==b) {
-        result = -0.0f; // Both zero but with different signs — return -0.0
-      } else {
-        result = std::fmin(a, b);
-      }
-      break;
+    case AluOp::kMinu: {
+      return {a < b ? a : b, false};
     }
-    case AluOp::FMAX_S: {
-      if (std::isnan(a) && !std::isnan(b)) {
-        result = b;
-      } else if (!std::isnan(a) && std::isnan(b)) {
-        result = a;
-      } else if (std::signbit(a)!=std::signbit(b) && a==b) {
-        result = 0.0f; // Both zero but with different signs — return +0.0
-      } else {
-        result = std::fmax(a, b);
-      }
-      break;
+    case AluOp::kSextb: {
+      return {static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(a))), false};
     }
-    case AluOp::FEQ_S: {
-      if (std::isnan(a) || std::isnan(b)) {
-        result = 0.0f;
-      } else {
-        result = (a==b) ? 1.0f : 0.0f;
-        if (result == 1.0f) {
-          return {0b1,fcsr};
-        }
-      }
-      break;
+    case AluOp::kSexth: {
+      return {static_cast<uint64_t>(static_cast<int64_t>(static_cast<int16_t>(a))), false};
     }
-    case AluOp::FLT_S: {
-      if (std::isnan(a) || std::isnan(b)) {
-        result = 0.0f;
-      } else {
-        result = (a < b) ? 1.0f : 0.0f;
-        if (result == 1.0f) {
-          return {0b1,fcsr};
-        }
-      }
-      break;
+    case AluOp::kZexth: {
+      return {static_cast<uint64_t>(static_cast<uint16_t>(a)), false};
     }
-    case AluOp::FLE_S: {
-      if (std::isnan(a) || std::isnan(b)) {
-        result = 0.0f;
-      } else {
-        result = (a <= b) ? 1.0f : 0.0f;
-        if (result == 1.0f) {
-          return {0b1, fcsr};
-        }
-      }
-      break;
+    case AluOp::kRol: {
+      unsigned int shamt = b & 63;
+      return {(a << shamt) | (a >> ((64 - shamt) & 63)), false};
     }
-    case AluOp::FCLASS_S: {
-      auto a_bits = static_cast<uint32_t>(ina);
-      float af;
-      std::memcpy(&af, &a_bits, sizeof(float));
-      uint16_t res = 0;
-
-      if (std::signbit(af) && std::isinf(af)) res |= 1 << 0; // -inf
-      else if (std::signbit(af) && std::fpclassify(af)==FP_NORMAL) res |= 1 << 1; // -normal
-      else if (std::signbit(af) && std::fpclassify(af)==FP_SUBNORMAL) res |= 1 << 2; // -subnormal
-      else if (std::signbit(af) && af==0.0f) res |= 1 << 3; // -zero
-      else if (!std::signbit(af) && af==0.0f) res |= 1 << 4; // +zero
-      else if (!std::signbit(af) && std::fpclassify(af)==FP_SUBNORMAL) res |= 1 << 5; // +subnormal
-      else if (!std::signbit(af) && std::fpclassify(af)==FP_NORMAL) res |= 1 << 6; // +normal
-      else if (!std::signbit(af) && std::isinf(af)) res |= 1 << 7; // +inf
-      else if (std::isnan(af) && (a_bits & 0x00400000)==0) res |= 1 << 8; // signaling NaN
-      else if (std::isnan(af)) res |= 1 << 9; // quiet NaN
-
-      std::fesetround(original_rm);
-      // std::cout << "Class: " << decode_fclass(res) << "\n";
-
-
-      return {res, fcsr};
+    case AluOp::kRolw: {
+      auto sa = static_cast<uint32_t>(a);
+      unsigned int shamt = b & 31;
+      uint32_t result = (sa << shamt) | (sa >> ((32 - shamt) & 31));
+      return {static_cast<uint64_t>(static_cast<int32_t>(result)), false};
     }
-    case AluOp::FMV_X_W: {
-      int32_t float_bits;
-      std::memcpy(&float_bits, &ina, sizeof(float));
-      auto sign_extended = static_cast<int64_t>(float_bits);
-      return {static_cast<uint64_t>(sign_extended), fcsr};
-    }
-    case AluOp::FMV_W_X: {
-      auto int_bits = static_cast<uint32_t>(ina & 0xFFFFFFFF);
-      std::memcpy(&result, &int_bits, sizeof(float));
-      break;
+    case AluOp::kRor: {
+      unsigned int shamt = b & 63;
+      return {(a >> shamt) | (a << ((64 - shamt) & 63)), false};
     }
-    default: break;
+    case AluOp::kRorw: {
+      auto sa = static_cast<uint32_t>(a);
+      unsigned int shamt = b & 31;
+      uint32_t result = (sa >> shamt) | (sa << ((32 - shamt) & 31));
+      return {static_cast<uint64_t>(static_cast<int32_t>(result)), false};
+    }
+    case AluOp::kOrcb: {
+      // fold every byte into its low bit, then widen each set low bit back to the whole byte
+      uint64_t folded = a | (a >> 1);
+      folded |= folded >> 2;
+      folded |= folded >> 4;
+      return {(folded & 0x0101010101010101) * 0xff, false};
+    }
+    case AluOp::kRev8: {
+      return {__builtin_bswap64(a), false};
+    }
+    default: return {0, false};
   }
+}
 
-  int raised = std::fetestexcept(FE_ALL_EXCEPT);
-  if (raised & FE_INVALID) fcsr |= FCSR_INVALID_OP;
-  if (raised & FE_DIVBYZERO) fcsr |= FCSR_DIV_BY_ZERO;
-  if (raised & FE_OVERFLOW) fcsr |= FCSR_OVERFLOW;
-  if (raised & FE_UNDERFLOW) fcsr |= FCSR_UNDERFLOW;
-  if (raised & FE_INEXACT) fcsr |= FCSR_INEXACT;
+namespace {
 
-  std::fesetround(original_rm);
+constexpr uint64_t kBoxMask = 0xFFFFFFFF00000000;
+constexpr uint32_t kSignBit32 = 0x80000000;
+constexpr uint64_t kSignBit64 = 0x8000000000000000;
 
-  uint32_t result_bits = 0;
-  std::memcpy(&result_bits, &result, sizeof(result));
-  return {static_cast<uint64_t>(result_bits), fcsr};
+// a single precision operand that is not NaN-boxed reads as the canonical NaN
+uint32_t unbox(uint64_t value) {
+  return (value & kBoxMask) == kBoxMask ? static_cast<uint32_t>(value) : softfloat::kDefaultNaN32;
 }
 
-[[nodiscard]] std::pair<uint64_t, bool> Alu::dfpexecute(AluOp op,
-                                                        uint64_t ina,
-                                                        uint64_t inb,
-                                                        uint64_t inc,
-                                                        uint8_t rm) {
-  double a, b, c;
-  std::memcpy(&a, &ina, sizeof(double));
-  std::memcpy(&b, &inb, sizeof(double));
-  std::memcpy(&c, &inc, sizeof(double));
-  double result = 0.0;
+uint64_t box(uint32_t value) {
+  return kBoxMask | value;
+}
 
-  uint8_t fcsr = 0;
+template <typename T> struct HostFormat;
+template <> struct HostFormat<float> {
+  using bits_t = uint32_t;
+  static constexpr int kFracBits = 23;
+  static constexpr int kMaxExp = 0xff;
+};
+template <> struct HostFormat<double> {
+  using bits_t = uint64_t;
+  static constexpr int kFracBits = 52;
+  static constexpr int kMaxExp = 0x7ff;
+};
+
+// Exponent field far enough from the subnormal range that the error terms below are exact, and from overflow.
+template <typename T>
+bool inHostRange(typename HostFormat<T>::bits_t bits) {
+  int exp = static_cast<int>((bits >> HostFormat<T>::kFracBits) & HostFormat<T>::kMaxExp);
+  return exp >= HostFormat<T>::kFracBits + 3 && exp <= HostFormat<T>::kMaxExp - 2;
+}
 
-  int original_rm = std::fegetround();
-
-  switch (rm) {
-    case 0b000: std::fesetround(FE_TONEAREST);
-      break;  // RNE
-    case 0b001: std::fesetround(FE_TOWARDZERO);
-      break; // RTZ
-    case 0b010: std::fesetround(FE_DOWNWARD);
-      break;   // RDN
-    case 0b011: std::fesetround(FE_UPWARD);
-      break;     // RUP
-      // 0b100 RMM, unsupported
-    default: break;
+enum class FpArith { kAdd, kSub, kMul, kDiv, kSqrt };
+
+// RNE arithmetic on operands and results inside the host range runs on the host FPU, which rounds there exactly like
+// the soft engine. The only flag such an operation raises is inexact, read from the exact error of the result
+// (TwoSum, or an fma for the rest) instead of the host FPU status. Anything else goes to the soft engine.
+template <typename T>
+bool hostArith(FpArith kind, typename HostFormat<T>::bits_t a, typename HostFormat<T>::bits_t b,
+               typename HostFormat<T>::bits_t &result, uint8_t &flags) {
+  using Bits = typename HostFormat<T>::bits_t;
+  if (!inHostRange<T>(a) || (kind != FpArith::kSqrt && !inHostRange<T>(b))) {
+    return false;
   }
+  T x, y, r, error;
+  std::memcpy(&x, &a, sizeof(T));
+  std::memcpy(&y, &b, sizeof(T));
+  switch (kind) {
+    case FpArith::kSub:
+      y = -y;
+      [[fallthrough]];
+    case FpArith::kAdd: {
+      r = x + y;
+      T y_part = r - x;
+      error = (x - (r - y_part)) + (y - y_part);
+      break;
+    }
+    case FpArith::kMul:
+      r = x * y;
+      error = std::fma(x, y, -r);
+      break;
+    case FpArith::kDiv:
+      r = x / y;
+      error = std::fma(-r, y, x);
+      break;
+    case FpArith::kSqrt:
+      if (std::signbit(x)) {
+        return false;
+      }
+      r = std::sqrt(x);
+      error = std::fma(-r, r, x);
+      break;
+  }
+  Bits bits;
+  std::memcpy(&bits, &r, sizeof(T));
+  if (!inHostRange<T>(bits)) {
+    return false;
+  }
+  if (error != 0) {
+    flags |= FCSR_INEXACT;
+  }
+  result = bits;
+  return true;
+}
 
-  std::feclearexcept(FE_ALL_EXCEPT);
+uint32_t arith32(FpArith kind, uint32_t a, uint32_t b, uint8_t rm, bool soft, uint8_t &flags) {
+  uint32_t result;
+  if (!soft && rm == softfloat::kRoundNearestEven && hostArith<float>(kind, a, b, result, flags)) {
+    return result;
+  }
+  switch (kind) {
+    case FpArith::kAdd: return softfloat::f32Add(a, b, rm, flags);
+    case FpArith::kSub: return softfloat::f32Sub(a, b, rm, flags);
+    case FpArith::kMul: return softfloat::f32Mul(a, b, rm, flags);
+    case FpArith::kDiv: return softfloat::f32Div(a, b, rm, flags);
+    case FpArith::kSqrt: return softfloat::f32Sqrt(a, rm, flags);
+  }
+  return softfloat::kDefaultNaN32;
+}
+
+uint64_t arith64(FpArith kind, uint64_t a, uint64_t b, uint8_t rm, bool soft, uint8_t &flags) {
+  uint64_t result;
+  if (!soft && rm == softfloat::kRoundNearestEven && hostArith<double>(kind, a, b, result, flags)) {
+    return result;
+  }
+  switch (kind) {
+    case FpArith::kAdd: return softfloat::f64Add(a, b, rm, flags);
+    case FpArith::kSub: return softfloat::f64Sub(a, b, rm, flags);
+    case FpArith::kMul: return softfloat::f64Mul(a, b, rm, flags);
+    case FpArith::kDiv: return softfloat::f64Div(a, b, rm, flags);
+    case FpArith::kSqrt: return softfloat::f64Sqrt(a, rm, flags);
+  }
+  return softfloat::kDefaultNaN64;
+}
+
+} // namespace
+
+[[nodiscard]] std::pair<uint64_t, uint8_t> Alu::fpexecute(AluOp op,
+                                                          uint64_t ina,
+                                                          uint64_t inb,
+                                                          uint64_t inc,
+                                                          uint8_t rm) const {
+  uint8_t fcsr = 0;
+  // single precision operands, the double precision ones are used as they are
+  uint32_t a = unbox(ina);
+  uint32_t b = unbox(inb);
+  uint32_t c = unbox(inc);
 
   switch (op) {
     case AluOp::kAdd: {
-      auto sa = static_cast<int64_t>(ina);
-      auto sb = static_cast<int64_t>(inb);
-      int64_t res = sa + sb;
-      // bool overflow = __builtin_add_overflow(sa, sb, &res); // TODO: check this
-      return {static_cast<uint64_t>(res), 0};
-    }
-    case AluOp::FMADD_D: {
-      result = std::fma(a, b, c);
-      break;
-    }
-    case AluOp::FMSUB_D: {
-      result = std::fma(a, b, -c);
-      break;
-    }
-    case AluOp::FNMADD_D: {
-      result = std::fma(-a, b, -c);
-      break;
-    }
-    case AluOp::FNMSUB_D: {
-      result = std::fma(-a, b, c);
-      break;
-    }
-    case AluOp::FADD_D: {
-      result = a + b;
-      break;
-    }
-    case AluOp::FSUB_D: {
-      result = a - b;
-      break;
-    }
-    case AluOp::FMUL_D: {
-      result = a * b;
-      break;
-    }
-    case AluOp::FDIV_D: {
-      if (b == 0.0) {
-        result = std::numeric_limits<double>::quiet_NaN();
-        fcsr |= FCSR_DIV_BY_ZERO;
-      } else {
-        result = a / b;
-      }
-      break;
-    }
-    case AluOp::FSQRT_D: {
-      if (a < 0.0) {
-        result = std::numeric_limits<double>::quiet_NaN();
-        fcsr |= FCSR_INVALID_OP;
-      } else {
-        result = std::sqrt(a);
-      }
-      break;
-    }
-    case AluOp::FCVT_W_D: {
-      if (!std::isfinite(a) || a > static_cast<double>(INT32_MAX) || a < static_cast<double>(INT32_MIN)) {
-        fcsr |= FCSR_INVALID_OP;
-        fesetround(original_rm);
-        int32_t saturate = (a < 0.0) ? INT32_MIN : INT32_MAX;
-        auto res = static_cast<int64_t>(saturate); // sign-extend to XLEN
-        return {static_cast<uint64_t>(res), fcsr};
-      } else {
-        auto ires = static_cast<int32_t>(std::nearbyint(a));
-        auto res = static_cast<int64_t>(ires); // sign-extend to XLEN
-        fesetround(original_rm);
-        return {static_cast<uint64_t>(res), fcsr};
-      }
-      break;
-    }
-    case AluOp::FCVT_WU_D: {
-      if (!std::isfinite(a) || a > static_cast<double>(UINT32_MAX) || a < 0.0) {
-        fcsr |= FCSR_INVALID_OP;
-        fesetround(original_rm);
-        uint32_t saturate = (a < 0.0) ? 0 : UINT32_MAX;
-        auto res = static_cast<int64_t>(static_cast<int32_t>(saturate)); // sign-extend per spec
-        return {static_cast<uint64_t>(res), fcsr};
-      } else {
-        auto ires = static_cast<uint32_t>(std::nearbyint(a));
-        auto res = static_cast<int64_t>(static_cast<int32_t>(ires)); // sign-extend
-        fesetround(original_rm);
-        return {static_cast<uint64_t>(res), fcsr};
-      }
-      break;
-    }
-    case AluOp::FCVT_L_D: {
-      if (!std::isfinite(a) || a > static_cast<double>(INT64_MAX) || a < static_cast<double>(INT64_MIN)) {
-        fcsr |= FCSR_INVALID_OP;
-        fesetround(original_rm);
-        int64_t saturate = (a < 0.0) ? INT64_MIN : INT64_MAX;
-        return {static_cast<uint64_t>(saturate), fcsr};
-      } else {
-        auto ires = static_cast<int64_t>(std::nearbyint(a));
-        fesetround(original_rm);
-        return {static_cast<uint64_t>(ires), fcsr};
-      }
-      break;
-    }
-    case AluOp::FCVT_LU_D: {
-      if (!std::isfinite(a) || a > static_cast<double>(UINT64_MAX) || a < 0.0) {
-        fcsr |= FCSR_INVALID_OP;
-        fesetround(original_rm);
-        uint64_t saturate = (a < 0.0) ? 0 : UINT64_MAX;
-        return {saturate, fcsr};
-      } else {
-        auto ires = static_cast<uint64_t>(std::nearbyint(a));
-        fesetround(original_rm);
-        return {ires, fcsr};
-      }
-      break;
-    }
-    case AluOp::FCVT_D_W: {
-      auto ia = static_cast<int32_t>(ina);
-      result = static_cast<double>(ia);
-      break;
-
+      // address of a fp load / store
+      return {ina + inb, 0};
+    }
+    case AluOp::kFmadd_s: return {box(softfloat::f32MulAdd(a, b, c, rm, fcsr)), fcsr};
+    case AluOp::kFmsub_s: return {box(softfloat::f32MulAdd(a, b, c ^ kSignBit32, rm, fcsr)), fcsr};
+    case AluOp::kFnmadd_s: return {box(softfloat::f32MulAdd(a ^ kSignBit32, b, c ^ kSignBit32, rm, fcsr)), fcsr};
+    case AluOp::kFnmsub_s: return {box(softfloat::f32MulAdd(a ^ kSignBit32, b, c, rm, fcsr)), fcsr};
+
+    case AluOp::FADD_S: return {box(arith32(FpArith::kAdd, a, b, rm, soft_float_, fcsr)), fcsr};
+    case AluOp::FSUB_S: return {box(arith32(FpArith::kSub, a, b, rm, soft_float_, fcsr)), fcsr};
+    case AluOp::FMUL_S: return {box(arith32(FpArith::kMul, a, b, rm, soft_float_, fcsr)), fcsr};
+    case AluOp::FDIV_S: return {box(arith32(FpArith::kDiv, a, b, rm, soft_float_, fcsr)), fcsr};
+    case AluOp::FSQRT_S: return {box(arith32(FpArith::kSqrt, a, b, rm, soft_float_, fcsr)), fcsr};
+
+    case AluOp::FSGNJ_S: return {box((a & ~kSignBit32) | (b & kSignBit32)), fcsr};
+    case AluOp::FSGNJN_S: return {box((a & ~kSignBit32) | (~b & kSignBit32)), fcsr};
+    case AluOp::FSGNJX_S: return {box(a ^ (b & kSignBit32)), fcsr};
+    case AluOp::FMIN_S: return {box(softfloat::f32Min(a, b, fcsr)), fcsr};
+    case AluOp::FMAX_S: return {box(softfloat::f32Max(a, b, fcsr)), fcsr};
+    case AluOp::FEQ_S: return {softfloat::f32Eq(a, b, fcsr), fcsr};
+    case AluOp::FLT_S: return {softfloat::f32Lt(a, b, fcsr), fcsr};
+    case AluOp::FLE_S: return {softfloat::f32Le(a, b, fcsr), fcsr};
+    case AluOp::FCLASS_S: return {softfloat::f32Classify(a), fcsr};
+
+    case AluOp::FCVT_W_S: return {softfloat::f32ToI32(a, rm, fcsr), fcsr};
+    case AluOp::FCVT_WU_S: return {softfloat::f32ToUi32(a, rm, fcsr), fcsr};
+    case AluOp::FCVT_L_S: return {softfloat::f32ToI64(a, rm, fcsr), fcsr};
+    case AluOp::FCVT_LU_S: return {softfloat::f32ToUi64(a, rm, fcsr), fcsr};
+
+    // the integer source is rs1 of the integer register file
+    case AluOp::FCVT_S_W: {
+      return {box(softfloat::i64ToF32(static_cast<int32_t>(ina), rm, fcsr)), fcsr};
     }
-    case AluOp::FCVT_D_WU: {
-      auto ua = static_cast<uint32_t>(ina);
-      result = static_cast<double>(ua);
-      break;
+    case AluOp::FCVT_S_WU: {
+      return {box(softfloat::ui64ToF32(static_cast<uint32_t>(ina), rm, fcsr)), fcsr};
     }
-    case AluOp::FCVT_D_L: {
-      auto la = static_cast<int64_t>(ina);
-      result = static_cast<double>(la);
-      break;
+    case AluOp::FCVT_S_L: return {box(softfloat::i64ToF32(static_cast<int64_t>(ina), rm, fcsr)), fcsr};
+    case AluOp::FCVT_S_LU: return {box(softfloat::ui64ToF32(ina, rm, fcsr)), fcsr};
 
-    }
-    case AluOp::FCVT_S_LU: {
-      auto ula = static_cast<uint64_t>(ina);
-      result = static_cast<double>(ula);
-      break;
-    }
-    case AluOp::FSGNJ_D: {
-      auto a_bits = static_cast<uint64_t>(ina);
-      auto b_bits = static_cast<uint64_t>(inb);
-      uint64_t temp = (a_bits & 0x7FFFFFFFFFFFFFFF) | (b_bits & 0x8000000000000000);
-      std::memcpy(&result, &temp, sizeof(double));
-      break;
-    }
-    case AluOp::FSGNJN_D: {
-      auto a_bits = static_cast<uint64_t>(ina);
-      auto b_bits = static_cast<uint64_t>(inb);
-      uint64_t temp = (a_bits & 0x7FFFFFFFFFFFFFFF) | (~b_bits & 0x8000000000000000);
-      std::memcpy(&result, &temp, sizeof(double));
-      break;
-    }
-    case AluOp::FSGNJX_D: {
-      auto a_bits = static_cast<uint64_t>(ina);
-      auto b_bits = static_cast<uint64_t>(inb);
-      uint64_t temp = (a_bits & 0x7FFFFFFFFFFFFFFF) | ((a_bits ^ b_bits) & 0x8000000000000000);
-      std::memcpy(&result, &temp, sizeof(double));
-      break;
-    }
-    case AluOp::FMIN_D: {
-      if (std::isnan(a) && !std::isnan(b)) {
-        result = b;
-      } else if (!std::isnan(a) && std::isnan(b)) {
-        result = a;
-      } else if (std::signbit(a)!=std::signbit(b) && a==b) {
-        result = -0.0; // Both zero but with different signs — return -0.0
-      } else {
-        result = std::fmin(a, b);
-      }
-      break;
-    }
-    case AluOp::FMAX_D: {
-      if (std::isnan(a) && !std::isnan(b)) {
-        result = b;
-      } else if (!std::isnan(a) && std::isnan(b)) {
-        result = a;
-      } else if (std::signbit(a)!=std::signbit(b) && a==b) {
-        result = 0.0; // Both zero but with different signs — return +0.0
-      } else {
-        result = std::fmax(a, b);
-      }
-      break;
-    }
-    case AluOp::FEQ_D: {
-      if (std::isnan(a) || std::isnan(b)) {
-        result = 0.0;
-      } else {
-        result = (a==b) ? 1.0 : 0.0;
-        if (result == 1.0) {
-          return {0b1,fcsr};
-        }
-      }
-      break;
-    }
-    case AluOp::FLT_D: {
-      if (std::isnan(a) || std::isnan(b)) {
-        result = 0.0;
-      } else {
-        result = (a < b) ? 1.0 : 0.0;
-        if (result == 1.0) {
-          return {0b1,fcsr};
-        }
-      }
-      break;
-    }
-    case AluOp::FLE_D: {
-      if (std::isnan(a) || std::isnan(b)) {
-        result = 0.0;
-      } else {
-        result = (a <= b) ? 1.0 : 0.0;
-        if (result == 1.0) {
-          return {0b1,fcsr};
-        }
-      }
-      break;
-    }
-    case AluOp::FCLASS_D: {
-      uint64_t a_bits = ina;
-      double af;
-      std::memcpy(&af, &a_bits, sizeof(double));
-      uint16_t res = 0;
-
-      if (std::signbit(af) && std::isinf(af)) res |= 1 << 0; // -inf
-      else if (std::signbit(af) && std::fpclassify(af)==FP_NORMAL) res |= 1 << 1; // -normal
-      else if (std::signbit(af) && std::fpclassify(af)==FP_SUBNORMAL) res |= 1 << 2; // -subnormal
-      else if (std::signbit(af) && af==0.0) res |= 1 << 3; // -zero
-      else if (!std::signbit(af) && af==0.0) res |= 1 << 4; // +zero
-      else if (!std::signbit(af) && std::fpclassify(af)==FP_SUBNORMAL) res |= 1 << 5; // +subnormal
-      else if (!std::signbit(af) && std::fpclassify(af)==FP_NORMAL) res |= 1 << 6; // +normal
-      else if (!std::signbit(af) && std::isinf(af)) res |= 1 << 7; // +inf
-      else if (std::isnan(af) && (a_bits & 0x0008000000000000)==0) res |= 1 << 8; // signaling NaN
-      else if (std::isnan(af)) res |= 1 << 9; // quiet NaN
-
-      std::fesetround(original_rm);
-      return {res, fcsr};
-    }
-    case AluOp::FCVT_D_S: {
-      auto fa = static_cast<float>(ina);
-      result = static_cast<double>(fa);
-      break;
-    }
-    case AluOp::FCVT_S_D: {
-      auto da = static_cast<double>(ina);
-      result = static_cast<float>(da);
-      break;
-    }
-    case AluOp::FMV_D_X: {
-      uint64_t double_bits;
-      std::memcpy(&double_bits, &ina, sizeof(double));
-      return {double_bits, fcsr};
-    }
-    case AluOp::FMV_X_D: {
-      uint64_t int_bits = ina & 0xFFFFFFFFFFFFFFFF;
-      double out;
-      std::memcpy(&out, &int_bits, sizeof(double));
-      result = out;
-      break;
-    }
+    case AluOp::FMV_X_W: {
+      // raw low 32 bits, sign-extended
+      return {static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(ina))), fcsr};
+    }
+    case AluOp::FMV_W_X: return {box(static_cast<uint32_t>(ina)), fcsr};
+
+    case AluOp::FMADD_D: return {softfloat::f64MulAdd(ina, inb, inc, rm, fcsr), fcsr};
+    case AluOp::FMSUB_D: return {softfloat::f64MulAdd(ina, inb, inc ^ kSignBit64, rm, fcsr), fcsr};
+    case AluOp::FNMADD_D: return {softfloat::f64MulAdd(ina ^ kSignBit64, inb, inc ^ kSignBit64, rm, fcsr), fcsr};
+    case AluOp::FNMSUB_D: return {softfloat::f64MulAdd(ina ^ kSignBit64, inb, inc, rm, fcsr), fcsr};
+
+    case AluOp::FADD_D: return {arith64(FpArith::kAdd, ina, inb, rm, soft_float_, fcsr), fcsr};
+    case AluOp::FSUB_D: return {arith64(FpArith::kSub, ina, inb, rm, soft_float_, fcsr), fcsr};
+    case AluOp::FMUL_D: return {arith64(FpArith::kMul, ina, inb, rm, soft_float_, fcsr), fcsr};
+    case AluOp::FDIV_D: return {arith64(FpArith::kDiv, ina, inb, rm, soft_float_, fcsr), fcsr};
+    case AluOp::FSQRT_D: return {arith64(FpArith::kSqrt, ina, inb, rm, soft_float_, fcsr), fcsr};
+
+    case AluOp::FSGNJ_D: return {(ina & ~kSignBit64) | (inb & kSignBit64), fcsr};
+    case AluOp::FSGNJN_D: return {(ina & ~kSignBit64) | (~inb & kSignBit64), fcsr};
+    case AluOp::FSGNJX_D: return {ina ^ (inb & kSignBit64), fcsr};
+    case AluOp::FMIN_D: return {softfloat::f64Min(ina, inb, fcsr), fcsr};
+    case AluOp::FMAX_D: return {softfloat::f64Max(ina, inb, fcsr), fcsr};
+    case AluOp::FEQ_D: return {softfloat::f64Eq(ina, inb, fcsr), fcsr};
+    case AluOp::FLT_D: return {softfloat::f64Lt(ina, inb, fcsr), fcsr};
+    case AluOp::FLE_D: return {softfloat::f64Le(ina, inb, fcsr), fcsr};
+    case AluOp::FCLASS_D: return {softfloat::f64Classify(ina), fcsr};
+
+    case AluOp::FCVT_W_D: return {softfloat::f64ToI32(ina, rm, fcsr), fcsr};
+    case AluOp::FCVT_WU_D: return {softfloat::f64ToUi32(ina, rm, fcsr), fcsr};
+    case AluOp::FCVT_L_D: return {softfloat::f64ToI64(ina, rm, fcsr), fcsr};
+    case AluOp::FCVT_LU_D: return {softfloat::f64ToUi64(ina, rm, fcsr), fcsr};
+
+    case AluOp::FCVT_D_W: return {softfloat::i64ToF64(static_cast<int32_t>(ina), rm, fcsr), fcsr};
+    case AluOp::FCVT_D_WU: return {softfloat::ui64ToF64(static_cast<uint32_t>(ina), rm, fcsr), fcsr};
+    case AluOp::FCVT_D_L: return {softfloat::i64ToF64(static_cast<int64_t>(ina), rm, fcsr), fcsr};
+    case AluOp::FCVT_D_LU: return {softfloat::ui64ToF64(ina, rm, fcsr), fcsr};
+
+    case AluOp::FCVT_S_D: return {box(softfloat::f64ToF32(ina, rm, fcsr)), fcsr};
+    case AluOp::FCVT_D_S: return {softfloat::f32ToF64(a, fcsr), fcsr};
+
+    // raw moves between the register files
+    case AluOp::FMV_D_X:
+    case AluOp::FMV_X_D: return {ina, fcsr};
     default: break;
   }
-
-  int raised = std::fetestexcept(FE_ALL_EXCEPT);
-  if (raised & FE_INVALID) fcsr |= FCSR_INVALID_OP;
-  if (raised & FE_DIVBYZERO) fcsr |= FCSR_DIV_BY_ZERO;
-  if (raised & FE_OVERFLOW) fcsr |= FCSR_OVERFLOW;
-  if (raised & FE_UNDERFLOW) fcsr |= FCSR_UNDERFLOW;
-  if (raised & FE_INEXACT) fcsr |= FCSR_INEXACT;
-
-  std::fesetround(original_rm);
-
-  uint64_t result_bits = 0;
-  std::memcpy(&result_bits, &result, sizeof(result));
-  return {result_bits, fcsr};
+  return {0, fcsr};
 }
 
 void Alu::setFlags(bool carry, bool zero, bool negative, bool overflow) {
@@ -0,0 +1,154 @@
+/**
+ * @file atomic_unit.cpp
+ * @brief RV64A on the memory controller, host std::atomic_ref when the memory is shared between harts
+ */
+
+#include "vm/atomic_unit.h"
+
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
+namespace atomic_unit {
+namespace {
+
+// funct7[6:2]
+enum Funct5 : uint32_t {
+    kAmoAdd = 0b00000,
+    kAmoSwap = 0b00001,
+    kLr = 0b00010,
+    kSc = 0b00011,
+    kAmoXor = 0b00100,
+    kAmoOr = 0b01000,
+    kAmoAnd = 0b01100,
+    kAmoMin = 0b10000,
+    kAmoMax = 0b10100,
+    kAmoMinu = 0b11000,
+    kAmoMaxu = 0b11100,
+};
+
+template <typename T>
+T combine(uint32_t funct5, T old_value, T operand) {
+    using S = std::make_signed_t<T>;
+    switch (funct5) {
+        case kAmoSwap: return operand;
+        case kAmoAdd: return old_value + operand;
+        case kAmoXor: return old_value ^ operand;
+        case kAmoOr: return old_value | operand;
+        case kAmoAnd: return old_value & operand;
+        case kAmoMin: return static_cast<S>(old_value) < static_cast<S>(operand) ? old_value : operand;
+        case kAmoMax: return static_cast<S>(old_value) > static_cast<S>(operand) ? old_value : operand;
+        case kAmoMinu: return old_value < operand ? old_value : operand;
+        case kAmoMaxu: return old_value > operand ? old_value : operand;
+        default: return old_value;
+    }
+}
+
+bool holds(const Reservation &reservation, uint64_t address, unsigned int bytes) {
+    return reservation.bytes == bytes && reservation.address == address;
+}
+
+template <typename T>
+T read(MemoryController &memory, uint64_t address) {
+    if constexpr (sizeof(T) == 4) {
+        return memory.ReadWord(address);
+    } else {
+        return memory.ReadDoubleWord(address);
+    }
+}
+
+template <typename T>
+void write(MemoryController &memory, uint64_t address, T value) {
+    if constexpr (sizeof(T) == 4) {
+        memory.WriteWord(address, value);
+    } else {
+        memory.WriteDoubleWord(address, value);
+    }
+}
+
+// a single hart, nothing else writes the memory between the read and the write
+template <typename T>
+T executeSequential(uint32_t funct5, uint64_t address, T operand, MemoryController &memory, Reservation &reservation) {
+    T old_value = read<T>(memory, address);
+    switch (funct5) {
+        case kLr:
+            reservation = {address, old_value, sizeof(T)};
+            return old_value;
+        case kSc: {
+            bool held = holds(reservation, address, sizeof(T)) && old_value == static_cast<T>(reservation.value);
+            reservation = {};
+            if (!held) {
+                return 1;
+            }
+            write<T>(memory, address, operand);
+            return 0;
+        }
+        default:
+            write<T>(memory, address, combine(funct5, old_value, operand));
+            return old_value;
+    }
+}
+
+// harts sharing the memory. Every store to it counts in the reservation stripe of its granule under the stripe lock,
+// which the atomics hold as well: sc fails once any store reached the granule since the lr, even one that put the
+// loaded value back (ABA). A store to another granule of the same stripe fails it too, as a larger reservation set would.
+template <typename T>
+T executeShared(uint32_t funct5, T &word, uint64_t address, T operand, ReservationStripe &stripe,
+                Reservation &reservation) {
+    std::atomic_ref<T> ref(word);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    T old_value = ref.load();
+    switch (funct5) {
+        case kLr:
+            reservation = {address, old_value, sizeof(T), stripe.stores};
+            return old_value;
+        case kSc: {
+            bool held = holds(reservation, address, sizeof(T)) && reservation.stores == stripe.stores;
+            reservation = {};
+            if (!held) {
+                return 1;
+            }
+            ref.store(operand);
+            ++stripe.stores;
+            return 0;
+        }
+        default:
+            ref.store(combine(funct5, old_value, operand));
+            ++stripe.stores;
+            return old_value;
+    }
+}
+
+template <typename T>
+T executeWidth(uint32_t funct5, uint64_t address, T operand, MemoryController &memory, Reservation &reservation) {
+    if (memory.IsShared()) {
+        uint8_t *host = memory.HostBytes(address, sizeof(T));
+        if (host && reinterpret_cast<uintptr_t>(host) % std::atomic_ref<T>::required_alignment == 0) {
+            return executeShared<T>(funct5, *reinterpret_cast<T *>(host), address, operand,
+                                    *memory.Reservations(address), reservation);
+        }
+    }
+    // misaligned accesses fall back to the read-modify-write, out of range ones throw from it like the loads and stores
+    return executeSequential<T>(funct5, address, operand, memory, reservation);
+}
+
+} // namespace
+
+uint8_t operation(uint32_t instruction) {
+    return static_cast<uint8_t>(instruction >> 27);
+}
+
+unsigned int accessBytes(uint32_t instruction) {
+    return ((instruction >> 12) & 0b111) == 0b011 ? 8 : 4;
+}
+
+uint64_t execute(uint8_t operation, unsigned int bytes, uint64_t address, uint64_t rs2_value, MemoryController &memory,
+                 Reservation &reservation) {
+    if (bytes == 8) {
+        return executeWidth<uint64_t>(operation, address, rs2_value, memory, reservation);
+    }
+    uint32_t result = executeWidth<uint32_t>(operation, address, static_cast<uint32_t>(rs2_value), memory, reservation);
+    return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(result)));
+}
+
+} // namespace atomic_unit
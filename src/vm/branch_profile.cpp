@@ -0,0 +1,176 @@
+/**
+ * @file branch_profile.cpp
+ * @brief Implementation of the per-branch profile and its JSON/CSV/disassembly reports
+ */
+
+#include "vm/branch_profile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr const char *kAnnotationMarker = "    # branch:";
+
+// source line of the instruction at pc, 0 if the program carries no mapping for it
+unsigned int SourceLine(const AssembledProgram &program, uint64_t pc) {
+    auto it = program.instruction_number_line_number_mapping.find(program.InstructionNumber(pc));
+    return it == program.instruction_number_line_number_mapping.end() ? 0 : it->second;
+}
+
+std::string Disassembly(const AssembledProgram &program, uint64_t pc) {
+    uint64_t index = program.InstructionNumber(pc);
+    if (index >= program.intermediate_code.size()) {
+        return "";
+    }
+    std::ostringstream oss;
+    oss << program.intermediate_code[index].first;
+    return oss.str();
+}
+
+std::string EscapeJson(const std::string &text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+double TakenRate(const BranchStats &stats) {
+    return stats.executions ? 100.0 * static_cast<double>(stats.taken) / static_cast<double>(stats.executions) : 0.0;
+}
+
+} // namespace
+
+void BranchProfile::Record(uint64_t pc, bool taken, bool mispredicted, unsigned int penalty_cycles) {
+    BranchStats &stats = stats_[pc];
+    stats.executions++;
+    if (taken) {
+        stats.taken++;
+    }
+    if (mispredicted) {
+        stats.mispredictions++;
+        stats.cycles_lost += penalty_cycles;
+    }
+}
+
+void BranchProfile::Clear() {
+    stats_.clear();
+}
+
+void BranchProfile::Restore(uint64_t pc, bool profiled, const BranchStats &stats) {
+    if (profiled) {
+        stats_[pc] = stats;
+    } else {
+        stats_.erase(pc);
+    }
+}
+
+bool BranchProfile::Empty() const {
+    return stats_.empty();
+}
+
+const std::unordered_map<uint64_t, BranchStats> &BranchProfile::GetStats() const {
+    return stats_;
+}
+
+std::vector<std::pair<uint64_t, BranchStats>> BranchProfile::Sorted() const {
+    std::vector<std::pair<uint64_t, BranchStats>> sorted(stats_.begin(), stats_.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        if (a.second.cycles_lost != b.second.cycles_lost) return a.second.cycles_lost > b.second.cycles_lost;
+        if (a.second.mispredictions != b.second.mispredictions) return a.second.mispredictions > b.second.mispredictions;
+        if (a.second.executions != b.second.executions) return a.second.executions > b.second.executions;
+        return a.first < b.first;
+    });
+    return sorted;
+}
+
+void BranchProfile::DumpJson(const std::filesystem::path &filename, const AssembledProgram &program) const {
+    std::ofstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Unable to open file: " + filename.string());
+    }
+
+    std::vector<std::pair<uint64_t, BranchStats>> sorted = Sorted();
+    file << "{\n";
+    file << "  \"branches\": [\n";
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const auto &[pc, stats] = sorted[i];
+        file << "    {"
+             << "\"pc\": \"0x" << std::hex << pc << std::dec << "\", "
+             << "\"line\": " << SourceLine(program, pc) << ", "
+             << "\"instruction\": \"" << EscapeJson(Disassembly(program, pc)) << "\", "
+             << "\"executions\": " << stats.executions << ", "
+             << "\"taken\": " << stats.taken << ", "
+             << "\"taken_rate\": " << std::fixed << std::setprecision(2) << TakenRate(stats) << std::defaultfloat << ", "
+             << "\"mispredictions\": " << stats.mispredictions << ", "
+             << "\"cycles_lost\": " << stats.cycles_lost
+             << "}" << (i + 1 < sorted.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+}
+
+void BranchProfile::DumpCsv(const std::filesystem::path &filename, const AssembledProgram &program) const {
+    std::ofstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Unable to open file: " + filename.string());
+    }
+
+    file << "pc,line,instruction,executions,taken,taken_rate,mispredictions,cycles_lost\n";
+    for (const auto &[pc, stats] : Sorted()) {
+        file << "0x" << std::hex << pc << std::dec << ","
+             << SourceLine(program, pc) << ","
+             << "\"" << Disassembly(program, pc) << "\","
+             << stats.executions << ","
+             << stats.taken << ","
+             << std::fixed << std::setprecision(2) << TakenRate(stats) << std::defaultfloat << ","
+             << stats.mispredictions << ","
+             << stats.cycles_lost << "\n";
+    }
+}
+
+void BranchProfile::AnnotateDisassembly(const std::filesystem::path &filename, const AssembledProgram &program) const {
+    std::ifstream in(filename);
+    if (!in) {
+        throw std::runtime_error("Unable to open disassembly file: " + filename.string());
+    }
+
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t marker = line.find(kAnnotationMarker);
+        if (marker != std::string::npos) {
+            line.erase(marker);
+        }
+        lines.push_back(line);
+    }
+    in.close();
+
+    for (const auto &[pc, stats] : stats_) {
+        auto it = program.instruction_number_disassembly_mapping.find(program.InstructionNumber(pc));
+        if (it == program.instruction_number_disassembly_mapping.end() || it->second == 0 || it->second > lines.size()) {
+            continue;
+        }
+        std::ostringstream note;
+        note << kAnnotationMarker
+             << " exec=" << stats.executions
+             << " taken=" << std::fixed << std::setprecision(1) << TakenRate(stats) << "%"
+             << " mispred=" << stats.mispredictions
+             << " lost=" << stats.cycles_lost;
+        lines[it->second - 1] += note.str();
+    }
+
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Unable to write disassembly file: " + filename.string());
+    }
+    for (const std::string &l : lines) {
+        out << l << "\n";
+    }
+}
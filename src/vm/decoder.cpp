@@ -0,0 +1,608 @@
+/**
+ * @file decoder.cpp
+ * @brief Compile time generation of the decoder tables
+ */
+
+#include "vm/decoder.h"
+
+#include <stdexcept>
+
+using instruction_set::Instruction;
+using instruction_set::InstructionEncoding;
+
+namespace {
+    using decoder::DecodedOp;
+    using decoder::ImmFormat;
+    using decoder::OperandA;
+    using decoder::detail::DecodeTables;
+
+    constexpr uint16_t kInvalidId = static_cast<uint16_t>(Instruction::INVALID);
+
+    constexpr alu::AluOp aluOpOf(Instruction instr) {
+        using alu::AluOp;
+        switch (instr) {
+            case Instruction::kadd: case Instruction::kaddi:
+            case Instruction::klb: case Instruction::klh: case Instruction::klw: case Instruction::kld:
+            case Instruction::klbu: case Instruction::klhu: case Instruction::klwu:
+            case Instruction::ksb: case Instruction::ksh: case Instruction::ksw: case Instruction::ksd:
+            case Instruction::kflw: case Instruction::kfld: case Instruction::kfsw: case Instruction::kfsd:
+            case Instruction::kjal: case Instruction::kjalr: case Instruction::klui: case Instruction::kauipc:
+                return AluOp::kAdd;
+            case Instruction::ksub: case Instruction::kbeq: case Instruction::kbne: return AluOp::kSub;
+            case Instruction::ksll: case Instruction::kslli: return AluOp::kSll;
+            case Instruction::kslt: case Instruction::kslti: case Instruction::kblt: case Instruction::kbge: return AluOp::kSlt;
+            case Instruction::ksltu: case Instruction::ksltiu: case Instruction::kbltu: case Instruction::kbgeu: return AluOp::kSltu;
+            case Instruction::kxor: case Instruction::kxori: return AluOp::kXor;
+            case Instruction::ksrl: case Instruction::ksrli: return AluOp::kSrl;
+            case Instruction::ksra: case Instruction::ksrai: return AluOp::kSra;
+            case Instruction::kor: case Instruction::kori: return AluOp::kOr;
+            case Instruction::kand: case Instruction::kandi: return AluOp::kAnd;
+
+            case Instruction::kaddw: case Instruction::kaddiw: return AluOp::kAddw;
+            case Instruction::ksubw: return AluOp::kSubw;
+            case Instruction::ksllw: case Instruction::kslliw: return AluOp::kSllw;
+            case Instruction::ksrlw: case Instruction::ksrliw: return AluOp::kSrlw;
+            case Instruction::ksraw: case Instruction::ksraiw: return AluOp::kSraw;
+
+            case Instruction::kmul: return AluOp::kMul;
+            case Instruction::kmulh: return AluOp::kMulh;
+            case Instruction::kmulhsu: return AluOp::kMulhsu;
+            case Instruction::kmulhu: return AluOp::kMulhu;
+            case Instruction::kdiv: return AluOp::kDiv;
+            case Instruction::kdivu: return AluOp::kDivu;
+            case Instruction::krem: return AluOp::kRem;
+            case Instruction::kremu: return AluOp::kRemu;
+            case Instruction::kmulw: return AluOp::kMulw;
+            case Instruction::kdivw: return AluOp::kDivw;
+            case Instruction::kdivuw: return AluOp::kDivuw;
+            case Instruction::kremw: return AluOp::kRemw;
+            case Instruction::kremuw: return AluOp::kRemuw;
+
+            case Instruction::ksh1add: return AluOp::kSh1add;
+            case Instruction::ksh2add: return AluOp::kSh2add;
+            case Instruction::ksh3add: return AluOp::kSh3add;
+            case Instruction::kadd_uw: return AluOp::kAdduw;
+            case Instruction::ksh1add_uw: return AluOp::kSh1adduw;
+            case Instruction::ksh2add_uw: return AluOp::kSh2adduw;
+            case Instruction::ksh3add_uw: return AluOp::kSh3adduw;
+            case Instruction::kslli_uw: return AluOp::kSlliuw;
+
+            case Instruction::kandn: return AluOp::kAndn;
+            case Instruction::korn: return AluOp::kOrn;
+            case Instruction::kxnor: return AluOp::kXnor;
+            case Instruction::kclz: return AluOp::kClz;
+            case Instruction::kctz: return AluOp::kCtz;
+            case Instruction::kcpop: return AluOp::kCpop;
+            case Instruction::kclzw: return AluOp::kClzw;
+            case Instruction::kctzw: return AluOp::kCtzw;
+            case Instruction::kcpopw: return AluOp::kCpopw;
+            case Instruction::kmax: return AluOp::kMax;
+            case Instruction::kmaxu: return AluOp::kMaxu;
+            case Instruction::kmin: return AluOp::kMin;
+            case Instruction::kminu: return AluOp::kMinu;
+            case Instruction::ksext_b: return AluOp::kSextb;
+            case Instruction::ksext_h: return AluOp::kSexth;
+            case Instruction::kzext_h: return AluOp::kZexth;
+            case Instruction::krol: return AluOp::kRol;
+            case Instruction::kror: case Instruction::krori: return AluOp::kRor;
+            case Instruction::krolw: return AluOp::kRolw;
+            case Instruction::krorw: case Instruction::kroriw: return AluOp::kRorw;
+            case Instruction::korc_b: return AluOp::kOrcb;
+            case Instruction::krev8: return AluOp::kRev8;
+
+            case Instruction::kfmadd_s: return AluOp::kFmadd_s;
+            case Instruction::kfmsub_s: return AluOp::kFmsub_s;
+            case Instruction::kfnmsub_s: return AluOp::kFnmsub_s;
+            case Instruction::kfnmadd_s: return AluOp::kFnmadd_s;
+            case Instruction::kfadd_s: return AluOp::FADD_S;
+            case Instruction::kfsub_s: return AluOp::FSUB_S;
+            case Instruction::kfmul_s: return AluOp::FMUL_S;
+            case Instruction::kfdiv_s: return AluOp::FDIV_S;
+            case Instruction::kfsqrt_s: return AluOp::FSQRT_S;
+            case Instruction::kfsgnj_s: return AluOp::FSGNJ_S;
+            case Instruction::kfsgnjn_s: return AluOp::FSGNJN_S;
+            case Instruction::kfsgnjx_s: return AluOp::FSGNJX_S;
+            case Instruction::kfmin_s: return AluOp::FMIN_S;
+            case Instruction::kfmax_s: return AluOp::FMAX_S;
+            case Instruction::kfeq_s: return AluOp::FEQ_S;
+            case Instruction::kflt_s: return AluOp::FLT_S;
+            case Instruction::kfle_s: return AluOp::FLE_S;
+            case Instruction::kfclass_s: return AluOp::FCLASS_S;
+            case Instruction::kfcvt_w_s: return AluOp::FCVT_W_S;
+            case Instruction::kfcvt_wu_s: return AluOp::FCVT_WU_S;
+            case Instruction::kfcvt_l_s: return AluOp::FCVT_L_S;
+            case Instruction::kfcvt_lu_s: return AluOp::FCVT_LU_S;
+            case Instruction::kfcvt_s_w: return AluOp::FCVT_S_W;
+            case Instruction::kfcvt_s_wu: return AluOp::FCVT_S_WU;
+            case Instruction::kfcvt_s_l: return AluOp::FCVT_S_L;
+            case Instruction::kfcvt_s_lu: return AluOp::FCVT_S_LU;
+            case Instruction::kfmv_x_w: return AluOp::FMV_X_W;
+            case Instruction::kfmv_w_x: return AluOp::FMV_W_X;
+
+            case Instruction::kfmadd_d: return AluOp::FMADD_D;
+            case Instruction::kfmsub_d: return AluOp::FMSUB_D;
+            case Instruction::kfnmsub_d: return AluOp::FNMSUB_D;
+            case Instruction::kfnmadd_d: return AluOp::FNMADD_D;
+            case Instruction::kfadd_d: return AluOp::FADD_D;
+            case Instruction::kfsub_d: return AluOp::FSUB_D;
+            case Instruction::kfmul_d: return AluOp::FMUL_D;
+            case Instruction::kfdiv_d: return AluOp::FDIV_D;
+            case Instruction::kfsqrt_d: return AluOp::FSQRT_D;
+            case Instruction::kfsgnj_d: return AluOp::FSGNJ_D;
+            case Instruction::kfsgnjn_d: return AluOp::FSGNJN_D;
+            case Instruction::kfsgnjx_d: return AluOp::FSGNJX_D;
+            case Instruction::kfmin_d: return AluOp::FMIN_D;
+            case Instruction::kfmax_d: return AluOp::FMAX_D;
+            case Instruction::kfeq_d: return AluOp::FEQ_D;
+            case Instruction::kflt_d: return AluOp::FLT_D;
+            case Instruction::kfle_d: return AluOp::FLE_D;
+            case Instruction::kfclass_d: return AluOp::FCLASS_D;
+            case Instruction::kfcvt_w_d: return AluOp::FCVT_W_D;
+            case Instruction::kfcvt_wu_d: return AluOp::FCVT_WU_D;
+            case Instruction::kfcvt_l_d: return AluOp::FCVT_L_D;
+            case Instruction::kfcvt_lu_d: return AluOp::FCVT_LU_D;
+            case Instruction::kfcvt_d_w: return AluOp::FCVT_D_W;
+            case Instruction::kfcvt_d_wu: return AluOp::FCVT_D_WU;
+            case Instruction::kfcvt_d_l: return AluOp::FCVT_D_L;
+            case Instruction::kfcvt_d_lu: return AluOp::FCVT_D_LU;
+            case Instruction::kfcvt_s_d: return AluOp::FCVT_S_D;
+            case Instruction::kfcvt_d_s: return AluOp::FCVT_D_S;
+            case Instruction::kfmv_x_d: return AluOp::FMV_X_D;
+            case Instruction::kfmv_d_x: return AluOp::FMV_D_X;
+
+            default: return AluOp::kNone;      // ecall, csr*
+        }
+    }
+
+    constexpr bool isVectorMemory(const InstructionEncoding &enc) {
+        return (enc.opcode == 0b0000111 || enc.opcode == 0b0100111) && enc.funct3 != 0b010 && enc.funct3 != 0b011;
+    }
+
+    // the vector unit decodes the rest of the instruction, only the scalar operands are described here
+    constexpr DecodedOp describeVector(const InstructionEncoding &enc) {
+        DecodedOp op;
+        op.instr = enc.instr;
+        op.is_vector = true;
+        if (enc.opcode == 0b1010111 && enc.funct3 == 0b111) {      // vset{i}vl{i} write the new vl to rd
+            op.reg_write = true;
+            if (enc.instr == Instruction::kvsetivli) {
+                op.operand_a = OperandA::kZero;                     // the avl is the rs1 field
+            }
+        } else if (enc.opcode == 0b1010111 && (enc.funct3 == 0b000 || enc.funct3 == 0b001 || enc.funct3 == 0b010
+                                               || enc.funct3 == 0b011)) {
+            op.operand_a = OperandA::kZero;                         // .vv, .vs and .vi have no scalar operand
+        }
+        op.rs1_fp = enc.opcode == 0b1010111 && enc.funct3 == 0b101; // .vf
+        return op;
+    }
+
+    // the control signals follow from the major opcode, the register files of OP-FP from funct7
+    constexpr DecodedOp describe(const InstructionEncoding &enc) {
+        if (enc.opcode == 0b1010111 || isVectorMemory(enc)) {
+            return describeVector(enc);
+        }
+        DecodedOp op;
+        op.instr = enc.instr;
+        op.alu_op = aluOpOf(enc.instr);
+
+        switch (enc.opcode) {
+            case 0b0110011:     // OP
+            case 0b0111011:     // OP-32
+                op.reg_write = true;
+                break;
+            case 0b0010011:     // OP-IMM
+            case 0b0011011:     // OP-IMM-32
+                op.imm_format = ImmFormat::kI;
+                op.alu_src = op.reg_write = true;
+                break;
+            case 0b0000011:     // LOAD
+            case 0b0000111:     // LOAD-FP
+                op.imm_format = ImmFormat::kI;
+                op.alu_src = op.mem_read = op.mem_to_reg = op.reg_write = true;
+                op.rd_fp = enc.opcode == 0b0000111;
+                break;
+            case 0b0100011:     // STORE
+            case 0b0100111:     // STORE-FP
+                op.imm_format = ImmFormat::kS;
+                op.alu_src = op.mem_write = true;
+                op.rs2_fp = enc.opcode == 0b0100111;
+                break;
+            case 0b0101111:     // AMO, the address is rs1 + 0, rd gets the old memory value, rs2 is stored
+                op.is_atomic = true;
+                op.alu_op = alu::AluOp::kAdd;
+                op.alu_src = op.mem_read = op.mem_to_reg = op.reg_write = true;
+                op.mem_write = enc.funct5 == -1;    // every one but lr
+                break;
+            case 0b1100011:     // BRANCH
+                op.imm_format = ImmFormat::kB;
+                op.branch = true;
+                break;
+            case 0b1101111:     // JAL, the alu computes the target from the pc
+                op.imm_format = ImmFormat::kJ;
+                op.operand_a = OperandA::kPc;
+                op.alu_src = op.reg_write = op.branch = true;
+                break;
+            case 0b1100111:     // JALR
+                op.imm_format = ImmFormat::kI;
+                op.alu_src = op.reg_write = op.branch = true;
+                break;
+            case 0b0110111:     // LUI
+                op.imm_format = ImmFormat::kU;
+                op.operand_a = OperandA::kZero;
+                op.alu_src = op.reg_write = true;
+                break;
+            case 0b0010111:     // AUIPC
+                op.imm_format = ImmFormat::kU;
+                op.operand_a = OperandA::kPc;
+                op.alu_src = op.reg_write = true;
+                break;
+            case 0b1110011:     // SYSTEM, the csr address is taken from the instruction, not from the immediate
+                if (enc.instr == Instruction::kecall) {
+                    op.is_syscall = true;
+                    break;
+                }
+                op.is_csr = op.reg_write = op.alu_src = true;
+                if (enc.funct3 & 0b100) {   // csrrwi, csrrsi, csrrci -> rs1 field is a zero extended immediate
+                    op.operand_a = OperandA::kZero;
+                }
+                break;
+            case 0b1000011: case 0b1000111: case 0b1001011: case 0b1001111:     // FMADD, FMSUB, FNMSUB, FNMADD
+                op.fp_unit = op.reg_write = true;
+                op.rs1_fp = op.rs2_fp = op.uses_rs3 = op.rd_fp = true;
+                break;
+            case 0b1010011:     // OP-FP
+                op.fp_unit = op.reg_write = true;
+                op.rs1_fp = op.rs2_fp = op.rd_fp = true;
+                switch (enc.funct7 >> 2) {
+                    case 0b01011:                   // fsqrt
+                    case 0b01000:                   // fcvt.s.d, fcvt.d.s
+                        op.rs2_fp = false;
+                        break;
+                    case 0b10100:                   // feq, flt, fle -> integer result
+                        op.rd_fp = false;
+                        break;
+                    case 0b11000:                   // fcvt.w[u] / fcvt.l[u] -> integer result
+                    case 0b11100:                   // fmv.x.w, fmv.x.d, fclass
+                        op.rs2_fp = op.rd_fp = false;
+                        break;
+                    case 0b11010:                   // fcvt.s.w[u] / fcvt.s.l[u] -> integer source
+                    case 0b11110:                   // fmv.w.x, fmv.d.x
+                        op.rs1_fp = op.rs2_fp = false;
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            default:
+                break;
+        }
+
+        // fmt is funct7[1:0] (funct2 for the fused ops), fcvt.s.d needs the D extension although its result is single
+        switch (enc.opcode) {
+            case 0b0000111: case 0b0100111:
+                op.is_double = enc.funct3 == 0b011;
+                op.is_float = !op.is_double;
+                break;
+            case 0b1000011: case 0b1000111: case 0b1001011: case 0b1001111:
+                op.is_double = enc.funct2 == 0b01;
+                op.is_float = !op.is_double;
+                break;
+            case 0b1010011:
+                op.is_double = (enc.funct7 & 0b1) || enc.instr == Instruction::kfcvt_s_d;
+                op.is_float = !op.is_double;
+                break;
+            default:
+                break;
+        }
+        return op;
+    }
+
+    constexpr bool matchesFunct7(const InstructionEncoding &enc, unsigned int funct7) {
+        if (enc.instr == Instruction::kvsetvli) {       // zimm[10:0] fills bits 30:20
+            return (funct7 >> 6) == 0;
+        }
+        if (enc.instr == Instruction::kvsetivli) {      // zimm[9:0] fills bits 29:20
+            return (funct7 >> 5) == 0b11;
+        }
+        if (enc.opcode == 0b0101111) {              // aq and rl are funct7[1:0]
+            return (funct7 >> 2) == static_cast<unsigned int>(enc.funct7 >> 2);
+        }
+        if (enc.funct2 != -1 && (funct7 & 0b11) != static_cast<unsigned int>(enc.funct2)) {
+            return false;
+        }
+        if (enc.funct6 != -1) {             // RV64 slli / srli / srai / rori / slli.uw: bit 25 is shamt[5]
+            return (funct7 >> 1) == static_cast<unsigned int>(enc.funct6);
+        }
+        if (enc.funct7 == -1) {
+            return true;
+        }
+        return funct7 == static_cast<unsigned int>(enc.funct7);
+    }
+
+    // two encodings claiming the same slot make the table generation fail to compile
+    constexpr void claim(uint16_t &slot, uint16_t id) {
+        if (slot != kInvalidId && slot != id) {
+            throw std::logic_error("overlapping instruction encodings");
+        }
+        slot = id;
+    }
+
+    constexpr DecodeTables buildTables() {
+        DecodeTables tables;
+        for (auto &row : tables.rows) {
+            row.fill(kInvalidId);
+        }
+        for (auto &group : tables.funct5_groups) {
+            group.fill(kInvalidId);
+        }
+
+        std::size_t num_rows = 1;
+        std::size_t num_groups = 0;
+        std::array<int, decoder::detail::kFunct5Groups> group_opcode{};
+        std::array<int, decoder::detail::kFunct5Groups> group_funct7{};
+        std::array<int, decoder::detail::kFunct5Groups> group_funct3{};
+
+        for (const InstructionEncoding &enc : instruction_set::compiletime_instruction_encoding_array) {
+            // skip the categorical entries (kRtype ... kCsrType) and the unused tail of the array
+            if (enc.instr <= Instruction::kCsrType || enc.instr == Instruction::INVALID || enc.opcode < 0) {
+                continue;
+            }
+            auto id = static_cast<uint16_t>(enc.instr);
+            tables.ops[id] = describe(enc);
+
+            uint8_t &row = tables.row_of_opcode[enc.opcode];
+            if (row == 0) {
+                if (num_rows == decoder::detail::kRows) {
+                    throw std::logic_error("more major opcodes than decoder rows");
+                }
+                row = static_cast<uint8_t>(num_rows++);
+            }
+
+            // encodings told apart by rs2 share a group per (opcode, funct7, funct3) they match
+            uint16_t entry = id;
+            if (enc.funct5 != -1) {
+                std::size_t group = 0;
+                while (group < num_groups && (group_opcode[group] != enc.opcode || group_funct7[group] != enc.funct7
+                                              || group_funct3[group] != enc.funct3)) {
+                    ++group;
+                }
+                if (group == num_groups) {
+                    if (num_groups == decoder::detail::kFunct5Groups) {
+                        throw std::logic_error("more funct5 groups than the decoder holds");
+                    }
+                    group_opcode[group] = enc.opcode;
+                    group_funct7[group] = enc.funct7;
+                    group_funct3[group] = enc.funct3;
+                    ++num_groups;
+                }
+                claim(tables.funct5_groups[group][enc.funct5], id);
+                entry = static_cast<uint16_t>(decoder::detail::kFirstGroup + group);
+            }
+
+            for (unsigned int funct3 = 0; funct3 < 8; ++funct3) {
+                if (enc.funct3 != -1 && funct3 != static_cast<unsigned int>(enc.funct3)) {
+                    continue;
+                }
+                for (unsigned int funct7 = 0; funct7 < 128; ++funct7) {
+                    if (matchesFunct7(enc, funct7)) {
+                        claim(tables.rows[row][funct3 << 7 | funct7], entry);
+                    }
+                }
+            }
+        }
+        return tables;
+    }
+}
+
+namespace decoder::detail {
+
+constexpr DecodeTables kTables = buildTables();
+
+} // namespace decoder::detail
+
+namespace {
+    static_assert(decoder::decode(0x00b50533).instr == Instruction::kadd);         // add a0, a0, a1
+    static_assert(decoder::decode(0x03f55513).instr == Instruction::ksrli);        // srli a0, a0, 63
+    static_assert(decoder::decode(0x00000073).is_syscall);                          // ecall
+    static_assert(decoder::decode(0x0220f1c3).alu_op == alu::AluOp::FMADD_D);      // fmadd.d f3, f1, f2, f0
+    static_assert(decoder::decode(0x401170d3).alu_op == alu::AluOp::FCVT_S_D);     // fcvt.s.d f1, f2
+    static_assert(decoder::decode(0xe0050553).instr == Instruction::kfmv_x_w);     // fmv.x.w a0, fa0
+    static_assert(decoder::decode(0x60051513).instr == Instruction::kclz);         // clz a0, a0
+    static_assert(decoder::decode(0x6005151b).instr == Instruction::kclzw);        // clzw a0, a0
+    static_assert(decoder::decode(0x63f55513).instr == Instruction::krori);        // rori a0, a0, 63
+    static_assert(decoder::decode(0x6b855513).instr == Instruction::krev8);        // rev8 a0, a0
+    static_assert(decoder::decode(0x0805151b).instr == Instruction::kslli_uw);     // slli.uw a0, a0, 0
+    static_assert(decoder::decode(0x0d0572d7).instr == Instruction::kvsetvli);     // vsetvli t0, a0, e32, m1, ta, ma
+    static_assert(decoder::decode(0x02b50057).instr == Instruction::kvadd_vv);     // vadd.vv v0, v11, v10
+    static_assert(decoder::decode(0x02056407).instr == Instruction::kvle32_v);     // vle32.v v8, (a0)
+    static_assert(decoder::decode(0x00b50057).instr == Instruction::INVALID);      // vadd.vv v0, v11, v10, v0.t
+    static_assert(decoder::decode(0x1005a52f).instr == Instruction::klr_w);        // lr.w a0, (a1)
+    static_assert(decoder::decode(0x0cc5a52f).instr == Instruction::kamoswap_w);   // amoswap.w.aq a0, a2, (a1)
+    static_assert(decoder::decode(0x06c5b52f).instr == Instruction::kamoadd_d);    // amoadd.d.aqrl a0, a2, (a1)
+    static_assert(decoder::decode(0x1015a52f).instr == Instruction::INVALID);      // lr.w with rs2 != 0
+    static_assert(decoder::decode(0x6b955513).instr == Instruction::INVALID);
+    static_assert(decoder::decode(0x00000000).instr == Instruction::INVALID);
+}
+
+namespace {
+    constexpr uint32_t kOpLoad = 0b0000011;
+    constexpr uint32_t kOpLoadFp = 0b0000111;
+    constexpr uint32_t kOpImm = 0b0010011;
+    constexpr uint32_t kOpImm32 = 0b0011011;
+    constexpr uint32_t kOpStore = 0b0100011;
+    constexpr uint32_t kOpStoreFp = 0b0100111;
+    constexpr uint32_t kOpReg = 0b0110011;
+    constexpr uint32_t kOpLui = 0b0110111;
+    constexpr uint32_t kOpReg32 = 0b0111011;
+    constexpr uint32_t kOpBranch = 0b1100011;
+    constexpr uint32_t kOpJalr = 0b1100111;
+    constexpr uint32_t kOpJal = 0b1101111;
+    constexpr uint32_t kEbreak = 0x00100073;
+    constexpr uint32_t kIllegal = 0;
+
+    constexpr uint32_t bits(uint32_t value, unsigned int hi, unsigned int lo) {
+        return (value >> lo) & ((1u << (hi - lo + 1)) - 1);
+    }
+
+    constexpr int32_t signExtend(uint32_t value, unsigned int width) {
+        return static_cast<int32_t>(value << (32 - width)) >> (32 - width);
+    }
+
+    constexpr uint32_t encodeR(uint32_t funct7, uint32_t rs2, uint32_t rs1, uint32_t funct3, uint32_t rd, uint32_t opcode) {
+        return funct7 << 25 | rs2 << 20 | rs1 << 15 | funct3 << 12 | rd << 7 | opcode;
+    }
+
+    constexpr uint32_t encodeI(int32_t imm, uint32_t rs1, uint32_t funct3, uint32_t rd, uint32_t opcode) {
+        return (static_cast<uint32_t>(imm) & 0xfff) << 20 | rs1 << 15 | funct3 << 12 | rd << 7 | opcode;
+    }
+
+    constexpr uint32_t encodeS(uint32_t imm, uint32_t rs2, uint32_t rs1, uint32_t funct3, uint32_t opcode) {
+        return bits(imm, 11, 5) << 25 | rs2 << 20 | rs1 << 15 | funct3 << 12 | bits(imm, 4, 0) << 7 | opcode;
+    }
+
+    constexpr uint32_t encodeB(int32_t imm, uint32_t rs1, uint32_t funct3) {
+        auto u = static_cast<uint32_t>(imm);
+        return bits(u, 12, 12) << 31 | bits(u, 10, 5) << 25 | rs1 << 15 | funct3 << 12 | bits(u, 4, 1) << 8
+            | bits(u, 11, 11) << 7 | kOpBranch;
+    }
+
+    constexpr uint32_t encodeJ(int32_t imm, uint32_t rd) {
+        auto u = static_cast<uint32_t>(imm);
+        return bits(u, 20, 20) << 31 | bits(u, 10, 1) << 21 | bits(u, 11, 11) << 20 | bits(u, 19, 12) << 12 | rd << 7
+            | kOpJal;
+    }
+
+    // Quadrant 0: stack pointer based addi and the loads / stores with the x8-x15 registers
+    constexpr uint32_t expandQuadrant0(uint32_t c) {
+        uint32_t rd_prime = 8 + bits(c, 4, 2);      // also rs2'
+        uint32_t rs1_prime = 8 + bits(c, 9, 7);
+        uint32_t word_offset = bits(c, 12, 10) << 3 | bits(c, 6, 6) << 2 | bits(c, 5, 5) << 6;
+        uint32_t double_offset = bits(c, 12, 10) << 3 | bits(c, 6, 5) << 6;
+        switch (bits(c, 15, 13)) {
+            case 0b000: {   // c.addi4spn
+                uint32_t imm = bits(c, 12, 11) << 4 | bits(c, 10, 7) << 6 | bits(c, 6, 6) << 2 | bits(c, 5, 5) << 3;
+                return imm == 0 ? kIllegal : encodeI(static_cast<int32_t>(imm), 2, 0b000, rd_prime, kOpImm);
+            }
+            case 0b001: return encodeI(static_cast<int32_t>(double_offset), rs1_prime, 0b011, rd_prime, kOpLoadFp);
+            case 0b010: return encodeI(static_cast<int32_t>(word_offset), rs1_prime, 0b010, rd_prime, kOpLoad);
+            case 0b011: return encodeI(static_cast<int32_t>(double_offset), rs1_prime, 0b011, rd_prime, kOpLoad);
+            case 0b101: return encodeS(double_offset, rd_prime, rs1_prime, 0b011, kOpStoreFp);
+            case 0b110: return encodeS(word_offset, rd_prime, rs1_prime, 0b010, kOpStore);
+            case 0b111: return encodeS(double_offset, rd_prime, rs1_prime, 0b011, kOpStore);
+            default: return kIllegal;
+        }
+    }
+
+    // Quadrant 1: immediates, arithmetic on x8-x15, c.j and the compare with zero branches
+    constexpr uint32_t expandQuadrant1(uint32_t c) {
+        uint32_t rd = bits(c, 11, 7);
+        uint32_t rd_prime = 8 + bits(c, 9, 7);
+        uint32_t rs2_prime = 8 + bits(c, 4, 2);
+        int32_t imm = signExtend(bits(c, 12, 12) << 5 | bits(c, 6, 2), 6);
+        uint32_t shamt = bits(c, 12, 12) << 5 | bits(c, 6, 2);
+        switch (bits(c, 15, 13)) {
+            case 0b000: return encodeI(imm, rd, 0b000, rd, kOpImm);                            // c.addi, c.nop
+            case 0b001: return rd == 0 ? kIllegal : encodeI(imm, rd, 0b000, rd, kOpImm32);     // c.addiw
+            case 0b010: return encodeI(imm, 0, 0b000, rd, kOpImm);                             // c.li
+            case 0b011: {
+                if (rd == 2) {      // c.addi16sp
+                    int32_t sp_imm = signExtend(bits(c, 12, 12) << 9 | bits(c, 6, 6) << 4 | bits(c, 5, 5) << 6
+                        | bits(c, 4, 3) << 7 | bits(c, 2, 2) << 5, 10);
+                    return sp_imm == 0 ? kIllegal : encodeI(sp_imm, 2, 0b000, 2, kOpImm);
+                }
+                if (imm == 0) {
+                    return kIllegal;
+                }
+                return (static_cast<uint32_t>(imm) << 12) | rd << 7 | kOpLui;                  // c.lui
+            }
+            case 0b100:
+                switch (bits(c, 11, 10)) {
+                    case 0b00: return encodeI(static_cast<int32_t>(shamt), rd_prime, 0b101, rd_prime, kOpImm);
+                    case 0b01: return encodeI(static_cast<int32_t>(0x400 | shamt), rd_prime, 0b101, rd_prime, kOpImm);
+                    case 0b10: return encodeI(imm, rd_prime, 0b111, rd_prime, kOpImm);
+                    default: break;
+                }
+                if (bits(c, 12, 12) == 0) {
+                    constexpr uint32_t kFunct3[4] = {0b000, 0b100, 0b110, 0b111};     // sub, xor, or, and
+                    uint32_t op = bits(c, 6, 5);
+                    return encodeR(op == 0 ? 0b0100000 : 0, rs2_prime, rd_prime, kFunct3[op], rd_prime, kOpReg);
+                }
+                switch (bits(c, 6, 5)) {
+                    case 0b00: return encodeR(0b0100000, rs2_prime, rd_prime, 0b000, rd_prime, kOpReg32);  // c.subw
+                    case 0b01: return encodeR(0, rs2_prime, rd_prime, 0b000, rd_prime, kOpReg32);          // c.addw
+                    default: return kIllegal;
+                }
+            case 0b101: {   // c.j
+                int32_t offset = signExtend(bits(c, 12, 12) << 11 | bits(c, 11, 11) << 4 | bits(c, 10, 9) << 8
+                    | bits(c, 8, 8) << 10 | bits(c, 7, 7) << 6 | bits(c, 6, 6) << 7 | bits(c, 5, 3) << 1
+                    | bits(c, 2, 2) << 5, 12);
+                return encodeJ(offset, 0);
+            }
+            default: {      // c.beqz, c.bnez
+                int32_t offset = signExtend(bits(c, 12, 12) << 8 | bits(c, 11, 10) << 3 | bits(c, 6, 5) << 6
+                    | bits(c, 4, 3) << 1 | bits(c, 2, 2) << 5, 9);
+                return encodeB(offset, rd_prime, bits(c, 13, 13));
+            }
+        }
+    }
+
+    // Quadrant 2: c.slli, the stack pointer loads / stores and the register moves, jumps and adds
+    constexpr uint32_t expandQuadrant2(uint32_t c) {
+        uint32_t rd = bits(c, 11, 7);
+        uint32_t rs2 = bits(c, 6, 2);
+        uint32_t word_load_offset = bits(c, 12, 12) << 5 | bits(c, 6, 4) << 2 | bits(c, 3, 2) << 6;
+        uint32_t double_load_offset = bits(c, 12, 12) << 5 | bits(c, 6, 5) << 3 | bits(c, 4, 2) << 6;
+        uint32_t word_store_offset = bits(c, 12, 9) << 2 | bits(c, 8, 7) << 6;
+        uint32_t double_store_offset = bits(c, 12, 10) << 3 | bits(c, 9, 7) << 6;
+        switch (bits(c, 15, 13)) {
+            case 0b000: return encodeI(static_cast<int32_t>(bits(c, 12, 12) << 5 | rs2), rd, 0b001, rd, kOpImm);
+            case 0b001: return encodeI(static_cast<int32_t>(double_load_offset), 2, 0b011, rd, kOpLoadFp);
+            case 0b010:
+                return rd == 0 ? kIllegal : encodeI(static_cast<int32_t>(word_load_offset), 2, 0b010, rd, kOpLoad);
+            case 0b011:
+                return rd == 0 ? kIllegal : encodeI(static_cast<int32_t>(double_load_offset), 2, 0b011, rd, kOpLoad);
+            case 0b100:
+                if (bits(c, 12, 12) == 0) {
+                    if (rs2 == 0) {
+                        return rd == 0 ? kIllegal : encodeI(0, rd, 0b000, 0, kOpJalr);        // c.jr
+                    }
+                    return encodeR(0, rs2, 0, 0b000, rd, kOpReg);                              // c.mv
+                }
+                if (rs2 == 0) {
+                    return rd == 0 ? kEbreak : encodeI(0, rd, 0b000, 1, kOpJalr);             // c.ebreak, c.jalr
+                }
+                return encodeR(0, rs2, rd, 0b000, rd, kOpReg);                                 // c.add
+            case 0b101: return encodeS(double_store_offset, rs2, 2, 0b011, kOpStoreFp);
+            case 0b110: return encodeS(word_store_offset, rs2, 2, 0b010, kOpStore);
+            default: return encodeS(double_store_offset, rs2, 2, 0b011, kOpStore);
+        }
+    }
+
+    constexpr uint32_t expand(uint32_t c) {
+        switch (c & 0b11) {
+            case 0b00: return expandQuadrant0(c);
+            case 0b01: return expandQuadrant1(c);
+            case 0b10: return expandQuadrant2(c);
+            default: return kIllegal;
+        }
+    }
+
+    static_assert(expand(0x0000) == kIllegal);
+    static_assert(expand(0x0001) == 0x00000013);        // c.nop -> addi x0, x0, 0
+    static_assert(expand(0x4515) == 0x00500513);        // c.li a0, 5
+    static_assert(expand(0x952e) == 0x00b50533);        // c.add a0, a1
+    static_assert(expand(0x8082) == 0x00008067);        // c.jr ra (ret)
+    static_assert(expand(0x6522) == 0x00813503);        // c.ldsp a0, 8(sp)
+    static_assert(expand(0x1141) == 0xff010113);        // c.addi sp, sp, -16
+    static_assert(expand(0xa001) == 0x0000006f);        // c.j 0
+    static_assert(expand(0xc501) == 0x00050463);        // c.beqz a0, 8
+    static_assert(decoder::decode(expand(0x8d0d)).instr == Instruction::ksub);     // c.sub a0, a1
+}
+
+namespace decoder {
+
+uint32_t expandCompressed(uint16_t parcel) {
+    return expand(parcel);
+}
+
+} // namespace decoder
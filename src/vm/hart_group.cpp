@@ -0,0 +1,164 @@
+/**
+ * @file hart_group.cpp
+ * @brief Implementation of the harts sharing one guest memory
+ */
+
+#include "vm/hart_group.h"
+
+#include <barrier>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace {
+    // the harts are built and run with stdout muted and without undo history, checkpoints, lockstep check or pipeline
+    // trace, the global config is restored afterwards
+    class HartScope {
+    public:
+        HartScope() : saved_config_(vm_config::config), cout_buf_(std::cout.rdbuf(&discard_)) {
+            vm_config::config.undo_depth = 0;
+            vm_config::config.checkpoint_interval = 0;
+            vm_config::config.lockstep_check = false;
+            vm_config::config.pipeline_trace_path.clear();
+        }
+
+        ~HartScope() {
+            vm_config::config = saved_config_;
+            std::cout.rdbuf(cout_buf_);
+        }
+
+        [[nodiscard]] std::streambuf *Stdout() const {
+            return cout_buf_;
+        }
+
+    private:
+        DiscardBuffer discard_;
+        vm_config::VmConfig saved_config_;
+        std::streambuf *cout_buf_;
+    };
+}
+
+HartGroup::HartGroup(const VmBase &boot, std::size_t harts, const VmFactory &factory, uint64_t quantum)
+    : quantum_(quantum) {
+    HartScope scope;
+    harts_.reserve(harts);
+    for (std::size_t i = 0; i < harts; ++i) {
+        std::unique_ptr<VmBase> hart = factory();
+        hart->program_ = boot.program_;
+        hart->program_size_ = boot.program_size_;
+        hart->program_counter_ = boot.ResumePc();
+        hart->registers_ = boot.registers_;
+        hart->registers_.SetHartId(i);
+        hart->silent_mode_ = true;
+        hart->hart_group_ = this;
+        if (i == 0) {
+            hart->memory_controller_ = boot.memory_controller_;    // the boot vm keeps its own memory
+            hart->memory_controller_.SetShared(true);
+        } else {
+            hart->memory_controller_.ShareMemoryOf(harts_.front()->memory_controller_);
+        }
+        harts_.push_back(std::move(hart));
+    }
+}
+
+void HartGroup::Run() {
+    HartScope scope;
+    uint64_t limit = vm_config::config.getInstructionExecutionLimit();
+    auto finished = [limit](const VmBase &hart) {
+        return hart.IsStopRequested() || hart.output_status_ == "VM_PROGRAM_END" ||
+               hart.output_status_ == "VM_LAST_INSTRUCTION_STEPPED" ||
+               (limit != 0 && hart.instructions_retired_ >= limit);
+    };
+
+    // Every hart prints into its own buffer, written to stdout hart by hart while all of them wait at the barrier
+    // and once they are done: no two threads ever write stdout at once.
+    std::vector<std::ostringstream> consoles(harts_.size());
+    std::ostream out(scope.Stdout());
+    auto flushConsoles = [&consoles, &out]() {
+        for (std::ostringstream &console : consoles) {
+            out << console.view();
+            console.str({});
+        }
+        out.flush();
+    };
+
+    // the harts that are done leave the barrier, the others go on without them
+    std::barrier sync(static_cast<std::ptrdiff_t>(harts_.size()), [this, &flushConsoles]() noexcept {
+        quanta_++;
+        flushConsoles();
+    });
+    std::vector<std::exception_ptr> errors(harts_.size());
+    for (std::size_t i = 0; i < harts_.size(); ++i) {
+        harts_[i]->console_ = &consoles[i];
+        harts_[i]->ClearStop();
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(harts_.size());
+    for (std::size_t i = 0; i < harts_.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            VmBase &hart = *harts_[i];
+            try {
+                while (!finished(hart)) {
+                    for (uint64_t cycle = 0; cycle < quantum_ && !finished(hart); ++cycle) {
+                        hart.Step();
+                    }
+                    if (!finished(hart)) {
+                        sync.arrive_and_wait();
+                    }
+                }
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+            sync.arrive_and_drop();
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    flushConsoles();
+
+    for (const std::unique_ptr<VmBase> &hart : harts_) {
+        hart->console_ = nullptr;
+    }
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+std::size_t HartGroup::Size() const {
+    return harts_.size();
+}
+
+VmBase &HartGroup::Hart(std::size_t index) {
+    return *harts_.at(index);
+}
+
+uint64_t HartGroup::Quanta() const {
+    return quanta_;
+}
+
+void HartGroup::DumpHartCounters(std::ostream &file, const std::string &indent) const {
+    file << indent << "\"quanta\": " << quanta_ << ",\n";
+    file << indent << "\"harts\": [\n";
+    for (std::size_t i = 0; i < harts_.size(); ++i) {
+        const VmBase &hart = *harts_[i];
+        file << indent << "  {"
+             << "\"hart_id\": " << i << ", "
+             << "\"program_counter\": \"0x" << std::hex << std::setw(8) << std::setfill('0') << hart.program_counter_
+             << std::dec << std::setfill(' ') << "\", "
+             << "\"output_status\": \"" << hart.output_status_ << "\", "
+             << "\"cycle_count\": " << hart.cycle_s_ << ", "
+             << "\"instructions_retired\": " << hart.instructions_retired_ << ", "
+             << "\"cpi\": " << hart.cpi_ << ", "
+             << "\"ipc\": " << hart.ipc_ << ", "
+             << "\"stall_cycles\": " << hart.stall_cycles_ << ", "
+             << "\"branch_mispredictions\": " << hart.branch_mispredictions_
+             << "}" << (i + 1 < harts_.size() ? "," : "") << "\n";
+    }
+    file << indent << "]";
+}
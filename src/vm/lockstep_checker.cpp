@@ -0,0 +1,197 @@
+/**
+ * @file lockstep_checker.cpp
+ * @brief Implementation of the lockstep differential checker
+ */
+
+#include "vm/lockstep_checker.h"
+#include "vm/decoder.h"
+#include "vm/vector_unit.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    constexpr uint32_t kEcall = 0x00000073;
+
+    // scalar stores only, the vector ones share the STORE-FP opcode and are described by vector_unit::footprint
+    bool isStore(uint32_t instruction) {
+        uint8_t opcode = instruction & 0b1111111;
+        return (opcode == 0b0100011 || opcode == 0b0100111 || opcode == 0b0101111)    // the amos write at rs1
+               && !decoder::decode(instruction).is_vector;
+    }
+
+    bool readsCounter(uint32_t instruction) {
+        return (instruction & 0b1111111) == 0b1110011 && ((instruction >> 12) & 0b111) != 0 && IsCounterCsr(instruction >> 20);
+    }
+
+    std::string hex(uint64_t value) {
+        std::ostringstream os;
+        os << "0x" << std::hex << std::setw(16) << std::setfill('0') << value;
+        return os.str();
+    }
+}
+
+LockstepChecker::LockstepChecker(VmBase &dut) : dut_(dut), golden_(true) {
+    golden_.memory_controller_ = dut.memory_controller_;
+    golden_.registers_ = dut.registers_;
+    golden_.reservation_ = dut.reservation_;
+    golden_.program_counter_ = dut.program_counter_;
+    golden_.program_size_ = dut.program_size_;
+    golden_.history_.SetCapacity(0);            // the golden vm never undoes
+    golden_.checkpoints_.SetInterval(0);        // or seeks
+}
+
+bool LockstepChecker::check(const RetiredInstruction &retired) {
+    if (diverged_) {
+        return false;
+    }
+
+    uint64_t pc = golden_.program_counter_;
+    if (pc >= golden_.program_size_) {
+        diverge("pipeline retired an instruction after the end of the program", retired.pc, 0);
+        return false;
+    }
+    uint8_t length = 4;
+    uint32_t instruction = golden_.FetchInstruction(pc, length);
+    if (retired.pc != pc) {
+        diverge("pc: pipeline " + hex(retired.pc) + " golden " + hex(pc), pc, instruction);
+        return false;
+    }
+
+    // the address a store writes is known before the golden vm runs it
+    uint64_t store_address = 0;
+    unsigned int store_size = 0;
+    if (isStore(instruction)) {
+        store_address = golden_.registers_.ReadGpr((instruction >> 15) & 0b11111) + static_cast<int64_t>(golden_.ImmGenerator(instruction));
+        store_size = 1u << ((instruction >> 12) & 0b11);
+    }
+    // a vector store writes vl elements at rs1 + i * stride, the other vector instructions the words of their vd group
+    vector_unit::Footprint vector_writes;
+    const decoder::DecodedOp &op = decoder::decode(instruction);
+    if (op.is_vector) {
+        uint8_t rs1 = (instruction >> 15) & 0b11111;
+        uint64_t rs1_value = op.rs1_fp ? golden_.registers_.ReadFpr(rs1) : golden_.registers_.ReadGpr(rs1);
+        uint64_t rs2_value = golden_.registers_.ReadGpr((instruction >> 20) & 0b11111);
+        vector_writes = vector_unit::footprint(instruction, golden_.registers_, rs1_value, rs2_value);
+    }
+
+    if (instruction == kEcall || retired.is_syscall) {
+        replaySyscall();
+    } else {
+        stepGolden();
+    }
+    if (readsCounter(instruction)) {
+        // the counters of the two vms differ, the value the pipeline read is taken as correct
+        uint8_t rd = (instruction >> 7) & 0b11111;
+        golden_.registers_.WriteGpr(rd, dut_.registers_.ReadGpr(rd));
+    }
+    checked_++;
+
+    if (retired.writes_rd && (retired.rd_fp || retired.rd_index != 0)) {
+        uint64_t dut_value = retired.rd_fp ? dut_.registers_.ReadFpr(retired.rd_index) : dut_.registers_.ReadGpr(retired.rd_index);
+        uint64_t golden_value = retired.rd_fp ? golden_.registers_.ReadFpr(retired.rd_index) : golden_.registers_.ReadGpr(retired.rd_index);
+        if (dut_value != golden_value) {
+            std::string name(retired.rd_fp ? "f" : "x");
+            name += std::to_string(retired.rd_index);
+            diverge(name + ": pipeline " + hex(dut_value) + " golden " + hex(golden_value), pc, instruction);
+            return false;
+        }
+    }
+
+    for (unsigned int i = 0; i < store_size; ++i) {
+        uint8_t dut_byte = dut_.memory_controller_.ReadByte(store_address + i);
+        uint8_t golden_byte = golden_.memory_controller_.ReadByte(store_address + i);
+        if (dut_byte != golden_byte) {
+            diverge("memory at " + hex(store_address + i) + ": pipeline " + hex(dut_byte) + " golden " + hex(golden_byte), pc, instruction);
+            return false;
+        }
+    }
+    return checkVectorWrites(vector_writes, pc, instruction);
+}
+
+bool LockstepChecker::checkVectorWrites(const vector_unit::Footprint &writes, uint64_t pc, uint32_t instruction) {
+    for (uint64_t i = 0; i < writes.elements; ++i) {
+        uint64_t address = writes.address + i * writes.stride;
+        for (unsigned int j = 0; j < writes.element_bytes; ++j) {
+            uint8_t dut_byte = dut_.memory_controller_.ReadByte(address + j);
+            uint8_t golden_byte = golden_.memory_controller_.ReadByte(address + j);
+            if (dut_byte != golden_byte) {
+                diverge("memory at " + hex(address + j) + ": pipeline " + hex(dut_byte) + " golden " + hex(golden_byte), pc, instruction);
+                return false;
+            }
+        }
+    }
+
+    std::size_t register_words = golden_.registers_.VectorRegisterWords();
+    for (std::size_t i = writes.first_word; i < writes.first_word + writes.words; ++i) {
+        uint64_t dut_word = dut_.registers_.ReadVectorWord(i);
+        uint64_t golden_word = golden_.registers_.ReadVectorWord(i);
+        if (dut_word != golden_word) {
+            std::string name("v");
+            name += std::to_string(i / register_words);
+            name += " word ";
+            name += std::to_string(i % register_words);
+            diverge(name + ": pipeline " + hex(dut_word) + " golden " + hex(golden_word), pc, instruction);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LockstepChecker::checkEnd() {
+    if (!diverged_ && golden_.program_counter_ < golden_.program_size_) {
+        uint64_t pc = golden_.program_counter_;
+        diverge("pipeline drained while the golden vm still has instructions to run", pc, golden_.memory_controller_.ReadWord(pc));
+    }
+    return !diverged_;
+}
+
+void LockstepChecker::stepGolden() {
+    golden_.Fetch();
+    golden_.Decode();
+    golden_.Execute();
+    golden_.WriteMemory();
+    golden_.WriteBack();
+    golden_.instructions_retired_++;
+}
+
+void LockstepChecker::replaySyscall() {
+    uint64_t syscall_number = golden_.registers_.ReadGpr(17);
+    if (syscall_number == SYSCALL_READ && golden_.registers_.ReadGpr(10) == 0) {
+        uint64_t buffer_address = golden_.registers_.ReadGpr(11);
+        uint64_t length = golden_.registers_.ReadGpr(12);
+        for (uint64_t i = 0; i < length; ++i) {
+            golden_.memory_controller_.WriteByte(buffer_address + i, dut_.memory_controller_.ReadByte(buffer_address + i));
+        }
+    }
+    golden_.registers_.WriteGpr(10, dut_.registers_.ReadGpr(10));
+    golden_.UpdateProgramCounter(4);
+    golden_.instructions_retired_++;
+}
+
+void LockstepChecker::diverge(const std::string &what, uint64_t pc, uint32_t instruction) {
+    diverged_ = true;
+
+    std::ostringstream os;
+    os << "Lockstep divergence at retired instruction " << checked_ << " (cycle " << dut_.cycle_s_ << ")\n";
+    os << "  pc " << hex(pc) << "  instruction 0x" << std::hex << std::setw(8) << std::setfill('0') << instruction << std::dec << "\n";
+    os << "  " << what << "\n";
+
+    // the rest of the architectural state, a result still in a multi-cycle unit shows up here as well
+    os << "  register differences (pipeline / golden):\n";
+    for (size_t i = 0; i < 32; ++i) {
+        uint64_t dut_value = dut_.registers_.ReadGpr(i);
+        uint64_t golden_value = golden_.registers_.ReadGpr(i);
+        if (dut_value != golden_value) {
+            os << "    x" << i << ": " << hex(dut_value) << " / " << hex(golden_value) << "\n";
+        }
+    }
+    for (size_t i = 0; i < 32; ++i) {
+        uint64_t dut_value = dut_.registers_.ReadFpr(i);
+        uint64_t golden_value = golden_.registers_.ReadFpr(i);
+        if (dut_value != golden_value) {
+            os << "    f" << i << ": " << hex(dut_value) << " / " << hex(golden_value) << "\n";
+        }
+    }
+    report_ = os.str();
+}
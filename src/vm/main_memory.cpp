@@ -16,18 +16,94 @@
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <sstream>
 
+namespace {
+  // generations are unique over all memories, 0 marks an empty entry of the block caches
+  std::atomic<uint64_t> next_generation{1};
+
+  struct CachedBlock {
+    uint64_t generation = 0;
+    uint64_t index = 0;
+    uint8_t *data = nullptr;
+  };
+
+  // the text and a few data and stack blocks, per host thread
+  constexpr size_t kBlockCacheSize = 16;
+  thread_local std::array<CachedBlock, kBlockCacheSize> block_cache;
+}
+
+void Memory::Reset() {
+  blocks_.clear();
+  generation_ = next_generation++;
+}
+
+void Memory::RestoreSnapshot(const Snapshot &snapshot) {
+  blocks_ = snapshot;
+  generation_ = next_generation++;
+}
+
+void Memory::SetShared(bool shared) {
+  if (shared) {
+    for (auto &[index, block] : blocks_) {    // nothing else may hold the blocks the harts write in place
+      if (block.data.use_count() > 1) {
+        block.data = std::make_shared<std::vector<uint8_t>>(*block.data);
+      }
+    }
+    if (!table_mutex_) {
+      table_mutex_ = std::make_shared<std::shared_mutex>();
+    }
+    if (!reservation_stripes_) {
+      reservation_stripes_ = std::make_shared<std::array<ReservationStripe, kReservationStripes>>();
+    }
+  } else {
+    reservation_stripes_.reset();
+  }
+  shared_ = shared;
+  generation_ = next_generation++;
+}
+
+uint8_t *Memory::SharedBlock(uint64_t block_index, bool create) {
+  CachedBlock &cached = block_cache[block_index % kBlockCacheSize];
+  if (cached.generation == generation_ && cached.index == block_index) {
+    return cached.data;
+  }
+  uint8_t *data = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> lock(*table_mutex_);
+    auto it = blocks_.find(block_index);
+    if (it != blocks_.end()) {
+      data = it->second.data->data();
+    }
+  }
+  if (!data) {
+    if (!create) {
+      return nullptr;
+    }
+    std::unique_lock<std::shared_mutex> lock(*table_mutex_);
+    data = blocks_.try_emplace(block_index).first->second.data->data();    // another hart may have created it meanwhile
+  }
+  cached = {generation_, block_index, data};    // the nodes of the table, and so the blocks, stay where they are
+  return data;
+}
+
 uint8_t Memory::Read(uint64_t address) {
   if (address >= memory_size_) {
     throw std::out_of_range("Memory address out of range: " + std::to_string(address));
   }
   uint64_t block_index = GetBlockIndex(address);
   uint64_t offset = GetBlockOffset(address);
+  if (shared_) {
+    uint8_t *data = SharedBlock(block_index, false);
+    return data ? std::atomic_ref<uint8_t>(data[offset]).load(std::memory_order_acquire) : 0;
+  }
   if (!IsBlockPresent(block_index)) {
     return 0;
   }
-  return blocks_[block_index].data[offset];
+  return (*blocks_[block_index].data)[offset];
 }
 
 void Memory::Write(uint64_t address, uint8_t value) {
@@ -36,8 +112,20 @@ void Memory::Write(uint64_t address, uint8_t value) {
   }
   uint64_t block_index = GetBlockIndex(address);
   uint64_t offset = GetBlockOffset(address);
+  if (shared_) {
+    uint8_t *data = SharedBlock(block_index, true);
+    ReservationStripe &stripe = *Reservations(address);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    std::atomic_ref<uint8_t>(data[offset]).store(value, std::memory_order_release);
+    ++stripe.stores;
+    return;
+  }
   EnsureBlockExists(block_index);
-  blocks_[block_index].data[offset] = value;
+  MemoryBlock &block = blocks_[block_index];
+  if (block.data.use_count() > 1) { // still shared with a snapshot, copy on write
+    block.data = std::make_shared<std::vector<uint8_t>>(*block.data);
+  }
+  (*block.data)[offset] = value;
 }
 
 uint64_t Memory::GetBlockIndex(uint64_t address) const {
@@ -60,6 +148,13 @@ void Memory::EnsureBlockExists(uint64_t block_index) {
 
 template<typename T>
 T Memory::ReadGeneric(uint64_t address) {
+  if (shared_ && address%sizeof(T) == 0 && GetBlockOffset(address) + sizeof(T) <= block_size_) {
+    uint8_t *data = SharedBlock(GetBlockIndex(address), false);
+    if (!data) {
+      return 0;
+    }
+    return std::atomic_ref<T>(*reinterpret_cast<T *>(data + GetBlockOffset(address))).load(std::memory_order_acquire);
+  }
   T value = 0;
   for (size_t i = 0; i < sizeof(T); ++i) {
     value |= static_cast<T>(Read(address + i)) << (8*i);
@@ -69,6 +164,14 @@ T Memory::ReadGeneric(uint64_t address) {
 
 template<typename T>
 void Memory::WriteGeneric(uint64_t address, T value) {
+  if (shared_ && address%sizeof(T) == 0 && GetBlockOffset(address) + sizeof(T) <= block_size_) {
+    uint8_t *data = SharedBlock(GetBlockIndex(address), true);
+    ReservationStripe &stripe = *Reservations(address);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    std::atomic_ref<T>(*reinterpret_cast<T *>(data + GetBlockOffset(address))).store(value, std::memory_order_release);
+    ++stripe.stores;
+    return;
+  }
   for (size_t i = 0; i < sizeof(T); ++i) {
     Write(address + i, static_cast<uint8_t>(value >> (8*i)));
   }
@@ -178,6 +281,33 @@ void Memory::WriteDouble(uint64_t address, double value) {
   }
 }
 
+uint8_t *Memory::HostBytes(uint64_t address, unsigned int size) {
+  if (address%size != 0 || address >= memory_size_ - (size - 1)) {
+    return nullptr;
+  }
+  uint64_t block_index = GetBlockIndex(address);
+  uint64_t offset = GetBlockOffset(address);
+  if (offset + size > block_size_) {
+    return nullptr;
+  }
+  if (shared_) {
+    return SharedBlock(block_index, true) + offset;
+  }
+  EnsureBlockExists(block_index);
+  MemoryBlock &block = blocks_[block_index];
+  if (block.data.use_count() > 1) {
+    block.data = std::make_shared<std::vector<uint8_t>>(*block.data);
+  }
+  return block.data->data() + offset;
+}
+
+ReservationStripe *Memory::Reservations(uint64_t address) {
+  if (!reservation_stripes_) {
+    return nullptr;
+  }
+  return &(*reservation_stripes_)[(address >> 3) % kReservationStripes];
+}
+
 void Memory::PrintMemory(const uint64_t address, unsigned int rows) {
   constexpr size_t bytes_per_row = 8; // One row equals 64 bytes
   std::cout << "Memory Dump at Address: 0x" << std::hex << address << std::dec << "\n";
@@ -274,7 +404,7 @@ void Memory::printMemoryUsage() const {
   std::cout << "---------------------\n";
   std::cout << "Block Count: " << blocks_.size() << "\n";
   for (const auto &[block_index, block] : blocks_) {
-    size_t used_bytes = std::count_if(block.data.begin(), block.data.end(),
+    size_t used_bytes = std::count_if(block.data->begin(), block.data->end(),
                                       [](uint8_t byte) { return byte!=0; });
     if (used_bytes > 0) {
       std::cout << "Block " << block_index << ": " << used_bytes
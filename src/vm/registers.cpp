@@ -5,70 +5,130 @@
  */
 
 #include "vm/registers.h"
+#include "config.h"
 
 #include <stdexcept>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
 #include <array>
+#include <algorithm>
 
-RegisterFile::RegisterFile() = default;
+RegisterFile::RegisterFile() {
+  Reset();
+}
 
 void RegisterFile::Reset() {
   gpr_.fill(0);
   fpr_.fill(0.0);
-  csr_.fill(0);
-  csr_[0x002] = 0b000; // Default: RNE (IEEE 754)
+  vregs_.assign(NUM_VR * (vm_config::config.getVlen() / 64), 0);
+  vl_ = 0;
+  vtype_ = VTYPE_VILL;
+  fcsr_ = 0;        // frm 0b000: RNE (IEEE 754)
+  cycle_offset_ = 0;
+  instret_offset_ = 0;
+}
+
+void RegisterFile::BindCounters(const unsigned int *cycles, const unsigned int *instructions_retired) {
+  counters_.cycles = cycles;
+  counters_.instructions_retired = instructions_retired;
+}
+
+// fflags (0x001) and frm (0x002) are the fields [4:0] and [7:5] of fcsr (0x003), only fcsr is stored.
+// time counts cycles, the simulator has no real-time clock. vl, vtype and vlenb are read-only, vl and vtype are set by
+// vset{i}vl{i}. mhartid is read-only as well.
+uint64_t RegisterFile::ReadCsr(size_t reg) const {
+  switch (reg & (NUM_CSR - 1)) {
+    case 0x001: return fcsr_ & 0x1f;
+    case 0x002: return (fcsr_ >> 5) & 0b111;
+    case 0x003: return fcsr_;
+    case 0xb00:                                         // mcycle
+    case 0xc00:                                         // cycle
+    case 0xc01: return Cycles() + cycle_offset_;        // time
+    case 0xb02:                                         // minstret
+    case 0xc02: return InstructionsRetired() + instret_offset_;  // instret
+    case 0xc20: return vl_;
+    case 0xc21: return vtype_;
+    case 0xc22: return VectorRegisterWords() * 8;       // vlenb
+    case 0xf14: return hart_id_;                        // mhartid
+    default: return 0;
+  }
+}
+
+void RegisterFile::WriteCsr(size_t reg, uint64_t value) {
+  const CsrInfo *csr = FindCsr(reg & (NUM_CSR - 1));
+  if (!csr || csr->write_mask == 0) {
+    return;                                             // unimplemented and read-only CSRs
+  }
+  value &= csr->write_mask;
+  switch (csr->address) {
+    case 0x001: fcsr_ = (fcsr_ & ~csr->write_mask) | value; break;
+    case 0x002: fcsr_ = (fcsr_ & ~(csr->write_mask << 5)) | (value << 5); break;
+    case 0x003: fcsr_ = value; break;
+    case 0xb00: cycle_offset_ = value - Cycles(); break;
+    case 0xb02: instret_offset_ = value - InstructionsRetired(); break;
+    default: break;
+  }
 }
 
-uint64_t RegisterFile::ReadGpr(size_t reg) const {
+uint64_t RegisterFile::ReadGprChecked(size_t reg) const {
   if (reg >= NUM_GPR) throw std::out_of_range("Invalid GPR index");
-  if (reg==0) return 0;
-  return gpr_[reg];
+  return ReadGpr(reg);
 }
 
-void RegisterFile::WriteGpr(size_t reg, uint64_t value) {
+void RegisterFile::WriteGprChecked(size_t reg, uint64_t value) {
   if (reg >= NUM_GPR) throw std::out_of_range("Invalid GPR index");
-  if (reg==0) return;
-  gpr_[reg] = value;
+  WriteGpr(reg, value);
 }
 
-uint64_t RegisterFile::ReadFpr(size_t reg) const {
+uint64_t RegisterFile::ReadFprChecked(size_t reg) const {
   if (reg >= NUM_FPR) throw std::out_of_range("Invalid FPR index");
-  return fpr_[reg];
+  return ReadFpr(reg);
 }
 
-void RegisterFile::WriteFpr(size_t reg, uint64_t value) {
+void RegisterFile::WriteFprChecked(size_t reg, uint64_t value) {
   if (reg >= NUM_FPR) throw std::out_of_range("Invalid FPR index");
-  fpr_[reg] = value;
+  WriteFpr(reg, value);
 }
 
-uint64_t RegisterFile::ReadCsr(size_t reg) const {
-  if (reg >= NUM_CSR) throw std::out_of_range("Invalid CSR index");
-  return csr_[reg];
+uint64_t RegisterFile::ReadCsrChecked(size_t reg) const {
+  if (!IsImplementedCsr(reg)) throw std::out_of_range("Invalid CSR index");
+  return ReadCsr(reg);
 }
 
-void RegisterFile::WriteCsr(size_t reg, uint64_t value) {
-  if (reg >= NUM_CSR) throw std::out_of_range("Invalid CSR index");
-  csr_[reg] = value;
+void RegisterFile::WriteCsrChecked(size_t reg, uint64_t value) {
+  if (!IsImplementedCsr(reg)) throw std::out_of_range("Invalid CSR index");
+  if (FindCsr(reg)->write_mask == 0) throw std::invalid_argument("Read-only CSR");
+  WriteCsr(reg, value);
 }
 
 std::vector<uint64_t> RegisterFile::GetGprValues() const {
-  return {gpr_.begin(), gpr_.end()};
+  return {gpr_.begin(), gpr_.begin() + NUM_GPR};
 }
 
 std::vector<uint64_t> RegisterFile::GetFprValues() const {
   return {fpr_.begin(), fpr_.end()};
 }
 
+std::vector<uint64_t> RegisterFile::GetVectorValues() const {
+  return vregs_;
+}
+
+void RegisterFile::SetVectorState(const std::vector<uint64_t> &words, uint64_t vl, uint64_t vtype) {
+  if (words.size() != vregs_.size()) throw std::invalid_argument("Vector register file of a different VLEN");
+  vregs_ = words;
+  vl_ = vl;
+  vtype_ = vtype;
+}
+
 void RegisterFile::ModifyRegister(const std::string &reg_name, uint64_t value) {
   std::string reg_name_n = reg_alias_to_name.at(reg_name);
   if (IsValidGeneralPurposeRegister(reg_name_n)) {
-    WriteGpr(std::stoi(reg_name_n.substr(1)), value);
+    WriteGprChecked(std::stoi(reg_name_n.substr(1)), value);
   } else if (IsValidFloatingPointRegister(reg_name_n)) {
-    WriteFpr(std::stoi(reg_name_n.substr(1)), value);
+    WriteFprChecked(std::stoi(reg_name_n.substr(1)), value);
   } else if (IsValidCsr(reg_name_n)) {
-    WriteCsr(csr_to_address.at(reg_name_n), value);
+    WriteCsrChecked(csr_to_address.at(reg_name_n), value);
   } else {
     throw std::invalid_argument("Invalid register name: " + reg_name_n);
   }
@@ -104,14 +164,70 @@ const std::unordered_set<std::string> valid_floating_point_registers = {
     "ft28", "ft29", "ft30", "ft31",
 };
 
+const std::unordered_set<std::string> valid_vector_registers = {
+    "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9",
+    "v10", "v11", "v12", "v13", "v14", "v15", "v16", "v17", "v18", "v19",
+    "v20", "v21", "v22", "v23", "v24", "v25", "v26", "v27", "v28", "v29",
+    "v30", "v31",
+};
+
+const std::array<CsrInfo, 12> implemented_csrs = {{
+    {"fflags", 0x001, 0x1f},
+    {"frm", 0x002, 0b111},
+    {"fcsr", 0x003, 0xff},
+    {"mcycle", 0xb00, ~uint64_t{0}},
+    {"minstret", 0xb02, ~uint64_t{0}},
+    {"cycle", 0xc00, 0},
+    {"time", 0xc01, 0},
+    {"instret", 0xc02, 0},
+    {"vl", 0xc20, 0},
+    {"vtype", 0xc21, 0},
+    {"vlenb", 0xc22, 0},
+    {"mhartid", 0xf14, 0},
+}};
+
+const CsrInfo *FindCsr(size_t address) {
+  auto it = std::find_if(implemented_csrs.begin(), implemented_csrs.end(),
+                         [address](const CsrInfo &csr) { return csr.address == address; });
+  return it == implemented_csrs.end() ? nullptr : &*it;
+}
+
+bool IsImplementedCsr(size_t address) {
+  return FindCsr(address) != nullptr;
+}
+
+CsrAccess CheckCsrAccess(size_t address, bool write) {
+  const CsrInfo *csr = FindCsr(address);
+  if (!csr) {
+    return CsrAccess::kUnimplemented;
+  }
+  return write && csr->write_mask == 0 ? CsrAccess::kReadOnly : CsrAccess::kOk;
+}
+
+bool IsCounterCsr(size_t address) {
+  return address == 0xb00 || address == 0xb02 || (address >= 0xc00 && address <= 0xc02);
+}
+
 const std::unordered_set<std::string> valid_csr_registers = {
-    "fflags", "frm", "fcsr"
+    "fflags", "frm", "fcsr",
+    "cycle", "time", "instret", "mcycle", "minstret",
+    "vl", "vtype", "vlenb",
+    "mhartid",
 };
 
 const std::unordered_map<std::string, int> csr_to_address{
     {"fflags", 0x001},
     {"frm", 0x002},
     {"fcsr", 0x003},
+    {"mcycle", 0xb00},
+    {"minstret", 0xb02},
+    {"cycle", 0xc00},
+    {"time", 0xc01},
+    {"instret", 0xc02},
+    {"vl", 0xc20},
+    {"vtype", 0xc21},
+    {"vlenb", 0xc22},
+    {"mhartid", 0xf14},
 };
 
 const std::unordered_map<std::string, std::string> reg_alias_to_name = {
@@ -251,6 +367,14 @@ const std::unordered_map<std::string, std::string> reg_alias_to_name = {
     {"fflags", "fflags"},
     {"frm", "frm"},
     {"fcsr", "fcsr"},
+    {"cycle", "cycle"},
+    {"time", "time"},
+    {"instret", "instret"},
+    {"mcycle", "mcycle"},
+    {"minstret", "minstret"},
+    {"vl", "vl"},
+    {"vtype", "vtype"},
+    {"vlenb", "vlenb"},
 
 };
 
@@ -262,6 +386,10 @@ bool IsValidFloatingPointRegister(const std::string &reg) {
   return valid_floating_point_registers.find(reg)!=valid_floating_point_registers.end();
 }
 
+bool IsValidVectorRegister(const std::string &reg) {
+  return valid_vector_registers.find(reg)!=valid_vector_registers.end();
+}
+
 bool IsValidCsr(const std::string &reg) {
   return valid_csr_registers.find(reg)!=valid_csr_registers.end();
 }
\ No newline at end of file
@@ -0,0 +1,221 @@
+/**
+ * @file branch_trace.cpp
+ * @brief Implementation of the branch trace file format and the trace replay harness
+ */
+
+#include "vm/rv5s/branch_prediction/branch_trace.h"
+#include "vm/rv5s/branch_prediction/static_predictors.h"
+#include "vm/rv5s/branch_prediction/dynamic_1bit_predictor.h"
+#include "vm/rv5s/branch_prediction/dynamic_2bit_predictor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+constexpr char kTraceMagic[4] = {'R', 'V', 'B', 'T'};
+constexpr uint32_t kTraceVersion = 2;
+constexpr uint32_t kTraceVersionConditional = 1;                               // no type, conditional branches only
+constexpr uint64_t kRecordBytes = 2 * sizeof(uint64_t) + 2 * sizeof(uint8_t); // pc, target, taken, type
+constexpr uint64_t kConditionalRecordBytes = 2 * sizeof(uint64_t) + sizeof(uint8_t);
+
+bool isLink(uint32_t reg) {
+    return reg == 1 || reg == 5;
+}
+
+template <typename T>
+void writeRaw(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void readRaw(std::ifstream &file, T &value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+BranchType jumpType(uint32_t instruction) {
+    uint32_t rd = (instruction >> 7) & 0b11111;
+    uint32_t rs1 = (instruction >> 15) & 0b11111;
+    if ((instruction & 0b1111111) == 0b1101111) {       // jal
+        return isLink(rd) ? BranchType::kCall : BranchType::kJump;
+    }
+    if (isLink(rd)) {
+        return BranchType::kIndirectCall;
+    }
+    return isLink(rs1) ? BranchType::kReturn : BranchType::kIndirectJump;
+}
+
+void BranchTrace::save(const std::filesystem::path &filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Unable to open branch trace file for writing: " + filename.string());
+    }
+
+    file.write(kTraceMagic, sizeof(kTraceMagic));
+    writeRaw(file, kTraceVersion);
+    writeRaw(file, instruction_count_);
+    writeRaw(file, static_cast<uint64_t>(records_.size()));
+    for (const BranchTraceRecord &record : records_) {
+        writeRaw(file, record.pc);
+        writeRaw(file, record.target);
+        writeRaw(file, static_cast<uint8_t>(record.taken));
+        writeRaw(file, static_cast<uint8_t>(record.type));
+    }
+
+    if (!file) {
+        throw std::runtime_error("Error while writing branch trace file: " + filename.string());
+    }
+}
+
+BranchTrace BranchTrace::load(const std::filesystem::path &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Unable to open branch trace file: " + filename.string());
+    }
+
+    char magic[4] = {};
+    uint32_t version = 0;
+    file.read(magic, sizeof(magic));
+    readRaw(file, version);
+    if (!file || !std::equal(std::begin(magic), std::end(magic), std::begin(kTraceMagic)) ||
+        (version != kTraceVersion && version != kTraceVersionConditional)) {
+        throw std::runtime_error("Not a supported branch trace file: " + filename.string());
+    }
+
+    BranchTrace trace;
+    uint64_t count = 0;
+    readRaw(file, trace.instruction_count_);
+    readRaw(file, count);
+
+    // the count comes from the file, a corrupt one must not size the allocation
+    std::streamoff header_end = file.tellg();
+    std::error_code size_error;
+    uint64_t file_size = std::filesystem::file_size(filename, size_error);
+    if (!file || header_end < 0 || size_error ||
+        count > (file_size - static_cast<uint64_t>(header_end)) /
+                    (version == kTraceVersion ? kRecordBytes : kConditionalRecordBytes)) {
+        throw std::runtime_error("Truncated branch trace file: " + filename.string());
+    }
+
+    trace.records_.reserve(count);
+    for (uint64_t i = 0; i < count && file; ++i) {
+        BranchTraceRecord record;
+        uint8_t taken = 0;
+        readRaw(file, record.pc);
+        readRaw(file, record.target);
+        readRaw(file, taken);
+        record.taken = (taken != 0);
+        if (version == kTraceVersion) {
+            uint8_t type = 0;
+            readRaw(file, type);
+            if (type > static_cast<uint8_t>(BranchType::kReturn)) {
+                throw std::runtime_error("Unknown branch type in branch trace file: " + filename.string());
+            }
+            record.type = static_cast<BranchType>(type);
+        }
+        trace.records_.push_back(record);
+    }
+
+    if (!file) {
+        throw std::runtime_error("Truncated branch trace file: " + filename.string());
+    }
+    return trace;
+}
+
+std::unique_ptr<IBranchPredictor> makeBranchPredictor(vm_config::BranchPredictorType type, std::size_t table_size) {
+    switch (type) {
+        case vm_config::BranchPredictorType::STATIC_NOT_TAKEN:
+            return std::make_unique<StaticNotTakenPredictor>();
+        case vm_config::BranchPredictorType::STATIC_TAKEN:
+            return std::make_unique<StaticTakenPredictor>();
+        case vm_config::BranchPredictorType::DYNAMIC_1BIT:
+            return std::make_unique<Dynamic1BitPredictor>(table_size);
+        case vm_config::BranchPredictorType::DYNAMIC_2BIT:
+            return std::make_unique<Dynamic2BitPredictor>(table_size);
+        default:
+            throw std::invalid_argument("Branch predictor type not supported for replay");
+    }
+}
+
+std::string branchPredictorName(vm_config::BranchPredictorType type) {
+    switch (type) {
+        case vm_config::BranchPredictorType::STATIC_NOT_TAKEN: return "static_not_taken";
+        case vm_config::BranchPredictorType::STATIC_TAKEN: return "static_taken";
+        case vm_config::BranchPredictorType::DYNAMIC_1BIT: return "dynamic_1bit";
+        case vm_config::BranchPredictorType::DYNAMIC_2BIT: return "dynamic_2bit";
+        case vm_config::BranchPredictorType::TOURNAMENT: return "tournament";
+    }
+    return "unknown";
+}
+
+ReplayResult replayTrace(const BranchTrace &trace, const ReplayConfig &config) {
+    std::unique_ptr<IBranchPredictor> predictor = makeBranchPredictor(config.type, config.table_size);
+
+    ReplayResult result;
+    for (const BranchTraceRecord &record : trace.getRecords()) {
+        if (record.type != BranchType::kConditional) {
+            continue;
+        }
+        bool predicted = predictor->getPrediction(record.pc);
+        predictor->updateState(record.pc, predicted, record.taken);
+        ++result.branches;
+    }
+
+    result.config = config;
+    result.mispredictions = predictor->getMispredictions();
+    if (result.branches) {
+        result.accuracy = 100.0 * static_cast<double>(result.branches - result.mispredictions) / static_cast<double>(result.branches);
+    }
+    if (trace.getInstructionCount()) {
+        result.mpki = 1000.0 * static_cast<double>(result.mispredictions) / static_cast<double>(trace.getInstructionCount());
+    }
+    return result;
+}
+
+std::vector<ReplayResult> replayTraceParallel(const BranchTrace &trace, const std::vector<ReplayConfig> &configs, unsigned int num_threads) {
+    std::vector<ReplayResult> results(configs.size());
+    if (configs.empty()) {
+        return results;
+    }
+
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min<unsigned int>(num_threads, configs.size());
+
+    // the trace is shared read-only, every worker owns its predictor -> workers only contend on the job index
+    std::atomic<std::size_t> next_job{0};
+    std::vector<std::exception_ptr> errors(configs.size());
+    auto worker = [&]() {
+        for (std::size_t job = next_job++; job < configs.size(); job = next_job++) {
+            try {
+                results[job] = replayTrace(trace, configs[job]);
+            } catch (...) {
+                errors[job] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(num_threads);
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread &t : pool) {
+        t.join();
+    }
+
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return results;
+}
@@ -4,17 +4,48 @@
  */
 
 #include "vm/rv5s/branch_prediction/dynamic_1bit_predictor.h"
+#include "vm/state_file.h"
 
 bool Dynamic1BitPredictor::getPrediction(uint64_t pc) {
-    if(bht_.find(pc) == bht_.end())         // pc not found in bht
+    auto it = bht_.find(index(pc));
+    if(it == bht_.end())                    // pc not found in bht
         return false;                       // default -> branch not taken
 
-    return bht_[pc];        // return the prediction
+    return it->second;      // return the prediction
+}
+PredictorEntry Dynamic1BitPredictor::saveEntry(uint64_t pc) const {
+    auto it = bht_.find(index(pc));
+    return {static_cast<uint8_t>(it != bht_.end() && it->second), no_mispredictions_};
+}
+void Dynamic1BitPredictor::restoreEntry(uint64_t pc, const PredictorEntry &entry) {
+    bht_[index(pc)] = entry.state != 0;
+    no_mispredictions_ = entry.mispredictions;
+}
+void Dynamic1BitPredictor::saveTable(StateWriter &writer) const {
+    writer.write(no_mispredictions_);
+    writer.write(static_cast<uint64_t>(bht_.size()));
+    for (const auto &[index, state] : bht_) {
+        writer.write(index);
+        writer.write(static_cast<uint8_t>(state));
+    }
+}
+void Dynamic1BitPredictor::loadTable(StateReader &reader) {
+    uint64_t count = 0;
+    reader.read(no_mispredictions_);
+    reader.read(count);
+    bht_.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t index = 0;
+        uint8_t state = 0;
+        if (reader.read(index) && reader.read(state)) {
+            bht_[index] = state != 0;
+        }
+    }
 }
 void Dynamic1BitPredictor::updateState(uint64_t pc, bool predicted_outcome, bool actual_outcome) {
     if (predicted_outcome != actual_outcome) {
         no_mispredictions_++;
     }
 
-    bht_[pc] = actual_outcome;
+    bht_[index(pc)] = actual_outcome;
 }
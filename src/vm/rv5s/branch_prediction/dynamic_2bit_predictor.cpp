@@ -4,23 +4,52 @@
  */
 
 #include "vm/rv5s/branch_prediction/dynamic_2bit_predictor.h"
+#include "vm/state_file.h"
 
 bool Dynamic2BitPredictor::getPrediction(uint64_t pc) {
-    if(bht_.find(pc) == bht_.end())         // pc not found in bht
+    auto it = bht_.find(index(pc));
+    if(it == bht_.end())                    // pc not found in bht
         return false;                       // default -> branch not taken
 
-    State state = bht_[pc];
+    State state = it->second;
     return (state == State::TWO_TAKEN) || (state == State::ONE_TAKEN);      
 }
+PredictorEntry Dynamic2BitPredictor::saveEntry(uint64_t pc) const {
+    auto it = bht_.find(index(pc));
+    return {static_cast<uint8_t>(it != bht_.end() ? it->second : State::TWO_NOT_TAKEN), no_mispredictions_};
+}
+void Dynamic2BitPredictor::restoreEntry(uint64_t pc, const PredictorEntry &entry) {
+    bht_[index(pc)] = static_cast<State>(entry.state);
+    no_mispredictions_ = entry.mispredictions;
+}
+void Dynamic2BitPredictor::saveTable(StateWriter &writer) const {
+    writer.write(no_mispredictions_);
+    writer.write(static_cast<uint64_t>(bht_.size()));
+    for (const auto &[index, state] : bht_) {
+        writer.write(index);
+        writer.write(static_cast<uint8_t>(state));
+    }
+}
+void Dynamic2BitPredictor::loadTable(StateReader &reader) {
+    uint64_t count = 0;
+    reader.read(no_mispredictions_);
+    reader.read(count);
+    bht_.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t index = 0;
+        uint8_t state = 0;
+        if (reader.read(index) && reader.read(state)) {
+            bht_[index] = static_cast<State>(state);
+        }
+    }
+}
 void Dynamic2BitPredictor::updateState(uint64_t pc, bool predicted_outcome, bool actual_outcome) {
     if (predicted_outcome != actual_outcome) {
         no_mispredictions_++;
     }
 
-    State state = bht_[pc];
-    if(bht_.find(pc) == bht_.end()) {        // pc not found in bht
-        bht_[pc] = State::TWO_NOT_TAKEN;
-    }
+    State &entry = bht_[index(pc)];         // pc not found in bht -> value initialised to TWO_NOT_TAKEN
+    State state = entry;
 
     // updating state
     if(actual_outcome) {            // branch was taken
@@ -39,5 +68,5 @@ void Dynamic2BitPredictor::updateState(uint64_t pc, bool predicted_outcome, bool
             case State::TWO_NOT_TAKEN:   break;
         }
     }
-    bht_[pc] = state;
+    entry = state;
 }
@@ -0,0 +1,27 @@
+/**
+ * @file i_branch_predictor.cpp
+ * @brief State file section shared by all the branch predictors
+ */
+
+#include "vm/rv5s/branch_prediction/i_branch_predictor.h"
+#include "vm/state_file.h"
+
+void IBranchPredictor::saveState(StateWriter &writer) const {
+    writer.beginSection(state_file::kTagPredictor);
+    writer.write(static_cast<uint8_t>(getPredictorType()));
+    saveTable(writer);
+    writer.endSection();
+}
+
+void IBranchPredictor::loadState(StateReader &reader) {
+    uint8_t type = 0;
+    if (!reader.read(type)) {
+        return;
+    }
+    if (type != static_cast<uint8_t>(getPredictorType())) {
+        std::cerr << "The saved branch predictor is of another type, it starts empty" << std::endl;
+        reader.skipSection();
+        return;
+    }
+    loadTable(reader);
+}
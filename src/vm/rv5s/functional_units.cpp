@@ -0,0 +1,51 @@
+/**
+ * @file functional_units.cpp
+ * @brief Latency and throughput of the execution units per alu operation
+ */
+
+#include "vm/rv5s/functional_units.h"
+
+using alu::AluOp;
+
+FuTiming getFuTiming(AluOp op) {
+    switch (op) {
+        case AluOp::kMul: case AluOp::kMulh: case AluOp::kMulhsu: case AluOp::kMulhu: case AluOp::kMulw:
+            return {FuUnit::INT_MUL, 3, true};
+
+        case AluOp::kDiv: case AluOp::kDivu: case AluOp::kDivw: case AluOp::kDivuw:
+        case AluOp::kRem: case AluOp::kRemu: case AluOp::kRemw: case AluOp::kRemuw:
+            return {FuUnit::INT_DIV, 20, false};
+
+        case AluOp::FADD_S: case AluOp::FSUB_S: case AluOp::FADD_D: case AluOp::FSUB_D:
+            return {FuUnit::FP_ADD, 4, true};
+
+        case AluOp::FMUL_S: case AluOp::FMUL_D:
+            return {FuUnit::FP_MUL, 4, true};
+
+        case AluOp::kFmadd_s: case AluOp::kFmsub_s: case AluOp::kFnmadd_s: case AluOp::kFnmsub_s:
+        case AluOp::FMADD_D: case AluOp::FMSUB_D: case AluOp::FNMADD_D: case AluOp::FNMSUB_D:
+            return {FuUnit::FP_FMA, 5, true};
+
+        case AluOp::FDIV_S: case AluOp::FSQRT_S:
+            return {FuUnit::FP_DIV_SQRT, 12, false};
+        case AluOp::FDIV_D: case AluOp::FSQRT_D:
+            return {FuUnit::FP_DIV_SQRT, 20, false};
+
+        case AluOp::FCVT_W_S: case AluOp::FCVT_WU_S: case AluOp::FCVT_L_S: case AluOp::FCVT_LU_S:
+        case AluOp::FCVT_S_W: case AluOp::FCVT_S_WU: case AluOp::FCVT_S_L: case AluOp::FCVT_S_LU:
+        case AluOp::FCVT_W_D: case AluOp::FCVT_WU_D: case AluOp::FCVT_L_D: case AluOp::FCVT_LU_D:
+        case AluOp::FCVT_D_W: case AluOp::FCVT_D_WU: case AluOp::FCVT_D_L: case AluOp::FCVT_D_LU:
+        case AluOp::FCVT_S_D: case AluOp::FCVT_D_S:
+            return {FuUnit::FP_MISC, 2, true};
+
+        case AluOp::FSGNJ_S: case AluOp::FSGNJN_S: case AluOp::FSGNJX_S: case AluOp::FMIN_S: case AluOp::FMAX_S:
+        case AluOp::FEQ_S: case AluOp::FLT_S: case AluOp::FLE_S: case AluOp::FCLASS_S:
+        case AluOp::FSGNJ_D: case AluOp::FSGNJN_D: case AluOp::FSGNJX_D: case AluOp::FMIN_D: case AluOp::FMAX_D:
+        case AluOp::FEQ_D: case AluOp::FLT_D: case AluOp::FLE_D: case AluOp::FCLASS_D:
+        case AluOp::FMV_X_W: case AluOp::FMV_W_X: case AluOp::FMV_X_D: case AluOp::FMV_D_X:
+            return {FuUnit::FP_MISC, 1, true};
+
+        default:
+            return {FuUnit::INT_ALU, 1, true};
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ * @file pipeline_trace.cpp
+ * @brief Implementation of the Kanata pipeline trace writer
+ */
+
+#include "vm/rv5s/pipeline_trace.h"
+
+#include <charconv>
+
+namespace {
+    constexpr std::array<std::string_view, 5> kStageNames = {"F", "D", "X", "M", "W"};
+}
+
+PipelineTrace::~PipelineTrace() {
+    close();
+}
+
+bool PipelineTrace::open(const std::filesystem::path &filename) {
+    close();
+    file_.open(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    buffer_.clear();
+    buffer_.reserve(kBufferSize + 256);
+    retiring_.clear();
+    last_id_.fill(0);
+    next_id_ = 1;
+    retired_ = 0;
+    cycle_ = 0;
+
+    append("Kanata\t0004\nC=\t0\n");
+    return true;
+}
+
+void PipelineTrace::close() {
+    if (!isOpen()) {
+        return;
+    }
+    advanceTo(cycle_ + 1);          // lets the instructions retired in the last cycle end
+    writeBuffer();
+    file_.close();
+}
+
+void PipelineTrace::advanceTo(uint64_t cycle) {
+    if (cycle <= cycle_) {
+        return;
+    }
+    append("C\t");
+    appendNumber(cycle - cycle_);
+    append("\n");
+    cycle_ = cycle;
+
+    for (uint64_t id : retiring_) {
+        endInstruction(id, false);
+    }
+    retiring_.clear();
+}
+
+uint64_t PipelineTrace::startInstruction(uint64_t pc, uint32_t instruction) {
+    uint64_t id = next_id_++;
+    uint64_t kanata_id = id - 1;        // kanata ids count from 0, 0 is "not traced" in the pipeline registers
+
+    append("I\t");
+    appendNumber(kanata_id);
+    append("\t");
+    appendNumber(kanata_id);
+    append("\t0\nL\t");
+    appendNumber(kanata_id);
+    append("\t0\t");
+    appendHex(pc);
+    append(": ");
+    appendHex(instruction);
+    append("\n");
+
+    startStage(id, Stage::FETCH);
+    return id;
+}
+
+void PipelineTrace::startStage(uint64_t id, Stage stage) {
+    // starting a stage ends the previous one of the same lane in konata
+    last_id_[static_cast<std::size_t>(stage)] = id;
+    append("S\t");
+    appendNumber(id - 1);
+    append("\t0\t");
+    append(kStageNames[static_cast<std::size_t>(stage)]);
+    append("\n");
+}
+
+void PipelineTrace::endInstruction(uint64_t id, bool squashed) {
+    if (!isOpen()) {
+        return;
+    }
+    append("R\t");
+    appendNumber(id - 1);
+    append("\t");
+    appendNumber(squashed ? 0 : retired_++);
+    append(squashed ? "\t1\n" : "\t0\n");
+}
+
+void PipelineTrace::append(std::string_view text) {
+    buffer_.append(text);
+    if (buffer_.size() >= kBufferSize) {
+        writeBuffer();
+    }
+}
+
+void PipelineTrace::appendNumber(uint64_t value) {
+    char digits[20];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+    append(std::string_view(digits, end - digits));
+}
+
+void PipelineTrace::appendHex(uint64_t value) {
+    char digits[18] = {'0', 'x'};
+    auto [end, ec] = std::to_chars(digits + 2, digits + sizeof(digits), value, 16);
+    append(std::string_view(digits, end - digits));
+}
+
+void PipelineTrace::writeBuffer() {
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
@@ -7,6 +7,9 @@
 #include "vm/rv5s/rv5s_control_unit.h"
 #include "vm/rv5s/pipeline_registers.h"
 #include "vm/rv5s/rv5s_hazard_unit.h"
+#include "vm/lockstep_checker.h"
+#include "vm/state_file.h"
+#include "vm/vector_unit.h"
 
 #include "vm/rv5s/rv5s_forwarding_unit.h" 
 #include "vm/rv5s/branch_prediction/static_predictors.h"
@@ -31,7 +34,6 @@
 #include <atomic>
 
 using instruction_set::Instruction;
-using instruction_set::get_instr_encoding;
 using instruction_type::MemReadOp;
 using instruction_type::MemWriteOp;
 using instruction_type::WriteBackSrc;
@@ -76,11 +78,27 @@ void RV5SEXVM::Reset() {
     ipc_ = 0.0;
     stall_cycles_ = 0;
     branch_mispredictions_ = 0;
+    reservation_ = {};
+    branch_profile_.Clear();
+    stall_accounting_.Clear();
+
+    multi_cycle_units_ = vm_config::config.getMultiCycleUnits();
+    vector_lanes_ = vm_config::config.getVectorLanes();
+    fu_in_flight_.clear();
+    fu_structural_stalls_ = 0;
+    long_latency_stalls_ = 0;
 
     stall_request_= false;
     flush_pipeline_ = false;
+    flush_reason_ = StallReason::BRANCH_MISPREDICT;
     forwarding_enabled_ = vm_config::config.getDataHazardMode() == DataHazardMode::FORWARDING;
     setBranchPredictorType(vm_config::config.getBranchPredictorType());
+    control_unit_.enableFpCsrDecode(true);
+    control_unit_.enableVectorDecode(true);
+    control_unit_.enableAtomicDecode(true);
+    alu_.setSoftFloat(vm_config::config.getFpEngine() == vm_config::FpEngine::SOFT);
+    journal_.setDepth(vm_config::config.getUndoDepth());
+    redo_cycles_ = 0;
 
     registers_.Reset();
     memory_controller_.Reset();
@@ -96,6 +114,13 @@ void RV5SEXVM::Reset() {
     next_ex_mem_reg_ = CreateBubble<EX_MEM_Reg>();
     next_mem_wb_reg_ = CreateBubble<MEM_WB_Reg>();
 
+    const std::string &trace_path = vm_config::config.getPipelineTracePath();
+    if(trace_path.empty()) {
+        pipeline_trace_.close();
+    } else if(!pipeline_trace_.open(trace_path)) {
+        std::cerr << "Could not open the pipeline trace file: " << trace_path << std::endl;
+    }
+
     if(!silent_mode_) {
         DumpRegisters(globals::registers_dump_file_path, registers_);
         DumpState(globals::vm_state_dump_file_path);
@@ -111,10 +136,26 @@ void RV5SEXVM::Step() {
         return;
     }
 
+    redo_cycles_ = 0;                   // a new cycle replaces the undone ones
+    if(journal_.enabled()) {
+        saveCycle();
+    }
+
     stall_request_ = false;
     flush_pipeline_ = false; 
+    pipeline_trace_.beginCycle(cycle_s_);
 
+    completeFunctionalUnits();
     WriteBack_Stage();
+    if(lockstep_checker_ && mem_wb_reg_.is_valid) {
+        RetiredInstruction retired;
+        retired.pc = mem_wb_reg_.pc;
+        retired.writes_rd = mem_wb_reg_.control.reg_write;
+        retired.rd_fp = mem_wb_reg_.control.rd_fp;
+        retired.rd_index = mem_wb_reg_.rd_index;
+        retired.is_syscall = mem_wb_reg_.control.is_syscall;
+        CheckRetired(retired);
+    }
     Memory_Stage();
     Execute_Stage();
     Decode_Stage();
@@ -156,16 +197,20 @@ void RV5SEXVM::Step() {
     }
 
     bool all_instructions_fetched = (program_counter_ >= program_size_);
-    bool is_pipeline_empty = !if_id_reg_.is_valid && !id_ex_reg_.is_valid && !ex_mem_reg_.is_valid && !mem_wb_reg_.is_valid;
+    bool is_pipeline_empty = !if_id_reg_.is_valid && !id_ex_reg_.is_valid && !ex_mem_reg_.is_valid && !mem_wb_reg_.is_valid && fu_in_flight_.empty();
 
     if(all_instructions_fetched && is_pipeline_empty) {
+        pipeline_trace_.close();
         RequestStop();
         std::cout << "VM_PROGRAM_END" << std::endl;
         output_status_ = "VM_PROGRAM_END";
+        CheckLockstepEnd();
         
         if(!silent_mode_) {
             DumpState(globals::vm_state_dump_file_path);        // final state with updated output status
         }
+    } else if(LockstepDiverged()) {
+        std::cout << "VM_LOCKSTEP_DIVERGED" << std::endl;
     } else {
         std::cout << "VM_STEP_COMPLETED" << std::endl;
         output_status_ = "VM_STEP_COMPLETED";
@@ -210,18 +255,147 @@ void RV5SEXVM::DebugRun() {
 }
 
 void RV5SEXVM::Undo() {
-    std::cerr << "Undo/Redo Feature is not available in multi-stage pipelining mode." << std::endl;    
+    if(journal_.empty()) {
+        std::cout << "VM_NO_MORE_UNDO" << std::endl;
+        output_status_ = "VM_NO_MORE_UNDO";
+        return;
+    }
+
+    restoreCycle(journal_.undoCycle(registers_, memory_controller_, *branch_predictor_, branch_profile_));
+    redo_cycles_++;
+
+    // neither the golden vm nor the trace file can step backwards
+    if(lockstep_checker_) {
+        std::cerr << "Lockstep check stopped by undo." << std::endl;
+        lockstep_checker_.reset();
+    }
+    if(pipeline_trace_.isOpen()) {
+        std::cerr << "Pipeline trace closed by undo." << std::endl;
+        pipeline_trace_.close();
+    }
+
+    std::cout << "Program Counter: " << program_counter_ << std::endl;
+    output_status_ = "VM_UNDO_COMPLETED";
+    std::cout << "VM_UNDO_COMPLETED" << std::endl;
+
+    if(!silent_mode_) {
+        DumpRegisters(globals::registers_dump_file_path, registers_);
+        DumpState(globals::vm_state_dump_file_path);
+    }
 }
 
 void RV5SEXVM::Redo() {
-    std::cerr << "Undo/Redo Feature is not available in multi-stage pipelining mode." << std::endl;
+    if(redo_cycles_ == 0) {
+        std::cout << "VM_NO_MORE_REDO" << std::endl;
+        return;
+    }
+
+    // the pipeline is deterministic, running the undone cycle again redoes it
+    unsigned int remaining = redo_cycles_ - 1;
+    Step();
+    redo_cycles_ = remaining;
+}
+
+void RV5SEXVM::saveCycle() {
+    CycleSnapshot &snapshot = journal_.beginCycle();
+    snapshot.saveCounters(*this);
+    snapshot.if_id = if_id_reg_;
+    snapshot.id_ex = id_ex_reg_;
+    snapshot.ex_mem = ex_mem_reg_;
+    snapshot.mem_wb = mem_wb_reg_;
+    snapshot.next_if_id = next_if_id_reg_;
+    snapshot.next_id_ex = next_id_ex_reg_;
+    snapshot.next_ex_mem = next_ex_mem_reg_;
+    snapshot.next_mem_wb = next_mem_wb_reg_;
+    snapshot.fu_in_flight = fu_in_flight_;
+    snapshot.fu_structural_stalls = fu_structural_stalls_;
+    snapshot.long_latency_stalls = long_latency_stalls_;
+    snapshot.flush_reason = flush_reason_;
+}
+
+void RV5SEXVM::restoreCycle(const CycleSnapshot &snapshot) {
+    snapshot.restoreCounters(*this);
+    if_id_reg_ = snapshot.if_id;
+    id_ex_reg_ = snapshot.id_ex;
+    ex_mem_reg_ = snapshot.ex_mem;
+    mem_wb_reg_ = snapshot.mem_wb;
+    next_if_id_reg_ = snapshot.next_if_id;
+    next_id_ex_reg_ = snapshot.next_id_ex;
+    next_ex_mem_reg_ = snapshot.next_ex_mem;
+    next_mem_wb_reg_ = snapshot.next_mem_wb;
+    fu_in_flight_ = snapshot.fu_in_flight;
+    fu_structural_stalls_ = snapshot.fu_structural_stalls;
+    long_latency_stalls_ = snapshot.long_latency_stalls;
+    flush_reason_ = snapshot.flush_reason;
+}
+
+uint64_t RV5SEXVM::ResumePc() const {
+    return oldestPipelinePc(if_id_reg_, id_ex_reg_, ex_mem_reg_, mem_wb_reg_, program_counter_);
+}
+
+void RV5SEXVM::SaveMicroarchState(StateWriter &writer) {
+    branch_predictor_->saveState(writer);
+
+    writer.beginSection(state_file::kTagExPipeline);
+    writer.write(program_counter_);
+    writer.write(if_id_reg_);
+    writer.write(id_ex_reg_);
+    writer.write(ex_mem_reg_);
+    writer.write(mem_wb_reg_);
+    writer.write(next_if_id_reg_);
+    writer.write(next_id_ex_reg_);
+    writer.write(next_ex_mem_reg_);
+    writer.write(next_mem_wb_reg_);
+    writer.write(static_cast<uint64_t>(fu_in_flight_.size()));
+    for (const InFlightFuOp &op : fu_in_flight_) {
+        writer.write(op);
+    }
+    writer.write(fu_structural_stalls_);
+    writer.write(long_latency_stalls_);
+    writer.write(flush_reason_);
+    writer.endSection();
+}
+
+bool RV5SEXVM::LoadMicroarchSection(StateReader &reader, uint32_t tag) {
+    if (tag == state_file::kTagPredictor) {
+        branch_predictor_->loadState(reader);
+        return true;
+    }
+    if (tag != state_file::kTagExPipeline) {
+        return false;
+    }
+    reader.read(program_counter_);
+    reader.read(if_id_reg_);
+    reader.read(id_ex_reg_);
+    reader.read(ex_mem_reg_);
+    reader.read(mem_wb_reg_);
+    reader.read(next_if_id_reg_);
+    reader.read(next_id_ex_reg_);
+    reader.read(next_ex_mem_reg_);
+    reader.read(next_mem_wb_reg_);
+    uint64_t in_flight = 0;
+    reader.read(in_flight);
+    fu_in_flight_.clear();
+    for (uint64_t i = 0; i < in_flight && reader.good(); ++i) {
+        InFlightFuOp op;
+        reader.read(op);
+        fu_in_flight_.push_back(op);
+    }
+    reader.read(fu_structural_stalls_);
+    reader.read(long_latency_stalls_);
+    reader.read(flush_reason_);
+
+    // the trace restarted with the reset, the ids of the instructions in flight are not in it
+    if_id_reg_.trace_id = id_ex_reg_.trace_id = ex_mem_reg_.trace_id = mem_wb_reg_.trace_id = 0;
+    next_if_id_reg_.trace_id = next_id_ex_reg_.trace_id = next_ex_mem_reg_.trace_id = next_mem_wb_reg_.trace_id = 0;
+    return true;
 }
 
 void RV5SEXVM::Fetch_Stage() {
     
     if (flush_pipeline_) { 
         stall_cycles_++;
-        next_if_id_reg_ = CreateBubble<IF_ID_Reg>();
+        next_if_id_reg_ = CreateBubble<IF_ID_Reg>(flush_reason_);
         return;
     }
 
@@ -233,10 +407,12 @@ void RV5SEXVM::Fetch_Stage() {
 
     // the Memory::ReadWord function throws a std::out_of_range exception if an invalid memory address is read. Safety Check -> 
     try {
-        uint32_t instruction = memory_controller_.ReadWord(program_counter_);
+        uint8_t length = 4;
+        uint32_t instruction = FetchInstruction(program_counter_, length);
         next_if_id_reg_.instruction = instruction;
         next_if_id_reg_.pc = program_counter_;       // original pc stored 
-        UpdateProgramCounter(4);
+        next_if_id_reg_.trace_id = pipeline_trace_.fetch(program_counter_, instruction);
+        UpdateProgramCounter(length);
         next_if_id_reg_.pc_inc = program_counter_; // the incremented pc to be stored in the pipeline register
         next_if_id_reg_.is_valid = true;
     } catch(const std::exception& e) {
@@ -253,14 +429,15 @@ void RV5SEXVM::Decode_Stage() {
     if (flush_pipeline_) {          // set to true in case of a branch misprediction
         if(if_id_reg_.is_valid) {
             stall_cycles_++; 
+            pipeline_trace_.squash(if_id_reg_.trace_id);
         }
-        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>();
+        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>(flush_reason_);
         return;
     }
 
     if(!if_id_reg_.is_valid)
     {
-        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>();
+        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>(if_id_reg_.bubble_reason);
         return;
     }
 
@@ -268,6 +445,8 @@ void RV5SEXVM::Decode_Stage() {
     uint32_t instruction = if_id_reg_.instruction;
     ControlSignals control = control_unit_.getControlSignals(instruction);
 
+    pipeline_trace_.enterStage(if_id_reg_.trace_id, PipelineTrace::Stage::DECODE);
+    next_id_ex_reg_.trace_id = if_id_reg_.trace_id;
     next_id_ex_reg_.pc = if_id_reg_.pc;
     next_id_ex_reg_.pc_inc = if_id_reg_.pc_inc;
     next_id_ex_reg_.is_valid = if_id_reg_.is_valid;
@@ -278,35 +457,47 @@ void RV5SEXVM::Decode_Stage() {
     }
 
     uint8_t opcode = instruction & 0b1111111;
-    uint8_t funct3 = (instruction >> 12) & 0b111;
 
-    if(opcode == get_instr_encoding(Instruction::kecall).opcode && 
-      funct3 == get_instr_encoding(Instruction::kecall).funct3) {
-        control.is_syscall = true;
-        next_id_ex_reg_.control = control;
+    next_id_ex_reg_.instruction = instruction;
+    next_id_ex_reg_.control = control;
+
+    // csr instructions are read-modify-write in EX, an ecall runs in WB -> keep them in program order with their neighbours
+    if(hazard_unit_.detectSerializationHazard(control, id_ex_reg_, ex_mem_reg_) || (control.is_syscall && !fu_in_flight_.empty())) {
+        stall_request_ = true;
+        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>(StallReason::SERIALIZATION);
+        if(!silent_mode_) {
+            std::cout << "Serializing CSR / system instruction. Stalling.." << std::endl;
+        }
         return;
     }
-    if(opcode==0b1110011) {
-        control.is_csr = true;
-        next_id_ex_reg_.control = control;
+    if(control.is_syscall) {            // arguments are read from the register file in WB
+        next_id_ex_reg_.rd_index = 0;
+        next_id_ex_reg_.rs1_index = 0;
+        next_id_ex_reg_.rs2_index = 0;
         return;
     }
 
-    next_id_ex_reg_.rd_index = (instruction >> 7) & 0b11111;
+    next_id_ex_reg_.rd_index = (control.is_vector && !control.reg_write) ? 0 : (instruction >> 7) & 0b11111;   // vd is not a gpr
     next_id_ex_reg_.immediate = ImmGenerator(instruction);  // inherited from vm_base
-    next_id_ex_reg_.control = control;
 
     // Handling rs1 for alu
-    if(opcode == 0b0110111 || opcode == 0b0010111) { // lui, auipc
+    if(opcode == 0b0110111 || opcode == 0b0010111 || (control.is_vector && control.alu_src_a == AluSrcA::ALU_SRC_A_ZERO)) { // lui, auipc, vector ops without a scalar
         next_id_ex_reg_.rs1_index = 0;
         next_id_ex_reg_.rs1_data = 0;
     } else {
         next_id_ex_reg_.rs1_index = (instruction >> 15) & 0b11111;
-        next_id_ex_reg_.rs1_data = registers_.ReadGpr(next_id_ex_reg_.rs1_index);
+        next_id_ex_reg_.rs1_data = control.rs1_fp ? registers_.ReadFpr(next_id_ex_reg_.rs1_index) : registers_.ReadGpr(next_id_ex_reg_.rs1_index);
     }
 
     // Handling rs2 for alu
-    if(opcode == 0b0110011 || opcode == 0b0100011 || opcode == 0b1100011) { // R-type, S-type, B-type
+    if(control.rs2_fp) {                // fp R-type, fp stores
+        next_id_ex_reg_.rs2_index = (instruction >> 20) & 0b11111;
+        next_id_ex_reg_.rs2_data = registers_.ReadFpr(next_id_ex_reg_.rs2_index);
+    } else if(opcode == 0b0110011 || opcode == 0b0111011 || opcode == 0b0100011 || opcode == 0b1100011
+            || opcode == 0b0101111) { // R-type, R-type word, S-type, B-type, AMO
+        next_id_ex_reg_.rs2_index = (instruction >> 20) & 0b11111;
+        next_id_ex_reg_.rs2_data = registers_.ReadGpr(next_id_ex_reg_.rs2_index);
+    } else if(control.is_vector && vector_unit::readsScalarRs2(instruction)) {     // vsetvl, strided stride
         next_id_ex_reg_.rs2_index = (instruction >> 20) & 0b11111;
         next_id_ex_reg_.rs2_data = registers_.ReadGpr(next_id_ex_reg_.rs2_index);
     } else {
@@ -314,17 +505,51 @@ void RV5SEXVM::Decode_Stage() {
         next_id_ex_reg_.rs2_data = 0;
     }
 
+    // Handling rs3 for the fused multiply add instructions
+    if(control.uses_rs3) {
+        next_id_ex_reg_.rs3_index = (instruction >> 27) & 0b11111;
+        next_id_ex_reg_.rs3_data = registers_.ReadFpr(next_id_ex_reg_.rs3_index);
+    } else {
+        next_id_ex_reg_.rs3_index = 0;
+        next_id_ex_reg_.rs3_data = 0;
+    }
+
     // resolution for data hazards
     bool data_stall = false;
     if(forwarding_enabled_) {
-        data_stall = hazard_unit_.detectLoadUseHazard(control, next_id_ex_reg_.rs1_index, next_id_ex_reg_.rs2_index, id_ex_reg_);
+        data_stall = hazard_unit_.detectLoadUseHazard(control, next_id_ex_reg_.rs1_index, next_id_ex_reg_.rs2_index, id_ex_reg_, next_id_ex_reg_.rs3_index);
     }
     else {
-        data_stall = hazard_unit_.detectDataHazard(control, next_id_ex_reg_.rs1_index, next_id_ex_reg_.rs2_index, id_ex_reg_, ex_mem_reg_);
+        data_stall = hazard_unit_.detectDataHazard(control, next_id_ex_reg_.rs1_index, next_id_ex_reg_.rs2_index, id_ex_reg_, ex_mem_reg_, next_id_ex_reg_.rs3_index);
+    }
+
+    // multi-cycle units: wait for a busy iterative unit, or for a long operation producing (or also writing) one of our registers
+    bool unit_stall = false;
+    StallReason unit_stall_reason = StallReason::STRUCTURAL;
+    if(!data_stall && multi_cycle_units_) {
+        // a vector instruction waits for the vector unit to finish the previous one, vset does not use it
+        FuTiming timing = (control.is_vector && !control.reg_write) ? FuTiming{FuUnit::VECTOR, 1, false} : getFuTiming(control.alu_op);
+        if(hazard_unit_.detectStructuralHazard(timing, fu_in_flight_)) {
+            fu_structural_stalls_++;
+            unit_stall = true;
+        }
+        else if(hazard_unit_.detectLongLatencyHazard(control, next_id_ex_reg_.rs1_index, next_id_ex_reg_.rs2_index, next_id_ex_reg_.rd_index, fu_in_flight_, next_id_ex_reg_.rs3_index)) {
+            long_latency_stalls_++;
+            unit_stall = true;
+            unit_stall_reason = StallReason::LONG_LATENCY;
+        }
+    }
+    if(unit_stall) {
+        stall_request_ = true;
+        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>(unit_stall_reason);
+        if(!silent_mode_) {
+            std::cout << "Functional unit busy / long latency result pending. Stalling.." << std::endl;
+        }
+        return;
     }
     if(data_stall) {
         stall_request_ = true;
-        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>();
+        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>(forwarding_enabled_ ? StallReason::LOAD_USE : StallReason::RAW);
 
         if(!silent_mode_) {                  
             if(forwarding_enabled_) 
@@ -347,6 +572,7 @@ void RV5SEXVM::Decode_Stage() {
         }
         // else if instruction is jalr, target address will be determined in the EX stage -> fetching next instruction by default 
         flush_pipeline_ = true;  
+        flush_reason_ = StallReason::BTB_MISS;          // no btb, the target is only known once the jump is decoded
     }
     else if(control.branch) {                            // other B type instructions
         prediction = branch_predictor_->getPrediction(if_id_reg_.pc);
@@ -354,6 +580,7 @@ void RV5SEXVM::Decode_Stage() {
         if(prediction) {                         // predicted to take branch
             program_counter_ = if_id_reg_.pc + next_id_ex_reg_.immediate;
             flush_pipeline_ = true;
+            flush_reason_ = StallReason::BTB_MISS;
         }
         // else -> do nothing -> next instruction at PC + 4
     }
@@ -365,36 +592,31 @@ void RV5SEXVM::Decode_Stage() {
 void RV5SEXVM::Execute_Stage() {
     if(!id_ex_reg_.is_valid)
     {
-        next_ex_mem_reg_ = CreateBubble<EX_MEM_Reg>();
+        next_ex_mem_reg_ = CreateBubble<EX_MEM_Reg>(id_ex_reg_.bubble_reason);
         return;
     }
+    pipeline_trace_.enterStage(id_ex_reg_.trace_id, PipelineTrace::Stage::EXECUTE);
     ControlSignals control = id_ex_reg_.control;
+    next_ex_mem_reg_.trace_id = id_ex_reg_.trace_id;
+    next_ex_mem_reg_.pc = id_ex_reg_.pc;
     next_ex_mem_reg_.control = id_ex_reg_.control;
     next_ex_mem_reg_.is_valid = id_ex_reg_.is_valid;
-    if(control.is_nop)
-    {
-        return;
-    }
-    else if(control.is_csr)
+    if(control.is_nop || control.is_syscall)        // the syscall runs in WB
     {
-        // ExecuteCsr();
-        return;
-    }
-    else if(control.is_syscall)
-    {
-        // HandleSyscall();
+        next_ex_mem_reg_.rd_index = 0;
         return;
     }
 
     // Forwarding logic 
     uint64_t data_alu_a = id_ex_reg_.rs1_data;
     uint64_t data_alu_b = id_ex_reg_.rs2_data;
+    uint64_t data_alu_c = id_ex_reg_.rs3_data;
 
     if(forwarding_enabled_) {
 
         // find out from where to forward for each of the alu operands 
-        ForwardSrc srcA = forwarding_unit_.getAluSrcA(id_ex_reg_.rs1_index, ex_mem_reg_, mem_wb_reg_);
-        ForwardSrc srcB = forwarding_unit_.getAluSrcB(id_ex_reg_.rs2_index, ex_mem_reg_, mem_wb_reg_);
+        ForwardSrc srcA = forwarding_unit_.getAluSrcA(id_ex_reg_.rs1_index, ex_mem_reg_, mem_wb_reg_, control.rs1_fp);
+        ForwardSrc srcB = forwarding_unit_.getAluSrcB(id_ex_reg_.rs2_index, ex_mem_reg_, mem_wb_reg_, control.rs2_fp);
 
         switch(srcA) {
             case ForwardSrc::FROM_EX_MEM:
@@ -421,8 +643,39 @@ void RV5SEXVM::Execute_Stage() {
             default:
                 break; 
         }
+
+        if(control.uses_rs3) {
+            switch (forwarding_unit_.getAluSrcC(id_ex_reg_.rs3_index, ex_mem_reg_, mem_wb_reg_)) {
+                case ForwardSrc::FROM_EX_MEM:
+                    data_alu_c = ex_mem_reg_.alu_result;
+                    break;
+                case ForwardSrc::FROM_MEM_WB:
+                    data_alu_c = getWriteBackData();
+                    break;
+                default:
+                    break;
+            }
+        }
     } 
 
+    next_ex_mem_reg_.pc_inc = id_ex_reg_.pc_inc;
+    next_ex_mem_reg_.rd_index = id_ex_reg_.rd_index;
+    next_ex_mem_reg_.fflags = 0;
+
+    if(control.is_csr) {
+        next_ex_mem_reg_.alu_result = executeCsr(data_alu_a);
+        return;
+    }
+    if(control.is_fp) {
+        next_ex_mem_reg_.alu_result = executeFloatingPoint(data_alu_a, data_alu_b, data_alu_c);
+        startFunctionalUnit(control.alu_op, next_ex_mem_reg_.alu_result);
+        return;
+    }
+    if(control.is_vector) {
+        next_ex_mem_reg_.alu_result = executeVector(data_alu_a, data_alu_b);
+        return;
+    }
+
     bool overflow = false;
     uint64_t reg1_value, reg2_value;
     switch (control.alu_src_a) {
@@ -502,17 +755,24 @@ void RV5SEXVM::Execute_Stage() {
 
     if(control.branch) {
         bool predicted_outcome = id_ex_reg_.predicted_outcome;
+        journal_.saveBranch(id_ex_reg_.pc, *branch_predictor_, branch_profile_);
         branch_predictor_->updateState(id_ex_reg_.pc, predicted_outcome, actual_outcome);
 
         if(!silent_mode_) {         
             std::cout << "Actual Outcome: " << actual_outcome << std::endl;
         }
+        if (control.branch_op != BranchOp::JAL && control.branch_op != BranchOp::JALR) {
+            // a mispredicted branch flushes the two instructions fetched behind it
+            branch_profile_.Record(id_ex_reg_.pc, actual_outcome, predicted_outcome != actual_outcome, 2);
+        }
         if (control.branch_op == BranchOp::JALR) {                  // special case for jalr, as its target address is calculated only in the ex stage and hence pipeline needs to be flushed
             program_counter_ = target_address;
             flush_pipeline_ = true;
+            flush_reason_ = StallReason::BTB_MISS;
         }
         else if(predicted_outcome != actual_outcome) {             // misprediction
             flush_pipeline_= true;
+            flush_reason_ = StallReason::BRANCH_MISPREDICT;
             branch_mispredictions_++;
             if(actual_outcome == true) {
                 program_counter_ = target_address;
@@ -522,20 +782,150 @@ void RV5SEXVM::Execute_Stage() {
             }
         }
     }
-    next_ex_mem_reg_.pc_inc = id_ex_reg_.pc_inc;
     next_ex_mem_reg_.alu_result = execution_result;
     next_ex_mem_reg_.store_data = data_alu_b; 
-    next_ex_mem_reg_.rd_index = id_ex_reg_.rd_index;
+    startFunctionalUnit(aluOperation, execution_result);
+}
+
+uint64_t RV5SEXVM::executeCsr(uint64_t rs1_value) {
+    uint32_t instruction = id_ex_reg_.instruction;
+    uint16_t csr = (instruction >> 20) & 0xFFF;
+    uint8_t funct3 = (instruction >> 12) & 0b111;
+    uint64_t uimm = id_ex_reg_.rs1_index;           // csrrwi, csrrsi, csrrci
+    uint64_t old_value = registers_.ReadCsr(csr);
+    journal_.saveCsr(registers_, csr);
+    // csrrw / csrrwi always write, the set and clear forms only with a non-zero source
+    bool write = (funct3 & 0b11) == 0b01 || ((funct3 & 0b100) ? uimm : rs1_value) != 0;
+    ReportCsrAccess(csr, write, id_ex_reg_.pc);
+
+    // same semantics as the single cycle vm, the old value goes to rd
+    switch (funct3) {
+        case 0b001:                                 // csrrw
+            registers_.WriteCsr(csr, rs1_value);
+            break;
+        case 0b010:                                 // csrrs
+            if(rs1_value != 0) registers_.WriteCsr(csr, old_value | rs1_value);
+            break;
+        case 0b011:                                 // csrrc
+            if(rs1_value != 0) registers_.WriteCsr(csr, old_value & ~rs1_value);
+            break;
+        case 0b101:                                 // csrrwi
+            registers_.WriteCsr(csr, uimm);
+            break;
+        case 0b110:                                 // csrrsi
+            if(uimm != 0) registers_.WriteCsr(csr, old_value | uimm);
+            break;
+        case 0b111:                                 // csrrci
+            if(uimm != 0) registers_.WriteCsr(csr, old_value & ~uimm);
+            break;
+        default:
+            break;
+    }
+    return old_value;
+}
+
+uint64_t RV5SEXVM::executeFloatingPoint(uint64_t rs1_value, uint64_t rs2_value, uint64_t rs3_value) {
+    uint8_t rm = (id_ex_reg_.instruction >> 12) & 0b111;
+    if(rm == 0b111) {                               // dynamic rounding mode, frm is up to date as csr writes happen in EX
+        rm = registers_.ReadCsr(0x002);
+    }
+
+    uint64_t result = 0;
+    if(id_ex_reg_.control.is_double) {
+        std::tie(result, next_ex_mem_reg_.fflags) = alu_.dfpexecute(id_ex_reg_.control.alu_op, rs1_value, rs2_value, rs3_value, rm);
+    } else {
+        std::tie(result, next_ex_mem_reg_.fflags) = alu_.fpexecute(id_ex_reg_.control.alu_op, rs1_value, rs2_value, rs3_value, rm);
+    }
+    return result;
+}
+
+uint64_t RV5SEXVM::executeVector(uint64_t rs1_value, uint64_t rs2_value) {
+    uint32_t instruction = id_ex_reg_.instruction;
+    next_ex_mem_reg_.instruction = instruction;
+
+    // vl is set in EX so that rd forwards like an alu result; the older vector instructions have already run in MEM
+    if(vector_unit::isConfig(instruction)) {
+        vector_unit::Config config = vector_unit::configure(instruction, rs1_value, rs2_value, registers_);
+        journal_.saveVectorConfig(registers_);
+        registers_.SetVectorConfig(config.vl, config.vtype);
+        return config.vl;
+    }
+
+    // the vector unit runs the instruction in MEM, in order with the scalar loads and stores; its results are written
+    // there at once, the unit then stays busy for the following vector instructions
+    if(multi_cycle_units_) {
+        unsigned int cycles = vector_unit::occupancy(instruction, registers_, vector_lanes_);
+        if(cycles > 1) {
+            InFlightFuOp fu_op;
+            fu_op.unit = FuUnit::VECTOR;
+            fu_op.remaining_cycles = cycles - 1;
+            fu_in_flight_.push_back(fu_op);
+        }
+    }
+    next_ex_mem_reg_.store_data = rs2_value;
+    return rs1_value;
+}
+
+uint8_t RV5SEXVM::runVectorUnit(uint32_t instruction, uint64_t rs1_value, uint64_t rs2_value) {
+    if(!vector_unit::isLegal(instruction, registers_)) {
+        std::cerr << "Illegal vector instruction at 0x" << std::hex << ex_mem_reg_.pc << std::dec
+                  << ": vtype not set or register group not aligned" << std::endl;
+        return 0;
+    }
+    vector_unit::Footprint footprint = vector_unit::footprint(instruction, registers_, rs1_value, rs2_value);
+    journal_.saveVectorWords(registers_, footprint.first_word, footprint.words);
+    for(uint64_t i = 0; i < footprint.elements; ++i) {
+        journal_.saveMemory(memory_controller_, footprint.address + i * footprint.stride, footprint.element_bytes);
+    }
+    return vector_unit::execute(instruction, registers_, memory_controller_, alu_, rs1_value, rs2_value);
+}
+
+void RV5SEXVM::startFunctionalUnit(alu::AluOp op, uint64_t result) {
+    // a long operation moves into its unit, the instruction continues down the pipeline without writing rd
+    FuTiming timing = getFuTiming(op);
+    if(!multi_cycle_units_ || timing.latency <= 1) {
+        return;
+    }
+    const ControlSignals &control = id_ex_reg_.control;
+    InFlightFuOp fu_op;
+    fu_op.unit = timing.unit;
+    fu_op.has_dest = control.reg_write && (control.rd_fp || id_ex_reg_.rd_index != 0);
+    fu_op.rd_fp = control.rd_fp;
+    fu_op.rd_index = id_ex_reg_.rd_index;
+    fu_op.result = result;
+    fu_op.remaining_cycles = timing.latency - 1;
+    fu_in_flight_.push_back(fu_op);
+    next_ex_mem_reg_.control.reg_write = false;
+}
+
+void RV5SEXVM::completeFunctionalUnits() {
+    for (auto it = fu_in_flight_.begin(); it != fu_in_flight_.end(); ) {
+        if(--it->remaining_cycles == 0) {
+            if(it->has_dest && it->rd_fp) {
+                journal_.saveFpr(registers_, it->rd_index);
+                registers_.WriteFpr(it->rd_index, it->result);
+            } else if(it->has_dest) {
+                journal_.saveGpr(registers_, it->rd_index);
+                registers_.WriteGpr(it->rd_index, it->result);
+            }
+            it = fu_in_flight_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 void RV5SEXVM::Memory_Stage() {
     
     if(!ex_mem_reg_.is_valid)
     {
-        next_mem_wb_reg_ = CreateBubble<MEM_WB_Reg>();
+        next_mem_wb_reg_ = CreateBubble<MEM_WB_Reg>(ex_mem_reg_.bubble_reason);
         return;
     }
+    pipeline_trace_.enterStage(ex_mem_reg_.trace_id, PipelineTrace::Stage::MEMORY);
     ControlSignals control = ex_mem_reg_.control;
-    if(control.is_nop || control.is_syscall || control.is_csr)
+    next_mem_wb_reg_.trace_id = ex_mem_reg_.trace_id;
+    next_mem_wb_reg_.pc = ex_mem_reg_.pc;
+    if(control.is_nop || control.is_syscall)
     {
         next_mem_wb_reg_.is_valid = ex_mem_reg_.is_valid;
         next_mem_wb_reg_.control = ex_mem_reg_.control;
@@ -545,9 +935,20 @@ void RV5SEXVM::Memory_Stage() {
     uint64_t alu_result = ex_mem_reg_.alu_result;   // the address for load, store
     uint64_t store_data = ex_mem_reg_.store_data;
     int64_t memory_result = 0;
+    uint8_t fflags = ex_mem_reg_.fflags;
+
+    if(control.is_vector && !control.reg_write) {   // rs1 and the stride were carried in alu_result and store_data
+        fflags |= runVectorUnit(ex_mem_reg_.instruction, alu_result, store_data);
+    }
 
     // Load Instructions
-    if(control.mem_read) {
+    if(control.is_atomic) {     // lr / sc / amo*, rs2 was carried in store_data
+        unsigned int bytes = atomicSize(control.mem_read_op);
+        journal_.saveMemory(memory_controller_, alu_result, bytes);
+        memory_result = static_cast<int64_t>(atomic_unit::execute(control.atomic_op, bytes, alu_result, store_data,
+                                                                  memory_controller_, reservation_));
+    }
+    else if(control.mem_read) {
     switch (control.mem_read_op) {
       case MemReadOp::MEM_READ_BYTE: {// LB
         memory_result = static_cast<int8_t>(memory_controller_.ReadByte(alu_result));
@@ -573,8 +974,9 @@ void RV5SEXVM::Memory_Stage() {
         memory_result = static_cast<uint16_t>(memory_controller_.ReadHalfWord(alu_result));
         break;
       }
-      case MemReadOp::MEM_READ_WORD_UNSIGNED: {// LWU
-        memory_result = static_cast<uint32_t>(memory_controller_.ReadWord(alu_result));
+      case MemReadOp::MEM_READ_WORD_UNSIGNED: {// LWU, FLW NaN-boxes the word instead
+        uint64_t word = memory_controller_.ReadWord(alu_result);
+        memory_result = static_cast<int64_t>(control.rd_fp ? 0xFFFFFFFF00000000 | word : word);
         break;
       }
       case MemReadOp::MEM_READ_NONE:
@@ -586,6 +988,7 @@ void RV5SEXVM::Memory_Stage() {
     }
     // Store Instructions
     else if(control.mem_write) {
+    journal_.saveMemory(memory_controller_, alu_result, storeSize(control.mem_write_op));
     switch (control.mem_write_op) {
       case MemWriteOp::MEM_WRITE_BYTE: {// SB
         memory_controller_.WriteByte(alu_result, store_data & 0xFF);
@@ -621,25 +1024,37 @@ void RV5SEXVM::Memory_Stage() {
         next_mem_wb_reg_.alu_result = alu_result;       // in case of other R-type instructions
     }
     next_mem_wb_reg_.rd_index = ex_mem_reg_.rd_index;
+    next_mem_wb_reg_.fflags = fflags;
 }
 void RV5SEXVM::WriteBack_Stage() {
     if(!mem_wb_reg_.is_valid)
     {
+        stall_accounting_.Record(mem_wb_reg_.bubble_reason);      // no instruction retires this cycle
         return;
     }
     instructions_retired_++;
+    pipeline_trace_.enterStage(mem_wb_reg_.trace_id, PipelineTrace::Stage::WRITEBACK);
+    pipeline_trace_.retire(mem_wb_reg_.trace_id);
     ControlSignals control = mem_wb_reg_.control;
     if(control.is_syscall)
     {
+        journal_.saveGpr(registers_, 10);
+        if(registers_.ReadGpr(17) == SYSCALL_READ && registers_.ReadGpr(10) == 0) {     // stdin read, the input and its terminator land in the buffer
+            journal_.saveMemory(memory_controller_, registers_.ReadGpr(11), registers_.ReadGpr(12) + 1);
+        }
+        HandleSyscall();            // all older instructions have written back, younger ones wait in ID
         return;
     }
-    if(control.is_csr) 
+    if(control.is_fp || control.is_vector)      // fflags accrue in program order
     {
-        // do something maybe
-        return;
+        uint64_t fcsr = registers_.ReadCsr(0x003);
+        if(mem_wb_reg_.fflags & ~fcsr) {       // sticky, written only when a new flag is raised
+            journal_.saveCsr(registers_, 0x003);
+            registers_.WriteCsr(0x003, fcsr | mem_wb_reg_.fflags);
+        }
     }
     uint8_t rd_index = mem_wb_reg_.rd_index;
-    if(control.reg_write && rd_index != 0) {
+    if(control.reg_write && (rd_index != 0 || control.rd_fp)) {
         
         uint64_t write_data = 0;
 
@@ -661,7 +1076,13 @@ void RV5SEXVM::WriteBack_Stage() {
                 std::cerr << "Default Write Back Stage Switch" << std::endl;    
             return; 
         }
-        registers_.WriteGpr(rd_index, write_data);
+        if(control.rd_fp) {
+            journal_.saveFpr(registers_, rd_index);
+            registers_.WriteFpr(rd_index, write_data);
+        } else {
+            journal_.saveGpr(registers_, rd_index);
+            registers_.WriteGpr(rd_index, write_data);
+        }
     }
 }
 /**
@@ -688,9 +1109,16 @@ void RV5SEXVM::DumpState(const std::filesystem::path &filename) {
     file << "    \"cpi\": " << cpi_ << ",\n";
     file << "    \"ipc\": " << ipc_ << ",\n";
     file << "    \"stall_cycles\": " << stall_cycles_ << ",\n";
+    file << "    \"multi_cycle_units\": \"" << multi_cycle_units_ << "\",\n";
+    file << "    \"functional_units_busy\": " << fu_in_flight_.size() << ",\n";
+    file << "    \"functional_unit_stalls\": " << fu_structural_stalls_ << ",\n";
+    file << "    \"long_latency_stalls\": " << long_latency_stalls_ << ",\n";
     file << "    \"branch_mispredictions\": " << branch_mispredictions_ << "\n";
     file << "  },\n";
 
+    stall_accounting_.DumpJson(file, cycle_s_, instructions_retired_, "  ");
+    file << ",\n";
+
     // Dump the pipeline registers
     DumpPipelineRegisters(file, if_id_reg_, id_ex_reg_, ex_mem_reg_, mem_wb_reg_);
 
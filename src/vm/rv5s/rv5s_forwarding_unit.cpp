@@ -6,28 +6,46 @@
 #include "vm/rv5s/rv5s_forwarding_unit.h"
 #include "vm/rv5s/pipeline_registers.h"
 
-ForwardSrc RV5SForwardingUnit::getAluSrcA(uint8_t id_rs1_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg) {
-    if (id_rs1_index == 0) {
+ForwardSrc RV5SForwardingUnit::getAluSrcA(uint8_t id_rs1_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg, bool rs1_fp) {
+    return getForwardSrc(id_rs1_index, rs1_fp, ex_mem_reg, mem_wb_reg);
+}
+
+ForwardSrc RV5SForwardingUnit::getAluSrcB(uint8_t id_rs2_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg, bool rs2_fp) {
+    return getForwardSrc(id_rs2_index, rs2_fp, ex_mem_reg, mem_wb_reg);
+}
+
+ForwardSrc RV5SForwardingUnit::getAluSrcC(uint8_t id_rs3_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg) {
+    return getForwardSrc(id_rs3_index, true, ex_mem_reg, mem_wb_reg);
+}
+
+ForwardSrc RV5SForwardingUnit::getForwardSrc(uint8_t rs_index, bool rs_fp, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg) {
+    if (rs_index == 0 && !rs_fp) {          // x0 is hardwired, f0 is an ordinary register
         return ForwardSrc::FROM_REG;
     }
-    if (ex_mem_reg.control.reg_write && ex_mem_reg.rd_index == id_rs1_index) {
+    if (ex_mem_reg.control.reg_write && ex_mem_reg.control.rd_fp == rs_fp && ex_mem_reg.rd_index == rs_index) {
         return ForwardSrc::FROM_EX_MEM;
     }   
-    if (mem_wb_reg.control.reg_write && mem_wb_reg.rd_index == id_rs1_index) {
+    if (mem_wb_reg.control.reg_write && mem_wb_reg.control.rd_fp == rs_fp && mem_wb_reg.rd_index == rs_index) {
         return ForwardSrc::FROM_MEM_WB;
     }
     return ForwardSrc::FROM_REG;
 }
 
-ForwardSrc RV5SForwardingUnit::getAluSrcB(uint8_t id_rs2_index, const EX_MEM_Reg& ex_mem_reg, const MEM_WB_Reg& mem_wb_reg) {
-    if (id_rs2_index == 0) {
-        return ForwardSrc::FROM_REG;
+BypassSource RV5SForwardingUnit::getBypassSource(uint8_t rs_index, const std::vector<EX_MEM_Reg>& ex_mem_regs, const std::vector<MEM_WB_Reg>& mem_wb_regs) {
+    if (rs_index == 0) {
+        return {ForwardSrc::FROM_REG, 0};
     }
-    if (ex_mem_reg.control.reg_write && ex_mem_reg.rd_index == id_rs2_index) {
-        return ForwardSrc::FROM_EX_MEM;
-    }   
-    if (mem_wb_reg.control.reg_write && mem_wb_reg.rd_index == id_rs2_index) {
-        return ForwardSrc::FROM_MEM_WB;
+    for (std::size_t slot = ex_mem_regs.size(); slot-- > 0;) {
+        const EX_MEM_Reg& reg = ex_mem_regs[slot];
+        if (reg.is_valid && reg.control.reg_write && reg.rd_index == rs_index) {
+            return {ForwardSrc::FROM_EX_MEM, slot};
+        }
     }
-    return ForwardSrc::FROM_REG;
-}
\ No newline at end of file
+    for (std::size_t slot = mem_wb_regs.size(); slot-- > 0;) {
+        const MEM_WB_Reg& reg = mem_wb_regs[slot];
+        if (reg.is_valid && reg.control.reg_write && reg.rd_index == rs_index) {
+            return {ForwardSrc::FROM_MEM_WB, slot};
+        }
+    }
+    return {ForwardSrc::FROM_REG, 0};
+}
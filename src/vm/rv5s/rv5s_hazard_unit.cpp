@@ -11,11 +11,22 @@ using instruction_type::BranchOp;
 using instruction_type::AluSrcA;
 using instruction_type::WriteBackSrc;
 
+// true if an older instruction writing rd (of its register file) produces the operand rs of the given register file
+static bool producesOperand(const ControlSignals& producer, uint8_t rd_index, uint8_t rs_index, bool rs_fp) {
+    if (!producer.reg_write || producer.rd_fp != rs_fp) {
+        return false;
+    }
+    if (!rs_fp && rd_index == 0) {         // x0 is hardwired, f0 is an ordinary register
+        return false;
+    }
+    return rd_index == rs_index;
+}
+
 bool RV5SHazardUnit::detectHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg, EX_MEM_Reg ex_mem_reg) {
     return detectControlHazard(signals) || detectDataHazard(signals, rs1_index, rs2_index, id_ex_reg, ex_mem_reg);
 }
     
-bool RV5SHazardUnit::detectDataHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg, EX_MEM_Reg ex_mem_reg) {
+bool RV5SHazardUnit::detectDataHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg, EX_MEM_Reg ex_mem_reg, uint8_t rs3_index) {
     
     bool rs1_reqd = false, rs2_reqd = false;
     // checking if rs1 is required by the instruction or not
@@ -33,34 +44,32 @@ bool RV5SHazardUnit::detectDataHazard(ControlSignals signals, uint8_t rs1_index,
     else if(signals.branch && signals.branch_op!=BranchOp::JAL && signals.branch_op!=BranchOp::JALR) {  // normal branch instructions
         rs2_reqd = true;
     }  
+    else if(signals.is_vector) {                            // the stride of the strided accesses, x0 when not read
+        rs2_reqd = true;
+    }
 
     // check for hazard with instruction at EX stage
-    if(id_ex_reg.control.reg_write && id_ex_reg.rd_index != 0) {
-        if((rs1_reqd && id_ex_reg.rd_index == rs1_index)  || (rs2_reqd && id_ex_reg.rd_index == rs2_index)) 
-            return true;
-    }
+    if((rs1_reqd && producesOperand(id_ex_reg.control, id_ex_reg.rd_index, rs1_index, signals.rs1_fp))
+        || (rs2_reqd && producesOperand(id_ex_reg.control, id_ex_reg.rd_index, rs2_index, signals.rs2_fp))
+        || (signals.uses_rs3 && producesOperand(id_ex_reg.control, id_ex_reg.rd_index, rs3_index, true)))
+        return true;
 
     // check for hazard with instruction at MEM stage
-    if(ex_mem_reg.control.reg_write && ex_mem_reg.rd_index != 0) {
-        if((rs1_reqd && ex_mem_reg.rd_index == rs1_index)  || (rs2_reqd && ex_mem_reg.rd_index == rs2_index)) 
-            return true;
-    }
+    if((rs1_reqd && producesOperand(ex_mem_reg.control, ex_mem_reg.rd_index, rs1_index, signals.rs1_fp))
+        || (rs2_reqd && producesOperand(ex_mem_reg.control, ex_mem_reg.rd_index, rs2_index, signals.rs2_fp))
+        || (signals.uses_rs3 && producesOperand(ex_mem_reg.control, ex_mem_reg.rd_index, rs3_index, true)))
+        return true;
 
     return false;
 }
 
-bool RV5SHazardUnit::detectLoadUseHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg) {
+bool RV5SHazardUnit::detectLoadUseHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, ID_EX_Reg id_ex_reg, uint8_t rs3_index) {
 
     // checking if instruction in EX stage is a load
     if (!id_ex_reg.control.mem_read) {
         return false;
     }
 
-    // If load destination is x0, it is not a hazard
-    if (id_ex_reg.rd_index == 0) {
-        return false;
-    }
-
     bool rs1_reqd = false, rs2_reqd = false;
     // checking if rs1 is required by the instruction or not
     if(signals.alu_src_a == AluSrcA::ALU_SRC_A_RS1) {
@@ -80,18 +89,46 @@ bool RV5SHazardUnit::detectLoadUseHazard(ControlSignals signals, uint8_t rs1_ind
     else if(signals.branch && signals.branch_op!=BranchOp::JAL && signals.branch_op!=BranchOp::JALR) {  // normal branch instructions -> reqd
         rs2_reqd = true;
     } 
+    else if(signals.is_vector) {
+        rs2_reqd = true;
+    }
 
-    if (rs1_reqd && id_ex_reg.rd_index == rs1_index) {              // if rs1's value is yet to be loaded into
+    // a load into x0 is never a hazard
+    if (rs1_reqd && producesOperand(id_ex_reg.control, id_ex_reg.rd_index, rs1_index, signals.rs1_fp)) {     // if rs1's value is yet to be loaded into
         return true;
     }
 
-    if (rs2_reqd && id_ex_reg.rd_index == rs2_index) {              // if rs2's value is yet to be loaded into
+    if (rs2_reqd && producesOperand(id_ex_reg.control, id_ex_reg.rd_index, rs2_index, signals.rs2_fp)) {     // if rs2's value is yet to be loaded into
+        return true;
+    }
+
+    if (signals.uses_rs3 && producesOperand(id_ex_reg.control, id_ex_reg.rd_index, rs3_index, true)) {
         return true;
     }
 
     return false;
 }
 
+bool RV5SHazardUnit::detectSerializationHazard(ControlSignals signals, const ID_EX_Reg& id_ex_reg, const EX_MEM_Reg& ex_mem_reg) {
+    // nothing issues behind an ecall until it has run in WB, it may write a0 and memory
+    if ((id_ex_reg.is_valid && id_ex_reg.control.is_syscall) || (ex_mem_reg.is_valid && ex_mem_reg.control.is_syscall)) {
+        return true;
+    }
+
+    // an ecall reads its arguments from the register file in WB -> wait for all older instructions to retire
+    if (signals.is_syscall) {
+        return (id_ex_reg.is_valid && !id_ex_reg.control.is_nop) || (ex_mem_reg.is_valid && !ex_mem_reg.control.is_nop);
+    }
+
+    // a csr instruction reads fcsr in EX: an fp or vector instruction in EX now would accrue its flags only after that
+    // (one in MEM now writes back before the csr instruction executes)
+    if (signals.is_csr) {
+        return id_ex_reg.is_valid && (id_ex_reg.control.is_fp || id_ex_reg.control.is_vector);
+    }
+
+    return false;
+}
+
 bool RV5SHazardUnit::detectControlHazard(ControlSignals signals) {
     if(signals.branch)
         return true;
@@ -100,4 +137,63 @@ bool RV5SHazardUnit::detectControlHazard(ControlSignals signals) {
     //     return true;
 
     return false;
-}
\ No newline at end of file
+}
+
+bool RV5SHazardUnit::detectDataHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, const std::vector<ID_EX_Reg>& id_ex_regs, const std::vector<EX_MEM_Reg>& ex_mem_regs) {
+    ID_EX_Reg no_id_ex{};
+    EX_MEM_Reg no_ex_mem{};
+
+    for (const ID_EX_Reg& id_ex_reg : id_ex_regs) {
+        if (id_ex_reg.is_valid && detectDataHazard(signals, rs1_index, rs2_index, id_ex_reg, no_ex_mem))
+            return true;
+    }
+    for (const EX_MEM_Reg& ex_mem_reg : ex_mem_regs) {
+        if (ex_mem_reg.is_valid && detectDataHazard(signals, rs1_index, rs2_index, no_id_ex, ex_mem_reg))
+            return true;
+    }
+    return false;
+}
+
+bool RV5SHazardUnit::detectLoadUseHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, const std::vector<ID_EX_Reg>& id_ex_regs) {
+    for (const ID_EX_Reg& id_ex_reg : id_ex_regs) {
+        if (id_ex_reg.is_valid && detectLoadUseHazard(signals, rs1_index, rs2_index, id_ex_reg))
+            return true;
+    }
+    return false;
+}
+
+bool RV5SHazardUnit::detectLongLatencyHazard(ControlSignals signals, uint8_t rs1_index, uint8_t rs2_index, uint8_t rd_index, const std::vector<InFlightFuOp>& in_flight, uint8_t rs3_index) {
+    bool rs1_reqd = signals.alu_src_a == AluSrcA::ALU_SRC_A_RS1 || signals.branch_op == BranchOp::JALR;
+    bool rs2_reqd = (!signals.alu_src_b && signals.reg_write && signals.wb_src == WriteBackSrc::WB_FROM_ALU)
+                    || signals.mem_write
+                    || (signals.branch && signals.branch_op != BranchOp::JAL && signals.branch_op != BranchOp::JALR)
+                    || signals.is_vector;
+    bool rd_written = signals.reg_write && (signals.rd_fp || rd_index != 0);
+
+    for (const InFlightFuOp& op : in_flight) {
+        if (!op.has_dest) {
+            continue;
+        }
+        auto produces = [&op](uint8_t index, bool fp) { return op.rd_fp == fp && op.rd_index == index; };
+        if ((rs1_reqd && produces(rs1_index, signals.rs1_fp)) || (rs2_reqd && produces(rs2_index, signals.rs2_fp))
+            || (signals.uses_rs3 && produces(rs3_index, true))) {
+            return true;
+        }
+        if (rd_written && produces(rd_index, signals.rd_fp)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RV5SHazardUnit::detectStructuralHazard(const FuTiming& timing, const std::vector<InFlightFuOp>& in_flight) {
+    if (timing.pipelined) {             // accepts one operation per cycle, the EX stage never issues more
+        return false;
+    }
+    for (const InFlightFuOp& op : in_flight) {
+        if (op.unit == timing.unit) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -9,6 +9,8 @@
 #include "vm/rv5s/rv5s_control_unit.h"
 #include "vm/rv5s/pipeline_registers.h"
 #include "vm/rv5s/rv5s_hazard_unit.h"
+#include "vm/lockstep_checker.h"
+#include "vm/state_file.h"
 
 #include "vm/rv5s/rv5s_forwarding_unit.h" 
 #include "vm/rv5s/branch_prediction/static_predictors.h"
@@ -33,7 +35,6 @@
 #include <atomic>
 
 using instruction_set::Instruction;
-using instruction_set::get_instr_encoding;
 using instruction_type::MemReadOp;
 using instruction_type::MemWriteOp;
 using instruction_type::WriteBackSrc;
@@ -78,11 +79,26 @@ void RV5SIDVM::Reset() {
     ipc_ = 0.0;
     stall_cycles_ = 0;
     branch_mispredictions_ = 0;
+    reservation_ = {};
+    control_unit_.enableAtomicDecode(true);
+    branch_profile_.Clear();
+    stall_accounting_.Clear();
 
     stall_request_= false;
     flush_pipeline_ = false;
+    flush_reason_ = StallReason::BRANCH_MISPREDICT;
+
+    ftq_ = FetchTargetQueue(vm_config::config.getFtqDepth());
+    // the buffer must be able to hold a complete fetch block, else fetch could never hand one over
+    fetch_buffer_ = RingQueue<IF_ID_Reg>(std::max<std::size_t>(vm_config::config.getFetchBufferSize(), kFetchBlockBytes / 4));
+    fetch_latency_ = vm_config::config.getFetchLatency();
+    fetch_busy_cycles_ = 0;
+    frontend_starvation_cycles_ = 0;
+
     forwarding_enabled_ = vm_config::config.getDataHazardMode() == DataHazardMode::FORWARDING;
     setBranchPredictorType(vm_config::config.getBranchPredictorType());
+    journal_.setDepth(vm_config::config.getUndoDepth());
+    redo_cycles_ = 0;
 
     registers_.Reset();
     memory_controller_.Reset();
@@ -98,6 +114,13 @@ void RV5SIDVM::Reset() {
     next_ex_mem_reg_ = CreateBubble<EX_MEM_Reg>();
     next_mem_wb_reg_ = CreateBubble<MEM_WB_Reg>();
 
+    const std::string &trace_path = vm_config::config.getPipelineTracePath();
+    if(trace_path.empty()) {
+        pipeline_trace_.close();
+    } else if(!pipeline_trace_.open(trace_path)) {
+        std::cerr << "Could not open the pipeline trace file: " << trace_path << std::endl;
+    }
+
     if(!silent_mode_) {
         DumpRegisters(globals::registers_dump_file_path, registers_);
         DumpState(globals::vm_state_dump_file_path);
@@ -113,15 +136,33 @@ void RV5SIDVM::Step() {
         return;
     }
 
+    redo_cycles_ = 0;                   // a new cycle replaces the undone ones
+    if(journal_.enabled()) {
+        saveCycle();
+    }
+
     stall_request_ = false;
     flush_pipeline_ = false; 
+    pipeline_trace_.beginCycle(cycle_s_);
 
     WriteBack_Stage();
+    if(lockstep_checker_ && mem_wb_reg_.is_valid) {
+        RetiredInstruction retired;
+        retired.pc = mem_wb_reg_.pc;
+        retired.writes_rd = mem_wb_reg_.control.reg_write;
+        retired.rd_fp = mem_wb_reg_.control.rd_fp;
+        retired.rd_index = mem_wb_reg_.rd_index;
+        retired.is_syscall = mem_wb_reg_.control.is_syscall;
+        CheckRetired(retired);
+    }
     Memory_Stage();
     Execute_Stage();
     Decode_Stage();
 
-    if(!stall_request_) {    // no need to stall
+    if(isFrontEndDecoupled()) {     // predictor and fetch keep running ahead during a stall
+        FrontEnd_Stage();
+    }
+    else if(!stall_request_) {    // no need to stall
         Fetch_Stage();
     }
 
@@ -157,17 +198,21 @@ void RV5SIDVM::Step() {
         DumpState(globals::vm_state_dump_file_path);
     }
 
-    bool all_instructions_fetched = (program_counter_ >= program_size_);
+    bool all_instructions_fetched = (program_counter_ >= program_size_) && ftq_.empty() && fetch_buffer_.empty();
     bool is_pipeline_empty = !if_id_reg_.is_valid && !id_ex_reg_.is_valid && !ex_mem_reg_.is_valid && !mem_wb_reg_.is_valid;
 
     if(all_instructions_fetched && is_pipeline_empty) {
+        pipeline_trace_.close();
         RequestStop();
         std::cout << "VM_PROGRAM_END" << std::endl;
         output_status_ = "VM_PROGRAM_END";
+        CheckLockstepEnd();
         
         if(!silent_mode_) {
             DumpState(globals::vm_state_dump_file_path);        // final state with updated output status
         }
+    } else if(LockstepDiverged()) {
+        std::cout << "VM_LOCKSTEP_DIVERGED" << std::endl;
     } else {
         std::cout << "VM_STEP_COMPLETED" << std::endl;
         output_status_ = "VM_STEP_COMPLETED";
@@ -212,17 +257,180 @@ void RV5SIDVM::DebugRun() {
 }
 
 void RV5SIDVM::Undo() {
-    std::cerr << "Undo/Redo Feature is not available in multi-stage pipelining mode." << std::endl;    
+    if(journal_.empty()) {
+        std::cout << "VM_NO_MORE_UNDO" << std::endl;
+        output_status_ = "VM_NO_MORE_UNDO";
+        return;
+    }
+
+    restoreCycle(journal_.undoCycle(registers_, memory_controller_, *branch_predictor_, branch_profile_, &btb_));
+    redo_cycles_++;
+
+    // neither the golden vm nor the trace file can step backwards
+    if(lockstep_checker_) {
+        std::cerr << "Lockstep check stopped by undo." << std::endl;
+        lockstep_checker_.reset();
+    }
+    if(pipeline_trace_.isOpen()) {
+        std::cerr << "Pipeline trace closed by undo." << std::endl;
+        pipeline_trace_.close();
+    }
+
+    std::cout << "Program Counter: " << program_counter_ << std::endl;
+    output_status_ = "VM_UNDO_COMPLETED";
+    std::cout << "VM_UNDO_COMPLETED" << std::endl;
+
+    if(!silent_mode_) {
+        DumpRegisters(globals::registers_dump_file_path, registers_);
+        DumpState(globals::vm_state_dump_file_path);
+    }
 }
 
 void RV5SIDVM::Redo() {
-    std::cerr << "Undo/Redo Feature is not available in multi-stage pipelining mode." << std::endl;
+    if(redo_cycles_ == 0) {
+        std::cout << "VM_NO_MORE_REDO" << std::endl;
+        return;
+    }
+
+    // the pipeline is deterministic, running the undone cycle again redoes it
+    unsigned int remaining = redo_cycles_ - 1;
+    Step();
+    redo_cycles_ = remaining;
+}
+
+void RV5SIDVM::saveCycle() {
+    CycleSnapshot &snapshot = journal_.beginCycle();
+    snapshot.saveCounters(*this);
+    snapshot.if_id = if_id_reg_;
+    snapshot.id_ex = id_ex_reg_;
+    snapshot.ex_mem = ex_mem_reg_;
+    snapshot.mem_wb = mem_wb_reg_;
+    snapshot.next_if_id = next_if_id_reg_;
+    snapshot.next_id_ex = next_id_ex_reg_;
+    snapshot.next_ex_mem = next_ex_mem_reg_;
+    snapshot.next_mem_wb = next_mem_wb_reg_;
+    snapshot.ftq = ftq_.mark();
+    snapshot.fetch_buffer = fetch_buffer_.mark();
+    snapshot.ftq_overwritten.clear();
+    snapshot.fetch_buffer_overwritten.clear();
+    snapshot.fetch_busy_cycles = fetch_busy_cycles_;
+    snapshot.frontend_starvation_cycles = frontend_starvation_cycles_;
+    snapshot.flush_reason = flush_reason_;
+}
+
+void RV5SIDVM::restoreCycle(const CycleSnapshot &snapshot) {
+    snapshot.restoreCounters(*this);
+    if_id_reg_ = snapshot.if_id;
+    id_ex_reg_ = snapshot.id_ex;
+    ex_mem_reg_ = snapshot.ex_mem;
+    mem_wb_reg_ = snapshot.mem_wb;
+    next_if_id_reg_ = snapshot.next_if_id;
+    next_id_ex_reg_ = snapshot.next_id_ex;
+    next_ex_mem_reg_ = snapshot.next_ex_mem;
+    next_mem_wb_reg_ = snapshot.next_mem_wb;
+    for (auto it = snapshot.ftq_overwritten.rbegin(); it != snapshot.ftq_overwritten.rend(); ++it) {
+        ftq_.restoreSlot(it->first, it->second);
+    }
+    for (auto it = snapshot.fetch_buffer_overwritten.rbegin(); it != snapshot.fetch_buffer_overwritten.rend(); ++it) {
+        fetch_buffer_.restoreSlot(it->first, it->second);
+    }
+    ftq_.rewind(snapshot.ftq);
+    fetch_buffer_.rewind(snapshot.fetch_buffer);
+    fetch_busy_cycles_ = snapshot.fetch_busy_cycles;
+    frontend_starvation_cycles_ = snapshot.frontend_starvation_cycles;
+    flush_reason_ = snapshot.flush_reason;
+}
+
+uint64_t RV5SIDVM::ResumePc() const {
+    uint64_t fallback = program_counter_;
+    if (!fetch_buffer_.empty()) {
+        fallback = fetch_buffer_.front().pc;
+    } else if (!ftq_.empty()) {
+        fallback = ftq_.front().start_pc;
+    }
+    return oldestPipelinePc(if_id_reg_, id_ex_reg_, ex_mem_reg_, mem_wb_reg_, fallback);
+}
+
+void RV5SIDVM::SaveMicroarchState(StateWriter &writer) {
+    branch_predictor_->saveState(writer);
+    btb_.saveState(writer);
+
+    writer.beginSection(state_file::kTagIdPipeline);
+    writer.write(program_counter_);
+    writer.write(if_id_reg_);
+    writer.write(id_ex_reg_);
+    writer.write(ex_mem_reg_);
+    writer.write(mem_wb_reg_);
+    writer.write(next_if_id_reg_);
+    writer.write(next_id_ex_reg_);
+    writer.write(next_ex_mem_reg_);
+    writer.write(next_mem_wb_reg_);
+    writer.write(static_cast<uint64_t>(ftq_.size()));
+    for (std::size_t i = 0; i < ftq_.size(); ++i) {
+        writer.write(ftq_.at(i));
+    }
+    writer.write(static_cast<uint64_t>(fetch_buffer_.size()));
+    for (std::size_t i = 0; i < fetch_buffer_.size(); ++i) {
+        writer.write(fetch_buffer_.at(i));
+    }
+    writer.write(fetch_busy_cycles_);
+    writer.write(frontend_starvation_cycles_);
+    writer.write(flush_reason_);
+    writer.endSection();
+}
+
+bool RV5SIDVM::LoadMicroarchSection(StateReader &reader, uint32_t tag) {
+    if (tag == state_file::kTagPredictor) {
+        branch_predictor_->loadState(reader);
+        return true;
+    }
+    if (tag == state_file::kTagBtb) {
+        btb_.loadState(reader);
+        return true;
+    }
+    if (tag != state_file::kTagIdPipeline) {
+        return false;
+    }
+    reader.read(program_counter_);
+    reader.read(if_id_reg_);
+    reader.read(id_ex_reg_);
+    reader.read(ex_mem_reg_);
+    reader.read(mem_wb_reg_);
+    reader.read(next_if_id_reg_);
+    reader.read(next_id_ex_reg_);
+    reader.read(next_ex_mem_reg_);
+    reader.read(next_mem_wb_reg_);
+    uint64_t count = 0;
+    reader.read(count);
+    ftq_.clear();
+    for (uint64_t i = 0; i < count && reader.good(); ++i) {
+        FetchTarget target;
+        reader.read(target);
+        ftq_.push(target);
+    }
+    reader.read(count);
+    fetch_buffer_.clear();
+    for (uint64_t i = 0; i < count && reader.good(); ++i) {
+        IF_ID_Reg reg;
+        reader.read(reg);
+        reg.trace_id = 0;
+        fetch_buffer_.push(reg);
+    }
+    reader.read(fetch_busy_cycles_);
+    reader.read(frontend_starvation_cycles_);
+    reader.read(flush_reason_);
+
+    // the trace restarted with the reset, the ids of the instructions in flight are not in it
+    if_id_reg_.trace_id = id_ex_reg_.trace_id = ex_mem_reg_.trace_id = mem_wb_reg_.trace_id = 0;
+    next_if_id_reg_.trace_id = next_id_ex_reg_.trace_id = next_ex_mem_reg_.trace_id = next_mem_wb_reg_.trace_id = 0;
+    return true;
 }
 
 void RV5SIDVM::Fetch_Stage() {
     if (flush_pipeline_) { 
         stall_cycles_++;
-        next_if_id_reg_ = CreateBubble<IF_ID_Reg>();
+        fetch_busy_cycles_ = 0;
+        next_if_id_reg_ = CreateBubble<IF_ID_Reg>(flush_reason_);
         return;
     }
 
@@ -231,8 +439,17 @@ void RV5SIDVM::Fetch_Stage() {
         return;
     }
 
+    // instruction memory access still in progress
+    if (++fetch_busy_cycles_ < fetch_latency_) {
+        frontend_starvation_cycles_++;
+        next_if_id_reg_ = CreateBubble<IF_ID_Reg>();
+        return;
+    }
+    fetch_busy_cycles_ = 0;
+
     try {
-        uint32_t instruction = memory_controller_.ReadWord(program_counter_);
+        uint8_t length = 4;
+        uint32_t instruction = FetchInstruction(program_counter_, length);
         
         // Checking for current PC address in the branch target buffer to determine whether it is a branch or not
         auto [btb_hit, btb_target] = btb_.lookup(program_counter_);
@@ -248,16 +465,18 @@ void RV5SIDVM::Fetch_Stage() {
             next_if_id_reg_.predicted_target = btb_target;
         } 
         else {
-            next_pc_val = program_counter_ + 4;
+            next_pc_val = program_counter_ + length;
             next_if_id_reg_.predicted_outcome = false;
             next_if_id_reg_.predicted_target = 0;
         }
 
         // update pipeline register
+        next_if_id_reg_.btb_hit = btb_hit;
         next_if_id_reg_.instruction = instruction;
         next_if_id_reg_.pc = program_counter_;
-        next_if_id_reg_.pc_inc = program_counter_ + 4; 
+        next_if_id_reg_.pc_inc = program_counter_ + length;
         next_if_id_reg_.is_valid = true;
+        next_if_id_reg_.trace_id = pipeline_trace_.fetch(program_counter_, instruction);
 
         UpdateProgramCounter(next_pc_val - program_counter_);
 
@@ -268,19 +487,145 @@ void RV5SIDVM::Fetch_Stage() {
     }
 }
 
+void RV5SIDVM::FrontEnd_Stage() {
+    if (flush_pipeline_) {
+        // everything fetched or predicted past the mispredicted branch is on the wrong path
+        // program_counter_ was already corrected by the decode stage, the predictor restarts from there next cycle
+        stall_cycles_++;
+        ftq_.clear();
+        for (std::size_t i = 0; i < fetch_buffer_.size(); ++i) {
+            pipeline_trace_.squash(fetch_buffer_.at(i).trace_id);
+        }
+        fetch_buffer_.clear();
+        fetch_busy_cycles_ = 0;
+        next_if_id_reg_ = CreateBubble<IF_ID_Reg>(flush_reason_);
+        return;
+    }
+
+    predictFetchTarget();
+    fetchFromTargetQueue();
+
+    if (stall_request_) {           // decode keeps its current instruction
+        return;
+    }
+
+    if (!fetch_buffer_.empty()) {
+        next_if_id_reg_ = fetch_buffer_.front();
+        fetch_buffer_.pop();
+    } else {
+        if (program_counter_ < program_size_ || !ftq_.empty()) {
+            frontend_starvation_cycles_++;
+        }
+        next_if_id_reg_ = CreateBubble<IF_ID_Reg>();
+    }
+}
+
+void RV5SIDVM::predictFetchTarget() {
+    if (ftq_.full() || program_counter_ >= program_size_) {
+        return;
+    }
+
+    FetchTarget target;
+    target.start_pc = program_counter_;
+
+    uint64_t pc = program_counter_;
+    while (true) {
+        auto [btb_hit, btb_target] = btb_.lookup(pc);
+        bool predict_taken = branch_predictor_->getPrediction(pc);
+        target.count++;
+
+        if (btb_hit && predict_taken) {         // block ends at a predicted taken branch
+            target.predicted_taken = true;
+            target.predicted_target = btb_target;
+            pc = btb_target;
+            break;
+        }
+
+        // the predecoded length, a block ends at the instruction that reaches the alignment and holds at most as many
+        // instructions as the smallest fetch buffer
+        pc += decoder::isCompressed(memory_controller_.ReadHalfWord(pc)) ? 2 : 4;
+        if (pc / kFetchBlockBytes != target.start_pc / kFetchBlockBytes || pc >= program_size_
+            || target.count == kFetchBlockBytes / 4) {
+            break;
+        }
+    }
+
+    pushFetchTarget(target);
+    UpdateProgramCounter(pc - program_counter_);
+}
+
+void RV5SIDVM::pushFetchTarget(const FetchTarget &target) {
+    CycleSnapshot *cycle = journal_.newestCycle();
+    if (cycle && !ftq_.full()) {
+        cycle->ftq_overwritten.push_back({ftq_.tailSlot(), ftq_.slot(ftq_.tailSlot())});
+    }
+    ftq_.push(target);
+}
+
+void RV5SIDVM::pushFetched(const IF_ID_Reg &reg) {
+    CycleSnapshot *cycle = journal_.newestCycle();
+    if (cycle && !fetch_buffer_.full()) {
+        cycle->fetch_buffer_overwritten.push_back({fetch_buffer_.tailSlot(), fetch_buffer_.slot(fetch_buffer_.tailSlot())});
+    }
+    fetch_buffer_.push(reg);
+}
+
+void RV5SIDVM::fetchFromTargetQueue() {
+    if (ftq_.empty()) {
+        return;
+    }
+
+    // the access latency is paid even if the buffer is full, the block is only handed over once there is room for all of it
+    if (fetch_busy_cycles_ < fetch_latency_) {
+        fetch_busy_cycles_++;
+    }
+    const FetchTarget &target = ftq_.front();
+    if (fetch_busy_cycles_ < fetch_latency_ || fetch_buffer_.size() + target.count > fetch_buffer_.capacity()) {
+        return;
+    }
+
+    uint64_t pc = target.start_pc;
+    for (unsigned int i = 0; i < target.count; ++i) {
+        IF_ID_Reg reg{};
+        reg.pc = pc;
+        reg.is_valid = true;
+
+        bool is_last = (i + 1 == target.count);
+        reg.predicted_outcome = is_last && target.predicted_taken;
+        reg.predicted_target = reg.predicted_outcome ? target.predicted_target : 0;
+        reg.btb_hit = btb_.lookup(reg.pc).first;
+
+        try {
+            uint8_t length = 4;
+            reg.instruction = FetchInstruction(reg.pc, length);
+            reg.pc_inc = reg.pc + length;
+            pc = reg.pc_inc;
+        } catch (const std::exception& e) {
+            std::cerr << "Fetch Stage Error: " << e.what() << std::endl;
+            break;
+        }
+        reg.trace_id = pipeline_trace_.fetch(reg.pc, reg.instruction);
+        pushFetched(reg);
+    }
+
+    ftq_.pop();
+    fetch_busy_cycles_ = 0;
+}
+
 void RV5SIDVM::Decode_Stage() {
 
     if (flush_pipeline_) {          // set to true in case of a branch misprediction
         if(if_id_reg_.is_valid) {
             stall_cycles_++; 
+            pipeline_trace_.squash(if_id_reg_.trace_id);
         }
-        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>();
+        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>(flush_reason_);
         return;
     }
 
     if(!if_id_reg_.is_valid)
     {
-        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>();
+        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>(if_id_reg_.bubble_reason);
         return;
     }
 
@@ -288,6 +633,8 @@ void RV5SIDVM::Decode_Stage() {
     uint32_t instruction = if_id_reg_.instruction;
     ControlSignals control = control_unit_.getControlSignals(instruction);
 
+    pipeline_trace_.enterStage(if_id_reg_.trace_id, PipelineTrace::Stage::DECODE);
+    next_id_ex_reg_.trace_id = if_id_reg_.trace_id;
     next_id_ex_reg_.pc = if_id_reg_.pc;
     next_id_ex_reg_.pc_inc = if_id_reg_.pc_inc;
     next_id_ex_reg_.is_valid = if_id_reg_.is_valid;
@@ -298,16 +645,8 @@ void RV5SIDVM::Decode_Stage() {
     }
 
     uint8_t opcode = instruction & 0b1111111;
-    uint8_t funct3 = (instruction >> 12) & 0b111;
 
-    if(opcode == get_instr_encoding(Instruction::kecall).opcode && 
-      funct3 == get_instr_encoding(Instruction::kecall).funct3) {
-        control.is_syscall = true;
-        next_id_ex_reg_.control = control;
-        return;
-    }
-    if(opcode==0b1110011) {
-        control.is_csr = true;
+    if(control.is_syscall || control.is_csr) {
         next_id_ex_reg_.control = control;
         return;
     }
@@ -326,7 +665,8 @@ void RV5SIDVM::Decode_Stage() {
     }
 
     // Handling rs2 for alu
-    if(opcode == 0b0110011 || opcode == 0b0100011 || opcode == 0b1100011) { // R-type, S-type, B-type
+    if(opcode == 0b0110011 || opcode == 0b0111011 || opcode == 0b0100011 || opcode == 0b1100011
+        || opcode == 0b0101111) { // R-type, R-type word, S-type, B-type, AMO
         next_id_ex_reg_.rs2_index = (instruction >> 20) & 0b11111;
         next_id_ex_reg_.rs2_data = registers_.ReadGpr(next_id_ex_reg_.rs2_index);
     } else {
@@ -336,6 +676,7 @@ void RV5SIDVM::Decode_Stage() {
 
     // resolution for data hazards
     bool data_stall = false;
+    StallReason data_stall_reason = forwarding_enabled_ ? StallReason::LOAD_USE : StallReason::RAW;
     if(forwarding_enabled_) {
         data_stall = hazard_unit_.detectLoadUseHazard(control, next_id_ex_reg_.rs1_index, next_id_ex_reg_.rs2_index, id_ex_reg_);
     } else {
@@ -348,6 +689,7 @@ void RV5SIDVM::Decode_Stage() {
         if (id_ex_reg_.is_valid && id_ex_reg_.control.reg_write && id_ex_reg_.rd_index != 0) {
             if (id_ex_reg_.rd_index == next_id_ex_reg_.rs1_index || id_ex_reg_.rd_index == next_id_ex_reg_.rs2_index) {
                 data_stall = true;
+                data_stall_reason = StallReason::RAW;       // alu result is produced too late for the comparison in ID
             }
         }
     }
@@ -364,7 +706,7 @@ void RV5SIDVM::Decode_Stage() {
 
     if(data_stall) {
         stall_request_ = true;
-        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>();
+        next_id_ex_reg_ = CreateBubble<ID_EX_Reg>(data_stall_reason);
         return; 
     }
 
@@ -402,6 +744,7 @@ void RV5SIDVM::Decode_Stage() {
         }
 
         // Update Branch Predictor and BTB
+        journal_.saveBranch(if_id_reg_.pc, *branch_predictor_, branch_profile_, &btb_);
         if (control.branch) {
             branch_predictor_->updateState(if_id_reg_.pc, if_id_reg_.predicted_outcome, actual_taken);
         }
@@ -420,16 +763,26 @@ void RV5SIDVM::Decode_Stage() {
             }
         }
 
+        if (control.branch_op != BranchOp::JAL && control.branch_op != BranchOp::JALR) {
+            // resolved in ID -> only the instruction in fetch is flushed
+            branch_profile_.Record(if_id_reg_.pc, actual_taken, !prediction_correct, 1);
+        }
+
         // Handling Misprediction
         if (!prediction_correct) {
             branch_mispredictions_++;
             flush_pipeline_ = true; // flush instruction currently in fetch stage
+
+            // fetch could not have redirected to a taken target it did not find (or found stale) in the btb
+            bool target_missed = actual_taken && (!if_id_reg_.btb_hit || (if_id_reg_.predicted_outcome && if_id_reg_.predicted_target != actual_target));
+            bool unconditional = control.branch_op == BranchOp::JAL || control.branch_op == BranchOp::JALR;
+            flush_reason_ = (unconditional || target_missed) ? StallReason::BTB_MISS : StallReason::BRANCH_MISPREDICT;
             
             // Update PC to correct value
             if (actual_taken) {
                 program_counter_ = actual_target;
             } else {
-                program_counter_ = next_id_ex_reg_.pc_inc; // PC + 4
+                program_counter_ = next_id_ex_reg_.pc_inc; // PC + length
             }
         }
     }
@@ -437,10 +790,13 @@ void RV5SIDVM::Decode_Stage() {
 void RV5SIDVM::Execute_Stage() {
     if(!id_ex_reg_.is_valid)
     {
-        next_ex_mem_reg_ = CreateBubble<EX_MEM_Reg>();
+        next_ex_mem_reg_ = CreateBubble<EX_MEM_Reg>(id_ex_reg_.bubble_reason);
         return;
     }
+    pipeline_trace_.enterStage(id_ex_reg_.trace_id, PipelineTrace::Stage::EXECUTE);
     ControlSignals control = id_ex_reg_.control;
+    next_ex_mem_reg_.trace_id = id_ex_reg_.trace_id;
+    next_ex_mem_reg_.pc = id_ex_reg_.pc;
     next_ex_mem_reg_.control = id_ex_reg_.control;
     next_ex_mem_reg_.is_valid = id_ex_reg_.is_valid;
     if(control.is_nop)
@@ -544,10 +900,13 @@ void RV5SIDVM::Memory_Stage() {
     
     if(!ex_mem_reg_.is_valid)
     {
-        next_mem_wb_reg_ = CreateBubble<MEM_WB_Reg>();
+        next_mem_wb_reg_ = CreateBubble<MEM_WB_Reg>(ex_mem_reg_.bubble_reason);
         return;
     }
+    pipeline_trace_.enterStage(ex_mem_reg_.trace_id, PipelineTrace::Stage::MEMORY);
     ControlSignals control = ex_mem_reg_.control;
+    next_mem_wb_reg_.trace_id = ex_mem_reg_.trace_id;
+    next_mem_wb_reg_.pc = ex_mem_reg_.pc;
     if(control.is_nop || control.is_syscall || control.is_csr)
     {
         next_mem_wb_reg_.is_valid = ex_mem_reg_.is_valid;
@@ -560,7 +919,13 @@ void RV5SIDVM::Memory_Stage() {
     int64_t memory_result = 0;
 
     // Load Instructions
-    if(control.mem_read) {
+    if(control.is_atomic) {     // lr / sc / amo*, rs2 was carried in store_data
+        unsigned int bytes = atomicSize(control.mem_read_op);
+        journal_.saveMemory(memory_controller_, alu_result, bytes);
+        memory_result = static_cast<int64_t>(atomic_unit::execute(control.atomic_op, bytes, alu_result, store_data,
+                                                                  memory_controller_, reservation_));
+    }
+    else if(control.mem_read) {
     switch (control.mem_read_op) {
       case MemReadOp::MEM_READ_BYTE: {// LB
         memory_result = static_cast<int8_t>(memory_controller_.ReadByte(alu_result));
@@ -599,6 +964,7 @@ void RV5SIDVM::Memory_Stage() {
     }
     // Store Instructions
     else if(control.mem_write) {
+    journal_.saveMemory(memory_controller_, alu_result, storeSize(control.mem_write_op));
     switch (control.mem_write_op) {
       case MemWriteOp::MEM_WRITE_BYTE: {// SB
         memory_controller_.WriteByte(alu_result, store_data & 0xFF);
@@ -638,9 +1004,12 @@ void RV5SIDVM::Memory_Stage() {
 void RV5SIDVM::WriteBack_Stage() {
     if(!mem_wb_reg_.is_valid)
     {
+        stall_accounting_.Record(mem_wb_reg_.bubble_reason);      // no instruction retires this cycle
         return;
     }
     instructions_retired_++;
+    pipeline_trace_.enterStage(mem_wb_reg_.trace_id, PipelineTrace::Stage::WRITEBACK);
+    pipeline_trace_.retire(mem_wb_reg_.trace_id);
     ControlSignals control = mem_wb_reg_.control;
     if(control.is_syscall)
     {
@@ -674,6 +1043,7 @@ void RV5SIDVM::WriteBack_Stage() {
                 std::cerr << "Default Write Back Stage Switch" << std::endl;    
             return; 
         }
+        journal_.saveGpr(registers_, rd_index);
         registers_.WriteGpr(rd_index, write_data);
     }
 }
@@ -701,9 +1071,16 @@ void RV5SIDVM::DumpState(const std::filesystem::path &filename) {
     file << "    \"cpi\": " << cpi_ << ",\n";
     file << "    \"ipc\": " << ipc_ << ",\n";
     file << "    \"stall_cycles\": " << stall_cycles_ << ",\n";
-    file << "    \"branch_mispredictions\": " << branch_mispredictions_ << "\n";
+    file << "    \"branch_mispredictions\": " << branch_mispredictions_ << ",\n";
+    file << "    \"ftq_depth\": " << ftq_.capacity() << ",\n";
+    file << "    \"ftq_occupancy\": " << ftq_.size() << ",\n";
+    file << "    \"fetch_buffer_occupancy\": " << fetch_buffer_.size() << ",\n";
+    file << "    \"frontend_starvation_cycles\": " << frontend_starvation_cycles_ << "\n";
     file << "  },\n";
 
+    stall_accounting_.DumpJson(file, cycle_s_, instructions_retired_, "  ");
+    file << ",\n";
+
     // Dump the pipeline registers
     DumpPipelineRegisters(file, if_id_reg_, id_ex_reg_, ex_mem_reg_, mem_wb_reg_);
 
@@ -7,6 +7,7 @@
 #include "vm/rv5s/rv5s_control_unit.h"
 #include "vm/rv5s/pipeline_registers.h"
 #include "vm/rv5s/rv5s_hazard_unit.h"
+#include "vm/state_file.h"
 #include "utils.h"
 #include "globals.h"
 #include "common/instructions.h"
@@ -25,7 +26,6 @@
 #include <atomic>
 
 using instruction_set::Instruction;
-using instruction_set::get_instr_encoding;
 using instruction_type::MemReadOp;
 using instruction_type::MemWriteOp;
 using instruction_type::WriteBackSrc;
@@ -46,9 +46,13 @@ void RV5SStallVM::Reset() {
     ipc_ = 0.0;
     stall_cycles_ = 0;
     branch_mispredictions_ = 0;
+    reservation_ = {};
+    control_unit_.enableAtomicDecode(true);
 
     stall_request_= false;
     flush_pipeline_ = false;
+    journal_.setDepth(vm_config::config.getUndoDepth());
+    redo_cycles_ = 0;
 
     registers_.Reset();
     memory_controller_.Reset();
@@ -79,6 +83,11 @@ void RV5SStallVM::Step() {
         return;
     }
 
+    redo_cycles_ = 0;                   // a new cycle replaces the undone ones
+    if(journal_.enabled()) {
+        saveCycle();
+    }
+
     stall_request_ = false;
     flush_pipeline_ = false;
 
@@ -177,11 +186,94 @@ void RV5SStallVM::DebugRun() {
 }
 
 void RV5SStallVM::Undo() {
-    std::cerr << "Undo/Redo Feature is not available in multi-stage pipelining mode." << std::endl;    
+    if(journal_.empty()) {
+        std::cout << "VM_NO_MORE_UNDO" << std::endl;
+        output_status_ = "VM_NO_MORE_UNDO";
+        return;
+    }
+
+    restoreCycle(journal_.undoCycle(registers_, memory_controller_));
+    redo_cycles_++;
+
+    std::cout << "Program Counter: " << program_counter_ << std::endl;
+    output_status_ = "VM_UNDO_COMPLETED";
+    std::cout << "VM_UNDO_COMPLETED" << std::endl;
+
+    if(!silent_mode_) {
+        DumpRegisters(globals::registers_dump_file_path, registers_);
+        DumpState(globals::vm_state_dump_file_path);
+    }
 }
 
 void RV5SStallVM::Redo() {
-    std::cerr << "Undo/Redo Feature is not available in multi-stage pipelining mode." << std::endl;
+    if(redo_cycles_ == 0) {
+        std::cout << "VM_NO_MORE_REDO" << std::endl;
+        return;
+    }
+
+    // the pipeline is deterministic, running the undone cycle again redoes it
+    unsigned int remaining = redo_cycles_ - 1;
+    Step();
+    redo_cycles_ = remaining;
+}
+
+void RV5SStallVM::saveCycle() {
+    PipelineSnapshot &snapshot = journal_.beginCycle();
+    snapshot.saveCounters(*this);
+    snapshot.if_id = if_id_reg_;
+    snapshot.id_ex = id_ex_reg_;
+    snapshot.ex_mem = ex_mem_reg_;
+    snapshot.mem_wb = mem_wb_reg_;
+    snapshot.next_if_id = next_if_id_reg_;
+    snapshot.next_id_ex = next_id_ex_reg_;
+    snapshot.next_ex_mem = next_ex_mem_reg_;
+    snapshot.next_mem_wb = next_mem_wb_reg_;
+}
+
+void RV5SStallVM::restoreCycle(const PipelineSnapshot &snapshot) {
+    snapshot.restoreCounters(*this);
+    if_id_reg_ = snapshot.if_id;
+    id_ex_reg_ = snapshot.id_ex;
+    ex_mem_reg_ = snapshot.ex_mem;
+    mem_wb_reg_ = snapshot.mem_wb;
+    next_if_id_reg_ = snapshot.next_if_id;
+    next_id_ex_reg_ = snapshot.next_id_ex;
+    next_ex_mem_reg_ = snapshot.next_ex_mem;
+    next_mem_wb_reg_ = snapshot.next_mem_wb;
+}
+
+uint64_t RV5SStallVM::ResumePc() const {
+    return oldestPipelinePc(if_id_reg_, id_ex_reg_, ex_mem_reg_, mem_wb_reg_, program_counter_);
+}
+
+void RV5SStallVM::SaveMicroarchState(StateWriter &writer) {
+    writer.beginSection(state_file::kTagStallPipeline);
+    writer.write(program_counter_);
+    writer.write(if_id_reg_);
+    writer.write(id_ex_reg_);
+    writer.write(ex_mem_reg_);
+    writer.write(mem_wb_reg_);
+    writer.write(next_if_id_reg_);
+    writer.write(next_id_ex_reg_);
+    writer.write(next_ex_mem_reg_);
+    writer.write(next_mem_wb_reg_);
+    writer.endSection();
+}
+
+bool RV5SStallVM::LoadMicroarchSection(StateReader &reader, uint32_t tag) {
+    if (tag != state_file::kTagStallPipeline) {
+        return false;
+    }
+    reader.read(program_counter_);
+    reader.read(if_id_reg_);
+    reader.read(id_ex_reg_);
+    reader.read(ex_mem_reg_);
+    reader.read(mem_wb_reg_);
+    reader.read(next_if_id_reg_);
+    reader.read(next_id_ex_reg_);
+    reader.read(next_ex_mem_reg_);
+    reader.read(next_mem_wb_reg_);
+    return true;
 }
 
 void RV5SStallVM::Fetch_Stage() {
@@ -199,10 +291,11 @@ void RV5SStallVM::Fetch_Stage() {
 
     // the Memory::ReadWord function throws a std::out_of_range exception if an invalid memory address is read. Safety Check -> 
     try {
-        uint32_t instruction = memory_controller_.ReadWord(program_counter_);
+        uint8_t length = 4;
+        uint32_t instruction = FetchInstruction(program_counter_, length);
         next_if_id_reg_.instruction = instruction;
         next_if_id_reg_.pc = program_counter_;       // original pc stored 
-        UpdateProgramCounter(4);
+        UpdateProgramCounter(length);
         next_if_id_reg_.pc_inc = program_counter_; // the incremented pc to be stored in the pipeline register
         next_if_id_reg_.is_valid = true;
     } catch(const std::exception& e) {
@@ -241,16 +334,8 @@ void RV5SStallVM::Decode_Stage() {
     }
 
     uint8_t opcode = instruction & 0b1111111;
-    uint8_t funct3 = (instruction >> 12) & 0b111;
 
-    if(opcode == get_instr_encoding(Instruction::kecall).opcode && 
-      funct3 == get_instr_encoding(Instruction::kecall).funct3) {
-        control.is_syscall = true;
-        next_id_ex_reg_.control = control;
-        return;
-    }
-    if(opcode==0b1110011) {
-        control.is_csr = true;
+    if(control.is_syscall || control.is_csr) {
         next_id_ex_reg_.control = control;
         return;
     }
@@ -269,7 +354,8 @@ void RV5SStallVM::Decode_Stage() {
     }
 
     // Handling rs2 for alu
-    if(opcode == 0b0110011 || opcode == 0b0100011 || opcode == 0b1100011) { // R-type, S-type, B-type
+    if(opcode == 0b0110011 || opcode == 0b0111011 || opcode == 0b0100011 || opcode == 0b1100011
+        || opcode == 0b0101111) { // R-type, R-type word, S-type, B-type, AMO
         next_id_ex_reg_.rs2_index = (instruction >> 20) & 0b11111;
         next_id_ex_reg_.rs2_data = registers_.ReadGpr(next_id_ex_reg_.rs2_index);
     } else {
@@ -417,7 +503,13 @@ void RV5SStallVM::Memory_Stage() {
     int64_t memory_result = 0;
 
     // Load Instructions
-    if(control.mem_read) {
+    if(control.is_atomic) {     // lr / sc / amo*, rs2 was carried in store_data
+        unsigned int bytes = atomicSize(control.mem_read_op);
+        journal_.saveMemory(memory_controller_, alu_result, bytes);
+        memory_result = static_cast<int64_t>(atomic_unit::execute(control.atomic_op, bytes, alu_result, store_data,
+                                                                  memory_controller_, reservation_));
+    }
+    else if(control.mem_read) {
     switch (control.mem_read_op) {
       case MemReadOp::MEM_READ_BYTE: {// LB
         memory_result = static_cast<int8_t>(memory_controller_.ReadByte(alu_result));
@@ -456,6 +548,7 @@ void RV5SStallVM::Memory_Stage() {
     }
     // Store Instructions
     else if(control.mem_write) {
+    journal_.saveMemory(memory_controller_, alu_result, storeSize(control.mem_write_op));
     switch (control.mem_write_op) {
       case MemWriteOp::MEM_WRITE_BYTE: {// SB
         memory_controller_.WriteByte(alu_result, store_data & 0xFF);
@@ -531,6 +624,7 @@ void RV5SStallVM::WriteBack_Stage() {
                 std::cerr << "Default Write Back Stage Switch" << std::endl;    
             return; 
         }
+        journal_.saveGpr(registers_, rd_index);
         registers_.WriteGpr(rd_index, data_to_write);
     }
 }
@@ -0,0 +1,665 @@
+/**
+ * @file rv5s_superscalar_vm.cpp
+ * @brief Implementation of the N-wide in-order superscalar 5-stage pipelined RISC-V VM
+ * Up to issue_width instructions move through every stage per cycle. Decode issues the oldest instructions of the IF/ID group in order
+ * and stops at the first one that has a hazard, depends on an older instruction of the same group or finds no free functional unit port.
+ * Instructions that could not issue stay in IF/ID and fetch only fills the freed slots.
+ */
+
+#include "vm/rv5s/rv5s_superscalar_vm.h"
+#include "vm/rv5s/branch_prediction/branch_trace.h"
+#include "vm/state_file.h"
+
+#include "utils.h"
+#include "globals.h"
+#include "common/instructions.h"
+#include "config.h"
+
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <tuple>
+
+using instruction_set::Instruction;
+using instruction_type::MemReadOp;
+using instruction_type::MemWriteOp;
+using instruction_type::WriteBackSrc;
+using instruction_type::AluSrcA;
+using instruction_type::BranchOp;
+using vm_config::DataHazardMode;
+using vm_config::BranchPredictorType;
+
+RV5SSuperscalarVM::RV5SSuperscalarVM(bool silent) : VmBase(silent) {
+    Reset();
+}
+
+RV5SSuperscalarVM::~RV5SSuperscalarVM() = default;
+
+void RV5SSuperscalarVM::enableForwarding(bool enable) {
+    forwarding_enabled_ = enable;
+}
+
+void RV5SSuperscalarVM::setBranchPredictorType(BranchPredictorType type) {
+    if (type == BranchPredictorType::TOURNAMENT) {          // not implemented yet, same fallback as the scalar pipelines
+        type = BranchPredictorType::STATIC_NOT_TAKEN;
+    }
+    branch_predictor_ = makeBranchPredictor(type);
+}
+
+void RV5SSuperscalarVM::Reset() {
+    program_counter_ = 0;
+    instructions_retired_ = 0;
+    cycle_s_ = 0;
+    cpi_ = 0.0;
+    ipc_ = 0.0;
+    stall_cycles_ = 0;
+    branch_mispredictions_ = 0;
+    reservation_ = {};
+    control_unit_.enableAtomicDecode(true);
+    branch_profile_.Clear();
+    multi_issue_cycles_ = 0;
+
+    width_ = vm_config::config.getIssueWidth();
+    alu_ports_ = vm_config::config.getAluPorts();
+    mem_ports_ = vm_config::config.getMemPorts();
+    branch_ports_ = vm_config::config.getBranchPorts();
+    fp_ports_ = vm_config::config.getFpPorts();
+
+    flush_pipeline_ = false;
+    decode_redirect_ = false;
+    issued_count_ = 0;
+    forwarding_enabled_ = vm_config::config.getDataHazardMode() == DataHazardMode::FORWARDING;
+    setBranchPredictorType(vm_config::config.getBranchPredictorType());
+
+    registers_.Reset();
+    memory_controller_.Reset();
+    program_size_ = 0;
+
+    if_id_regs_ = CreateBubbles<IF_ID_Reg>(width_);
+    id_ex_regs_ = CreateBubbles<ID_EX_Reg>(width_);
+    ex_mem_regs_ = CreateBubbles<EX_MEM_Reg>(width_);
+    mem_wb_regs_ = CreateBubbles<MEM_WB_Reg>(width_);
+
+    next_if_id_regs_ = CreateBubbles<IF_ID_Reg>(width_);
+    next_id_ex_regs_ = CreateBubbles<ID_EX_Reg>(width_);
+    next_ex_mem_regs_ = CreateBubbles<EX_MEM_Reg>(width_);
+    next_mem_wb_regs_ = CreateBubbles<MEM_WB_Reg>(width_);
+
+    if(!silent_mode_) {
+        DumpRegisters(globals::registers_dump_file_path, registers_);
+        DumpState(globals::vm_state_dump_file_path);
+    }
+}
+
+void RV5SSuperscalarVM::Step() {
+    if(output_status_ == "VM_PROGRAM_END") {
+        std::cout << "VM_PROGRAM_END" << std::endl;
+        return;
+    }
+
+    flush_pipeline_ = false;
+    decode_redirect_ = false;
+
+    WriteBack_Stage();
+    Memory_Stage();
+    Execute_Stage();
+    Decode_Stage();
+    Fetch_Stage();          // also carries over the IF/ID instructions decode could not issue
+
+    cycle_s_++;
+    if_id_regs_ = next_if_id_regs_;
+    id_ex_regs_ = next_id_ex_regs_;
+    ex_mem_regs_ = next_ex_mem_regs_;
+    mem_wb_regs_ = next_mem_wb_regs_;
+
+    if(instructions_retired_ > 0) {
+        cpi_ = static_cast<double>(cycle_s_) / instructions_retired_;
+        ipc_ = static_cast<double>(instructions_retired_) / cycle_s_;
+    }
+    else {
+        cpi_ = 0.0;
+        ipc_ = 0.0;
+    }
+
+    if(!silent_mode_) {
+        DumpRegisters(globals::registers_dump_file_path, registers_);
+        DumpState(globals::vm_state_dump_file_path);
+    }
+
+    bool all_instructions_fetched = (program_counter_ >= program_size_);
+    bool is_pipeline_empty = true;
+    for (std::size_t slot = 0; slot < width_; ++slot) {
+        if (if_id_regs_[slot].is_valid || id_ex_regs_[slot].is_valid || ex_mem_regs_[slot].is_valid || mem_wb_regs_[slot].is_valid) {
+            is_pipeline_empty = false;
+            break;
+        }
+    }
+
+    if(all_instructions_fetched && is_pipeline_empty) {
+        RequestStop();
+        std::cout << "VM_PROGRAM_END" << std::endl;
+        output_status_ = "VM_PROGRAM_END";
+
+        if(!silent_mode_) {
+            DumpState(globals::vm_state_dump_file_path);
+        }
+    } else {
+        std::cout << "VM_STEP_COMPLETED" << std::endl;
+        output_status_ = "VM_STEP_COMPLETED";
+    }
+}
+
+void RV5SSuperscalarVM::Run() {
+    ClearStop();
+
+    output_status_ = "VM_RUNNING";
+    while (true) {
+        if(stop_requested_) {
+            stop_requested_ = false;
+            break;
+        }
+        Step();
+        std::cout << "Program Counter: " << program_counter_ << std::endl;
+    }
+}
+
+void RV5SSuperscalarVM::DebugRun() {
+    ClearStop();
+    output_status_ = "VM_RUNNING";
+    while (true) {
+        if(stop_requested_) {
+            stop_requested_ = false;
+            break;
+        }
+        if(CheckBreakpoint(program_counter_)) {
+            std::cout << "VM_BREAKPOINT_HIT " << program_counter_ << std::endl;
+            output_status_ = "VM_BREAKPOINT_HIT";
+            if(!silent_mode_) {
+                DumpState(globals::vm_state_dump_file_path);
+            }
+            break;
+        }
+        Step();
+        std::cout << "Program Counter: " << program_counter_ << std::endl;
+        unsigned int delay_ms = vm_config::config.getRunStepDelay();
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+    }
+}
+
+void RV5SSuperscalarVM::Undo() {
+    std::cerr << "Undo/Redo Feature is not available in multi-stage pipelining mode." << std::endl;
+}
+
+void RV5SSuperscalarVM::Redo() {
+    std::cerr << "Undo/Redo Feature is not available in multi-stage pipelining mode." << std::endl;
+}
+
+// the slots are not saved, a loaded state refills the pipeline from its oldest instruction
+uint64_t RV5SSuperscalarVM::ResumePc() const {
+    for (const MEM_WB_Reg &reg : mem_wb_regs_) if (reg.is_valid) return reg.pc;
+    for (const EX_MEM_Reg &reg : ex_mem_regs_) if (reg.is_valid) return reg.pc;
+    for (const ID_EX_Reg &reg : id_ex_regs_) if (reg.is_valid) return reg.pc;
+    for (const IF_ID_Reg &reg : if_id_regs_) if (reg.is_valid) return reg.pc;
+    return program_counter_;
+}
+
+void RV5SSuperscalarVM::SaveMicroarchState(StateWriter &writer) {
+    branch_predictor_->saveState(writer);
+}
+
+bool RV5SSuperscalarVM::LoadMicroarchSection(StateReader &reader, uint32_t tag) {
+    if (tag != state_file::kTagPredictor) {
+        return false;
+    }
+    branch_predictor_->loadState(reader);
+    return true;
+}
+
+void RV5SSuperscalarVM::Fetch_Stage() {
+    next_if_id_regs_ = CreateBubbles<IF_ID_Reg>(width_);
+
+    if (flush_pipeline_) {          // program_counter_ already points to the correct path
+        stall_cycles_++;
+        return;
+    }
+    if (decode_redirect_) {         // the fetch slot of this cycle is lost to the redirect, as in the scalar pipeline
+        return;
+    }
+
+    // instructions decode could not issue keep their order at the front of the group
+    std::size_t filled = 0;
+    for (std::size_t slot = issued_count_; slot < width_; ++slot) {
+        if (if_id_regs_[slot].is_valid) {
+            next_if_id_regs_[filled++] = if_id_regs_[slot];
+        }
+    }
+
+    while (filled < width_ && program_counter_ < program_size_) {
+        IF_ID_Reg &reg = next_if_id_regs_[filled];
+        uint8_t length = 4;
+        try {
+            reg.instruction = FetchInstruction(program_counter_, length);
+            reg.is_valid = true;
+        } catch(const std::exception& e) {
+            std::cerr << "Fetch Stage Error: " << e.what() << std::endl;
+            reg.is_valid = false;
+        }
+        reg.pc = program_counter_;
+        UpdateProgramCounter(length);
+        reg.pc_inc = program_counter_;
+        filled++;
+    }
+}
+
+bool RV5SSuperscalarVM::decodeSlot(const IF_ID_Reg &if_id_reg, ID_EX_Reg &id_ex_reg) {
+    uint32_t instruction = if_id_reg.instruction;
+    ControlSignals control = control_unit_.getControlSignals(instruction);
+
+    id_ex_reg.pc = if_id_reg.pc;
+    id_ex_reg.pc_inc = if_id_reg.pc_inc;
+    id_ex_reg.is_valid = if_id_reg.is_valid;
+    id_ex_reg.control = control;
+    if(control.is_nop) {
+        return true;
+    }
+
+    uint8_t opcode = instruction & 0b1111111;
+
+    if(control.is_syscall || control.is_csr) {
+        return true;
+    }
+
+    id_ex_reg.rd_index = (instruction >> 7) & 0b11111;
+    id_ex_reg.immediate = ImmGenerator(instruction);
+
+    if(opcode == 0b0110111 || opcode == 0b0010111) { // lui, auipc
+        id_ex_reg.rs1_index = 0;
+        id_ex_reg.rs1_data = 0;
+    } else {
+        id_ex_reg.rs1_index = (instruction >> 15) & 0b11111;
+        id_ex_reg.rs1_data = registers_.ReadGpr(id_ex_reg.rs1_index);
+    }
+
+    if(opcode == 0b0110011 || opcode == 0b0111011 || opcode == 0b0100011 || opcode == 0b1100011
+        || opcode == 0b0101111) { // R-type, R-type word, S-type, B-type, AMO
+        id_ex_reg.rs2_index = (instruction >> 20) & 0b11111;
+        id_ex_reg.rs2_data = registers_.ReadGpr(id_ex_reg.rs2_index);
+    } else {
+        id_ex_reg.rs2_index = 0;
+        id_ex_reg.rs2_data = 0;
+    }
+    return true;
+}
+
+void RV5SSuperscalarVM::Decode_Stage() {
+    next_id_ex_regs_ = CreateBubbles<ID_EX_Reg>(width_);
+    issued_count_ = 0;
+
+    if (flush_pipeline_) {
+        for (const IF_ID_Reg &reg : if_id_regs_) {
+            if (reg.is_valid) {
+                stall_cycles_++;
+                break;
+            }
+        }
+        issued_count_ = width_;
+        return;
+    }
+
+    std::size_t alu_used = 0, mem_used = 0, branch_used = 0, fp_used = 0;
+    std::size_t issued_valid = 0;
+    bool group_has_valid = false;
+
+    for (std::size_t slot = 0; slot < width_; ++slot) {
+        const IF_ID_Reg &if_id_reg = if_id_regs_[slot];
+        if (!if_id_reg.is_valid) {
+            issued_count_++;
+            continue;
+        }
+        group_has_valid = true;
+
+        ID_EX_Reg candidate;
+        decodeSlot(if_id_reg, candidate);
+        ControlSignals control = candidate.control;
+
+        // structural hazard: one issue port of the instruction's functional unit class must be free
+        std::size_t *used = &alu_used;
+        std::size_t ports = alu_ports_;
+        switch (getFuClass(if_id_reg.instruction)) {
+            case FuClass::MEM: used = &mem_used; ports = mem_ports_; break;
+            case FuClass::BRANCH: used = &branch_used; ports = branch_ports_; break;
+            case FuClass::FP: used = &fp_used; ports = fp_ports_; break;
+            case FuClass::ALU: default: break;
+        }
+        if (!control.is_nop && *used >= ports) {
+            break;
+        }
+
+        // data hazards with the older groups in EX and MEM
+        bool data_stall = false;
+        if (forwarding_enabled_) {
+            data_stall = hazard_unit_.detectLoadUseHazard(control, candidate.rs1_index, candidate.rs2_index, id_ex_regs_);
+        } else {
+            data_stall = hazard_unit_.detectDataHazard(control, candidate.rs1_index, candidate.rs2_index, id_ex_regs_, ex_mem_regs_);
+        }
+
+        // intra-group dependence: the producer issues in this same cycle, nothing can be bypassed to the consumer yet
+        if (!data_stall) {
+            data_stall = hazard_unit_.detectDataHazard(control, candidate.rs1_index, candidate.rs2_index, next_id_ex_regs_, {});
+        }
+        if (data_stall) {
+            break;
+        }
+
+        if (!control.is_nop) {
+            (*used)++;
+        }
+
+        // control hazards: predicted in decode, as in the scalar branch-in-EX pipeline
+        bool redirect = false;
+        if (control.branch_op == BranchOp::JAL || control.branch_op == BranchOp::JALR) {
+            candidate.predicted_outcome = true;
+            if (control.branch_op == BranchOp::JAL) {
+                program_counter_ = candidate.pc + candidate.immediate;
+            }
+            redirect = true;
+        }
+        else if (control.branch) {
+            candidate.predicted_outcome = branch_predictor_->getPrediction(candidate.pc);
+            if (candidate.predicted_outcome) {
+                program_counter_ = candidate.pc + candidate.immediate;
+                redirect = true;
+            }
+        }
+
+        next_id_ex_regs_[slot] = candidate;
+        issued_count_++;
+        issued_valid++;
+
+        if (redirect) {                 // younger instructions of the group are on the wrong path
+            decode_redirect_ = true;
+            issued_count_ = width_;
+            break;
+        }
+    }
+
+    if (group_has_valid && issued_valid == 0) {
+        stall_cycles_++;
+    }
+    if (issued_valid > 1) {
+        multi_issue_cycles_++;
+    }
+}
+
+uint64_t RV5SSuperscalarVM::getForwardedData(uint8_t rs_index, uint64_t reg_data) {
+    BypassSource bypass = forwarding_unit_.getBypassSource(rs_index, ex_mem_regs_, mem_wb_regs_);
+    switch (bypass.src) {
+        case ForwardSrc::FROM_EX_MEM: {
+            const EX_MEM_Reg &reg = ex_mem_regs_[bypass.slot];
+            return reg.control.wb_src == WriteBackSrc::WB_FROM_PC_INC ? reg.pc_inc : reg.alu_result;
+        }
+        case ForwardSrc::FROM_MEM_WB:
+            return getWriteBackData(mem_wb_regs_[bypass.slot]);
+        case ForwardSrc::FROM_REG:
+        default:
+            return reg_data;
+    }
+}
+
+bool RV5SSuperscalarVM::executeSlot(const ID_EX_Reg &id_ex_reg, EX_MEM_Reg &ex_mem_reg) {
+    ControlSignals control = id_ex_reg.control;
+    ex_mem_reg.control = control;
+    ex_mem_reg.is_valid = id_ex_reg.is_valid;
+    ex_mem_reg.pc = id_ex_reg.pc;
+    ex_mem_reg.pc_inc = id_ex_reg.pc_inc;
+    if(control.is_nop || control.is_csr || control.is_syscall) {
+        return true;
+    }
+
+    uint64_t data_alu_a = id_ex_reg.rs1_data;
+    uint64_t data_alu_b = id_ex_reg.rs2_data;
+    if(forwarding_enabled_) {
+        data_alu_a = getForwardedData(id_ex_reg.rs1_index, data_alu_a);
+        data_alu_b = getForwardedData(id_ex_reg.rs2_index, data_alu_b);
+    }
+
+    uint64_t reg1_value, reg2_value;
+    switch (control.alu_src_a) {
+        case AluSrcA::ALU_SRC_A_PC:         // for auipc
+            reg1_value = id_ex_reg.pc;
+            break;
+        case AluSrcA::ALU_SRC_A_ZERO:       // for lui
+            reg1_value = 0;
+            break;
+        case AluSrcA::ALU_SRC_A_RS1:
+        default:
+            reg1_value = data_alu_a;
+            break;
+    }
+
+    if(control.alu_src_a == AluSrcA::ALU_SRC_A_ZERO || control.alu_src_a == AluSrcA::ALU_SRC_A_PC) {   // lui, auipc
+        if(control.branch_op != BranchOp::JAL) {
+            reg2_value = static_cast<uint64_t>(static_cast<int64_t>(id_ex_reg.immediate)) << 12;
+            if(reg2_value & 0x80000000) {   // sign extend the 32 bit result
+                reg2_value |= 0xFFFFFFFF00000000;
+            }
+        } else {                            // jal
+            reg2_value = static_cast<uint64_t>(static_cast<int64_t>(id_ex_reg.immediate));
+        }
+    }
+    else if(control.alu_src_b) {            // normal I type
+        reg2_value = static_cast<uint64_t>(static_cast<int64_t>(id_ex_reg.immediate));
+    }
+    else {                                  // R type
+        reg2_value = data_alu_b;
+    }
+
+    bool overflow = false;
+    int64_t execution_result;
+    std::tie(execution_result, overflow) = alu_.execute(control.alu_op, reg1_value, reg2_value);
+
+    ex_mem_reg.alu_result = execution_result;
+    ex_mem_reg.store_data = data_alu_b;
+    ex_mem_reg.rd_index = id_ex_reg.rd_index;
+
+    if(!control.branch && control.branch_op != BranchOp::JAL && control.branch_op != BranchOp::JALR) {
+        return true;
+    }
+
+    bool actual_outcome = false;
+    int64_t target_address = 0;
+    if(control.branch_op == BranchOp::JAL || control.branch_op == BranchOp::JALR) {
+        actual_outcome = true;
+        target_address = execution_result;
+    }
+    else {
+        switch (control.branch_op) {
+            case BranchOp::BEQ:  actual_outcome = (execution_result == 0); break;
+            case BranchOp::BNE:  actual_outcome = (execution_result != 0); break;
+            case BranchOp::BLT:  actual_outcome = (execution_result == 1); break;
+            case BranchOp::BGE:  actual_outcome = (execution_result == 0); break;
+            case BranchOp::BLTU: actual_outcome = (execution_result == 1); break;
+            case BranchOp::BGEU: actual_outcome = (execution_result == 0); break;
+            default: break;
+        }
+        if(actual_outcome) {
+            target_address = id_ex_reg.pc + id_ex_reg.immediate;
+        }
+    }
+
+    bool predicted_outcome = id_ex_reg.predicted_outcome;
+    if(control.branch) {
+        branch_predictor_->updateState(id_ex_reg.pc, predicted_outcome, actual_outcome);
+    }
+    if (control.branch_op != BranchOp::JAL && control.branch_op != BranchOp::JALR) {
+        branch_profile_.Record(id_ex_reg.pc, actual_outcome, predicted_outcome != actual_outcome, 2);
+    }
+
+    if (control.branch_op == BranchOp::JALR) {      // target only known now
+        program_counter_ = target_address;
+        flush_pipeline_ = true;
+    }
+    else if(predicted_outcome != actual_outcome) {
+        flush_pipeline_ = true;
+        branch_mispredictions_++;
+        program_counter_ = actual_outcome ? target_address : id_ex_reg.pc_inc;
+    }
+    return !flush_pipeline_;
+}
+
+void RV5SSuperscalarVM::Execute_Stage() {
+    next_ex_mem_regs_ = CreateBubbles<EX_MEM_Reg>(width_);
+    for (std::size_t slot = 0; slot < width_; ++slot) {
+        if (!id_ex_regs_[slot].is_valid) {
+            continue;
+        }
+        if (!executeSlot(id_ex_regs_[slot], next_ex_mem_regs_[slot])) {
+            break;                      // younger slots of the group were fetched down the wrong path
+        }
+    }
+}
+
+void RV5SSuperscalarVM::memorySlot(const EX_MEM_Reg &ex_mem_reg, MEM_WB_Reg &mem_wb_reg) {
+    ControlSignals control = ex_mem_reg.control;
+    mem_wb_reg.is_valid = ex_mem_reg.is_valid;
+    mem_wb_reg.control = control;
+    mem_wb_reg.pc = ex_mem_reg.pc;
+    mem_wb_reg.pc_inc = ex_mem_reg.pc_inc;
+    if(control.is_nop || control.is_syscall || control.is_csr) {
+        return;
+    }
+
+    uint64_t address = ex_mem_reg.alu_result;
+    uint64_t store_data = ex_mem_reg.store_data;
+    int64_t memory_result = 0;
+
+    if(control.is_atomic) {     // lr / sc / amo*, rs2 was carried in store_data
+        memory_result = static_cast<int64_t>(atomic_unit::execute(control.atomic_op, atomicSize(control.mem_read_op),
+                                                                  address, store_data, memory_controller_, reservation_));
+    }
+    else if(control.mem_read) {
+        switch (control.mem_read_op) {
+            case MemReadOp::MEM_READ_BYTE: memory_result = static_cast<int8_t>(memory_controller_.ReadByte(address)); break;
+            case MemReadOp::MEM_READ_HALF: memory_result = static_cast<int16_t>(memory_controller_.ReadHalfWord(address)); break;
+            case MemReadOp::MEM_READ_WORD: memory_result = static_cast<int32_t>(memory_controller_.ReadWord(address)); break;
+            case MemReadOp::MEM_READ_DOUBLE: memory_result = memory_controller_.ReadDoubleWord(address); break;
+            case MemReadOp::MEM_READ_BYTE_UNSIGNED: memory_result = static_cast<uint8_t>(memory_controller_.ReadByte(address)); break;
+            case MemReadOp::MEM_READ_HALF_UNSIGNED: memory_result = static_cast<uint16_t>(memory_controller_.ReadHalfWord(address)); break;
+            case MemReadOp::MEM_READ_WORD_UNSIGNED: memory_result = static_cast<uint32_t>(memory_controller_.ReadWord(address)); break;
+            case MemReadOp::MEM_READ_NONE:
+            default:
+                std::cerr << "Default Condition Reached in Read Memory Switch" << std::endl;
+                break;
+        }
+    }
+    else if(control.mem_write) {
+        switch (control.mem_write_op) {
+            case MemWriteOp::MEM_WRITE_BYTE: memory_controller_.WriteByte(address, store_data & 0xFF); break;
+            case MemWriteOp::MEM_WRITE_HALF: memory_controller_.WriteHalfWord(address, store_data & 0xFFFF); break;
+            case MemWriteOp::MEM_WRITE_WORD: memory_controller_.WriteWord(address, store_data & 0xFFFFFFFF); break;
+            case MemWriteOp::MEM_WRITE_DOUBLE: memory_controller_.WriteDoubleWord(address, store_data); break;
+            case MemWriteOp::MEM_WRITE_NONE:
+            default:
+                std::cerr << "Default Condition Reached in Write Memory Switch" << std::endl;
+                break;
+        }
+    }
+
+    if(control.mem_read) {
+        mem_wb_reg.memory_data = memory_result;
+    } else {
+        mem_wb_reg.alu_result = address;
+    }
+    mem_wb_reg.rd_index = ex_mem_reg.rd_index;
+}
+
+void RV5SSuperscalarVM::Memory_Stage() {
+    next_mem_wb_regs_ = CreateBubbles<MEM_WB_Reg>(width_);
+    for (std::size_t slot = 0; slot < width_; ++slot) {     // program order -> stores and loads of a group stay ordered
+        if (ex_mem_regs_[slot].is_valid) {
+            memorySlot(ex_mem_regs_[slot], next_mem_wb_regs_[slot]);
+        }
+    }
+}
+
+uint64_t RV5SSuperscalarVM::getWriteBackData(const MEM_WB_Reg &mem_wb_reg) {
+    switch (mem_wb_reg.control.wb_src) {
+        case WriteBackSrc::WB_FROM_ALU:
+            return mem_wb_reg.alu_result;
+        case WriteBackSrc::WB_FROM_MEM:
+            return mem_wb_reg.memory_data;
+        case WriteBackSrc::WB_FROM_PC_INC:
+            return mem_wb_reg.pc_inc;
+        case WriteBackSrc::WB_NONE:
+        default:
+            std::cerr << "Default Write Back Stage Switch" << std::endl;
+            return 0;
+    }
+}
+
+void RV5SSuperscalarVM::writeBackSlot(const MEM_WB_Reg &mem_wb_reg) {
+    instructions_retired_++;
+    ControlSignals control = mem_wb_reg.control;
+    if(control.is_syscall || control.is_csr) {
+        return;
+    }
+    if(control.reg_write && mem_wb_reg.rd_index != 0) {
+        registers_.WriteGpr(mem_wb_reg.rd_index, getWriteBackData(mem_wb_reg));
+    }
+}
+
+void RV5SSuperscalarVM::WriteBack_Stage() {
+    for (std::size_t slot = 0; slot < width_; ++slot) {     // program order -> the youngest write to a register wins
+        if (mem_wb_regs_[slot].is_valid) {
+            writeBackSlot(mem_wb_regs_[slot]);
+        }
+    }
+}
+
+void RV5SSuperscalarVM::DumpState(const std::filesystem::path &filename) {
+    std::ofstream file(filename);
+    if(!file.is_open()) {
+        std::cerr << "Unable to open vm_state_dump file: " << filename << std::endl;
+        return;
+    }
+
+    file << "{\n";
+
+    file << "  \"vm_state\": {\n";
+    file << "    \"program_counter\": " << program_counter_ << ",\n";
+    file << "    \"output_status\": \"" << output_status_ << "\",\n";
+    file << "    \"flush_pipeline\": \"" << flush_pipeline_ << "\",\n";
+    file << "    \"issue_width\": " << width_ << ",\n";
+    file << "    \"cycles\": " << cycle_s_ << ",\n";
+    file << "    \"instructions_retired\": " << instructions_retired_ << ",\n";
+    file << "    \"cpi\": " << cpi_ << ",\n";
+    file << "    \"ipc\": " << ipc_ << ",\n";
+    file << "    \"stall_cycles\": " << stall_cycles_ << ",\n";
+    file << "    \"multi_issue_cycles\": " << multi_issue_cycles_ << ",\n";
+    file << "    \"branch_mispredictions\": " << branch_mispredictions_ << "\n";
+    file << "  },\n";
+
+    // pcs of the valid instructions in every stage, slot 0 first
+    auto dump_slots = [&](const char *name, const auto &regs, bool last) {
+        file << "    \"" << name << "\": [";
+        bool first = true;
+        for (const auto &reg : regs) {
+            if (!reg.is_valid) continue;
+            file << (first ? "" : ", ") << "\"0x" << std::hex << reg.pc << std::dec << "\"";
+            first = false;
+        }
+        file << "]" << (last ? "\n" : ",\n");
+    };
+    file << "  \"issue_slots\": {\n";
+    dump_slots("IF_ID", if_id_regs_, false);
+    dump_slots("ID_EX", id_ex_regs_, false);
+    dump_slots("EX_MEM", ex_mem_regs_, false);
+    dump_slots("MEM_WB", mem_wb_regs_, true);
+    file << "  },\n";
+
+    // slot 0 in the layout of the scalar pipelines
+    DumpPipelineRegisters(file, if_id_regs_[0], id_ex_regs_[0], ex_mem_regs_[0], mem_wb_regs_[0]);
+
+    file << "}\n";
+    file.close();
+}
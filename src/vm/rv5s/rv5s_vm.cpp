@@ -24,7 +24,6 @@
 #include <atomic>
 
 using instruction_set::Instruction;
-using instruction_set::get_instr_encoding;
 using instruction_type::MemReadOp;
 using instruction_type::MemWriteOp;
 using instruction_type::WriteBackSrc;
@@ -45,6 +44,8 @@ void RV5SVM::Reset() {
     ipc_ = 0.0;
     stall_cycles_ = 0;
     branch_mispredictions_ = 0;
+    reservation_ = {};
+    control_unit_.enableAtomicDecode(true);
     registers_.Reset();
     memory_controller_.Reset();
     program_size_ = 0;          // this should also be made zero as memory controller is reset (including the text and data segment)
@@ -173,10 +174,11 @@ void RV5SVM::Fetch_Stage() {
 
     // the Memory::ReadWord function throws a std::out_of_range exception if an invalid memory address is read. Safety Check -> 
     try {
-        uint32_t instruction = memory_controller_.ReadWord(program_counter_);
+        uint8_t length = 4;
+        uint32_t instruction = FetchInstruction(program_counter_, length);
         next_if_id_reg_.instruction = instruction;
         next_if_id_reg_.pc = program_counter_;       // original pc stored 
-        UpdateProgramCounter(4);
+        UpdateProgramCounter(length);
         next_if_id_reg_.pc_inc = program_counter_; // the incremented pc to be stored in the pipeline register
         next_if_id_reg_.is_valid = true;
     } catch(const std::exception& e) {
@@ -210,16 +212,8 @@ void RV5SVM::Decode_Stage() {
     }
 
     uint8_t opcode = instruction & 0b1111111;
-    uint8_t funct3 = (instruction >> 12) & 0b111;
 
-    if (opcode == get_instr_encoding(Instruction::kecall).opcode && 
-      funct3 == get_instr_encoding(Instruction::kecall).funct3) {
-        control.is_syscall = true;
-        next_id_ex_reg_.control = control;
-        return;
-    }
-    if (opcode==0b1110011) {
-        control.is_csr = true;
+    if (control.is_syscall || control.is_csr) {
         next_id_ex_reg_.control = control;
         return;
     }
@@ -238,7 +232,8 @@ void RV5SVM::Decode_Stage() {
     }
 
     // Handling rs2 for alu
-    if (opcode == 0b0110011 || opcode == 0b0100011 || opcode == 0b1100011) { // R-type, S-type, B-type
+    if (opcode == 0b0110011 || opcode == 0b0111011 || opcode == 0b0100011 || opcode == 0b1100011
+        || opcode == 0b0101111) { // R-type, R-type word, S-type, B-type, AMO
         next_id_ex_reg_.rs2_index = (instruction >> 20) & 0b11111;
         next_id_ex_reg_.rs2_data = registers_.ReadGpr(next_id_ex_reg_.rs2_index);
     } else {
@@ -329,7 +324,11 @@ void RV5SVM::Memory_Stage() {
     int64_t memory_result = 0;
 
     // Load Instructions
-    if (control.mem_read) {
+    if (control.is_atomic) {    // lr / sc / amo*, rs2 was carried in store_data
+        memory_result = static_cast<int64_t>(atomic_unit::execute(control.atomic_op, atomicSize(control.mem_read_op),
+                                                                  alu_result, store_data, memory_controller_, reservation_));
+    }
+    else if (control.mem_read) {
     switch (control.mem_read_op) {
       case MemReadOp::MEM_READ_BYTE: {// LB
         memory_result = static_cast<int8_t>(memory_controller_.ReadByte(alu_result));
@@ -0,0 +1,796 @@
+/**
+ * @file rvooo_vm.cpp
+ * @brief Implementation of the parameterised out-of-order RISC-V VM
+ * Stages per cycle (evaluated back to front): Commit -> WriteBack -> Issue -> Rename -> Fetch.
+ * Fetch predicts branches with the configured IBranchPredictor, rename maps the architectural registers onto a physical
+ * register file and allocates ROB / issue queue / LSQ entries, issue selects the oldest ready instructions per functional unit port,
+ * and commit retires in program order into registers_ and memory. A mispredicted branch squashes everything younger than itself by
+ * walking the ROB back and restoring the previous mappings, so the committed state is always precise.
+ */
+
+#include "vm/rvooo/rvooo_vm.h"
+#include "vm/rv5s/branch_prediction/branch_trace.h"
+#include "vm/state_file.h"
+
+#include "utils.h"
+#include "globals.h"
+#include "config.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <tuple>
+
+using instruction_type::MemReadOp;
+using instruction_type::MemWriteOp;
+using instruction_type::WriteBackSrc;
+using instruction_type::AluSrcA;
+using instruction_type::BranchOp;
+using vm_config::BranchPredictorType;
+
+RVOOOVM::RVOOOVM(bool silent) : VmBase(silent) {
+    Reset();
+}
+
+RVOOOVM::~RVOOOVM() = default;
+
+void RVOOOVM::setBranchPredictorType(BranchPredictorType type) {
+    if (type == BranchPredictorType::TOURNAMENT) {          // not implemented yet, same fallback as the pipelines
+        type = BranchPredictorType::STATIC_NOT_TAKEN;
+    }
+    branch_predictor_ = makeBranchPredictor(type);
+}
+
+void RVOOOVM::Reset() {
+    program_counter_ = 0;
+    instructions_retired_ = 0;
+    cycle_s_ = 0;
+    cpi_ = 0.0;
+    ipc_ = 0.0;
+    stall_cycles_ = 0;
+    branch_mispredictions_ = 0;
+    branch_profile_.Clear();
+
+    width_ = vm_config::config.getIssueWidth();
+    rob_size_ = vm_config::config.getRobSize();
+    iq_size_ = vm_config::config.getIssueQueueSize();
+    lsq_size_ = vm_config::config.getLsqSize();
+    num_phys_regs_ = vm_config::config.getPhysicalRegisters();
+    split_iq_ = vm_config::config.getSplitIssueQueues();
+    alu_ports_ = vm_config::config.getAluPorts();
+    mem_ports_ = vm_config::config.getMemPorts();
+    branch_ports_ = vm_config::config.getBranchPorts();
+    setBranchPredictorType(vm_config::config.getBranchPredictorType());
+
+    // identity mapping, the remaining physical registers are free
+    prf_.assign(num_phys_regs_, 0);
+    prf_ready_.assign(num_phys_regs_, true);
+    free_list_.clear();
+    for (std::size_t i = 0; i < kNumArchRegs; ++i) {
+        rat_[i] = static_cast<uint16_t>(i);
+    }
+    for (std::size_t i = kNumArchRegs; i < num_phys_regs_; ++i) {
+        free_list_.push_back(static_cast<uint16_t>(i));
+    }
+
+    fetch_queue_.clear();
+    rob_.clear();
+    issue_queues_.assign(split_iq_ ? 3 : 1, {});
+    lsq_.clear();
+    in_flight_.clear();
+    next_seq_ = 0;
+
+    rob_occupancy_sum_ = iq_occupancy_sum_ = lsq_occupancy_sum_ = 0;
+    rob_peak_ = iq_peak_ = lsq_peak_ = 0;
+    rename_stall_rob_full_ = rename_stall_iq_full_ = rename_stall_lsq_full_ = 0;
+    rename_stall_no_free_regs_ = rename_stall_frontend_empty_ = 0;
+    load_disambiguation_stalls_ = 0;
+    squashed_instructions_ = 0;
+
+    registers_.Reset();
+    memory_controller_.Reset();
+    program_size_ = 0;
+
+    if(!silent_mode_) {
+        DumpRegisters(globals::registers_dump_file_path, registers_);
+        DumpState(globals::vm_state_dump_file_path);
+    }
+}
+
+void RVOOOVM::Step() {
+    if(output_status_ == "VM_PROGRAM_END") {
+        std::cout << "VM_PROGRAM_END" << std::endl;
+        return;
+    }
+
+    if (rob_.empty()) {             // nothing in flight -> pick up registers modified from outside (program load, modify_register)
+        syncArchitecturalState();
+    }
+
+    Commit_Stage();
+    WriteBack_Stage();
+    Issue_Stage();
+    Rename_Stage();
+    Fetch_Stage();
+
+    cycle_s_++;
+    std::size_t iq_occupancy = issueQueueOccupancy();
+    rob_occupancy_sum_ += rob_.size();
+    iq_occupancy_sum_ += iq_occupancy;
+    lsq_occupancy_sum_ += lsq_.size();
+    rob_peak_ = std::max(rob_peak_, rob_.size());
+    iq_peak_ = std::max(iq_peak_, iq_occupancy);
+    lsq_peak_ = std::max(lsq_peak_, lsq_.size());
+
+    if(instructions_retired_ > 0) {
+        cpi_ = static_cast<double>(cycle_s_) / instructions_retired_;
+        ipc_ = static_cast<double>(instructions_retired_) / cycle_s_;
+    }
+    else {
+        cpi_ = 0.0;
+        ipc_ = 0.0;
+    }
+
+    if(!silent_mode_) {
+        DumpRegisters(globals::registers_dump_file_path, registers_);
+        DumpState(globals::vm_state_dump_file_path);
+    }
+
+    if(program_counter_ >= program_size_ && fetch_queue_.empty() && rob_.empty()) {
+        RequestStop();
+        std::cout << "VM_PROGRAM_END" << std::endl;
+        output_status_ = "VM_PROGRAM_END";
+
+        if(!silent_mode_) {
+            DumpState(globals::vm_state_dump_file_path);
+        }
+    } else {
+        std::cout << "VM_STEP_COMPLETED" << std::endl;
+        output_status_ = "VM_STEP_COMPLETED";
+    }
+}
+
+void RVOOOVM::Run() {
+    ClearStop();
+
+    output_status_ = "VM_RUNNING";
+    while (true) {
+        if(stop_requested_) {
+            stop_requested_ = false;
+            break;
+        }
+        Step();
+        std::cout << "Program Counter: " << program_counter_ << std::endl;
+    }
+}
+
+void RVOOOVM::DebugRun() {
+    ClearStop();
+    output_status_ = "VM_RUNNING";
+    while (true) {
+        if(stop_requested_) {
+            stop_requested_ = false;
+            break;
+        }
+        if(CheckBreakpoint(program_counter_)) {
+            std::cout << "VM_BREAKPOINT_HIT " << program_counter_ << std::endl;
+            output_status_ = "VM_BREAKPOINT_HIT";
+            if(!silent_mode_) {
+                DumpState(globals::vm_state_dump_file_path);
+            }
+            break;
+        }
+        Step();
+        std::cout << "Program Counter: " << program_counter_ << std::endl;
+        unsigned int delay_ms = vm_config::config.getRunStepDelay();
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+    }
+}
+
+// the rob, queues and renaming are not saved, a loaded state refetches from the oldest instruction not committed
+uint64_t RVOOOVM::ResumePc() const {
+    if (!rob_.empty()) {
+        return rob_.front().pc;
+    }
+    if (!fetch_queue_.empty()) {
+        return fetch_queue_.front().pc;
+    }
+    return program_counter_;
+}
+
+void RVOOOVM::SaveMicroarchState(StateWriter &writer) {
+    branch_predictor_->saveState(writer);
+}
+
+bool RVOOOVM::LoadMicroarchSection(StateReader &reader, uint32_t tag) {
+    if (tag != state_file::kTagPredictor) {
+        return false;
+    }
+    branch_predictor_->loadState(reader);
+    return true;
+}
+
+void RVOOOVM::Undo() {
+    std::cerr << "Undo/Redo Feature is not available in out-of-order mode." << std::endl;
+}
+
+void RVOOOVM::Redo() {
+    std::cerr << "Undo/Redo Feature is not available in out-of-order mode." << std::endl;
+}
+
+void RVOOOVM::syncArchitecturalState() {
+    for (std::size_t i = 1; i < kNumArchRegs; ++i) {
+        prf_[rat_[i]] = registers_.ReadGpr(i);
+        prf_ready_[rat_[i]] = true;
+    }
+}
+
+RobEntry& RVOOOVM::robEntry(uint64_t seq) {
+    return rob_[seq - rob_.front().seq];        // the ROB holds consecutive sequence numbers
+}
+
+LsqEntry* RVOOOVM::lsqEntry(uint64_t seq) {
+    for (LsqEntry &entry : lsq_) {
+        if (entry.seq == seq) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::size_t RVOOOVM::issueQueueIndex(FuClass fu_class) const {
+    if (!split_iq_) {
+        return 0;
+    }
+    switch (fu_class) {
+        case FuClass::MEM: return 1;
+        case FuClass::BRANCH: return 2;
+        case FuClass::ALU: case FuClass::FP: default: return 0;
+    }
+}
+
+std::size_t RVOOOVM::issueQueueOccupancy() const {
+    std::size_t occupancy = 0;
+    for (const auto &queue : issue_queues_) {
+        occupancy += queue.size();
+    }
+    return occupancy;
+}
+
+bool RVOOOVM::readsRs1(uint32_t instruction) {
+    switch (instruction & 0b1111111) {
+        case 0b0110111: case 0b0010111: case 0b1101111: case 0b1110011:     // lui, auipc, jal, system
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool RVOOOVM::readsRs2(uint32_t instruction) {
+    switch (instruction & 0b1111111) {
+        case 0b0110011: case 0b0111011: case 0b0100011: case 0b1100011:     // R-type, R-type word, S-type, B-type
+            return true;
+        default:
+            return false;
+    }
+}
+
+unsigned int RVOOOVM::accessSize(const ControlSignals &control) {
+    if (control.mem_read) {
+        switch (control.mem_read_op) {
+            case MemReadOp::MEM_READ_BYTE: case MemReadOp::MEM_READ_BYTE_UNSIGNED: return 1;
+            case MemReadOp::MEM_READ_HALF: case MemReadOp::MEM_READ_HALF_UNSIGNED: return 2;
+            case MemReadOp::MEM_READ_WORD: case MemReadOp::MEM_READ_WORD_UNSIGNED: return 4;
+            case MemReadOp::MEM_READ_DOUBLE: return 8;
+            default: return 0;
+        }
+    }
+    switch (control.mem_write_op) {
+        case MemWriteOp::MEM_WRITE_BYTE: return 1;
+        case MemWriteOp::MEM_WRITE_HALF: return 2;
+        case MemWriteOp::MEM_WRITE_WORD: return 4;
+        case MemWriteOp::MEM_WRITE_DOUBLE: return 8;
+        default: return 0;
+    }
+}
+
+void RVOOOVM::Fetch_Stage() {
+    std::size_t capacity = 2 * width_;
+    for (std::size_t n = 0; n < width_ && fetch_queue_.size() < capacity && program_counter_ < program_size_; ++n) {
+        FetchedInstruction fetched;
+        fetched.pc = program_counter_;
+        fetched.fetch_cycle = cycle_s_;
+        try {
+            uint8_t length = 4;
+            fetched.instruction = FetchInstruction(program_counter_, length);
+            fetched.pc_inc = fetched.pc + length;
+        } catch(const std::exception& e) {
+            std::cerr << "Fetch Stage Error: " << e.what() << std::endl;
+            return;
+        }
+
+        // the target of direct jumps and branches is computed from the instruction bits, jalr is predicted to fall through
+        uint32_t opcode = fetched.instruction & 0b1111111;
+        if (opcode == 0b1101111) {
+            fetched.predicted_taken = true;
+        } else if (opcode == 0b1100011) {
+            fetched.predicted_taken = branch_predictor_->getPrediction(fetched.pc);
+        }
+        fetched.predicted_next_pc = fetched.predicted_taken ? fetched.pc + ImmGenerator(fetched.instruction) : fetched.pc_inc;
+
+        fetch_queue_.push_back(fetched);
+        program_counter_ = fetched.predicted_next_pc;
+        if (fetched.predicted_taken) {          // a fetch group ends at a taken branch
+            break;
+        }
+    }
+}
+
+void RVOOOVM::Rename_Stage() {
+    for (std::size_t n = 0; n < width_; ++n) {
+        if (fetch_queue_.empty()) {
+            if (n == 0) {
+                rename_stall_frontend_empty_++;
+            }
+            return;
+        }
+
+        const FetchedInstruction &fetched = fetch_queue_.front();
+        ControlSignals control = control_unit_.getControlSignals(fetched.instruction);
+        uint32_t opcode = fetched.instruction & 0b1111111;
+        // system instructions and nops only pass through the ROB, as in the pipelined vms
+        bool needs_execution = !control.is_nop && opcode != 0b1110011;
+        bool is_mem = needs_execution && (control.mem_read || control.mem_write);
+        FuClass fu_class = getFuClass(fetched.instruction);
+        uint8_t rd_index = (fetched.instruction >> 7) & 0b11111;
+        bool has_dest = needs_execution && control.reg_write && rd_index != 0;
+
+        if (rob_.size() >= rob_size_) {
+            rename_stall_rob_full_++;
+            stall_cycles_++;
+            return;
+        }
+        if (needs_execution && issue_queues_[issueQueueIndex(fu_class)].size() >= iq_size_) {
+            rename_stall_iq_full_++;
+            stall_cycles_++;
+            return;
+        }
+        if (is_mem && lsq_.size() >= lsq_size_) {
+            rename_stall_lsq_full_++;
+            stall_cycles_++;
+            return;
+        }
+        if (has_dest && free_list_.empty()) {
+            rename_stall_no_free_regs_++;
+            stall_cycles_++;
+            return;
+        }
+
+        RobEntry entry;
+        entry.seq = next_seq_++;
+        entry.pc = fetched.pc;
+        entry.pc_inc = fetched.pc_inc;
+        entry.instruction = fetched.instruction;
+        entry.control = control;
+        entry.immediate = ImmGenerator(fetched.instruction);
+        entry.rd_index = rd_index;
+        entry.has_dest = has_dest;
+        entry.predicted_taken = fetched.predicted_taken;
+        entry.predicted_next_pc = fetched.predicted_next_pc;
+        entry.fetch_cycle = fetched.fetch_cycle;
+
+        // sources are looked up before rd is renamed, so that "addi x5, x5, 1" reads the old x5
+        IssueQueueEntry iq_entry;
+        iq_entry.seq = entry.seq;
+        iq_entry.fu_class = fu_class;
+        iq_entry.phys_rs1 = readsRs1(fetched.instruction) ? rat_[(fetched.instruction >> 15) & 0b11111] : 0;
+        iq_entry.phys_rs2 = readsRs2(fetched.instruction) ? rat_[(fetched.instruction >> 20) & 0b11111] : 0;
+
+        if (has_dest) {
+            entry.old_phys_rd = rat_[rd_index];
+            entry.phys_rd = free_list_.front();
+            free_list_.pop_front();
+            prf_ready_[entry.phys_rd] = false;
+            rat_[rd_index] = entry.phys_rd;
+        }
+
+        if (is_mem) {
+            LsqEntry lsq_entry;
+            lsq_entry.seq = entry.seq;
+            lsq_entry.is_store = control.mem_write;
+            lsq_entry.size = accessSize(control);
+            lsq_.push_back(lsq_entry);
+        }
+
+        if (needs_execution) {
+            issue_queues_[issueQueueIndex(fu_class)].push_back(iq_entry);
+        } else {
+            entry.done = true;
+        }
+
+        rob_.push_back(entry);
+        fetch_queue_.pop_front();
+    }
+}
+
+uint64_t RVOOOVM::computeAluResult(const RobEntry &entry, uint64_t rs1_value, uint64_t rs2_value) {
+    const ControlSignals &control = entry.control;
+    uint64_t reg1_value, reg2_value;
+    switch (control.alu_src_a) {
+        case AluSrcA::ALU_SRC_A_PC:         // for auipc, jal
+            reg1_value = entry.pc;
+            break;
+        case AluSrcA::ALU_SRC_A_ZERO:       // for lui
+            reg1_value = 0;
+            break;
+        case AluSrcA::ALU_SRC_A_RS1:
+        default:
+            reg1_value = rs1_value;
+            break;
+    }
+
+    if(control.alu_src_a == AluSrcA::ALU_SRC_A_ZERO || control.alu_src_a == AluSrcA::ALU_SRC_A_PC) {   // lui, auipc
+        if(control.branch_op != BranchOp::JAL) {
+            reg2_value = static_cast<uint64_t>(static_cast<int64_t>(entry.immediate)) << 12;
+            if(reg2_value & 0x80000000) {   // sign extend the 32 bit result
+                reg2_value |= 0xFFFFFFFF00000000;
+            }
+        } else {                            // jal
+            reg2_value = static_cast<uint64_t>(static_cast<int64_t>(entry.immediate));
+        }
+    }
+    else if(control.alu_src_b) {            // normal I type
+        reg2_value = static_cast<uint64_t>(static_cast<int64_t>(entry.immediate));
+    }
+    else {                                  // R type
+        reg2_value = rs2_value;
+    }
+
+    bool overflow = false;
+    int64_t execution_result;
+    std::tie(execution_result, overflow) = alu_.execute(control.alu_op, reg1_value, reg2_value);
+    return static_cast<uint64_t>(execution_result);
+}
+
+bool RVOOOVM::tryLoad(const RobEntry &entry, uint64_t address, uint64_t &value, bool &must_wait) {
+    unsigned int size = accessSize(entry.control);
+    must_wait = false;
+
+    // memory disambiguation: the youngest older store to an overlapping address supplies the data,
+    // a load never passes an older store whose address is still unknown
+    bool forwarded = false;
+    uint64_t raw = 0;
+    for (auto it = lsq_.rbegin(); it != lsq_.rend(); ++it) {
+        if (it->seq >= entry.seq || !it->is_store) {
+            continue;
+        }
+        if (!it->address_known) {
+            must_wait = true;
+            return false;
+        }
+        bool overlaps = it->address < address + size && address < it->address + it->size;
+        if (!overlaps) {
+            continue;
+        }
+        bool covers = it->address <= address && address + size <= it->address + it->size;
+        if (!covers) {              // partial overlap -> wait until the store has written memory
+            must_wait = true;
+            return false;
+        }
+        raw = it->store_data >> (8 * (address - it->address));
+        forwarded = true;
+        break;
+    }
+
+    if (!forwarded) {
+        try {
+            switch (size) {
+                case 1: raw = memory_controller_.ReadByte(address); break;
+                case 2: raw = memory_controller_.ReadHalfWord(address); break;
+                case 4: raw = memory_controller_.ReadWord(address); break;
+                case 8: raw = memory_controller_.ReadDoubleWord(address); break;
+                default: break;
+            }
+        } catch (const std::exception &e) {     // possibly a wrong path load, the value is never committed then
+            raw = 0;
+        }
+    }
+
+    switch (entry.control.mem_read_op) {
+        case MemReadOp::MEM_READ_BYTE: value = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(raw))); break;
+        case MemReadOp::MEM_READ_HALF: value = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int16_t>(raw))); break;
+        case MemReadOp::MEM_READ_WORD: value = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(raw))); break;
+        case MemReadOp::MEM_READ_DOUBLE: value = raw; break;
+        case MemReadOp::MEM_READ_BYTE_UNSIGNED: value = static_cast<uint8_t>(raw); break;
+        case MemReadOp::MEM_READ_HALF_UNSIGNED: value = static_cast<uint16_t>(raw); break;
+        case MemReadOp::MEM_READ_WORD_UNSIGNED: value = static_cast<uint32_t>(raw); break;
+        case MemReadOp::MEM_READ_NONE:
+        default:
+            value = 0;
+            break;
+    }
+    return true;
+}
+
+void RVOOOVM::Issue_Stage() {
+    // ready instructions of all queues, oldest first
+    struct Candidate {
+        uint64_t seq;
+        std::size_t queue;
+        std::size_t index;
+    };
+    std::vector<Candidate> candidates;
+    for (std::size_t q = 0; q < issue_queues_.size(); ++q) {
+        for (std::size_t i = 0; i < issue_queues_[q].size(); ++i) {
+            const IssueQueueEntry &iq_entry = issue_queues_[q][i];
+            if (prf_ready_[iq_entry.phys_rs1] && prf_ready_[iq_entry.phys_rs2]) {
+                candidates.push_back({iq_entry.seq, q, i});
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) { return a.seq < b.seq; });
+
+    std::size_t alu_used = 0, mem_used = 0, branch_used = 0, issued = 0;
+    bool load_waited = false;
+    std::vector<std::vector<bool>> issued_flags(issue_queues_.size());
+    for (std::size_t q = 0; q < issue_queues_.size(); ++q) {
+        issued_flags[q].assign(issue_queues_[q].size(), false);
+    }
+
+    for (const Candidate &candidate : candidates) {
+        if (issued >= width_) {
+            break;
+        }
+        const IssueQueueEntry &iq_entry = issue_queues_[candidate.queue][candidate.index];
+        std::size_t *used = &alu_used;
+        std::size_t ports = alu_ports_;
+        if (iq_entry.fu_class == FuClass::MEM) {
+            used = &mem_used;
+            ports = mem_ports_;
+        } else if (iq_entry.fu_class == FuClass::BRANCH) {
+            used = &branch_used;
+            ports = branch_ports_;
+        }
+        if (*used >= ports) {
+            continue;
+        }
+
+        RobEntry &entry = robEntry(iq_entry.seq);
+        uint64_t rs1_value = prf_[iq_entry.phys_rs1];
+        uint64_t rs2_value = prf_[iq_entry.phys_rs2];
+        const ControlSignals &control = entry.control;
+
+        InFlightOp op;
+        op.seq = entry.seq;
+        if (control.mem_read) {
+            uint64_t address = rs1_value + static_cast<uint64_t>(static_cast<int64_t>(entry.immediate));
+            bool must_wait = false;
+            if (!tryLoad(entry, address, op.result, must_wait)) {
+                load_waited = true;
+                continue;
+            }
+            LsqEntry *lsq_entry = lsqEntry(entry.seq);
+            lsq_entry->address = address;
+            lsq_entry->address_known = true;
+            op.remaining_cycles = kLoadLatency;
+        }
+        else if (control.mem_write) {
+            LsqEntry *lsq_entry = lsqEntry(entry.seq);
+            lsq_entry->address = rs1_value + static_cast<uint64_t>(static_cast<int64_t>(entry.immediate));
+            lsq_entry->store_data = rs2_value;
+            lsq_entry->address_known = true;
+            op.remaining_cycles = kStoreLatency;
+        }
+        else {
+            uint64_t result = computeAluResult(entry, rs1_value, rs2_value);
+            op.result = result;
+            op.actual_next_pc = entry.pc_inc;
+            if (control.branch_op == BranchOp::JAL || control.branch_op == BranchOp::JALR) {
+                op.actual_taken = true;
+                op.actual_next_pc = result;
+                op.result = entry.pc_inc;
+            }
+            else if (control.branch) {
+                int64_t execution_result = static_cast<int64_t>(result);
+                switch (control.branch_op) {
+                    case BranchOp::BEQ:  op.actual_taken = (execution_result == 0); break;
+                    case BranchOp::BNE:  op.actual_taken = (execution_result != 0); break;
+                    case BranchOp::BLT:  op.actual_taken = (execution_result == 1); break;
+                    case BranchOp::BGE:  op.actual_taken = (execution_result == 0); break;
+                    case BranchOp::BLTU: op.actual_taken = (execution_result == 1); break;
+                    case BranchOp::BGEU: op.actual_taken = (execution_result == 0); break;
+                    default: break;
+                }
+                if (op.actual_taken) {
+                    op.actual_next_pc = entry.pc + entry.immediate;
+                }
+            }
+            op.remaining_cycles = kAluLatency;
+        }
+
+        in_flight_.push_back(op);
+        issued_flags[candidate.queue][candidate.index] = true;
+        (*used)++;
+        issued++;
+    }
+
+    if (load_waited) {
+        load_disambiguation_stalls_++;
+    }
+
+    for (std::size_t q = 0; q < issue_queues_.size(); ++q) {
+        std::vector<IssueQueueEntry> remaining;
+        remaining.reserve(issue_queues_[q].size());
+        for (std::size_t i = 0; i < issue_queues_[q].size(); ++i) {
+            if (!issued_flags[q][i]) {
+                remaining.push_back(issue_queues_[q][i]);
+            }
+        }
+        issue_queues_[q] = std::move(remaining);
+    }
+}
+
+void RVOOOVM::WriteBack_Stage() {
+    std::vector<InFlightOp> completed;
+    std::vector<InFlightOp> still_running;
+    for (InFlightOp &op : in_flight_) {
+        if (--op.remaining_cycles == 0) {
+            completed.push_back(op);
+        } else {
+            still_running.push_back(op);
+        }
+    }
+    in_flight_ = std::move(still_running);
+    std::sort(completed.begin(), completed.end(), [](const InFlightOp &a, const InFlightOp &b) { return a.seq < b.seq; });
+
+    for (const InFlightOp &op : completed) {
+        if (rob_.empty() || op.seq > rob_.back().seq) {     // squashed by an older branch completing in this cycle
+            continue;
+        }
+        RobEntry &entry = robEntry(op.seq);
+        entry.done = true;
+        if (entry.has_dest) {
+            prf_[entry.phys_rd] = op.result;
+            prf_ready_[entry.phys_rd] = true;
+        }
+
+        const ControlSignals &control = entry.control;
+        bool is_jump = control.branch_op == BranchOp::JAL || control.branch_op == BranchOp::JALR;
+        if (!control.branch && !is_jump) {
+            continue;
+        }
+
+        bool mispredicted = op.actual_next_pc != entry.predicted_next_pc;
+        if (!is_jump) {
+            branch_predictor_->updateState(entry.pc, entry.predicted_taken, op.actual_taken);
+            // a misprediction costs the cycles from fetching the branch to resolving it
+            branch_profile_.Record(entry.pc, op.actual_taken, mispredicted, static_cast<unsigned int>(cycle_s_ - entry.fetch_cycle));
+            if (mispredicted) {
+                branch_mispredictions_++;
+            }
+        }
+        if (mispredicted) {
+            recoverFrom(entry.seq, op.actual_next_pc);
+        }
+    }
+}
+
+void RVOOOVM::recoverFrom(uint64_t branch_seq, uint64_t correct_pc) {
+    // walk the ROB back from the youngest instruction, undoing its rename
+    while (!rob_.empty() && rob_.back().seq > branch_seq) {
+        const RobEntry &entry = rob_.back();
+        if (entry.has_dest) {
+            rat_[entry.rd_index] = entry.old_phys_rd;
+            free_list_.push_front(entry.phys_rd);
+        }
+        rob_.pop_back();
+        squashed_instructions_++;
+    }
+    next_seq_ = branch_seq + 1;
+
+    for (auto &queue : issue_queues_) {
+        queue.erase(std::remove_if(queue.begin(), queue.end(), [&](const IssueQueueEntry &e) { return e.seq > branch_seq; }), queue.end());
+    }
+    while (!lsq_.empty() && lsq_.back().seq > branch_seq) {
+        lsq_.pop_back();
+    }
+    in_flight_.erase(std::remove_if(in_flight_.begin(), in_flight_.end(), [&](const InFlightOp &op) { return op.seq > branch_seq; }), in_flight_.end());
+
+    squashed_instructions_ += fetch_queue_.size();
+    fetch_queue_.clear();
+    program_counter_ = correct_pc;
+}
+
+void RVOOOVM::writeMemory(const RobEntry &entry, const LsqEntry &store) {
+    switch (entry.control.mem_write_op) {
+        case MemWriteOp::MEM_WRITE_BYTE: memory_controller_.WriteByte(store.address, store.store_data & 0xFF); break;
+        case MemWriteOp::MEM_WRITE_HALF: memory_controller_.WriteHalfWord(store.address, store.store_data & 0xFFFF); break;
+        case MemWriteOp::MEM_WRITE_WORD: memory_controller_.WriteWord(store.address, store.store_data & 0xFFFFFFFF); break;
+        case MemWriteOp::MEM_WRITE_DOUBLE: memory_controller_.WriteDoubleWord(store.address, store.store_data); break;
+        case MemWriteOp::MEM_WRITE_NONE:
+        default:
+            std::cerr << "Default Condition Reached in Write Memory Switch" << std::endl;
+            break;
+    }
+}
+
+void RVOOOVM::Commit_Stage() {
+    for (std::size_t n = 0; n < width_ && !rob_.empty() && rob_.front().done; ++n) {
+        const RobEntry &entry = rob_.front();
+
+        if (!lsq_.empty() && lsq_.front().seq == entry.seq) {
+            if (lsq_.front().is_store) {        // stores update memory only once they are no longer speculative
+                writeMemory(entry, lsq_.front());
+            }
+            lsq_.pop_front();
+        }
+        if (entry.has_dest) {
+            registers_.WriteGpr(entry.rd_index, prf_[entry.phys_rd]);
+            free_list_.push_back(entry.old_phys_rd);
+        }
+
+        instructions_retired_++;
+        rob_.pop_front();
+    }
+}
+
+void RVOOOVM::DumpState(const std::filesystem::path &filename) {
+    std::ofstream file(filename);
+    if(!file.is_open()) {
+        std::cerr << "Unable to open vm_state_dump file: " << filename << std::endl;
+        return;
+    }
+
+    auto average = [&](uint64_t sum) {
+        return cycle_s_ ? static_cast<double>(sum) / cycle_s_ : 0.0;
+    };
+
+    file << "{\n";
+
+    file << "  \"vm_state\": {\n";
+    file << "    \"program_counter\": " << program_counter_ << ",\n";
+    file << "    \"output_status\": \"" << output_status_ << "\",\n";
+    file << "    \"cycles\": " << cycle_s_ << ",\n";
+    file << "    \"instructions_retired\": " << instructions_retired_ << ",\n";
+    file << "    \"cpi\": " << cpi_ << ",\n";
+    file << "    \"ipc\": " << ipc_ << ",\n";
+    file << "    \"stall_cycles\": " << stall_cycles_ << ",\n";
+    file << "    \"branch_mispredictions\": " << branch_mispredictions_ << ",\n";
+    file << "    \"squashed_instructions\": " << squashed_instructions_ << "\n";
+    file << "  },\n";
+
+    file << "  \"core\": {\n";
+    file << "    \"width\": " << width_ << ",\n";
+    file << "    \"rob_size\": " << rob_size_ << ",\n";
+    file << "    \"issue_queue_size\": " << iq_size_ << ",\n";
+    file << "    \"issue_queues\": \"" << (split_iq_ ? "split" : "unified") << "\",\n";
+    file << "    \"lsq_size\": " << lsq_size_ << ",\n";
+    file << "    \"physical_registers\": " << num_phys_regs_ << "\n";
+    file << "  },\n";
+
+    file << "  \"occupancy\": {\n";
+    file << "    \"rob\": " << rob_.size() << ",\n";
+    file << "    \"rob_average\": " << average(rob_occupancy_sum_) << ",\n";
+    file << "    \"rob_peak\": " << rob_peak_ << ",\n";
+    file << "    \"issue_queue\": " << issueQueueOccupancy() << ",\n";
+    file << "    \"issue_queue_average\": " << average(iq_occupancy_sum_) << ",\n";
+    file << "    \"issue_queue_peak\": " << iq_peak_ << ",\n";
+    file << "    \"lsq\": " << lsq_.size() << ",\n";
+    file << "    \"lsq_average\": " << average(lsq_occupancy_sum_) << ",\n";
+    file << "    \"lsq_peak\": " << lsq_peak_ << ",\n";
+    file << "    \"free_physical_registers\": " << free_list_.size() << "\n";
+    file << "  },\n";
+
+    file << "  \"stall_reasons\": {\n";
+    file << "    \"rob_full\": " << rename_stall_rob_full_ << ",\n";
+    file << "    \"issue_queue_full\": " << rename_stall_iq_full_ << ",\n";
+    file << "    \"lsq_full\": " << rename_stall_lsq_full_ << ",\n";
+    file << "    \"no_free_registers\": " << rename_stall_no_free_regs_ << ",\n";
+    file << "    \"frontend_empty\": " << rename_stall_frontend_empty_ << ",\n";
+    file << "    \"load_waiting_on_store\": " << load_disambiguation_stalls_ << "\n";
+    file << "  }\n";
+
+    file << "}\n";
+    file.close();
+}
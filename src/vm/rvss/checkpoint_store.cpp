@@ -0,0 +1,83 @@
+/**
+ * @file checkpoint_store.cpp
+ * @brief Implementation of the single stage VM checkpoints
+ */
+
+#include "vm/rvss/checkpoint_store.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+void CheckpointStore::SetInterval(uint64_t instructions) {
+  interval_ = instructions;
+  Clear();
+}
+
+void CheckpointStore::Clear() {
+  checkpoints_.clear();
+  syscalls_.clear();
+  next_ = 0;
+}
+
+void CheckpointStore::Add(Checkpoint &&checkpoint) {
+  next_ = (checkpoint.instructions_retired / interval_ + 1) * interval_;
+  checkpoints_.push_back(std::move(checkpoint));
+  if (checkpoints_.size() > kMaxCheckpoints) {
+    Thin();
+  }
+}
+
+// Drops the checkpoint whose neighbours end up closest together for its distance from the newest one, so the spacing
+// grows about exponentially going back. The first checkpoint and the newest one are kept.
+void CheckpointStore::Thin() {
+  uint64_t newest = checkpoints_.back().instructions_retired;
+  std::size_t victim = 1;
+  double best = std::numeric_limits<double>::max();
+  for (std::size_t i = 1; i + 1 < checkpoints_.size(); ++i) {
+    double gap = static_cast<double>(checkpoints_[i + 1].instructions_retired - checkpoints_[i - 1].instructions_retired);
+    double age = static_cast<double>(newest - checkpoints_[i].instructions_retired + interval_);
+    if (gap / age < best) {
+      best = gap / age;
+      victim = i;
+    }
+  }
+  checkpoints_.erase(checkpoints_.begin() + static_cast<std::ptrdiff_t>(victim));
+}
+
+const Checkpoint *CheckpointStore::Nearest(uint64_t instruction) const {
+  auto it = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), instruction,
+                             [](uint64_t value, const Checkpoint &checkpoint) {
+                               return value < checkpoint.instructions_retired;
+                             });
+  return it == checkpoints_.begin() ? nullptr : &*std::prev(it);
+}
+
+void CheckpointStore::RecordSyscall(SyscallRecord &&record) {
+  syscalls_.push_back(std::move(record));
+}
+
+const SyscallRecord *CheckpointStore::FindSyscall(uint64_t instruction) const {
+  auto it = std::lower_bound(syscalls_.begin(), syscalls_.end(), instruction,
+                             [](const SyscallRecord &record, uint64_t value) {
+                               return record.instruction < value;
+                             });
+  return (it != syscalls_.end() && it->instruction == instruction) ? &*it : nullptr;
+}
+
+void CheckpointStore::DropFrom(uint64_t instruction) {
+  auto checkpoint = std::lower_bound(checkpoints_.begin(), checkpoints_.end(), instruction,
+                                     [](const Checkpoint &checkpoint, uint64_t value) {
+                                       return checkpoint.instructions_retired < value;
+                                     });
+  checkpoints_.erase(checkpoint, checkpoints_.end());
+
+  auto syscall = std::lower_bound(syscalls_.begin(), syscalls_.end(), instruction,
+                                  [](const SyscallRecord &record, uint64_t value) {
+                                    return record.instruction < value;
+                                  });
+  syscalls_.erase(syscall, syscalls_.end());
+
+  // the next checkpoint is the first multiple of the interval not covered any more, possibly the current instruction
+  next_ = checkpoints_.empty() ? 0 : checkpoints_.back().instructions_retired + interval_;
+}
@@ -5,6 +5,7 @@
  */
 
 #include "vm/rvss/rvss_vm.h"
+#include "vm/vector_unit.h"
 
 #include "utils.h"
 #include "globals.h"
@@ -12,8 +13,11 @@
 #include "config.h"
 
 #include <cctype>
+#include <charconv>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <string_view>
 #include <tuple>
 #include <stack>  
 #include <algorithm>
@@ -33,8 +37,8 @@ RVSSVM::RVSSVM(bool silent) : VmBase(silent) {
 RVSSVM::~RVSSVM() = default;
 
 void RVSSVM::Fetch() {
-  current_instruction_ = memory_controller_.ReadWord(program_counter_);
-  UpdateProgramCounter(4);
+  current_instruction_ = FetchInstruction(program_counter_, instruction_length_);
+  UpdateProgramCounter(instruction_length_);
 }
 
 void RVSSVM::Decode() {
@@ -42,24 +46,25 @@ void RVSSVM::Decode() {
 }
 
 void RVSSVM::Execute() {
-  uint8_t opcode = current_instruction_ & 0b1111111;
-  uint8_t funct3 = (current_instruction_ >> 12) & 0b111;
+  const decoder::DecodedOp &op = control_unit_.GetDecodedOp();
 
-  if (opcode == get_instr_encoding(Instruction::kecall).opcode && 
-      funct3 == get_instr_encoding(Instruction::kecall).funct3) {
+  if (op.is_syscall) {
     HandleSyscall();
     return;
   }
 
-  if (instruction_set::isFInstruction(current_instruction_)) { // RV64 F
+  if (op.is_float) { // RV64 F
     ExecuteFloat();
     return;
-  } else if (instruction_set::isDInstruction(current_instruction_)) {
+  } else if (op.is_double) {
     ExecuteDouble();
     return;
-  } else if (opcode==0b1110011) {
+  } else if (op.is_csr) {
     ExecuteCsr();
     return;
+  } else if (op.is_vector) {
+    ExecuteVector();
+    return;
   }
 
   uint8_t rs1 = (current_instruction_ >> 15) & 0b11111;
@@ -76,52 +81,47 @@ void RVSSVM::Execute() {
     reg2_value = static_cast<uint64_t>(static_cast<int64_t>(imm));
   }
 
-  alu::AluOp aluOperation = control_unit_.GetAluSignal(current_instruction_, control_unit_.GetAluOp());
-  std::tie(execution_result_, overflow) = alu_.execute(aluOperation, reg1_value, reg2_value);
+  std::tie(execution_result_, overflow) = alu_.execute(op.alu_op, reg1_value, reg2_value);
 
+  bool conditional_branch = op.imm_format == decoder::ImmFormat::kB;
 
   if (control_unit_.GetBranch()) {
-    if (opcode==get_instr_encoding(Instruction::kjalr).opcode || 
-        opcode==get_instr_encoding(Instruction::kjal).opcode) {
+    if (op.instr == Instruction::kjalr || op.instr == Instruction::kjal) {
       next_pc_ = static_cast<int64_t>(program_counter_); // PC was already updated in Fetch()
-      UpdateProgramCounter(-4);
-      return_address_ = program_counter_ + 4;
-      if (opcode==get_instr_encoding(Instruction::kjalr).opcode) { 
+      UpdateProgramCounter(-instruction_length_);
+      return_address_ = program_counter_ + instruction_length_;
+      if (op.instr == Instruction::kjalr) { 
         UpdateProgramCounter(-program_counter_ + (execution_result_));
-      } else if (opcode==get_instr_encoding(Instruction::kjal).opcode) {
+      } else {
         UpdateProgramCounter(imm);
       }
-    } else if (opcode==get_instr_encoding(Instruction::kbeq).opcode ||
-               opcode==get_instr_encoding(Instruction::kbne).opcode ||
-               opcode==get_instr_encoding(Instruction::kblt).opcode ||
-               opcode==get_instr_encoding(Instruction::kbge).opcode ||
-               opcode==get_instr_encoding(Instruction::kbltu).opcode ||
-               opcode==get_instr_encoding(Instruction::kbgeu).opcode) {
-      switch (funct3) {
-        case 0b000: {// BEQ
+    } else if (conditional_branch) {
+      switch (op.instr) {
+        case Instruction::kbeq: {
           branch_flag_ = (execution_result_==0);
           break;
         }
-        case 0b001: {// BNE
+        case Instruction::kbne: {
           branch_flag_ = (execution_result_!=0);
           break;
         }
-        case 0b100: {// BLT
+        case Instruction::kblt: {
           branch_flag_ = (execution_result_==1);
           break;
         }
-        case 0b101: {// BGE
+        case Instruction::kbge: {
           branch_flag_ = (execution_result_==0);
           break;
         }
-        case 0b110: {// BLTU
+        case Instruction::kbltu: {
           branch_flag_ = (execution_result_==1);
           break;
         }
-        case 0b111: {// BGEU
+        case Instruction::kbgeu: {
           branch_flag_ = (execution_result_==0);
           break;
         }
+        default: break;
       }
 
     }
@@ -131,22 +131,28 @@ void RVSSVM::Execute() {
   }
 
   
-  if (branch_flag_ && opcode==0b1100011) {
-    UpdateProgramCounter(-4);
+  if (branch_trace_ && conditional_branch) { // branch and jump outcomes for offline predictor replay
+    uint64_t branch_pc = program_counter_ - instruction_length_;
+    branch_trace_->record(branch_pc, branch_pc + static_cast<int64_t>(imm), branch_flag_);
+  } else if (branch_trace_ && (op.instr == Instruction::kjal || op.instr == Instruction::kjalr)) {
+    branch_trace_->record(next_pc_ - instruction_length_, program_counter_, true, jumpType(current_instruction_));
+  }
+
+  if (branch_flag_ && conditional_branch) {
+    UpdateProgramCounter(-instruction_length_);
     UpdateProgramCounter(imm);
   }
 
 
-  if (opcode==get_instr_encoding(Instruction::kauipc).opcode) { // AUIPC
-    execution_result_ = static_cast<int64_t>(program_counter_) - 4 + (imm << 12);
+  if (op.instr == Instruction::kauipc) { // AUIPC
+    execution_result_ = static_cast<int64_t>(program_counter_) - instruction_length_ + (imm << 12);
 
   }
 }
 
 void RVSSVM::ExecuteFloat() {
-  uint8_t opcode = current_instruction_ & 0b1111111;
+  const decoder::DecodedOp &op = control_unit_.GetDecodedOp();
   uint8_t funct3 = (current_instruction_ >> 12) & 0b111;
-  uint8_t funct7 = (current_instruction_ >> 25) & 0b1111111;
   uint8_t rm = funct3;
   uint8_t rs1 = (current_instruction_ >> 15) & 0b11111;
   uint8_t rs2 = (current_instruction_ >> 20) & 0b11111;
@@ -164,7 +170,7 @@ void RVSSVM::ExecuteFloat() {
   uint64_t reg2_value = registers_.ReadFpr(rs2);
   uint64_t reg3_value = registers_.ReadFpr(rs3);
 
-  if (funct7==0b1101000 || funct7==0b1111000 || opcode==0b0000111 || opcode==0b0100111) {
+  if (!op.rs1_fp) { // fcvt.s.(w|wu|l|lu), fmv.w.x, flw, fsw
     reg1_value = registers_.ReadGpr(rs1);
   }
 
@@ -172,19 +178,16 @@ void RVSSVM::ExecuteFloat() {
     reg2_value = static_cast<uint64_t>(static_cast<int64_t>(imm));
   }
 
-  alu::AluOp aluOperation = control_unit_.GetAluSignal(current_instruction_, control_unit_.GetAluOp());
-  std::tie(execution_result_, fcsr_status) = alu::Alu::fpexecute(aluOperation, reg1_value, reg2_value, reg3_value, rm);
+  std::tie(execution_result_, fcsr_status) = alu_.fpexecute(op.alu_op, reg1_value, reg2_value, reg3_value, rm);
 
   // std::cout << "+++++ Float execution result: " << execution_result_ << std::endl;
 
-
-  registers_.WriteCsr(0x003, fcsr_status);
+  AccrueFflags(fcsr_status);
 }
 
 void RVSSVM::ExecuteDouble() {
-  uint8_t opcode = current_instruction_ & 0b1111111;
+  const decoder::DecodedOp &op = control_unit_.GetDecodedOp();
   uint8_t funct3 = (current_instruction_ >> 12) & 0b111;
-  uint8_t funct7 = (current_instruction_ >> 25) & 0b1111111;
   uint8_t rm = funct3;
   uint8_t rs1 = (current_instruction_ >> 15) & 0b11111;
   uint8_t rs2 = (current_instruction_ >> 20) & 0b11111;
@@ -194,11 +197,15 @@ void RVSSVM::ExecuteDouble() {
 
   int32_t imm = ImmGenerator(current_instruction_);
 
+  if (rm==0b111) {
+    rm = registers_.ReadCsr(0x002);
+  }
+
   uint64_t reg1_value = registers_.ReadFpr(rs1);
   uint64_t reg2_value = registers_.ReadFpr(rs2);
   uint64_t reg3_value = registers_.ReadFpr(rs3);
 
-  if (funct7==0b1101001 || funct7==0b1111001 || opcode==0b0000111 || opcode==0b0100111) {
+  if (!op.rs1_fp) { // fcvt.d.(w|wu|l|lu), fmv.d.x, fld, fsd
     reg1_value = registers_.ReadGpr(rs1);
   }
 
@@ -206,8 +213,17 @@ void RVSSVM::ExecuteDouble() {
     reg2_value = static_cast<uint64_t>(static_cast<int64_t>(imm));
   }
 
-  alu::AluOp aluOperation = control_unit_.GetAluSignal(current_instruction_, control_unit_.GetAluOp());
-  std::tie(execution_result_, fcsr_status) = alu::Alu::dfpexecute(aluOperation, reg1_value, reg2_value, reg3_value, rm);
+  std::tie(execution_result_, fcsr_status) = alu_.dfpexecute(op.alu_op, reg1_value, reg2_value, reg3_value, rm);
+  AccrueFflags(fcsr_status);
+}
+
+void RVSSVM::AccrueFflags(uint8_t flags) {
+  // fflags only ever gain bits, so an op that raises nothing new leaves fcsr and the undo history alone
+  uint64_t old_fcsr = registers_.ReadCsr(0x003);
+  if (flags & ~old_fcsr) {
+    registers_.WriteCsr(0x003, old_fcsr | flags);
+    history_.RecordRegister(0x003, 1, old_fcsr, old_fcsr | flags); // 0 for GPR, 1 for CSR, 2 for FPR
+  }
 }
 
 void RVSSVM::ExecuteCsr() {
@@ -221,197 +237,160 @@ void RVSSVM::ExecuteCsr() {
   csr_uimm_ = rs1;
 }
 
-// TODO: implement writeback for syscalls
-void RVSSVM::HandleSyscall() {
-  uint64_t syscall_number = registers_.ReadGpr(17);
-  switch (syscall_number) {
-    case SYSCALL_PRINT_INT: {
-        if (!globals::vm_as_backend) {
-            std::cout << "[Syscall output: ";
-        } else {
-          std::cout << "VM_STDOUT_START";
-        }
-        std::cout << static_cast<int64_t>(registers_.ReadGpr(10)); // Print signed integer
-        if (!globals::vm_as_backend) {
-            std::cout << "]" << std::endl;
-        } else {
-          std::cout << "VM_STDOUT_END" << std::endl;
-        }
-        break;
-    }
-    case SYSCALL_PRINT_FLOAT: { // print float
-        if (!globals::vm_as_backend) {
-            std::cout << "[Syscall output: ";
-        } else {
-          std::cout << "VM_STDOUT_START";
-        }
-        float float_value;
-        uint64_t raw = registers_.ReadGpr(10);
-        std::memcpy(&float_value, &raw, sizeof(float_value));
-        std::cout << std::setprecision(std::numeric_limits<float>::max_digits10) << float_value;
-        if (!globals::vm_as_backend) {
-            std::cout << "]" << std::endl;
-        } else {
-          std::cout << "VM_STDOUT_END" << std::endl;
-        }
-        break;
-    }
-    case SYSCALL_PRINT_DOUBLE: { // print double
-        if (!globals::vm_as_backend) {
-            std::cout << "[Syscall output: ";
-        } else {
-          std::cout << "VM_STDOUT_START";
-        }
-        double double_value;
-        uint64_t raw = registers_.ReadGpr(10);
-        std::memcpy(&double_value, &raw, sizeof(double_value));
-        std::cout << std::setprecision(std::numeric_limits<double>::max_digits10) << double_value;
-        if (!globals::vm_as_backend) {
-            std::cout << "]" << std::endl;
-        } else {
-          std::cout << "VM_STDOUT_END" << std::endl;
-        }
-        break;
-    }
-    case SYSCALL_PRINT_STRING: {
-        if (!globals::vm_as_backend) {
-            std::cout << "[Syscall output: ";
-        }
-        PrintString(registers_.ReadGpr(10)); // Print string
-        if (!globals::vm_as_backend) {
-            std::cout << "]" << std::endl;
-        }
-        break;
+void RVSSVM::ExecuteVector() {
+  const decoder::DecodedOp &op = control_unit_.GetDecodedOp();
+  uint8_t rs1 = (current_instruction_ >> 15) & 0b11111;
+  uint8_t rs2 = (current_instruction_ >> 20) & 0b11111;
+  uint64_t rs1_value = op.rs1_fp ? registers_.ReadFpr(rs1) : registers_.ReadGpr(rs1);
+  uint64_t rs2_value = registers_.ReadGpr(rs2);
+
+  if (vector_unit::isConfig(current_instruction_)) {
+    vector_unit::Config config = vector_unit::configure(current_instruction_, rs1_value, rs2_value, registers_);
+    if (config.vl != registers_.VectorLength()) {
+      history_.RecordRegister(0, 4, registers_.VectorLength(), config.vl);
     }
-    case SYSCALL_EXIT: {
-        stop_requested_ = true; // Stop the VM
-        if (!globals::vm_as_backend) {
-            std::cout << "VM_EXIT" << std::endl;
-        }
-        output_status_ = "VM_EXIT";
-        std::cout << "Exited with exit code: " << registers_.ReadGpr(10) << std::endl;
-        exit(0); // Exit the program
-        break;
+    if (config.vtype != registers_.VectorType()) {
+      history_.RecordRegister(1, 4, registers_.VectorType(), config.vtype);
     }
-    case SYSCALL_READ: { // Read
-      uint64_t file_descriptor = registers_.ReadGpr(10);
-      uint64_t buffer_address = registers_.ReadGpr(11);
-      uint64_t length = registers_.ReadGpr(12);
-
-      if (file_descriptor == 0) {
-        // Read from stdin
-        std::string input;
-        {
-          std::cout << "VM_STDIN_START" << std::endl;
-          output_status_ = "VM_STDIN_START";
-          std::unique_lock<std::mutex> lock(input_mutex_);
-          input_cv_.wait(lock, [this]() { 
-            return !input_queue_.empty(); 
-          });
-          output_status_ = "VM_STDIN_END";
-          std::cout << "VM_STDIN_END" << std::endl;
-
-          input = input_queue_.front();
-          input_queue_.pop();
-        }
+    registers_.SetVectorConfig(config.vl, config.vtype);
+    execution_result_ = static_cast<int64_t>(config.vl);
+    return;
+  }
 
+  if (!vector_unit::isLegal(current_instruction_, registers_)) {
+    std::cerr << "Illegal vector instruction at 0x" << std::hex << program_counter_ - instruction_length_ << std::dec
+              << ": vtype not set or register group not aligned" << std::endl;
+    return;
+  }
 
-        std::vector<uint8_t> old_bytes_vec(length, 0);
-        std::vector<uint8_t> new_bytes_vec(length, 0);
+  // the old values are read before the instruction runs, what it changed is recorded after
+  vector_unit::Footprint footprint = vector_unit::footprint(current_instruction_, registers_, rs1_value, rs2_value);
+  vector_old_words_.resize(footprint.words);
+  for (size_t i = 0; i < footprint.words; ++i) {
+    vector_old_words_[i] = registers_.ReadVectorWord(footprint.first_word + i);
+  }
+  vector_old_bytes_.resize(footprint.elements * footprint.element_bytes);
+  for (uint64_t i = 0; i < footprint.elements; ++i) {
+    uint64_t address = footprint.address + i * footprint.stride;
+    for (size_t j = 0; j < footprint.element_bytes; ++j) {
+      vector_old_bytes_[i * footprint.element_bytes + j] = memory_controller_.ReadByte(address + j);
+    }
+  }
 
-        for (size_t i = 0; i < length; ++i) {
-          old_bytes_vec[i] = memory_controller_.ReadByte(buffer_address + i);
-        }
-        
-        for (size_t i = 0; i < input.size() && i < length; ++i) {
-          memory_controller_.WriteByte(buffer_address + i, static_cast<uint8_t>(input[i]));
-        }
-        if (input.size() < length) {
-          memory_controller_.WriteByte(buffer_address + input.size(), '\0');
-        }
+  AccrueFflags(vector_unit::execute(current_instruction_, registers_, memory_controller_, alu_, rs1_value, rs2_value));
 
-        for (size_t i = 0; i < length; ++i) {
-          new_bytes_vec[i] = memory_controller_.ReadByte(buffer_address + i);
-        }
+  for (size_t i = 0; i < footprint.words; ++i) {
+    uint64_t new_word = registers_.ReadVectorWord(footprint.first_word + i);
+    if (new_word != vector_old_words_[i]) {
+      history_.RecordRegister(footprint.first_word + i, 3, vector_old_words_[i], new_word);
+    }
+  }
+  for (uint64_t i = 0; i < footprint.elements; ++i) {
+    RecordStore(footprint.address + i * footprint.stride, vector_old_bytes_.data() + i * footprint.element_bytes,
+                footprint.element_bytes);
+  }
+}
 
-        current_delta_.memory_changes.push_back({
-          buffer_address, 
-          old_bytes_vec, 
-          new_bytes_vec
-        });
-
-        uint64_t old_reg = registers_.ReadGpr(10);
-        unsigned int reg_index = 10;
-        unsigned int reg_type = 0; // 0 for GPR, 1 for CSR, 2 for FPR
-        uint64_t new_reg = std::min(static_cast<uint64_t>(length), static_cast<uint64_t>(input.size()));
-        registers_.WriteGpr(10, new_reg); 
-        if (old_reg != new_reg) {
-          current_delta_.register_changes.push_back({reg_index, reg_type, old_reg, new_reg});
-        }
+void RVSSVM::HandleSyscall() {
+  // the syscall itself is shared with the pipelined vms, only the undo record is specific to this vm
+  uint64_t syscall_number = registers_.ReadGpr(17);
+  uint64_t buffer_address = registers_.ReadGpr(11);
+  uint64_t length = registers_.ReadGpr(12);
+  bool reads_stdin = syscall_number == SYSCALL_READ && registers_.ReadGpr(10) == 0;
+  uint64_t old_reg = registers_.ReadGpr(10);
 
-      } else {
-          std::cerr << "Unsupported file descriptor: " << file_descriptor << std::endl;
-      }
-      break;
+  std::vector<uint8_t> old_bytes_vec;
+  if (reads_stdin) {
+    old_bytes_vec.resize(length, 0);
+    for (size_t i = 0; i < length; ++i) {
+      old_bytes_vec[i] = memory_controller_.ReadByte(buffer_address + i);
     }
-    case SYSCALL_WRITE: { // Write
-        uint64_t file_descriptor = registers_.ReadGpr(10);
-        uint64_t buffer_address = registers_.ReadGpr(11);
-        uint64_t length = registers_.ReadGpr(12);
-
-        if (file_descriptor == 1) { // stdout
-          std::cout << "VM_STDOUT_START";
-          output_status_ = "VM_STDOUT_START";
-          uint64_t bytes_printed = 0;
-          for (uint64_t i = 0; i < length; ++i) {
-              char c = memory_controller_.ReadByte(buffer_address + i);
-              // if (c == '\0') {
-              //     break;
-              // }
-              std::cout << c;
-              bytes_printed++;
-          }
-          std::cout << std::flush; 
-          output_status_ = "VM_STDOUT_END";
-          std::cout << "VM_STDOUT_END" << std::endl;
-
-          uint64_t old_reg = registers_.ReadGpr(10);
-          unsigned int reg_index = 10;
-          unsigned int reg_type = 0; // 0 for GPR, 1 for CSR, 2 for FPR
-          uint64_t new_reg = std::min(static_cast<uint64_t>(length), bytes_printed);
-          registers_.WriteGpr(10, new_reg);
-          if (old_reg != new_reg) {
-            current_delta_.register_changes.push_back({reg_index, reg_type, old_reg, new_reg});
-          }
-        } else {
-            std::cerr << "Unsupported file descriptor: " << file_descriptor << std::endl;
-        }
-        break;
+  }
+
+  // a seek replaying past this ecall gets the recorded result, so nothing is printed or read from stdin twice
+  const SyscallRecord *recorded = checkpoints_.FindSyscall(instructions_retired_);
+  if (recorded) {
+    for (size_t i = 0; i < recorded->buffer.size(); ++i) {
+      memory_controller_.WriteByte(recorded->buffer_address + i, recorded->buffer[i]);
     }
-    default: {
-      std::cerr << "Unknown syscall number: " << syscall_number << std::endl;
-      break;
+    registers_.WriteGpr(10, recorded->a0);
+  } else {
+    VmBase::HandleSyscall();
+  }
+
+  if (reads_stdin) {
+    std::vector<uint8_t> new_bytes_vec(length, 0);
+    for (size_t i = 0; i < length; ++i) {
+      new_bytes_vec[i] = memory_controller_.ReadByte(buffer_address + i);
+    }
+    history_.RecordMemory(buffer_address, old_bytes_vec.data(), new_bytes_vec.data(), length);
+    if (!recorded && checkpoints_.Enabled()) {
+      checkpoints_.RecordSyscall({instructions_retired_, registers_.ReadGpr(10), buffer_address, std::move(new_bytes_vec)});
     }
+  } else if (!recorded && checkpoints_.Enabled()) {
+    checkpoints_.RecordSyscall({instructions_retired_, registers_.ReadGpr(10), 0, {}});
+  }
+
+  uint64_t new_reg = registers_.ReadGpr(10);
+  if (old_reg != new_reg) {
+    history_.RecordRegister(10, 0, old_reg, new_reg); // 0 for GPR, 1 for CSR, 2 for FPR
+  }
+}
+
+void RVSSVM::RecordStore(uint64_t address, const uint8_t *old_bytes, size_t size) {
+  uint8_t new_bytes[MemoryChange::kMaxBytes];
+  for (size_t i = 0; i < size; ++i) {
+    new_bytes[i] = memory_controller_.ReadByte(address + i);
+  }
+  if (!std::equal(old_bytes, old_bytes + size, new_bytes)) {
+    history_.RecordMemory(address, old_bytes, new_bytes, size);
+  }
+}
+
+void RVSSVM::RecordReservation(const atomic_unit::Reservation &old_reservation) {
+  if (old_reservation.address != reservation_.address) {
+    history_.RecordRegister(0, 5, old_reservation.address, reservation_.address);
+  }
+  if (old_reservation.value != reservation_.value) {
+    history_.RecordRegister(1, 5, old_reservation.value, reservation_.value);
+  }
+  if (old_reservation.bytes != reservation_.bytes) {
+    history_.RecordRegister(2, 5, old_reservation.bytes, reservation_.bytes);
   }
 }
 
 void RVSSVM::WriteMemory() {
-  uint8_t opcode = current_instruction_ & 0b1111111;
+  const decoder::DecodedOp &op = control_unit_.GetDecodedOp();
   uint8_t rs2 = (current_instruction_ >> 20) & 0b11111;
   uint8_t funct3 = (current_instruction_ >> 12) & 0b111;
 
-  if (opcode == 0b1110011 && funct3 == 0b000) {
+  if (op.is_syscall || op.is_vector) {   // vector stores are done in ExecuteVector()
     return;
   }
 
-  if (instruction_set::isFInstruction(current_instruction_)) { // RV64 F
+  if (op.is_float) { // RV64 F
     WriteMemoryFloat();
     return;
-  } else if (instruction_set::isDInstruction(current_instruction_)) {
+  } else if (op.is_double) {
     WriteMemoryDouble();
     return;
   }
 
+  if (op.is_atomic) { // lr, sc, amo*, rs1 is the address
+    uint64_t addr = execution_result_;
+    size_t size = atomic_unit::accessBytes(current_instruction_);
+    uint8_t old_bytes[MemoryChange::kMaxBytes];
+    for (size_t i = 0; i < size; ++i) {
+      old_bytes[i] = memory_controller_.ReadByte(addr + i);
+    }
+    atomic_unit::Reservation old_reservation = reservation_;
+    memory_result_ = static_cast<int64_t>(atomic_unit::execute(atomic_unit::operation(current_instruction_), size, addr,
+                                                               registers_.ReadGpr(rs2), memory_controller_, reservation_));
+    RecordStore(addr, old_bytes, size);
+    RecordReservation(old_reservation);
+    return;
+  }
+
   if (control_unit_.GetMemRead()) {
     switch (funct3) {
       case 0b000: {// LB
@@ -445,95 +424,57 @@ void RVSSVM::WriteMemory() {
     }
   }
 
-  uint64_t addr = 0;
-  std::vector<uint8_t> old_bytes_vec;
-  std::vector<uint8_t> new_bytes_vec;
-
   // TODO: use direct read to read memory for undo/redo functionality, i.e. ReadByte -> ReadByte_d
 
 
   if (control_unit_.GetMemWrite()) {
+    uint64_t addr = execution_result_;
+    size_t size = size_t{1} << (funct3 & 0b11); // 1, 2, 4, 8 bytes
+    uint8_t old_bytes[MemoryChange::kMaxBytes];
+    for (size_t i = 0; i < size; ++i) {
+      old_bytes[i] = memory_controller_.ReadByte(addr + i);
+    }
+
     switch (funct3) {
       case 0b000: {// SB
-        addr = execution_result_;
-        old_bytes_vec.push_back(memory_controller_.ReadByte(addr));
         memory_controller_.WriteByte(execution_result_, registers_.ReadGpr(rs2) & 0xFF);
-        new_bytes_vec.push_back(memory_controller_.ReadByte(addr));
         break;
       }
       case 0b001: {// SH
-        addr = execution_result_;
-        for (size_t i = 0; i < 2; ++i) {
-          old_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
-        }
         memory_controller_.WriteHalfWord(execution_result_, registers_.ReadGpr(rs2) & 0xFFFF);
-        for (size_t i = 0; i < 2; ++i) {
-          new_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
-        }
         break;
       }
       case 0b010: {// SW
-        addr = execution_result_;
-        for (size_t i = 0; i < 4; ++i) {
-          old_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
-        }
         memory_controller_.WriteWord(execution_result_, registers_.ReadGpr(rs2) & 0xFFFFFFFF);
-        for (size_t i = 0; i < 4; ++i) {
-          new_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
-        }
         break;
       }
       case 0b011: {// SD
-        addr = execution_result_;
-        for (size_t i = 0; i < 8; ++i) {
-          old_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
-        }
         memory_controller_.WriteDoubleWord(execution_result_, registers_.ReadGpr(rs2) & 0xFFFFFFFFFFFFFFFF);
-        for (size_t i = 0; i < 8; ++i) {
-          new_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
-        }
         break;
       }
     }
-  }
-
-  if (old_bytes_vec != new_bytes_vec) {
-    current_delta_.memory_changes.push_back({
-      addr,
-      old_bytes_vec,
-      new_bytes_vec
-    });
+    RecordStore(addr, old_bytes, size);
   }
 }
 
 void RVSSVM::WriteMemoryFloat() {
   uint8_t rs2 = (current_instruction_ >> 20) & 0b11111;
 
-  if (control_unit_.GetMemRead()) { // FLW
-    memory_result_ = memory_controller_.ReadWord(execution_result_);
+  if (control_unit_.GetMemRead()) { // FLW, NaN-boxed into the 64-bit register
+    memory_result_ = 0xFFFFFFFF00000000 | memory_controller_.ReadWord(execution_result_);
   }
 
   // std::cout << "+++++ Memory result: " << memory_result_ << std::endl;
 
-  uint64_t addr = 0;
-  std::vector<uint8_t> old_bytes_vec;
-  std::vector<uint8_t> new_bytes_vec;
-
   if (control_unit_.GetMemWrite()) { // FSW
-    addr = execution_result_;
+    uint64_t addr = execution_result_;
+    uint8_t old_bytes[4];
     for (size_t i = 0; i < 4; ++i) {
-      old_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
+      old_bytes[i] = memory_controller_.ReadByte(addr + i);
     }
     uint32_t val = registers_.ReadFpr(rs2) & 0xFFFFFFFF;
     memory_controller_.WriteWord(execution_result_, val);
-    // new_bytes_vec.push_back(memory_controller_.ReadByte(addr));
-    for (size_t i = 0; i < 4; ++i) {
-      new_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
-    }
-  }
-
-  if (old_bytes_vec!=new_bytes_vec) {
-    current_delta_.memory_changes.push_back({addr, old_bytes_vec, new_bytes_vec});
+    RecordStore(addr, old_bytes, 4);
   }
 }
 
@@ -544,44 +485,33 @@ void RVSSVM::WriteMemoryDouble() {
     memory_result_ = memory_controller_.ReadDoubleWord(execution_result_);
   }
 
-  uint64_t addr = 0;
-  std::vector<uint8_t> old_bytes_vec;
-  std::vector<uint8_t> new_bytes_vec;
-
   if (control_unit_.GetMemWrite()) {// FSD
-    addr = execution_result_;
+    uint64_t addr = execution_result_;
+    uint8_t old_bytes[8];
     for (size_t i = 0; i < 8; ++i) {
-      old_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
+      old_bytes[i] = memory_controller_.ReadByte(addr + i);
     }
     memory_controller_.WriteDoubleWord(execution_result_, registers_.ReadFpr(rs2));
-    for (size_t i = 0; i < 8; ++i) {
-      new_bytes_vec.push_back(memory_controller_.ReadByte(addr + i));
-    }
-  }
-
-  if (old_bytes_vec!=new_bytes_vec) {
-    current_delta_.memory_changes.push_back({addr, old_bytes_vec, new_bytes_vec});
+    RecordStore(addr, old_bytes, 8);
   }
 }
 
 void RVSSVM::WriteBack() {
-  uint8_t opcode = current_instruction_ & 0b1111111;
-  uint8_t funct3 = (current_instruction_ >> 12) & 0b111;
+  const decoder::DecodedOp &op = control_unit_.GetDecodedOp();
   uint8_t rd = (current_instruction_ >> 7) & 0b11111;
   int32_t imm = ImmGenerator(current_instruction_);
 
-  if (opcode == get_instr_encoding(Instruction::kecall).opcode && 
-      funct3 == get_instr_encoding(Instruction::kecall).funct3) { // ecall
+  if (op.is_syscall) { // ecall
     return;
   }
 
-  if (instruction_set::isFInstruction(current_instruction_)) { // RV64 F
+  if (op.is_float) { // RV64 F
     WriteBackFloat();
     return;
-  } else if (instruction_set::isDInstruction(current_instruction_)) {
+  } else if (op.is_double) {
     WriteBackDouble();
     return;
-  } else if (opcode==0b1110011) { // CSR opcode
+  } else if (op.is_csr) { // CSR opcode
     WriteBackCsr();
     return;
   }
@@ -592,48 +522,26 @@ void RVSSVM::WriteBack() {
 
 
   if (control_unit_.GetRegWrite()) { 
-    switch (opcode) {
-      case get_instr_encoding(Instruction::kRtype).opcode: /* R-Type */
-      case get_instr_encoding(Instruction::kItype).opcode: /* I-Type */
-      case get_instr_encoding(Instruction::kauipc).opcode: /* AUIPC */ {
-        registers_.WriteGpr(rd, execution_result_);
-        break;
-      }
-      case get_instr_encoding(Instruction::kLoadType).opcode: /* Load */ { 
-        registers_.WriteGpr(rd, memory_result_);
-        break;
-      }
-      case get_instr_encoding(Instruction::kjalr).opcode: /* JALR */
-      case get_instr_encoding(Instruction::kjal).opcode: /* JAL */ {
-        registers_.WriteGpr(rd, next_pc_);
-        break;
-      }
-      case get_instr_encoding(Instruction::klui).opcode: /* LUI */ {
-        registers_.WriteGpr(rd, (imm << 12));
-        break;
-      }
-      default: break;
+    if (control_unit_.GetMemToReg()) { // Load
+      registers_.WriteGpr(rd, memory_result_);
+    } else if (control_unit_.GetBranch()) { // JAL, JALR, next_pc_ set in Execute()
+      registers_.WriteGpr(rd, next_pc_);
+    } else if (op.instr == Instruction::klui) { // LUI
+      registers_.WriteGpr(rd, (imm << 12));
+    } else { // R-Type, I-Type, AUIPC
+      registers_.WriteGpr(rd, execution_result_);
     }
   }
 
-  if (opcode==get_instr_encoding(Instruction::kjal).opcode) /* JAL */ {
-    // Updated in Execute()
-  }
-  if (opcode==get_instr_encoding(Instruction::kjalr).opcode) /* JALR */ {
-    // registers_.WriteGpr(rd, return_address_); // Write back to rs1
-    // Updated in Execute()
-  }
-
   uint64_t new_reg = registers_.ReadGpr(rd);
   if (old_reg!=new_reg) {
-    current_delta_.register_changes.push_back({reg_index, reg_type, old_reg, new_reg});
+    history_.RecordRegister(reg_index, reg_type, old_reg, new_reg);
   }
 
 }
 
 void RVSSVM::WriteBackFloat() {
-  uint8_t opcode = current_instruction_ & 0b1111111;
-  uint8_t funct7 = (current_instruction_ >> 25) & 0b1111111;
+  const decoder::DecodedOp &op = control_unit_.GetDecodedOp();
   uint8_t rd = (current_instruction_ >> 7) & 0b11111;
 
   uint64_t old_reg = 0;
@@ -642,73 +550,34 @@ void RVSSVM::WriteBackFloat() {
   uint64_t new_reg = 0;
 
   if (control_unit_.GetRegWrite()) {
-    switch(funct7) {
-      // write to GPR
-      case get_instr_encoding(Instruction::kfle_s).funct7: // f(eq|lt|le).s
-      case get_instr_encoding(Instruction::kfcvt_w_s).funct7: // fcvt.(w|wu|l|lu).s
-      case get_instr_encoding(Instruction::kfmv_x_w).funct7: // fmv.x.w , fclass.s
-      {
-        old_reg = registers_.ReadGpr(rd);
-        registers_.WriteGpr(rd, execution_result_);
-        new_reg = execution_result_;
-        reg_type = 0; // GPR
-        break;
-      }
-
-      // write to FPR
-      default: {
-        switch (opcode) {
-          case get_instr_encoding(Instruction::kflw).opcode: {
-            old_reg = registers_.ReadFpr(rd);
-            registers_.WriteFpr(rd, memory_result_);
-            new_reg = memory_result_;
-            reg_type = 2; // FPR
-            break;
-          }
-
-          default: {
-            old_reg = registers_.ReadFpr(rd);
-            registers_.WriteFpr(rd, execution_result_);
-            new_reg = execution_result_;
-            reg_type = 2; // FPR
-            break;
-          }
-        }
-      }
+    // write to GPR: f(eq|lt|le).s, fcvt.(w|wu|l|lu).s, fmv.x.w, fclass.s
+    if (!op.rd_fp) {
+      old_reg = registers_.ReadGpr(rd);
+      registers_.WriteGpr(rd, execution_result_);
+      new_reg = execution_result_;
+      reg_type = 0; // GPR
+    }
+    // write to FPR
+    else if (control_unit_.GetMemToReg()) { // FLW
+      old_reg = registers_.ReadFpr(rd);
+      registers_.WriteFpr(rd, memory_result_);
+      new_reg = memory_result_;
+      reg_type = 2; // FPR
+    } else {
+      old_reg = registers_.ReadFpr(rd);
+      registers_.WriteFpr(rd, execution_result_);
+      new_reg = execution_result_;
+      reg_type = 2; // FPR
     }
-
-    // // write to GPR
-    // if (funct7==0b1010000
-    //     || funct7==0b1100000
-    //     || funct7==0b1110000) { // f(eq|lt|le).s, fcvt.(w|wu|l|lu).s
-    //   old_reg = registers_.ReadGpr(rd);
-    //   registers_.WriteGpr(rd, execution_result_);
-    //   new_reg = execution_result_;
-    //   reg_type = 0; // GPR
-
-    // }
-    // // write to FPR
-    // else if (opcode==get_instr_encoding(Instruction::kflw).opcode) {
-    //   old_reg = registers_.ReadFpr(rd);
-    //   registers_.WriteFpr(rd, memory_result_);
-    //   new_reg = memory_result_;
-    //   reg_type = 2; // FPR
-    // } else {
-    //   old_reg = registers_.ReadFpr(rd);
-    //   registers_.WriteFpr(rd, execution_result_);
-    //   new_reg = execution_result_;
-    //   reg_type = 2; // FPR
-    // }
   }
 
   if (old_reg!=new_reg) {
-    current_delta_.register_changes.push_back({reg_index, reg_type, old_reg, new_reg});
+    history_.RecordRegister(reg_index, reg_type, old_reg, new_reg);
   }
 }
 
 void RVSSVM::WriteBackDouble() {
-  uint8_t opcode = current_instruction_ & 0b1111111;
-  uint8_t funct7 = (current_instruction_ >> 25) & 0b1111111;
+  const decoder::DecodedOp &op = control_unit_.GetDecodedOp();
   uint8_t rd = (current_instruction_ >> 7) & 0b11111;
 
   uint64_t old_reg = 0;
@@ -717,17 +586,15 @@ void RVSSVM::WriteBackDouble() {
   uint64_t new_reg = 0;
 
   if (control_unit_.GetRegWrite()) {
-    // write to GPR
-    if (funct7==0b1010001
-        || funct7==0b1100001
-        || funct7==0b1110001) { // f(eq|lt|le).d, fcvt.(w|wu|l|lu).d
+    // write to GPR: f(eq|lt|le).d, fcvt.(w|wu|l|lu).d, fmv.x.d, fclass.d
+    if (!op.rd_fp) {
       old_reg = registers_.ReadGpr(rd);
       registers_.WriteGpr(rd, execution_result_);
       new_reg = execution_result_;
       reg_type = 0; // GPR
     }
       // write to FPR
-    else if (opcode==0b0000111) {
+    else if (control_unit_.GetMemToReg()) { // FLD
       old_reg = registers_.ReadFpr(rd);
       registers_.WriteFpr(rd, memory_result_);
       new_reg = memory_result_;
@@ -741,7 +608,7 @@ void RVSSVM::WriteBackDouble() {
   }
 
   if (old_reg!=new_reg) {
-    current_delta_.register_changes.push_back({reg_index, reg_type, old_reg, new_reg});
+    history_.RecordRegister(reg_index, reg_type, old_reg, new_reg);
   }
 
   return;
@@ -750,6 +617,11 @@ void RVSSVM::WriteBackDouble() {
 void RVSSVM::WriteBackCsr() {
   uint8_t rd = (current_instruction_ >> 7) & 0b11111;
   uint8_t funct3 = (current_instruction_ >> 12) & 0b111;
+  uint64_t old_reg = registers_.ReadGpr(rd);
+  uint64_t old_csr = registers_.ReadCsr(csr_target_address_);
+  // csrrw / csrrwi always write, the set and clear forms only with a non-zero source
+  bool write = (funct3 & 0b11) == 0b01 || ((funct3 & 0b100) ? csr_uimm_ : csr_write_val_) != 0;
+  ReportCsrAccess(csr_target_address_, write, program_counter_ - instruction_length_);
 
   switch (funct3) {
     case get_instr_encoding(Instruction::kcsrrw).funct3: { // CSRRW
@@ -792,6 +664,61 @@ void RVSSVM::WriteBackCsr() {
     }
   }
 
+  uint64_t new_reg = registers_.ReadGpr(rd);
+  if (old_reg != new_reg) {
+    history_.RecordRegister(rd, 0, old_reg, new_reg); // 0 for GPR, 1 for CSR, 2 for FPR
+  }
+  uint64_t new_csr = registers_.ReadCsr(csr_target_address_);
+  if (old_csr != new_csr) {
+    history_.RecordRegister(csr_target_address_, 1, old_csr, new_csr);
+  }
+}
+
+void RVSSVM::ExecuteInstruction() {
+  if (checkpoints_.Due(instructions_retired_)) {
+    TakeCheckpoint();
+  }
+  Fetch();
+  Decode();
+  Execute();
+  WriteMemory();
+  WriteBack();
+  instructions_retired_++;
+  cycle_s_++;
+}
+
+void RVSSVM::TakeCheckpoint() {
+  checkpoints_.Add({instructions_retired_, cycle_s_, program_counter_, registers_, memory_controller_.TakeSnapshot(),
+                    reservation_});
+}
+
+void RVSSVM::RestoreCheckpoint(const Checkpoint &checkpoint) {
+  instructions_retired_ = checkpoint.instructions_retired;
+  cycle_s_ = checkpoint.cycles;
+  program_counter_ = checkpoint.program_counter;
+  registers_ = checkpoint.registers;
+  memory_controller_.RestoreSnapshot(checkpoint.memory);
+  reservation_ = checkpoint.reservation;
+}
+
+bool RVSSVM::SeekTo(uint64_t instruction) {
+  // going back always needs a checkpoint, going forward only uses one if it skips more than replaying from here
+  const Checkpoint *nearest = checkpoints_.Nearest(instruction);
+  if (instruction < instructions_retired_) {
+    if (!nearest) {
+      return false;
+    }
+    RestoreCheckpoint(*nearest);
+  } else if (nearest && nearest->instructions_retired > instructions_retired_) {
+    RestoreCheckpoint(*nearest);
+  }
+
+  ClearStop();
+  while (instructions_retired_ < instruction && !stop_requested_ && program_counter_ < program_size_) {
+    ExecuteInstruction();
+  }
+  furthest_instruction_ = std::max(furthest_instruction_, static_cast<uint64_t>(instructions_retired_));
+  return true;
 }
 
 void RVSSVM::Run() {
@@ -802,16 +729,11 @@ void RVSSVM::Run() {
     if (instruction_executed > vm_config::config.getInstructionExecutionLimit())
       break;
 
-    Fetch();
-    Decode();
-    Execute();
-    WriteMemory();
-    WriteBack();
-    instructions_retired_++;
+    ExecuteInstruction();
     instruction_executed++;
-    cycle_s_++;
     std::cout << "Program Counter: " << program_counter_ << std::endl;
   }
+  furthest_instruction_ = std::max(furthest_instruction_, static_cast<uint64_t>(instructions_retired_));
   if (program_counter_ >= program_size_) {
     std::cout << "VM_PROGRAM_END" << std::endl;
     output_status_ = "VM_PROGRAM_END";
@@ -828,25 +750,14 @@ void RVSSVM::DebugRun() {
   while (!stop_requested_ && program_counter_ < program_size_) {
     if (instruction_executed > vm_config::config.getInstructionExecutionLimit())
       break;
-    current_delta_.old_pc = program_counter_;
     if (std::find(breakpoints_.begin(), breakpoints_.end(), program_counter_) == breakpoints_.end()) {
-      Fetch();
-      Decode();
-      Execute();
-      WriteMemory();
-      WriteBack();
-      instructions_retired_++;
+      history_.BeginStep(program_counter_);
+      ExecuteInstruction();
       instruction_executed++;
-      cycle_s_++;
       std::cout << "Program Counter: " << program_counter_ << std::endl;
 
-      current_delta_.new_pc = program_counter_;
-      // history_.push(current_delta_);
-      undo_stack_.push(current_delta_);
-      while (!redo_stack_.empty()) {
-        redo_stack_.pop();
-      }
-      current_delta_ = StepDelta();
+      history_.CommitStep(program_counter_);
+      furthest_instruction_ = std::max(furthest_instruction_, static_cast<uint64_t>(instructions_retired_));
       if (program_counter_ < program_size_) {
         std::cout << "VM_STEP_COMPLETED" << std::endl;
         output_status_ = "VM_STEP_COMPLETED";
@@ -879,27 +790,16 @@ void RVSSVM::DebugRun() {
 }
 
 void RVSSVM::Step() {
-  current_delta_.old_pc = program_counter_;
   if (program_counter_ < program_size_) {
-    Fetch();
-    Decode();
-    Execute();
-    WriteMemory();
-    WriteBack();
-    instructions_retired_++;
-    cycle_s_++;
-    std::cout << "Program Counter: " << std::hex << program_counter_ << std::dec << std::endl;
-
-    current_delta_.new_pc = program_counter_;
-
-    // history_.push(current_delta_);
-
-    undo_stack_.push(current_delta_);
-    while (!redo_stack_.empty()) {
-      redo_stack_.pop();
-    }
+    history_.BeginStep(program_counter_);
+    ExecuteInstruction();
+    // formatted without std::hex, which would change the flags of the std::cout shared by the harts of a HartGroup
+    char pc_text[16];
+    char *pc_end = std::to_chars(std::begin(pc_text), std::end(pc_text), program_counter_, 16).ptr;
+    std::cout << "Program Counter: " << std::string_view(pc_text, pc_end - pc_text) << std::endl;
 
-    current_delta_ = StepDelta();
+    history_.CommitStep(program_counter_);
+    furthest_instruction_ = std::max(furthest_instruction_, static_cast<uint64_t>(instructions_retired_));
 
 
     if (program_counter_ < program_size_) {
@@ -920,24 +820,39 @@ void RVSSVM::Step() {
   }
 }
 
+void RVSSVM::SetReservationField(unsigned int index, uint64_t value) {
+  switch (index) {
+    case 0: reservation_.address = value; break;
+    case 1: reservation_.value = value; break;
+    default: reservation_.bytes = static_cast<unsigned int>(value); break;
+  }
+}
+
 void RVSSVM::Undo() {
-  if (undo_stack_.empty()) {
+  // past the recorded history, an undo is a seek to the previous instruction
+  if (!history_.CanUndo() && instructions_retired_ > 0 && SeekTo(instructions_retired_ - 1)) {
+    history_.Clear();
+    std::cout << "Program Counter: " << program_counter_ << std::endl;
+    output_status_ = "VM_UNDO_COMPLETED";
+    std::cout << "VM_UNDO_COMPLETED" << std::endl;
+    if(!silent_mode_) {
+      DumpRegisters(globals::registers_dump_file_path, registers_);
+      DumpState(globals::vm_state_dump_file_path);
+    }
+    return;
+  }
+
+  if (!history_.CanUndo()) {
     std::cout << "VM_NO_MORE_UNDO" << std::endl;
     output_status_ = "VM_NO_MORE_UNDO";
     return;
   }
 
-  StepDelta last = undo_stack_.top();
-  undo_stack_.pop();
-
-  // if (!history_.can_undo()) {
-  //     std::cout << "Nothing to undo.\n";
-  //     return;
-  // }
-
-  // StepDelta last = history_.undo();
+  const StepDelta &last = history_.Undo();
 
-  for (const auto &change : last.register_changes) {
+  // newest change first, a location written twice in the step gets its oldest value back
+  for (uint64_t i = last.register_end; i-- > last.register_begin;) {
+    const RegisterChange &change = history_.RegisterAt(i);
     switch (change.reg_type) {
       case 0: { // GPR
         registers_.WriteGpr(change.reg_index, change.old_value);
@@ -951,14 +866,31 @@ void RVSSVM::Undo() {
         registers_.WriteFpr(change.reg_index, change.old_value);
         break;
       }
-      default:std::cerr << "Invalid register type: " << change.reg_type << std::endl;
+      case 3: { // vector register word
+        registers_.WriteVectorWord(change.reg_index, change.old_value);
+        break;
+      }
+      case 4: { // vl, vtype
+        if (change.reg_index == 0) {
+          registers_.SetVectorConfig(change.old_value, registers_.VectorType());
+        } else {
+          registers_.SetVectorConfig(registers_.VectorLength(), change.old_value);
+        }
+        break;
+      }
+      case 5: { // lr / sc reservation
+        SetReservationField(change.reg_index, change.old_value);
+        break;
+      }
+      default:std::cerr << "Invalid register type: " << static_cast<unsigned int>(change.reg_type) << std::endl;
         break;
     }
   }
 
-  for (const auto &change : last.memory_changes) {
-    for (size_t i = 0; i < change.old_bytes_vec.size(); ++i) {
-      memory_controller_.WriteByte(change.address + i, change.old_bytes_vec[i]);
+  for (uint64_t i = last.memory_end; i-- > last.memory_begin;) {
+    const MemoryChange &change = history_.MemoryAt(i);
+    for (size_t j = 0; j < change.size; ++j) {
+      memory_controller_.WriteByte(change.address + j, change.old_bytes[j]);
     }
   }
 
@@ -967,8 +899,6 @@ void RVSSVM::Undo() {
   cycle_s_--;
   std::cout << "Program Counter: " << program_counter_ << std::endl;
 
-  redo_stack_.push(last);
-
   output_status_ = "VM_UNDO_COMPLETED";
   std::cout << "VM_UNDO_COMPLETED" << std::endl;
 
@@ -979,22 +909,26 @@ void RVSSVM::Undo() {
 }
 
 void RVSSVM::Redo() {
-  if (redo_stack_.empty()) {
-    std::cout << "VM_NO_MORE_REDO" << std::endl;
+  // steps reached by a seek were never recorded, they are redone by replaying them
+  if (!history_.CanRedo() && instructions_retired_ < furthest_instruction_ && SeekTo(instructions_retired_ + 1)) {
+    history_.Clear();
+    if(!silent_mode_) {
+      DumpRegisters(globals::registers_dump_file_path, registers_);
+      DumpState(globals::vm_state_dump_file_path);
+    }
+    std::cout << "Program Counter: " << program_counter_ << std::endl;
     return;
   }
 
-  StepDelta next = redo_stack_.top();
-  redo_stack_.pop();
-
-  // if (!history_.can_redo()) {
-  //       std::cout << "Nothing to redo.\n";
-  //       return;
-  //   }
+  if (!history_.CanRedo()) {
+    std::cout << "VM_NO_MORE_REDO" << std::endl;
+    return;
+  }
 
-  //   StepDelta next = history_.redo();
+  const StepDelta &next = history_.Redo();
 
-  for (const auto &change : next.register_changes) {
+  for (uint64_t i = next.register_begin; i < next.register_end; ++i) {
+    const RegisterChange &change = history_.RegisterAt(i);
     switch (change.reg_type) {
       case 0: { // GPR
         registers_.WriteGpr(change.reg_index, change.new_value);
@@ -1008,14 +942,31 @@ void RVSSVM::Redo() {
         registers_.WriteFpr(change.reg_index, change.new_value);
         break;
       }
-      default:std::cerr << "Invalid register type: " << change.reg_type << std::endl;
+      case 3: { // vector register word
+        registers_.WriteVectorWord(change.reg_index, change.new_value);
+        break;
+      }
+      case 4: { // vl, vtype
+        if (change.reg_index == 0) {
+          registers_.SetVectorConfig(change.new_value, registers_.VectorType());
+        } else {
+          registers_.SetVectorConfig(registers_.VectorLength(), change.new_value);
+        }
+        break;
+      }
+      case 5: { // lr / sc reservation
+        SetReservationField(change.reg_index, change.new_value);
+        break;
+      }
+      default:std::cerr << "Invalid register type: " << static_cast<unsigned int>(change.reg_type) << std::endl;
         break;
     }
   }
 
-  for (const auto &change : next.memory_changes) {
-    for (size_t i = 0; i < change.new_bytes_vec.size(); ++i) {
-      memory_controller_.WriteByte(change.address + i, change.new_bytes_vec[i]);
+  for (uint64_t i = next.memory_begin; i < next.memory_end; ++i) {
+    const MemoryChange &change = history_.MemoryAt(i);
+    for (size_t j = 0; j < change.size; ++j) {
+      memory_controller_.WriteByte(change.address + j, change.new_bytes[j]);
     }
   }
 
@@ -1027,10 +978,38 @@ void RVSSVM::Redo() {
     DumpState(globals::vm_state_dump_file_path);
   }
   std::cout << "Program Counter: " << program_counter_ << std::endl;
-  undo_stack_.push(next);
 
 }
 
+void RVSSVM::Seek(uint64_t instruction) {
+  if (!SeekTo(instruction)) {
+    std::cout << "VM_NO_CHECKPOINT" << std::endl;
+    output_status_ = "VM_NO_CHECKPOINT";
+    return;
+  }
+
+  // the undo history does not cover the jump, undo/redo continue from checkpoints
+  history_.Clear();
+  std::cout << "Program Counter: " << program_counter_ << std::endl;
+  if (program_counter_ >= program_size_) {
+    std::cout << "VM_PROGRAM_END" << std::endl;
+    output_status_ = "VM_PROGRAM_END";
+  } else {
+    std::cout << "VM_SEEK_COMPLETED" << std::endl;
+    output_status_ = "VM_SEEK_COMPLETED";
+  }
+  if(!silent_mode_) {
+    DumpRegisters(globals::registers_dump_file_path, registers_);
+    DumpState(globals::vm_state_dump_file_path);
+  }
+}
+
+void RVSSVM::StateEdited() {
+  checkpoints_.DropFrom(instructions_retired_);
+  history_.Clear();
+  furthest_instruction_ = instructions_retired_;
+}
+
 void RVSSVM::Reset() {
   program_counter_ = 0;
   instructions_retired_ = 0;
@@ -1040,22 +1019,21 @@ void RVSSVM::Reset() {
   program_size_ = 0;          // this should also be made zero as memory controller is reset (including the text and data segment)
   
   control_unit_.Reset();
+  alu_.setSoftFloat(vm_config::config.getFpEngine() == vm_config::FpEngine::SOFT);
   branch_flag_ = false;
   next_pc_ = 0;
   execution_result_ = 0;
   memory_result_ = 0;
+  reservation_ = {};
 
   return_address_ = 0;
   csr_target_address_ = 0;
   csr_old_value_ = 0;
   csr_write_val_ = 0;
   csr_uimm_ = 0;
-  current_delta_.register_changes.clear();
-  current_delta_.memory_changes.clear();
-  current_delta_.old_pc = 0;
-  current_delta_.new_pc = 0;
-  undo_stack_ = std::stack<StepDelta>();
-  redo_stack_ = std::stack<StepDelta>();
+  history_.SetCapacity(vm_config::config.getUndoDepth());
+  checkpoints_.SetInterval(vm_config::config.getCheckpointInterval());
+  furthest_instruction_ = 0;
 
   if(!silent_mode_) {
     DumpRegisters(globals::registers_dump_file_path, registers_);
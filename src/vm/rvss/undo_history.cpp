@@ -0,0 +1,112 @@
+/**
+ * @file undo_history.cpp
+ * @brief Implementation of the single stage VM undo/redo history
+ */
+
+#include "vm/rvss/undo_history.h"
+
+#include <algorithm>
+
+void UndoHistory::SetCapacity(std::size_t steps) {
+  step_ring_.assign(steps, StepDelta{});
+  register_ring_.assign(steps * kRecordsPerStep, RegisterChange{});
+  memory_ring_.assign(steps * kRecordsPerStep, MemoryChange{});
+  Clear();
+}
+
+void UndoHistory::Clear() {
+  oldest_ = 0;
+  undo_count_ = 0;
+  redo_count_ = 0;
+  register_head_ = 0;
+  memory_head_ = 0;
+  open_ = false;
+  overflowed_ = false;
+}
+
+void UndoHistory::BeginStep(uint64_t pc) {
+  if (step_ring_.empty()) {
+    return;
+  }
+
+  // a new step replaces the undone ones, their records are reused
+  if (redo_count_ > 0) {
+    const StepDelta &first_undone = StepAt(oldest_ + undo_count_);
+    register_head_ = first_undone.register_begin;
+    memory_head_ = first_undone.memory_begin;
+    redo_count_ = 0;
+  }
+
+  current_ = {pc, pc, register_head_, register_head_, memory_head_, memory_head_};
+  open_ = true;
+  overflowed_ = false;
+}
+
+bool UndoHistory::MakeRoom(uint64_t head, std::size_t ring_size, uint64_t StepDelta::*begin) {
+  while (undo_count_ > 0 && head - StepAt(oldest_).*begin >= ring_size) {
+    oldest_++;
+    undo_count_--;
+  }
+  if (undo_count_ == 0 && head - current_.*begin >= ring_size) {
+    overflowed_ = true;
+  }
+  return !overflowed_;
+}
+
+void UndoHistory::RecordRegister(unsigned int reg_index, unsigned int reg_type, uint64_t old_value, uint64_t new_value) {
+  if (!open_ || overflowed_ || !MakeRoom(register_head_, register_ring_.size(), &StepDelta::register_begin)) {
+    return;
+  }
+  register_ring_[register_head_ % register_ring_.size()] = {static_cast<uint16_t>(reg_index), static_cast<uint8_t>(reg_type),
+                                                            old_value, new_value};
+  register_head_++;
+}
+
+void UndoHistory::RecordMemory(uint64_t address, const uint8_t *old_bytes, const uint8_t *new_bytes, std::size_t size) {
+  for (std::size_t offset = 0; offset < size; offset += MemoryChange::kMaxBytes) {
+    if (!open_ || overflowed_ || !MakeRoom(memory_head_, memory_ring_.size(), &StepDelta::memory_begin)) {
+      return;
+    }
+    MemoryChange &change = memory_ring_[memory_head_ % memory_ring_.size()];
+    change.address = address + offset;
+    change.size = static_cast<uint8_t>(std::min(size - offset, MemoryChange::kMaxBytes));
+    std::copy_n(old_bytes + offset, change.size, change.old_bytes);
+    std::copy_n(new_bytes + offset, change.size, change.new_bytes);
+    memory_head_++;
+  }
+}
+
+void UndoHistory::CommitStep(uint64_t pc) {
+  if (!open_) {
+    return;
+  }
+  open_ = false;
+
+  // the older steps were evicted to make room for this one, and it can not be undone either
+  if (overflowed_) {
+    Clear();
+    return;
+  }
+
+  current_.new_pc = pc;
+  current_.register_end = register_head_;
+  current_.memory_end = memory_head_;
+  if (undo_count_ == step_ring_.size()) {
+    oldest_++;
+    undo_count_--;
+  }
+  StepAt(oldest_ + undo_count_) = current_;
+  undo_count_++;
+}
+
+const StepDelta &UndoHistory::Undo() {
+  undo_count_--;
+  redo_count_++;
+  return StepAt(oldest_ + undo_count_);
+}
+
+const StepDelta &UndoHistory::Redo() {
+  redo_count_--;
+  undo_count_++;
+  return StepAt(oldest_ + undo_count_ - 1);
+}
@@ -0,0 +1,619 @@
+/**
+ * @file softfloat.cpp
+ * @brief Implementation of the integer-only IEEE-754 arithmetic
+ */
+
+#include "vm/softfloat.h"
+#include "vm/alu.h"
+
+#include <utility>
+
+namespace softfloat {
+
+namespace {
+
+__extension__ typedef unsigned __int128 u128;
+
+template <typename Bits, int FracBits, int ExpBits>
+struct Format {
+    using bits_t = Bits;
+    static constexpr int kFracBits = FracBits;
+    static constexpr int kBias = (1 << (ExpBits - 1)) - 1;
+    static constexpr int kMaxExp = (1 << ExpBits) - 1;               // exponent field of inf and NaN
+    static constexpr Bits kSignMask = Bits{1} << (FracBits + ExpBits);
+    static constexpr Bits kFracMask = (Bits{1} << FracBits) - 1;
+    static constexpr Bits kQuietBit = Bits{1} << (FracBits - 1);
+    static constexpr Bits kInf = Bits{kMaxExp} << FracBits;
+    static constexpr Bits kDefaultNaN = kInf | kQuietBit;
+    static constexpr int kRoundBits = 62 - FracBits;                 // bits below the lsb in the unpacked significand
+};
+
+using F32 = Format<uint32_t, 23, 8>;
+using F64 = Format<uint64_t, 52, 11>;
+
+// a finite non zero value: sig * 2^(exp - 62) with bit 62 of sig set
+struct Unpacked {
+    bool sign;
+    int32_t exp;
+    uint64_t sig;
+};
+
+template <typename F> int expField(typename F::bits_t a) {
+    return static_cast<int>((a >> F::kFracBits) & F::kMaxExp);
+}
+
+template <typename F> bool signOf(typename F::bits_t a) {
+    return a & F::kSignMask;
+}
+
+template <typename F> bool isNaN(typename F::bits_t a) {
+    return expField<F>(a) == F::kMaxExp && (a & F::kFracMask);
+}
+
+template <typename F> bool isSignalingNaN(typename F::bits_t a) {
+    return isNaN<F>(a) && !(a & F::kQuietBit);
+}
+
+template <typename F> bool isInf(typename F::bits_t a) {
+    return (a & ~F::kSignMask) == F::kInf;
+}
+
+template <typename F> bool isZero(typename F::bits_t a) {
+    return (a & ~F::kSignMask) == 0;
+}
+
+template <typename F> typename F::bits_t withSign(bool sign, typename F::bits_t magnitude) {
+    return sign ? (magnitude | F::kSignMask) : magnitude;
+}
+
+template <typename F> Unpacked unpack(typename F::bits_t a) {
+    Unpacked u{signOf<F>(a), expField<F>(a) - F::kBias, static_cast<uint64_t>(a & F::kFracMask) << F::kRoundBits};
+    if (expField<F>(a) == 0) {
+        int shift = __builtin_clzll(u.sig) - 1;
+        u.sig <<= shift;
+        u.exp = 1 - F::kBias - shift;
+    } else {
+        u.sig |= uint64_t{1} << 62;
+    }
+    return u;
+}
+
+uint64_t shiftRightJam64(uint64_t value, int dist) {
+    if (dist <= 0) {
+        return value;
+    }
+    if (dist >= 64) {
+        return value != 0;
+    }
+    return (value >> dist) | ((value << (64 - dist)) != 0);
+}
+
+u128 shiftRightJam128(u128 value, int dist) {
+    if (dist <= 0) {
+        return value;
+    }
+    if (dist >= 128) {
+        return value != 0;
+    }
+    return (value >> dist) | ((value << (128 - dist)) != 0);
+}
+
+int clz128(u128 value) {
+    auto high = static_cast<uint64_t>(value >> 64);
+    return high ? __builtin_clzll(high) : 64 + __builtin_clzll(static_cast<uint64_t>(value));
+}
+
+// rounding toward +inf for a negative value is rounding toward zero of its magnitude and so on
+bool roundsAwayFromZero(bool sign, uint8_t rm) {
+    return (rm == kRoundDown && sign) || (rm == kRoundUp && !sign);
+}
+
+bool roundsToNearest(uint8_t rm) {
+    return rm != kRoundTowardZero && rm != kRoundDown && rm != kRoundUp;
+}
+
+// Rounds sig * 2^(exp - 62) (sig non zero, any bit may be the leading one, bit 0 is sticky) to the format.
+// Tininess is detected after rounding, as RISC-V does.
+template <typename F>
+typename F::bits_t roundPack(bool sign, int32_t exp, uint64_t sig, uint8_t rm, uint8_t &flags) {
+    using Bits = typename F::bits_t;
+    if (sig >> 63) {
+        sig = (sig >> 1) | (sig & 1);
+        ++exp;
+    } else {
+        int shift = __builtin_clzll(sig) - 1;
+        sig <<= shift;
+        exp -= shift;
+    }
+
+    constexpr uint64_t kRoundMask = (uint64_t{1} << F::kRoundBits) - 1;
+    constexpr uint64_t kHalf = uint64_t{1} << (F::kRoundBits - 1);
+    uint64_t increment = roundsToNearest(rm) ? kHalf : roundsAwayFromZero(sign, rm) ? kRoundMask : 0;
+
+    auto overflow = [&]() {
+        flags |= FCSR_OVERFLOW | FCSR_INEXACT;
+        bool to_inf = roundsToNearest(rm) || roundsAwayFromZero(sign, rm);
+        return withSign<F>(sign, to_inf ? F::kInf : F::kInf - 1);
+    };
+
+    int32_t biased = exp + F::kBias;
+    if (biased >= F::kMaxExp) {
+        return overflow();
+    }
+    bool tiny = false;
+    if (biased <= 0) {
+        // with an unbounded exponent the value would round up to 2^emin only if rounding carries out
+        tiny = biased < 0 || sig + increment < (uint64_t{1} << 63);
+        sig = shiftRightJam64(sig, 1 - biased);
+        biased = 0;
+    }
+
+    uint64_t round_bits = sig & kRoundMask;
+    if (round_bits) {
+        flags |= FCSR_INEXACT;
+        if (tiny) {
+            flags |= FCSR_UNDERFLOW;
+        }
+    }
+    sig = (sig + increment) >> F::kRoundBits;
+    if (roundsToNearest(rm) && rm != kRoundNearestMaxMagnitude && round_bits == kHalf) {
+        sig &= ~uint64_t{1};
+    }
+
+    // the hidden bit carries into the exponent field, a subnormal that rounds up becomes the smallest normal
+    uint64_t packed = (static_cast<uint64_t>(biased ? biased - 1 : 0) << F::kFracBits) + sig;
+    if ((packed >> F::kFracBits) >= static_cast<uint64_t>(F::kMaxExp)) {
+        return overflow();
+    }
+    return withSign<F>(sign, static_cast<Bits>(packed));
+}
+
+template <typename F>
+typename F::bits_t propagateNaN(typename F::bits_t a, typename F::bits_t b, uint8_t &flags) {
+    if (isSignalingNaN<F>(a) || isSignalingNaN<F>(b)) {
+        flags |= FCSR_INVALID_OP;
+    }
+    return F::kDefaultNaN;
+}
+
+template <typename F>
+typename F::bits_t invalid(uint8_t &flags) {
+    flags |= FCSR_INVALID_OP;
+    return F::kDefaultNaN;
+}
+
+// an exact zero sum is +0, or -0 when rounding down
+template <typename F>
+typename F::bits_t exactZero(uint8_t rm) {
+    return withSign<F>(rm == kRoundDown, 0);
+}
+
+template <typename F>
+typename F::bits_t add(typename F::bits_t a, typename F::bits_t b, bool subtract, uint8_t rm, uint8_t &flags) {
+    if (isNaN<F>(a) || isNaN<F>(b)) {
+        return propagateNaN<F>(a, b, flags);
+    }
+    if (subtract) {
+        b ^= F::kSignMask;
+    }
+    bool sign_a = signOf<F>(a);
+    bool sign_b = signOf<F>(b);
+    if (isInf<F>(a)) {
+        return isInf<F>(b) && sign_a != sign_b ? invalid<F>(flags) : a;
+    }
+    if (isInf<F>(b)) {
+        return b;
+    }
+    if (isZero<F>(a)) {
+        return isZero<F>(b) && sign_a != sign_b ? exactZero<F>(rm) : b;
+    }
+    if (isZero<F>(b)) {
+        return a;
+    }
+
+    Unpacked ua = unpack<F>(a);
+    Unpacked ub = unpack<F>(b);
+    if (ua.exp < ub.exp || (ua.exp == ub.exp && ua.sig < ub.sig)) {
+        std::swap(ua, ub);
+    }
+    uint64_t aligned = shiftRightJam64(ub.sig, ua.exp - ub.exp);
+    if (ua.sign == ub.sign) {
+        return roundPack<F>(ua.sign, ua.exp, ua.sig + aligned, rm, flags);
+    }
+    uint64_t difference = ua.sig - aligned;
+    if (difference == 0) {
+        return exactZero<F>(rm);
+    }
+    return roundPack<F>(ua.sign, ua.exp, difference, rm, flags);
+}
+
+template <typename F>
+typename F::bits_t mul(typename F::bits_t a, typename F::bits_t b, uint8_t rm, uint8_t &flags) {
+    if (isNaN<F>(a) || isNaN<F>(b)) {
+        return propagateNaN<F>(a, b, flags);
+    }
+    bool sign = signOf<F>(a) != signOf<F>(b);
+    if (isInf<F>(a) || isInf<F>(b)) {
+        return isZero<F>(a) || isZero<F>(b) ? invalid<F>(flags) : withSign<F>(sign, F::kInf);
+    }
+    if (isZero<F>(a) || isZero<F>(b)) {
+        return withSign<F>(sign, 0);
+    }
+
+    Unpacked ua = unpack<F>(a);
+    Unpacked ub = unpack<F>(b);
+    u128 product = static_cast<u128>(ua.sig) * ub.sig;
+    uint64_t sig = static_cast<uint64_t>(shiftRightJam128(product, 62));
+    return roundPack<F>(sign, ua.exp + ub.exp, sig, rm, flags);
+}
+
+template <typename F>
+typename F::bits_t divide(typename F::bits_t a, typename F::bits_t b, uint8_t rm, uint8_t &flags) {
+    if (isNaN<F>(a) || isNaN<F>(b)) {
+        return propagateNaN<F>(a, b, flags);
+    }
+    bool sign = signOf<F>(a) != signOf<F>(b);
+    if (isInf<F>(a)) {
+        return isInf<F>(b) ? invalid<F>(flags) : withSign<F>(sign, F::kInf);
+    }
+    if (isInf<F>(b)) {
+        return withSign<F>(sign, 0);
+    }
+    if (isZero<F>(b)) {
+        if (isZero<F>(a)) {
+            return invalid<F>(flags);
+        }
+        flags |= FCSR_DIV_BY_ZERO;
+        return withSign<F>(sign, F::kInf);
+    }
+    if (isZero<F>(a)) {
+        return withSign<F>(sign, 0);
+    }
+
+    Unpacked ua = unpack<F>(a);
+    Unpacked ub = unpack<F>(b);
+    u128 dividend = static_cast<u128>(ua.sig) << 62;
+    auto quotient = static_cast<uint64_t>(dividend / ub.sig);
+    bool remainder = static_cast<uint64_t>(dividend % ub.sig) != 0;
+    return roundPack<F>(sign, ua.exp - ub.exp, quotient | remainder, rm, flags);
+}
+
+template <typename F>
+typename F::bits_t squareRoot(typename F::bits_t a, uint8_t rm, uint8_t &flags) {
+    if (isNaN<F>(a)) {
+        return propagateNaN<F>(a, a, flags);
+    }
+    if (isZero<F>(a)) {
+        return a;
+    }
+    if (signOf<F>(a)) {
+        return invalid<F>(flags);
+    }
+    if (isInf<F>(a)) {
+        return a;
+    }
+
+    Unpacked ua = unpack<F>(a);
+    uint64_t sig = ua.sig;
+    int32_t exp = ua.exp;
+    if (exp & 1) {
+        sig <<= 1;
+        --exp;
+    }
+    // floor(sqrt(sig * 2^62)) lies in [2^62, 2^63): Newton's method on the top 64 bits gives 32 bits of it, one
+    // 128-bit step from below lands at most a few units above, the rest is corrected by the remainder
+    u128 radicand = static_cast<u128>(sig) << 62;
+    uint64_t top = sig;
+    uint64_t estimate = uint64_t{1} << 32;
+    for (uint64_t next = (estimate + top / estimate) / 2; next < estimate; next = (estimate + top / estimate) / 2) {
+        estimate = next;
+    }
+    uint64_t low = estimate << 31;
+    auto root = static_cast<uint64_t>((low + radicand / low) / 2);
+    while (static_cast<u128>(root) * root > radicand) {
+        --root;
+    }
+    u128 remainder = radicand - static_cast<u128>(root) * root;
+    return roundPack<F>(false, exp / 2, root | (remainder != 0), rm, flags);
+}
+
+template <typename F>
+typename F::bits_t mulAdd(typename F::bits_t a, typename F::bits_t b, typename F::bits_t c, uint8_t rm,
+                          uint8_t &flags) {
+    bool product_invalid = (isInf<F>(a) && isZero<F>(b)) || (isZero<F>(a) && isInf<F>(b));
+    if (isNaN<F>(a) || isNaN<F>(b) || isNaN<F>(c)) {
+        // inf * 0 is invalid even when the addend is a quiet NaN
+        if (product_invalid || isSignalingNaN<F>(a) || isSignalingNaN<F>(b) || isSignalingNaN<F>(c)) {
+            flags |= FCSR_INVALID_OP;
+        }
+        return F::kDefaultNaN;
+    }
+    if (product_invalid) {
+        return invalid<F>(flags);
+    }
+    bool sign_product = signOf<F>(a) != signOf<F>(b);
+    bool sign_c = signOf<F>(c);
+    if (isInf<F>(a) || isInf<F>(b)) {
+        return isInf<F>(c) && sign_c != sign_product ? invalid<F>(flags) : withSign<F>(sign_product, F::kInf);
+    }
+    if (isInf<F>(c)) {
+        return c;
+    }
+    if (isZero<F>(a) || isZero<F>(b)) {
+        if (isZero<F>(c)) {
+            return sign_c == sign_product ? c : exactZero<F>(rm);
+        }
+        return c;
+    }
+
+    Unpacked ua = unpack<F>(a);
+    Unpacked ub = unpack<F>(b);
+    // both terms as 128-bit significands scaled by 2^(exp - 124), the product is exact
+    u128 product = static_cast<u128>(ua.sig) * ub.sig;
+    int32_t exp = ua.exp + ub.exp;
+    if (isZero<F>(c)) {
+        int lead = 127 - clz128(product);
+        auto sig = static_cast<uint64_t>(shiftRightJam128(product, lead - 62));
+        return roundPack<F>(sign_product, exp + lead - 124, sig, rm, flags);
+    }
+
+    Unpacked uc = unpack<F>(c);
+    u128 addend = static_cast<u128>(uc.sig) << 62;
+    if (exp >= uc.exp) {
+        addend = shiftRightJam128(addend, exp - uc.exp);
+    } else {
+        product = shiftRightJam128(product, uc.exp - exp);
+        exp = uc.exp;
+    }
+
+    u128 sum;
+    bool sign;
+    if (sign_product == sign_c) {
+        sum = product + addend;
+        sign = sign_c;
+    } else if (product >= addend) {
+        sum = product - addend;
+        sign = sign_product;
+    } else {
+        sum = addend - product;
+        sign = sign_c;
+    }
+    if (sum == 0) {
+        return exactZero<F>(rm);
+    }
+
+    int lead = 127 - clz128(sum);
+    uint64_t sig = lead > 62 ? static_cast<uint64_t>(shiftRightJam128(sum, lead - 62))
+                             : static_cast<uint64_t>(sum) << (62 - lead);
+    return roundPack<F>(sign, exp + lead - 124, sig, rm, flags);
+}
+
+// a quiet NaN operand is ignored, -0 orders below +0
+template <typename F>
+typename F::bits_t minMax(typename F::bits_t a, typename F::bits_t b, bool max, uint8_t &flags) {
+    if (isSignalingNaN<F>(a) || isSignalingNaN<F>(b)) {
+        flags |= FCSR_INVALID_OP;
+    }
+    if (isNaN<F>(a)) {
+        return isNaN<F>(b) ? F::kDefaultNaN : b;
+    }
+    if (isNaN<F>(b)) {
+        return a;
+    }
+    if (isZero<F>(a) && isZero<F>(b)) {
+        return max ? (a & b) : (a | b);
+    }
+    bool sign_a = signOf<F>(a);
+    bool a_less = sign_a != signOf<F>(b) ? sign_a : (a != b && (sign_a != (a < b)));
+    return a_less != max ? a : b;
+}
+
+template <typename F>
+bool eq(typename F::bits_t a, typename F::bits_t b, uint8_t &flags) {
+    if (isNaN<F>(a) || isNaN<F>(b)) {
+        if (isSignalingNaN<F>(a) || isSignalingNaN<F>(b)) {
+            flags |= FCSR_INVALID_OP;
+        }
+        return false;
+    }
+    return a == b || isZero<F>(a | b);
+}
+
+template <typename F>
+bool lt(typename F::bits_t a, typename F::bits_t b, uint8_t &flags) {
+    if (isNaN<F>(a) || isNaN<F>(b)) {
+        flags |= FCSR_INVALID_OP;
+        return false;
+    }
+    bool sign_a = signOf<F>(a);
+    if (sign_a != signOf<F>(b)) {
+        return sign_a && !isZero<F>(a | b);
+    }
+    return a != b && (sign_a != (a < b));
+}
+
+template <typename F>
+bool le(typename F::bits_t a, typename F::bits_t b, uint8_t &flags) {
+    if (isNaN<F>(a) || isNaN<F>(b)) {
+        flags |= FCSR_INVALID_OP;
+        return false;
+    }
+    bool sign_a = signOf<F>(a);
+    if (sign_a != signOf<F>(b)) {
+        return sign_a || isZero<F>(a | b);
+    }
+    return a == b || (sign_a != (a < b));
+}
+
+template <typename F>
+uint16_t classify(typename F::bits_t a) {
+    bool sign = signOf<F>(a);
+    int exp = expField<F>(a);
+    bool frac = a & F::kFracMask;
+    if (exp == F::kMaxExp) {
+        if (!frac) {
+            return sign ? 1 << 0 : 1 << 7;
+        }
+        return (a & F::kQuietBit) ? 1 << 9 : 1 << 8;
+    }
+    if (exp == 0) {
+        if (!frac) {
+            return sign ? 1 << 3 : 1 << 4;
+        }
+        return sign ? 1 << 2 : 1 << 5;
+    }
+    return sign ? 1 << 1 : 1 << 6;
+}
+
+template <typename From, typename To>
+typename To::bits_t convert(typename From::bits_t a, uint8_t rm, uint8_t &flags) {
+    if (isNaN<From>(a)) {
+        if (isSignalingNaN<From>(a)) {
+            flags |= FCSR_INVALID_OP;
+        }
+        return To::kDefaultNaN;
+    }
+    bool sign = signOf<From>(a);
+    if (isInf<From>(a)) {
+        return withSign<To>(sign, To::kInf);
+    }
+    if (isZero<From>(a)) {
+        return withSign<To>(sign, 0);
+    }
+    Unpacked u = unpack<From>(a);
+    return roundPack<To>(u.sign, u.exp, u.sig, rm, flags);
+}
+
+template <typename F>
+typename F::bits_t fromInteger(bool sign, uint64_t magnitude, uint8_t rm, uint8_t &flags) {
+    if (magnitude == 0) {
+        return 0;
+    }
+    return roundPack<F>(sign, 62, magnitude, rm, flags);
+}
+
+// width 32 or 64, the 32-bit results sign-extended
+template <typename F>
+uint64_t toInteger(typename F::bits_t a, uint8_t rm, uint8_t &flags, bool is_signed, int width) {
+    uint64_t unsigned_max = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    uint64_t signed_max = unsigned_max >> 1;
+    auto finish = [width](uint64_t value) {
+        return width == 64 ? value : static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(value)));
+    };
+    auto saturate = [&](bool negative) {
+        flags |= FCSR_INVALID_OP;
+        if (is_signed) {
+            return finish(negative ? signed_max + 1 : signed_max);
+        }
+        return finish(negative ? 0 : unsigned_max);
+    };
+
+    if (isNaN<F>(a)) {
+        return saturate(false);
+    }
+    bool sign = signOf<F>(a);
+    if (isInf<F>(a)) {
+        return saturate(sign);
+    }
+    if (isZero<F>(a)) {
+        return 0;
+    }
+
+    Unpacked u = unpack<F>(a);
+    if (u.exp >= 64) {
+        return saturate(sign);
+    }
+    uint64_t magnitude;
+    uint64_t fraction;             // the bits below the binary point, msb first
+    if (u.exp >= 62) {
+        magnitude = u.sig << (u.exp - 62);
+        fraction = 0;
+    } else if (u.exp >= -1) {
+        int shift = 62 - u.exp;
+        magnitude = u.sig >> shift;
+        fraction = u.sig << (64 - shift);
+    } else {
+        magnitude = 0;
+        fraction = 1;              // below one half
+    }
+
+    constexpr uint64_t kHalf = uint64_t{1} << 63;
+    bool round_up;
+    switch (rm) {
+        case kRoundTowardZero: round_up = false; break;
+        case kRoundDown: round_up = sign && fraction; break;
+        case kRoundUp: round_up = !sign && fraction; break;
+        case kRoundNearestMaxMagnitude: round_up = fraction >= kHalf; break;
+        default: round_up = fraction > kHalf || (fraction == kHalf && (magnitude & 1)); break;
+    }
+    if (round_up) {
+        ++magnitude;               // the magnitude is below 2^62 whenever there are fraction bits
+    }
+
+    if (is_signed) {
+        if (sign ? magnitude > signed_max + 1 : magnitude > signed_max) {
+            return saturate(sign);
+        }
+    } else if ((sign && magnitude) || magnitude > unsigned_max) {
+        return saturate(sign);
+    }
+    if (fraction) {
+        flags |= FCSR_INEXACT;
+    }
+    return finish(sign ? 0 - magnitude : magnitude);
+}
+
+} // namespace
+
+uint32_t f32Add(uint32_t a, uint32_t b, uint8_t rm, uint8_t &flags) { return add<F32>(a, b, false, rm, flags); }
+uint32_t f32Sub(uint32_t a, uint32_t b, uint8_t rm, uint8_t &flags) { return add<F32>(a, b, true, rm, flags); }
+uint32_t f32Mul(uint32_t a, uint32_t b, uint8_t rm, uint8_t &flags) { return mul<F32>(a, b, rm, flags); }
+uint32_t f32Div(uint32_t a, uint32_t b, uint8_t rm, uint8_t &flags) { return divide<F32>(a, b, rm, flags); }
+uint32_t f32Sqrt(uint32_t a, uint8_t rm, uint8_t &flags) { return squareRoot<F32>(a, rm, flags); }
+uint32_t f32MulAdd(uint32_t a, uint32_t b, uint32_t c, uint8_t rm, uint8_t &flags) {
+    return mulAdd<F32>(a, b, c, rm, flags);
+}
+uint32_t f32Min(uint32_t a, uint32_t b, uint8_t &flags) { return minMax<F32>(a, b, false, flags); }
+uint32_t f32Max(uint32_t a, uint32_t b, uint8_t &flags) { return minMax<F32>(a, b, true, flags); }
+bool f32Eq(uint32_t a, uint32_t b, uint8_t &flags) { return eq<F32>(a, b, flags); }
+bool f32Lt(uint32_t a, uint32_t b, uint8_t &flags) { return lt<F32>(a, b, flags); }
+bool f32Le(uint32_t a, uint32_t b, uint8_t &flags) { return le<F32>(a, b, flags); }
+uint16_t f32Classify(uint32_t a) { return classify<F32>(a); }
+
+uint64_t f64Add(uint64_t a, uint64_t b, uint8_t rm, uint8_t &flags) { return add<F64>(a, b, false, rm, flags); }
+uint64_t f64Sub(uint64_t a, uint64_t b, uint8_t rm, uint8_t &flags) { return add<F64>(a, b, true, rm, flags); }
+uint64_t f64Mul(uint64_t a, uint64_t b, uint8_t rm, uint8_t &flags) { return mul<F64>(a, b, rm, flags); }
+uint64_t f64Div(uint64_t a, uint64_t b, uint8_t rm, uint8_t &flags) { return divide<F64>(a, b, rm, flags); }
+uint64_t f64Sqrt(uint64_t a, uint8_t rm, uint8_t &flags) { return squareRoot<F64>(a, rm, flags); }
+uint64_t f64MulAdd(uint64_t a, uint64_t b, uint64_t c, uint8_t rm, uint8_t &flags) {
+    return mulAdd<F64>(a, b, c, rm, flags);
+}
+uint64_t f64Min(uint64_t a, uint64_t b, uint8_t &flags) { return minMax<F64>(a, b, false, flags); }
+uint64_t f64Max(uint64_t a, uint64_t b, uint8_t &flags) { return minMax<F64>(a, b, true, flags); }
+bool f64Eq(uint64_t a, uint64_t b, uint8_t &flags) { return eq<F64>(a, b, flags); }
+bool f64Lt(uint64_t a, uint64_t b, uint8_t &flags) { return lt<F64>(a, b, flags); }
+bool f64Le(uint64_t a, uint64_t b, uint8_t &flags) { return le<F64>(a, b, flags); }
+uint16_t f64Classify(uint64_t a) { return classify<F64>(a); }
+
+uint64_t f32ToF64(uint32_t a, uint8_t &flags) { return convert<F32, F64>(a, kRoundNearestEven, flags); }
+uint32_t f64ToF32(uint64_t a, uint8_t rm, uint8_t &flags) { return convert<F64, F32>(a, rm, flags); }
+
+uint32_t i64ToF32(int64_t a, uint8_t rm, uint8_t &flags) {
+    return fromInteger<F32>(a < 0, a < 0 ? 0 - static_cast<uint64_t>(a) : a, rm, flags);
+}
+uint32_t ui64ToF32(uint64_t a, uint8_t rm, uint8_t &flags) { return fromInteger<F32>(false, a, rm, flags); }
+uint64_t i64ToF64(int64_t a, uint8_t rm, uint8_t &flags) {
+    return fromInteger<F64>(a < 0, a < 0 ? 0 - static_cast<uint64_t>(a) : a, rm, flags);
+}
+uint64_t ui64ToF64(uint64_t a, uint8_t rm, uint8_t &flags) { return fromInteger<F64>(false, a, rm, flags); }
+
+uint64_t f32ToI32(uint32_t a, uint8_t rm, uint8_t &flags) { return toInteger<F32>(a, rm, flags, true, 32); }
+uint64_t f32ToUi32(uint32_t a, uint8_t rm, uint8_t &flags) { return toInteger<F32>(a, rm, flags, false, 32); }
+uint64_t f32ToI64(uint32_t a, uint8_t rm, uint8_t &flags) { return toInteger<F32>(a, rm, flags, true, 64); }
+uint64_t f32ToUi64(uint32_t a, uint8_t rm, uint8_t &flags) { return toInteger<F32>(a, rm, flags, false, 64); }
+uint64_t f64ToI32(uint64_t a, uint8_t rm, uint8_t &flags) { return toInteger<F64>(a, rm, flags, true, 32); }
+uint64_t f64ToUi32(uint64_t a, uint8_t rm, uint8_t &flags) { return toInteger<F64>(a, rm, flags, false, 32); }
+uint64_t f64ToI64(uint64_t a, uint8_t rm, uint8_t &flags) { return toInteger<F64>(a, rm, flags, true, 64); }
+uint64_t f64ToUi64(uint64_t a, uint8_t rm, uint8_t &flags) { return toInteger<F64>(a, rm, flags, false, 64); }
+
+} // namespace softfloat
@@ -0,0 +1,62 @@
+/**
+ * @file stall_accounting.cpp
+ * @brief Implementation of the stall reason counters and the CPI stack report
+ */
+
+#include "vm/stall_accounting.h"
+
+#include <numeric>
+
+const char *StallReasonName(StallReason reason) {
+    switch (reason) {
+        case StallReason::FRONTEND:             return "frontend";
+        case StallReason::LOAD_USE:             return "load_use";
+        case StallReason::RAW:                  return "raw";
+        case StallReason::LONG_LATENCY:         return "long_latency";
+        case StallReason::STRUCTURAL:           return "structural";
+        case StallReason::SERIALIZATION:        return "serialization";
+        case StallReason::BRANCH_MISPREDICT:    return "branch_mispredict";
+        case StallReason::BTB_MISS:             return "btb_miss";
+        default:                                return "unknown";
+    }
+}
+
+void StallAccounting::Record(StallReason reason, uint64_t cycles) {
+    cycles_[static_cast<std::size_t>(reason)] += cycles;
+}
+
+void StallAccounting::Clear() {
+    cycles_.fill(0);
+}
+
+uint64_t StallAccounting::Get(StallReason reason) const {
+    return cycles_[static_cast<std::size_t>(reason)];
+}
+
+uint64_t StallAccounting::Total() const {
+    return std::accumulate(cycles_.begin(), cycles_.end(), uint64_t{0});
+}
+
+void StallAccounting::DumpJson(std::ostream &os, uint64_t cycles, uint64_t instructions, const std::string &indent) const {
+    // a cycle either retires an instruction or is lost to exactly one cause, so the components add up to the cpi
+    auto per_instruction = [instructions](uint64_t value) {
+        return instructions ? static_cast<double>(value) / static_cast<double>(instructions) : 0.0;
+    };
+    uint64_t lost = Total();
+    uint64_t base = cycles > lost ? cycles - lost : 0;
+
+    os << indent << "\"cpi_stack\": {\n";
+    os << indent << "  \"cpi\": " << per_instruction(cycles) << ",\n";
+    os << indent << "  \"base\": " << per_instruction(base);
+    for (std::size_t i = 0; i < kNumReasons; ++i) {
+        os << ",\n" << indent << "  \"" << StallReasonName(static_cast<StallReason>(i)) << "\": " << per_instruction(cycles_[i]);
+    }
+    os << "\n" << indent << "},\n";
+
+    os << indent << "\"lost_cycles\": {\n";
+    os << indent << "  \"total\": " << lost;
+    for (std::size_t i = 0; i < kNumReasons; ++i) {
+        os << ",\n" << indent << "  \"" << StallReasonName(static_cast<StallReason>(i)) << "\": " << cycles_[i];
+    }
+    os << "\n" << indent << "}";
+}
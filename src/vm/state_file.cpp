@@ -0,0 +1,172 @@
+/**
+ * @file state_file.cpp
+ * @brief Implementation of the vm state file writer and reader
+ */
+
+#include "vm/state_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    enum BlockEncoding : uint8_t {
+        BLOCK_RAW = 0,
+        BLOCK_ZERO_RUN = 1,     // (zero count, literal count, literals) runs covering the block
+    };
+
+    void appendU32(std::vector<uint8_t> &out, uint32_t value) {
+        const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(value));
+    }
+
+    // zero runs shorter than this stay in the literals, a run header costs 8 bytes
+    constexpr std::size_t kMinZeroRun = 8;
+}
+
+StateWriter::StateWriter(const std::filesystem::path &filename, uint32_t flags, uint32_t block_size)
+    : file_(filename, std::ios::binary | std::ios::trunc), flags_(flags) {
+    writeBytes(state_file::kMagic, sizeof(state_file::kMagic));
+    write(state_file::kVersion);
+    write(flags_);
+    write(block_size);
+}
+
+void StateWriter::beginSection(uint32_t tag) {
+    write(tag);
+    write(uint64_t{0});
+    section_start_ = file_.tellp();
+}
+
+void StateWriter::endSection() {
+    std::streampos end = file_.tellp();
+    uint64_t length = static_cast<uint64_t>(end - section_start_);
+    file_.seekp(section_start_ - static_cast<std::streamoff>(sizeof(uint64_t)));
+    write(length);
+    file_.seekp(end);
+}
+
+void StateWriter::writeBlock(uint64_t index, const std::vector<uint8_t> &data) {
+    write(index);
+    if (!compressed()) {
+        write(uint8_t{BLOCK_RAW});
+        write(static_cast<uint32_t>(data.size()));
+        writeBytes(data.data(), data.size());
+        return;
+    }
+
+    scratch_.clear();
+    std::size_t pos = 0;
+    while (pos < data.size()) {
+        std::size_t zeros = 0;
+        while (pos + zeros < data.size() && data[pos + zeros] == 0) {
+            zeros++;
+        }
+        std::size_t literal_start = pos + zeros;
+        std::size_t literal_end = literal_start;
+        while (literal_end < data.size()) {
+            auto next_zero = std::find(data.begin() + static_cast<std::ptrdiff_t>(literal_end), data.end(), 0);
+            literal_end = static_cast<std::size_t>(next_zero - data.begin());
+            std::size_t run = 0;
+            while (literal_end + run < data.size() && data[literal_end + run] == 0 && run < kMinZeroRun) {
+                run++;
+            }
+            if (run >= kMinZeroRun || literal_end + run == data.size()) {
+                break;
+            }
+            literal_end += run;
+        }
+        appendU32(scratch_, static_cast<uint32_t>(zeros));
+        appendU32(scratch_, static_cast<uint32_t>(literal_end - literal_start));
+        scratch_.insert(scratch_.end(), data.begin() + static_cast<std::ptrdiff_t>(literal_start),
+                        data.begin() + static_cast<std::ptrdiff_t>(literal_end));
+        pos = literal_end;
+    }
+
+    if (scratch_.size() >= data.size()) {
+        write(uint8_t{BLOCK_RAW});
+        write(static_cast<uint32_t>(data.size()));
+        writeBytes(data.data(), data.size());
+    } else {
+        write(uint8_t{BLOCK_ZERO_RUN});
+        write(static_cast<uint32_t>(scratch_.size()));
+        writeBytes(scratch_.data(), scratch_.size());
+    }
+}
+
+StateReader::StateReader(const std::filesystem::path &filename) : file_(filename, std::ios::binary) {
+    char magic[sizeof(state_file::kMagic)] = {};
+    ok_ = file_.is_open();
+    if (!readBytes(magic, sizeof(magic)) || std::memcmp(magic, state_file::kMagic, sizeof(magic)) != 0) {
+        ok_ = false;
+        return;
+    }
+    read(version_);
+    read(flags_);
+    read(block_size_);
+}
+
+bool StateReader::nextSection(uint32_t &tag, uint64_t &length) {
+    if (!ok_ || file_.peek() == std::ifstream::traits_type::eof()) {
+        return false;
+    }
+    if (!read(tag) || !read(length)) {
+        return false;
+    }
+    section_end_ = file_.tellg() + static_cast<std::streamoff>(length);
+    return true;
+}
+
+void StateReader::skipSection() {
+    file_.seekg(section_end_);
+    ok_ = ok_ && file_.good();
+}
+
+bool StateReader::sectionDone() {
+    return ok_ && file_.tellg() == section_end_;
+}
+
+bool StateReader::readBytes(void *data, std::size_t size) {
+    if (!ok_) {
+        return false;
+    }
+    file_.read(static_cast<char *>(data), static_cast<std::streamsize>(size));
+    ok_ = file_.gcount() == static_cast<std::streamsize>(size);
+    return ok_;
+}
+
+bool StateReader::readBlock(uint64_t &index, std::vector<uint8_t> &data) {
+    uint8_t encoding = 0;
+    uint32_t payload = 0;
+    if (!read(index) || !read(encoding) || !read(payload)) {
+        return false;
+    }
+
+    if (encoding == BLOCK_RAW) {
+        if (payload != data.size()) {
+            return ok_ = false;
+        }
+        return readBytes(data.data(), data.size());
+    }
+    if (encoding != BLOCK_ZERO_RUN) {
+        return ok_ = false;
+    }
+
+    std::size_t pos = 0;
+    uint32_t consumed = 0;
+    while (consumed < payload) {
+        uint32_t zeros = 0;
+        uint32_t literals = 0;
+        if (!read(zeros) || !read(literals) || pos + zeros + literals > data.size()) {
+            return ok_ = false;
+        }
+        std::fill_n(data.begin() + static_cast<std::ptrdiff_t>(pos), zeros, 0);
+        pos += zeros;
+        if (!readBytes(data.data() + pos, literals)) {
+            return false;
+        }
+        pos += literals;
+        consumed += 2 * sizeof(uint32_t) + literals;
+    }
+    std::fill(data.begin() + static_cast<std::ptrdiff_t>(pos), data.end(), 0);
+    return consumed == payload;
+}
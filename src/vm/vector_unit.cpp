@@ -0,0 +1,514 @@
+/**
+ * @file vector_unit.cpp
+ * @brief The RVV subset, integer and RNE fp element loops on host SIMD with scalar loops for the rest
+ */
+
+#include "vm/vector_unit.h"
+#include "vm/decoder.h"
+#include "vm/softfloat.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <tuple>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define VECTOR_UNIT_HOST_SIMD 1
+#endif
+
+using instruction_set::Instruction;
+
+namespace vector_unit {
+namespace {
+
+constexpr uint64_t kBoxMask = 0xFFFFFFFF00000000ULL;
+constexpr uint32_t kCanonicalNaN32 = 0x7fc00000;
+
+bool isMemory(uint32_t instruction) {
+    return (instruction & 0b1111111) != 0b1010111;
+}
+
+bool isStore(uint32_t instruction) {
+    return (instruction & 0b1111111) == 0b0100111;
+}
+
+bool isStrided(uint32_t instruction) {
+    return ((instruction >> 26) & 0b11) == 0b10;        // mop
+}
+
+// EEW of the loads and stores, from the width field
+unsigned int memoryElementBytes(uint32_t instruction) {
+    switch ((instruction >> 12) & 0b111) {
+        case 0b000: return 1;
+        case 0b101: return 2;
+        case 0b110: return 4;
+        default: return 8;
+    }
+}
+
+bool isReduction(Instruction instr) {
+    return instr == Instruction::kvredsum_vs || instr == Instruction::kvfredusum_vs
+        || instr == Instruction::kvfredosum_vs;
+}
+
+bool isSplat(Instruction instr) {            // vs2 is not an operand
+    return instr == Instruction::kvmv_v_v || instr == Instruction::kvmv_v_x || instr == Instruction::kvmv_v_i
+        || instr == Instruction::kvfmv_v_f;
+}
+
+// elements are stored little-endian in the register group, as on the host
+template <typename T>
+T element(const uint8_t *group, uint64_t i) {
+    T value;
+    std::memcpy(&value, group + i * sizeof(T), sizeof(T));
+    return value;
+}
+
+template <typename T>
+void setElement(uint8_t *group, uint64_t i, T value) {
+    std::memcpy(group + i * sizeof(T), &value, sizeof(T));
+}
+
+// calls fn with a value of the unsigned integer type of the element width
+template <typename Fn>
+void withElementType(unsigned int bytes, Fn &&fn) {
+    switch (bytes) {
+        case 1: fn(uint8_t{}); break;
+        case 2: fn(uint16_t{}); break;
+        case 4: fn(uint32_t{}); break;
+        default: fn(uint64_t{}); break;
+    }
+}
+
+#ifdef VECTOR_UNIT_HOST_SIMD
+namespace stdx = std::experimental;
+
+template <typename T>
+using Lanes = stdx::native_simd<T>;
+
+template <typename V>
+V loadLanes(const uint8_t *bytes) {
+    alignas(stdx::memory_alignment_v<V>) typename V::value_type lanes[V::size()];
+    std::memcpy(lanes, bytes, sizeof(lanes));
+    return V(lanes, stdx::vector_aligned);
+}
+
+template <typename V>
+void storeLanes(const V &value, uint8_t *bytes) {
+    alignas(stdx::memory_alignment_v<V>) typename V::value_type lanes[V::size()];
+    value.copy_to(lanes, stdx::vector_aligned);
+    std::memcpy(bytes, lanes, sizeof(lanes));
+}
+#endif
+
+enum class IntOp { kAdd, kSub, kMul, kMacc, kMove };
+
+// a is vs2, b is vs1 or the scalar, d is the old vd
+template <typename X>
+X applyInt(IntOp op, X a, X b, X d) {
+    switch (op) {
+        case IntOp::kAdd: return a + b;
+        case IntOp::kSub: return a - b;
+        case IntOp::kMul: return a * b;
+        case IntOp::kMacc: return d + a * b;
+        case IntOp::kMove: return b;
+    }
+    return d;
+}
+
+// vd[i] = op(va[i], vb[i], vd[i]) for i < vl, vb broadcasts the scalar when null. The remainder runs in uint64_t, so
+// the sums and products wrap modulo 2^SEW once truncated.
+template <typename T>
+void mapInt(IntOp op, uint8_t *vd, const uint8_t *va, const uint8_t *vb, uint64_t scalar, uint64_t vl) {
+    uint64_t i = 0;
+#ifdef VECTOR_UNIT_HOST_SIMD
+    using V = Lanes<T>;
+    const V splat(static_cast<T>(scalar));
+    for (; i + V::size() <= vl; i += V::size()) {
+        V a = va ? loadLanes<V>(va + i * sizeof(T)) : V();
+        V b = vb ? loadLanes<V>(vb + i * sizeof(T)) : splat;
+        V d = op == IntOp::kMacc ? loadLanes<V>(vd + i * sizeof(T)) : V();
+        storeLanes(applyInt(op, a, b, d), vd + i * sizeof(T));
+    }
+#endif
+    for (; i < vl; ++i) {
+        uint64_t a = va ? element<T>(va, i) : 0;
+        uint64_t b = vb ? element<T>(vb, i) : scalar;
+        uint64_t d = element<T>(vd, i);
+        setElement<T>(vd, i, static_cast<T>(applyInt<uint64_t>(op, a, b, d)));
+    }
+}
+
+// vd[0] = vs1[0] + the sum of vs2[i], i < vl
+template <typename T>
+void sumInt(uint8_t *vd, const uint8_t *vs2, const uint8_t *vs1, uint64_t vl) {
+    uint64_t sum = element<T>(vs1, 0);
+    uint64_t i = 0;
+#ifdef VECTOR_UNIT_HOST_SIMD
+    using V = Lanes<T>;
+    V partial_sums = 0;
+    for (; i + V::size() <= vl; i += V::size()) {
+        partial_sums += loadLanes<V>(vs2 + i * sizeof(T));
+    }
+    sum += stdx::reduce(partial_sums);
+#endif
+    for (; i < vl; ++i) {
+        sum += element<T>(vs2, i);
+    }
+    setElement<T>(vd, 0, static_cast<T>(sum));
+}
+
+enum class FpOp { kAdd, kSub, kMul, kMacc };
+
+template <typename F> struct FpFormat;
+template <> struct FpFormat<float> {
+    using Bits = uint32_t;
+    static constexpr alu::AluOp kAdd = alu::AluOp::FADD_S;
+    static constexpr alu::AluOp kSub = alu::AluOp::FSUB_S;
+    static constexpr alu::AluOp kMul = alu::AluOp::FMUL_S;
+    static constexpr alu::AluOp kMacc = alu::AluOp::kFmadd_s;
+    // the host range of the alu: exponent field from 26 to 253
+    static constexpr float kMinHost = std::bit_cast<float>(uint32_t{26} << 23);
+    static constexpr float kMaxHost = std::bit_cast<float>(uint32_t{254} << 23);
+    static uint64_t widen(Bits bits) { return kBoxMask | bits; }
+};
+template <> struct FpFormat<double> {
+    using Bits = uint64_t;
+    static constexpr alu::AluOp kAdd = alu::AluOp::FADD_D;
+    static constexpr alu::AluOp kSub = alu::AluOp::FSUB_D;
+    static constexpr alu::AluOp kMul = alu::AluOp::FMUL_D;
+    static constexpr alu::AluOp kMacc = alu::AluOp::FMADD_D;
+    // exponent field from 55 to 2045
+    static constexpr double kMinHost = std::bit_cast<double>(uint64_t{55} << 52);
+    static constexpr double kMaxHost = std::bit_cast<double>(uint64_t{2046} << 52);
+    static uint64_t widen(Bits bits) { return bits; }
+};
+
+// one element through the alu, vd = vs2 op vs1 or vd = vs1 * vs2 + vd
+template <typename F>
+uint8_t fpElement(FpOp op, uint8_t *vd, const uint8_t *va, const uint8_t *vb, uint64_t scalar, uint64_t i,
+                  const alu::Alu &alu, uint8_t rm) {
+    using Format = FpFormat<F>;
+    using Bits = typename Format::Bits;
+    uint64_t a = Format::widen(element<Bits>(va, i));
+    uint64_t b = Format::widen(vb ? element<Bits>(vb, i) : static_cast<Bits>(scalar));
+    uint64_t result;
+    uint8_t flags;
+    switch (op) {
+        case FpOp::kAdd: std::tie(result, flags) = alu.fpexecute(Format::kAdd, a, b, 0, rm); break;
+        case FpOp::kSub: std::tie(result, flags) = alu.fpexecute(Format::kSub, a, b, 0, rm); break;
+        case FpOp::kMul: std::tie(result, flags) = alu.fpexecute(Format::kMul, a, b, 0, rm); break;
+        default:
+            std::tie(result, flags) = alu.fpexecute(Format::kMacc, b, a, Format::widen(element<Bits>(vd, i)), rm);
+            break;
+    }
+    setElement<Bits>(vd, i, static_cast<Bits>(result));
+    return flags;
+}
+
+#ifdef VECTOR_UNIT_HOST_SIMD
+template <typename F>
+bool inHostRange(const Lanes<F> &x) {
+    Lanes<F> magnitude = stdx::abs(x);
+    return stdx::all_of(magnitude >= Lanes<F>(FpFormat<F>::kMinHost) && magnitude < Lanes<F>(FpFormat<F>::kMaxHost));
+}
+
+// The same test as the host path of the alu, lane-wise: with every operand and result inside the host range the RNE
+// result is the one the soft engine gives and inexact is the only flag, read from the exact error.
+template <typename F>
+bool hostArith(FpOp op, const Lanes<F> &x, Lanes<F> y, Lanes<F> &result, bool &inexact) {
+    if (!inHostRange<F>(x) || !inHostRange<F>(y)) {
+        return false;
+    }
+    Lanes<F> error;
+    if (op == FpOp::kMul) {
+        result = x * y;
+        error = stdx::fma(x, y, -result);
+    } else {
+        if (op == FpOp::kSub) {
+            y = -y;
+        }
+        result = x + y;
+        Lanes<F> y_part = result - x;
+        error = (x - (result - y_part)) + (y - y_part);
+    }
+    if (!inHostRange<F>(result)) {
+        return false;
+    }
+    inexact = stdx::any_of(error != 0);
+    return true;
+}
+#endif
+
+template <typename F>
+uint8_t mapFloat(FpOp op, uint8_t *vd, const uint8_t *va, const uint8_t *vb, uint64_t scalar, uint64_t vl,
+                 const alu::Alu &alu, uint8_t rm) {
+    using Bits = typename FpFormat<F>::Bits;
+    uint8_t flags = 0;
+    uint64_t i = 0;
+#ifdef VECTOR_UNIT_HOST_SIMD
+    if (op != FpOp::kMacc && !alu.isSoftFloat() && rm == softfloat::kRoundNearestEven) {
+        using V = Lanes<F>;
+        const V splat(std::bit_cast<F>(static_cast<Bits>(scalar)));
+        for (; i + V::size() <= vl; i += V::size()) {
+            V x = loadLanes<V>(va + i * sizeof(F));
+            V y = vb ? loadLanes<V>(vb + i * sizeof(F)) : splat;
+            V result;
+            bool inexact = false;
+            if (hostArith<F>(op, x, y, result, inexact)) {
+                storeLanes(result, vd + i * sizeof(F));
+                flags |= inexact ? FCSR_INEXACT : 0;
+                continue;
+            }
+            for (uint64_t j = i; j < i + V::size(); ++j) {
+                flags |= fpElement<F>(op, vd, va, vb, scalar, j, alu, rm);
+            }
+        }
+    }
+#endif
+    for (; i < vl; ++i) {
+        flags |= fpElement<F>(op, vd, va, vb, scalar, i, alu, rm);
+    }
+    return flags;
+}
+
+// vd[0] = vs1[0] + the sum of vs2[i]; both the ordered and the unordered sum add in element order, so the result and
+// the flags do not depend on the host
+template <typename F>
+uint8_t sumFloat(uint8_t *vd, const uint8_t *vs2, const uint8_t *vs1, uint64_t vl, const alu::Alu &alu, uint8_t rm) {
+    using Format = FpFormat<F>;
+    using Bits = typename Format::Bits;
+    uint64_t sum = Format::widen(element<Bits>(vs1, 0));
+    uint8_t flags = 0;
+    for (uint64_t i = 0; i < vl; ++i) {
+        uint8_t raised;
+        std::tie(sum, raised) = alu.fpexecute(Format::kAdd, sum, Format::widen(element<Bits>(vs2, i)), 0, rm);
+        flags |= raised;
+    }
+    setElement<Bits>(vd, 0, static_cast<Bits>(sum));
+    return flags;
+}
+
+uint64_t readElement(MemoryController &memory, uint64_t address, unsigned int bytes) {
+    switch (bytes) {
+        case 1: return memory.ReadByte(address);
+        case 2: return memory.ReadHalfWord(address);
+        case 4: return memory.ReadWord(address);
+        default: return memory.ReadDoubleWord(address);
+    }
+}
+
+void writeElement(MemoryController &memory, uint64_t address, unsigned int bytes, uint64_t value) {
+    switch (bytes) {
+        case 1: memory.WriteByte(address, static_cast<uint8_t>(value)); break;
+        case 2: memory.WriteHalfWord(address, static_cast<uint16_t>(value)); break;
+        case 4: memory.WriteWord(address, static_cast<uint32_t>(value)); break;
+        default: memory.WriteDoubleWord(address, value); break;
+    }
+}
+
+} // namespace
+
+VType decodeVType(uint64_t vtype) {
+    VType type;
+    unsigned int vlmul = vtype & 0b111;
+    unsigned int vsew = (vtype >> 3) & 0b111;
+    if ((vtype >> 8) != 0 || vsew > 0b011 || vlmul > 0b011) {    // vill, reserved bits, SEW 128+, fractional LMUL
+        return type;
+    }
+    type.sew_bytes = 1u << vsew;
+    type.lmul = 1u << vlmul;
+    type.vill = false;
+    return type;
+}
+
+uint64_t vlmax(const VType &type, std::size_t register_words) {
+    return type.vill ? 0 : register_words * 8 * type.lmul / type.sew_bytes;
+}
+
+Config configure(uint32_t instruction, uint64_t rs1_value, uint64_t rs2_value, const RegisterFile &registers) {
+    Instruction instr = decoder::decode(instruction).instr;
+    unsigned int rd = (instruction >> 7) & 0b11111;
+    unsigned int rs1 = (instruction >> 15) & 0b11111;
+    uint64_t vtype;
+    switch (instr) {
+        case Instruction::kvsetvli: vtype = (instruction >> 20) & 0x7ff; break;
+        case Instruction::kvsetivli: vtype = (instruction >> 20) & 0x3ff; break;
+        default: vtype = rs2_value; break;
+    }
+    VType type = decodeVType(vtype);
+    if (type.vill) {
+        return {};
+    }
+    uint64_t max = vlmax(type, registers.VectorRegisterWords());
+    uint64_t avl;
+    if (instr == Instruction::kvsetivli) {
+        avl = rs1;                                      // uimm
+    } else if (rs1 != 0) {
+        avl = rs1_value;
+    } else {
+        avl = rd != 0 ? max : registers.VectorLength(); // rs1 = x0: VLMAX, or keep vl when rd is x0 too
+    }
+    return {std::min(avl, max), vtype};
+}
+
+bool isConfig(uint32_t instruction) {
+    return (instruction & 0b1111111) == 0b1010111 && ((instruction >> 12) & 0b111) == 0b111;
+}
+
+bool readsScalarRs2(uint32_t instruction) {
+    if (isConfig(instruction)) {
+        return (instruction >> 30) == 0b10;             // vsetvl
+    }
+    return isMemory(instruction) && isStrided(instruction);
+}
+
+bool isLegal(uint32_t instruction, const RegisterFile &registers) {
+    if (isConfig(instruction)) {
+        return true;
+    }
+    VType type = decodeVType(registers.VectorType());
+    if (type.vill) {
+        return false;
+    }
+    unsigned int vd = (instruction >> 7) & 0b11111;
+    unsigned int vs1 = (instruction >> 15) & 0b11111;
+    unsigned int vs2 = (instruction >> 20) & 0b11111;
+    auto aligned = [](unsigned int reg, unsigned int group) { return reg % group == 0; };
+
+    if (isMemory(instruction)) {
+        unsigned int emul_times_sew = memoryElementBytes(instruction) * type.lmul;   // EMUL = EEW / SEW * LMUL
+        if (emul_times_sew < type.sew_bytes || emul_times_sew > 8 * type.sew_bytes) {
+            return false;
+        }
+        return aligned(vd, emul_times_sew / type.sew_bytes);
+    }
+
+    Instruction instr = decoder::decode(instruction).instr;
+    unsigned int funct3 = (instruction >> 12) & 0b111;
+    if ((funct3 == 0b001 || funct3 == 0b101) && type.sew_bytes < 4) {
+        return false;
+    }
+    if (isReduction(instr)) {                           // vd and vs1 are single registers
+        return aligned(vs2, type.lmul);
+    }
+    bool vs1_is_vector = funct3 == 0b000 || funct3 == 0b001 || funct3 == 0b010;
+    return aligned(vd, type.lmul) && (isSplat(instr) || aligned(vs2, type.lmul))
+        && (!vs1_is_vector || aligned(vs1, type.lmul));
+}
+
+Footprint footprint(uint32_t instruction, const RegisterFile &registers, uint64_t rs1_value, uint64_t rs2_value) {
+    Footprint result;
+    uint64_t vl = registers.VectorLength();
+    if (isConfig(instruction) || vl == 0 || !isLegal(instruction, registers)) {
+        return result;
+    }
+    unsigned int element_bytes = isMemory(instruction) ? memoryElementBytes(instruction)
+                                                       : decodeVType(registers.VectorType()).sew_bytes;
+    if (isStore(instruction)) {
+        result.address = rs1_value;
+        result.stride = isStrided(instruction) ? static_cast<int64_t>(rs2_value) : element_bytes;
+        result.element_bytes = element_bytes;
+        result.elements = vl;
+        return result;
+    }
+    unsigned int vd = (instruction >> 7) & 0b11111;
+    result.first_word = vd * registers.VectorRegisterWords();
+    result.words = isReduction(decoder::decode(instruction).instr) ? 1 : (vl * element_bytes + 7) / 8;
+    return result;
+}
+
+uint8_t execute(uint32_t instruction, RegisterFile &registers, MemoryController &memory, const alu::Alu &alu,
+                uint64_t rs1_value, uint64_t rs2_value) {
+    uint64_t vl = registers.VectorLength();
+    if (vl == 0) {
+        return 0;
+    }
+    auto group = [&registers](unsigned int reg) { return reinterpret_cast<uint8_t *>(registers.VectorRegister(reg)); };
+    uint8_t *vd = group((instruction >> 7) & 0b11111);
+    const uint8_t *vs1 = group((instruction >> 15) & 0b11111);
+    const uint8_t *vs2 = group((instruction >> 20) & 0b11111);
+
+    if (isMemory(instruction)) {
+        unsigned int bytes = memoryElementBytes(instruction);
+        uint64_t stride = isStrided(instruction) ? rs2_value : bytes;
+        for (uint64_t i = 0; i < vl; ++i) {
+            uint64_t address = rs1_value + i * stride;
+            if (isStore(instruction)) {
+                uint64_t value = 0;
+                std::memcpy(&value, vd + i * bytes, bytes);
+                writeElement(memory, address, bytes, value);
+            } else {
+                uint64_t value = readElement(memory, address, bytes);
+                std::memcpy(vd + i * bytes, &value, bytes);
+            }
+        }
+        return 0;
+    }
+
+    unsigned int sew_bytes = decodeVType(registers.VectorType()).sew_bytes;
+    Instruction instr = decoder::decode(instruction).instr;
+    uint64_t scalar = rs1_value;
+    if (((instruction >> 12) & 0b111) == 0b011) {      // .vi, simm5
+        scalar = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(instruction << 12) >> 27));
+    } else if (((instruction >> 12) & 0b111) == 0b101 && sew_bytes == 4) {
+        scalar = (rs1_value & kBoxMask) == kBoxMask ? static_cast<uint32_t>(rs1_value) : kCanonicalNaN32;
+    }
+    uint8_t rm = registers.ReadCsr(0x002) & 0b111;     // frm
+
+    uint8_t flags = 0;
+    auto integer = [&](IntOp op, const uint8_t *va, const uint8_t *vb) {
+        withElementType(sew_bytes, [&](auto tag) { mapInt<decltype(tag)>(op, vd, va, vb, scalar, vl); });
+    };
+    auto floating = [&](FpOp op, const uint8_t *vb) {
+        flags = sew_bytes == 4 ? mapFloat<float>(op, vd, vs2, vb, scalar, vl, alu, rm)
+                               : mapFloat<double>(op, vd, vs2, vb, scalar, vl, alu, rm);
+    };
+
+    switch (instr) {
+        case Instruction::kvadd_vv: integer(IntOp::kAdd, vs2, vs1); break;
+        case Instruction::kvadd_vx:
+        case Instruction::kvadd_vi: integer(IntOp::kAdd, vs2, nullptr); break;
+        case Instruction::kvsub_vv: integer(IntOp::kSub, vs2, vs1); break;
+        case Instruction::kvsub_vx: integer(IntOp::kSub, vs2, nullptr); break;
+        case Instruction::kvmul_vv: integer(IntOp::kMul, vs2, vs1); break;
+        case Instruction::kvmul_vx: integer(IntOp::kMul, vs2, nullptr); break;
+        case Instruction::kvmacc_vv: integer(IntOp::kMacc, vs2, vs1); break;
+        case Instruction::kvmacc_vx: integer(IntOp::kMacc, vs2, nullptr); break;
+        case Instruction::kvmv_v_v: integer(IntOp::kMove, nullptr, vs1); break;
+        case Instruction::kvmv_v_x:
+        case Instruction::kvmv_v_i:
+        case Instruction::kvfmv_v_f: integer(IntOp::kMove, nullptr, nullptr); break;
+        case Instruction::kvredsum_vs:
+            withElementType(sew_bytes, [&](auto tag) { sumInt<decltype(tag)>(vd, vs2, vs1, vl); });
+            break;
+
+        case Instruction::kvfadd_vv: floating(FpOp::kAdd, vs1); break;
+        case Instruction::kvfadd_vf: floating(FpOp::kAdd, nullptr); break;
+        case Instruction::kvfsub_vv: floating(FpOp::kSub, vs1); break;
+        case Instruction::kvfsub_vf: floating(FpOp::kSub, nullptr); break;
+        case Instruction::kvfmul_vv: floating(FpOp::kMul, vs1); break;
+        case Instruction::kvfmul_vf: floating(FpOp::kMul, nullptr); break;
+        case Instruction::kvfmacc_vv: floating(FpOp::kMacc, vs1); break;
+        case Instruction::kvfmacc_vf: floating(FpOp::kMacc, nullptr); break;
+        case Instruction::kvfredusum_vs:
+        case Instruction::kvfredosum_vs:
+            flags = sew_bytes == 4 ? sumFloat<float>(vd, vs2, vs1, vl, alu, rm)
+                                   : sumFloat<double>(vd, vs2, vs1, vl, alu, rm);
+            break;
+        default:
+            break;
+    }
+    return flags;
+}
+
+unsigned int occupancy(uint32_t instruction, const RegisterFile &registers, uint64_t lanes) {
+    uint64_t element_bytes = isMemory(instruction) ? memoryElementBytes(instruction)
+                                                   : decodeVType(registers.VectorType()).sew_bytes;
+    uint64_t lane_bytes = 8 * lanes;
+    uint64_t cycles = (registers.VectorLength() * element_bytes + lane_bytes - 1) / lane_bytes;
+    return static_cast<unsigned int>(std::max<uint64_t>(cycles, 1));
+}
+
+} // namespace vector_unit
@@ -5,31 +5,81 @@
  */
 
 #include "vm/vm_base.h"
+#include "vm/lockstep_checker.h"
+#include "vm/state_file.h"
+#include "vm/decoder.h"
+#include "vm/hart_group.h"
 
 #include "globals.h"
+#include "utils.h"
 #include "config.h"
 
 #include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
 #include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
 
 VmBase::VmBase(bool silent) : silent_mode_(silent) {
+  registers_.BindCounters(&cycle_s_, &instructions_retired_);
+}
+
+VmBase::~VmBase() = default;
 
+namespace {
+  // throws if vm would not execute the instruction at address, see VmBase::ExecutesFpCsr, VmBase::ExecutesVector and
+  // VmBase::ExecutesAtomic
+  void checkSupported(const VmBase &vm, uint32_t instruction, uint64_t address) {
+    if (vm.ExecutesFpCsr() && vm.ExecutesVector() && vm.ExecutesAtomic()) {
+      return;
+    }
+    const decoder::DecodedOp &op = decoder::decode(instruction);
+    const char *kind = nullptr;
+    const char *pipelines = "single_stage, or multi_stage with branch_stage ex and issue_width 1";
+    if (!vm.ExecutesFpCsr() && (op.is_float || op.is_double || op.is_csr || op.is_syscall)) {
+      kind = "F/D, Zicsr or ecall";
+    } else if (!vm.ExecutesVector() && op.is_vector) {
+      kind = "a vector instruction";
+    } else if (!vm.ExecutesAtomic() && op.is_atomic) {
+      kind = "an atomic instruction";
+      pipelines = "single_stage or multi_stage";
+    }
+    if (kind != nullptr) {
+      std::ostringstream message;
+      message << "Instruction 0x" << std::hex << std::setw(8) << std::setfill('0') << instruction << " at 0x" << address
+              << " is " << kind << ", which this pipeline does not execute. Run the program with processor_type "
+              << pipelines << ".";
+      throw std::runtime_error(message.str());
+    }
+  }
 }
 
 void VmBase::LoadProgram(const AssembledProgram &program) {
+  for (unsigned int i = 0; i < program.text_buffer.size(); ++i) {
+    uint32_t instruction = program.text_buffer[i];
+    if (decoder::isCompressed(instruction)) {
+      instruction = decoder::expandCompressed(static_cast<uint16_t>(instruction));
+    }
+    checkSupported(*this, instruction, program.InstructionAddress(i));
+  }
+
   program_ = program;
-  unsigned int counter = 0;
-  for (const auto &instruction: program.text_buffer) {
-    memory_controller_.WriteWord(counter, instruction);
-      counter += 4;
+  for (unsigned int i = 0; i < program.text_buffer.size(); ++i) {
+    uint32_t instruction = program.text_buffer[i];
+    if (decoder::isCompressed(instruction)) {
+      memory_controller_.WriteHalfWord(program.InstructionAddress(i), static_cast<uint16_t>(instruction));
+    } else {
+      memory_controller_.WriteWord(program.InstructionAddress(i), instruction);
+    }
   }
-  program_size_ = counter;
+  program_size_ = program.TextSize();
   AddBreakpoint(program_size_, false);  // address
 
   unsigned int data_counter = 0;
@@ -83,6 +133,10 @@ void VmBase::LoadProgram(const AssembledProgram &program) {
   std::cout << "VM_PROGRAM_LOADED" << std::endl;
   output_status_ = "VM_PROGRAM_LOADED";
 
+  if (vm_config::config.getLockstepCheck()) {
+    EnableLockstepCheck();
+  }
+
   if(!silent_mode_) {
     DumpState(globals::vm_state_dump_file_path);
   }
@@ -93,6 +147,61 @@ void VmBase::SetProgramSize(uint64_t size) {
     program_size_ = size;
 }
 
+void VmBase::CheckProgramSupported() {
+    uint8_t length = 4;
+    for (uint64_t pc = 0; pc < program_size_; pc += length) {
+        checkSupported(*this, FetchInstruction(pc, length), pc);
+    }
+}
+
+void VmBase::ReportCsrAccess(uint16_t csr, bool write, uint64_t pc) const {
+    switch (CheckCsrAccess(csr, write)) {
+        case CsrAccess::kReadOnly:
+            std::cerr << "VM Error: Write to read-only CSR " << FindCsr(csr)->name << " (0x" << std::hex << csr
+                      << ") at 0x" << pc << std::dec << ", ignored." << std::endl;
+            break;
+        case CsrAccess::kUnimplemented:
+            std::cerr << "VM Error: Unimplemented CSR 0x" << std::hex << csr << " at 0x" << pc << std::dec
+                      << ", it reads 0 and ignores writes." << std::endl;
+            break;
+        case CsrAccess::kOk:
+            break;
+    }
+}
+
+void VmBase::EnableLockstepCheck() {
+    lockstep_checker_ = std::make_unique<LockstepChecker>(*this);
+}
+
+bool VmBase::LockstepDiverged() const {
+    return lockstep_checker_ && lockstep_checker_->diverged();
+}
+
+bool VmBase::CheckRetired(const RetiredInstruction &retired) {
+    if (!lockstep_checker_ || lockstep_checker_->diverged()) {
+        return !lockstep_checker_;
+    }
+    if (lockstep_checker_->check(retired)) {
+        return true;
+    }
+    std::cerr << lockstep_checker_->report();
+    output_status_ = "VM_LOCKSTEP_DIVERGED";
+    RequestStop();
+    return false;
+}
+
+bool VmBase::CheckLockstepEnd() {
+    if (!lockstep_checker_ || lockstep_checker_->diverged()) {
+        return !lockstep_checker_;
+    }
+    if (lockstep_checker_->checkEnd()) {
+        return true;
+    }
+    std::cerr << lockstep_checker_->report();
+    output_status_ = "VM_LOCKSTEP_DIVERGED";
+    return false;
+}
+
 // moved functions related to std::atomic<bool> stop_requested_ = false to vm_base
 void VmBase::RequestStop() {
     stop_requested_ = true;
@@ -114,6 +223,16 @@ void VmBase::UpdateProgramCounter(int64_t value) {
     program_counter_ = static_cast<uint64_t>(static_cast<int64_t>(program_counter_) + value);
 }
 
+uint32_t VmBase::FetchInstruction(uint64_t pc, uint8_t &length) {
+    uint32_t instruction = memory_controller_.ReadWord(pc);
+    if (decoder::isCompressed(instruction)) {
+        length = 2;
+        return decoder::expandCompressed(static_cast<uint16_t>(instruction));
+    }
+    length = 4;
+    return instruction;
+}
+
 auto sign_extend = [](uint32_t value, unsigned int bits) -> int32_t {
     int32_t mask = 1 << (bits - 1);
     return (value ^ mask) - mask;
@@ -122,28 +241,19 @@ auto sign_extend = [](uint32_t value, unsigned int bits) -> int32_t {
 
 int32_t VmBase::ImmGenerator(uint32_t instruction) {
     int32_t imm = 0;
-    uint8_t opcode = instruction & 0b1111111;
-
-    switch (opcode) {
-        /*** I-TYPE (Load, alu Immediate, JALR, FPU Loads) ***/
-        case 0b0010011: // alu Immediate (ADDI, SLTI, SLTIU, XORI, ORI, ANDI, SLLI, SRLI, SRAI)
-        case 0b0000011: // Load (LB, LH, LW, LD, LBU, LHU, LWU)
-        case 0b1100111: // JALR
-        case 0b0001111: // FENCE
-        case 0b0000111: // FLW, FLD (Floating-point load)
+
+    switch (decoder::decode(instruction).imm_format) {
+        case decoder::ImmFormat::kI: // alu Immediate, Load, JALR, FPU Loads
             imm = (instruction >> 20) & 0xFFF;
             imm = sign_extend(imm, 12);
             break;
 
-        /*** S-TYPE (Store, Floating-Point Store) ***/
-        case 0b0100011: // Store (SB, SH, SW, SD)
-        case 0b0100111: // FSW, FSD (Floating-point store)
+        case decoder::ImmFormat::kS: // Store, Floating-point store
             imm = ((instruction >> 7) & 0x1F) | ((instruction >> 25) & 0x7F) << 5;
             imm = sign_extend(imm, 12);
             break;
 
-        /*** SB-TYPE (branch_ Instructions) ***/
-        case 0b1100011: // branch_ (BEQ, BNE, BLT, BGE, BLTU, BGEU)
+        case decoder::ImmFormat::kB: // branch_ (BEQ, BNE, BLT, BGE, BLTU, BGEU)
             imm = ((instruction >> 8) & 0xF) // Bits 11:8
                   | ((instruction >> 25) & 0x3F) << 4 // Bits 10:5
                   | ((instruction >> 7) & 0x1) << 10 // Bit 4
@@ -152,40 +262,20 @@ int32_t VmBase::ImmGenerator(uint32_t instruction) {
             imm = sign_extend(imm, 13);
             break;
 
-        /*** U-TYPE (LUI, AUIPC) ***/
-        case 0b0110111: // LUI
-        case 0b0010111: // AUIPC
+        case decoder::ImmFormat::kU: // LUI, AUIPC
             imm = (instruction & 0xFFFFF000) >> 12;  // Upper 20 bits
-            
             break;
 
-        /*** J-TYPE (JAL) ***/
-        case 0b1101111: // JAL
+        case decoder::ImmFormat::kJ: // JAL
             imm = ((instruction >> 21) & 0x3FF)  // Bits 10:1
                 | ((instruction >> 20) & 0x1) << 10  // Bit 11
                 | ((instruction >> 12) & 0xFF) << 11  // Bits 19:12
                 | ((instruction >> 31) & 0x1) << 19;  // Bit 20
             imm <<= 1;  // Shift left by 1
-            // if (imm & 0x1000) {
-            //    imm |= 0xFFFFE000;
-            // }
-            imm = sign_extend(imm, 21); // Might be 20
-            break;
-
-        /*** M-EXTENSION (Multiplication, Division) - R-TYPE ***/
-        case 0b0110011: // kMul, kMulh, kMulhu, kMulhsu, kDiv, kDivu, kRem, kRemu
-            // R-Type (no immediate needed)
-            imm = 0;
-            break;
-
-        /*** F-EXTENSION (Floating Point Operations) - R-TYPE ***/
-        case 0b1010011: // Floating-point (FADD, FSUB, FMUL, FDIV, FSQRT, etc.)
-            // R-Type (no immediate needed)
-            imm = 0;
+            imm = sign_extend(imm, 21);
             break;
 
-
-        default:
+        default: // R-Type, R4-Type and SYSTEM (no immediate needed)
             imm = 0;
             break;
     }
@@ -202,15 +292,15 @@ void VmBase::AddBreakpoint(uint64_t val, bool is_line) {
             return;
         }
         uint64_t line = val;
-        uint64_t bp = program_.line_number_instruction_number_mapping[line] * 4;
+        uint64_t bp = program_.InstructionAddress(program_.line_number_instruction_number_mapping[line]);
         if (CheckBreakpoint(bp)) {
             std::cerr << "Breakpoint already exists at line: " << line << std::endl;
             return;
         }
         breakpoints_.emplace_back(bp);
     } else {
-        if (val % 4 != 0) {
-            std::cerr << "Invalid instruction address: " << val << ". Must be a multiple of 4." << std::endl;
+        if (val % 2 != 0) {
+            std::cerr << "Invalid instruction address: " << val << ". Must be a multiple of 2." << std::endl;
             return;
         }
         if (CheckBreakpoint(val)) {
@@ -232,15 +322,15 @@ void VmBase::RemoveBreakpoint(uint64_t val, bool is_line) {
             return;
         }
         uint64_t line = val;
-        uint64_t bp = program_.line_number_instruction_number_mapping[line] * 4;
+        uint64_t bp = program_.InstructionAddress(program_.line_number_instruction_number_mapping[line]);
         if (!CheckBreakpoint(bp)) {
             std::cerr << "No breakpoint exists at line: " << line << std::endl;
             return;
         }
         breakpoints_.erase(std::remove(breakpoints_.begin(), breakpoints_.end(), bp), breakpoints_.end());
     } else {
-        if (val % 4 != 0) {
-            std::cerr << "Invalid instruction address: " << val << ". Must be a multiple of 4." << std::endl;
+        if (val % 2 != 0) {
+            std::cerr << "Invalid instruction address: " << val << ". Must be a multiple of 2." << std::endl;
             return;
         }
         if (!CheckBreakpoint(val)) {
@@ -260,14 +350,175 @@ bool VmBase::CheckBreakpoint(uint64_t address) {
 
 
 void VmBase::PrintString(uint64_t address) {
+    std::ostream &out = console_ ? *console_ : std::cout;
     while (true) {
         char c = memory_controller_.ReadByte(address);
         if (c == '\0') break;
-        std::cout << c;
+        out << c;
         address++;
     }
 }
 
+void VmBase::HandleSyscall() {
+  uint64_t syscall_number = registers_.ReadGpr(17);
+  std::ostream &out = console_ ? *console_ : std::cout;
+  if (forked_) {
+    if (syscall_number == SYSCALL_EXIT) {
+      stop_requested_ = true;
+      output_status_ = "VM_EXIT";
+    } else if (syscall_number == SYSCALL_READ) {
+      registers_.WriteGpr(10, 0);
+    } else if (syscall_number == SYSCALL_WRITE) {
+      registers_.WriteGpr(10, registers_.ReadGpr(12));
+    }
+    return;
+  }
+
+  switch (syscall_number) {
+    case SYSCALL_PRINT_INT: {
+        if (!globals::vm_as_backend) {
+            out << "[Syscall output: ";
+        } else {
+          out << "VM_STDOUT_START";
+        }
+        out << static_cast<int64_t>(registers_.ReadGpr(10)); // Print signed integer
+        if (!globals::vm_as_backend) {
+            out << "]" << std::endl;
+        } else {
+          out << "VM_STDOUT_END" << std::endl;
+        }
+        break;
+    }
+    case SYSCALL_PRINT_FLOAT: { // print float
+        if (!globals::vm_as_backend) {
+            out << "[Syscall output: ";
+        } else {
+          out << "VM_STDOUT_START";
+        }
+        float float_value;
+        uint64_t raw = registers_.ReadGpr(10);
+        std::memcpy(&float_value, &raw, sizeof(float_value));
+        out << std::setprecision(std::numeric_limits<float>::max_digits10) << float_value;
+        if (!globals::vm_as_backend) {
+            out << "]" << std::endl;
+        } else {
+          out << "VM_STDOUT_END" << std::endl;
+        }
+        break;
+    }
+    case SYSCALL_PRINT_DOUBLE: { // print double
+        if (!globals::vm_as_backend) {
+            out << "[Syscall output: ";
+        } else {
+          out << "VM_STDOUT_START";
+        }
+        double double_value;
+        uint64_t raw = registers_.ReadGpr(10);
+        std::memcpy(&double_value, &raw, sizeof(double_value));
+        out << std::setprecision(std::numeric_limits<double>::max_digits10) << double_value;
+        if (!globals::vm_as_backend) {
+            out << "]" << std::endl;
+        } else {
+          out << "VM_STDOUT_END" << std::endl;
+        }
+        break;
+    }
+    case SYSCALL_PRINT_STRING: {
+        if (!globals::vm_as_backend) {
+            out << "[Syscall output: ";
+        }
+        PrintString(registers_.ReadGpr(10)); // Print string
+        if (!globals::vm_as_backend) {
+            out << "]" << std::endl;
+        }
+        break;
+    }
+    case SYSCALL_EXIT: {
+        stop_requested_ = true; // Stop the VM
+        if (!globals::vm_as_backend) {
+            out << "VM_EXIT" << std::endl;
+        }
+        output_status_ = "VM_EXIT";
+        out << "Exited with exit code: " << registers_.ReadGpr(10) << std::endl;
+        if (hart_group_) {
+          break;        // only this hart stops, the others run on
+        }
+        exit(0); // Exit the program
+        break;
+    }
+    case SYSCALL_READ: { // Read
+      uint64_t file_descriptor = registers_.ReadGpr(10);
+      uint64_t buffer_address = registers_.ReadGpr(11);
+      uint64_t length = registers_.ReadGpr(12);
+
+      if (file_descriptor == 0 && hart_group_) {
+        registers_.WriteGpr(10, 0);     // the harts have no stdin, a read sees its end
+      } else if (file_descriptor == 0) {
+        // Read from stdin
+        std::string input;
+        {
+          out << "VM_STDIN_START" << std::endl;
+          output_status_ = "VM_STDIN_START";
+          std::unique_lock<std::mutex> lock(input_mutex_);
+          input_cv_.wait(lock, [this]() { 
+            return !input_queue_.empty(); 
+          });
+          output_status_ = "VM_STDIN_END";
+          out << "VM_STDIN_END" << std::endl;
+
+          input = input_queue_.front();
+          input_queue_.pop();
+        }
+
+
+        for (size_t i = 0; i < input.size() && i < length; ++i) {
+          memory_controller_.WriteByte(buffer_address + i, static_cast<uint8_t>(input[i]));
+        }
+        if (input.size() < length) {
+          memory_controller_.WriteByte(buffer_address + input.size(), '\0');
+        }
+
+        registers_.WriteGpr(10, std::min(static_cast<uint64_t>(length), static_cast<uint64_t>(input.size())));
+
+      } else {
+          std::cerr << "Unsupported file descriptor: " << file_descriptor << std::endl;
+      }
+      break;
+    }
+    case SYSCALL_WRITE: { // Write
+        uint64_t file_descriptor = registers_.ReadGpr(10);
+        uint64_t buffer_address = registers_.ReadGpr(11);
+        uint64_t length = registers_.ReadGpr(12);
+
+        if (file_descriptor == 1) { // stdout
+          out << "VM_STDOUT_START";
+          output_status_ = "VM_STDOUT_START";
+          uint64_t bytes_printed = 0;
+          for (uint64_t i = 0; i < length; ++i) {
+              char c = memory_controller_.ReadByte(buffer_address + i);
+              // if (c == '\0') {
+              //     break;
+              // }
+              out << c;
+              bytes_printed++;
+          }
+          out << std::flush; 
+          output_status_ = "VM_STDOUT_END";
+          out << "VM_STDOUT_END" << std::endl;
+
+          registers_.WriteGpr(10, std::min(static_cast<uint64_t>(length), bytes_printed));
+        } else {
+            std::cerr << "Unsupported file descriptor: " << file_descriptor << std::endl;
+        }
+        break;
+    }
+    default: {
+      std::cerr << "Unknown syscall number: " << syscall_number << std::endl;
+      break;
+    }
+  }
+}
+
 void VmBase::DumpState(const std::filesystem::path &filename) {
     std::ofstream file(filename);
     if (!file.is_open()) {
@@ -280,7 +531,7 @@ void VmBase::DumpState(const std::filesystem::path &filename) {
 
     // Access 'program_' only if it has been initialized. (will not be in testing) 
     if (!program_.instruction_number_line_number_mapping.empty()) {
-        instruction_number = program_counter_ / 4;
+        instruction_number = program_.InstructionNumber(program_counter_);
         current_line = program_.instruction_number_line_number_mapping[instruction_number];
     }
 
@@ -305,13 +556,17 @@ void VmBase::DumpState(const std::filesystem::path &filename) {
     file << "    \"branch_mispredictions\": " << branch_mispredictions_ << ",\n";
     file << "    \"breakpoints\": [";
     for (size_t i = 1; i < breakpoints_.size(); ++i) {
-        program_.instruction_number_line_number_mapping[breakpoints_[i] / 4];
-        file << program_.instruction_number_line_number_mapping[breakpoints_[i] / 4];
+        file << program_.instruction_number_line_number_mapping[program_.InstructionNumber(breakpoints_[i])];
         if (i < breakpoints_.size() - 1) {
             file << ", ";
         }
     }
     file << "],\n";
+    file << "    \"hart_id\": " << registers_.ReadCsr(0xf14) << ",\n";
+    if (hart_group_) {
+        hart_group_->DumpHartCounters(file, "    ");
+        file << ",\n";
+    }
     file << "    \"output_status\": \"" << output_status_ << "\"\n";
     file << "}\n";
     file.close();
@@ -322,6 +577,230 @@ void VmBase::ModifyRegister(const std::string &reg_name, uint64_t value) {
     registers_.ModifyRegister(reg_name, value);
 }
 
+void VmBase::Seek(uint64_t instruction) {
+    (void)instruction;
+    std::cerr << "Seek is only available in single stage mode." << std::endl;
+}
+
+void VmBase::ForkFrom(const VmBase &parent) {
+    program_ = parent.program_;
+    program_size_ = parent.program_size_;
+    program_counter_ = parent.ResumePc();
+    registers_ = parent.registers_;
+    memory_controller_ = parent.memory_controller_;     // copies the block table only, the blocks stay shared
+    reservation_ = parent.reservation_;
+    silent_mode_ = true;
+    forked_ = true;
+}
+
+bool VmBase::SaveState(const std::filesystem::path &filename, bool compress) {
+    StateWriter writer(filename, compress ? state_file::kFlagCompressed : 0, vm_config::config.getMemoryBlockSize());
+
+    writer.beginSection(state_file::kTagCounters);
+    writer.write(ResumePc());
+    writer.write(program_size_);
+    writer.write(static_cast<uint64_t>(cycle_s_));
+    writer.write(static_cast<uint64_t>(instructions_retired_));
+    writer.write(static_cast<uint64_t>(stall_cycles_));
+    writer.write(static_cast<uint64_t>(branch_mispredictions_));
+    writer.write(cpi_);
+    writer.write(ipc_);
+    writer.write(static_cast<uint32_t>(StallAccounting::kNumReasons));
+    for (std::size_t i = 0; i < StallAccounting::kNumReasons; ++i) {
+        writer.write(stall_accounting_.Get(static_cast<StallReason>(i)));
+    }
+    writer.endSection();
+
+    writer.beginSection(state_file::kTagRegisters);
+    for (std::size_t i = 0; i < 32; ++i) {
+        writer.write(registers_.ReadGpr(i));
+    }
+    for (std::size_t i = 0; i < 32; ++i) {
+        writer.write(registers_.ReadFpr(i));
+    }
+    writer.endSection();
+
+    writer.beginSection(state_file::kTagVectors);
+    writer.write(static_cast<uint64_t>(registers_.VectorRegisterWords() * 64));
+    writer.write(registers_.VectorLength());
+    writer.write(registers_.VectorType());
+    for (uint64_t word : registers_.GetVectorValues()) {
+        writer.write(word);
+    }
+    writer.endSection();
+
+    // only the writable csrs that are set, the read-only counters follow the counters section
+    std::vector<std::pair<uint16_t, uint64_t>> csrs;
+    for (const CsrInfo &csr : implemented_csrs) {
+        if (csr.write_mask != 0 && registers_.ReadCsr(csr.address) != 0) {
+            csrs.emplace_back(csr.address, registers_.ReadCsr(csr.address));
+        }
+    }
+    writer.beginSection(state_file::kTagCsrs);
+    writer.write(static_cast<uint32_t>(csrs.size()));
+    for (const auto &[address, value] : csrs) {
+        writer.write(address);
+        writer.write(value);
+    }
+    writer.endSection();
+
+    // blocks are only ever allocated by a write, the ones left all zero are not saved
+    Memory::Snapshot memory = memory_controller_.TakeSnapshot();
+    std::vector<uint64_t> block_indices;
+    for (const auto &[index, block] : memory) {
+        if (std::any_of(block.data->begin(), block.data->end(), [](uint8_t byte) { return byte != 0; })) {
+            block_indices.push_back(index);
+        }
+    }
+    std::sort(block_indices.begin(), block_indices.end());
+    writer.beginSection(state_file::kTagMemory);
+    writer.write(static_cast<uint64_t>(block_indices.size()));
+    for (uint64_t index : block_indices) {
+        writer.writeBlock(index, *memory.at(index).data);
+    }
+    writer.endSection();
+
+    writer.beginSection(state_file::kTagBranchProfile);
+    writer.write(static_cast<uint64_t>(branch_profile_.GetStats().size()));
+    for (const auto &[pc, stats] : branch_profile_.Sorted()) {
+        writer.write(pc);
+        writer.write(stats);
+    }
+    writer.endSection();
+
+    SaveMicroarchState(writer);
+
+    if (!writer.good()) {
+        std::cerr << "Error writing the vm state to: " << filename.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool VmBase::LoadState(const std::filesystem::path &filename) {
+    StateReader reader(filename);
+    if (!reader.good()) {
+        std::cerr << "Not a vm state file: " << filename.string() << std::endl;
+        return false;
+    }
+    if (reader.version() > state_file::kVersion) {
+        std::cerr << "Unsupported vm state file version: " << reader.version() << std::endl;
+        return false;
+    }
+    if (reader.blockSize() != vm_config::config.getMemoryBlockSize()) {
+        std::cerr << "The vm state was saved with a memory block size of " << reader.blockSize() << std::endl;
+        return false;
+    }
+
+    Reset();
+    lockstep_checker_.reset();          // the golden vm would have to start at a retirement boundary
+
+    uint32_t tag = 0;
+    uint64_t length = 0;
+    while (reader.nextSection(tag, length)) {
+        if (tag == state_file::kTagCounters) {
+            uint64_t cycles = 0, instructions = 0, stalls = 0, mispredictions = 0;
+            uint32_t reasons = 0;
+            reader.read(program_counter_);
+            reader.read(program_size_);
+            reader.read(cycles);
+            reader.read(instructions);
+            reader.read(stalls);
+            reader.read(mispredictions);
+            reader.read(cpi_);
+            reader.read(ipc_);
+            reader.read(reasons);
+            cycle_s_ = static_cast<unsigned int>(cycles);
+            instructions_retired_ = static_cast<unsigned int>(instructions);
+            stall_cycles_ = static_cast<unsigned int>(stalls);
+            branch_mispredictions_ = static_cast<unsigned int>(mispredictions);
+            stall_accounting_.Clear();
+            for (uint32_t i = 0; i < reasons; ++i) {
+                uint64_t lost = 0;
+                if (reader.read(lost) && i < StallAccounting::kNumReasons && lost > 0) {
+                    stall_accounting_.Record(static_cast<StallReason>(i), lost);
+                }
+            }
+        } else if (tag == state_file::kTagRegisters) {
+            uint64_t value = 0;
+            for (std::size_t i = 0; i < 32 && reader.read(value); ++i) {
+                registers_.WriteGpr(i, value);
+            }
+            for (std::size_t i = 0; i < 32 && reader.read(value); ++i) {
+                registers_.WriteFpr(i, value);
+            }
+        } else if (tag == state_file::kTagVectors) {
+            uint64_t vlen = 0, vl = 0, vtype = 0;
+            reader.read(vlen);
+            reader.read(vl);
+            reader.read(vtype);
+            if (vlen != registers_.VectorRegisterWords() * 64) {     // the register file is left reset
+                std::cerr << "The vm state was saved with a VLEN of " << vlen << ", vector registers not restored" << std::endl;
+                reader.skipSection();
+                continue;
+            }
+            std::vector<uint64_t> words(registers_.GetVectorValues().size());
+            for (uint64_t &word : words) {
+                reader.read(word);
+            }
+            registers_.SetVectorState(words, vl, vtype);
+        } else if (tag == state_file::kTagCsrs) {
+            uint32_t count = 0;
+            reader.read(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                uint16_t address = 0;
+                uint64_t value = 0;
+                if (reader.read(address) && reader.read(value) && address < 4096) {
+                    registers_.WriteCsr(address, value);
+                }
+            }
+        } else if (tag == state_file::kTagMemory) {
+            uint64_t count = 0;
+            reader.read(count);
+            Memory::Snapshot memory;
+            for (uint64_t i = 0; i < count && reader.good(); ++i) {
+                MemoryBlock block;
+                uint64_t index = 0;
+                reader.readBlock(index, *block.data);
+                memory.emplace(index, std::move(block));
+            }
+            memory_controller_.RestoreSnapshot(memory);
+        } else if (tag == state_file::kTagBranchProfile) {
+            uint64_t count = 0;
+            reader.read(count);
+            for (uint64_t i = 0; i < count; ++i) {
+                uint64_t pc = 0;
+                BranchStats stats;
+                if (reader.read(pc) && reader.read(stats)) {
+                    branch_profile_.Restore(pc, true, stats);
+                }
+            }
+        } else if (!LoadMicroarchSection(reader, tag)) {
+            reader.skipSection();
+            continue;
+        }
+
+        if (!reader.sectionDone()) {
+            std::cerr << "Corrupt section in the vm state file: " << filename.string() << std::endl;
+            Reset();
+            return false;
+        }
+    }
+
+    if (!reader.good()) {
+        std::cerr << "Error reading the vm state from: " << filename.string() << std::endl;
+        Reset();
+        return false;
+    }
+
+    output_status_ = "VM_STATE_LOADED";
+    if (!silent_mode_) {
+        DumpRegisters(globals::registers_dump_file_path, registers_);
+        DumpState(globals::vm_state_dump_file_path);
+    }
+    return true;
+}
+
 void VmBase::DumpFinalState(const std::filesystem::path &filename, uint64_t mem_base_addr) {
     std::ofstream file(filename);
     if (!file.is_open()) {
@@ -342,10 +821,18 @@ void VmBase::DumpFinalState(const std::filesystem::path &filename, uint64_t mem_
     file << "    \"stall_cycles\": " << stall_cycles_ << ",\n";
     file << "    \"branch_mispredictions\": " << branch_mispredictions_ << ",\n";
     file << "    \"cpi\": " << cpi_ << ",\n";
-    file << "    \"ipc\": " << ipc_ << "\n";
+    file << "    \"ipc\": " << ipc_;
+    if (hart_group_) {
+        file << ",\n";
+        hart_group_->DumpHartCounters(file, "    ");
+    }
+    file << "\n";
     file << "  },\n";
 
-    
+    // CPI stack, everything is base cpi for the vms that do not attribute lost cycles
+    stall_accounting_.DumpJson(file, cycle_s_, instructions_retired_, "  ");
+    file << ",\n";
+
     // Dump Registers
     file << "  \"registers\": {\n";
     for (int i = 0; i < 32; ++i) {
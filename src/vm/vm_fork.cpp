@@ -0,0 +1,182 @@
+/**
+ * @file vm_fork.cpp
+ * @brief Implementation of the forked what-if runs
+ */
+
+#include "vm/vm_fork.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    // stdout is muted and the global config swapped per child while the children are built and run
+    class ForkScope {
+    public:
+        ForkScope() : saved_config_(vm_config::config), cout_buf_(std::cout.rdbuf(&discard_)) {}
+
+        ~ForkScope() {
+            vm_config::config = saved_config_;
+            std::cout.rdbuf(cout_buf_);
+        }
+
+    private:
+        DiscardBuffer discard_;
+        vm_config::VmConfig saved_config_;
+        std::streambuf *cout_buf_;
+    };
+
+    // limit counts the instructions retired after the fork, 0 runs to the end, true when the limit stopped the child
+    bool runToEnd(VmBase &vm, uint64_t limit) {
+        vm.ClearStop();
+        while (!vm.IsStopRequested() && vm.output_status_ != "VM_PROGRAM_END" &&
+               vm.output_status_ != "VM_LAST_INSTRUCTION_STEPPED") {
+            if (limit != 0 && vm.instructions_retired_ >= limit) {
+                return true;
+            }
+            vm.Step();
+        }
+        return false;
+    }
+
+    std::string escapeJson(const std::string &text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+}
+
+ForkSpec parseForkSpec(const std::string &overrides, const vm_config::VmConfig &base) {
+    ForkSpec spec{overrides, base};
+    std::istringstream stream(overrides);
+    std::string pair;
+
+    // the setters report every change on stdout
+    std::streambuf *cout_buf = std::cout.rdbuf(nullptr);
+    try {
+        while (std::getline(stream, pair, ',')) {
+            std::size_t equals = pair.find('=');
+            if (equals == std::string::npos || equals == 0) {
+                throw std::invalid_argument("Expected key=value in fork overrides: " + pair);
+            }
+            spec.config.modifyConfig("Execution", pair.substr(0, equals), pair.substr(equals + 1));
+        }
+    } catch (...) {
+        std::cout.rdbuf(cout_buf);
+        std::cout.clear();
+        throw;
+    }
+    std::cout.rdbuf(cout_buf);
+    std::cout.clear();
+    return spec;
+}
+
+std::vector<ForkResult> forkAndRun(const VmBase &parent, const std::vector<ForkSpec> &specs, const VmFactory &factory,
+                                   unsigned int num_threads) {
+    std::vector<ForkResult> results(specs.size());
+    if (specs.empty()) {
+        return results;
+    }
+
+    ForkScope scope;
+
+    // the vms read the config when they are built and reset, which happens here on the calling thread only
+    std::vector<std::unique_ptr<VmBase>> children;
+    children.reserve(specs.size());
+    for (const ForkSpec &spec : specs) {
+        vm_config::config = spec.config;
+        vm_config::config.undo_depth = 0;                   // a what-if run never steps back
+        vm_config::config.checkpoint_interval = 0;
+        vm_config::config.lockstep_check = false;
+        vm_config::config.pipeline_trace_path.clear();      // the children would all write the same file
+        children.push_back(factory());
+        children.back()->ForkFrom(parent);
+    }
+
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min<unsigned int>(num_threads, specs.size());
+
+    // every child owns its registers, pipeline and block table -> workers only contend on the job index and on the
+    // reference counts of the memory blocks still shared with parent
+    std::atomic<std::size_t> next_job{0};
+    std::vector<std::exception_ptr> errors(specs.size());
+    auto worker = [&]() {
+        for (std::size_t job = next_job++; job < specs.size(); job = next_job++) {
+            try {
+                VmBase &child = *children[job];
+                bool limited = runToEnd(child, specs[job].config.getInstructionExecutionLimit());
+
+                ForkResult &result = results[job];
+                result.overrides = specs[job].overrides;
+                result.status = limited ? "VM_LIMIT_REACHED" : child.output_status_;
+                result.cycles = child.cycle_s_;
+                result.instructions = child.instructions_retired_;
+                result.stall_cycles = child.stall_cycles_;
+                result.branch_mispredictions = child.branch_mispredictions_;
+                if (result.instructions) {
+                    result.cpi = static_cast<double>(result.cycles) / static_cast<double>(result.instructions);
+                }
+                if (result.cycles) {
+                    result.ipc = static_cast<double>(result.instructions) / static_cast<double>(result.cycles);
+                }
+            } catch (...) {
+                errors[job] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(num_threads);
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread &t : pool) {
+        t.join();
+    }
+
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return results;
+}
+
+void dumpForkResults(const std::filesystem::path &filename, uint64_t fork_point, const std::vector<ForkResult> &results) {
+    std::ofstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Unable to open file: " + filename.string());
+    }
+
+    file << "{\n";
+    file << "  \"fork_point\": " << fork_point << ",\n";
+    file << "  \"runs\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const ForkResult &result = results[i];
+        file << "    {"
+             << "\"overrides\": \"" << escapeJson(result.overrides) << "\", "
+             << "\"status\": \"" << result.status << "\", "
+             << "\"cycles\": " << result.cycles << ", "
+             << "\"instructions_retired\": " << result.instructions << ", "
+             << "\"cpi\": " << std::fixed << std::setprecision(4) << result.cpi << ", "
+             << "\"ipc\": " << result.ipc << std::defaultfloat << ", "
+             << "\"stall_cycles\": " << result.stall_cycles << ", "
+             << "\"branch_mispredictions\": " << result.branch_mispredictions
+             << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+}
@@ -4,4 +4,34 @@
  * @author Vishank Singh, https://github.com/VishankSingh
  */
 
-#include "vm_asm_mw.h"
\ No newline at end of file
+#include "vm_asm_mw.h"
+
+#include <algorithm>
+
+uint64_t AssembledProgram::InstructionAddress(unsigned int instruction_number) const {
+  if (instruction_addresses.empty()) {
+    return static_cast<uint64_t>(instruction_number) * 4;
+  }
+  if (instruction_number >= instruction_addresses.size()) {
+    return TextSize();
+  }
+  return instruction_addresses[instruction_number];
+}
+
+unsigned int AssembledProgram::InstructionNumber(uint64_t address) const {
+  if (instruction_addresses.empty()) {
+    return address % 4 == 0 ? static_cast<unsigned int>(address / 4) : static_cast<unsigned int>(text_buffer.size());
+  }
+  auto it = std::lower_bound(instruction_addresses.begin(), instruction_addresses.end(), address);
+  if (it == instruction_addresses.end() || *it != address) {
+    return static_cast<unsigned int>(instruction_addresses.size());
+  }
+  return static_cast<unsigned int>(it - instruction_addresses.begin());
+}
+
+uint64_t AssembledProgram::TextSize() const {
+  if (instruction_addresses.empty()) {
+    return text_buffer.size() * 4;
+  }
+  return instruction_addresses.back() + ((text_buffer.back() & 0b11) == 0b11 ? 4 : 2);
+}
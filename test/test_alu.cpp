@@ -1,5 +1,5 @@
 #include <gtest/gtest.h>
-#include "../src/vm/alu.h"
+#include "vm/alu.h"
 
 TEST(ALUTest, AddTest) {
   alu::Alu alu;
@@ -0,0 +1,44 @@
+/**
+ * @file test_branch_trace.cpp
+ * @brief Jump classification, the trace file round trip and the replay of the conditional branches only
+ */
+
+#include <gtest/gtest.h>
+#include "vm/rv5s/branch_prediction/branch_trace.h"
+
+#include <filesystem>
+
+TEST(BranchTraceTest, ClassifiesJumps) {
+  EXPECT_EQ(jumpType(0x008000ef), BranchType::kCall);           // jal ra, 8
+  EXPECT_EQ(jumpType(0x0080006f), BranchType::kJump);           // jal zero, 8
+  EXPECT_EQ(jumpType(0x00008067), BranchType::kReturn);         // jalr zero, 0(ra)
+  EXPECT_EQ(jumpType(0x00028067), BranchType::kReturn);         // jalr zero, 0(t0)
+  EXPECT_EQ(jumpType(0x000300e7), BranchType::kIndirectCall);   // jalr ra, 0(t1)
+  EXPECT_EQ(jumpType(0x00030067), BranchType::kIndirectJump);   // jalr zero, 0(t1)
+}
+
+TEST(BranchTraceTest, SavesAndReplaysTypedRecords) {
+  BranchTrace trace;
+  trace.setInstructionCount(100);
+  trace.record(0x10, 0x4, true);
+  trace.record(0x14, 0x40, true, BranchType::kCall);
+  trace.record(0x44, 0x18, true, BranchType::kReturn);
+  trace.record(0x10, 0x4, false);
+
+  std::filesystem::path path = std::filesystem::temp_directory_path() / "test_branch_trace.bt";
+  trace.save(path);
+  BranchTrace loaded = BranchTrace::load(path);
+  std::filesystem::remove(path);
+
+  ASSERT_EQ(loaded.getRecords().size(), 4u);
+  EXPECT_EQ(loaded.getInstructionCount(), 100u);
+  EXPECT_EQ(loaded.getRecords()[1].type, BranchType::kCall);
+  EXPECT_EQ(loaded.getRecords()[2].type, BranchType::kReturn);
+  EXPECT_EQ(loaded.getRecords()[2].target, 0x18u);
+  EXPECT_FALSE(loaded.getRecords()[3].taken);
+
+  // the call and the return do not reach the direction predictor
+  ReplayResult result = replayTrace(loaded, {vm_config::BranchPredictorType::STATIC_TAKEN, 0});
+  EXPECT_EQ(result.branches, 2u);
+  EXPECT_EQ(result.mispredictions, 1u);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file test_checkpoint_store.cpp
+ * @brief Thinning of the single stage VM checkpoints past their cap
+ */
+
+#include <gtest/gtest.h>
+#include "vm/rvss/checkpoint_store.h"
+
+#include <cstdint>
+
+namespace {
+
+Checkpoint checkpointAt(uint64_t instruction) {
+  Checkpoint checkpoint{};
+  checkpoint.instructions_retired = instruction;
+  return checkpoint;
+}
+
+} // namespace
+
+TEST(CheckpointStoreTest, ThinsOlderCheckpointsPastTheCap) {
+  CheckpointStore store;
+  store.SetInterval(10);
+
+  uint64_t instruction = 0;
+  for (int i = 0; i < 2000; ++i, instruction += 10) {
+    ASSERT_TRUE(store.Due(instruction));
+    store.Add(checkpointAt(instruction));
+  }
+  uint64_t newest = instruction - 10;
+  EXPECT_EQ(store.Size(), 64u);
+
+  // the first and the newest are kept, the recent ones stay one interval apart
+  ASSERT_NE(store.Nearest(5), nullptr);
+  EXPECT_EQ(store.Nearest(5)->instructions_retired, 0u);
+  EXPECT_EQ(store.Nearest(newest + 5)->instructions_retired, newest);
+  EXPECT_EQ(store.Nearest(newest - 5)->instructions_retired, newest - 10);
+
+  // far back, a seek replays from further before its target than near the newest one
+  uint64_t recent_gap = (newest - 100) - store.Nearest(newest - 100)->instructions_retired;
+  uint64_t old_gap = (newest / 2) - store.Nearest(newest / 2)->instructions_retired;
+  EXPECT_LT(recent_gap, 100u);
+  EXPECT_GT(old_gap, 10 * recent_gap);
+}
+
+TEST(CheckpointStoreTest, DropFromKeepsTheEarlierCheckpoints) {
+  CheckpointStore store;
+  store.SetInterval(10);
+  for (uint64_t instruction = 0; instruction <= 100; instruction += 10) {
+    store.Add(checkpointAt(instruction));
+  }
+
+  store.DropFrom(55);
+  EXPECT_EQ(store.Size(), 6u);
+  EXPECT_EQ(store.Nearest(1000)->instructions_retired, 50u);
+}
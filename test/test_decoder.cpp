@@ -0,0 +1,237 @@
+/**
+ * @file test_decoder.cpp
+ * @brief Every entry of the encoding array against decoder::decode(), and every 32-bit encoding the tables can tell apart
+ */
+
+#include <gtest/gtest.h>
+#include "vm/decoder.h"
+
+#include <cstdint>
+#include <map>
+
+using decoder::DecodedOp;
+using decoder::ImmFormat;
+using instruction_set::Instruction;
+using instruction_set::InstructionEncoding;
+
+namespace {
+
+constexpr uint32_t kOpLoad = 0b0000011;
+constexpr uint32_t kOpLoadFp = 0b0000111;
+constexpr uint32_t kOpImm = 0b0010011;
+constexpr uint32_t kOpAuipc = 0b0010111;
+constexpr uint32_t kOpImm32 = 0b0011011;
+constexpr uint32_t kOpStore = 0b0100011;
+constexpr uint32_t kOpStoreFp = 0b0100111;
+constexpr uint32_t kOpAmo = 0b0101111;
+constexpr uint32_t kOpLui = 0b0110111;
+constexpr uint32_t kOpFp = 0b1010011;
+constexpr uint32_t kOpVector = 0b1010111;
+constexpr uint32_t kOpBranch = 0b1100011;
+constexpr uint32_t kOpJalr = 0b1100111;
+constexpr uint32_t kOpJal = 0b1101111;
+constexpr uint32_t kOpSystem = 0b1110011;
+
+bool isInstruction(const InstructionEncoding &enc) {
+  return enc.instr > Instruction::kCsrType && enc.instr != Instruction::INVALID && enc.opcode >= 0;
+}
+
+bool isFused(uint32_t opcode) {
+  return opcode == 0b1000011 || opcode == 0b1000111 || opcode == 0b1001011 || opcode == 0b1001111;
+}
+
+bool isVector(const InstructionEncoding &enc) {
+  auto opcode = static_cast<uint32_t>(enc.opcode);
+  return opcode == kOpVector || ((opcode == kOpLoadFp || opcode == kOpStoreFp) && enc.funct3 != 0b010 && enc.funct3 != 0b011);
+}
+
+// funct7 field of an instruction the entry matches, aq / rl / vm / shamt[5] left 0
+uint32_t funct7Of(const InstructionEncoding &enc) {
+  if (enc.instr == Instruction::kvsetvli) {
+    return 0;
+  }
+  if (enc.instr == Instruction::kvsetivli) {
+    return 0b1100000;
+  }
+  if (enc.funct7 != -1) {
+    return static_cast<uint32_t>(enc.funct7);
+  }
+  if (enc.funct6 != -1) {
+    return static_cast<uint32_t>(enc.funct6) << 1;
+  }
+  return enc.funct2 != -1 ? static_cast<uint32_t>(enc.funct2) : 0;
+}
+
+// rd = 5, rs1 = 6, rs2 = 7 unless the entry fixes it
+uint32_t encode(const InstructionEncoding &enc) {
+  uint32_t funct3 = enc.funct3 != -1 ? static_cast<uint32_t>(enc.funct3) : 0;
+  uint32_t rs2 = enc.funct5 != -1 ? static_cast<uint32_t>(enc.funct5) : 7;
+  return static_cast<uint32_t>(enc.opcode) | 5u << 7 | funct3 << 12 | 6u << 15 | rs2 << 20 | funct7Of(enc) << 25;
+}
+
+ImmFormat expectedImmFormat(const InstructionEncoding &enc) {
+  if (isVector(enc)) {
+    return ImmFormat::kNone;
+  }
+  switch (static_cast<uint32_t>(enc.opcode)) {
+    case kOpLoad: case kOpLoadFp: case kOpImm: case kOpImm32: case kOpJalr: return ImmFormat::kI;
+    case kOpStore: case kOpStoreFp: return ImmFormat::kS;
+    case kOpBranch: return ImmFormat::kB;
+    case kOpLui: case kOpAuipc: return ImmFormat::kU;
+    case kOpJal: return ImmFormat::kJ;
+    default: return ImmFormat::kNone;
+  }
+}
+
+// same instruction fields as the entry, the way the tables compare them
+bool matches(const InstructionEncoding &enc, uint32_t instruction) {
+  uint32_t funct3 = (instruction >> 12) & 0b111;
+  uint32_t rs2 = (instruction >> 20) & 0b11111;
+  uint32_t funct7 = instruction >> 25;
+  if ((instruction & 0b1111111) != static_cast<uint32_t>(enc.opcode)
+      || (enc.funct3 != -1 && funct3 != static_cast<uint32_t>(enc.funct3))
+      || (enc.funct5 != -1 && rs2 != static_cast<uint32_t>(enc.funct5))) {
+    return false;
+  }
+  if (enc.instr == Instruction::kvsetvli) {
+    return (funct7 >> 6) == 0;
+  }
+  if (enc.instr == Instruction::kvsetivli) {
+    return (funct7 >> 5) == 0b11;
+  }
+  if (enc.opcode == static_cast<int>(kOpAmo)) {
+    return (funct7 >> 2) == static_cast<uint32_t>(enc.funct7 >> 2);
+  }
+  if (enc.funct2 != -1 && (funct7 & 0b11) != static_cast<uint32_t>(enc.funct2)) {
+    return false;
+  }
+  if (enc.funct6 != -1) {
+    return (funct7 >> 1) == static_cast<uint32_t>(enc.funct6);
+  }
+  return enc.funct7 == -1 || funct7 == static_cast<uint32_t>(enc.funct7);
+}
+
+bool allSignalsOff(const DecodedOp &op) {
+  return op.alu_op == alu::AluOp::kNone && op.imm_format == ImmFormat::kNone && op.operand_a == decoder::OperandA::kRs1
+         && !op.alu_src && !op.reg_write && !op.mem_read && !op.mem_write && !op.mem_to_reg && !op.branch
+         && !op.fp_unit && !op.is_float && !op.is_double && !op.rs1_fp && !op.rs2_fp && !op.uses_rs3 && !op.rd_fp
+         && !op.is_csr && !op.is_syscall && !op.is_atomic && !op.is_vector;
+}
+
+} // namespace
+
+TEST(DecoderTest, EveryEncodingDecodesToItsInstruction) {
+  for (const InstructionEncoding &enc : instruction_set::compiletime_instruction_encoding_array) {
+    if (!isInstruction(enc)) {
+      continue;
+    }
+    auto opcode = static_cast<uint32_t>(enc.opcode);
+    uint32_t instruction = encode(enc);
+    const DecodedOp &op = decoder::decode(instruction);
+    SCOPED_TRACE(testing::Message() << "instr " << static_cast<int>(enc.instr) << std::hex << " encoding 0x" << instruction);
+
+    ASSERT_EQ(op.instr, enc.instr);
+    EXPECT_EQ(op.imm_format, expectedImmFormat(enc));
+    EXPECT_EQ(op.is_vector, isVector(enc));
+    if (isVector(enc)) {
+      EXPECT_FALSE(op.mem_read || op.mem_write || op.branch || op.fp_unit);   // the vector unit does all of it
+      continue;
+    }
+
+    bool load = opcode == kOpLoad || opcode == kOpLoadFp;
+    bool store = opcode == kOpStore || opcode == kOpStoreFp;
+    bool amo = opcode == kOpAmo;
+    EXPECT_EQ(op.mem_read, load || amo);
+    EXPECT_EQ(op.mem_to_reg, load || amo);
+    EXPECT_EQ(op.mem_write, store || (amo && enc.instr != Instruction::klr_w && enc.instr != Instruction::klr_d));
+    EXPECT_EQ(op.is_atomic, amo);
+    EXPECT_EQ(op.branch, opcode == kOpBranch || opcode == kOpJal || opcode == kOpJalr);
+    EXPECT_EQ(op.reg_write, !store && opcode != kOpBranch && enc.instr != Instruction::kecall);
+    EXPECT_EQ(op.alu_src, (expectedImmFormat(enc) != ImmFormat::kNone && opcode != kOpBranch) || amo || op.is_csr);
+    EXPECT_EQ(op.is_syscall, enc.instr == Instruction::kecall);
+    EXPECT_EQ(op.is_csr, opcode == kOpSystem && enc.instr != Instruction::kecall);
+
+    EXPECT_EQ(op.fp_unit, opcode == kOpFp || isFused(opcode));
+    EXPECT_EQ(op.uses_rs3, isFused(opcode));
+    // OP-FP picks its register files from funct7, the other opcodes from the opcode alone
+    if (opcode != kOpFp) {
+      EXPECT_EQ(op.rd_fp, opcode == kOpLoadFp || isFused(opcode));
+      EXPECT_EQ(op.rs2_fp, opcode == kOpStoreFp || isFused(opcode));
+      EXPECT_EQ(op.rs1_fp, isFused(opcode));
+    }
+    bool fp = opcode == kOpLoadFp || opcode == kOpStoreFp || opcode == kOpFp || isFused(opcode);
+    EXPECT_EQ(op.is_float || op.is_double, fp);
+    EXPECT_FALSE(op.is_float && op.is_double);
+
+    if (!op.is_csr && !op.is_syscall) {
+      EXPECT_NE(op.alu_op, alu::AluOp::kNone);
+    }
+  }
+}
+
+TEST(DecoderTest, EveryInstructionHasOneEncoding) {
+  std::map<Instruction, int> entries;
+  for (const InstructionEncoding &enc : instruction_set::compiletime_instruction_encoding_array) {
+    if (isInstruction(enc)) {
+      ++entries[enc.instr];
+    }
+  }
+  for (const auto &[instr, count] : entries) {
+    EXPECT_EQ(count, 1) << "instr " << static_cast<int>(instr);
+  }
+}
+
+// Every opcode, funct3, funct7 and rs2 field: an instruction decodes only from the fields of its own entry, anything
+// else is INVALID with every signal off.
+TEST(DecoderTest, EveryOtherEncodingIsInvalid) {
+  std::map<Instruction, const InstructionEncoding *> entry_of;
+  for (const InstructionEncoding &enc : instruction_set::compiletime_instruction_encoding_array) {
+    if (isInstruction(enc)) {
+      entry_of[enc.instr] = &enc;
+    }
+  }
+
+  for (uint32_t opcode = 0; opcode < 128; ++opcode) {
+    for (uint32_t funct3 = 0; funct3 < 8; ++funct3) {
+      for (uint32_t funct7 = 0; funct7 < 128; ++funct7) {
+        for (uint32_t rs2 = 0; rs2 < 32; ++rs2) {
+          uint32_t instruction = opcode | 5u << 7 | funct3 << 12 | 6u << 15 | rs2 << 20 | funct7 << 25;
+          const DecodedOp &op = decoder::decode(instruction);
+          if (op.instr == Instruction::INVALID) {
+            ASSERT_TRUE(allSignalsOff(op)) << std::hex << instruction;
+            continue;
+          }
+          auto entry = entry_of.find(op.instr);
+          ASSERT_NE(entry, entry_of.end()) << std::hex << instruction;
+          ASSERT_TRUE(matches(*entry->second, instruction)) << std::hex << instruction;
+        }
+      }
+    }
+  }
+
+  EXPECT_EQ(decoder::decode(0x00000000).instr, Instruction::INVALID);
+  EXPECT_EQ(decoder::decode(0xffffffff).instr, Instruction::INVALID);
+  EXPECT_EQ(decoder::decode(0x0000000b).instr, Instruction::INVALID);            // custom-0
+  EXPECT_EQ(decoder::decode(0x40b50533 | 1u << 12).instr, Instruction::INVALID); // sll with the sub funct7
+  EXPECT_EQ(decoder::decode(0x1015a52f).instr, Instruction::INVALID);            // lr.w with rs2 != 0
+}
+
+// the fsd entry of the encoding array was once labelled fsw, fsd then decoded as a single precision store
+TEST(DecoderTest, FsdIsADoublePrecisionStore) {
+  const DecodedOp &fsd = decoder::decode(0x00a13427);       // fsd fa0, 8(sp)
+  EXPECT_EQ(fsd.instr, Instruction::kfsd);
+  EXPECT_TRUE(fsd.is_double);
+  EXPECT_FALSE(fsd.is_float);
+  EXPECT_TRUE(fsd.mem_write);
+  EXPECT_TRUE(fsd.rs2_fp);
+  EXPECT_EQ(fsd.imm_format, ImmFormat::kS);
+
+  const DecodedOp &fsw = decoder::decode(0x00a12427);       // fsw fa0, 8(sp)
+  EXPECT_EQ(fsw.instr, Instruction::kfsw);
+  EXPECT_TRUE(fsw.is_float);
+  EXPECT_FALSE(fsw.is_double);
+
+  const InstructionEncoding &entry = instruction_set::get_instr_encoding(Instruction::kfsd);
+  EXPECT_EQ(entry.instr, Instruction::kfsd);
+  EXPECT_EQ(entry.funct3, 0b011);
+}
@@ -5,7 +5,9 @@
  */
 
 #include <gtest/gtest.h>
-#include "../src/vm/main_memory.h"
+#include "vm/main_memory.h"
+#include "vm/memory_controller.h"
+#include "vm/atomic_unit.h"
 
 TEST(MemoryTest, ReadWriteTest) {
   Memory memory;
@@ -87,4 +89,27 @@ TEST(MemoryTest, ReadWriteLargeDoubleTest) {
   EXPECT_DOUBLE_EQ(memory.ReadDouble(4096), large_value4);
 }
 
-
+// a store of another hart that puts the loaded value back (A -> B -> A) between lr and sc still fails the sc
+TEST(MemoryTest, SharedStoreDropsReservationTest) {
+  constexpr uint8_t kLr = 0b00010;
+  constexpr uint8_t kSc = 0b00011;
+  MemoryController memory;
+  memory.SetShared(true);
+  memory.WriteDoubleWord(0x100, 5);
+
+  atomic_unit::Reservation reservation;
+  EXPECT_EQ(atomic_unit::execute(kLr, 8, 0x100, 0, memory, reservation), 5u);
+  memory.WriteDoubleWord(0x100, 6);
+  memory.WriteDoubleWord(0x100, 5);
+  EXPECT_EQ(atomic_unit::execute(kSc, 8, 0x100, 9, memory, reservation), 1u);
+  EXPECT_EQ(memory.ReadDoubleWord(0x100), 5u);
+
+  // a byte store into the granule drops it too, a store elsewhere in the memory does not
+  atomic_unit::execute(kLr, 8, 0x100, 0, memory, reservation);
+  memory.WriteByte(0x107, 0);
+  EXPECT_EQ(atomic_unit::execute(kSc, 8, 0x100, 9, memory, reservation), 1u);
+  atomic_unit::execute(kLr, 8, 0x100, 0, memory, reservation);
+  memory.WriteDoubleWord(0x108, 7);
+  EXPECT_EQ(atomic_unit::execute(kSc, 8, 0x100, 9, memory, reservation), 0u);
+  EXPECT_EQ(memory.ReadDoubleWord(0x100), 9u);
+}
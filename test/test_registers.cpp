@@ -0,0 +1,46 @@
+/**
+ * @file test_registers.cpp
+ * @brief CSR writes through the write masks of implemented_csrs, and the accesses the vms report
+ */
+
+#include <gtest/gtest.h>
+#include "vm/registers.h"
+
+#include <stdexcept>
+
+TEST(RegistersTest, CsrWritesKeepToTheWriteMask) {
+  RegisterFile registers;
+  registers.WriteCsr(0x001, ~uint64_t{0});     // fflags
+  EXPECT_EQ(registers.ReadCsr(0x003), 0x1fu);
+  registers.WriteCsr(0x002, ~uint64_t{0});     // frm
+  EXPECT_EQ(registers.ReadCsr(0x003), 0xffu);
+  EXPECT_EQ(registers.ReadCsr(0x002), 0b111u);
+
+  registers.WriteCsr(0x003, 0x1234);          // fcsr
+  EXPECT_EQ(registers.ReadCsr(0x003), 0x34u);
+  EXPECT_EQ(registers.ReadCsr(0x001), 0x14u);
+  EXPECT_EQ(registers.ReadCsr(0x002), 0b001u);
+
+  registers.WriteCsr(0xb00, 1000);            // mcycle, unbound counters read 0
+  EXPECT_EQ(registers.ReadCsr(0xc00), 1000u);
+}
+
+TEST(RegistersTest, ReadOnlyAndUnimplementedCsrsIgnoreWrites) {
+  RegisterFile registers;
+  registers.SetHartId(3);
+  registers.WriteCsr(0xf14, 7);               // mhartid
+  registers.WriteCsr(0xc00, 7);               // cycle
+  registers.WriteCsr(0x7c0, 7);
+  EXPECT_EQ(registers.ReadCsr(0xf14), 3u);
+  EXPECT_EQ(registers.ReadCsr(0xc00), 0u);
+  EXPECT_EQ(registers.ReadCsr(0x7c0), 0u);
+
+  EXPECT_EQ(CheckCsrAccess(0x003, true), CsrAccess::kOk);
+  EXPECT_EQ(CheckCsrAccess(0xc02, false), CsrAccess::kOk);
+  EXPECT_EQ(CheckCsrAccess(0xc02, true), CsrAccess::kReadOnly);
+  EXPECT_EQ(CheckCsrAccess(0xf14, true), CsrAccess::kReadOnly);
+  EXPECT_EQ(CheckCsrAccess(0x7c0, false), CsrAccess::kUnimplemented);
+
+  EXPECT_THROW(registers.ModifyRegister("instret", 1), std::invalid_argument);
+  EXPECT_NO_THROW(registers.ModifyRegister("minstret", 1));
+}
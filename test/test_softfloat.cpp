@@ -0,0 +1,235 @@
+/**
+ * @file test_softfloat.cpp
+ * @brief Edge vectors of the soft fp engine, NaN-boxing in the alu, and the host fast path against the soft engine
+ */
+
+#include <gtest/gtest.h>
+#include "vm/alu.h"
+#include "vm/softfloat.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+using namespace softfloat;
+
+namespace {
+
+constexpr uint8_t kNV = FCSR_INVALID_OP;
+constexpr uint8_t kOF = FCSR_OVERFLOW;
+constexpr uint8_t kUF = FCSR_UNDERFLOW;
+constexpr uint8_t kNX = FCSR_INEXACT;
+
+constexpr std::array<uint8_t, 5> kRoundingModes = {kRoundNearestEven, kRoundTowardZero, kRoundDown, kRoundUp,
+                                                   kRoundNearestMaxMagnitude};
+
+constexpr uint32_t kOne32 = 0x3f800000;
+constexpr uint32_t kTwo32 = 0x40000000;
+constexpr uint32_t kHalf32 = 0x3f000000;
+constexpr uint32_t kMax32 = 0x7f7fffff;
+constexpr uint32_t kInf32 = 0x7f800000;
+constexpr uint64_t kHalf64 = 0x3fe0000000000000;
+constexpr uint64_t kTwo64 = 0x4000000000000000;
+constexpr uint64_t kMax64 = 0x7fefffffffffffff;
+constexpr uint64_t kInf64 = 0x7ff0000000000000;
+
+constexpr uint64_t box(uint32_t value) {
+  return 0xffffffff00000000 | value;
+}
+
+} // namespace
+
+TEST(SoftFloatTest, Subnormals) {
+  uint8_t flags = 0;
+  // exact results are not tiny-and-inexact, no underflow
+  EXPECT_EQ(f32Add(0x00000001, 0x00000001, kRoundNearestEven, flags), 0x00000002u);
+  EXPECT_EQ(f32Mul(0x00800000, kHalf32, kRoundNearestEven, flags), 0x00400000u);
+  EXPECT_EQ(flags, 0);
+
+  // half the smallest subnormal is a tie between 0 and it
+  flags = 0;
+  EXPECT_EQ(f32Mul(0x00000001, kHalf32, kRoundNearestEven, flags), 0x00000000u);
+  EXPECT_EQ(flags, kUF | kNX);
+  flags = 0;
+  EXPECT_EQ(f32Mul(0x00000001, kHalf32, kRoundUp, flags), 0x00000001u);
+  EXPECT_EQ(flags, kUF | kNX);
+  flags = 0;
+  EXPECT_EQ(f64Mul(0x0000000000000001, kHalf64, kRoundNearestMaxMagnitude, flags), 0x0000000000000001u);
+  EXPECT_EQ(flags, kUF | kNX);
+
+  // the largest subnormal plus the smallest one is the smallest normal
+  flags = 0;
+  EXPECT_EQ(f64Add(0x000fffffffffffff, 0x0000000000000001, kRoundNearestEven, flags), 0x0010000000000000u);
+  EXPECT_EQ(flags, 0);
+
+  EXPECT_EQ(f32Classify(0x00000001), 1u << 5);
+  EXPECT_EQ(f32Classify(0x80000001), 1u << 2);
+  EXPECT_EQ(f64Classify(0x000fffffffffffff), 1u << 5);
+}
+
+TEST(SoftFloatTest, OverflowUnderEachRoundingMode) {
+  // the modes that round toward zero stop at the largest finite value, the others go to infinity
+  const std::array<uint32_t, 5> positive32 = {kInf32, kMax32, kMax32, kInf32, kInf32};
+  const std::array<uint32_t, 5> negative32 = {0xff800000, 0xff7fffff, 0xff800000, 0xff7fffff, 0xff800000};
+  const std::array<uint64_t, 5> positive64 = {kInf64, kMax64, kMax64, kInf64, kInf64};
+  for (std::size_t i = 0; i < kRoundingModes.size(); ++i) {
+    uint8_t rm = kRoundingModes[i];
+    uint8_t flags = 0;
+    EXPECT_EQ(f32Mul(kMax32, kTwo32, rm, flags), positive32[i]) << "rm " << int(rm);
+    EXPECT_EQ(flags, kOF | kNX) << "rm " << int(rm);
+    flags = 0;
+    EXPECT_EQ(f32Mul(0xff7fffff, kTwo32, rm, flags), negative32[i]) << "rm " << int(rm);
+    EXPECT_EQ(flags, kOF | kNX) << "rm " << int(rm);
+    flags = 0;
+    EXPECT_EQ(f64Add(kMax64, kMax64, rm, flags), positive64[i]) << "rm " << int(rm);
+    EXPECT_EQ(flags, kOF | kNX) << "rm " << int(rm);
+    flags = 0;
+    EXPECT_EQ(f64ToF32(kMax64, rm, flags), positive32[i]) << "rm " << int(rm);
+    EXPECT_EQ(flags, kOF | kNX) << "rm " << int(rm);
+  }
+}
+
+TEST(SoftFloatTest, NearestMaxMagnitudeTies) {
+  // 1 + 2^-24 lies halfway between 1 and the next float up
+  uint8_t flags = 0;
+  EXPECT_EQ(f32Add(kOne32, 0x33800000, kRoundNearestEven, flags), kOne32);
+  EXPECT_EQ(f32Add(kOne32, 0x33800000, kRoundNearestMaxMagnitude, flags), 0x3f800001u);
+  EXPECT_EQ(f32Add(0xbf800000, 0xb3800000, kRoundNearestMaxMagnitude, flags), 0xbf800001u);
+  EXPECT_EQ(flags, kNX);
+
+  // not a tie, both nearest modes agree
+  EXPECT_EQ(f32Add(kOne32, 0x33c00000, kRoundNearestEven, flags), 0x3f800001u);
+  EXPECT_EQ(f32Add(kOne32, 0x33c00000, kRoundNearestMaxMagnitude, flags), 0x3f800001u);
+
+  flags = 0;
+  EXPECT_EQ(f32ToI32(0x40200000, kRoundNearestEven, flags), 2u);                     // 2.5
+  EXPECT_EQ(f32ToI32(0x40200000, kRoundNearestMaxMagnitude, flags), 3u);
+  EXPECT_EQ(f32ToI32(0xc0200000, kRoundNearestMaxMagnitude, flags), 0xfffffffffffffffdu);
+  EXPECT_EQ(f64ToI64(0xc004000000000000, kRoundNearestMaxMagnitude, flags), 0xfffffffffffffffdu);
+  EXPECT_EQ(flags, kNX);
+}
+
+TEST(SoftFloatTest, FusedInfinityTimesZeroIsInvalidEvenWithAQuietNaN) {
+  uint8_t flags = 0;
+  EXPECT_EQ(f32MulAdd(kInf32, 0x00000000, kDefaultNaN32, kRoundNearestEven, flags), kDefaultNaN32);
+  EXPECT_EQ(flags, kNV);
+  flags = 0;
+  EXPECT_EQ(f64MulAdd(0x0000000000000000, kInf64, kDefaultNaN64, kRoundNearestEven, flags), kDefaultNaN64);
+  EXPECT_EQ(flags, kNV);
+
+  // a quiet NaN addend alone raises nothing, a signaling one does
+  flags = 0;
+  EXPECT_EQ(f32MulAdd(kOne32, kTwo32, kDefaultNaN32, kRoundNearestEven, flags), kDefaultNaN32);
+  EXPECT_EQ(flags, 0);
+  EXPECT_EQ(f32MulAdd(kOne32, kTwo32, 0x7f800001, kRoundNearestEven, flags), kDefaultNaN32);
+  EXPECT_EQ(flags, kNV);
+}
+
+TEST(SoftFloatTest, UnboxedOperandsReadAsTheCanonicalNaN) {
+  alu::Alu alu;
+  constexpr uint64_t kUnboxedOne = kOne32;        // upper half not all ones
+
+  auto [sum, sum_flags] = alu.fpexecute(alu::AluOp::FADD_S, kUnboxedOne, box(kOne32), 0, kRoundNearestEven);
+  EXPECT_EQ(sum, box(kDefaultNaN32));
+  EXPECT_EQ(sum_flags, 0);
+
+  auto [sign, sign_flags] = alu.fpexecute(alu::AluOp::FSGNJ_S, kUnboxedOne, box(0xbf800000), 0, kRoundNearestEven);
+  EXPECT_EQ(sign, box(0xffc00000));
+  EXPECT_EQ(sign_flags, 0);
+
+  auto [equal, equal_flags] = alu.fpexecute(alu::AluOp::FEQ_S, kUnboxedOne, kUnboxedOne, 0, kRoundNearestEven);
+  EXPECT_EQ(equal, 0u);
+  EXPECT_EQ(equal_flags, 0);
+  auto [less, less_flags] = alu.fpexecute(alu::AluOp::FLT_S, kUnboxedOne, box(kOne32), 0, kRoundNearestEven);
+  EXPECT_EQ(less, 0u);
+  EXPECT_EQ(less_flags, kNV);
+
+  auto [convert, convert_flags] = alu.fpexecute(alu::AluOp::FCVT_W_S, kUnboxedOne, 0, 0, kRoundNearestEven);
+  EXPECT_EQ(convert, 0x7fffffffu);
+  EXPECT_EQ(convert_flags, kNV);
+
+  auto [fused, fused_flags] = alu.fpexecute(alu::AluOp::kFmadd_s, box(kOne32), box(kOne32), kUnboxedOne,
+                                            kRoundNearestEven);
+  EXPECT_EQ(fused, box(kDefaultNaN32));
+  EXPECT_EQ(fused_flags, 0);
+
+  // single precision results are boxed
+  EXPECT_EQ(alu.fpexecute(alu::AluOp::FADD_S, box(kOne32), box(kOne32), 0, kRoundNearestEven).first, box(kTwo32));
+}
+
+TEST(SoftFloatTest, ConversionsToIntegersSaturate) {
+  struct Vector {
+    uint64_t (*convert)(uint32_t, uint8_t, uint8_t &);
+    uint32_t input;
+    uint64_t expected;
+  };
+  const Vector vectors32[] = {
+      {f32ToI32, kDefaultNaN32, 0x7fffffff},
+      {f32ToI32, kInf32, 0x7fffffff},
+      {f32ToI32, 0xff800000, 0xffffffff80000000},
+      {f32ToI32, 0x4f32d05e, 0x7fffffff},                 // 3e9
+      {f32ToUi32, kDefaultNaN32, 0xffffffffffffffff},     // sign-extended from 32 bits
+      {f32ToUi32, 0xbf800000, 0},                         // -1
+      {f32ToI64, 0xff800000, 0x8000000000000000},
+      {f32ToUi64, kInf32, 0xffffffffffffffff},
+  };
+  for (const Vector &vector : vectors32) {
+    uint8_t flags = 0;
+    EXPECT_EQ(vector.convert(vector.input, kRoundTowardZero, flags), vector.expected) << std::hex << vector.input;
+    EXPECT_EQ(flags, kNV) << std::hex << vector.input;
+  }
+
+  uint8_t flags = 0;
+  EXPECT_EQ(f64ToI64(0x43e0000000000000, kRoundNearestEven, flags), 0x7fffffffffffffffu);        // 2^63
+  EXPECT_EQ(flags, kNV);
+  flags = 0;
+  EXPECT_EQ(f64ToI64(0xc3e0000000000000, kRoundNearestEven, flags), 0x8000000000000000u);        // -2^63 fits
+  EXPECT_EQ(flags, 0);
+  EXPECT_EQ(f64ToUi64(0xfff0000000000000, kRoundNearestEven, flags), 0u);
+  EXPECT_EQ(flags, kNV);
+  flags = 0;
+  EXPECT_EQ(f64ToI32(0xc1e0000000200000, kRoundNearestEven, flags), 0xffffffff80000000u);        // -2^31 - 1
+  EXPECT_EQ(flags, kNV);
+
+  // a negative value that rounds to 0 is in range for the unsigned conversions
+  flags = 0;
+  EXPECT_EQ(f32ToUi32(0xbf000000, kRoundTowardZero, flags), 0u);
+  EXPECT_EQ(flags, kNX);
+}
+
+// The host fast path must give the soft engine's result and flags bit for bit, whether it takes the operands or not.
+TEST(SoftFloatTest, HostEngineAgreesWithSoftEngine) {
+  alu::Alu host;
+  alu::Alu soft;
+  soft.setSoftFloat(true);
+
+  std::mt19937_64 random(0x5eed);
+  // half the operands have an exponent near 1.0 so most results stay in the host range, the rest are any bits
+  auto operand32 = [&random]() {
+    uint32_t bits = static_cast<uint32_t>(random());
+    return (random() & 1) ? bits : (bits & 0x807fffff) | ((0x70 + (bits >> 23 & 0x1f)) << 23);
+  };
+  auto operand64 = [&random]() {
+    uint64_t bits = random();
+    return (random() & 1) ? bits : (bits & 0x800fffffffffffff) | ((0x3f0 + (bits >> 52 & 0x1f)) << 52);
+  };
+
+  const alu::AluOp ops32[] = {alu::AluOp::FADD_S, alu::AluOp::FSUB_S, alu::AluOp::FMUL_S, alu::AluOp::FDIV_S,
+                              alu::AluOp::FSQRT_S};
+  const alu::AluOp ops64[] = {alu::AluOp::FADD_D, alu::AluOp::FSUB_D, alu::AluOp::FMUL_D, alu::AluOp::FDIV_D,
+                              alu::AluOp::FSQRT_D};
+  for (int i = 0; i < 20000; ++i) {
+    uint64_t a32 = box(operand32());
+    uint64_t b32 = box(operand32());
+    for (alu::AluOp op : ops32) {
+      ASSERT_EQ(host.fpexecute(op, a32, b32, 0, kRoundNearestEven), soft.fpexecute(op, a32, b32, 0, kRoundNearestEven))
+          << "op " << static_cast<int>(op) << std::hex << " a " << a32 << " b " << b32;
+    }
+    uint64_t a64 = operand64();
+    uint64_t b64 = operand64();
+    for (alu::AluOp op : ops64) {
+      ASSERT_EQ(host.fpexecute(op, a64, b64, 0, kRoundNearestEven), soft.fpexecute(op, a64, b64, 0, kRoundNearestEven))
+          << "op " << static_cast<int>(op) << std::hex << " a " << a64 << " b " << b64;
+    }
+  }
+}
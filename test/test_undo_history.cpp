@@ -0,0 +1,141 @@
+/**
+ * @file test_undo_history.cpp
+ * @brief Ring eviction, overflow and redo truncation of the single stage VM undo history
+ */
+
+#include <gtest/gtest.h>
+#include "vm/rvss/undo_history.h"
+
+#include <vector>
+
+namespace {
+
+// one step at pc writing the given registers, new value = register index + 100 * pc
+void recordStep(UndoHistory &history, uint64_t pc, const std::vector<unsigned int> &registers) {
+  history.BeginStep(pc);
+  for (unsigned int reg : registers) {
+    history.RecordRegister(reg, 0, pc, reg + 100 * pc);
+  }
+  history.CommitStep(pc + 4);
+}
+
+std::vector<uint64_t> newValues(const UndoHistory &history, const StepDelta &step) {
+  std::vector<uint64_t> values;
+  for (uint64_t i = step.register_begin; i < step.register_end; ++i) {
+    values.push_back(history.RegisterAt(i).new_value);
+  }
+  return values;
+}
+
+} // namespace
+
+TEST(UndoHistoryTest, WrapsAroundTheRings) {
+  UndoHistory history;
+  history.SetCapacity(3);       // 3 steps, 6 register records
+
+  // 2 records a step, the indices pass the ring boundary several times
+  for (uint64_t pc = 0; pc < 10; ++pc) {
+    recordStep(history, pc, {1, 2});
+  }
+
+  for (uint64_t pc = 9; pc >= 7; --pc) {
+    ASSERT_TRUE(history.CanUndo());
+    const StepDelta &step = history.Undo();
+    EXPECT_EQ(step.old_pc, pc);
+    EXPECT_EQ(step.new_pc, pc + 4);
+    EXPECT_EQ(newValues(history, step), (std::vector<uint64_t>{1 + 100 * pc, 2 + 100 * pc}));
+  }
+  EXPECT_FALSE(history.CanUndo());
+
+  for (uint64_t pc = 7; pc <= 9; ++pc) {
+    ASSERT_TRUE(history.CanRedo());
+    EXPECT_EQ(history.Redo().old_pc, pc);
+  }
+  EXPECT_FALSE(history.CanRedo());
+}
+
+TEST(UndoHistoryTest, LargeStepEvictsOlderSteps) {
+  UndoHistory history;
+  history.SetCapacity(4);       // 8 register records
+
+  for (uint64_t pc = 0; pc < 4; ++pc) {
+    recordStep(history, pc, {1});
+  }
+  // 5 records do not fit beside the 4 kept ones, the oldest step makes room
+  recordStep(history, 4, {1, 2, 3, 4, 5});
+
+  const StepDelta &large = history.Undo();
+  EXPECT_EQ(large.old_pc, 4u);
+  EXPECT_EQ(newValues(history, large), (std::vector<uint64_t>{401, 402, 403, 404, 405}));
+  for (uint64_t pc = 3; pc >= 1; --pc) {
+    ASSERT_TRUE(history.CanUndo());
+    const StepDelta &step = history.Undo();
+    EXPECT_EQ(step.old_pc, pc);
+    EXPECT_EQ(newValues(history, step), (std::vector<uint64_t>{1 + 100 * pc}));
+  }
+  EXPECT_FALSE(history.CanUndo());
+}
+
+TEST(UndoHistoryTest, OverflowingStepClearsTheHistory) {
+  UndoHistory history;
+  history.SetCapacity(2);       // 4 register records
+
+  recordStep(history, 0, {1});
+  recordStep(history, 1, {1});
+  recordStep(history, 2, {1, 2, 3, 4, 5});    // more than the whole ring
+
+  EXPECT_FALSE(history.CanUndo());
+  EXPECT_FALSE(history.CanRedo());
+
+  // the history records again from the next step
+  recordStep(history, 3, {1});
+  ASSERT_TRUE(history.CanUndo());
+  EXPECT_EQ(newValues(history, history.Undo()), (std::vector<uint64_t>{301}));
+}
+
+TEST(UndoHistoryTest, NewStepDropsTheRedoSteps) {
+  UndoHistory history;
+  history.SetCapacity(4);
+
+  recordStep(history, 0, {1});
+  recordStep(history, 1, {1, 2});
+  recordStep(history, 2, {1});
+  history.Undo();
+  history.Undo();
+  ASSERT_TRUE(history.CanRedo());
+
+  // the new step reuses the records of the undone ones
+  recordStep(history, 5, {7});
+  EXPECT_FALSE(history.CanRedo());
+
+  const StepDelta &step = history.Undo();
+  EXPECT_EQ(step.old_pc, 5u);
+  EXPECT_EQ(step.register_begin, 1u);
+  EXPECT_EQ(newValues(history, step), (std::vector<uint64_t>{507}));
+  EXPECT_EQ(newValues(history, history.Undo()), (std::vector<uint64_t>{1}));
+  EXPECT_FALSE(history.CanUndo());
+
+  EXPECT_EQ(history.Redo().old_pc, 0u);
+  EXPECT_EQ(history.Redo().old_pc, 5u);
+  EXPECT_FALSE(history.CanRedo());
+}
+
+TEST(UndoHistoryTest, MemoryRecordsSplitLongWrites) {
+  UndoHistory history;
+  history.SetCapacity(4);       // 8 memory records
+
+  std::vector<uint8_t> old_bytes(20, 0);
+  std::vector<uint8_t> new_bytes(20);
+  for (std::size_t i = 0; i < new_bytes.size(); ++i) {
+    new_bytes[i] = static_cast<uint8_t>(i + 1);
+  }
+  history.BeginStep(0);
+  history.RecordMemory(0x1000, old_bytes.data(), new_bytes.data(), new_bytes.size());
+  history.CommitStep(4);
+
+  const StepDelta &step = history.Undo();
+  ASSERT_EQ(step.memory_end - step.memory_begin, 3u);
+  EXPECT_EQ(history.MemoryAt(step.memory_begin + 2).address, 0x1010u);
+  EXPECT_EQ(history.MemoryAt(step.memory_begin + 2).size, 4u);
+  EXPECT_EQ(history.MemoryAt(step.memory_begin + 2).new_bytes[3], 20u);
+}